@@ -1,6 +1,10 @@
 #pragma once
 
 #include <octet/logger>
+#include <octet/metrics>
 #include <octet/storage_manager>
+#include <octet/storage_reader>
 #include <octet/journal_manager>
 #include <octet/uuid_generator>
+#include <octet/value_allocator>
+#include <octet/value_log>
@@ -1,11 +1,23 @@
 #include "interactive/commands.hpp"
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
+#include "utils/byte_order.hpp"
 #include "utils/compiler.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/parallel.hpp"
+#include "metrics.hpp"
 
 namespace {
+// Сигнатура двоичного файла загрузки: далее записи [u32 LE длина][данные]
+constexpr std::string_view IMPORT_BINARY_SIGNATURE = "OCTET-IMPORT-V1\n";
+// Количество строк, передаваемых хранилищу за один вызов загрузки
+constexpr size_t IMPORT_CHUNK_SIZE = 1024 * 1024;
+// Минимальный объём текста, который разбирается одним потоком
+constexpr size_t IMPORT_MIN_RANGE_SIZE = 4 * 1024 * 1024;
 /**
  * @brief Схлопывание строк вектора в одну указанную строку
  * @param args Ссылка на вектор строк
@@ -154,29 +166,189 @@ std::optional<std::pair<std::string, std::vector<std::string>>> parseInput(std::
 
     return std::make_pair(*command, args);
 }
+
+// Разделение аргументов однократного запуска на команду и её аргументы
+std::optional<std::string> takeCommand(std::vector<std::string> &args)
+{
+    if (args.empty()) {
+        LOG_ERROR << "Ошибка: необходимо указать команду для выполнения.\n"
+                  << "Введите `help` для получения списка доступных команд";
+        return std::nullopt;
+    }
+
+    // Достаем команду из аргументов
+    auto command = std::move(args.front());
+    args.erase(args.begin());
+    return command;
+}
+/**
+ * @brief Разбор двоичного файла загрузки
+ * @param content Содержимое файла после сигнатуры
+ * @return Строки, ссылающиеся на содержимое (при повреждённой записи - std::nullopt)
+ */
+std::optional<std::vector<std::string_view>> parseBinaryImport(std::string_view content)
+{
+    std::vector<std::string_view> values;
+    size_t offset = 0;
+    while (offset < content.size()) {
+        if (content.size() - offset < sizeof(uint32_t)) {
+            LOG_ERROR << "Ошибка: обрезанная запись в конце файла загрузки";
+            return std::nullopt;
+        }
+        const auto length = octet::utils::loadLittleEndian<uint32_t>(content.data() + offset);
+        offset += sizeof(uint32_t);
+        if (content.size() - offset < length) {
+            LOG_ERROR << "Ошибка: запись " << values.size()
+                      << " файла загрузки выходит за пределы файла";
+            return std::nullopt;
+        }
+        values.push_back(content.substr(offset, length));
+        offset += length;
+    }
+    return values;
+}
+
+/**
+ * @brief Разбор текстового файла загрузки (одна строка данных на строку файла) в нескольких
+ * потоках: файл делится на диапазоны по границам строк, пустые строки пропускаются
+ * @param content Содержимое файла
+ * @return Строки, ссылающиеся на содержимое
+ */
+std::vector<std::string_view> parseLinesImport(std::string_view content)
+{
+    // Границы диапазонов сдвигаются к началу следующей строки
+    const auto rangeCount = std::max<size_t>(
+        1, std::min(octet::utils::defaultParallelism(), content.size() / IMPORT_MIN_RANGE_SIZE));
+    std::vector<size_t> bounds{ 0 };
+    for (size_t i = 1; i < rangeCount; i++) {
+        const auto from = std::max(bounds.back(), i * content.size() / rangeCount);
+        const auto newline = content.find('\n', from);
+        if (newline == std::string_view::npos) {
+            break;
+        }
+        bounds.push_back(newline + 1);
+    }
+    bounds.push_back(content.size());
+
+    std::vector<std::vector<std::string_view>> ranges(bounds.size() - 1);
+    octet::utils::parallelFor(ranges.size(), [&](size_t i) {
+        auto range = content.substr(bounds[i], bounds[i + 1] - bounds[i]);
+        while (!range.empty()) {
+            const auto end = std::min(range.find('\n'), range.size());
+            auto line = range.substr(0, end);
+            range.remove_prefix(std::min(end + 1, range.size()));
+            if (!line.empty() && line.back() == '\r') {
+                line.remove_suffix(1);
+            }
+            if (!line.empty()) {
+                ranges[i].push_back(line);
+            }
+        }
+    });
+
+    std::vector<std::string_view> values;
+    size_t total = 0;
+    for (const auto &range : ranges) {
+        total += range.size();
+    }
+    values.reserve(total);
+    for (const auto &range : ranges) {
+        values.insert(values.end(), range.begin(), range.end());
+    }
+    return values;
+}
+
+/**
+ * @brief Загрузка строк из файла в хранилище. Ключи записей сохраняются в файл с суффиксом
+ * .uuids по одному на строку в порядке строк исходного файла
+ * @param storage Хранилище
+ * @param path Путь к текстовому или двоичному файлу загрузки
+ * @return true если все строки загружены и зафиксированы снапшотом
+ */
+bool importFile(octet::StorageManager &storage, const std::filesystem::path &path)
+{
+    const octet::utils::MappedFile file(path);
+    if (!file.isMapped()) {
+        LOG_ERROR << "Ошибка: не удалось открыть файл загрузки " << path;
+        return false;
+    }
+
+    const auto content = file.view();
+    std::vector<std::string_view> values;
+    if (content.substr(0, IMPORT_BINARY_SIGNATURE.size()) == IMPORT_BINARY_SIGNATURE) {
+        auto parsed = parseBinaryImport(content.substr(IMPORT_BINARY_SIGNATURE.size()));
+        if (!parsed.has_value()) {
+            return false;
+        }
+        values = std::move(*parsed);
+    }
+    else {
+        values = parseLinesImport(content);
+    }
+
+    // Таблицы хранилища резервируются под все строки сразу, а строки передаются частями,
+    // чтобы не держать второй набор ссылок на весь файл
+    storage.reserve(values.size());
+    std::vector<octet::Uuid> keys;
+    keys.reserve(values.size());
+    for (size_t offset = 0; offset < values.size(); offset += IMPORT_CHUNK_SIZE) {
+        const auto end = std::min(values.size(), offset + IMPORT_CHUNK_SIZE);
+        const std::vector<std::string_view> chunk(values.begin() + offset, values.begin() + end);
+        std::vector<octet::Uuid> chunkKeys;
+        if (!storage.importValues(chunk, &chunkKeys)) {
+            LOG_ERROR << "Ошибка: загрузка прервана после " << offset << " строк";
+            return false;
+        }
+        keys.insert(keys.end(), chunkKeys.begin(), chunkKeys.end());
+    }
+
+    // Строки ключей имеют одинаковую длину, поэтому форматируются в нескольких потоках
+    constexpr auto lineLength = octet::Uuid::STRING_LENGTH + 1;
+    std::string keysData(keys.size() * lineLength, '\n');
+    octet::utils::parallelFor(
+        (keys.size() + IMPORT_CHUNK_SIZE - 1) / IMPORT_CHUNK_SIZE, [&](size_t chunk) {
+            const auto end = std::min(keys.size(), (chunk + 1) * IMPORT_CHUNK_SIZE);
+            for (auto i = chunk * IMPORT_CHUNK_SIZE; i < end; i++) {
+                keys[i].writeTo(keysData.data() + i * lineLength);
+            }
+        });
+    auto keysPath = path;
+    keysPath += ".uuids";
+    if (!octet::utils::atomicFileWrite(keysPath, keysData)) {
+        LOG_ERROR << "Ошибка: не удалось записать ключи загруженных строк в " << keysPath;
+        return false;
+    }
+
+    if (!storage.finishImport()) {
+        LOG_ERROR << "Ошибка: не удалось зафиксировать загруженные строки снапшотом";
+        return false;
+    }
+    LOG_IMPORTANT << "Загружено строк: " << values.size() << ", ключи записаны в " << keysPath;
+    return true;
+}
 } // namespace
 
 namespace octet::cli {
 CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleShotMode)
-    : storage_(storage)
+    : storage_(&storage)
     , singleShotMode_(singleShotMode)
 {
-    // Регистрация всех доступных команд
+    registerCommands();
+}
 
-    // Команда вставки строки
-    commands_["insert"]
-        = { 1, false, [this](const std::vector<std::string> &args) -> CommandResult {
-               const auto result = storage_.insert(args[0]);
-               if (result.has_value()) {
-                   LOG_IMPORTANT << *result;
-                   return CommandResult::SUCCESS;
-               }
-               return CommandResult::FAILURE;
-           } };
+CommandProcessor::CommandProcessor(octet::StorageReader &reader, bool singleShotMode)
+    : reader_(&reader)
+    , singleShotMode_(singleShotMode)
+{
+    registerCommands();
+}
 
+void CommandProcessor::registerCommands()
+{
     // Команда получения строки
     commands_["get"] = { 1, false, [this](const std::vector<std::string> &args) -> CommandResult {
-                            const auto result = storage_.get(args[0]);
+                            const auto result = reader_ != nullptr ? reader_->get(args[0])
+                                                                   : storage_->get(args[0]);
                             if (result.has_value()) {
                                 LOG_IMPORTANT << *result;
                                 return CommandResult::SUCCESS;
@@ -184,23 +356,69 @@ CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleSh
                             return CommandResult::FAILURE;
                         } };
 
+    // Команда вывода показателей работы
+    commands_["stats"] = { 0, true, [](const std::vector<std::string> &) -> CommandResult {
+                              LOG_IMPORTANT << Metrics::getInstance().snapshot().toPrometheus();
+                              return CommandResult::SUCCESS;
+                          } };
+
+    // Команда выхода
+    commands_["exit"] = { 0, true, [this](const std::vector<std::string> &) -> CommandResult {
+                             return CommandResult::EXIT;
+                         } };
+
+    // Хранилище другого процесса доступно только для чтения
+    if (storage_ == nullptr) {
+        commands_["help"] = {
+            0, true,
+            [this](const std::vector<std::string> &) -> CommandResult {
+                LOG_IMPORTANT
+                    << "Хранилище открыто только для чтения. Доступные команды:\n"
+                    << "  get <UUID>                   Получить строку по UUID\n"
+                    << "  stats                        Показать показатели работы хранилища\n"
+                    << "  exit                         Выход из интерактивного режима\n"
+                    << "  help                         Показать справку по доступным командам\n";
+                return CommandResult::SUCCESS;
+            }
+        };
+        return;
+    }
+
+    // Команда вставки строки
+    commands_["insert"]
+        = { 1, false, [this](const std::vector<std::string> &args) -> CommandResult {
+               const auto result = storage_->insert(args[0]);
+               if (result.has_value()) {
+                   LOG_IMPORTANT << *result;
+                   return CommandResult::SUCCESS;
+               }
+               return CommandResult::FAILURE;
+           } };
+
     // Команда обновления строки
     commands_["update"]
         = { 2, false, [this](const std::vector<std::string> &args) -> CommandResult {
-               const auto result = storage_.update(args[0], args[1]);
+               const auto result = storage_->update(args[0], args[1]);
                return result ? CommandResult::SUCCESS : CommandResult::FAILURE;
            } };
 
     // Команда удаления строки
     commands_["remove"]
         = { 1, false, [this](const std::vector<std::string> &args) -> CommandResult {
-               const auto result = storage_.remove(args[0]);
+               const auto result = storage_->remove(args[0]);
                return result ? CommandResult::SUCCESS : CommandResult::FAILURE;
            } };
 
+    // Команда загрузки строк из файла
+    commands_["import"]
+        = { 1, false, [this](const std::vector<std::string> &args) -> CommandResult {
+               return importFile(*storage_, args[0]) ? CommandResult::SUCCESS
+                                                     : CommandResult::FAILURE;
+           } };
+
     // Команда создания снапшота
     commands_["snapshot"] = { 0, true, [this](const std::vector<std::string> &) -> CommandResult {
-                                 const auto result = storage_.createSnapshot();
+                                 const auto result = storage_->createSnapshot();
                                  return result ? CommandResult::SUCCESS : CommandResult::FAILURE;
                              } };
 
@@ -209,7 +427,7 @@ CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleSh
         = { 1, true, [this](const std::vector<std::string> &args) -> CommandResult {
                try {
                    const auto threshold = std::stoul(args[0]);
-                   storage_.setSnapshotOperationsThreshold(threshold);
+                   storage_->setSnapshotOperationsThreshold(threshold);
                    return CommandResult::SUCCESS;
                }
                catch (const std::exception &e) {
@@ -223,7 +441,7 @@ CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleSh
         = { 1, true, [this](const std::vector<std::string> &args) -> CommandResult {
                try {
                    const auto minutes = std::stoul(args[0]);
-                   storage_.setSnapshotTimeThreshold(minutes);
+                   storage_->setSnapshotTimeThreshold(minutes);
                    return CommandResult::SUCCESS;
                }
                catch (const std::exception &e) {
@@ -232,11 +450,6 @@ CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleSh
                }
            } };
 
-    // Команда выхода
-    commands_["exit"] = { 0, true, [this](const std::vector<std::string> &) -> CommandResult {
-                             return CommandResult::EXIT;
-                         } };
-
     // Команда вывода справки
     commands_["help"] = {
         0, true,
@@ -247,9 +460,11 @@ CommandProcessor::CommandProcessor(octet::StorageManager &storage, bool singleSh
                 << "  get <UUID>                   Получить строку по UUID\n"
                 << "  update <UUID> <СТРОКА>       Обновить строку по UUID\n"
                 << "  remove <UUID>                Удалить строку по UUID\n"
+                << "  import <ФАЙЛ>                Загрузить строки из файла\n"
                 << "  snapshot                     Принудительно создать снапшот\n"
                 << "  set-snapshot-operations <N>  Изменить порог операций для снапшота\n"
                 << "  set-snapshot-minutes <N>     Изменить интервал снапшота в минутах\n"
+                << "  stats                        Показать показатели работы хранилища\n"
                 << "  exit                         Выход из интерактивного режима\n"
                 << "  help                         Показать справку по доступным командам\n\n"
 
@@ -266,6 +481,12 @@ CommandResult CommandProcessor::do_execute(const std::string &command,
 {
     auto it = commands_.find(command);
     if (it == commands_.end()) {
+        if (storage_ == nullptr) {
+            LOG_ERROR << "Ошибка: команда " << command
+                      << " недоступна: хранилище открыто только для чтения.\n"
+                      << "Введите `help` для получения списка доступных команд";
+            return CommandResult::FAILURE;
+        }
         LOG_ERROR << "Ошибка: неизвестная команда: " << command << ".\n"
                   << "Введите `help` для получения списка доступных команд";
         return CommandResult::FAILURE;
@@ -301,24 +522,36 @@ CommandResult CommandProcessor::do_execute(const std::string &command,
 
 CommandResult CommandProcessor::executeShot(StorageManager &storage, std::vector<std::string> args)
 {
-    if (args.empty()) {
-        LOG_ERROR << "Ошибка: необходимо указать команду для выполнения.\n"
-                  << "Введите `help` для получения списка доступных команд";
+    const auto command = takeCommand(args);
+    if (!command.has_value()) {
         return CommandResult::FAILURE;
     }
-
-    // Достаем команду из аргументов
-    const auto command = std::move(args.front());
-    args.erase(args.begin());
-
     const auto processor = CommandProcessor(storage, true);
-    return processor.do_execute(command, std::move(args));
+    return processor.do_execute(*command, std::move(args));
+}
+
+CommandResult CommandProcessor::executeShot(StorageReader &reader, std::vector<std::string> args)
+{
+    const auto command = takeCommand(args);
+    if (!command.has_value()) {
+        return CommandResult::FAILURE;
+    }
+    const auto processor = CommandProcessor(reader, true);
+    return processor.do_execute(*command, std::move(args));
 }
 
 int CommandProcessor::runInteractiveMode(StorageManager &storage)
 {
-    const auto processor = CommandProcessor(storage, false);
+    return CommandProcessor(storage, false).runInteractiveLoop();
+}
+
+int CommandProcessor::runInteractiveMode(StorageReader &reader)
+{
+    return CommandProcessor(reader, false).runInteractiveLoop();
+}
 
+int CommandProcessor::runInteractiveLoop() const
+{
     constexpr char PROMT[] = "octet> ";
     std::string input;
 
@@ -351,7 +584,7 @@ int CommandProcessor::runInteractiveMode(StorageManager &storage)
 
         // Выполняем команду
         try {
-            const auto result = processor.do_execute(command, args);
+            const auto result = do_execute(command, args);
             if (result == octet::cli::CommandResult::EXIT) {
                 LOG_IMPORTANT << "Выход из интерактивного режима";
                 return 0;
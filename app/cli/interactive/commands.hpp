@@ -6,6 +6,7 @@
 #include <vector>
 
 #include "storage/storage_manager.hpp"
+#include "storage/storage_reader.hpp"
 
 namespace octet::cli {
 /**
@@ -44,6 +45,13 @@ public:
      */
     static CommandResult executeShot(StorageManager &storage, std::vector<std::string> args);
 
+    /**
+     * @brief Одноразовое выполнение команды чтения над хранилищем другого процесса
+     * @param reader Ссылка на объект StorageReader
+     * @param args Аргументы командной строки
+     */
+    static CommandResult executeShot(StorageReader &reader, std::vector<std::string> args);
+
     /**
      * @brief Запуск интерактивного режима
      * @param storage Ссылка на объект StorageManager
@@ -51,8 +59,16 @@ public:
      */
     static int runInteractiveMode(StorageManager &storage);
 
+    /**
+     * @brief Запуск интерактивного режима только для чтения
+     * @param reader Ссылка на объект StorageReader
+     * @return Код завершения
+     */
+    static int runInteractiveMode(StorageReader &reader);
+
 private:
-    StorageManager &storage_; // Хранилище
+    StorageManager *storage_ = nullptr; // Хранилище (nullptr в режиме только для чтения)
+    StorageReader *reader_ = nullptr; // Хранилище только для чтения (nullptr, если не используется)
     std::unordered_map<std::string, Command> commands_; // Зарегестрированные команды
     bool singleShotMode_ = false;
 
@@ -63,6 +79,25 @@ private:
      */
     CommandProcessor(StorageManager &storage, bool singleShotMode);
 
+    /**
+     * @brief Конструктор с указанием хранилища только для чтения (регистрируются только команды,
+     * не изменяющие хранилище)
+     * @param reader Ссылка на объект StorageReader
+     * @param singleShotMode Процессор создается для однократного выполнения команды
+     */
+    CommandProcessor(StorageReader &reader, bool singleShotMode);
+
+    /**
+     * @brief Регистрация команд (команды изменения хранилища - только если оно открыто для записи)
+     */
+    void registerCommands();
+
+    /**
+     * @brief Цикл интерактивного режима
+     * @return Код завершения
+     */
+    int runInteractiveLoop() const;
+
     /**
      * @brief Фактическое выполнение команды
      * @param command Команда для выполнения
@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <chrono>
 #include <filesystem>
 #include <iostream>
 #include <optional>
@@ -6,8 +7,11 @@
 #include <vector>
 
 #include "interactive/commands.hpp"
+#include "server/replica.hpp"
 #include "server/server.hpp"
 #include "storage/storage_manager.hpp"
+#include "storage/storage_reader.hpp"
+#include "storage/value_allocator.hpp"
 #include "logger.hpp"
 
 // Вывод справки
@@ -28,9 +32,50 @@ void printHelp(const char *executable)
         << "Общие опции:\n"
         << "  --snapshot-operations=ЧИСЛО    Порог операций до снапшота (по умолчанию: 100)\n"
         << "  --snapshot-minutes=ЧИСЛО       Интервал снапшотов в минутах (по умолчанию: 10)\n"
+        << "  --snapshot-mode=РЕЖИМ          Способ создания снапшотов: fork (дочерний процесс\n"
+        << "                                 без копирования данных) или copy\n"
+        << "                                 (по умолчанию: fork)\n"
+        << "  --snapshot-deltas=ЧИСЛО        Разностных снапшотов до записи нового полного\n"
+        << "                                 (по умолчанию: 10, 0 - только полные снапшоты)\n"
+        << "  --compaction-mb=ЧИСЛО          Размер журнала в МБ для его уплотнения\n"
+        << "                                 (по умолчанию: 64, 0 - без ограничения)\n"
+        << "  --compaction-minutes=ЧИСЛО     Возраст сегмента журнала в минутах для его\n"
+        << "                                 уплотнения (по умолчанию: 60, 0 - без ограничения)\n"
+        << "  --segment-mb=ЧИСЛО             Размер сегмента журнала в МБ (по умолчанию: 64,\n"
+        << "                                 0 - без ограничения)\n"
+        << "  --compression=АЛГОРИТМ         Сжатие снапшотов и запечатанных сегментов журнала:\n"
+        << "                                 none, lz4 или zstd (по умолчанию: none)\n"
+        << "  --value-allocator=СПОСОБ       Выделение памяти под значения длиннее 15 байт:\n"
+        << "                                 slab (общие слэбы по классам размера) или heap\n"
+        << "                                 (отдельный буфер на значение, по умолчанию: slab)\n"
+        << "  --value-log-min=БАЙТ           Значения не короче указанной длины хранятся на\n"
+        << "                                 диске в журнале значений, а в памяти остаётся\n"
+        << "                                 только их положение (по умолчанию: 0 - все\n"
+        << "                                 значения в памяти)\n"
+        << "  --value-cache-mb=ЧИСЛО         Объём кэша значений журнала значений в МБ\n"
+        << "                                 (по умолчанию: 64, 0 - без кэша)\n"
+        << "  --durability=РЕЖИМ             Режим фиксации операций на диске\n"
+        << "                                 (по умолчанию: group)\n"
+        << "  --sync-interval=МС             Интервал синхронизации для режима interval\n"
+        << "                                 в миллисекундах (по умолчанию: 10)\n"
+        << "  --io-backend=СПОСОБ            Запись журнала и снапшотов: posix или io_uring\n"
+        << "                                 (только Linux, при недоступности используется\n"
+        << "                                 posix; по умолчанию: posix)\n"
+        << "  --read-only                    Открыть хранилище, которое ведёт другой процесс\n"
+        << "                                 octet, только для чтения (доступны команды get и\n"
+        << "                                 MGET, опции снапшотов и журнала игнорируются)\n"
         << "  --disable-warnings             Отключить вывод текстовых сообщений-предупреждений\n"
         << "  --help                         Показать справку\n\n"
 
+        << "Режимы фиксации (--durability):\n"
+        << "  sync       Каждая операция фиксируется на диске (fdatasync) до подтверждения\n"
+        << "  group      Конкурентные операции фиксируются на диске общим пакетом, операция\n"
+        << "             подтверждается после фиксации своего пакета\n"
+        << "  interval   Операции подтверждаются сразу и фиксируются на диске раз в интервал;\n"
+        << "             при сбое теряются операции за последний интервал\n"
+        << "  none       Операции подтверждаются сразу, сброс на диск выполняет ОС;\n"
+        << "             при сбое ОС теряются все не сброшенные операции\n\n"
+
         << "Режимы работы:\n"
         << "  По умолчанию octet выполняет однократную команду, если не указаны "
            "--interactive или --server.\n\n"
@@ -44,11 +89,17 @@ void printHelp(const char *executable)
         << "    insert \"<СТРОКА>\"            Вставить строку и получить ее UUID\n"
         << "    get <UUID>                   Получить строку по UUID\n"
         << "    update <UUID> \"<СТРОКА>\"     Обновить строку по UUID\n"
-        << "    remove <UUID>                Удалить строку по UUID\n\n"
+        << "    remove <UUID>                Удалить строку по UUID\n"
+        << "    import <ФАЙЛ>                Загрузить строки из файла\n\n"
 
         << "  Для корректной передачи <СТРОКА> рекомендуется заключать её в кавычки\n"
         << "  и при необходимости экранировать специальные символы.\n\n"
 
+        << "  Файл для import содержит по одной строке данных на строку файла либо начинается\n"
+        << "  с сигнатуры OCTET-IMPORT-V1 и перевода строки, за которыми следуют записи\n"
+        << "  [длина u32 LE][данные]. Ключи загруженных строк записываются в <ФАЙЛ>.uuids\n"
+        << "  в порядке строк файла, загрузка фиксируется одним снапшотом.\n\n"
+
         << "=== Интерактивный режим ===\n"
         << "  Запуск: " << executable << " --storage=ПУТЬ --interactive [ОПЦИИ]\n"
         << "  В интерактивном режиме команды вводятся построчно.\n"
@@ -61,9 +112,11 @@ void printHelp(const char *executable)
         << "    get <UUID>                   Получить строку по UUID\n"
         << "    update <UUID> <СТРОКА>       Обновить строку по UUID\n"
         << "    remove <UUID>                Удалить строку по UUID\n"
+        << "    import <ФАЙЛ>                Загрузить строки из файла\n"
         << "    snapshot                     Принудительно создать снапшот\n"
         << "    set-snapshot-operations <N>  Изменить порог операций для снапшота\n"
         << "    set-snapshot-minutes <N>     Изменить интервал снапшота в минутах\n"
+        << "    stats                        Показать показатели работы хранилища\n"
         << "    exit                         Выход из интерактивного режима\n"
         << "    help                         Показать справку по доступным командам\n\n"
 
@@ -78,7 +131,14 @@ void printHelp(const char *executable)
         << "    --snapshot-operations=ЧИСЛО  Порог операций до снапшота (по умолчанию: 100)\n"
         << "    --snapshot-minutes=ЧИСЛО     Интервал снапшотов в минутах (по умолчанию: 10)\n"
         << "    --socket=ПУТЬ                Путь к Unix-сокету (по умолчанию: /tmp/octet.sock).\n"
-        << "                                 Сокет не должен существовать.\n\n"
+        << "                                 Сокет не должен существовать.\n"
+        << "    --io-threads=ЧИСЛО           Потоков ввода-вывода для сокетов (по умолчанию: "
+        << octet::server::DEFAULT_IO_THREADS << ")\n"
+        << "    --workers=ЧИСЛО              Потоков для операций с хранилищем (по умолчанию: "
+        << octet::server::DEFAULT_WORKER_THREADS << ")\n"
+        << "    --replicate-from=СОКЕТ       Запустить горячую реплику сервера, слушающего\n"
+        << "                                 СОКЕТ: хранилище получает его операции командой\n"
+        << "                                 SUBSCRIBE, а запросы изменения отклоняются\n\n"
 
         << "  Неподдерживаемые опции для выбранного режима будут проигнорированы.\n\n";
 }
@@ -133,6 +193,24 @@ bool checkLastArgs(const std::vector<std::string> &args)
     return false;
 }
 
+// Преобразование названия режима фиксации в DurabilityMode
+std::optional<octet::DurabilityMode> parseDurabilityMode(const std::string &value)
+{
+    if (value == "sync") {
+        return octet::DurabilityMode::SYNC;
+    }
+    if (value == "group") {
+        return octet::DurabilityMode::GROUP_COMMIT;
+    }
+    if (value == "interval") {
+        return octet::DurabilityMode::INTERVAL;
+    }
+    if (value == "none") {
+        return octet::DurabilityMode::NONE;
+    }
+    return std::nullopt;
+}
+
 int main(int argc, char *argv[])
 {
     // Получение команды запуска
@@ -152,8 +230,10 @@ int main(int argc, char *argv[])
     // Получение параметров
     const auto interactiveMode = hasFlag("--interactive", args);
     const auto serverMode = hasFlag("--server", args);
+    const auto readOnlyMode = hasFlag("--read-only", args);
     const auto disableWarnings = hasFlag("disable-warnings", args);
     const auto socketPath = getOptionValue("--socket", args);
+    const auto replicateFrom = getOptionValue("--replicate-from", args);
     std::optional<size_t> snapshotOpsThreshold;
     std::optional<size_t> snapshotTimeThreshold;
 
@@ -195,23 +275,269 @@ int main(int argc, char *argv[])
         }
     }
 
+    // Парсинг порогов уплотнения журнала
+    std::optional<uint64_t> compactionSizeMb;
+    const auto compactionSizeOption = getOptionValue("--compaction-mb", args);
+    if (compactionSizeOption.has_value()) {
+        try {
+            compactionSizeMb = std::stoull(*compactionSizeOption);
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --compaction-mb";
+            return 1;
+        }
+    }
+    std::optional<size_t> compactionMinutes;
+    const auto compactionMinutesOption = getOptionValue("--compaction-minutes", args);
+    if (compactionMinutesOption.has_value()) {
+        try {
+            compactionMinutes = std::stoul(*compactionMinutesOption);
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --compaction-minutes";
+            return 1;
+        }
+    }
+
+    std::optional<uint64_t> segmentSizeMb;
+    const auto segmentSizeOption = getOptionValue("--segment-mb", args);
+    if (segmentSizeOption.has_value()) {
+        try {
+            segmentSizeMb = std::stoull(*segmentSizeOption);
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --segment-mb";
+            return 1;
+        }
+    }
+
+    // Парсинг способа создания снапшотов
+    std::optional<octet::SnapshotMode> snapshotMode;
+    const auto snapshotModeOption = getOptionValue("--snapshot-mode", args);
+    if (snapshotModeOption.has_value()) {
+        if (*snapshotModeOption == "fork") {
+            snapshotMode = octet::SnapshotMode::FORK;
+        }
+        else if (*snapshotModeOption == "copy") {
+            snapshotMode = octet::SnapshotMode::COPY;
+        }
+        else {
+            LOG_ERROR << "Ошибка: некорректное значение для --snapshot-mode (допустимо: fork, "
+                         "copy)";
+            return 1;
+        }
+    }
+
+    std::optional<size_t> snapshotDeltaLimit;
+    const auto snapshotDeltasOption = getOptionValue("--snapshot-deltas", args);
+    if (snapshotDeltasOption.has_value()) {
+        try {
+            snapshotDeltaLimit = std::stoul(*snapshotDeltasOption);
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --snapshot-deltas";
+            return 1;
+        }
+    }
+
+    // Парсинг алгоритма сжатия (поддержка проверяется до открытия хранилища)
+    std::optional<octet::CompressionCodec> compressionCodec;
+    const auto compressionOption = getOptionValue("--compression", args);
+    if (compressionOption.has_value()) {
+        if (*compressionOption == "none") {
+            compressionCodec = octet::CompressionCodec::NONE;
+        }
+        else if (*compressionOption == "lz4") {
+            compressionCodec = octet::CompressionCodec::LZ4;
+        }
+        else if (*compressionOption == "zstd") {
+            compressionCodec = octet::CompressionCodec::ZSTD;
+        }
+        else {
+            LOG_ERROR << "Ошибка: некорректное значение для --compression (допустимо: none, lz4, "
+                         "zstd)";
+            return 1;
+        }
+        if (!octet::JournalManager::isCompressionCodecSupported(*compressionCodec)) {
+            LOG_ERROR << "Ошибка: octet собран без поддержки сжатия " << *compressionOption;
+            return 1;
+        }
+    }
+
+    // Способ выделения значений задаётся до загрузки хранилища, так как действует на весь процесс
+    const auto valueAllocatorOption = getOptionValue("--value-allocator", args);
+    if (valueAllocatorOption.has_value()) {
+        if (*valueAllocatorOption == "slab") {
+            octet::ValueAllocator::setDefaultAllocation(octet::ValueAllocation::SLAB);
+        }
+        else if (*valueAllocatorOption == "heap") {
+            octet::ValueAllocator::setDefaultAllocation(octet::ValueAllocation::HEAP);
+        }
+        else {
+            LOG_ERROR << "Ошибка: некорректное значение для --value-allocator (допустимо: slab, "
+                         "heap)";
+            return 1;
+        }
+    }
+
+    // Парсинг параметров журнала значений
+    octet::ValueLogPolicy valueLog;
+    const auto valueLogMinOption = getOptionValue("--value-log-min", args);
+    if (valueLogMinOption.has_value()) {
+        try {
+            valueLog.minValueSize = std::stoul(*valueLogMinOption);
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --value-log-min";
+            return 1;
+        }
+    }
+    const auto valueCacheOption = getOptionValue("--value-cache-mb", args);
+    if (valueCacheOption.has_value()) {
+        try {
+            valueLog.cacheBytes = std::stoul(*valueCacheOption) * 1024 * 1024;
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --value-cache-mb";
+            return 1;
+        }
+    }
+
+    // Парсинг политики фиксации операций
+    octet::DurabilityPolicy durability{ octet::DurabilityMode::GROUP_COMMIT };
+    const auto durabilityOption = getOptionValue("--durability", args);
+    if (durabilityOption.has_value()) {
+        const auto mode = parseDurabilityMode(*durabilityOption);
+        if (!mode.has_value()) {
+            LOG_ERROR << "Ошибка: некорректное значение для --durability (допустимо: sync, group, "
+                         "interval, none)";
+            return 1;
+        }
+        durability.mode = *mode;
+    }
+    const auto syncIntervalOption = getOptionValue("--sync-interval", args);
+    if (syncIntervalOption.has_value()) {
+        try {
+            durability.syncInterval = std::chrono::milliseconds(std::stoul(*syncIntervalOption));
+        }
+        catch (const std::exception &e) {
+            LOG_ERROR << "Ошибка: некорректное значение для --sync-interval";
+            return 1;
+        }
+    }
+    const auto ioBackendOption = getOptionValue("--io-backend", args);
+    if (ioBackendOption.has_value()) {
+        if (*ioBackendOption == "posix") {
+            durability.ioBackend = octet::IoBackend::POSIX;
+        }
+        else if (*ioBackendOption == "io_uring") {
+            durability.ioBackend = octet::IoBackend::IO_URING;
+        }
+        else {
+            LOG_ERROR << "Ошибка: некорректное значение для --io-backend (допустимо: posix, "
+                         "io_uring)";
+            return 1;
+        }
+    }
+
+    // Парсинг параметров потоков сервера
+    octet::server::ServerConfig serverConfig;
+    const auto ioThreadsOption = getOptionValue("--io-threads", args);
+    if (ioThreadsOption.has_value()) {
+        try {
+            serverConfig.ioThreads = std::stoul(*ioThreadsOption);
+        }
+        catch (const std::exception &e) {
+            serverConfig.ioThreads = 0;
+        }
+        if (serverConfig.ioThreads == 0) {
+            LOG_ERROR << "Ошибка: некорректное значение для --io-threads";
+            return 1;
+        }
+    }
+    const auto workersOption = getOptionValue("--workers", args);
+    if (workersOption.has_value()) {
+        try {
+            serverConfig.workerThreads = std::stoul(*workersOption);
+        }
+        catch (const std::exception &e) {
+            serverConfig.workerThreads = 0;
+        }
+        if (serverConfig.workerThreads == 0) {
+            LOG_ERROR << "Ошибка: некорректное значение для --workers";
+            return 1;
+        }
+    }
+
+    // Реплика принимает только запросы чтения, а хранилище изменяет поток репликации
+    if (replicateFrom.has_value()) {
+        if (!serverMode || readOnlyMode) {
+            LOG_ERROR << "Ошибка: --replicate-from используется только с --server и без "
+                         "--read-only";
+            return 1;
+        }
+        serverConfig.readOnly = true;
+    }
+
     // Для интерактивного и серверного режимов не должно остаться аргументов
     if ((interactiveMode || serverMode) && !checkLastArgs(args)) {
         return 1;
     }
 
+    // Хранилище, которое ведёт другой процесс, открывается только для чтения: снапшот
+    // отображается в память, а новые записи дочитываются из журнала
+    if (readOnlyMode) {
+        octet::StorageReader reader(storagePath);
+        if (serverMode) {
+            octet::Logger::getInstance().setAsync(true);
+            return octet::server::Server::startServer(reader, socketPath, serverConfig);
+        }
+        if (interactiveMode) {
+            return octet::cli::CommandProcessor::runInteractiveMode(reader);
+        }
+        const auto result = octet::cli::CommandProcessor::executeShot(reader, std::move(args));
+        return result == octet::cli::CommandResult::SUCCESS ? 0 : 1;
+    }
+
     // Инициализация StorageManager
-    octet::StorageManager storage(std::move(storagePath));
+    octet::StorageManager storage(storagePath, durability, valueLog);
     if (snapshotOpsThreshold.has_value()) {
         storage.setSnapshotOperationsThreshold(*snapshotOpsThreshold);
     }
     if (snapshotTimeThreshold.has_value()) {
         storage.setSnapshotTimeThreshold(*snapshotTimeThreshold);
     }
+    if (snapshotMode.has_value()) {
+        storage.setSnapshotMode(*snapshotMode);
+    }
+    if (snapshotDeltaLimit.has_value()) {
+        storage.setSnapshotDeltaLimit(*snapshotDeltaLimit);
+    }
+    if (compactionSizeMb.has_value()) {
+        storage.setJournalCompactionSizeThreshold(*compactionSizeMb * 1024 * 1024);
+    }
+    if (compactionMinutes.has_value()) {
+        storage.setJournalCompactionTimeThreshold(*compactionMinutes);
+    }
+    if (segmentSizeMb.has_value()) {
+        storage.setJournalSegmentSize(*segmentSizeMb * 1024 * 1024);
+    }
+    if (compressionCodec.has_value()) {
+        storage.setCompressionCodec(*compressionCodec);
+    }
 
     // Запуск в серверном режиме
     if (serverMode) {
-        return octet::server::Server::startServer(storage, socketPath);
+        // Сообщения обработчиков запросов выводятся фоновым потоком записи
+        octet::Logger::getInstance().setAsync(true);
+        if (!replicateFrom.has_value()) {
+            return octet::server::Server::startServer(storage, socketPath, serverConfig);
+        }
+        octet::server::Replica replica(storage, storagePath, *replicateFrom);
+        replica.start();
+        const auto code = octet::server::Server::startServer(storage, socketPath, serverConfig);
+        replica.stop();
+        return code;
     }
 
     // Запуск в интерактивном режиме
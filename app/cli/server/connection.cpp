@@ -1,23 +1,47 @@
 #include "connection.hpp"
 
+#include <algorithm>
+
 #include "logger.hpp"
+#include "metrics.hpp"
 
 namespace octet::server {
-// Максимальный размер буфера чтения (16 КБ)
-constexpr uint16_t MAX_BUFFER_SIZE = 16384;
+// Начальный размер буфера чтения (16 КБ)
+constexpr size_t INITIAL_BUFFER_SIZE = 16384;
+// Минимальный размер свободного места для одного чтения из сокета (16 КБ)
+constexpr size_t READ_CHUNK_SIZE = 16384;
+// Максимальное количество одновременно выполняемых запросов одного соединения: при его
+// достижении чтение приостанавливается до получения ответов
+constexpr size_t MAX_PENDING_REQUESTS = 256;
+// Максимальное количество кадров, отправляемых одной записью с разбросом
+constexpr size_t MAX_GATHER_FRAMES = 32;
+// Желаемый размер записей журнала в одном ответе SUBSCRIBE (4 МБ)
+constexpr size_t REPLICATION_CHUNK_SIZE = 4 * 1024 * 1024;
 
 Connection::SharedConnection Connection::create(boost::asio::io_context &io_context,
-                                                StorageManager &storage)
+                                                boost::asio::thread_pool &workers,
+                                                StorageManager *storage,
+                                                StorageReader *reader, bool readOnly)
+{
+    return SharedConnection(new Connection(io_context, workers, storage, reader, readOnly));
+}
+
+Connection::Connection(boost::asio::io_context &io_context, boost::asio::thread_pool &workers,
+                       StorageManager *storage, StorageReader *reader, bool readOnly)
+    : storage_(storage)
+    , reader_(reader)
+    , readOnly_(readOnly)
+    , workers_(workers)
+    , socket_(boost::asio::make_strand(io_context))
+    , readBuffer_(INITIAL_BUFFER_SIZE)
 {
-    return SharedConnection(new Connection(io_context, storage));
 }
 
-Connection::Connection(boost::asio::io_context &io_context, StorageManager &storage)
-    : socket_(io_context)
-    , storage_(storage)
+Connection::~Connection()
 {
-    // Резервируем место для чтения
-    readBuffer_.reserve(MAX_BUFFER_SIZE);
+    // Кадры, которые так и не были отправлены, больше не учитываются в очередях записи
+    Metrics::getInstance().addGauge(MetricGauge::WRITE_QUEUE_DEPTH,
+                                    -static_cast<int64_t>(writeQueue_.size()));
 }
 
 boost::asio::local::stream_protocol::socket &Connection::socket()
@@ -28,21 +52,28 @@ boost::asio::local::stream_protocol::socket &Connection::socket()
 void Connection::start()
 {
     LOG_DEBUG << "Новое соединение установлено";
-    read();
+    // Чтение начинается в strand сокета, а не в потоке аксептора
+    boost::asio::dispatch(socket_.get_executor(), [self = shared_from_this()] { self->read(); });
 }
 
 void Connection::read()
 {
-    // Предотвращаем уничтожение указателя во время чтения
-    auto self(shared_from_this());
-
-    // Создаем временный буфер
-    auto tmpBuffer = std::make_shared<std::vector<uint8_t>>(1024);
+    if (ProtocolFrame::exceedsMaxSize(readBuffer_)) {
+        LOG_ERROR << "Размер запроса превышает допустимый (" << MAX_FRAME_SIZE
+                  << " байт), соединение закрывается";
+        boost::system::error_code ec;
+        socket_.close(ec);
+        return;
+    }
+    // Свободного места должно хватить на оставшуюся часть текущего кадра, чтобы большой запрос
+    // читался без промежуточных копирований
+    const auto missing = ProtocolFrame::missingBytes(readBuffer_);
+    auto *data = readBuffer_.prepare(std::max(missing, READ_CHUNK_SIZE));
 
-    // Асинхронное чтение
+    // Асинхронное чтение прямо в буфер
     socket_.async_read_some(
-        boost::asio::buffer(*tmpBuffer), [this, self = shared_from_this(), tmpBuffer](
-                                             boost::system::error_code ec, std::size_t length) {
+        boost::asio::buffer(data, readBuffer_.writable()),
+        [this, self = shared_from_this()](boost::system::error_code ec, std::size_t length) {
             // Обрабатываем ошибки
             if (ec) {
                 if (ec != boost::asio::error::operation_aborted) {
@@ -57,19 +88,17 @@ void Connection::read()
                 read(); // Повторяем чтение
                 return;
             }
-
-            // Чистим буффер, если у нас переполнение
-            if (readBuffer_.size() + length > MAX_BUFFER_SIZE) {
-                LOG_ERROR << "Переполнение буфера чтения, очищаем";
-                readBuffer_.clear();
-            }
-            // Добавляем данные в буфер
-            readBuffer_.insert(readBuffer_.end(), tmpBuffer->begin(), tmpBuffer->begin() + length);
+            readBuffer_.commit(length);
 
             // Обрабатываем сообщения из буфера
             processMessages();
 
-            // Продолжаем чтение
+            // Продолжаем чтение, если клиент не превысил лимит одновременных запросов
+            if (pendingRequests_ >= MAX_PENDING_REQUESTS) {
+                LOG_DEBUG << "Чтение приостановлено до получения ответов на запросы";
+                readPaused_ = true;
+                return;
+            }
             read();
         });
 }
@@ -77,44 +106,111 @@ void Connection::read()
 void Connection::processMessages()
 {
     while (true) {
-        const auto jsonMessage = ProtocolFrame::extractMessage(readBuffer_);
-        if (!jsonMessage.has_value()) {
+        const auto message = ProtocolFrame::extractMessage(readBuffer_);
+        if (!message.has_value()) {
             break; // Нет полных сообщений, выходим из цикла
         }
-        LOG_DEBUG << "Извлечено сообщение: " << *jsonMessage;
+        const auto format = ProtocolFrame::messageFormat(*message);
+        if (format == MessageFormat::JSON) {
+            LOG_DEBUG << "Извлечено сообщение: " << *message;
+        }
+        else {
+            LOG_DEBUG << "Извлечено двоичное сообщение: " << message->size() << " байт";
+        }
 
-        // Разбираем запрос
-        const auto request = Request::fromJson(*jsonMessage);
+        // Разбираем запрос: крупные данные INSERT и UPDATE остаются в памяти буфера чтения и
+        // копируются только в хранилище
+        auto request = Request::parse(*message, readBuffer_.share());
         if (request.has_value()) {
-            // Обрабатываем запрос и отправляем ответ
-            const auto response = handleRequest(*request);
-            write(response);
+            // Передаём запрос в пул, ответ будет отправлен по готовности в формате запроса
+            dispatch(std::move(*request), format);
         }
         else {
-            LOG_ERROR << "Некорректный формат запроса: " << *jsonMessage;
+            if (format == MessageFormat::JSON) {
+                LOG_ERROR << "Некорректный формат запроса: " << *message;
+            }
             // Отправляем ошибку
             Response errorResponse;
             errorResponse.requestId = "error";
             errorResponse.success = false;
             errorResponse.error = "Invalid request format";
-            write(errorResponse);
+            write(errorResponse, format);
         }
     }
 }
 
-void Connection::write(const Response &response)
+void Connection::dispatch(Request request, MessageFormat format)
 {
-    // Сериализуем ответ в JSON
-    const auto jsonResponse = response.toJson();
-
-    // Создаем новый буфер
-    auto buffer = std::make_shared<std::vector<uint8_t>>(ProtocolFrame::wrapMessage(jsonResponse));
-    // Помещаем буфер в очередь
-    {
-        std::lock_guard<std::mutex> lock(writeMutex_);
-        writeQueue_.push(buffer);
+    // PING не обращается к хранилищу и отвечается сразу
+    if (request.command == CommandType::PING) {
+        write(handleRequest(request), format);
+        return;
+    }
+    // Записи журнала не являются текстом, поэтому поток репликации передаётся только в
+    // двоичном формате
+    if (request.command == CommandType::SUBSCRIBE && format != MessageFormat::BINARY) {
+        Response response;
+        response.requestId = request.requestId;
+        response.success = false;
+        response.error = "SUBSCRIBE requires binary protocol";
+        write(response, format);
+        return;
     }
 
+    pendingRequests_++;
+    boost::asio::post(workers_, [this, self = shared_from_this(), request = std::move(request),
+                                 format]() mutable {
+        // Сериализация ответа тоже выполняется в пуле, в strand передаётся готовый кадр
+        auto frame = request.command == CommandType::GET ? readValue(request, format) : nullptr;
+        if (frame == nullptr) {
+            frame = makeFrame(handleRequest(request), format);
+        }
+        // Память буфера чтения освобождается до ответа, чтобы следующее чтение могло её
+        // переиспользовать
+        request.frame.reset();
+        boost::asio::post(socket_.get_executor(), [this, self, frame = std::move(frame)] {
+            complete(frame);
+        });
+    });
+}
+
+void Connection::complete(std::shared_ptr<OutgoingFrame> frame)
+{
+    pendingRequests_--;
+    queueWrite(std::move(frame));
+
+    // Возобновляем чтение, приостановленное из-за лимита одновременных запросов
+    if (readPaused_ && pendingRequests_ < MAX_PENDING_REQUESTS) {
+        readPaused_ = false;
+        read();
+    }
+}
+
+std::shared_ptr<OutgoingFrame> Connection::makeFrame(const Response &response,
+                                                     MessageFormat format)
+{
+    auto frame = framePool_.acquire();
+    // Ответ, который нельзя представить в двоичном формате, отправляется в JSON: клиент
+    // определяет формат каждого сообщения по первому байту
+    if (format != MessageFormat::BINARY || !response.toBinary(frame->body)) {
+        response.toJson(frame->body);
+    }
+    ProtocolFrame::wrapMessage(*frame);
+    return frame;
+}
+
+void Connection::write(const Response &response, MessageFormat format)
+{
+    queueWrite(makeFrame(response, format));
+}
+
+void Connection::queueWrite(std::shared_ptr<OutgoingFrame> frame)
+{
+    // Очередь используется только в strand сокета, поэтому дополнительная синхронизация не нужна
+    writeQueue_.push(std::move(frame));
+    Metrics::getInstance().addGauge(MetricGauge::WRITE_QUEUE_DEPTH, 1);
+    Metrics::getInstance().record(MetricHistogram::WRITE_QUEUE_DEPTH, writeQueue_.size());
+
     // Если запись уже идет, то выходим - текущая операция запустит следующую при завершении
     if (writeInProgress_) {
         return;
@@ -128,49 +224,94 @@ void Connection::do_write()
     // Предотвращаем уничтожение указателя во время записи
     auto self(shared_from_this());
 
-    // Блокируем доступ к очереди на время проверки и извлечения
-    std::shared_ptr<std::vector<uint8_t>> buffer;
-    {
-        std::lock_guard<std::mutex> lock(writeMutex_);
-        // Если очередь пуста, отмечаем, что запись не выполняется, и выходим
-        if (writeQueue_.empty()) {
-            writeInProgress_ = false;
-            return;
-        }
-        // Отмечаем, что запись выполняется
-        writeInProgress_ = true;
-        // Получаем буфер из начала очереди
-        buffer = writeQueue_.front();
+    // Если очередь пуста, отмечаем, что запись не выполняется, и выходим
+    if (writeQueue_.empty()) {
+        writeInProgress_ = false;
+        return;
+    }
+    // Отмечаем, что запись выполняется
+    writeInProgress_ = true;
+
+    // Забираем накопившиеся кадры: заголовки и тела передаются в сокет отдельными буферами
+    writeBuffers_.clear();
+    while (!writeQueue_.empty() && writingFrames_.size() < MAX_GATHER_FRAMES) {
+        auto &frame = writeQueue_.front();
+        writeBuffers_.push_back(boost::asio::buffer(frame->header));
+        writeBuffers_.push_back(boost::asio::buffer(frame->body));
+        writingFrames_.push_back(std::move(frame));
         writeQueue_.pop();
     }
+    Metrics::getInstance().addGauge(MetricGauge::WRITE_QUEUE_DEPTH,
+                                    -static_cast<int64_t>(writingFrames_.size()));
 
     // Асинхронная запись данных
-    boost::asio::async_write(socket_, boost::asio::buffer(*buffer),
-                             [this, self, buffer](boost::system::error_code ec, std::size_t) {
+    boost::asio::async_write(socket_, writeBuffers_,
+                             [this, self](boost::system::error_code ec, std::size_t) {
                                  if (ec && ec != boost::asio::error::operation_aborted) {
                                      LOG_ERROR << "Ошибка при записи: " << ec.message();
                                  }
+                                 // Возвращаем отправленные кадры в пул
+                                 for (auto &frame : writingFrames_) {
+                                     framePool_.release(std::move(frame));
+                                 }
+                                 writingFrames_.clear();
                                  // Запускаем следующую операцию записи
                                  do_write();
                              });
 }
 
-Response Connection::handleRequest(const Request &request)
+std::shared_ptr<OutgoingFrame> Connection::readValue(const Request &request, MessageFormat format)
+{
+    if (storage_ == nullptr || !request.uuid.has_value()) {
+        return nullptr;
+    }
+
+    Response response;
+    response.requestId = request.requestId;
+    response.success = true;
+    std::shared_ptr<OutgoingFrame> frame;
+    storage_->read(*request.uuid, [&](std::string_view value) {
+        response.dataView = value;
+        frame = makeFrame(response, format);
+    });
+    return frame;
+}
+
+Response Connection::handleRequest(Request &request)
 {
     Response response;
     response.requestId = request.requestId;
     response.success = true;
 
+    // Хранилище другого процесса и хранилище реплики доступны только для чтения
+    const auto modifiesStorage = request.command == CommandType::INSERT
+                                 || request.command == CommandType::UPDATE
+                                 || request.command == CommandType::REMOVE
+                                 || request.command == CommandType::BATCH
+                                 || request.command == CommandType::IMPORT;
+    if (modifiesStorage && (storage_ == nullptr || readOnly_)) {
+        response.success = false;
+        response.error = "Storage is read-only";
+        return response;
+    }
+    // Поток репликации читается из журнала, который ведёт этот процесс
+    if (request.command == CommandType::SUBSCRIBE && storage_ == nullptr) {
+        response.success = false;
+        response.error = "Replication is not available for read-only storage";
+        return response;
+    }
+
     try {
         switch (request.command) {
         case CommandType::INSERT: {
-            if (!request.data.has_value()) {
+            const auto data = request.payload();
+            if (!data.has_value()) {
                 response.success = false;
                 response.error = "Missing data for INSERT";
                 break;
             }
 
-            auto result = storage_.insert(*request.data);
+            auto result = storage_->insert(*data);
             if (result.has_value()) {
                 response.uuid = std::move(*result);
             }
@@ -187,7 +328,8 @@ Response Connection::handleRequest(const Request &request)
                 break;
             }
 
-            auto result = storage_.get(*request.uuid);
+            auto result = reader_ != nullptr ? reader_->get(*request.uuid)
+                                             : storage_->get(*request.uuid);
             if (result.has_value()) {
                 response.data = std::move(*result);
             }
@@ -198,13 +340,14 @@ Response Connection::handleRequest(const Request &request)
             break;
         }
         case CommandType::UPDATE: {
-            if (!request.uuid.has_value() || !request.data.has_value()) {
+            const auto data = request.payload();
+            if (!request.uuid.has_value() || !data.has_value()) {
                 response.success = false;
                 response.error = "Missing UUID or data for UPDATE";
                 break;
             }
 
-            const auto result = storage_.update(*request.uuid, *request.data);
+            const auto result = storage_->update(*request.uuid, *data);
             if (!result) {
                 response.success = false;
                 response.error = "Failed to update item";
@@ -218,14 +361,141 @@ Response Connection::handleRequest(const Request &request)
                 break;
             }
 
-            const auto result = storage_.remove(*request.uuid);
+            const auto result = storage_->remove(*request.uuid);
             if (!result) {
                 response.success = false;
                 response.error = "Failed to remove item";
             }
             break;
         }
+        case CommandType::BATCH: {
+            if (!request.operations.has_value() || request.operations->empty()) {
+                response.success = false;
+                response.error = "Missing operations for BATCH";
+                break;
+            }
+
+            std::vector<BatchOperation> operations;
+            operations.reserve(request.operations->size());
+            for (auto &operation : *request.operations) {
+                BatchOperation batchOperation;
+                switch (operation.command) {
+                case CommandType::INSERT:
+                    batchOperation.type = OperationType::INSERT;
+                    break;
+                case CommandType::UPDATE:
+                    batchOperation.type = OperationType::UPDATE;
+                    break;
+                case CommandType::REMOVE:
+                    batchOperation.type = OperationType::REMOVE;
+                    break;
+                default:
+                    response.success = false;
+                    response.error = "Unsupported command in BATCH";
+                    break;
+                }
+                const auto needsUuid = operation.command != CommandType::INSERT;
+                const auto needsData = operation.command != CommandType::REMOVE;
+                if (response.success
+                    && ((needsUuid && !operation.uuid.has_value())
+                        || (needsData && !operation.data.has_value()))) {
+                    response.success = false;
+                    response.error = "Missing UUID or data for operation in BATCH";
+                }
+                if (!response.success) {
+                    break;
+                }
+                // Данные перемещаются из запроса, чтобы не копировать их ещё раз
+                if (operation.uuid.has_value()) {
+                    batchOperation.uuid = std::move(*operation.uuid);
+                }
+                if (operation.data.has_value()) {
+                    batchOperation.data = std::move(*operation.data);
+                }
+                operations.push_back(std::move(batchOperation));
+            }
+            if (!response.success) {
+                break;
+            }
+
+            auto result = storage_->applyBatch(operations);
+            if (result.has_value()) {
+                response.uuids = std::move(*result);
+            }
+            else {
+                response.success = false;
+                response.error = "Failed to apply batch";
+            }
+            break;
+        }
+        case CommandType::IMPORT: {
+            if (!request.values.has_value() || request.values->empty()) {
+                response.success = false;
+                response.error = "Missing values for IMPORT";
+                break;
+            }
+
+            // Строки загружаются без журналирования каждой. Загрузка из нескольких запросов
+            // фиксируется одним снапшотом в последнем из них (без признака partial), поэтому
+            // подтверждённые им строки переживают сбой
+            const std::vector<std::string_view> values(request.values->begin(),
+                                                       request.values->end());
+            std::vector<Uuid> keys;
+            if (!storage_->importValues(values, &keys)) {
+                response.success = false;
+                response.error = "Failed to import values";
+                break;
+            }
+            auto &uuids = response.uuids.emplace();
+            uuids.reserve(keys.size());
+            for (const auto &key : keys) {
+                uuids.push_back(key.toString());
+            }
+            // Загруженные строки уже видны читателям, поэтому при ошибке снапшота они остаются
+            // в хранилище и попадут на диск со следующим снапшотом
+            if (!request.partial && !storage_->finishImport()) {
+                response.success = false;
+                response.error = "Values imported but not persisted: snapshot failed";
+            }
+            break;
+        }
+        case CommandType::MGET: {
+            if (!request.uuids.has_value()) {
+                response.success = false;
+                response.error = "Missing uuids for MGET";
+                break;
+            }
+
+            response.values = reader_ != nullptr ? reader_->getMany(*request.uuids)
+                                                 : storage_->getMany(*request.uuids);
+            break;
+        }
         case CommandType::PING: {
+            // Согласование формата сообщений: подтверждаем двоичный формат, если клиент его
+            // запросил (иначе клиент продолжает использовать JSON)
+            if (request.protocol.has_value() && *request.protocol == BINARY_PROTOCOL_NAME) {
+                response.protocol = std::string(BINARY_PROTOCOL_NAME);
+            }
+            break;
+        }
+        case CommandType::STATS: {
+            response.data = Metrics::getInstance().snapshot().toPrometheus();
+            break;
+        }
+        case CommandType::SUBSCRIBE: {
+            std::lock_guard<std::mutex> lock(replicationMutex_);
+            if (replication_ == nullptr) {
+                replication_ = std::make_unique<ReplicationSource>(*storage_);
+            }
+            ReplicationChunk chunk;
+            if (!replication_->read(request.position, REPLICATION_CHUNK_SIZE, chunk)) {
+                response.success = false;
+                response.error = "Failed to read replication stream";
+                break;
+            }
+            response.data = std::move(chunk.records);
+            response.position = std::move(chunk.next);
+            response.reset = chunk.reset;
             break;
         }
         case CommandType::UNKNOWN:
@@ -7,12 +7,20 @@
 #include <boost/asio.hpp>
 
 #include "protocol.hpp"
+#include "storage/replication.hpp"
 #include "storage/storage_manager.hpp"
+#include "storage/storage_reader.hpp"
 
 namespace octet::server {
 /**
  * @class Connection
- * @brief Класс, обрабатывающий одно соединение с клиентом
+ * @brief Класс, обрабатывающий одно соединение с клиентом.
+ *
+ * Все операции с сокетом и состоянием соединения выполняются в strand сокета, а запросы к
+ * хранилищу - в пуле рабочих потоков. Поэтому соединение продолжает читать и разбирать
+ * следующие запросы (конвейер), пока предыдущие ещё фиксируются на диске, а ответы
+ * отправляются по мере готовности и могут идти не в порядке запросов (клиент сопоставляет их
+ * по requestId).
  */
 class Connection : public std::enable_shared_from_this<Connection> {
 public:
@@ -21,10 +29,21 @@ public:
     /**
      * @brief Создает новое соединение
      * @param ioCtx ASIO контекст
-     * @param storage Ссылка на хранилище
+     * @param workers Пул потоков для операций с хранилищем
+     * @param storage Хранилище (nullptr в режиме только для чтения)
+     * @param reader Хранилище только для чтения (nullptr, если не используется)
+     * @param readOnly Отклонять запросы изменения хранилища (хранилище реплики изменяет только
+     * поток репликации)
      * @return Указатель на новое соединение
      */
-    static SharedConnection create(boost::asio::io_context &ioCtx, StorageManager &storage);
+    static SharedConnection create(boost::asio::io_context &ioCtx,
+                                   boost::asio::thread_pool &workers, StorageManager *storage,
+                                   StorageReader *reader, bool readOnly = false);
+
+    /**
+     * @brief Деструктор
+     */
+    ~Connection();
 
     /**
      * @brief Получить сокет
@@ -38,19 +57,34 @@ public:
     void start();
 
 private:
-    StorageManager &storage_; // Хранилище
-    boost::asio::local::stream_protocol::socket socket_; // Сокет
-    std::vector<uint8_t> readBuffer_; // Буфер для чтения
-    std::queue<std::shared_ptr<std::vector<uint8_t>>> writeQueue_; // Очередь буферов для записи
-    std::mutex writeMutex_; // Мьютекс для защиты очереди записи
-    bool writeInProgress_; // Выполняется ли в данный момент операция записи
+    StorageManager *storage_; // Хранилище (nullptr в режиме только для чтения)
+    StorageReader *reader_; // Хранилище только для чтения (nullptr, если не используется)
+    const bool readOnly_; // Отклонять ли запросы изменения хранилища
+    boost::asio::thread_pool &workers_; // Пул потоков для операций с хранилищем
+    boost::asio::local::stream_protocol::socket socket_; // Сокет (со своим strand)
+    FrameBuffer readBuffer_; // Буфер для чтения
+    FramePool framePool_; // Пул кадров ответа
+    std::queue<std::shared_ptr<OutgoingFrame>> writeQueue_; // Очередь кадров для записи
+    std::vector<std::shared_ptr<OutgoingFrame>> writingFrames_; // Кадры текущей записи
+    std::vector<boost::asio::const_buffer> writeBuffers_; // Заголовки и тела кадров записи
+    bool writeInProgress_ = false; // Выполняется ли в данный момент операция записи
+    size_t pendingRequests_ = 0; // Запросы, переданные в пул и ещё не получившие ответа
+    bool readPaused_ = false; // Чтение приостановлено из-за слишком большого числа запросов
+    // Поток репликации реплики, подписавшейся через это соединение (создаётся при первом
+    // запросе SUBSCRIBE, запросы которого выполняются в пуле по очереди)
+    std::unique_ptr<ReplicationSource> replication_;
+    std::mutex replicationMutex_;
 
     /**
      * @brief Конструктор
      * @param ioCtx ASIO контекст
-     * @param storage Ссылка на хранилище
+     * @param workers Пул потоков для операций с хранилищем
+     * @param storage Хранилище (nullptr в режиме только для чтения)
+     * @param reader Хранилище только для чтения (nullptr, если не используется)
+     * @param readOnly Отклонять запросы изменения хранилища
      */
-    Connection(boost::asio::io_context &ioCtx, StorageManager &storage);
+    Connection(boost::asio::io_context &ioCtx, boost::asio::thread_pool &workers,
+               StorageManager *storage, StorageReader *reader, bool readOnly);
 
     /**
      * @brief Асинхронное чтение данных
@@ -62,23 +96,61 @@ private:
      */
     void processMessages();
 
+    /**
+     * @brief Передача запроса на выполнение в пул потоков хранилища
+     * @param request Запрос
+     * @param format Формат сообщения запроса (в нём же отправляется ответ)
+     */
+    void dispatch(Request request, MessageFormat format);
+
+    /**
+     * @brief Завершение запроса, выполненного в пуле: отправка ответа и возобновление чтения
+     * @param frame Кадр ответа
+     */
+    void complete(std::shared_ptr<OutgoingFrame> frame);
+
+    /**
+     * @brief Сериализация ответа в кадр из пула
+     * @param response Ответ
+     * @param format Формат сообщения
+     * @return Кадр ответа
+     */
+    std::shared_ptr<OutgoingFrame> makeFrame(const Response &response, MessageFormat format);
+
     /**
      * @brief Постановка данных в очередь на отправку
      * @param response Ответ для отправки
+     * @param format Формат сообщения
+     */
+    void write(const Response &response, MessageFormat format);
+
+    /**
+     * @brief Постановка готового кадра в очередь на отправку
+     * @param frame Кадр ответа
      */
-    void write(const Response &response);
+    void queueWrite(std::shared_ptr<OutgoingFrame> frame);
 
     /**
-     * @brief Асинхронная запись сообщения из очереди
+     * @brief Асинхронная запись накопившихся в очереди кадров одной операцией
      */
     void do_write();
 
+    /**
+     * @brief Сериализация ответа GET прямо из памяти хранилища: строка копируется только в кадр
+     * ответа (под разделяемой блокировкой её сегмента)
+     * @param request Запрос GET
+     * @param format Формат сообщения
+     * @return Кадр ответа или nullptr, если запрос нужно обработать через handleRequest (строка
+     * не найдена или хранилище открыто только для чтения)
+     */
+    std::shared_ptr<OutgoingFrame> readValue(const Request &request, MessageFormat format);
+
     /**
      * @brief Обработка запроса
-     * @param request Запрос
+     * @param request Запрос (данные операций BATCH перемещаются из него в пакет)
      * @return Ответ
      */
-    Response handleRequest(const Request &request);
+    Response handleRequest(Request &request);
 };
 
 } // namespace octet::server
@@ -0,0 +1,81 @@
+#include "frame_buffer.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Максимальное количество свободных кадров в пуле соединения
+static constexpr size_t MAX_POOLED_FRAMES = 64;
+// Максимальный размер тела кадра, память которого сохраняется в пуле (1 МБ)
+static constexpr size_t MAX_POOLED_FRAME_CAPACITY = 1024 * 1024;
+} // namespace
+
+namespace octet::server {
+FrameBuffer::FrameBuffer(size_t initialCapacity)
+    : storage_(new uint8_t[std::max<size_t>(initialCapacity, 1)])
+    , capacity_(std::max<size_t>(initialCapacity, 1))
+    , initialCapacity_(capacity_)
+{
+}
+
+uint8_t *FrameBuffer::prepare(size_t minSize)
+{
+    // Разделённая память до tail_ может читаться обработчиками запросов, поэтому её нельзя
+    // заполнять сначала или сдвигать
+    const auto shared = storage_.use_count() > 1;
+
+    // Все данные обработаны: начинаем заполнять буфер сначала
+    if (!shared && head_ == tail_) {
+        head_ = 0;
+        tail_ = 0;
+    }
+    if (writable() >= minSize) {
+        return storage_.get() + tail_;
+    }
+
+    const auto unread = size();
+    if (!shared && capacity_ - unread >= minSize) {
+        // Переносим непрочитанный остаток в начало буфера
+        std::memmove(storage_.get(), storage_.get() + head_, unread);
+    }
+    else {
+        // Расширяем буфер или переносим остаток из разделённой памяти в новую (её размер не
+        // наследует рост под большой кадр)
+        const auto capacity = shared ? std::max(initialCapacity_, unread + minSize)
+                                     : std::max(capacity_ * 2, unread + minSize);
+        std::shared_ptr<uint8_t[]> storage(new uint8_t[capacity]);
+        std::memcpy(storage.get(), storage_.get() + head_, unread);
+        storage_ = std::move(storage);
+        capacity_ = capacity;
+    }
+    head_ = 0;
+    tail_ = unread;
+    return storage_.get() + tail_;
+}
+
+std::shared_ptr<OutgoingFrame> FramePool::acquire()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!frames_.empty()) {
+            auto frame = std::move(frames_.back());
+            frames_.pop_back();
+            return frame;
+        }
+    }
+    return std::make_shared<OutgoingFrame>();
+}
+
+void FramePool::release(std::shared_ptr<OutgoingFrame> frame)
+{
+    if (frame == nullptr || frame->body.capacity() > MAX_POOLED_FRAME_CAPACITY) {
+        return;
+    }
+    frame->body.clear();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (frames_.size() < MAX_POOLED_FRAMES) {
+        frames_.push_back(std::move(frame));
+    }
+}
+} // namespace octet::server
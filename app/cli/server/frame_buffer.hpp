@@ -0,0 +1,125 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace octet::server {
+// Размер заголовка кадра протокола (длина сообщения)
+static constexpr size_t FRAME_HEADER_SIZE = 4;
+// Максимальный размер кадра (64 МБ): запросы BATCH и IMPORT содержат много строк сразу
+static constexpr size_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+/**
+ * @class FrameBuffer
+ * @brief Буфер чтения кадров протокола.
+ *
+ * Данные читаются из сокета прямо в свободное место в конце буфера, а извлечение сообщения
+ * лишь сдвигает начало непрочитанных данных, поэтому разбор пачки сообщений не перемещает
+ * память. Непрочитанный остаток (начало неполного кадра) переносится в начало буфера только
+ * тогда, когда в конце не хватает места для следующего чтения.
+ *
+ * Память буфера можно разделить с обработчиком запроса (share()), чтобы данные извлечённого
+ * сообщения читались на месте, а не копировались: пока память разделена, prepare() не
+ * перезаписывает её, а переносит непрочитанный остаток в новую память.
+ */
+class FrameBuffer {
+public:
+    /**
+     * @brief Конструктор
+     * @param initialCapacity Начальный размер буфера
+     */
+    explicit FrameBuffer(size_t initialCapacity);
+
+    /**
+     * @brief Подготавливает свободное место для чтения
+     * @param minSize Минимальный размер свободного места
+     * @return Указатель на начало свободного места (не меньше writable() байт). Указатели,
+     * полученные от data() до вызова, становятся недействительными
+     */
+    uint8_t *prepare(size_t minSize);
+
+    /**
+     * @brief Размер свободного места после prepare()
+     * @return Количество байт
+     */
+    size_t writable() const { return capacity_ - tail_; }
+
+    /**
+     * @brief Отмечает прочитанные в свободное место данные
+     * @param length Количество прочитанных байт
+     */
+    void commit(size_t length) { tail_ += length; }
+
+    /**
+     * @brief Начало непрочитанных данных
+     * @return Указатель на данные
+     */
+    const uint8_t *data() const { return storage_.get() + head_; }
+
+    /**
+     * @brief Размер непрочитанных данных
+     * @return Количество байт
+     */
+    size_t size() const { return tail_ - head_; }
+
+    /**
+     * @brief Отмечает данные как обработанные (память не перемещается)
+     * @param length Количество байт
+     */
+    void consume(size_t length) { head_ += length; }
+
+    /**
+     * @brief Разделяет текущую память буфера
+     * @return Владелец памяти: указатели, полученные от data(), остаются действительными, пока
+     * жив владелец
+     */
+    std::shared_ptr<const void> share() const { return storage_; }
+
+private:
+    std::shared_ptr<uint8_t[]> storage_; // Память буфера
+    size_t capacity_; // Размер памяти буфера
+    size_t initialCapacity_; // Размер новой памяти взамен разделённой
+    size_t head_ = 0; // Начало непрочитанных данных
+    size_t tail_ = 0; // Конец непрочитанных данных
+};
+
+/**
+ * @struct OutgoingFrame
+ * @brief Кадр ответа: заголовок и тело отправляются одной записью с разбросом (writev), без
+ * склеивания в общий буфер
+ */
+struct OutgoingFrame {
+    std::array<uint8_t, FRAME_HEADER_SIZE> header{}; // Длина сообщения
+    std::string body; // JSON-сообщение
+};
+
+/**
+ * @class FramePool
+ * @brief Пул кадров ответа соединения: тело кадра сериализуется в уже выделенную при прошлых
+ * ответах память. Потокобезопасен, так как кадры заполняются в пуле потоков хранилища, а
+ * возвращаются после записи в strand соединения
+ */
+class FramePool {
+public:
+    /**
+     * @brief Получает кадр из пула или создаёт новый
+     * @return Кадр (тело пустое)
+     */
+    std::shared_ptr<OutgoingFrame> acquire();
+
+    /**
+     * @brief Возвращает кадр в пул (слишком большие кадры и кадры сверх лимита уничтожаются)
+     * @param frame Кадр
+     */
+    void release(std::shared_ptr<OutgoingFrame> frame);
+
+private:
+    std::mutex mutex_; // Мьютекс для защиты списка свободных кадров
+    std::vector<std::shared_ptr<OutgoingFrame>> frames_; // Свободные кадры
+};
+} // namespace octet::server
@@ -1,16 +1,375 @@
 #include "protocol.hpp"
 
+#include <cstring>
+#include <iterator>
+#include <limits>
+
 #include "3rdparty/json.hpp"
+#include "storage/uuid.hpp"
 #include "logger.hpp"
 
 namespace octet::server {
 // Используем nlohmann::json для работы с JSON
 using json = nlohmann::json;
 
-std::optional<Request> Request::fromJson(const std::string &jsonStr)
+namespace {
+// Флаги полей двоичного запроса
+static constexpr uint8_t REQUEST_HAS_UUID = 0x01;
+static constexpr uint8_t REQUEST_HAS_DATA = 0x02;
+static constexpr uint8_t REQUEST_HAS_UUIDS = 0x04;
+static constexpr uint8_t REQUEST_HAS_OPERATIONS = 0x08;
+static constexpr uint8_t REQUEST_HAS_VALUES = 0x10;
+static constexpr uint8_t REQUEST_HAS_POSITION = 0x20;
+static constexpr uint8_t REQUEST_PARTIAL = 0x40;
+
+// Флаги полей двоичного ответа
+static constexpr uint8_t RESPONSE_SUCCESS = 0x01;
+static constexpr uint8_t RESPONSE_HAS_UUID = 0x02;
+static constexpr uint8_t RESPONSE_HAS_DATA = 0x04;
+static constexpr uint8_t RESPONSE_HAS_UUIDS = 0x08;
+static constexpr uint8_t RESPONSE_HAS_VALUES = 0x10;
+static constexpr uint8_t RESPONSE_HAS_ERROR = 0x20;
+static constexpr uint8_t RESPONSE_HAS_POSITION = 0x40;
+static constexpr uint8_t RESPONSE_RESET = 0x80;
+
+// Номер части в положении реплики, когда состояние хранилища уже передано
+static constexpr uint32_t POSITION_NO_PART = std::numeric_limits<uint32_t>::max();
+
+// Минимальный размер операции BATCH в двоичном формате (команда и флаги)
+static constexpr size_t BINARY_OPERATION_MIN_SIZE = 2;
+
+// Минимальный размер данных запроса, которые читаются на месте в памяти кадра: меньшие данные
+// дешевле скопировать, чем заменять разделённую память буфера чтения (4 КБ)
+static constexpr size_t SHARED_DATA_MIN_SIZE = 4096;
+
+// Команды двоичного формата: индекс в массиве - код команды
+static constexpr CommandType BINARY_COMMANDS[] = {
+    CommandType::UNKNOWN, CommandType::INSERT, CommandType::GET,  CommandType::UPDATE,
+    CommandType::REMOVE,  CommandType::BATCH,  CommandType::MGET, CommandType::PING,
+    CommandType::STATS,   CommandType::IMPORT, CommandType::SUBSCRIBE,
+};
+
+/**
+ * @brief Преобразует код команды двоичного формата в CommandType
+ * @param code Код команды
+ * @return Команда или CommandType::UNKNOWN
+ */
+CommandType commandFromByte(uint8_t code)
+{
+    return code < std::size(BINARY_COMMANDS) ? BINARY_COMMANDS[code] : CommandType::UNKNOWN;
+}
+
+/**
+ * @brief Преобразует CommandType в код команды двоичного формата
+ * @param command Команда
+ * @return Код команды или 0, если у команды нет кода
+ */
+uint8_t commandToByte(CommandType command)
+{
+    for (size_t code = 1; code < std::size(BINARY_COMMANDS); code++) {
+        if (BINARY_COMMANDS[code] == command) {
+            return static_cast<uint8_t>(code);
+        }
+    }
+    return 0;
+}
+
+/**
+ * @class BinaryReader
+ * @brief Последовательное чтение полей двоичного сообщения с проверкой границ
+ */
+class BinaryReader {
+public:
+    explicit BinaryReader(std::string_view message)
+        : message_(message)
+    {
+    }
+
+    size_t remaining() const { return message_.size() - position_; }
+
+    template <typename T>
+    bool readInteger(T &value)
+    {
+        if (remaining() < sizeof(T)) {
+            return false;
+        }
+        value = 0;
+        for (size_t i = 0; i < sizeof(T); i++) {
+            value |= static_cast<T>(static_cast<uint8_t>(message_[position_ + i])) << (8 * i);
+        }
+        position_ += sizeof(T);
+        return true;
+    }
+
+    bool readString(size_t length, std::string &value)
+    {
+        if (remaining() < length) {
+            return false;
+        }
+        value.assign(message_.substr(position_, length));
+        position_ += length;
+        return true;
+    }
+
+    // Данные с длиной u32
+    bool readData(std::string &value)
+    {
+        uint32_t length = 0;
+        return readInteger(length) && readString(length, value);
+    }
+
+    // Данные с длиной u32 без копирования (значение ссылается на память сообщения)
+    bool readDataView(std::string_view &value)
+    {
+        uint32_t length = 0;
+        if (!readInteger(length) || remaining() < length) {
+            return false;
+        }
+        value = message_.substr(position_, length);
+        position_ += length;
+        return true;
+    }
+
+    // UUID из 16 байт в каноническое строковое представление
+    bool readUuid(std::string &value)
+    {
+        if (remaining() < sizeof(Uuid)) {
+            return false;
+        }
+        value = Uuid::fromBytes(message_.data() + position_).toString();
+        position_ += sizeof(Uuid);
+        return true;
+    }
+
+    // Количество элементов u32 с проверкой, что элементы минимального размера поместятся
+    bool readCount(size_t minItemSize, uint32_t &count)
+    {
+        return readInteger(count) && remaining() / minItemSize >= count;
+    }
+
+    // Положение реплики
+    bool readPosition(ReplicationPosition &position)
+    {
+        uint16_t length = 0;
+        uint32_t part = 0;
+        if (!readInteger(length) || !readString(length, position.checkpointId)
+            || !readInteger(position.offset) || !readInteger(part)) {
+            return false;
+        }
+        position.part = part != POSITION_NO_PART ? std::optional<uint32_t>(part) : std::nullopt;
+        return true;
+    }
+
+private:
+    std::string_view message_; // Сообщение
+    size_t position_ = 0; // Позиция следующего поля
+};
+
+template <typename T>
+void appendInteger(std::string &out, T value)
+{
+    for (size_t i = 0; i < sizeof(T); i++) {
+        out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+    }
+}
+
+// Данные с длиной u32
+bool appendData(std::string &out, std::string_view value)
+{
+    if (value.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    appendInteger(out, static_cast<uint32_t>(value.size()));
+    out.append(value);
+    return true;
+}
+
+// UUID в двоичном виде (только каноническое строковое представление)
+bool appendUuid(std::string &out, const std::string &value)
+{
+    const auto uuid = Uuid::fromString(value);
+    if (!uuid.has_value()) {
+        return false;
+    }
+    out.append(reinterpret_cast<const char *>(uuid->bytes().data()), uuid->bytes().size());
+    return true;
+}
+
+// Положение реплики
+bool appendPosition(std::string &out, const ReplicationPosition &position)
+{
+    if (position.checkpointId.size() > std::numeric_limits<uint16_t>::max()
+        || position.part == POSITION_NO_PART) {
+        return false;
+    }
+    appendInteger(out, static_cast<uint16_t>(position.checkpointId.size()));
+    out.append(position.checkpointId);
+    appendInteger(out, position.offset);
+    appendInteger(out, position.part.value_or(POSITION_NO_PART));
+    return true;
+}
+
+/**
+ * @brief Разбирает двоичный запрос
+ * @param reader Читатель сообщения
+ * @param req Запрос для заполнения
+ * @return true, если сообщение корректно
+ */
+bool readBinaryRequest(BinaryReader &reader, Request &req)
+{
+    uint8_t magic = 0;
+    uint8_t command = 0;
+    uint8_t flags = 0;
+    uint16_t requestIdLength = 0;
+    if (!reader.readInteger(magic) || magic != BINARY_MESSAGE_MAGIC
+        || !reader.readInteger(command) || !reader.readInteger(flags)
+        || !reader.readInteger(requestIdLength)
+        || !reader.readString(requestIdLength, req.requestId)) {
+        return false;
+    }
+    req.command = commandFromByte(command);
+    req.partial = (flags & REQUEST_PARTIAL) != 0;
+
+    if ((flags & REQUEST_HAS_UUID) != 0 && !reader.readUuid(req.uuid.emplace())) {
+        return false;
+    }
+    if ((flags & REQUEST_HAS_DATA) != 0) {
+        std::string_view data;
+        if (!reader.readDataView(data)) {
+            return false;
+        }
+        // Крупные данные читаются на месте, если память сообщения разделена с запросом
+        if (req.frame != nullptr && data.size() >= SHARED_DATA_MIN_SIZE) {
+            req.dataView = data;
+        }
+        else {
+            req.data.emplace(data);
+        }
+    }
+
+    uint32_t count = 0;
+    if ((flags & REQUEST_HAS_UUIDS) != 0) {
+        if (!reader.readCount(sizeof(Uuid), count)) {
+            return false;
+        }
+        auto &uuids = req.uuids.emplace(count);
+        for (auto &uuid : uuids) {
+            if (!reader.readUuid(uuid)) {
+                return false;
+            }
+        }
+    }
+
+    if ((flags & REQUEST_HAS_OPERATIONS) != 0) {
+        if (!reader.readCount(BINARY_OPERATION_MIN_SIZE, count)) {
+            return false;
+        }
+        auto &operations = req.operations.emplace(count);
+        for (auto &operation : operations) {
+            uint8_t operationCommand = 0;
+            uint8_t operationFlags = 0;
+            if (!reader.readInteger(operationCommand) || !reader.readInteger(operationFlags)) {
+                return false;
+            }
+            operation.command = commandFromByte(operationCommand);
+            if ((operationFlags & REQUEST_HAS_UUID) != 0
+                && !reader.readUuid(operation.uuid.emplace())) {
+                return false;
+            }
+            if ((operationFlags & REQUEST_HAS_DATA) != 0
+                && !reader.readData(operation.data.emplace())) {
+                return false;
+            }
+        }
+    }
+
+    if ((flags & REQUEST_HAS_VALUES) != 0) {
+        if (!reader.readCount(sizeof(uint32_t), count)) {
+            return false;
+        }
+        auto &values = req.values.emplace(count);
+        for (auto &value : values) {
+            if (!reader.readData(value)) {
+                return false;
+            }
+        }
+    }
+
+    if ((flags & REQUEST_HAS_POSITION) != 0 && !reader.readPosition(req.position.emplace())) {
+        return false;
+    }
+
+    return reader.remaining() == 0;
+}
+
+/**
+ * @brief Разбирает двоичный ответ
+ * @param reader Читатель сообщения
+ * @param resp Ответ для заполнения
+ * @return true, если сообщение корректно
+ */
+bool readBinaryResponse(BinaryReader &reader, Response &resp)
+{
+    uint8_t magic = 0;
+    uint8_t flags = 0;
+    uint16_t requestIdLength = 0;
+    if (!reader.readInteger(magic) || magic != BINARY_MESSAGE_MAGIC
+        || !reader.readInteger(flags) || !reader.readInteger(requestIdLength)
+        || !reader.readString(requestIdLength, resp.requestId)) {
+        return false;
+    }
+    resp.success = (flags & RESPONSE_SUCCESS) != 0;
+    resp.reset = (flags & RESPONSE_RESET) != 0;
+
+    if ((flags & RESPONSE_HAS_UUID) != 0 && !reader.readUuid(resp.uuid.emplace())) {
+        return false;
+    }
+    if ((flags & RESPONSE_HAS_DATA) != 0 && !reader.readData(resp.data.emplace())) {
+        return false;
+    }
+
+    uint32_t count = 0;
+    if ((flags & RESPONSE_HAS_UUIDS) != 0) {
+        if (!reader.readCount(sizeof(Uuid), count)) {
+            return false;
+        }
+        auto &uuids = resp.uuids.emplace(count);
+        for (auto &uuid : uuids) {
+            if (!reader.readUuid(uuid)) {
+                return false;
+            }
+        }
+    }
+
+    if ((flags & RESPONSE_HAS_VALUES) != 0) {
+        if (!reader.readCount(sizeof(uint8_t), count)) {
+            return false;
+        }
+        auto &values = resp.values.emplace(count);
+        for (auto &value : values) {
+            uint8_t present = 0;
+            if (!reader.readInteger(present)
+                || (present != 0 && !reader.readData(value.emplace()))) {
+                return false;
+            }
+        }
+    }
+
+    if ((flags & RESPONSE_HAS_ERROR) != 0 && !reader.readData(resp.error.emplace())) {
+        return false;
+    }
+    if ((flags & RESPONSE_HAS_POSITION) != 0 && !reader.readPosition(resp.position.emplace())) {
+        return false;
+    }
+
+    return reader.remaining() == 0;
+}
+} // namespace
+
+std::optional<Request> Request::fromJson(std::string_view jsonStr)
 {
     try {
-        const auto jsonData = json::parse(jsonStr);
+        const auto jsonData = json::parse(jsonStr.begin(), jsonStr.end());
 
         // Проверка обязательных полей
         if (!jsonData.contains("request_id") || !jsonData.contains("command")
@@ -33,6 +392,48 @@ std::optional<Request> Request::fromJson(const std::string &jsonStr)
             req.data = params["data"].get<std::string>();
         }
 
+        if (params.contains("uuids")) {
+            req.uuids = params["uuids"].get<std::vector<std::string>>();
+        }
+
+        if (params.contains("values")) {
+            req.values = params["values"].get<std::vector<std::string>>();
+        }
+
+        if (params.contains("partial")) {
+            req.partial = params["partial"].get<bool>();
+        }
+
+        if (params.contains("protocol")) {
+            req.protocol = params["protocol"].get<std::string>();
+        }
+
+        if (params.contains("position")) {
+            const auto &item = params["position"];
+            auto &position = req.position.emplace();
+            position.checkpointId = item.at("checkpoint").get<std::string>();
+            position.offset = item.at("offset").get<uint64_t>();
+            if (item.contains("part")) {
+                position.part = item["part"].get<uint32_t>();
+            }
+        }
+
+        if (params.contains("operations")) {
+            std::vector<RequestOperation> operations;
+            for (const auto &item : params["operations"]) {
+                RequestOperation operation;
+                operation.command = stringToCommand(item.at("command").get<std::string>());
+                if (item.contains("uuid")) {
+                    operation.uuid = item["uuid"].get<std::string>();
+                }
+                if (item.contains("data")) {
+                    operation.data = item["data"].get<std::string>();
+                }
+                operations.push_back(std::move(operation));
+            }
+            req.operations = std::move(operations);
+        }
+
         return req;
     }
     catch (const json::exception &e) {
@@ -41,6 +442,98 @@ std::optional<Request> Request::fromJson(const std::string &jsonStr)
     }
 }
 
+std::optional<Request> Request::fromBinary(std::string_view message,
+                                           std::shared_ptr<const void> frame)
+{
+    BinaryReader reader(message);
+    Request req;
+    req.frame = std::move(frame);
+    if (!readBinaryRequest(reader, req)) {
+        LOG_ERROR << "Некорректное двоичное сообщение запроса (" << message.size() << " байт)";
+        return std::nullopt;
+    }
+    // Память сообщения удерживается, только если запрос на неё ссылается
+    if (!req.dataView.has_value()) {
+        req.frame.reset();
+    }
+    return req;
+}
+
+std::optional<Request> Request::parse(std::string_view message,
+                                      std::shared_ptr<const void> frame)
+{
+    if (ProtocolFrame::messageFormat(message) == MessageFormat::BINARY) {
+        return fromBinary(message, std::move(frame));
+    }
+    return fromJson(message);
+}
+
+bool Request::toBinary(std::string &out) const
+{
+    out.clear();
+    const auto code = commandToByte(command);
+    if (code == 0 || requestId.size() > std::numeric_limits<uint16_t>::max()) {
+        return false;
+    }
+
+    uint8_t flags = uuid.has_value() ? REQUEST_HAS_UUID : 0;
+    const auto value = payload();
+    flags |= value.has_value() ? REQUEST_HAS_DATA : 0;
+    flags |= uuids.has_value() ? REQUEST_HAS_UUIDS : 0;
+    flags |= operations.has_value() ? REQUEST_HAS_OPERATIONS : 0;
+    flags |= values.has_value() ? REQUEST_HAS_VALUES : 0;
+    flags |= position.has_value() ? REQUEST_HAS_POSITION : 0;
+    flags |= partial ? REQUEST_PARTIAL : 0;
+
+    out.push_back(static_cast<char>(BINARY_MESSAGE_MAGIC));
+    out.push_back(static_cast<char>(code));
+    out.push_back(static_cast<char>(flags));
+    appendInteger(out, static_cast<uint16_t>(requestId.size()));
+    out.append(requestId);
+
+    if (uuid.has_value() && !appendUuid(out, *uuid)) {
+        return false;
+    }
+    if (value.has_value() && !appendData(out, *value)) {
+        return false;
+    }
+    if (uuids.has_value()) {
+        appendInteger(out, static_cast<uint32_t>(uuids->size()));
+        for (const auto &item : *uuids) {
+            if (!appendUuid(out, item)) {
+                return false;
+            }
+        }
+    }
+    if (operations.has_value()) {
+        appendInteger(out, static_cast<uint32_t>(operations->size()));
+        for (const auto &operation : *operations) {
+            uint8_t operationFlags = operation.uuid.has_value() ? REQUEST_HAS_UUID : 0;
+            operationFlags |= operation.data.has_value() ? REQUEST_HAS_DATA : 0;
+            out.push_back(static_cast<char>(commandToByte(operation.command)));
+            out.push_back(static_cast<char>(operationFlags));
+            if (operation.uuid.has_value() && !appendUuid(out, *operation.uuid)) {
+                return false;
+            }
+            if (operation.data.has_value() && !appendData(out, *operation.data)) {
+                return false;
+            }
+        }
+    }
+    if (values.has_value()) {
+        appendInteger(out, static_cast<uint32_t>(values->size()));
+        for (const auto &value : *values) {
+            if (!appendData(out, value)) {
+                return false;
+            }
+        }
+    }
+    if (position.has_value() && !appendPosition(out, *position)) {
+        return false;
+    }
+    return true;
+}
+
 CommandType Request::stringToCommand(const std::string &cmd_str)
 {
     if (cmd_str == "insert")
@@ -51,12 +544,29 @@ CommandType Request::stringToCommand(const std::string &cmd_str)
         return CommandType::UPDATE;
     if (cmd_str == "remove")
         return CommandType::REMOVE;
+    if (cmd_str == "batch")
+        return CommandType::BATCH;
+    if (cmd_str == "mget")
+        return CommandType::MGET;
     if (cmd_str == "ping")
         return CommandType::PING;
+    if (cmd_str == "stats")
+        return CommandType::STATS;
+    if (cmd_str == "import")
+        return CommandType::IMPORT;
+    if (cmd_str == "subscribe")
+        return CommandType::SUBSCRIBE;
     return CommandType::UNKNOWN;
 }
 
 std::string Response::toJson() const
+{
+    std::string result;
+    toJson(result);
+    return result;
+}
+
+void Response::toJson(std::string &out) const
 {
     json jsonData;
     jsonData["request_id"] = requestId;
@@ -69,40 +579,121 @@ std::string Response::toJson() const
     if (data.has_value()) {
         params["data"] = *data;
     }
+    else if (dataView.has_value()) {
+        params["data"] = *dataView;
+    }
+    if (uuids.has_value()) {
+        params["uuids"] = *uuids;
+    }
+    if (values.has_value()) {
+        auto &items = params["values"] = json::array();
+        for (const auto &value : *values) {
+            items.push_back(value.has_value() ? json(*value) : json(nullptr));
+        }
+    }
+    if (protocol.has_value()) {
+        params["protocol"] = *protocol;
+    }
+    if (position.has_value()) {
+        auto &item = params["position"];
+        item["checkpoint"] = position->checkpointId;
+        item["offset"] = position->offset;
+        if (position->part.has_value()) {
+            item["part"] = *position->part;
+        }
+    }
+    if (reset) {
+        params["reset"] = true;
+    }
     jsonData["params"] = params;
 
     if (error.has_value()) {
         jsonData["error"] = *error;
     }
 
-    return jsonData.dump();
+    // Сериализуем так же, как json::dump(), но в переданную строку
+    out.clear();
+    nlohmann::detail::serializer<json> serializer(
+        nlohmann::detail::output_adapter<char, std::string>(out), ' ');
+    serializer.dump(jsonData, false, false, 0);
 }
 
-std::vector<uint8_t> ProtocolFrame::wrapMessage(const std::string &jsonMessage)
+bool Response::toBinary(std::string &out) const
 {
-    // Вычисляем длину сообщения
-    const uint32_t length = static_cast<uint32_t>(jsonMessage.size());
+    out.clear();
+    if (requestId.size() > std::numeric_limits<uint16_t>::max()) {
+        return false;
+    }
 
-    // Кодируем длину
-    auto lengthBytes = encodeLength(length);
+    uint8_t flags = success ? RESPONSE_SUCCESS : 0;
+    flags |= uuid.has_value() ? RESPONSE_HAS_UUID : 0;
+    flags |= data.has_value() || dataView.has_value() ? RESPONSE_HAS_DATA : 0;
+    flags |= uuids.has_value() ? RESPONSE_HAS_UUIDS : 0;
+    flags |= values.has_value() ? RESPONSE_HAS_VALUES : 0;
+    flags |= error.has_value() ? RESPONSE_HAS_ERROR : 0;
+    flags |= position.has_value() ? RESPONSE_HAS_POSITION : 0;
+    flags |= reset ? RESPONSE_RESET : 0;
 
-    // Создаем результирующий буфер
-    const auto lengthBytesSize = lengthBytes.size();
-    std::vector<uint8_t> frame(lengthBytesSize + jsonMessage.size());
+    out.push_back(static_cast<char>(BINARY_MESSAGE_MAGIC));
+    out.push_back(static_cast<char>(flags));
+    appendInteger(out, static_cast<uint16_t>(requestId.size()));
+    out.append(requestId);
 
-    // Копируем заголовок и сообщение
-    std::copy(lengthBytes.begin(), lengthBytes.end(), frame.begin());
-    std::copy(jsonMessage.begin(), jsonMessage.end(), frame.begin() + lengthBytesSize);
+    if (uuid.has_value() && !appendUuid(out, *uuid)) {
+        return false;
+    }
+    if (data.has_value() && !appendData(out, *data)) {
+        return false;
+    }
+    if (!data.has_value() && dataView.has_value() && !appendData(out, *dataView)) {
+        return false;
+    }
+    if (uuids.has_value()) {
+        appendInteger(out, static_cast<uint32_t>(uuids->size()));
+        for (const auto &item : *uuids) {
+            if (!appendUuid(out, item)) {
+                return false;
+            }
+        }
+    }
+    if (values.has_value()) {
+        appendInteger(out, static_cast<uint32_t>(values->size()));
+        for (const auto &value : *values) {
+            out.push_back(value.has_value() ? 1 : 0);
+            if (value.has_value() && !appendData(out, *value)) {
+                return false;
+            }
+        }
+    }
+    if (error.has_value() && !appendData(out, *error)) {
+        return false;
+    }
+    if (position.has_value() && !appendPosition(out, *position)) {
+        return false;
+    }
+    return true;
+}
 
-    return frame;
+std::optional<Response> Response::fromBinary(std::string_view message)
+{
+    BinaryReader reader(message);
+    Response resp;
+    if (!readBinaryResponse(reader, resp)) {
+        LOG_ERROR << "Некорректное двоичное сообщение ответа (" << message.size() << " байт)";
+        return std::nullopt;
+    }
+    return resp;
 }
 
-std::optional<std::string> ProtocolFrame::extractMessage(std::vector<uint8_t> &buffer)
+void ProtocolFrame::wrapMessage(OutgoingFrame &frame)
 {
-    constexpr size_t headerSize = 4; // 4 байта для длины
+    frame.header = encodeLength(static_cast<uint32_t>(frame.body.size()));
+}
 
+std::optional<std::string_view> ProtocolFrame::extractMessage(FrameBuffer &buffer)
+{
     // Проверяем, есть ли достаточно данных для чтения заголовка
-    if (buffer.size() < headerSize) {
+    if (buffer.size() < FRAME_HEADER_SIZE) {
         return std::nullopt;
     }
 
@@ -110,19 +701,40 @@ std::optional<std::string> ProtocolFrame::extractMessage(std::vector<uint8_t> &b
     const auto messageLength = decodeLength(buffer.data());
 
     // Проверяем, получили ли мы все сообщение
-    if (buffer.size() < headerSize + messageLength) {
+    if (buffer.size() < FRAME_HEADER_SIZE + messageLength) {
         return std::nullopt;
     }
 
-    // Извлекаем сообщение
-    std::string message(buffer.begin() + headerSize, buffer.begin() + headerSize + messageLength);
-
-    // Удаляем обработанные данные из буфера
-    buffer.erase(buffer.begin(), buffer.begin() + headerSize + messageLength);
+    // Сообщение остаётся в памяти буфера, сдвигается только начало непрочитанных данных
+    const std::string_view message(
+        reinterpret_cast<const char *>(buffer.data() + FRAME_HEADER_SIZE), messageLength);
+    buffer.consume(FRAME_HEADER_SIZE + messageLength);
 
     return message;
 }
 
+MessageFormat ProtocolFrame::messageFormat(std::string_view message)
+{
+    if (!message.empty() && static_cast<uint8_t>(message.front()) == BINARY_MESSAGE_MAGIC) {
+        return MessageFormat::BINARY;
+    }
+    return MessageFormat::JSON;
+}
+
+size_t ProtocolFrame::missingBytes(const FrameBuffer &buffer)
+{
+    if (buffer.size() < FRAME_HEADER_SIZE) {
+        return FRAME_HEADER_SIZE - buffer.size();
+    }
+    const size_t frameSize = FRAME_HEADER_SIZE + decodeLength(buffer.data());
+    return frameSize > buffer.size() ? frameSize - buffer.size() : 0;
+}
+
+bool ProtocolFrame::exceedsMaxSize(const FrameBuffer &buffer)
+{
+    return buffer.size() + missingBytes(buffer) > MAX_FRAME_SIZE;
+}
+
 // !! Для кодирования/декодирования используем формат little-endian
 
 uint32_t ProtocolFrame::decodeLength(const uint8_t *headerBytes)
@@ -136,11 +748,11 @@ uint32_t ProtocolFrame::decodeLength(const uint8_t *headerBytes)
     return length;
 }
 
-std::vector<uint8_t> ProtocolFrame::encodeLength(uint32_t length)
+std::array<uint8_t, FRAME_HEADER_SIZE> ProtocolFrame::encodeLength(uint32_t length)
 {
     constexpr size_t BYTES_IN_TYPE = sizeof(uint32_t);
     constexpr size_t BITS_PER_BYTE = 8;
-    std::vector<uint8_t> bytes(BYTES_IN_TYPE);
+    std::array<uint8_t, FRAME_HEADER_SIZE> bytes{};
     for (size_t i = 0; i < BYTES_IN_TYPE; i++) {
         bytes[i] = (length >> (i * BITS_PER_BYTE)) & 0xFF;
     }
@@ -1,16 +1,59 @@
 #pragma once
 
+#include <array>
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <optional>
 #include <vector>
 
+#include "storage/replication.hpp"
+#include "frame_buffer.hpp"
+
 namespace octet::server {
 /**
  * @enum CommandType
  * @brief Типы команд для взаимодействия между Go и C++
  */
-enum class CommandType { INSERT, GET, UPDATE, REMOVE, PING, UNKNOWN };
+enum class CommandType {
+    INSERT,
+    GET,
+    UPDATE,
+    REMOVE,
+    BATCH,
+    MGET,
+    PING,
+    STATS,
+    IMPORT,
+    SUBSCRIBE,
+    UNKNOWN
+};
+
+/**
+ * @enum MessageFormat
+ * @brief Формат сообщения внутри кадра протокола
+ */
+enum class MessageFormat {
+    JSON, // JSON-объект (формат по умолчанию)
+    BINARY // Двоичный формат (см. ProtocolFrame), согласуется запросом PING
+};
+
+// Первый байт двоичного сообщения (JSON-сообщение всегда начинается с '{')
+static constexpr uint8_t BINARY_MESSAGE_MAGIC = 0x01;
+
+// Название двоичного формата в параметре "protocol" запроса и ответа PING
+static constexpr std::string_view BINARY_PROTOCOL_NAME = "binary";
+
+/**
+ * @struct RequestOperation
+ * @brief Операция пакетного запроса BATCH (INSERT, UPDATE или REMOVE)
+ */
+struct RequestOperation {
+    CommandType command;
+    std::optional<std::string> uuid;
+    std::optional<std::string> data;
+};
 
 /**
  * @struct Request
@@ -21,13 +64,65 @@ struct Request {
     CommandType command;
     std::optional<std::string> uuid;
     std::optional<std::string> data;
+    // Данные, читаемые на месте в памяти кадра (заполняется вместо data), и владелец этой памяти
+    std::optional<std::string_view> dataView;
+    std::shared_ptr<const void> frame;
+    std::optional<std::vector<std::string>> uuids; // Для MGET
+    std::optional<std::vector<RequestOperation>> operations; // Для BATCH
+    std::optional<std::vector<std::string>> values; // Для IMPORT
+    // Для IMPORT: загрузка продолжится следующими запросами, поэтому строки пока не фиксируются
+    // снапшотом (их зафиксирует запрос без этого признака)
+    bool partial = false;
+    std::optional<std::string> protocol; // Для PING: формат, на который хочет перейти клиент
+    std::optional<ReplicationPosition> position; // Для SUBSCRIBE: положение реплики
 
     /**
      * @brief Десериализация запроса из JSON
      * @param jsonStr JSON-строка
      * @return Request или std::nullopt при ошибке
      */
-    static std::optional<Request> fromJson(const std::string &jsonStr);
+    static std::optional<Request> fromJson(std::string_view jsonStr);
+
+    /**
+     * @brief Десериализация запроса из двоичного формата
+     * @param message Двоичное сообщение (начинается с BINARY_MESSAGE_MAGIC)
+     * @param frame Владелец памяти сообщения: если задан, крупные данные не копируются, а
+     * читаются на месте через dataView
+     * @return Request или std::nullopt при ошибке
+     */
+    static std::optional<Request> fromBinary(std::string_view message,
+                                             std::shared_ptr<const void> frame = nullptr);
+
+    /**
+     * @brief Десериализация запроса в формате, определяемом по первому байту сообщения
+     * @param message Сообщение из кадра
+     * @param frame Владелец памяти сообщения (см. fromBinary)
+     * @return Request или std::nullopt при ошибке
+     */
+    static std::optional<Request> parse(std::string_view message,
+                                        std::shared_ptr<const void> frame = nullptr);
+
+    /**
+     * @brief Данные запроса независимо от того, скопированы они или читаются на месте
+     * @return Данные или std::nullopt, если их нет в запросе
+     */
+    std::optional<std::string_view> payload() const
+    {
+        if (dataView.has_value()) {
+            return dataView;
+        }
+        if (data.has_value()) {
+            return std::string_view(*data);
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Сериализация запроса в двоичный формат (для клиента, например реплики)
+     * @param out Строка для результата (прежнее содержимое заменяется)
+     * @return false, если запрос нельзя представить в двоичном формате
+     */
+    bool toBinary(std::string &out) const;
 
     /**
      * @brief Конвертация строкового представления команды в CommandType
@@ -46,6 +141,15 @@ struct Response {
     bool success;
     std::optional<std::string> uuid;
     std::optional<std::string> data;
+    // Данные, не принадлежащие ответу (сериализуются вместо data без промежуточной копии и должны
+    // оставаться действительными до окончания сериализации)
+    std::optional<std::string_view> dataView;
+    std::optional<std::vector<std::string>> uuids; // UUID операций BATCH и строк IMPORT
+    std::optional<std::vector<std::optional<std::string>>> values; // Строки MGET (null - нет)
+    std::optional<std::string> protocol; // Для PING: подтверждённый сервером формат
+    // Для SUBSCRIBE: положение реплики после применения записей журнала из data
+    std::optional<ReplicationPosition> position;
+    bool reset = false; // Для SUBSCRIBE: data начинает состояние, заменяющее записи реплики
     std::optional<std::string> error;
 
     /**
@@ -53,28 +157,94 @@ struct Response {
      * @return JSON-строка
      */
     std::string toJson() const;
+
+    /**
+     * @brief Сериализация ответа в JSON в уже выделенную строку (её память переиспользуется)
+     * @param out Строка для результата (прежнее содержимое заменяется)
+     */
+    void toJson(std::string &out) const;
+
+    /**
+     * @brief Сериализация ответа в двоичный формат
+     * @param out Строка для результата (прежнее содержимое заменяется)
+     * @return false, если ответ нельзя представить в двоичном формате (UUID не в каноническом
+     * виде) - тогда ответ отправляется в JSON
+     */
+    bool toBinary(std::string &out) const;
+
+    /**
+     * @brief Десериализация ответа из двоичного формата (для клиента, например реплики)
+     * @param message Двоичное сообщение (начинается с BINARY_MESSAGE_MAGIC)
+     * @return Response или std::nullopt при ошибке
+     */
+    static std::optional<Response> fromBinary(std::string_view message);
 };
 
 /**
  * @brief Класс для работы с форматом сообщений по протоколу
  *
- * Формат: [4 байта длины сообщения][JSON-сообщение]
+ * Формат кадра: [4 байта длины сообщения][сообщение]. Сообщение - JSON-объект или, если
+ * клиент согласовал двоичный формат запросом PING с параметром "protocol": "binary",
+ * двоичное сообщение. Формат определяется по первому байту сообщения, ответ отправляется в
+ * формате запроса. Числа в двоичном формате - little-endian, UUID - 16 байт:
+ *
+ * Запрос: [0x01][команда: u8][флаги: u8][u16 длина + request_id][uuid]?[u32 длина + data]?
+ * [u32 количество + uuid...]? [u32 количество + операции]? [u32 количество + строки]?
+ * [положение]?, где операция BATCH - [команда: u8][флаги: u8][uuid]?[u32 длина + data]?,
+ * строка IMPORT - [u32 длина + data], а положение реплики - [u16 длина + контрольная точка]
+ * [операций после неё: u64][номер части: u32, 0xFFFFFFFF - нет]. Флаги: 0x01 - uuid,
+ * 0x02 - data, 0x04 - uuids, 0x08 - operations, 0x10 - values, 0x20 - position,
+ * 0x40 - partial.
+ *
+ * Ответ: [0x01][флаги: u8][u16 длина + request_id][uuid]?[u32 длина + data]?
+ * [u32 количество + uuid...]? [u32 количество + значения]? [u32 длина + error]? [положение]?,
+ * где значение MGET - [0x00] (нет строки) или [0x01][u32 длина + data]. Флаги: 0x01 - success,
+ * 0x02 - uuid, 0x04 - data, 0x08 - uuids, 0x10 - values, 0x20 - error, 0x40 - position,
+ * 0x80 - reset.
+ *
+ * Команды: 1 - insert, 2 - get, 3 - update, 4 - remove, 5 - batch, 6 - mget, 7 - ping,
+ * 8 - stats (показатели работы в текстовом формате Prometheus возвращаются в data), 9 - import
+ * (строки values загружаются без журналирования каждой, их UUID возвращаются в uuids, а все
+ * загруженные строки фиксируются одним снапшотом запросом без признака partial),
+ * 10 - subscribe (очередная порция потока репликации от положения реплики: записи журнала в
+ * data и положение после них, см. ReplicationSource; доступна только в двоичном формате).
  */
 class ProtocolFrame {
 public:
     /**
-     * @brief Обертывание JSON-сообщения в фрейм протокола
-     * @param jsonMessage Сообщение в формате JSON
-     * @return Байты фрейма протокола
+     * @brief Заполнение заголовка кадра ответа по длине его тела
+     * @param frame Кадр с сериализованным сообщением
+     */
+    static void wrapMessage(OutgoingFrame &frame);
+
+    /**
+     * @brief Извлечение JSON-сообщения из буфера чтения без копирования
+     * @param buffer Буфер с данными
+     * @return std::nullopt, если сообщение неполное, или JSON-сообщение (ссылается на память
+     * буфера и действительно до следующего вызова buffer.prepare())
+     */
+    static std::optional<std::string_view> extractMessage(FrameBuffer &buffer);
+
+    /**
+     * @brief Определение формата сообщения по его первому байту
+     * @param message Сообщение из кадра
+     * @return Формат сообщения
+     */
+    static MessageFormat messageFormat(std::string_view message);
+
+    /**
+     * @brief Количество байт, которых не хватает в буфере до конца текущего кадра
+     * @param buffer Буфер с данными
+     * @return Количество байт (размер заголовка, если заголовок ещё не получен)
      */
-    static std::vector<uint8_t> wrapMessage(const std::string &jsonMessage);
+    static size_t missingBytes(const FrameBuffer &buffer);
 
     /**
-     * @brief Извлечение JSON-сообщения из частичного буфера
+     * @brief Проверка, что вместе с остатком текущего кадра буфер превысит MAX_FRAME_SIZE
      * @param buffer Буфер с данными
-     * @return std::nullopt, если сообщение неполное, или JSON-сообщение
+     * @return true, если кадр нельзя принять и соединение нужно закрыть
      */
-    static std::optional<std::string> extractMessage(std::vector<uint8_t> &buffer);
+    static bool exceedsMaxSize(const FrameBuffer &buffer);
 
     /**
      * @brief Извлечение длины сообщения из заголовка
@@ -88,6 +258,6 @@ public:
      * @param length Длина сообщения
      * @return Байты заголовка (4 байта)
      */
-    static std::vector<uint8_t> encodeLength(uint32_t length);
+    static std::array<uint8_t, FRAME_HEADER_SIZE> encodeLength(uint32_t length);
 };
 } // namespace octet::server
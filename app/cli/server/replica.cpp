@@ -0,0 +1,174 @@
+#include "replica.hpp"
+
+#include <array>
+#include <sys/socket.h>
+
+#include "logger.hpp"
+
+namespace octet::server {
+// Интервал опроса источника, когда новых записей нет
+constexpr std::chrono::milliseconds REPLICATION_POLL_INTERVAL(50);
+// Пауза перед повторным подключением к источнику
+constexpr std::chrono::milliseconds REPLICATION_RECONNECT_DELAY(1000);
+
+Replica::Replica(StorageManager &storage, const std::filesystem::path &dataDir,
+                 std::filesystem::path sourceSocket)
+    : target_(storage, dataDir)
+    , sourceSocket_(std::move(sourceSocket))
+{
+}
+
+Replica::~Replica()
+{
+    stop();
+}
+
+void Replica::start()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = false;
+    }
+    thread_ = std::thread(&Replica::run, this);
+}
+
+void Replica::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+        // Завершение соединения прерывает ожидание ответа источника в потоке репликации
+        if (socketHandle_.has_value()) {
+            ::shutdown(*socketHandle_, SHUT_RDWR);
+        }
+    }
+    condition_.notify_all();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+}
+
+void Replica::run()
+{
+    LOG_IMPORTANT << "Запуск репликации с сервера-источника " << sourceSocket_.string();
+    while (follow() && waitFor(REPLICATION_RECONNECT_DELAY)) {
+        LOG_INFO << "Повторное подключение к источнику репликации";
+    }
+    LOG_IMPORTANT << "Репликация остановлена";
+}
+
+bool Replica::follow()
+{
+    boost::asio::io_context ioCtx;
+    boost::asio::local::stream_protocol::socket socket(ioCtx);
+    boost::system::error_code ec;
+    socket.connect(boost::asio::local::stream_protocol::endpoint(sourceSocket_.string()), ec);
+    if (ec) {
+        LOG_WARNING << "Не удалось подключиться к источнику репликации "
+                    << sourceSocket_.string() << ": " << ec.message();
+        return true;
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) {
+            return false;
+        }
+        socketHandle_ = socket.native_handle();
+    }
+
+    auto connected = true;
+    while (connected) {
+        Request request;
+        request.requestId = std::to_string(++requestCounter_);
+        request.command = CommandType::SUBSCRIBE;
+        request.position = target_.getPosition();
+
+        Response response;
+        if (!exchange(socket, request, response)) {
+            break;
+        }
+        if (!response.success || !response.position.has_value()) {
+            LOG_ERROR << "Источник репликации отклонил запрос: "
+                      << response.error.value_or("нет положения реплики");
+            break;
+        }
+
+        ReplicationChunk chunk;
+        chunk.records = std::move(response.data).value_or(std::string());
+        chunk.next = std::move(*response.position);
+        chunk.reset = response.reset;
+        // Непримененная порция будет запрошена повторно с прежнего положения
+        if (!target_.apply(chunk)) {
+            LOG_ERROR << "Не удалось применить порцию репликации";
+            break;
+        }
+        // Пока источник отдаёт записи, следующая порция запрашивается сразу
+        if (chunk.records.empty() && !chunk.next.part.has_value()) {
+            connected = waitFor(REPLICATION_POLL_INTERVAL);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    socketHandle_.reset();
+    socket.close(ec);
+    return !stopping_;
+}
+
+bool Replica::exchange(boost::asio::local::stream_protocol::socket &socket,
+                       const Request &request, Response &response)
+{
+    std::string body;
+    if (!request.toBinary(body)) {
+        LOG_ERROR << "Не удалось сериализовать запрос к источнику репликации";
+        return false;
+    }
+    const auto header = ProtocolFrame::encodeLength(static_cast<uint32_t>(body.size()));
+
+    boost::system::error_code ec;
+    const std::array<boost::asio::const_buffer, 2> buffers{ boost::asio::buffer(header),
+                                                             boost::asio::buffer(body) };
+    boost::asio::write(socket, buffers, ec);
+    std::array<uint8_t, FRAME_HEADER_SIZE> responseHeader{};
+    if (!ec) {
+        boost::asio::read(socket, boost::asio::buffer(responseHeader), ec);
+    }
+    if (ec) {
+        LOG_WARNING << "Соединение с источником репликации разорвано: " << ec.message();
+        return false;
+    }
+
+    // Длина кадра получена от источника, поэтому память под ответ выделяется только в пределах
+    // допустимого размера кадра
+    const auto length = ProtocolFrame::decodeLength(responseHeader.data());
+    if (length > MAX_FRAME_SIZE) {
+        LOG_ERROR << "Размер ответа источника репликации превышает допустимый (" << MAX_FRAME_SIZE
+                  << " байт): " << length;
+        return false;
+    }
+    body.resize(length);
+    boost::asio::read(socket, boost::asio::buffer(body), ec);
+    if (ec) {
+        LOG_WARNING << "Соединение с источником репликации разорвано: " << ec.message();
+        return false;
+    }
+
+    // Источник, не поддерживающий двоичный формат или команду, отвечает в JSON
+    if (ProtocolFrame::messageFormat(body) != MessageFormat::BINARY) {
+        LOG_ERROR << "Источник репликации не поддерживает команду SUBSCRIBE: " << body;
+        return false;
+    }
+    auto parsed = Response::fromBinary(body);
+    if (!parsed.has_value() || parsed->requestId != request.requestId) {
+        LOG_ERROR << "Некорректный ответ источника репликации";
+        return false;
+    }
+    response = std::move(*parsed);
+    return true;
+}
+
+bool Replica::waitFor(std::chrono::milliseconds duration)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    return !condition_.wait_for(lock, duration, [this] { return stopping_; });
+}
+} // namespace octet::server
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <thread>
+#include <boost/asio.hpp>
+
+#include "protocol.hpp"
+#include "storage/replication.hpp"
+#include "storage/storage_manager.hpp"
+
+namespace octet::server {
+/**
+ * @class Replica
+ * @brief Поддерживает хранилище горячей реплики в актуальном состоянии, получая поток
+ * репликации от сервера-источника.
+ *
+ * Фоновый поток подключается к Unix-сокету источника и запрашивает порции командой SUBSCRIBE
+ * (см. ReplicationSource), применяя каждую к хранилищу через ReplicationTarget до следующего
+ * запроса. Пока источник отдаёт записи, следующая порция запрашивается сразу, а когда новых
+ * записей нет, поток ждёт интервал опроса. Репликация асинхронная: источник подтверждает
+ * операции своим клиентам, не дожидаясь реплики. После разрыва соединения поток подключается
+ * заново и продолжает с положения реплики.
+ */
+class Replica {
+public:
+    /**
+     * @brief Конструктор, загружает сохранённое положение реплики
+     * @param storage Хранилище реплики
+     * @param dataDir Директория данных хранилища реплики
+     * @param sourceSocket Путь к Unix-сокету сервера-источника
+     */
+    Replica(StorageManager &storage, const std::filesystem::path &dataDir,
+            std::filesystem::path sourceSocket);
+
+    /**
+     * @brief Деструктор, останавливает поток репликации
+     */
+    ~Replica();
+
+    // Запрещаем копирование и перемещение
+    Replica(const Replica &) = delete;
+    Replica &operator=(const Replica &) = delete;
+    Replica(Replica &&) = delete;
+    Replica &operator=(Replica &&) = delete;
+
+    /**
+     * @brief Запускает поток репликации
+     */
+    void start();
+
+    /**
+     * @brief Останавливает поток репликации, прерывая ожидание ответа источника
+     */
+    void stop();
+
+private:
+    ReplicationTarget target_; // Применение порций к хранилищу реплики
+    const std::filesystem::path sourceSocket_; // Сокет сервера-источника
+    std::thread thread_; // Поток репликации
+    std::mutex mutex_; // Защищает stopping_ и socketHandle_
+    std::condition_variable condition_; // Прерывает ожидание при остановке
+    bool stopping_ = false; // Запрошена ли остановка
+    std::optional<int> socketHandle_; // Дескриптор сокета текущего подключения
+    uint64_t requestCounter_ = 0; // Счётчик для идентификаторов запросов
+
+    /**
+     * @brief Функция потока: подключается к источнику и получает поток репликации до остановки
+     */
+    void run();
+
+    /**
+     * @brief Получает поток репликации через одно подключение к источнику
+     * @return false если получение прервано остановкой
+     */
+    bool follow();
+
+    /**
+     * @brief Отправляет запрос и дожидается ответа на него
+     * @param socket Сокет подключения к источнику
+     * @param request Запрос
+     * @param[out] response Ответ
+     * @return true если ответ получен и разобран
+     */
+    bool exchange(boost::asio::local::stream_protocol::socket &socket, const Request &request,
+                  Response &response);
+
+    /**
+     * @brief Ожидает указанное время или остановку
+     * @param duration Время ожидания
+     * @return false если запрошена остановка
+     */
+    bool waitFor(std::chrono::milliseconds duration);
+};
+} // namespace octet::server
@@ -1,5 +1,6 @@
 #include "server.hpp"
 
+#include <algorithm>
 #include <boost/system/error_code.hpp>
 
 #include "utils/file_utils.hpp"
@@ -17,21 +18,35 @@ std::filesystem::path getSocketPath(std::optional<std::string> socketPath)
 } // namespace
 
 namespace octet::server {
-Server::Server(StorageManager &storage, std::optional<std::string> socketPath)
+Server::Server(StorageManager *storage, StorageReader *reader,
+               std::optional<std::string> socketPath, const ServerConfig &config)
     : socketPath_(getSocketPath(socketPath))
     , storage_(storage)
+    , reader_(reader)
+    , config_(config)
     , running_(false)
 {
+    config_.ioThreads = std::max<size_t>(config_.ioThreads, 1);
+    config_.workerThreads = std::max<size_t>(config_.workerThreads, 1);
 }
 
 Server::~Server()
 {
     stop();
+    shutdown();
 }
 
-int Server::startServer(StorageManager &storage, std::optional<std::string> socketPath)
+int Server::startServer(StorageManager &storage, std::optional<std::string> socketPath,
+                        const ServerConfig &config)
 {
-    Server server(storage, std::move(socketPath));
+    Server server(&storage, nullptr, std::move(socketPath), config);
+    return server.start();
+}
+
+int Server::startServer(StorageReader &reader, std::optional<std::string> socketPath,
+                        const ServerConfig &config)
+{
+    Server server(nullptr, &reader, std::move(socketPath), config);
     return server.start();
 }
 
@@ -58,18 +73,23 @@ int Server::start()
             return false;
         }
 
-        // Инициализируем ASIO контекст
-        ioCtx_ = std::make_unique<boost::asio::io_context>();
+        // Инициализируем ASIO контекст и потоки операций с хранилищем
+        ioCtx_ = std::make_unique<boost::asio::io_context>(static_cast<int>(config_.ioThreads));
+        workers_ = std::make_unique<boost::asio::thread_pool>(config_.workerThreads);
+
+        // Аксептор и обработчик сигналов работают в общем strand, так как их обработчики могут
+        // выполняться в разных потоках ввода-вывода
+        const auto strand = boost::asio::make_strand(*ioCtx_);
 
         // Создаем аксептор
         acceptor_ = std::make_unique<boost::asio::local::stream_protocol::acceptor>(
-            *ioCtx_, boost::asio::local::stream_protocol::endpoint(socketPath_.string()));
+            strand, boost::asio::local::stream_protocol::endpoint(socketPath_.string()));
 
         // Начинаем принимать соединения
         accept();
 
         // Настраиваем корректную обработку сигналов
-        signalSet_ = std::make_unique<boost::asio::signal_set>(*ioCtx_, SIGINT, SIGTERM);
+        signalSet_ = std::make_unique<boost::asio::signal_set>(strand, SIGINT, SIGTERM);
         signalSet_->async_wait([this](auto ec, auto sig) {
             if (!ec) {
                 LOG_IMPORTANT << "Получен сигнал " << sig;
@@ -80,31 +100,49 @@ int Server::start()
         // Устанавливаем флаг работы
         running_ = true;
 
-        LOG_IMPORTANT << "Запуск сервера на сокете " << socketPath_.string() << "...";
-
-        // Запуск рабочего потока (блокирующий вызов)
-        ioCtx_->run();
+        LOG_IMPORTANT << "Запуск сервера на сокете " << socketPath_.string() << " (потоков "
+                      << "ввода-вывода: " << config_.ioThreads
+                      << ", потоков хранилища: " << config_.workerThreads << ")...";
 
-        LOG_IMPORTANT << "Сервер завершил работу";
-        return 0;
+        // Запуск дополнительных потоков ввода-вывода
+        for (size_t i = 1; i < config_.ioThreads; i++) {
+            ioThreads_.emplace_back([this] { runIoContext(); });
+        }
     }
     catch (const std::exception &e) {
         LOG_ERROR << "Ошибка при запуске сервера: " << e.what();
+        stop();
+        shutdown();
         return 1;
     }
+
+    // Текущий поток тоже обрабатывает события (блокирующий вызов)
+    runIoContext();
+    shutdown();
+
+    LOG_IMPORTANT << "Сервер завершил работу";
+    return 0;
+}
+
+void Server::runIoContext()
+{
+    try {
+        ioCtx_->run();
+    }
+    catch (const std::exception &e) {
+        LOG_ERROR << "Ошибка в потоке ввода-вывода: " << e.what();
+        stop();
+    }
 }
 
 void Server::stop()
 {
-    if (!running_) {
+    if (!running_.exchange(false)) {
         return;
     }
 
     LOG_IMPORTANT << "Останавливаем сервер...";
 
-    // Устанавливаем флаг остановки
-    running_ = false;
-
     if (signalSet_ != nullptr) {
         boost::system::error_code ec;
         signalSet_->cancel(ec);
@@ -120,13 +158,33 @@ void Server::stop()
         if (ec) {
             LOG_ERROR << "Ошибка при закрытии аксептора: " << ec.message();
         }
-        acceptor_.reset();
     }
 
-    // Останавливаем ASIO контекст
+    // Останавливаем ASIO контекст: run() завершится во всех потоках ввода-вывода
     if (ioCtx_ != nullptr) {
         ioCtx_->stop();
     }
+}
+
+void Server::shutdown()
+{
+    // Дожидаемся потоков ввода-вывода
+    for (auto &thread : ioThreads_) {
+        if (thread.joinable()) {
+            thread.join();
+        }
+    }
+    ioThreads_.clear();
+
+    // Дожидаемся уже начатых операций с хранилищем: их ответы не будут отправлены, но сами
+    // операции должны завершиться до освобождения соединений
+    if (workers_ != nullptr) {
+        workers_->join();
+    }
+
+    if (ioCtx_ == nullptr) {
+        return;
+    }
 
     // Удаляем файл сокета
     std::error_code ec;
@@ -136,8 +194,12 @@ void Server::stop()
                   << ", код ошибки: " << ec.value() << ", сообщение: " << ec.message();
     }
 
-    // Сбрасываем ASIO контекст
+    // Освобождаем ресурсы: соединения, удерживаемые незавершёнными обработчиками, уничтожаются
+    // вместе с ASIO контекстом
+    signalSet_.reset();
+    acceptor_.reset();
     ioCtx_.reset();
+    workers_.reset();
 }
 
 void Server::accept()
@@ -147,7 +209,8 @@ void Server::accept()
     }
 
     // Создаем новое соединение
-    auto newConnection = Connection::create(*ioCtx_, storage_);
+    auto newConnection
+        = Connection::create(*ioCtx_, *workers_, storage_, reader_, config_.readOnly);
 
     // Асинхронно принимаем соединение
     acceptor_->async_accept(newConnection->socket(),
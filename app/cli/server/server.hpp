@@ -3,11 +3,32 @@
 #include <filesystem>
 #include <memory>
 #include <atomic>
+#include <thread>
+#include <vector>
 #include <boost/asio.hpp>
 
 #include "storage/storage_manager.hpp"
+#include "storage/storage_reader.hpp"
 
 namespace octet::server {
+// Количество потоков ввода-вывода по умолчанию
+static constexpr size_t DEFAULT_IO_THREADS = 2;
+// Количество потоков для операций с хранилищем по умолчанию
+static constexpr size_t DEFAULT_WORKER_THREADS = 4;
+
+/**
+ * @struct ServerConfig
+ * @brief Параметры потоков и режима сервера
+ */
+struct ServerConfig {
+    // Потоки, обслуживающие сокеты (чтение, разбор кадров и запись ответов)
+    size_t ioThreads = DEFAULT_IO_THREADS;
+    // Потоки, выполняющие операции с хранилищем (в том числе ожидание фиксации на диске)
+    size_t workerThreads = DEFAULT_WORKER_THREADS;
+    // Отклонять запросы изменения хранилища (хранилище реплики изменяет только поток репликации)
+    bool readOnly = false;
+};
+
 /**
  * @class Server
  * @brief Серверный процесс для обработки запросов от Go
@@ -16,24 +37,46 @@ class Server {
 public:
     /**
      * @brief Инициализация и запуск сервера
+     * @param storage Хранилище
+     * @param socketPath Путь к Unix Domain Socket
+     * @param config Параметры потоков и режима сервера
      * @return Код завершения
      */
-    static int startServer(StorageManager &storage, std::optional<std::string> socketPath);
+    static int startServer(StorageManager &storage, std::optional<std::string> socketPath,
+                           const ServerConfig &config = ServerConfig{});
+
+    /**
+     * @brief Инициализация и запуск сервера только для чтения над хранилищем другого процесса
+     * (запросы изменения хранилища отклоняются)
+     * @param reader Хранилище только для чтения
+     * @param socketPath Путь к Unix Domain Socket
+     * @param config Параметры потоков сервера
+     * @return Код завершения
+     */
+    static int startServer(StorageReader &reader, std::optional<std::string> socketPath,
+                           const ServerConfig &config = ServerConfig{});
 
 private:
-    StorageManager &storage_; // Хранилище
+    StorageManager *storage_; // Хранилище (nullptr в режиме только для чтения)
+    StorageReader *reader_; // Хранилище только для чтения (nullptr, если не используется)
     std::filesystem::path socketPath_; // Путь к сокету
+    ServerConfig config_; // Параметры потоков
     std::unique_ptr<boost::asio::io_context> ioCtx_; // ASIO контекст
+    std::unique_ptr<boost::asio::thread_pool> workers_; // Потоки операций с хранилищем
+    std::vector<std::thread> ioThreads_; // Дополнительные потоки ввода-вывода
     std::unique_ptr<boost::asio::local::stream_protocol::acceptor> acceptor_; // Ассептор соединений
     std::unique_ptr<boost::asio::signal_set> signalSet_; // Обработчик сигналов завершения
     std::atomic<bool> running_; // Флаг работы сервера
 
     /**
      * @brief Конструктор сервера
-     * @param storagePath Путь к хранилищу
+     * @param storage Хранилище (nullptr в режиме только для чтения)
+     * @param reader Хранилище только для чтения (nullptr, если не используется)
      * @param socketPath Путь к Unix Domain Socket
+     * @param config Параметры потоков сервера
      */
-    Server(StorageManager &storage, std::optional<std::string> socketPath);
+    Server(StorageManager *storage, StorageReader *reader, std::optional<std::string> socketPath,
+           const ServerConfig &config);
 
     /**
      * @brief Деструктор сервера
@@ -47,10 +90,21 @@ private:
     int start();
 
     /**
-     * @brief Остановка сервера
+     * @brief Остановка сервера: прекращает приём соединений и работу потоков ввода-вывода
+     * (ресурсы освобождаются в start() после завершения всех потоков)
      */
     void stop();
 
+    /**
+     * @brief Обработка событий ASIO в текущем потоке до остановки сервера
+     */
+    void runIoContext();
+
+    /**
+     * @brief Ожидание завершения потоков и освобождение ресурсов сервера
+     */
+    void shutdown();
+
     /**
      * @brief Принятие нового соединения
      */
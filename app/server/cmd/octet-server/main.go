@@ -85,6 +85,7 @@ func main() {
 	// Создание REST API сервера
 	router := api.NewRouter(api.RouterConfig{
 		ClientPool: clientPool,
+		Cache:      service.NewResponseCache(cfg.CacheSize),
 		Logger:     logger,
 	})
 	server := &http.Server{
@@ -42,6 +42,32 @@ const docTemplate = `{
                 }
             }
         },
+        "/metrics": {
+            "get": {
+                "description": "Задержки операций, fsync журнала, снапшотов и очередей записи в текстовом формате Prometheus",
+                "produces": [
+                    "text/plain"
+                ],
+                "tags": [
+                    "health"
+                ],
+                "summary": "Показатели работы хранилища",
+                "responses": {
+                    "200": {
+                        "description": "OK",
+                        "schema": {
+                            "type": "string"
+                        }
+                    },
+                    "500": {
+                        "description": "Internal Server Error",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    }
+                }
+            }
+        },
         "/octet/v1": {
             "post": {
                 "description": "Сохранение строки UTF-8 и получение UUID",
@@ -88,6 +114,150 @@ const docTemplate = `{
                 }
             }
         },
+        "/octet/v1/batch": {
+            "post": {
+                "description": "Атомарное выполнение операций insert, update и remove одним запросом",
+                "consumes": [
+                    "application/json"
+                ],
+                "produces": [
+                    "application/json"
+                ],
+                "tags": [
+                    "strings"
+                ],
+                "summary": "Пакетное выполнение операций",
+                "parameters": [
+                    {
+                        "description": "Операции пакета",
+                        "name": "operations",
+                        "in": "body",
+                        "required": true,
+                        "schema": {
+                            "$ref": "#/definitions/api.BatchHeader"
+                        }
+                    }
+                ],
+                "responses": {
+                    "200": {
+                        "description": "OK",
+                        "schema": {
+                            "$ref": "#/definitions/api.UuidsHeader"
+                        }
+                    },
+                    "400": {
+                        "description": "Bad Request",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    },
+                    "500": {
+                        "description": "Internal Server Error",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    }
+                }
+            }
+        },
+        "/octet/v1/import": {
+            "post": {
+                "description": "Загрузка строк без журналирования каждой. Строки фиксируются снапшотом до ответа на запрос без partial=true вместе со строками предыдущих запросов с partial=true",
+                "consumes": [
+                    "application/json"
+                ],
+                "produces": [
+                    "application/json"
+                ],
+                "tags": [
+                    "strings"
+                ],
+                "summary": "Загрузка строк",
+                "parameters": [
+                    {
+                        "description": "Строки для загрузки",
+                        "name": "values",
+                        "in": "body",
+                        "required": true,
+                        "schema": {
+                            "$ref": "#/definitions/api.ImportHeader"
+                        }
+                    },
+                    {
+                        "type": "boolean",
+                        "description": "Загрузка продолжится следующими запросами",
+                        "name": "partial",
+                        "in": "query"
+                    }
+                ],
+                "responses": {
+                    "200": {
+                        "description": "OK",
+                        "schema": {
+                            "$ref": "#/definitions/api.UuidsHeader"
+                        }
+                    },
+                    "400": {
+                        "description": "Bad Request",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    },
+                    "500": {
+                        "description": "Internal Server Error",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    }
+                }
+            }
+        },
+        "/octet/v1/mget": {
+            "post": {
+                "description": "Извлечение строк из хранилища по списку UUID (null для отсутствующих)",
+                "consumes": [
+                    "application/json"
+                ],
+                "produces": [
+                    "application/json"
+                ],
+                "tags": [
+                    "strings"
+                ],
+                "summary": "Получение нескольких строк",
+                "parameters": [
+                    {
+                        "description": "UUID строк",
+                        "name": "uuids",
+                        "in": "body",
+                        "required": true,
+                        "schema": {
+                            "$ref": "#/definitions/api.UuidsHeader"
+                        }
+                    }
+                ],
+                "responses": {
+                    "200": {
+                        "description": "OK",
+                        "schema": {
+                            "$ref": "#/definitions/api.ValuesHeader"
+                        }
+                    },
+                    "400": {
+                        "description": "Bad Request",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    },
+                    "500": {
+                        "description": "Internal Server Error",
+                        "schema": {
+                            "$ref": "#/definitions/api.ErrorHeader"
+                        }
+                    }
+                }
+            }
+        },
         "/octet/v1/{uuid}": {
             "get": {
                 "description": "Извлечение строки из хранилища по её UUID",
@@ -105,6 +275,12 @@ const docTemplate = `{
                         "name": "uuid",
                         "in": "path",
                         "required": true
+                    },
+                    {
+                        "type": "string",
+                        "description": "ETag ранее полученной версии строки",
+                        "name": "If-None-Match",
+                        "in": "header"
                     }
                 ],
                 "responses": {
@@ -112,8 +288,17 @@ const docTemplate = `{
                         "description": "OK",
                         "schema": {
                             "$ref": "#/definitions/api.DataHeader"
+                        },
+                        "headers": {
+                            "ETag": {
+                                "type": "string",
+                                "description": "Версия строки"
+                            }
                         }
                     },
+                    "304": {
+                        "description": "Строка не изменилась"
+                    },
                     "400": {
                         "description": "Bad Request",
                         "schema": {
@@ -212,6 +397,17 @@ const docTemplate = `{
         }
     },
     "definitions": {
+        "api.BatchHeader": {
+            "type": "object",
+            "properties": {
+                "operations": {
+                    "type": "array",
+                    "items": {
+                        "$ref": "#/definitions/protocol.BatchOperation"
+                    }
+                }
+            }
+        },
         "api.DataHeader": {
             "type": "object",
             "properties": {
@@ -239,6 +435,17 @@ const docTemplate = `{
                 }
             }
         },
+        "api.ImportHeader": {
+            "type": "object",
+            "properties": {
+                "values": {
+                    "type": "array",
+                    "items": {
+                        "type": "string"
+                    }
+                }
+            }
+        },
         "api.UuidHeader": {
             "type": "object",
             "properties": {
@@ -246,6 +453,63 @@ const docTemplate = `{
                     "type": "string"
                 }
             }
+        },
+        "api.UuidsHeader": {
+            "type": "object",
+            "properties": {
+                "uuids": {
+                    "type": "array",
+                    "items": {
+                        "type": "string"
+                    }
+                }
+            }
+        },
+        "api.ValuesHeader": {
+            "type": "object",
+            "properties": {
+                "values": {
+                    "type": "array",
+                    "items": {
+                        "type": "string"
+                    }
+                }
+            }
+        },
+        "protocol.BatchOperation": {
+            "type": "object",
+            "properties": {
+                "command": {
+                    "$ref": "#/definitions/protocol.CommandType"
+                },
+                "data": {
+                    "type": "string"
+                },
+                "uuid": {
+                    "type": "string"
+                }
+            }
+        },
+        "protocol.CommandType": {
+            "type": "string",
+            "enum": [
+                "insert",
+                "get",
+                "update",
+                "remove",
+                "batch",
+                "mget",
+                "ping"
+            ],
+            "x-enum-varnames": [
+                "CommandInsert",
+                "CommandGet",
+                "CommandUpdate",
+                "CommandRemove",
+                "CommandBatch",
+                "CommandMGet",
+                "CommandPing"
+            ]
         }
     }
 }`
@@ -3,9 +3,12 @@ package api
 import (
 	"encoding/json"
 	"net/http"
+	"strconv"
+	"strings"
 	"time"
 
 	"github.com/go-chi/chi/v5"
+	"github.com/lildannita/octet-server/internal/protocol"
 	"github.com/lildannita/octet-server/internal/service"
 	"go.uber.org/zap"
 )
@@ -20,6 +23,26 @@ type UuidHeader struct {
 	Uuid string `json:"uuid"`
 }
 
+// Для отправки пакета операций
+type BatchHeader struct {
+	Operations []protocol.BatchOperation `json:"operations"`
+}
+
+// Для отправки UUID строк
+type UuidsHeader struct {
+	Uuids []string `json:"uuids"`
+}
+
+// Для загрузки строк
+type ImportHeader struct {
+	Values []string `json:"values"`
+}
+
+// Для получения нескольких строк (null - строка не найдена)
+type ValuesHeader struct {
+	Values []*string `json:"values"`
+}
+
 // Для ответа с информацией об ошибке
 type ErrorHeader struct {
 	Error string `json:"error"`
@@ -34,6 +57,7 @@ type HealthCheckResponse struct {
 // Handler содержит обработчики HTTP-запросов
 type Handler struct {
 	clientPool *service.ClientPool
+	cache      *service.ResponseCache // Кэш строк (nil, если отключен)
 	logger     *zap.Logger
 }
 
@@ -67,6 +91,37 @@ func (h *Handler) HealthCheck(w http.ResponseWriter, r *http.Request) {
 	})
 }
 
+// Metrics godoc
+// @Summary Показатели работы хранилища
+// @Description Задержки операций, fsync журнала, снапшотов и очередей записи в текстовом формате Prometheus
+// @Tags health
+// @Produce plain
+// @Success 200 {string} string
+// @Failure 500 {object} ErrorHeader
+// @Router /metrics [get]
+func (h *Handler) Metrics(w http.ResponseWriter, r *http.Request) {
+	// Получаем клиент из пула
+	client, err := h.clientPool.GetClient()
+	if err != nil {
+		h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Сервер недоступен")
+		return
+	}
+
+	// Получаем показатели
+	metrics, err := client.Stats(r.Context())
+	if err != nil {
+		h.logger.Error("Не удалось выполнить octet::stats", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Ошибка при получении показателей: "+err.Error())
+		return
+	}
+
+	// Отправляем ответ
+	w.Header().Set("Content-Type", "text/plain; version=0.0.4; charset=utf-8")
+	w.WriteHeader(http.StatusOK)
+	w.Write([]byte(metrics))
+}
+
 // Insert godoc
 // @Summary Добавление новой строки
 // @Description Сохранение строки UTF-8 и получение UUID
@@ -119,7 +174,10 @@ func (h *Handler) Insert(w http.ResponseWriter, r *http.Request) {
 // @Tags strings
 // @Produce json
 // @Param uuid path string true "UUID строки"
+// @Param If-None-Match header string false "ETag ранее полученной версии строки"
 // @Success 200 {object} DataHeader
+// @Header 200 {string} ETag "Версия строки"
+// @Success 304 "Строка не изменилась"
 // @Failure 400 {object} ErrorHeader
 // @Failure 500 {object} ErrorHeader
 // @Router /octet/v1/{uuid} [get]
@@ -131,24 +189,41 @@ func (h *Handler) Get(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
-	// Получаем клиент из пула
-	client, err := h.clientPool.GetClient()
-	if err != nil {
-		h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
-		respondWithError(w, http.StatusInternalServerError, "Внутренняя ошибка сервера")
-		return
+	// Популярные строки отдаются из кэша без обращения к octet
+	entry, ok := h.cache.Get(uuid)
+	if !ok {
+		// Поколение кэша запоминается до чтения, чтобы не сохранить строку, измененную во время чтения
+		generation := h.cache.Generation()
+
+		// Получаем клиент из пула
+		client, err := h.clientPool.GetClient()
+		if err != nil {
+			h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
+			respondWithError(w, http.StatusInternalServerError, "Внутренняя ошибка сервера")
+			return
+		}
+
+		// Получаем строку
+		data, err := client.Get(r.Context(), uuid)
+		if err != nil {
+			h.logger.Error("Ошибка при получении строки", zap.Error(err))
+			respondWithError(w, http.StatusInternalServerError, "Ошибка при получении строки: "+err.Error())
+			return
+		}
+
+		entry = service.CacheEntry{Data: data, ETag: service.ContentETag(data)}
+		h.cache.Add(uuid, entry, generation)
 	}
 
-	// Получаем строку
-	data, err := client.Get(r.Context(), uuid)
-	if err != nil {
-		h.logger.Error("Ошибка при получении строки", zap.Error(err))
-		respondWithError(w, http.StatusInternalServerError, "Ошибка при получении строки: "+err.Error())
+	// Если у клиента уже есть эта версия строки, тело ответа не передается
+	w.Header().Set("ETag", entry.ETag)
+	if etagMatches(r.Header.Get("If-None-Match"), entry.ETag) {
+		w.WriteHeader(http.StatusNotModified)
 		return
 	}
 
 	// Отправляем ответ
-	respondWithJSON(w, http.StatusOK, DataHeader{Data: data})
+	respondWithJSON(w, http.StatusOK, DataHeader{Data: entry.Data})
 }
 
 // Update godoc
@@ -193,8 +268,10 @@ func (h *Handler) Update(w http.ResponseWriter, r *http.Request) {
 		return
 	}
 
-	// Обновляем строку
-	if err := client.Update(r.Context(), uuid, updateReq.Data); err != nil {
+	// Обновляем строку (кэш сбрасывается и при ошибке, так как результат может быть неизвестен)
+	err = client.Update(r.Context(), uuid, updateReq.Data)
+	h.cache.Invalidate(uuid)
+	if err != nil {
 		h.logger.Error("Ошибка при обновлении строки", zap.Error(err))
 		respondWithError(w, http.StatusInternalServerError, "Ошибка при обновлении строки: "+err.Error())
 		return
@@ -230,7 +307,9 @@ func (h *Handler) Remove(w http.ResponseWriter, r *http.Request) {
 	}
 
 	// Удаляем строку
-	if err := client.Remove(r.Context(), uuid); err != nil {
+	err = client.Remove(r.Context(), uuid)
+	h.cache.Invalidate(uuid)
+	if err != nil {
 		h.logger.Error("Ошибка при удалении строки", zap.Error(err))
 		respondWithError(w, http.StatusInternalServerError, "Ошибка при удалении строки: "+err.Error())
 		return
@@ -240,6 +319,207 @@ func (h *Handler) Remove(w http.ResponseWriter, r *http.Request) {
 	w.WriteHeader(http.StatusNoContent)
 }
 
+// Batch godoc
+// @Summary Пакетное выполнение операций
+// @Description Атомарное выполнение операций insert, update и remove одним запросом
+// @Tags strings
+// @Accept json
+// @Produce json
+// @Param operations body BatchHeader true "Операции пакета"
+// @Success 200 {object} UuidsHeader
+// @Failure 400 {object} ErrorHeader
+// @Failure 500 {object} ErrorHeader
+// @Router /octet/v1/batch [post]
+func (h *Handler) Batch(w http.ResponseWriter, r *http.Request) {
+	// Разбираем запрос
+	var batchReq BatchHeader
+	if err := json.NewDecoder(r.Body).Decode(&batchReq); err != nil {
+		h.logger.Error("Ошибка при разборе запроса", zap.Error(err))
+		respondWithError(w, http.StatusBadRequest, "Некорректный запрос")
+		return
+	}
+
+	// Проверяем операции
+	if len(batchReq.Operations) == 0 {
+		respondWithError(w, http.StatusBadRequest, "Поле 'operations' не может быть пустым")
+		return
+	}
+	for _, operation := range batchReq.Operations {
+		switch operation.Command {
+		case protocol.CommandInsert:
+		case protocol.CommandUpdate, protocol.CommandRemove:
+			if len(operation.Uuid) == 0 {
+				respondWithError(w, http.StatusBadRequest, "UUID операции не указан")
+				return
+			}
+		default:
+			respondWithError(w, http.StatusBadRequest,
+				"Неподдерживаемая операция пакета: "+string(operation.Command))
+			return
+		}
+		if operation.Command != protocol.CommandRemove && len(operation.Data) == 0 {
+			respondWithError(w, http.StatusBadRequest, "Поле 'data' не может быть пустым")
+			return
+		}
+	}
+
+	// Получаем клиент из пула
+	client, err := h.clientPool.GetClient()
+	if err != nil {
+		h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Внутренняя ошибка сервера")
+		return
+	}
+
+	// Выполняем пакет операций
+	uuids, err := client.Batch(r.Context(), batchReq.Operations)
+	h.invalidateBatch(batchReq.Operations)
+	if err != nil {
+		h.logger.Error("Ошибка при выполнении пакета операций", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError,
+			"Ошибка при выполнении пакета операций: "+err.Error())
+		return
+	}
+
+	// Отправляем ответ
+	respondWithJSON(w, http.StatusOK, UuidsHeader{Uuids: uuids})
+}
+
+// MGet godoc
+// @Summary Получение нескольких строк
+// @Description Извлечение строк из хранилища по списку UUID (null для отсутствующих)
+// @Tags strings
+// @Accept json
+// @Produce json
+// @Param uuids body UuidsHeader true "UUID строк"
+// @Success 200 {object} ValuesHeader
+// @Failure 400 {object} ErrorHeader
+// @Failure 500 {object} ErrorHeader
+// @Router /octet/v1/mget [post]
+func (h *Handler) MGet(w http.ResponseWriter, r *http.Request) {
+	// Разбираем запрос
+	var mgetReq UuidsHeader
+	if err := json.NewDecoder(r.Body).Decode(&mgetReq); err != nil {
+		h.logger.Error("Ошибка при разборе запроса", zap.Error(err))
+		respondWithError(w, http.StatusBadRequest, "Некорректный запрос")
+		return
+	}
+
+	// Проверяем данные
+	if len(mgetReq.Uuids) == 0 {
+		respondWithError(w, http.StatusBadRequest, "Поле 'uuids' не может быть пустым")
+		return
+	}
+
+	// Получаем клиент из пула
+	client, err := h.clientPool.GetClient()
+	if err != nil {
+		h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Внутренняя ошибка сервера")
+		return
+	}
+
+	// Получаем строки
+	values, err := client.MGet(r.Context(), mgetReq.Uuids)
+	if err != nil {
+		h.logger.Error("Ошибка при получении строк", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Ошибка при получении строк: "+err.Error())
+		return
+	}
+
+	// Отправляем ответ
+	respondWithJSON(w, http.StatusOK, ValuesHeader{Values: values})
+}
+
+// Import godoc
+// @Summary Загрузка строк
+// @Description Загрузка строк без журналирования каждой. Строки фиксируются снапшотом до ответа на запрос без partial=true вместе со строками предыдущих запросов с partial=true
+// @Tags strings
+// @Accept json
+// @Produce json
+// @Param values body ImportHeader true "Строки для загрузки"
+// @Param partial query bool false "Загрузка продолжится следующими запросами"
+// @Success 200 {object} UuidsHeader
+// @Failure 400 {object} ErrorHeader
+// @Failure 500 {object} ErrorHeader
+// @Router /octet/v1/import [post]
+func (h *Handler) Import(w http.ResponseWriter, r *http.Request) {
+	// Разбираем запрос
+	var importReq ImportHeader
+	if err := json.NewDecoder(r.Body).Decode(&importReq); err != nil {
+		h.logger.Error("Ошибка при разборе запроса", zap.Error(err))
+		respondWithError(w, http.StatusBadRequest, "Некорректный запрос")
+		return
+	}
+
+	// Запросы загрузки, кроме последнего, не создают снапшот
+	partial := false
+	if value := r.URL.Query().Get("partial"); value != "" {
+		parsed, err := strconv.ParseBool(value)
+		if err != nil {
+			respondWithError(w, http.StatusBadRequest, "Некорректный параметр 'partial'")
+			return
+		}
+		partial = parsed
+	}
+
+	// Проверяем данные
+	if len(importReq.Values) == 0 {
+		respondWithError(w, http.StatusBadRequest, "Поле 'values' не может быть пустым")
+		return
+	}
+	for _, value := range importReq.Values {
+		if len(value) == 0 {
+			respondWithError(w, http.StatusBadRequest, "Строки в поле 'values' не могут быть пустыми")
+			return
+		}
+	}
+
+	// Получаем клиент из пула
+	client, err := h.clientPool.GetClient()
+	if err != nil {
+		h.logger.Error("Не удалось получить клиент из пула", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Внутренняя ошибка сервера")
+		return
+	}
+
+	// Загружаем строки (новые UUID не могут быть в кэше, поэтому кэш не сбрасывается)
+	uuids, err := client.Import(r.Context(), importReq.Values, partial)
+	if err != nil {
+		h.logger.Error("Ошибка при загрузке строк", zap.Error(err))
+		respondWithError(w, http.StatusInternalServerError, "Ошибка при загрузке строк: "+err.Error())
+		return
+	}
+
+	// Отправляем ответ
+	respondWithJSON(w, http.StatusOK, UuidsHeader{Uuids: uuids})
+}
+
+// invalidateBatch сбрасывает кэш строк, изменяемых пакетом операций
+func (h *Handler) invalidateBatch(operations []protocol.BatchOperation) {
+	uuids := make([]string, 0, len(operations))
+	for _, operation := range operations {
+		if operation.Command != protocol.CommandInsert {
+			uuids = append(uuids, operation.Uuid)
+		}
+	}
+	if len(uuids) != 0 {
+		h.cache.Invalidate(uuids...)
+	}
+}
+
+// etagMatches проверяет, совпадает ли версия строки с одной из версий в If-None-Match
+// (используется слабое сравнение, как требуется для GET)
+func etagMatches(header, etag string) bool {
+	for _, candidate := range strings.Split(header, ",") {
+		candidate = strings.TrimSpace(candidate)
+		if candidate == "*" || strings.TrimPrefix(candidate, "W/") == etag {
+			return true
+		}
+	}
+	return false
+}
+
 // respondWithError отправляет клиенту ответ с ошибкой
 func respondWithError(w http.ResponseWriter, code int, message string) {
 	respondWithJSON(w, code, ErrorHeader{Error: message})
@@ -17,6 +17,8 @@ import (
 type RouterConfig struct {
 	// Пул клиентов для взаимодействия с C++ процессом
 	ClientPool *service.ClientPool
+	// Кэш строк для GET-запросов (nil - кэш отключен)
+	Cache *service.ResponseCache
 	// Логгер
 	Logger *zap.Logger
 }
@@ -42,8 +44,8 @@ func NewRouter(config RouterConfig) http.Handler {
 	r.Use(cors.Handler(cors.Options{
 		AllowedOrigins:   []string{"*"},
 		AllowedMethods:   []string{"GET", "POST", "PUT", "DELETE", "OPTIONS"},
-		AllowedHeaders:   []string{"Accept", "Content-Type"},
-		ExposedHeaders:   []string{"Link"},
+		AllowedHeaders:   []string{"Accept", "Content-Type", "If-None-Match"},
+		ExposedHeaders:   []string{"Link", "ETag"},
 		AllowCredentials: false,
 		MaxAge:           300,
 	}))
@@ -53,17 +55,22 @@ func NewRouter(config RouterConfig) http.Handler {
 	// Обработчики API
 	h := &Handler{
 		clientPool: config.ClientPool,
+		cache:      config.Cache,
 		logger:     config.Logger,
 	}
 
 	// Маршруты
 	r.Get("/health", h.HealthCheck)
+	r.Get("/metrics", h.Metrics)
 
 	// API
 	r.Route("/octet", func(r chi.Router) {
 		// API v1
 		r.Route("/v1", func(r chi.Router) {
 			r.Post("/", h.Insert)
+			r.Post("/batch", h.Batch)
+			r.Post("/mget", h.MGet)
+			r.Post("/import", h.Import)
 			r.Get("/{uuid}", h.Get)
 			r.Put("/{uuid}", h.Update)
 			r.Delete("/{uuid}", h.Remove)
@@ -17,7 +17,8 @@ type Config struct {
 	SocketPath string `json:"socket_path"` // Путь к UNIX domain socket для связи с C++ процессом
 	OctetPath  string `json:"octet_path"`  // Путь к исполняемому файлу octet
 	HTTPAddr   string `json:"http_addr"`   // Адрес и порт для HTTP сервера
-	MaxClients int    `json:"max_clients"` // Максимальное количество клиентов
+	MaxClients int    `json:"max_clients"` // Количество соединений с octet (запросы мультиплексируются)
+	CacheSize  int    `json:"cache_size"`  // Количество строк в кэше GET-запросов (0 - кэш отключен)
 }
 
 // Загрузка конфигурации из JSON файла по указанному пути
@@ -58,6 +59,7 @@ func Load(configPath string) (*Config, error) {
 		SocketPath: filepath.Join(octetDir, "octet.sock"),
 		OctetPath:  "",
 		HTTPAddr:   ":8080",
+		CacheSize:  10000,
 	}
 
 	var baseDir string
@@ -0,0 +1,295 @@
+package protocol
+
+import (
+	"encoding/binary"
+	"encoding/hex"
+	"errors"
+	"fmt"
+	"math"
+)
+
+// Название двоичного формата сообщений, согласуемого запросом ping
+const ProtocolBinary = "binary"
+
+// Первый байт двоичного сообщения (JSON-сообщение всегда начинается с '{')
+const binaryMagic = 0x01
+
+// Размер UUID в двоичном формате
+const uuidSize = 16
+
+// Флаги полей двоичного запроса
+const (
+	requestHasUuid       = 0x01
+	requestHasData       = 0x02
+	requestHasUuids      = 0x04
+	requestHasOperations = 0x08
+	requestHasValues     = 0x10
+	requestPartial       = 0x40
+)
+
+// Флаги полей двоичного ответа
+const (
+	responseSuccess   = 0x01
+	responseHasUuid   = 0x02
+	responseHasData   = 0x04
+	responseHasUuids  = 0x08
+	responseHasValues = 0x10
+	responseHasError  = 0x20
+)
+
+// Коды команд двоичного формата
+var binaryCommands = map[CommandType]byte{
+	CommandInsert: 1,
+	CommandGet:    2,
+	CommandUpdate: 3,
+	CommandRemove: 4,
+	CommandBatch:  5,
+	CommandMGet:   6,
+	CommandPing:   7,
+	CommandStats:  8,
+	CommandImport: 9,
+}
+
+// Запрос нельзя представить в двоичном формате (например, UUID не в каноническом виде),
+// и он должен быть отправлен в JSON
+var ErrNotBinaryEncodable = errors.New("запрос нельзя представить в двоичном формате")
+
+// Разбор UUID в каноническом виде (xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx, нижний регистр)
+func parseUuid(uuid string) ([uuidSize]byte, bool) {
+	var result [uuidSize]byte
+	if len(uuid) != 36 || uuid[8] != '-' || uuid[13] != '-' || uuid[18] != '-' || uuid[23] != '-' {
+		return result, false
+	}
+	digits := uuid[0:8] + uuid[9:13] + uuid[14:18] + uuid[19:23] + uuid[24:36]
+	for i := 0; i < len(digits); i++ {
+		if c := digits[i]; (c < '0' || c > '9') && (c < 'a' || c > 'f') {
+			return result, false
+		}
+	}
+	if _, err := hex.Decode(result[:], []byte(digits)); err != nil {
+		return result, false
+	}
+	return result, true
+}
+
+// Строковое представление UUID из 16 байт
+func formatUuid(uuid []byte) string {
+	digits := hex.EncodeToString(uuid)
+	return digits[0:8] + "-" + digits[8:12] + "-" + digits[12:16] + "-" + digits[16:20] + "-" + digits[20:32]
+}
+
+// Добавление UUID в двоичном виде
+func appendUuid(buf []byte, uuid string) ([]byte, bool) {
+	parsed, ok := parseUuid(uuid)
+	if !ok {
+		return buf, false
+	}
+	return append(buf, parsed[:]...), true
+}
+
+// Добавление данных с длиной uint32
+func appendData(buf []byte, data string) []byte {
+	buf = binary.LittleEndian.AppendUint32(buf, uint32(len(data)))
+	return append(buf, data...)
+}
+
+// Нужны ли данные команде (пустая строка тоже передаётся)
+func commandHasData(command CommandType, data string) bool {
+	return command == CommandInsert || command == CommandUpdate || len(data) != 0
+}
+
+// Сериализация запроса в двоичный формат (кадр с заголовком длины)
+func EncodeBinary(request *Request) ([]byte, error) {
+	command, ok := binaryCommands[request.Command]
+	if !ok || len(request.RequestId) > math.MaxUint16 {
+		return nil, ErrNotBinaryEncodable
+	}
+	params := &request.Params
+
+	var flags byte
+	if len(params.Uuid) != 0 {
+		flags |= requestHasUuid
+	}
+	if commandHasData(request.Command, params.Data) {
+		flags |= requestHasData
+	}
+	if params.Uuids != nil {
+		flags |= requestHasUuids
+	}
+	if params.Operations != nil {
+		flags |= requestHasOperations
+	}
+	if params.Values != nil {
+		flags |= requestHasValues
+	}
+	if params.Partial {
+		flags |= requestPartial
+	}
+
+	// Место под заголовок кадра заполняется после сериализации сообщения
+	buf := make([]byte, headerSize, headerSize+64+len(params.Data))
+	buf = append(buf, binaryMagic, command, flags)
+	buf = binary.LittleEndian.AppendUint16(buf, uint16(len(request.RequestId)))
+	buf = append(buf, request.RequestId...)
+
+	if flags&requestHasUuid != 0 {
+		if buf, ok = appendUuid(buf, params.Uuid); !ok {
+			return nil, ErrNotBinaryEncodable
+		}
+	}
+	if flags&requestHasData != 0 {
+		buf = appendData(buf, params.Data)
+	}
+	if flags&requestHasUuids != 0 {
+		buf = binary.LittleEndian.AppendUint32(buf, uint32(len(params.Uuids)))
+		for _, uuid := range params.Uuids {
+			if buf, ok = appendUuid(buf, uuid); !ok {
+				return nil, ErrNotBinaryEncodable
+			}
+		}
+	}
+	if flags&requestHasOperations != 0 {
+		buf = binary.LittleEndian.AppendUint32(buf, uint32(len(params.Operations)))
+		for _, operation := range params.Operations {
+			operationCommand, ok := binaryCommands[operation.Command]
+			if !ok {
+				return nil, ErrNotBinaryEncodable
+			}
+			var operationFlags byte
+			if len(operation.Uuid) != 0 {
+				operationFlags |= requestHasUuid
+			}
+			if commandHasData(operation.Command, operation.Data) {
+				operationFlags |= requestHasData
+			}
+			buf = append(buf, operationCommand, operationFlags)
+			if operationFlags&requestHasUuid != 0 {
+				if buf, ok = appendUuid(buf, operation.Uuid); !ok {
+					return nil, ErrNotBinaryEncodable
+				}
+			}
+			if operationFlags&requestHasData != 0 {
+				buf = appendData(buf, operation.Data)
+			}
+		}
+	}
+
+	if flags&requestHasValues != 0 {
+		buf = binary.LittleEndian.AppendUint32(buf, uint32(len(params.Values)))
+		for _, value := range params.Values {
+			// Отсутствующую строку нельзя передать в двоичном формате
+			if value == nil {
+				return nil, ErrNotBinaryEncodable
+			}
+			buf = appendData(buf, *value)
+		}
+	}
+
+	// Записываем длину сообщения (в формате little endian)
+	binary.LittleEndian.PutUint32(buf[:headerSize], uint32(len(buf)-headerSize))
+	return buf, nil
+}
+
+// Последовательное чтение полей двоичного сообщения с проверкой границ
+type binaryReader struct {
+	data []byte
+	err  error
+}
+
+func (r *binaryReader) take(n int) []byte {
+	if r.err != nil {
+		return nil
+	}
+	if n < 0 || len(r.data) < n {
+		r.err = errors.New("двоичное сообщение обрезано")
+		return nil
+	}
+	result := r.data[:n]
+	r.data = r.data[n:]
+	return result
+}
+
+func (r *binaryReader) byte() byte {
+	if b := r.take(1); b != nil {
+		return b[0]
+	}
+	return 0
+}
+
+func (r *binaryReader) uint16() uint16 {
+	if b := r.take(2); b != nil {
+		return binary.LittleEndian.Uint16(b)
+	}
+	return 0
+}
+
+func (r *binaryReader) uint32() uint32 {
+	if b := r.take(4); b != nil {
+		return binary.LittleEndian.Uint32(b)
+	}
+	return 0
+}
+
+func (r *binaryReader) data32() string {
+	return string(r.take(int(r.uint32())))
+}
+
+func (r *binaryReader) uuid() string {
+	if b := r.take(uuidSize); b != nil {
+		return formatUuid(b)
+	}
+	return ""
+}
+
+// Количество элементов с проверкой, что элементы минимального размера поместятся
+func (r *binaryReader) count(minItemSize int) int {
+	count := int(r.uint32())
+	if r.err == nil && len(r.data)/minItemSize < count {
+		r.err = errors.New("некорректное количество элементов в двоичном сообщении")
+		return 0
+	}
+	return count
+}
+
+// Десериализация ответа из двоичного формата
+func decodeBinaryResponse(message []byte) (*Response, error) {
+	reader := &binaryReader{data: message}
+	reader.byte() // binaryMagic
+	flags := reader.byte()
+
+	var response Response
+	response.RequestId = string(reader.take(int(reader.uint16())))
+	response.Success = flags&responseSuccess != 0
+	if flags&responseHasUuid != 0 {
+		response.Params.Uuid = reader.uuid()
+	}
+	if flags&responseHasData != 0 {
+		response.Params.Data = reader.data32()
+	}
+	if flags&responseHasUuids != 0 {
+		response.Params.Uuids = make([]string, reader.count(uuidSize))
+		for i := range response.Params.Uuids {
+			response.Params.Uuids[i] = reader.uuid()
+		}
+	}
+	if flags&responseHasValues != 0 {
+		response.Params.Values = make([]*string, reader.count(1))
+		for i := range response.Params.Values {
+			if reader.byte() != 0 {
+				value := reader.data32()
+				response.Params.Values[i] = &value
+			}
+		}
+	}
+	if flags&responseHasError != 0 {
+		response.Error = reader.data32()
+	}
+
+	if reader.err == nil && len(reader.data) != 0 {
+		reader.err = errors.New("лишние данные в конце двоичного сообщения")
+	}
+	if reader.err != nil {
+		return nil, fmt.Errorf("ошибка десериализации ответа: %w", reader.err)
+	}
+	return &response, nil
+}
@@ -16,7 +16,11 @@ const (
 	CommandGet    CommandType = "get"
 	CommandUpdate CommandType = "update"
 	CommandRemove CommandType = "remove"
+	CommandBatch  CommandType = "batch"
+	CommandMGet   CommandType = "mget"
 	CommandPing   CommandType = "ping"
+	CommandStats  CommandType = "stats"
+	CommandImport CommandType = "import"
 )
 
 // Request представляет запрос к C++ процессу
@@ -36,8 +40,20 @@ type Response struct {
 
 // AdditionalParams содержит дополнительные данные для Request/Response
 type AdditionalParams struct {
-	Uuid string `json:"uuid,omitempty"`
-	Data string `json:"data,omitempty"`
+	Uuid       string           `json:"uuid,omitempty"`
+	Data       string           `json:"data,omitempty"`
+	Uuids      []string         `json:"uuids,omitempty"`      // UUID для mget и UUID операций batch
+	Operations []BatchOperation `json:"operations,omitempty"` // Операции batch
+	Values     []*string        `json:"values,omitempty"`     // Строки mget (nil - не найдена) и import
+	Protocol   string           `json:"protocol,omitempty"`   // Формат сообщений (для ping)
+	Partial    bool             `json:"partial,omitempty"`    // Import продолжится следующими запросами
+}
+
+// BatchOperation представляет операцию пакетного запроса (insert, update или remove)
+type BatchOperation struct {
+	Command CommandType `json:"command"`
+	Uuid    string      `json:"uuid,omitempty"`
+	Data    string      `json:"data,omitempty"`
 }
 
 // Длина заголовка сообщения - 4 байта
@@ -83,9 +99,18 @@ func Decode(data []byte) (*Response, error) {
 	// Читаем JSON-данные
 	jsonData := data[headerSize : headerSize+messageLength]
 
+	return decodeMessage(jsonData)
+}
+
+// Десериализация ответа в формате, определяемом по первому байту сообщения
+func decodeMessage(message []byte) (*Response, error) {
+	if len(message) > 0 && message[0] == binaryMagic {
+		return decodeBinaryResponse(message)
+	}
+
 	// Десериализуем JSON
 	var response Response
-	if err := json.Unmarshal(jsonData, &response); err != nil {
+	if err := json.Unmarshal(message, &response); err != nil {
 		return nil, fmt.Errorf("ошибка десериализации ответа: %w", err)
 	}
 
@@ -109,13 +134,8 @@ func ReadFrame(reader io.Reader) (*Response, error) {
 		return nil, fmt.Errorf("ошибка чтения данных фрейма: %w", err)
 	}
 
-	// Десериализация JSON-ответа
-	var response Response
-	if err := json.Unmarshal(messageBuf, &response); err != nil {
-		return nil, fmt.Errorf("ошибка десериализации ответа: %w", err)
-	}
-
-	return &response, nil
+	// Десериализация ответа (JSON или двоичного)
+	return decodeMessage(messageBuf)
 }
 
 // Запись одного фрейма в Writer
@@ -134,6 +154,25 @@ func WriteFrame(writer io.Writer, request *Request) error {
 	return nil
 }
 
+// Запись одного фрейма в двоичном формате (или в JSON, если запрос нельзя представить в
+// двоичном формате)
+func WriteBinaryFrame(writer io.Writer, request *Request) error {
+	data, err := EncodeBinary(request)
+	if errors.Is(err, ErrNotBinaryEncodable) {
+		data, err = Encode(request)
+	}
+	if err != nil {
+		return err
+	}
+
+	// Запись всех данных
+	if _, err := writer.Write(data); err != nil {
+		return fmt.Errorf("ошибка записи фрейма: %w", err)
+	}
+
+	return nil
+}
+
 // Создание нового запроса добавления данных
 func NewInsertRequest(requestId, data string) *Request {
 	return &Request{
@@ -179,6 +218,45 @@ func NewRemoveRequest(requestId, uuid string) *Request {
 	}
 }
 
+// Создание нового запроса пакета операций
+func NewBatchRequest(requestId string, operations []BatchOperation) *Request {
+	return &Request{
+		RequestId: requestId,
+		Command:   CommandBatch,
+		Params: AdditionalParams{
+			Operations: operations,
+		},
+	}
+}
+
+// Создание нового запроса получения нескольких строк
+func NewMGetRequest(requestId string, uuids []string) *Request {
+	return &Request{
+		RequestId: requestId,
+		Command:   CommandMGet,
+		Params: AdditionalParams{
+			Uuids: uuids,
+		},
+	}
+}
+
+// Создание нового запроса загрузки строк (partial - строки зафиксирует снапшотом один из
+// следующих запросов загрузки)
+func NewImportRequest(requestId string, values []string, partial bool) *Request {
+	pointers := make([]*string, len(values))
+	for i := range values {
+		pointers[i] = &values[i]
+	}
+	return &Request{
+		RequestId: requestId,
+		Command:   CommandImport,
+		Params: AdditionalParams{
+			Values:  pointers,
+			Partial: partial,
+		},
+	}
+}
+
 // Создание нового запроса удаления данных
 func NewPingRequest(requestId string) *Request {
 	return &Request{
@@ -186,3 +264,22 @@ func NewPingRequest(requestId string) *Request {
 		Command:   CommandPing,
 	}
 }
+
+// Создание нового запроса показателей работы хранилища
+func NewStatsRequest(requestId string) *Request {
+	return &Request{
+		RequestId: requestId,
+		Command:   CommandStats,
+	}
+}
+
+// Создание запроса ping с предложением перейти на двоичный формат сообщений
+func NewHandshakeRequest(requestId string) *Request {
+	return &Request{
+		RequestId: requestId,
+		Command:   CommandPing,
+		Params: AdditionalParams{
+			Protocol: ProtocolBinary,
+		},
+	}
+}
@@ -0,0 +1,133 @@
+package service
+
+import (
+	"container/list"
+	"crypto/sha256"
+	"encoding/hex"
+	"sync"
+)
+
+// Запись кэша строк
+type CacheEntry struct {
+	Data string // Строка хранилища
+	ETag string // Версия строки для условных запросов HTTP
+}
+
+// Элемент списка LRU
+type cacheItem struct {
+	uuid  string
+	entry CacheEntry
+}
+
+// Ограниченный по количеству записей LRU-кэш строк хранилища.
+//
+// Кэш заполняется при чтении (read-through) и сбрасывается при изменении строк. Чтобы
+// чтение, начатое до изменения, не вернуло в кэш устаревшее значение, заполнение принимает
+// поколение кэша, полученное до обращения к octet: если с тех пор строки изменялись, запись
+// не сохраняется. Нулевой указатель соответствует отключенному кэшу
+type ResponseCache struct {
+	capacity   int
+	entries    map[string]*list.Element
+	order      *list.List // От недавно использованных к давно использованным
+	generation uint64     // Увеличивается при каждом сбросе записей
+	mutex      sync.Mutex
+}
+
+// Создание кэша на указанное количество записей (nil, если кэш отключен)
+func NewResponseCache(capacity int) *ResponseCache {
+	if capacity <= 0 {
+		return nil
+	}
+	return &ResponseCache{
+		capacity: capacity,
+		entries:  make(map[string]*list.Element, capacity),
+		order:    list.New(),
+	}
+}
+
+// Версия строки, используемая в качестве ETag: не зависит от процесса, который ее вычислил,
+// поэтому остается действительной после перезапуска сервера
+func ContentETag(data string) string {
+	digest := sha256.Sum256([]byte(data))
+	return `"` + hex.EncodeToString(digest[:16]) + `"`
+}
+
+// Получение записи из кэша
+func (c *ResponseCache) Get(uuid string) (CacheEntry, bool) {
+	if c == nil {
+		return CacheEntry{}, false
+	}
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+
+	element, ok := c.entries[uuid]
+	if !ok {
+		return CacheEntry{}, false
+	}
+	c.order.MoveToFront(element)
+	return element.Value.(*cacheItem).entry, true
+}
+
+// Текущее поколение кэша (запрашивается перед чтением строки из octet)
+func (c *ResponseCache) Generation() uint64 {
+	if c == nil {
+		return 0
+	}
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+	return c.generation
+}
+
+// Сохранение прочитанной строки, если после получения поколения строки не изменялись
+func (c *ResponseCache) Add(uuid string, entry CacheEntry, generation uint64) bool {
+	if c == nil {
+		return false
+	}
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+
+	if generation != c.generation {
+		return false
+	}
+	if element, ok := c.entries[uuid]; ok {
+		element.Value.(*cacheItem).entry = entry
+		c.order.MoveToFront(element)
+		return true
+	}
+
+	c.entries[uuid] = c.order.PushFront(&cacheItem{uuid: uuid, entry: entry})
+	if c.order.Len() > c.capacity {
+		// Вытесняем давно использованную запись
+		oldest := c.order.Back()
+		c.order.Remove(oldest)
+		delete(c.entries, oldest.Value.(*cacheItem).uuid)
+	}
+	return true
+}
+
+// Сброс записей измененных строк (вызывается после update/remove, в том числе неуспешных)
+func (c *ResponseCache) Invalidate(uuids ...string) {
+	if c == nil {
+		return
+	}
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+
+	c.generation++
+	for _, uuid := range uuids {
+		if element, ok := c.entries[uuid]; ok {
+			c.order.Remove(element)
+			delete(c.entries, uuid)
+		}
+	}
+}
+
+// Количество записей в кэше
+func (c *ResponseCache) Len() int {
+	if c == nil {
+		return 0
+	}
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+	return c.order.Len()
+}
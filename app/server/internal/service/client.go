@@ -7,6 +7,7 @@ import (
 	"net"
 	"os"
 	"sync"
+	"sync/atomic"
 	"time"
 
 	guuid "github.com/google/uuid"
@@ -22,11 +23,19 @@ type ClientConfig struct {
 	WriteTimeout time.Duration // Таймаут записи
 }
 
-// Клиент для взаимодействия с C++ процессом
+// Клиент для взаимодействия с C++ процессом.
+//
+// Клиент мультиплексирует запросы: по одному соединению одновременно передается множество
+// запросов, а ответы, которые сервер может вернуть в любом порядке, сопоставляются с
+// ожидающими их вызовами по RequestId в отдельной горутине чтения
 type Client struct {
-	config ClientConfig
-	conn   net.Conn
-	mutex  sync.Mutex
+	config     ClientConfig
+	conn       net.Conn
+	binary     bool                               // Согласован ли двоичный формат сообщений для текущего соединения
+	pending    map[string]chan *protocol.Response // Ожидающие ответа запросы текущего соединения
+	mutex      sync.Mutex                         // Защита conn, binary и pending
+	writeMutex sync.Mutex                         // Запись кадров в сокет по одному
+	dialMutex  sync.Mutex                         // Подключение выполняет одна горутина за раз
 }
 
 // Создание нового клиента
@@ -38,19 +47,22 @@ func NewClient(config ClientConfig) (*Client, error) {
 	}
 
 	return &Client{
-		config: config,
+		config:  config,
+		pending: make(map[string]chan *protocol.Response),
 	}, nil
 }
 
-// Установка соединения с процессом octet
+// Установка соединения с процессом octet.
+//
+// Клиент используется несколькими горутинами, и разрыв соединения они могут обнаружить
+// одновременно. Подключается только одна из них, а остальные, дождавшись её, используют
+// установленное соединение, не закрывая его вместе с ожидающими ответа запросами
 func (c *Client) Connect() error {
-	c.mutex.Lock()
-	defer c.mutex.Unlock()
+	c.dialMutex.Lock()
+	defer c.dialMutex.Unlock()
 
-	// Если соединение уже установлено, закрываем его
-	if c.conn != nil {
-		c.conn.Close()
-		c.conn = nil
+	if c.IsConnected() {
+		return nil
 	}
 
 	// Устанавливаем новое соединение с таймаутом
@@ -60,19 +72,99 @@ func (c *Client) Connect() error {
 		return fmt.Errorf("не удалось подключиться к сокету: %w", err)
 	}
 
+	// Согласуем формат сообщений (до запуска горутины чтения, поэтому ответ читается здесь же)
+	binary, err := negotiateProtocol(conn, c.config.ConnTimeout)
+	if err != nil {
+		conn.Close()
+		return fmt.Errorf("не удалось согласовать формат сообщений: %w", err)
+	}
+
+	c.mutex.Lock()
 	c.conn = conn
+	c.binary = binary
+	c.mutex.Unlock()
+	go c.readLoop(conn)
 	return nil
 }
 
+// Согласование формата сообщений: запрос ping в JSON предлагает перейти на двоичный формат.
+// Сервер без поддержки двоичного формата не подтверждает его, и клиент остаётся на JSON
+func negotiateProtocol(conn net.Conn, timeout time.Duration) (bool, error) {
+	if timeout > 0 {
+		if err := conn.SetDeadline(time.Now().Add(timeout)); err != nil {
+			return false, fmt.Errorf("не удалось установить таймаут: %w", err)
+		}
+		defer conn.SetDeadline(time.Time{})
+	}
+
+	req := protocol.NewHandshakeRequest(guuid.New().String())
+	if err := protocol.WriteFrame(conn, req); err != nil {
+		return false, err
+	}
+	resp, err := protocol.ReadFrame(conn)
+	if err != nil {
+		return false, err
+	}
+	if resp.RequestId != req.RequestId {
+		return false, fmt.Errorf("несоответствие ID запроса и ответа: %s != %s", req.RequestId, resp.RequestId)
+	}
+	return resp.Success && resp.Params.Protocol == protocol.ProtocolBinary, nil
+}
+
+// Чтение ответов соединения и передача их ожидающим запросам
+func (c *Client) readLoop(conn net.Conn) {
+	for {
+		resp, err := protocol.ReadFrame(conn)
+		if err != nil {
+			// Соединение закрыто или поток кадров нарушен: все ожидающие запросы завершаются ошибкой
+			c.dropConnection(conn)
+			return
+		}
+
+		c.mutex.Lock()
+		ch, ok := c.pending[resp.RequestId]
+		if ok {
+			delete(c.pending, resp.RequestId)
+		}
+		c.mutex.Unlock()
+
+		// Ответ на запрос, который уже не ожидается (например, по истечении таймаута), отбрасывается
+		if ok {
+			ch <- resp
+		}
+	}
+}
+
+// Закрытие соединения, если оно все еще является текущим
+func (c *Client) dropConnection(conn net.Conn) {
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+
+	if c.conn == conn {
+		c.closeLocked()
+	} else {
+		conn.Close()
+	}
+}
+
+// Закрытие текущего соединения и завершение ожидающих запросов (вызывается под c.mutex)
+func (c *Client) closeLocked() error {
+	err := c.conn.Close()
+	c.conn = nil
+	for requestId, ch := range c.pending {
+		close(ch)
+		delete(c.pending, requestId)
+	}
+	return err
+}
+
 // Закрытие соединения
 func (c *Client) Close() error {
 	c.mutex.Lock()
 	defer c.mutex.Unlock()
 
 	if c.conn != nil {
-		err := c.conn.Close()
-		c.conn = nil
-		return err
+		return c.closeLocked()
 	}
 	return nil
 }
@@ -86,44 +178,64 @@ func (c *Client) IsConnected() bool {
 
 // Отправка запроса и получение ответа
 func (c *Client) SendAndGet(req *protocol.Request) (*protocol.Response, error) {
-	// Проверяем соединение
-	if !c.IsConnected() {
-		return nil, fmt.Errorf("соединение не установлено")
-	}
+	return c.Send(context.Background(), req)
+}
 
+// Отправка запроса и ожидание ответа с учетом контекста. Безопасна для одновременного
+// вызова из нескольких горутин: запросы не ждут ответов на чужие запросы
+func (c *Client) Send(ctx context.Context, req *protocol.Request) (*protocol.Response, error) {
+	// Регистрируем запрос до отправки, чтобы горутина чтения не пропустила быстрый ответ
 	c.mutex.Lock()
-	defer c.mutex.Unlock()
-
-	// Устанавливаем таймаут записи
-	if err := c.conn.SetWriteDeadline(time.Now().Add(c.config.WriteTimeout)); err != nil {
-		return nil, fmt.Errorf("не удалось установить таймаут записи: %w", err)
+	conn, binary := c.conn, c.binary
+	if conn == nil {
+		c.mutex.Unlock()
+		return nil, fmt.Errorf("соединение не установлено")
 	}
-
-	// Отправляем запрос
-	if err := protocol.WriteFrame(c.conn, req); err != nil {
-		// Закрываем соединение при ошибке
-		c.conn.Close()
-		c.conn = nil
-		return nil, fmt.Errorf("ошибка отправки запроса: %w", err)
+	if _, exists := c.pending[req.RequestId]; exists {
+		c.mutex.Unlock()
+		return nil, fmt.Errorf("запрос с ID %s уже ожидает ответа", req.RequestId)
 	}
-
-	// Устанавливаем таймаут чтения
-	if err := c.conn.SetReadDeadline(time.Now().Add(c.config.ReadTimeout)); err != nil {
-		return nil, fmt.Errorf("не удалось установить таймаут чтения: %w", err)
+	ch := make(chan *protocol.Response, 1)
+	c.pending[req.RequestId] = ch
+	c.mutex.Unlock()
+	defer c.forget(req.RequestId, ch)
+
+	// Отправляем запрос в согласованном формате
+	write := protocol.WriteFrame
+	if binary {
+		write = protocol.WriteBinaryFrame
 	}
-
-	// Читаем ответ
-	resp, err := protocol.ReadFrame(c.conn)
+	c.writeMutex.Lock()
+	err := conn.SetWriteDeadline(time.Now().Add(c.config.WriteTimeout))
+	if err == nil {
+		err = write(conn, req)
+	}
+	c.writeMutex.Unlock()
 	if err != nil {
-		// Закрываем соединение при ошибке
-		c.conn.Close()
-		c.conn = nil
-		return nil, fmt.Errorf("ошибка чтения ответа: %w", err)
+		// Кадр мог быть записан частично, поэтому соединение дальше использовать нельзя
+		c.dropConnection(conn)
+		return nil, fmt.Errorf("ошибка отправки запроса: %w", err)
 	}
 
-	// Проверяем, что ID запроса совпадает с ID ответа
-	if resp.RequestId != req.RequestId {
-		return nil, fmt.Errorf("несоответствие ID запроса и ответа: %s != %s", req.RequestId, resp.RequestId)
+	// Ждем ответ. Таймаут завершает только этот запрос, соединение остается открытым
+	var timeout <-chan time.Time
+	if c.config.ReadTimeout > 0 {
+		timer := time.NewTimer(c.config.ReadTimeout)
+		defer timer.Stop()
+		timeout = timer.C
+	}
+
+	var resp *protocol.Response
+	select {
+	case r, ok := <-ch:
+		if !ok {
+			return nil, fmt.Errorf("ошибка чтения ответа: соединение закрыто")
+		}
+		resp = r
+	case <-timeout:
+		return nil, fmt.Errorf("ошибка чтения ответа: превышено время ожидания (%v)", c.config.ReadTimeout)
+	case <-ctx.Done():
+		return nil, ctx.Err()
 	}
 
 	// Если операция не успешна, возвращаем ошибку
@@ -134,11 +246,20 @@ func (c *Client) SendAndGet(req *protocol.Request) (*protocol.Response, error) {
 	return resp, nil
 }
 
+// Снятие запроса с ожидания (если ответ не был получен)
+func (c *Client) forget(requestId string, ch chan *protocol.Response) {
+	c.mutex.Lock()
+	defer c.mutex.Unlock()
+	if c.pending[requestId] == ch {
+		delete(c.pending, requestId)
+	}
+}
+
 // Выполнение octet::insert
 func (c *Client) Insert(ctx context.Context, data string) (string, error) {
 	requestId := guuid.New().String()
 	req := protocol.NewInsertRequest(requestId, data)
-	resp, err := c.SendAndGet(req)
+	resp, err := c.Send(ctx, req)
 	if err != nil {
 		return "", err
 	}
@@ -152,7 +273,7 @@ func (c *Client) Insert(ctx context.Context, data string) (string, error) {
 func (c *Client) Get(ctx context.Context, uuid string) (string, error) {
 	requestId := guuid.New().String()
 	req := protocol.NewGetRequest(requestId, uuid)
-	resp, err := c.SendAndGet(req)
+	resp, err := c.Send(ctx, req)
 	if err != nil {
 		return "", err
 	}
@@ -163,7 +284,7 @@ func (c *Client) Get(ctx context.Context, uuid string) (string, error) {
 func (c *Client) Update(ctx context.Context, uuid, data string) error {
 	requestID := guuid.New().String()
 	req := protocol.NewUpdateRequest(requestID, uuid, data)
-	_, err := c.SendAndGet(req)
+	_, err := c.Send(ctx, req)
 	return err
 }
 
@@ -171,32 +292,95 @@ func (c *Client) Update(ctx context.Context, uuid, data string) error {
 func (c *Client) Remove(ctx context.Context, uuid string) error {
 	requestID := guuid.New().String()
 	req := protocol.NewRemoveRequest(requestID, uuid)
-	_, err := c.SendAndGet(req)
+	_, err := c.Send(ctx, req)
 	return err
 }
 
+// Выполнение octet::applyBatch
+func (c *Client) Batch(ctx context.Context, operations []protocol.BatchOperation) ([]string, error) {
+	requestID := guuid.New().String()
+	req := protocol.NewBatchRequest(requestID, operations)
+	resp, err := c.Send(ctx, req)
+	if err != nil {
+		return nil, err
+	}
+	if len(resp.Params.Uuids) != len(operations) {
+		return nil, fmt.Errorf("количество UUID в ответе не совпадает с количеством операций: %d != %d",
+			len(resp.Params.Uuids), len(operations))
+	}
+	return resp.Params.Uuids, nil
+}
+
+// Выполнение octet::getMany
+func (c *Client) MGet(ctx context.Context, uuids []string) ([]*string, error) {
+	requestID := guuid.New().String()
+	req := protocol.NewMGetRequest(requestID, uuids)
+	resp, err := c.Send(ctx, req)
+	if err != nil {
+		return nil, err
+	}
+	if len(resp.Params.Values) != len(uuids) {
+		return nil, fmt.Errorf("количество строк в ответе не совпадает с количеством UUID: %d != %d",
+			len(resp.Params.Values), len(uuids))
+	}
+	return resp.Params.Values, nil
+}
+
+// Выполнение octet::importValues
+func (c *Client) Import(ctx context.Context, values []string, partial bool) ([]string, error) {
+	requestID := guuid.New().String()
+	req := protocol.NewImportRequest(requestID, values, partial)
+	resp, err := c.Send(ctx, req)
+	if err != nil {
+		return nil, err
+	}
+	if len(resp.Params.Uuids) != len(values) {
+		return nil, fmt.Errorf("количество UUID в ответе не совпадает с количеством строк: %d != %d",
+			len(resp.Params.Uuids), len(values))
+	}
+	return resp.Params.Uuids, nil
+}
+
 // Выполнение octet::ping
 func (c *Client) Ping(ctx context.Context) error {
 	requestID := guuid.New().String()
 	req := protocol.NewPingRequest(requestID)
-	_, err := c.SendAndGet(req)
+	_, err := c.Send(ctx, req)
 	return err
 }
 
+// Получение показателей octet в текстовом формате Prometheus
+func (c *Client) Stats(ctx context.Context) (string, error) {
+	requestID := guuid.New().String()
+	req := protocol.NewStatsRequest(requestID)
+	resp, err := c.Send(ctx, req)
+	if err != nil {
+		return "", err
+	}
+	return resp.Data, nil
+}
+
 // Конфигурация для пула клиентов
 type ClientPoolConfig struct {
 	SocketPath    string        // Путь к сокету
-	MaxClients    int           // Максимальное количество клиентов в пуле
+	MaxClients    int           // Количество соединений (мультиплексируемых клиентов) в пуле
+	MaxInFlight   int           // Максимальное количество одновременных запросов на одно соединение
 	ConnTimeout   time.Duration // Таймаут соединения
 	ReadTimeout   time.Duration // Таймаут чтения
 	WriteTimeout  time.Duration // Таймаут записи
-	ClientTimeout time.Duration // Время ожидания клиента
+	ClientTimeout time.Duration // Время ожидания свободного места для запроса
 }
 
-// Пул клиентов, взаимодействующих с процессом octet
+// Пул клиентов, взаимодействующих с процессом octet.
+//
+// Клиенты пула не захватываются монопольно: каждый клиент мультиплексирует запросы, поэтому
+// GetClient лишь выбирает следующее соединение по кругу. Ожидание возникает только тогда,
+// когда одновременно выполняется MaxClients * MaxInFlight запросов
 type ClientPool struct {
 	config         ClientPoolConfig
-	clients        chan *Client
+	clients        []*Client
+	next           atomic.Uint32 // Номер следующего клиента для выбора по кругу
+	slots          chan struct{} // Семафор одновременно выполняемых запросов
 	processManager *ProcessManager
 }
 
@@ -218,6 +402,9 @@ func NewClientPool(config ClientPoolConfig, logger *zap.Logger, pm *ProcessManag
 	if config.MaxClients <= 0 {
 		config.MaxClients = 10
 	}
+	if config.MaxInFlight <= 0 {
+		config.MaxInFlight = 128
+	}
 	if config.ConnTimeout == 0 {
 		config.ConnTimeout = 5 * time.Second
 	}
@@ -231,7 +418,8 @@ func NewClientPool(config ClientPoolConfig, logger *zap.Logger, pm *ProcessManag
 	// Создаем пул
 	pool := &ClientPool{
 		config:         config,
-		clients:        make(chan *Client, config.MaxClients),
+		clients:        make([]*Client, 0, config.MaxClients),
+		slots:          make(chan struct{}, config.MaxClients*config.MaxInFlight),
 		processManager: pm,
 	}
 
@@ -254,7 +442,7 @@ func NewClientPool(config ClientPoolConfig, logger *zap.Logger, pm *ProcessManag
 		}
 
 		// Добавляем клиент в пул
-		pool.clients <- client
+		pool.clients = append(pool.clients, client)
 	}
 
 	return pool, nil
@@ -275,28 +463,40 @@ func (p *ClientPool) GetClient() (*PooledClient, error) {
 	// Определяем стратегию ожидания на основе настроенного таймаута
 	switch {
 	case p.config.ClientTimeout < 0:
-		// Ждем бесконечно, пока не освободится клиент
-		client := <-p.clients
-		return p.prepareClient(client)
+		// Ждем бесконечно, пока не освободится место для запроса
+		p.slots <- struct{}{}
 
 	case p.config.ClientTimeout == 0:
-		// Не ждем, сразу возвращаем ошибку если клиентов нет
+		// Не ждем, сразу возвращаем ошибку если все соединения заполнены
 		select {
-		case client := <-p.clients:
-			return p.prepareClient(client)
+		case p.slots <- struct{}{}:
 		default:
 			return nil, fmt.Errorf("все клиенты заняты")
 		}
 
 	default:
 		// Ждем указанное время
+		timer := time.NewTimer(p.config.ClientTimeout)
+		defer timer.Stop()
 		select {
-		case client := <-p.clients:
-			return p.prepareClient(client)
-		case <-time.After(p.config.ClientTimeout):
+		case p.slots <- struct{}{}:
+		case <-timer.C:
 			return nil, fmt.Errorf("превышено время ожидания свободного клиента (%v)", p.config.ClientTimeout)
 		}
 	}
+
+	return p.prepareClient(p.nextClient())
+}
+
+// Выбор следующего клиента по кругу (предпочтительно с установленным соединением)
+func (p *ClientPool) nextClient() *Client {
+	start := int(p.next.Add(1) % uint32(len(p.clients)))
+	for i := 0; i < len(p.clients); i++ {
+		if client := p.clients[(start+i)%len(p.clients)]; client.IsConnected() {
+			return client
+		}
+	}
+	return p.clients[start]
 }
 
 // Подготовка клиента к использованию
@@ -305,13 +505,13 @@ func (p *ClientPool) prepareClient(client *Client) (*PooledClient, error) {
 	if !client.IsConnected() {
 		// Пытаемся подключиться
 		if err := client.Connect(); err != nil {
-			// Возвращаем клиент в пул и возвращаем ошибку
-			p.clients <- client
+			// Освобождаем место для запроса и возвращаем ошибку
+			<-p.slots
 			return nil, fmt.Errorf("не удалось подключить клиент: %w", err)
 		}
 	}
 
-	// Возвращаем клиент, обернутый в PooledClient для автоматического возврата в пул
+	// Возвращаем клиент, обернутый в PooledClient для автоматического освобождения места
 	return &PooledClient{
 		Client: client,
 		pool:   p,
@@ -321,36 +521,25 @@ func (p *ClientPool) prepareClient(client *Client) (*PooledClient, error) {
 
 // Закрытие всех соединений и освобождение ресурсов
 func (p *ClientPool) Close() {
-	// Закрываем все клиенты
-	clientsCount := len(p.clients)
-	for i := 0; i < clientsCount; i++ {
-		select {
-		case client := <-p.clients:
-			client.Close()
-		default:
-			// Если канал пуст, выходим
-			return
-		}
+	for _, client := range p.clients {
+		client.Close()
 	}
-
-	// Закрываем канал
-	close(p.clients)
 }
 
-// Обертка для клиента для автоматического возрата в пул
+// Обертка для клиента для автоматического освобождения места для запроса в пуле
 type PooledClient struct {
 	*Client
 	pool *ClientPool
 	used bool
 }
 
-// Возврат клиента в пул
+// Освобождение места для запроса в пуле (соединение остается доступным другим запросам)
 func (pc *PooledClient) Release() {
 	if pc.used {
 		return
 	}
 	pc.used = true
-	pc.pool.clients <- pc.Client
+	<-pc.pool.slots
 }
 
 // Выполнение octet::insert и возврат клиента в пул
@@ -377,8 +566,32 @@ func (pc *PooledClient) Remove(ctx context.Context, uuid string) error {
 	return pc.Client.Remove(ctx, uuid)
 }
 
+// Выполнение octet::applyBatch и возврат клиента в пул
+func (pc *PooledClient) Batch(ctx context.Context, operations []protocol.BatchOperation) ([]string, error) {
+	defer pc.Release()
+	return pc.Client.Batch(ctx, operations)
+}
+
+// Выполнение octet::getMany и возврат клиента в пул
+func (pc *PooledClient) MGet(ctx context.Context, uuids []string) ([]*string, error) {
+	defer pc.Release()
+	return pc.Client.MGet(ctx, uuids)
+}
+
+// Выполнение octet::importValues и возврат клиента в пул
+func (pc *PooledClient) Import(ctx context.Context, values []string, partial bool) ([]string, error) {
+	defer pc.Release()
+	return pc.Client.Import(ctx, values, partial)
+}
+
 // Выполнение octet::ping и возврат клиента в пул
 func (pc *PooledClient) Ping(ctx context.Context) error {
 	defer pc.Release()
 	return pc.Client.Ping(ctx)
 }
+
+// Получение показателей octet и возврат клиента в пул
+func (pc *PooledClient) Stats(ctx context.Context) (string, error) {
+	defer pc.Release()
+	return pc.Client.Stats(ctx)
+}
@@ -0,0 +1,77 @@
+#include <benchmark/benchmark.h>
+#include <filesystem>
+#include <string>
+
+#include "storage/journal_manager.hpp"
+#include "storage/uuid_generator.hpp"
+#include "utils/file_utils.hpp"
+#include "bench_utils.hpp"
+
+namespace octet::benchmarks {
+namespace {
+/**
+ * @brief Сериализация записи журнала (аргумент - размер данных)
+ */
+void BM_JournalEntrySerialize(benchmark::State &state)
+{
+    const JournalEntry entry(OperationType::UPDATE, UuidGenerator().generateUuid(),
+                             makeValue(state.range(0)));
+    for (auto _ : state) {
+        auto record = entry.serialize();
+        benchmark::DoNotOptimize(record);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JournalEntrySerialize)->Arg(16)->Arg(256)->Arg(4096)->Arg(64 * 1024);
+
+/**
+ * @brief Десериализация записи журнала с копированием данных (аргумент - размер данных)
+ */
+void BM_JournalEntryDeserialize(benchmark::State &state)
+{
+    const auto record = JournalEntry(OperationType::UPDATE, UuidGenerator().generateUuid(),
+                                     makeValue(state.range(0)))
+                            .serialize();
+    for (auto _ : state) {
+        auto entry = JournalEntry::deserialize(record);
+        benchmark::DoNotOptimize(entry);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JournalEntryDeserialize)->Arg(16)->Arg(256)->Arg(4096)->Arg(64 * 1024);
+
+/**
+ * @brief Разбор записи журнала без копирования данных (аргумент - размер данных)
+ */
+void BM_JournalEntryDeserializeView(benchmark::State &state)
+{
+    const auto record = JournalEntry(OperationType::UPDATE, UuidGenerator().generateUuid(),
+                                     makeValue(state.range(0)))
+                            .serialize();
+    for (auto _ : state) {
+        auto view = JournalEntry::deserializeView(record);
+        benchmark::DoNotOptimize(view);
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_JournalEntryDeserializeView)->Arg(16)->Arg(256)->Arg(4096)->Arg(64 * 1024);
+
+/**
+ * @brief Добавление данных в файл через utils::safeFileAppend (аргумент - размер данных)
+ */
+void BM_SafeFileAppend(benchmark::State &state)
+{
+    const TmpDirectory dir("SafeFileAppend");
+    const auto path = dir.path() / "append.bin";
+    const auto data = makeValue(state.range(0));
+    for (auto _ : state) {
+        if (!utils::safeFileAppend(path, data)) {
+            state.SkipWithError("safeFileAppend failed");
+            break;
+        }
+    }
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SafeFileAppend)->Arg(64)->Arg(4096)->Arg(64 * 1024);
+} // namespace
+} // namespace octet::benchmarks
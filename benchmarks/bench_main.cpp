@@ -0,0 +1,17 @@
+#include <benchmark/benchmark.h>
+
+#include "logger.hpp"
+
+int main(int argc, char **argv)
+{
+    // Вывод логгера искажает измерения, поэтому он отключается
+    octet::Logger::getInstance().disable();
+
+    benchmark::Initialize(&argc, argv);
+    if (benchmark::ReportUnrecognizedArguments(argc, argv)) {
+        return 1;
+    }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
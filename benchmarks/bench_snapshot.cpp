@@ -0,0 +1,106 @@
+#include <benchmark/benchmark.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/snapshot_format.hpp"
+#include "storage/uuid_generator.hpp"
+#include "bench_utils.hpp"
+
+namespace octet::benchmarks {
+namespace {
+// Размер значения записи снапшота
+constexpr int64_t SNAPSHOT_VALUE_SIZE = 128;
+
+/**
+ * @brief Формирует записи снапшота
+ * @param count Количество записей
+ * @return Пары из ключа и значения
+ */
+std::vector<std::pair<Uuid, std::string>> makeEntries(int64_t count)
+{
+    UuidGenerator generator;
+    std::vector<std::pair<Uuid, std::string>> entries;
+    entries.reserve(static_cast<size_t>(count));
+    for (int64_t i = 0; i < count; i++) {
+        entries.emplace_back(generator.generate(), makeValue(SNAPSHOT_VALUE_SIZE));
+    }
+    return entries;
+}
+
+/**
+ * @brief Сериализует записи в память в формате снапшота v2
+ * @param entries Записи
+ * @param codec Алгоритм сжатия блоков
+ * @return Содержимое файла снапшота
+ */
+std::string serializeEntries(const std::vector<std::pair<Uuid, std::string>> &entries,
+                             CompressionCodec codec)
+{
+    std::string content;
+    writeSnapshotEntries(
+        "checkpoint", nullptr, codec, false,
+        [&](auto &&emit) {
+            for (const auto &[key, value] : entries) {
+                emit(key, value, false);
+            }
+        },
+        [&](const char *data, size_t size) {
+            content.append(data, size);
+            return true;
+        });
+    return content;
+}
+
+/**
+ * @brief Сериализация записей в формат снапшота (аргумент - количество записей)
+ */
+void BM_SnapshotSerialize(benchmark::State &state)
+{
+    const auto entries = makeEntries(state.range(0));
+    for (auto _ : state) {
+        auto content = serializeEntries(entries, CompressionCodec::NONE);
+        benchmark::DoNotOptimize(content);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_SnapshotSerialize)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+
+/**
+ * @brief Разбор снапшота: проверка структуры, контрольных сумм и записей всех блоков
+ * (аргумент - количество записей)
+ */
+void BM_SnapshotDeserialize(benchmark::State &state)
+{
+    const auto content = serializeEntries(makeEntries(state.range(0)), CompressionCodec::NONE);
+    std::string decompressed;
+    for (auto _ : state) {
+        SnapshotLayout layout;
+        CompressionCodec codec;
+        if (!parseSnapshotLayout(content, layout)
+            || !checkSnapshotLayout(layout, std::nullopt, codec)) {
+            state.SkipWithError("snapshot layout is corrupted");
+            break;
+        }
+        size_t entries = 0;
+        for (const auto &block : layout.blocks) {
+            std::string_view data;
+            if (!readSnapshotBlock(content, block, codec, decompressed, data)
+                || !decodeSnapshotBlock(data, block.entryCount, layout.flags,
+                                        [&](const Uuid &, std::string_view value, bool,
+                                            const ValueLocation *) {
+                                            benchmark::DoNotOptimize(value.data());
+                                            entries++;
+                                        })) {
+                state.SkipWithError("snapshot block is corrupted");
+                break;
+            }
+        }
+        benchmark::DoNotOptimize(entries);
+    }
+    state.SetItemsProcessed(state.iterations() * state.range(0));
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(content.size()));
+}
+BENCHMARK(BM_SnapshotDeserialize)->Arg(1000)->Arg(100000)->Unit(benchmark::kMicrosecond);
+} // namespace
+} // namespace octet::benchmarks
@@ -0,0 +1,131 @@
+#include <benchmark/benchmark.h>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "storage/storage_manager.hpp"
+#include "bench_utils.hpp"
+
+namespace octet::benchmarks {
+namespace {
+// Количество записей, с которыми работают бенчмарки смешанной нагрузки
+constexpr size_t STORAGE_ENTRIES = 100000;
+// Размер значения записи
+constexpr int64_t STORAGE_VALUE_SIZE = 128;
+
+/**
+ * @struct SharedStorage
+ * @brief Хранилище с заранее добавленными записями, общее для всех потоков и запусков
+ */
+struct SharedStorage {
+    TmpDirectory dir{ "Storage" };
+    std::unique_ptr<StorageManager> manager;
+    std::vector<std::string> uuids;
+
+    explicit SharedStorage(DurabilityMode mode)
+    {
+        manager = std::make_unique<StorageManager>(dir.path(), DurabilityPolicy{ mode });
+        // Снапшоты во время измерений не создаются
+        manager->setSnapshotOperationsThreshold(1000000000);
+        manager->setSnapshotTimeThreshold(1000000);
+
+        const auto value = makeValue(STORAGE_VALUE_SIZE);
+        std::vector<BatchOperation> batch(STORAGE_ENTRIES);
+        for (auto &operation : batch) {
+            operation.type = OperationType::INSERT;
+            operation.data = value;
+        }
+        uuids = manager->applyBatch(batch).value_or(std::vector<std::string>{});
+    }
+
+    ~SharedStorage()
+    {
+        // Хранилище закрывается до удаления директории
+        manager.reset();
+    }
+};
+
+/**
+ * @brief Возвращает общее хранилище для режима фиксации (создаётся при первом обращении)
+ * @param mode Режим фиксации
+ * @return Хранилище
+ */
+SharedStorage &sharedStorage(DurabilityMode mode)
+{
+    switch (mode) {
+        case DurabilityMode::GROUP_COMMIT: {
+            static SharedStorage storage(DurabilityMode::GROUP_COMMIT);
+            return storage;
+        }
+        default: {
+            static SharedStorage storage(DurabilityMode::NONE);
+            return storage;
+        }
+    }
+}
+
+/**
+ * @brief Смешанная нагрузка get/update по случайным ключам.
+ *
+ * Аргументы: доля чтений в процентах и режим фиксации (0 - NONE, 1 - GROUP_COMMIT). Количество
+ * потоков задаётся через Threads, все потоки работают с одним хранилищем.
+ */
+void BM_StorageMixed(benchmark::State &state)
+{
+    const auto readPercent = state.range(0);
+    auto &storage = sharedStorage(state.range(1) == 0 ? DurabilityMode::NONE
+                                                      : DurabilityMode::GROUP_COMMIT);
+    if (storage.uuids.size() != STORAGE_ENTRIES) {
+        state.SkipWithError("failed to populate storage");
+        return;
+    }
+
+    std::mt19937_64 random(state.thread_index() + 1);
+    std::uniform_int_distribution<size_t> keyDistribution(0, storage.uuids.size() - 1);
+    std::uniform_int_distribution<int64_t> percentDistribution(0, 99);
+    const auto value = makeValue(STORAGE_VALUE_SIZE);
+    for (auto _ : state) {
+        const auto &uuid = storage.uuids[keyDistribution(random)];
+        if (percentDistribution(random) < readPercent) {
+            auto result = storage.manager->get(uuid);
+            benchmark::DoNotOptimize(result);
+        }
+        else if (!storage.manager->update(uuid, value)) {
+            state.SkipWithError("update failed");
+            break;
+        }
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_StorageMixed)
+    ->ArgNames({ "read%", "group" })
+    ->ArgsProduct({ { 50, 90, 99 }, { 0 } })
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+BENCHMARK(BM_StorageMixed)
+    ->ArgNames({ "read%", "group" })
+    ->ArgsProduct({ { 50, 90 }, { 1 } })
+    ->ThreadRange(1, 8)
+    ->UseRealTime();
+
+/**
+ * @brief Добавление записей (аргумент - размер значения), журнал без fdatasync
+ */
+void BM_StorageInsert(benchmark::State &state)
+{
+    const TmpDirectory dir("StorageInsert");
+    StorageManager manager(dir.path(), DurabilityPolicy{ DurabilityMode::NONE });
+    manager.setSnapshotOperationsThreshold(1000000000);
+    manager.setSnapshotTimeThreshold(1000000);
+    const auto value = makeValue(state.range(0));
+    for (auto _ : state) {
+        auto uuid = manager.insert(value);
+        benchmark::DoNotOptimize(uuid);
+    }
+    state.SetItemsProcessed(state.iterations());
+    state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_StorageInsert)->Arg(128)->Arg(4096);
+} // namespace
+} // namespace octet::benchmarks
@@ -0,0 +1,32 @@
+#include <atomic>
+#include <chrono>
+#include <system_error>
+
+#include "bench_utils.hpp"
+
+namespace octet::benchmarks {
+std::string makeValue(int64_t size)
+{
+    std::string value(static_cast<size_t>(size), '\0');
+    for (size_t i = 0; i < value.size(); i++) {
+        value[i] = static_cast<char>('a' + i % 26);
+    }
+    return value;
+}
+
+TmpDirectory::TmpDirectory(std::string_view name)
+{
+    static std::atomic<uint64_t> counter{ 0 };
+    const auto stamp = std::chrono::steady_clock::now().time_since_epoch().count();
+    path_ = std::filesystem::temp_directory_path()
+            / ("octet_bench_" + std::string(name) + "_" + std::to_string(stamp) + "_"
+               + std::to_string(counter.fetch_add(1)));
+    std::filesystem::create_directories(path_);
+}
+
+TmpDirectory::~TmpDirectory()
+{
+    std::error_code ec;
+    std::filesystem::remove_all(path_, ec);
+}
+} // namespace octet::benchmarks
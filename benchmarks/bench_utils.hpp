@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+
+namespace octet::benchmarks {
+/**
+ * @brief Формирует строку указанного размера из печатных символов
+ * @param size Размер строки
+ * @return Сформированная строка
+ */
+std::string makeValue(int64_t size);
+
+/**
+ * @class TmpDirectory
+ * @brief Временная директория, удаляемая вместе с объектом
+ */
+class TmpDirectory {
+public:
+    /**
+     * @brief Создаёт уникальную временную директорию
+     * @param name Название бенчмарка (входит в имя директории)
+     */
+    explicit TmpDirectory(std::string_view name);
+
+    ~TmpDirectory();
+
+    TmpDirectory(const TmpDirectory &) = delete;
+    TmpDirectory &operator=(const TmpDirectory &) = delete;
+
+    const std::filesystem::path &path() const
+    {
+        return path_;
+    }
+
+private:
+    std::filesystem::path path_; // Путь к директории
+};
+} // namespace octet::benchmarks
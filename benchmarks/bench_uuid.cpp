@@ -0,0 +1,35 @@
+#include <benchmark/benchmark.h>
+
+#include "storage/uuid_generator.hpp"
+
+namespace octet::benchmarks {
+namespace {
+/**
+ * @brief Генерация UUID в строковом представлении
+ */
+void BM_UuidGenerateString(benchmark::State &state)
+{
+    UuidGenerator generator;
+    for (auto _ : state) {
+        auto uuid = generator.generateUuid();
+        benchmark::DoNotOptimize(uuid);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UuidGenerateString)->ThreadRange(1, 8);
+
+/**
+ * @brief Генерация UUID в двоичном представлении
+ */
+void BM_UuidGenerateBinary(benchmark::State &state)
+{
+    UuidGenerator generator;
+    for (auto _ : state) {
+        auto uuid = generator.generate();
+        benchmark::DoNotOptimize(uuid);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_UuidGenerateBinary)->ThreadRange(1, 8);
+} // namespace
+} // namespace octet::benchmarks
@@ -0,0 +1,413 @@
+/**
+ * Генератор нагрузки для серверного режима octet.
+ *
+ * Каждое соединение работает в замкнутом цикле: отправляет запрос по протоколу Unix-сокета (кадр
+ * с длиной little-endian и JSON-сообщением), дожидается ответа и только после этого отправляет
+ * следующий. Поэтому задержки не маскируются очередью запросов клиента, а пропускная способность
+ * определяется сервером. По завершении выводятся перцентили задержек p50/p99/p99.9.
+ */
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "3rdparty/json.hpp"
+#include "metrics.hpp"
+
+namespace {
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// Размер заголовка кадра с длиной сообщения
+constexpr size_t FRAME_HEADER_SIZE = 4;
+
+/**
+ * @struct LoadConfig
+ * @brief Параметры нагрузки
+ */
+struct LoadConfig {
+    std::string socketPath = "/tmp/octet.sock"; // Путь к Unix-сокету сервера
+    size_t connections = 8; // Количество соединений (одновременных запросов)
+    size_t durationSeconds = 10; // Длительность измерения
+    size_t warmupSeconds = 1; // Длительность прогрева (не учитывается в результатах)
+    int readPercent = 90; // Доля запросов GET (остальные - UPDATE)
+    size_t keys = 10000; // Количество записей, добавляемых перед измерением
+    size_t valueSize = 128; // Размер значения записи
+};
+
+/**
+ * @struct WorkerResult
+ * @brief Результаты одного соединения
+ */
+struct WorkerResult {
+    octet::HistogramSnapshot latencies; // Задержки запросов в наносекундах
+    uint64_t errors = 0; // Запросы, завершившиеся ошибкой
+};
+
+/**
+ * @class Connection
+ * @brief Синхронное соединение с сервером octet
+ */
+class Connection {
+public:
+    explicit Connection(const std::string &socketPath)
+    {
+        sockaddr_un address{};
+        if (socketPath.size() >= sizeof(address.sun_path)) {
+            return;
+        }
+        address.sun_family = AF_UNIX;
+        std::memcpy(address.sun_path, socketPath.data(), socketPath.size());
+
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd_ >= 0
+            && ::connect(fd_, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) != 0) {
+            ::close(fd_);
+            fd_ = -1;
+        }
+    }
+
+    ~Connection()
+    {
+        if (fd_ >= 0) {
+            ::close(fd_);
+        }
+    }
+
+    Connection(const Connection &) = delete;
+    Connection &operator=(const Connection &) = delete;
+
+    bool isOpen() const
+    {
+        return fd_ >= 0;
+    }
+
+    /**
+     * @brief Отправляет запрос и дожидается ответа
+     * @param request JSON-сообщение запроса
+     * @return Разобранный ответ или std::nullopt при ошибке соединения
+     */
+    std::optional<json> call(const std::string &request)
+    {
+        std::array<uint8_t, FRAME_HEADER_SIZE> header;
+        const auto length = static_cast<uint32_t>(request.size());
+        for (size_t i = 0; i < FRAME_HEADER_SIZE; i++) {
+            header[i] = static_cast<uint8_t>(length >> (i * 8));
+        }
+        if (!writeAll(header.data(), header.size()) || !writeAll(request.data(), request.size())
+            || !readAll(header.data(), header.size())) {
+            return std::nullopt;
+        }
+
+        uint32_t responseLength = 0;
+        for (size_t i = 0; i < FRAME_HEADER_SIZE; i++) {
+            responseLength |= static_cast<uint32_t>(header[i]) << (i * 8);
+        }
+        response_.resize(responseLength);
+        if (!readAll(response_.data(), response_.size())) {
+            return std::nullopt;
+        }
+        auto parsed = json::parse(response_, nullptr, false);
+        if (parsed.is_discarded()) {
+            return std::nullopt;
+        }
+        return parsed;
+    }
+
+private:
+    bool writeAll(const void *data, size_t size)
+    {
+        const auto *ptr = static_cast<const char *>(data);
+        while (size != 0) {
+            const auto written = ::send(fd_, ptr, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) {
+                continue;
+            }
+            if (written <= 0) {
+                return false;
+            }
+            ptr += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+
+    bool readAll(void *data, size_t size)
+    {
+        auto *ptr = static_cast<char *>(data);
+        while (size != 0) {
+            const auto received = ::recv(fd_, ptr, size, 0);
+            if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            if (received <= 0) {
+                return false;
+            }
+            ptr += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+
+    int fd_ = -1; // Дескриптор сокета
+    std::string response_; // Буфер для сообщения ответа
+};
+
+/**
+ * @brief Формирует JSON-запрос
+ * @param requestId Идентификатор запроса
+ * @param command Команда
+ * @param params Параметры команды
+ * @return JSON-сообщение
+ */
+std::string makeRequest(uint64_t requestId, const char *command, json params)
+{
+    json request;
+    request["request_id"] = std::to_string(requestId);
+    request["command"] = command;
+    request["params"] = std::move(params);
+    return request.dump();
+}
+
+/**
+ * @brief Проверяет, что ответ пришёл и сообщает об успешном выполнении
+ * @param response Ответ сервера
+ * @return true, если запрос выполнен
+ */
+bool isSuccess(const std::optional<json> &response)
+{
+    return response.has_value() && response->value("success", false);
+}
+
+/**
+ * @brief Добавляет записи, с которыми будут работать соединения
+ * @param config Параметры нагрузки
+ * @return UUID добавленных записей или std::nullopt при ошибке
+ */
+std::optional<std::vector<std::string>> populate(const LoadConfig &config)
+{
+    Connection connection(config.socketPath);
+    if (!connection.isOpen()) {
+        std::cerr << "Не удалось подключиться к " << config.socketPath << ": "
+                  << std::strerror(errno) << std::endl;
+        return std::nullopt;
+    }
+
+    const std::string value(config.valueSize, 'v');
+    std::vector<std::string> uuids;
+    uuids.reserve(config.keys);
+    for (size_t i = 0; i < config.keys; i++) {
+        const auto response = connection.call(makeRequest(i, "insert", { { "data", value } }));
+        if (!isSuccess(response) || !(*response)["params"].contains("uuid")) {
+            std::cerr << "Не удалось добавить запись перед измерением" << std::endl;
+            return std::nullopt;
+        }
+        uuids.push_back((*response)["params"]["uuid"].get<std::string>());
+    }
+    return uuids;
+}
+
+/**
+ * @brief Замкнутый цикл запросов одного соединения
+ * @param config Параметры нагрузки
+ * @param uuids UUID записей
+ * @param index Номер соединения
+ * @param measureFrom Начало измерения (запросы, начатые раньше, не учитываются)
+ * @param stop Признак завершения
+ * @param[out] result Результаты соединения
+ */
+void runWorker(const LoadConfig &config, const std::vector<std::string> &uuids, size_t index,
+               Clock::time_point measureFrom, const std::atomic<bool> &stop,
+               WorkerResult &result)
+{
+    result.latencies.buckets.assign(octet::HistogramSnapshot::BUCKET_COUNT, 0);
+    Connection connection(config.socketPath);
+    if (!connection.isOpen()) {
+        result.errors++;
+        return;
+    }
+
+    std::mt19937_64 random(index + 1);
+    std::uniform_int_distribution<size_t> keyDistribution(0, uuids.size() - 1);
+    std::uniform_int_distribution<int> percentDistribution(0, 99);
+    const std::string value(config.valueSize, 'u');
+    uint64_t requestId = 0;
+    while (!stop.load(std::memory_order_relaxed)) {
+        const auto &uuid = uuids[keyDistribution(random)];
+        const auto request
+            = percentDistribution(random) < config.readPercent
+                  ? makeRequest(requestId++, "get", { { "uuid", uuid } })
+                  : makeRequest(requestId++, "update", { { "uuid", uuid }, { "data", value } });
+
+        const auto start = Clock::now();
+        const auto response = connection.call(request);
+        const auto finish = Clock::now();
+        if (!response.has_value()) {
+            result.errors++;
+            return;
+        }
+        if (start < measureFrom) {
+            continue;
+        }
+        if (!isSuccess(response)) {
+            result.errors++;
+            continue;
+        }
+        const auto latency
+            = std::chrono::duration_cast<std::chrono::nanoseconds>(finish - start).count();
+        auto &histogram = result.latencies;
+        histogram.buckets[octet::HistogramSnapshot::bucketIndex(latency)]++;
+        histogram.count++;
+        histogram.sum += latency;
+        histogram.max = std::max<uint64_t>(histogram.max, latency);
+    }
+}
+
+/**
+ * @brief Разбирает числовой параметр
+ * @param text Значение параметра
+ * @param[out] value Результат
+ * @return true, если значение - неотрицательное целое число
+ */
+template <typename T> bool parseNumber(const std::string &text, T &value)
+{
+    if (text.empty() || !std::all_of(text.begin(), text.end(), ::isdigit)) {
+        return false;
+    }
+    value = static_cast<T>(std::stoull(text));
+    return true;
+}
+
+void printUsage(const char *executable)
+{
+    std::cout << "Использование: " << executable << " [ОПЦИИ]\n"
+              << "  --socket=ПУТЬ         Путь к Unix-сокету сервера (по умолчанию: /tmp/octet.sock)\n"
+              << "  --connections=ЧИСЛО   Количество соединений (по умолчанию: 8)\n"
+              << "  --duration=ЧИСЛО      Длительность измерения в секундах (по умолчанию: 10)\n"
+              << "  --warmup=ЧИСЛО        Длительность прогрева в секундах (по умолчанию: 1)\n"
+              << "  --read-percent=ЧИСЛО  Доля запросов GET в процентах (по умолчанию: 90)\n"
+              << "  --keys=ЧИСЛО          Количество записей (по умолчанию: 10000)\n"
+              << "  --value-size=ЧИСЛО    Размер значения записи в байтах (по умолчанию: 128)\n";
+}
+
+/**
+ * @brief Разбирает аргументы командной строки
+ * @param argc Количество аргументов
+ * @param argv Аргументы
+ * @param[out] config Параметры нагрузки
+ * @return true, если все аргументы корректны
+ */
+bool parseArguments(int argc, char **argv, LoadConfig &config)
+{
+    for (int i = 1; i < argc; i++) {
+        const std::string arg = argv[i];
+        const auto pos = arg.find('=');
+        if (pos == std::string::npos) {
+            return false;
+        }
+        const auto name = arg.substr(0, pos);
+        const auto value = arg.substr(pos + 1);
+        bool valid = true;
+        if (name == "--socket") {
+            config.socketPath = value;
+        }
+        else if (name == "--connections") {
+            valid = parseNumber(value, config.connections) && config.connections != 0;
+        }
+        else if (name == "--duration") {
+            valid = parseNumber(value, config.durationSeconds) && config.durationSeconds != 0;
+        }
+        else if (name == "--warmup") {
+            valid = parseNumber(value, config.warmupSeconds);
+        }
+        else if (name == "--read-percent") {
+            valid = parseNumber(value, config.readPercent) && config.readPercent <= 100;
+        }
+        else if (name == "--keys") {
+            valid = parseNumber(value, config.keys) && config.keys != 0;
+        }
+        else if (name == "--value-size") {
+            valid = parseNumber(value, config.valueSize);
+        }
+        else {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << "Некорректный аргумент: " << arg << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+int main(int argc, char **argv)
+{
+    LoadConfig config;
+    if (!parseArguments(argc, argv, config)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    const auto uuids = populate(config);
+    if (!uuids.has_value()) {
+        return 1;
+    }
+
+    std::atomic<bool> stop{ false };
+    std::vector<WorkerResult> results(config.connections);
+    std::vector<std::thread> workers;
+    const auto measureFrom = Clock::now() + std::chrono::seconds(config.warmupSeconds);
+    for (size_t i = 0; i < config.connections; i++) {
+        workers.emplace_back(runWorker, std::cref(config), std::cref(*uuids), i, measureFrom,
+                             std::cref(stop), std::ref(results[i]));
+    }
+    std::this_thread::sleep_until(measureFrom + std::chrono::seconds(config.durationSeconds));
+    stop.store(true, std::memory_order_relaxed);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+
+    // Объединяем распределения всех соединений
+    octet::HistogramSnapshot total;
+    total.buckets.assign(octet::HistogramSnapshot::BUCKET_COUNT, 0);
+    uint64_t errors = 0;
+    for (const auto &result : results) {
+        for (size_t i = 0; i < total.buckets.size(); i++) {
+            total.buckets[i] += result.latencies.buckets[i];
+        }
+        total.count += result.latencies.count;
+        total.sum += result.latencies.sum;
+        total.max = std::max(total.max, result.latencies.max);
+        errors += result.errors;
+    }
+
+    const auto micros = [](uint64_t nanos) { return static_cast<double>(nanos) / 1000.0; };
+    std::cout << std::fixed << std::setprecision(1) << "connections:  " << config.connections
+              << "\nread%:        " << config.readPercent
+              << "\nrequests:     " << total.count << "\nerrors:       " << errors
+              << "\nthroughput:   "
+              << static_cast<double>(total.count) / static_cast<double>(config.durationSeconds)
+              << " req/s"
+              << "\nlatency mean: " << total.mean() / 1000.0 << " us"
+              << "\nlatency p50:  " << micros(total.valueAtQuantile(0.5)) << " us"
+              << "\nlatency p99:  " << micros(total.valueAtQuantile(0.99)) << " us"
+              << "\nlatency p999: " << micros(total.valueAtQuantile(0.999)) << " us"
+              << "\nlatency max:  " << micros(total.max) << " us" << std::endl;
+    return errors == 0 ? 0 : 2;
+}
@@ -1,11 +1,18 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <fstream>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace octet {
 /**
@@ -34,6 +41,11 @@ enum class LogLevel {
  *
  * Logger является синглтоном и обеспечивает потокобезопасное логирование.
  * По умолчанию логирование отключено и должно быть явно включено пользователем.
+ *
+ * В асинхронном режиме (setAsync) сообщение лишь помещается в кольцевой буфер потока,
+ * вызвавшего логирование, без блокировок, а форматирование и вывод выполняет фоновый поток
+ * записи. Сообщения одного потока выводятся в порядке логирования, сообщения разных потоков
+ * могут перемежаться (время в сообщении соответствует моменту логирования).
  */
 class Logger {
 public:
@@ -103,18 +115,39 @@ public:
      */
     bool getFormatMessage() const;
 
+    /**
+     * @brief Включение или отключение асинхронного режима логирования
+     * @param async true для вывода сообщений фоновым потоком записи
+     */
+    void setAsync(bool async);
+
+    /**
+     * @brief Проверка, включен ли асинхронный режим логирования
+     * @return true, если сообщения выводит фоновый поток записи
+     */
+    bool isAsync() const;
+
+    /**
+     * @brief Ожидание вывода всех сообщений, залогированных до вызова (в асинхронном режиме)
+     */
+    void flush();
+
     /**
      * @brief Логирование сообщения с указанным уровнем
      * @param level Уровень сообщения
      * @param message Текст сообщения
-     * @param file Имя файла, из которого вызвана функция логирования
+     * @param file Имя файла, из которого вызвана функция логирования (строка должна жить до
+     * конца работы программы, как __FILE__)
      * @param line Номер строки, из которой вызвана функция логирования
      * @param useLock Нужно ли использовать блокировку
      */
-    void log(LogLevel level, const std::string &message, const std::string_view file = {},
-             int line = 0, bool useLock = true);
+    void log(LogLevel level, std::string message, const std::string_view file = {}, int line = 0,
+             bool useLock = true);
 
 private:
+    struct Record; // Сообщение, ожидающее вывода
+    class Ring; // Кольцевой буфер сообщений потока
+
     // Запрещаем создание экземпляров класса напрямую
     Logger();
     ~Logger();
@@ -124,14 +157,29 @@ private:
     Logger &operator=(Logger &&) = delete;
 
     // Состояние логгера
-    bool enabled_; // Включено ли логирование
+    std::atomic<bool> enabled_; // Включено ли логирование
     bool consoleOutput_; // Вывод в консоль
     bool colorOutput_; // Использовать цветной вывод
     bool formatMessage_; // Использовать префикс
     std::optional<std::filesystem::path> logFilePath_; // Путь к файлу лога
-    LogLevel minimumLevel_; // Минимальный уровень логирования
+    std::ofstream logFile_; // Открытый файл лога
+    std::atomic<LogLevel> minimumLevel_; // Минимальный уровень логирования
     std::mutex logMutex_; // Мьютекс для потокобезопасности
 
+    // Асинхронный режим
+    std::atomic<bool> async_; // Включен ли асинхронный режим
+    std::mutex asyncMutex_; // Мьютекс для включения и отключения асинхронного режима
+    std::mutex ringsMutex_; // Мьютекс для защиты списка буферов потоков
+    std::vector<std::shared_ptr<Ring>> rings_; // Буферы потоков, писавших в асинхронном режиме
+    std::thread writer_; // Поток записи
+    bool writerRunning_ = false; // Должен ли поток записи продолжать работу
+    std::atomic<bool> wakeup_; // Есть ли новые сообщения для потока записи
+    std::mutex writerMutex_; // Мьютекс для ожидания потока записи
+    std::condition_variable writerCv_; // Пробуждение потока записи
+    std::condition_variable drainedCv_; // Уведомление о завершении прохода потока записи
+    static thread_local std::shared_ptr<Ring> threadRing_; // Буфер текущего потока (создается
+                                                            // при первом логировании)
+
     /**
      * @brief Преобразует уровень логирования в строку
      * @param level Уровень логирования
@@ -145,10 +193,39 @@ private:
      * @param message Текст сообщения
      * @param file Имя файла
      * @param line Номер строки
+     * @param time Время логирования
      * @return Отформатированное сообщение
      */
     std::string formatLogMessage(LogLevel level, const std::string &message,
-                                 const std::string_view file, int line) const;
+                                 const std::string_view file, int line,
+                                 std::chrono::system_clock::time_point time) const;
+
+    /**
+     * @brief Форматирует и выводит сообщение (вызывается под logMutex_)
+     * @param record Сообщение
+     */
+    void writeRecord(const Record &record);
+
+    /**
+     * @brief Помещает сообщение в кольцевой буфер текущего потока
+     * @param record Сообщение
+     */
+    void enqueue(Record &&record);
+
+    /**
+     * @brief Пробуждает поток записи
+     */
+    void wakeWriter();
+
+    /**
+     * @brief Основной цикл потока записи
+     */
+    void writerLoop();
+
+    /**
+     * @brief Выводит все сообщения из буферов потоков
+     */
+    void drainRings();
 
     /**
      * @brief Записывает сообщение в файл лога
@@ -196,15 +273,20 @@ public:
      */
     template <typename T> LogStream &operator<<(const T &val)
     {
-        if (Logger::getInstance().isEnabled() && level_ >= Logger::getInstance().getMinLogLevel()) {
-            stream_ << val;
+        if (active_) {
+            if (!stream_.has_value()) {
+                stream_.emplace();
+            }
+            *stream_ << val;
         }
         return *this;
     }
 
 private:
     LogLevel level_; // Уровень логирования
-    std::ostringstream stream_; // Поток для формирования сообщения
+    bool active_; // Будет ли сообщение залогировано (проверяется один раз при создании)
+    std::optional<std::ostringstream> stream_; // Поток для формирования сообщения (создается
+                                               // только для логируемых сообщений)
     std::string_view file_; // Имя файла
     int line_; // Номер строки
 };
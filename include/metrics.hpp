@@ -0,0 +1,258 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace octet {
+/**
+ * @enum MetricCounter
+ * @brief Монотонно растущие счётчики
+ */
+enum class MetricCounter : uint8_t {
+    STORAGE_FAILURES, // Операции StorageManager, завершившиеся ошибкой
+    JOURNAL_BYTES, // Байты, записанные в журнал
+    JOURNAL_FSYNCS, // Вызовы fdatasync журнала
+    SNAPSHOT_BYTES, // Байты, записанные в файлы снапшотов
+    SNAPSHOT_FAILURES, // Снапшоты, которые не удалось создать
+    VALUE_LOG_READS, // Значения, прочитанные с диска из журнала значений
+    VALUE_CACHE_HITS, // Значения журнала значений, прочитанные из кэша
+    COUNT // Количество счётчиков (не является счётчиком)
+};
+
+/**
+ * @enum MetricGauge
+ * @brief Текущие значения, которые могут как расти, так и уменьшаться
+ */
+enum class MetricGauge : uint8_t {
+    SNAPSHOT_SIZE, // Размер последнего полного снапшота в байтах
+    DELTA_SNAPSHOT_SIZE, // Размер последнего разностного снапшота в байтах
+    LOADED_ENTRIES, // Количество записей, загруженных с диска при запуске
+    WRITE_QUEUE_DEPTH, // Кадры ответов в очередях записи всех соединений
+    VALUE_LIVE_BYTES, // Суммарная длина значений вне ячеек таблиц (из ValueAllocator)
+    VALUE_ALLOCATED_BYTES, // Размер блоков, выданных под значения (из ValueAllocator)
+    VALUE_RESERVED_BYTES, // Память, полученная ValueAllocator у системы
+    VALUE_SLABS, // Количество слэбов ValueAllocator
+    VALUE_LOG_DISK_BYTES, // Суммарный размер сегментов журналов значений
+    VALUE_LOG_LIVE_BYTES, // Размер записей журналов значений, используемых хранилищами
+    VALUE_CACHE_BYTES, // Суммарная длина значений в кэшах журналов значений
+    COUNT // Количество показателей (не является показателем)
+};
+
+/**
+ * @enum MetricHistogram
+ * @brief Распределения значений (длительности записываются в наносекундах)
+ */
+enum class MetricHistogram : uint8_t {
+    STORAGE_INSERT, // Длительность StorageManager::insert
+    STORAGE_GET, // Длительность StorageManager::get
+    STORAGE_UPDATE, // Длительность StorageManager::update
+    STORAGE_REMOVE, // Длительность StorageManager::remove
+    STORAGE_BATCH, // Длительность StorageManager::applyBatch
+    STORAGE_MGET, // Длительность StorageManager::getMany
+    JOURNAL_APPEND, // Длительность записи пакета в журнал (включая fdatasync)
+    JOURNAL_FSYNC, // Длительность fdatasync журнала
+    SNAPSHOT, // Длительность создания полного снапшота
+    DELTA_SNAPSHOT, // Длительность создания разностного снапшота
+    LOAD, // Длительность загрузки хранилища с диска (снапшоты и журнал)
+    LOCK_WAIT, // Ожидание файловой блокировки в FileLockGuard
+    WRITE_QUEUE_DEPTH, // Длина очереди записи соединения при постановке кадра
+    COUNT // Количество распределений (не является распределением)
+};
+
+/**
+ * @class HistogramSnapshot
+ * @brief Распределение значений в логарифмически-линейных корзинах (как в HDR Histogram).
+ *
+ * Значения меньше SUB_BUCKET_COUNT хранятся точно, а каждый следующий интервал [2^k, 2^(k+1))
+ * делится на SUB_BUCKET_COUNT равных корзин, поэтому относительная погрешность перцентилей не
+ * превышает 1 / SUB_BUCKET_COUNT при фиксированном размере гистограммы. Значения больше
+ * MAX_TRACKABLE_VALUE попадают в последнюю корзину.
+ */
+class HistogramSnapshot {
+public:
+    static constexpr size_t SUB_BUCKET_BITS = 4;
+    static constexpr size_t SUB_BUCKET_COUNT = size_t(1) << SUB_BUCKET_BITS;
+    // Наибольшее различимое значение: около 4.9 часа в наносекундах
+    static constexpr size_t MAX_VALUE_BITS = 44;
+    static constexpr uint64_t MAX_TRACKABLE_VALUE = (uint64_t(1) << MAX_VALUE_BITS) - 1;
+    static constexpr size_t BUCKET_COUNT
+        = (MAX_VALUE_BITS - SUB_BUCKET_BITS + 1) * SUB_BUCKET_COUNT;
+
+    uint64_t count = 0; // Количество значений
+    uint64_t sum = 0; // Сумма значений
+    uint64_t max = 0; // Наибольшее значение
+    std::vector<uint64_t> buckets; // Количество значений в каждой корзине
+
+    /**
+     * @brief Возвращает индекс корзины для значения
+     * @param value Значение
+     * @return Индекс корзины в [0, BUCKET_COUNT)
+     */
+    static size_t bucketIndex(uint64_t value);
+
+    /**
+     * @brief Возвращает наибольшее значение, попадающее в корзину
+     * @param index Индекс корзины
+     * @return Верхняя граница корзины (включительно)
+     */
+    static uint64_t bucketUpperBound(size_t index);
+
+    /**
+     * @brief Возвращает значение, не меньше которого не больше (1 - quantile) доли значений
+     * @param quantile Квантиль в [0, 1]
+     * @return Верхняя граница корзины квантиля, но не больше наибольшего значения (0, если
+     * значений нет)
+     */
+    uint64_t valueAtQuantile(double quantile) const;
+
+    /**
+     * @brief Возвращает среднее значение
+     * @return Среднее значение (0, если значений нет)
+     */
+    double mean() const;
+};
+
+/**
+ * @struct MetricsSnapshot
+ * @brief Согласованные между собой значения всех показателей на момент вызова Metrics::snapshot
+ */
+struct MetricsSnapshot {
+    std::array<uint64_t, size_t(MetricCounter::COUNT)> counters{};
+    std::array<int64_t, size_t(MetricGauge::COUNT)> gauges{};
+    std::array<HistogramSnapshot, size_t(MetricHistogram::COUNT)> histograms;
+
+    uint64_t counter(MetricCounter metric) const
+    {
+        return counters[size_t(metric)];
+    }
+    int64_t gauge(MetricGauge metric) const
+    {
+        return gauges[size_t(metric)];
+    }
+    const HistogramSnapshot &histogram(MetricHistogram metric) const
+    {
+        return histograms[size_t(metric)];
+    }
+
+    /**
+     * @brief Форматирует показатели в текстовом формате Prometheus (распределения выводятся как
+     * summary с квантилями 0.5, 0.9, 0.99 и 0.999, длительности - в секундах)
+     * @return Текст для ответа на запрос /metrics
+     */
+    std::string toPrometheus() const;
+};
+
+/**
+ * @class Metrics
+ * @brief Собирает показатели работы библиотеки с минимальными накладными расходами.
+ *
+ * Metrics является синглтоном. Счётчики и распределения каждый поток изменяет в своём сегменте
+ * (создаётся при первой записи), поэтому запись не требует блокировок и атомарных
+ * read-modify-write операций, а потоки не делят кэш-линии. Сегменты суммируются только при
+ * вызове snapshot(). Сегменты завершившихся потоков сохраняются, поэтому их значения не теряются.
+ * Показатели (gauges) хранятся глобально, так как их значение задаётся, а не накапливается.
+ * Показатели памяти значений не хранятся, а запрашиваются у ValueAllocator при вызове snapshot().
+ */
+class Metrics {
+public:
+    /**
+     * @brief Получение единственного экземпляра
+     * @return Ссылка на экземпляр
+     */
+    static Metrics &getInstance();
+
+    /**
+     * @brief Увеличивает счётчик
+     * @param metric Счётчик
+     * @param value Величина увеличения
+     */
+    void increment(MetricCounter metric, uint64_t value = 1);
+
+    /**
+     * @brief Устанавливает значение показателя
+     * @param metric Показатель
+     * @param value Новое значение
+     */
+    void setGauge(MetricGauge metric, int64_t value);
+
+    /**
+     * @brief Изменяет значение показателя
+     * @param metric Показатель
+     * @param delta Величина изменения (может быть отрицательной)
+     */
+    void addGauge(MetricGauge metric, int64_t delta);
+
+    /**
+     * @brief Добавляет значение в распределение
+     * @param metric Распределение
+     * @param value Значение (длительности - в наносекундах)
+     */
+    void record(MetricHistogram metric, uint64_t value);
+
+    /**
+     * @brief Добавляет длительность в распределение
+     * @param metric Распределение
+     * @param duration Длительность
+     */
+    void recordDuration(MetricHistogram metric, std::chrono::steady_clock::duration duration);
+
+    /**
+     * @brief Суммирует значения всех потоков
+     * @return Текущие значения показателей
+     */
+    MetricsSnapshot snapshot() const;
+
+private:
+    class Shard; // Показатели одного потока
+
+    // Запрещаем создание экземпляров класса напрямую
+    Metrics();
+    ~Metrics();
+    Metrics(const Metrics &) = delete;
+    Metrics &operator=(const Metrics &) = delete;
+    Metrics(Metrics &&) = delete;
+    Metrics &operator=(Metrics &&) = delete;
+
+    /**
+     * @brief Возвращает сегмент текущего потока, создавая его при первом обращении
+     * @return Сегмент текущего потока
+     */
+    Shard &threadShard();
+
+    mutable std::mutex shardsMutex_; // Мьютекс для защиты списка сегментов
+    std::vector<std::shared_ptr<Shard>> shards_; // Сегменты всех потоков, писавших показатели
+    std::array<std::atomic<int64_t>, size_t(MetricGauge::COUNT)> gauges_{};
+    static thread_local std::shared_ptr<Shard> threadShard_; // Сегмент текущего потока
+};
+
+/**
+ * @class ScopedLatency
+ * @brief Записывает в распределение время жизни объекта
+ */
+class ScopedLatency {
+public:
+    explicit ScopedLatency(MetricHistogram metric)
+        : metric_(metric)
+        , start_(std::chrono::steady_clock::now())
+    {
+    }
+
+    ~ScopedLatency()
+    {
+        Metrics::getInstance().recordDuration(metric_, std::chrono::steady_clock::now() - start_);
+    }
+
+    ScopedLatency(const ScopedLatency &) = delete;
+    ScopedLatency &operator=(const ScopedLatency &) = delete;
+
+private:
+    const MetricHistogram metric_;
+    const std::chrono::steady_clock::time_point start_;
+};
+} // namespace octet
@@ -1,13 +1,24 @@
 #pragma once
 
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <memory>
 #include <mutex>
 #include <optional>
 #include <string>
+#include <string_view>
+#include <thread>
 #include <unordered_map>
 #include <vector>
 
 namespace octet {
+namespace utils {
+class IoRing;
+} // namespace utils
+
 /**
  * @enum OperationType
  * @brief Типы операций для журнала.
@@ -19,6 +30,90 @@ enum class OperationType : uint8_t {
     CHECKPOINT // Контрольная точка (снимок состояния)
 };
 
+/**
+ * @enum DurabilityMode
+ * @brief Режимы фиксации записей журнала на диске.
+ *
+ * В режимах SYNC и GROUP_COMMIT операция подтверждается только после fdatasync, поэтому
+ * подтвержденные операции переживают как падение процесса, так и сбой ОС. В режиме INTERVAL при
+ * сбое ОС или падении процесса теряются операции за последний интервал синхронизации, в режиме
+ * NONE - всё, что не успела записать ОС. Контрольные точки во всех режимах фиксируются синхронно.
+ */
+enum class DurabilityMode : uint8_t {
+    SYNC, // Каждая запись фиксируется на диске отдельно в потоке вызывающего
+    GROUP_COMMIT, // Записи конкурентных писателей объединяются и фиксируются одним fdatasync
+    INTERVAL, // Записи накапливаются и фиксируются одним пакетом раз в интервал синхронизации
+    NONE // Записи передаются ОС без fdatasync, сброс на диск остаётся на усмотрение ОС
+};
+
+/**
+ * @enum IoBackend
+ * @brief Способ записи журнала и снапшотов на диск.
+ *
+ * В режиме IO_URING (только Linux) пакет журнала и fdatasync передаются ядру связанной парой
+ * операций одним системным вызовом, а снапшот записывается из нескольких буферов, пока
+ * сериализуются следующие данные. Если io_uring недоступен (старое ядро, запрет в контейнере или
+ * сборка без поддержки), используются обычные системные вызовы.
+ */
+enum class IoBackend : uint8_t {
+    POSIX, // Системные вызовы write и fdatasync
+    IO_URING // Очередь io_uring
+};
+
+/**
+ * @struct DurabilityPolicy
+ * @brief Политика фиксации записей журнала на диске
+ */
+struct DurabilityPolicy {
+    DurabilityMode mode = DurabilityMode::SYNC; // Режим фиксации
+    std::chrono::milliseconds syncInterval{ 10 }; // Интервал синхронизации для режима INTERVAL
+    IoBackend ioBackend = IoBackend::POSIX; // Способ записи на диск
+};
+
+/**
+ * @enum CompressionCodec
+ * @brief Алгоритмы поблочного сжатия снапшотов и запечатанных сегментов журнала.
+ *
+ * Алгоритм записывается в заголовок каждого сжатого файла, поэтому файлы, сжатые разными
+ * алгоритмами (или не сжатые вовсе), читаются независимо от текущей настройки.
+ */
+enum class CompressionCodec : uint8_t {
+    NONE = 0, // Данные записываются без сжатия
+    LZ4 = 1, // Быстрое сжатие LZ4
+    ZSTD = 2 // Более сильное сжатие Zstandard
+};
+
+// Пакет записей, фиксируемых на диске одной операцией (определён в journal_manager.cpp)
+struct JournalBatch;
+
+// Квитанция о постановке записи в журнал, по которой можно дождаться её фиксации на диске
+using JournalTicket = std::shared_ptr<JournalBatch>;
+
+/**
+ * @struct JournalOperationView
+ * @brief Операция для пакетной постановки в журнал (поля ссылаются на данные вызывающего и
+ * должны быть действительны до возврата из submitOperations)
+ */
+struct JournalOperationView {
+    OperationType type; // Тип операции (кроме CHECKPOINT)
+    std::string_view uuid; // Идентификатор строки
+    std::string_view data; // Данные операции (для INSERT и UPDATE)
+};
+
+/**
+ * @struct JournalEntryView
+ * @brief Представление записи журнала без копирования её данных.
+ *
+ * Поля ссылаются на буфер, из которого запись была прочитана (например, на отображенный в память
+ * журнал), и действительны, только пока существует этот буфер.
+ */
+struct JournalEntryView {
+    OperationType type; // Тип операции
+    std::string_view uuid; // Идентификатор строки
+    std::string_view data; // Данные операции (для INSERT и UPDATE)
+    uint64_t timestamp; // Временная метка операции (наносекунды с начала эпохи Unix)
+};
+
 /**
  * @struct JournalEntry
  * @brief Структура для хранения записи в журнале
@@ -29,23 +124,51 @@ struct JournalEntry {
      * @param type Тип операции
      * @param uuid Идентификатор строки
      * @param data Данные операции
-     * @param timestamp Временная метка (если не указана, будет сгенерирована)
+     * @param timestamp Временная метка в наносекундах с начала эпохи Unix (если не указана, будет
+     * сгенерирована)
      */
     JournalEntry(OperationType type, std::string uuid, std::string data = "",
-                 std::string timestamp = "");
+                 std::optional<uint64_t> timestamp = std::nullopt);
+
     /**
-     * @brief Сериализует запись журнала в строку для записи в файл
-     * @param entry Запись журнала для сериализации
-     * @return Строка, представляющая запись в формате журнала
+     * @brief Сериализует запись журнала в бинарную запись с контрольной суммой CRC32C
+     * @return Бинарное представление записи
      */
     std::string serialize() const;
 
     /**
-     * @brief Десериализует строку из файла журнала в запись журнала
+     * @brief Десериализует бинарную запись журнала, расположенную в начале буфера
+     * @param buffer Буфер, начинающийся с записи журнала
+     * @param[out] recordSize Размер прочитанной записи в байтах (опционально)
+     * @return Запись журнала или std::nullopt, если запись повреждена или дописана не полностью
+     */
+    static std::optional<JournalEntry> deserialize(std::string_view buffer,
+                                                   size_t *recordSize = nullptr);
+
+    /**
+     * @brief Разбирает бинарную запись журнала, расположенную в начале буфера, без копирования
+     * @param buffer Буфер, начинающийся с записи журнала
+     * @param[out] recordSize Размер прочитанной записи в байтах (опционально)
+     * @return Представление записи, ссылающееся на buffer, или std::nullopt, если запись
+     * повреждена или дописана не полностью
+     */
+    static std::optional<JournalEntryView> deserializeView(std::string_view buffer,
+                                                           size_t *recordSize = nullptr);
+
+    /**
+     * @brief Дописывает бинарную запись журнала по её представлению в буфер (например, чтобы
+     * передать прочитанную запись без копирования в JournalEntry)
+     * @param entry Представление записи
+     * @param buffer Буфер для дописывания
+     */
+    static void serializeView(const JournalEntryView &entry, std::string &buffer);
+
+    /**
+     * @brief Десериализует строку журнала текстового формата v1
      * @param line Строка из журнала
      * @return Запись журнала или std::nullopt в случае ошибки формата
      */
-    static std::optional<JournalEntry> deserialize(const std::string &line);
+    static std::optional<JournalEntry> deserializeLegacy(std::string_view line);
 
     /**
      * @brief Геттер для типа операции
@@ -74,11 +197,39 @@ struct JournalEntry {
         return data_;
     }
 
+    /**
+     * @brief Геттер для временной метки операции
+     * @return Временная метка в наносекундах с начала эпохи Unix
+     */
+    uint64_t timestamp() const
+    {
+        return timestamp_;
+    }
+
+    /**
+     * @brief Возвращает представление записи, действительное, пока существует запись
+     * @return Представление записи
+     */
+    JournalEntryView view() const
+    {
+        return JournalEntryView{ type_, uuid_, data_, timestamp_ };
+    }
+
 private:
     OperationType type_; // Тип операции
     std::string uuid_; // Идентификатор строки
     std::string data_; // Данные операции (для INSERT и UPDATE)
-    std::string timestamp_; // Временная метка операции
+    uint64_t timestamp_; // Временная метка операции (наносекунды с начала эпохи Unix)
+};
+
+/**
+ * @struct CheckpointLocation
+ * @brief Положение записи контрольной точки в файле журнала
+ */
+struct CheckpointLocation {
+    std::string id; // Идентификатор контрольной точки
+    uint64_t offset; // Смещение записи контрольной точки от начала файла сегмента
+    uint64_t segment = 0; // Номер запечатанного сегмента с точкой (0 - активный сегмент)
 };
 
 /**
@@ -87,16 +238,36 @@ private:
  *
  * Реализует механизм журналирования (WAL) для обеспечения устойчивости
  * к сбоям и возможности восстановления данных после неожиданного завершения.
- * Все операции изменения данных сначала записываются в журнал, а затем применяются
- * к хранилищу, что гарантирует согласованность при сбоях.
+ * Хранилище изменяет данные в памяти вместе с резервированием номера записи журнала, поэтому
+ * порядок записей совпадает с порядком изменений, а подтверждает операцию только после фиксации
+ * её записи. Если фиксация не удалась, изменение откатывается, поэтому после сбоя
+ * восстанавливаются все подтверждённые операции.
+ *
+ * Рядом с журналом хранится индекс положений контрольных точек (сегмент и смещение в нём),
+ * позволяющий при восстановлении сразу перейти к нужной контрольной точке и читать только записи
+ * после неё, не читая предшествующие сегменты. При запечатывании сегмента его точки остаются в
+ * индексе под номером сегмента. Индекс является вспомогательным: каждое положение сверяется с
+ * журналом, а при расхождении журнал читается целиком.
+ *
+ * Журнал состоит из сегментов: записи дописываются в активный сегмент (файл по пути журнала),
+ * место под который выделяется заранее. Когда сегмент достигает заданного размера или журнал
+ * уплотняется, сегмент запечатывается под именем с порядковым номером и начинается новый активный
+ * сегмент (при уплотнении - с контрольной точки). Запечатанные сегменты, предшествующие
+ * контрольной точке сохранённого снапшота, удаляются целиком, без чтения их содержимого, а при
+ * восстановлении разбираются параллельно.
  */
 class JournalManager {
 public:
     /**
      * @brief Конструктор с указанием пути к файлу журнала
      * @param journalPath Путь к файлу журнала операций
+     * @param policy Политика фиксации записей на диске
+     * @param onWrite Обработчик, вызываемый после записи каждого пакета в журнал (например, для
+     * уведомления читателей из других процессов), опционально
      */
-    explicit JournalManager(const std::filesystem::path &journalPath);
+    explicit JournalManager(const std::filesystem::path &journalPath,
+                            DurabilityPolicy policy = DurabilityPolicy(),
+                            std::function<void()> onWrite = nullptr);
 
     /**
      * @brief Деструктор, гарантирующий закрытие ресурсов
@@ -113,6 +284,108 @@ public:
     bool writeOperation(OperationType opType, const std::string &uuid,
                         const std::string &data = "");
 
+    /**
+     * @brief Ставит операцию в очередь на запись в журнал, не дожидаясь её фиксации на диске.
+     * В режиме SYNC запись фиксируется сразу, а в режимах INTERVAL и NONE не требует ожидания
+     * (кроме контрольных точек), поэтому в этих случаях квитанция возвращается уже завершённой
+     * @param opType Тип операции
+     * @param uuid Идентификатор строки
+     * @param data Данные операции (для INSERT и UPDATE)
+     * @return Квитанция для ожидания фиксации или nullptr при ошибке
+     */
+    JournalTicket submitOperation(OperationType opType, std::string_view uuid,
+                                  std::string_view data = {});
+
+    /**
+     * @brief Ставит контрольную точку в очередь на запись в журнал. Если требуется новый сегмент,
+     * то записи до контрольной точки фиксируются в текущем сегменте, он запечатывается, а
+     * контрольная точка становится первой записью нового активного сегмента. Данные записи
+     * контрольной точки ссылаются на предыдущую точку и количество операций после неё
+     * ("идентификатор\nколичество", пусто, если предыдущая точка неизвестна): по ссылке читатель
+     * находит своё положение, даже если прежняя точка удалена уплотнением (см. JournalReader)
+     * @param checkpointId Идентификатор контрольной точки
+     * @param startNewSegment Нужно ли начать с контрольной точки новый сегмент журнала
+     * @return Квитанция для ожидания фиксации (через waitForCheckpoint) или nullptr при ошибке
+     */
+    JournalTicket submitCheckpoint(const std::string &checkpointId, bool startNewSegment);
+
+    /**
+     * @brief Резервирует порядковый номер следующей записи журнала. Записи попадают в журнал
+     * строго в порядке номеров, поэтому номер, полученный под блокировкой данных вместе с их
+     * изменением, позволяет ставить запись в очередь уже после снятия блокировки. Каждый
+     * зарезервированный номер должен быть обязательно передан в submitOperation или
+     * submitCheckpoint, иначе следующие записи будут ждать его бесконечно
+     * @return Порядковый номер записи
+     */
+    uint64_t reserveSequence();
+
+    /**
+     * @brief Резервирует несколько последовательных номеров записей журнала (для пакета операций,
+     * передаваемого в submitOperations)
+     * @param count Количество номеров
+     * @return Первый из зарезервированных номеров
+     */
+    uint64_t reserveSequences(uint64_t count);
+
+    /**
+     * @brief Ставит операцию с зарезервированным номером в очередь на запись в журнал, дожидаясь
+     * постановки в очередь всех операций с меньшими номерами
+     * @param sequence Номер, полученный от reserveSequence
+     * @param opType Тип операции
+     * @param uuid Идентификатор строки
+     * @param data Данные операции (для INSERT и UPDATE)
+     * @return Квитанция для ожидания фиксации или nullptr при ошибке
+     */
+    JournalTicket submitOperation(uint64_t sequence, OperationType opType, std::string_view uuid,
+                                  std::string_view data = {});
+
+    /**
+     * @brief Ставит пакет операций с зарезервированными подряд номерами в очередь на запись в
+     * журнал. Операции попадают в один пакет журнала и фиксируются на диске одной операцией
+     * синхронизации, поэтому для всего пакета достаточно одного ожидания waitForCommit
+     * @param firstSequence Первый номер, полученный от reserveSequences(operations.size())
+     * @param operations Операции пакета
+     * @return Квитанция для ожидания фиксации или nullptr при ошибке (в том числе если хотя бы
+     * одна операция не может быть записана: тогда не записывается весь пакет)
+     */
+    JournalTicket submitOperations(uint64_t firstSequence,
+                                   const std::vector<JournalOperationView> &operations);
+
+    /**
+     * @brief Ставит контрольную точку с зарезервированным номером в очередь на запись в журнал
+     * @param sequence Номер, полученный от reserveSequence
+     * @param checkpointId Идентификатор контрольной точки
+     * @param startNewSegment Нужно ли начать с контрольной точки новый сегмент журнала
+     * @return Квитанция для ожидания фиксации (через waitForCheckpoint) или nullptr при ошибке
+     */
+    JournalTicket submitCheckpoint(uint64_t sequence, const std::string &checkpointId,
+                                   bool startNewSegment);
+
+    /**
+     * @brief Проверяет, что операция может быть записана в журнал (идентификатор не пуст, а
+     * размеры полей не превышают ограничений формата записи)
+     * @param uuid Идентификатор строки
+     * @param data Данные операции
+     * @return true если операцию можно записать
+     */
+    static bool isOperationRecordable(std::string_view uuid, std::string_view data);
+
+    /**
+     * @brief Ожидает фиксации на диске операции, поставленной в очередь через submitOperation
+     * @param ticket Квитанция, полученная от submitOperation
+     * @return true если операция зафиксирована успешно
+     */
+    bool waitForCommit(const JournalTicket &ticket);
+
+    /**
+     * @brief Ожидает фиксации контрольной точки, поставленной в очередь через submitOperation, и
+     * обновляет сведения о последней контрольной точке (кэш и индекс смещений)
+     * @param ticket Квитанция, полученная от submitOperation для операции CHECKPOINT
+     * @param checkpointId Идентификатор контрольной точки
+     * @return true если контрольная точка зафиксирована успешно
+     */
+    bool waitForCheckpoint(const JournalTicket &ticket, const std::string &checkpointId);
+
     /**
      * @brief Записывает операцию INSERT в журнал
      * @param uuid Идентификатор строки
@@ -152,6 +425,18 @@ public:
     bool replayJournal(std::unordered_map<std::string, std::string> &dataStore,
                        const std::optional<std::string> &lastCheckpoint = std::nullopt);
 
+    /**
+     * @brief Воспроизводит операции из журнала, передавая их обработчику (контрольные точки ему
+     * не передаются). Последняя контрольная точка журнала запоминается: на неё сошлётся следующая
+     * записанная точка
+     * @param apply Обработчик операции, возвращающий true при её успешном применении (поля записи
+     * действительны только во время вызова)
+     * @param lastCheckpoint Идентификатор последней контрольной точки (опционально)
+     * @return true если восстановление выполнено успешно
+     */
+    bool replayJournal(const std::function<bool(const JournalEntryView &)> &apply,
+                       const std::optional<std::string> &lastCheckpoint = std::nullopt);
+
     /**
      * @brief Получает последний идентификатор контрольной точки из журнала
      * @return Идентификатор последней контрольной точки или std::nullopt, если контрольных точек
@@ -179,9 +464,72 @@ public:
      */
     bool isJournalValid() const;
 
+    /**
+     * @brief Удаляет запечатанные сегменты журнала, предшествующие сегменту, который начинается с
+     * указанной контрольной точки. Содержимое удаляемых сегментов не читается
+     * @param checkpointId Контрольная точка, с которой начинается один из сегментов журнала
+     * @return true если сегмент с контрольной точкой найден и предшествующие сегменты удалены
+     */
+    bool removeSegmentsBeforeCheckpoint(const std::string &checkpointId);
+
+    /**
+     * @brief Задает размер сегмента журнала, по достижении которого начинается новый сегмент
+     * @param bytes Размер в байтах, 0 - без ограничения (по умолчанию: 64 МБ)
+     */
+    void setSegmentSize(uint64_t bytes);
+
+    /**
+     * @brief Задает алгоритм сжатия запечатанных сегментов журнала (по умолчанию: без сжатия).
+     * Активный сегмент не сжимается никогда
+     * @param codec Алгоритм сжатия
+     * @return true если алгоритм поддерживается сборкой и установлен
+     */
+    bool setCompressionCodec(CompressionCodec codec);
+
+    /**
+     * @brief Проверяет, собрана ли библиотека с поддержкой алгоритма сжатия
+     * @param codec Алгоритм сжатия
+     * @return true если алгоритм поддерживается
+     */
+    static bool isCompressionCodecSupported(CompressionCodec codec);
+
+    /**
+     * @brief Сжимает ещё не сжатые запечатанные сегменты журнала установленным алгоритмом.
+     * Сегмент заменяется сжатым атомарно и только если сжатие уменьшило его размер
+     * @return true если все сегменты обработаны без ошибок
+     */
+    bool compressSealedSegments();
+
+    /**
+     * @brief Возвращает размер активного сегмента журнала
+     * @return Размер в байтах
+     */
+    uint64_t getActiveSegmentSize() const;
+
+    /**
+     * @brief Возвращает суммарный размер всех сегментов журнала
+     * @return Размер в байтах
+     */
+    uint64_t getJournalSize() const;
+
+    /**
+     * @brief Возвращает время, прошедшее с начала записи в активный сегмент журнала (или с
+     * открытия журнала, если сегмент был начат до этого)
+     * @return Возраст активного сегмента
+     */
+    std::chrono::steady_clock::duration getActiveSegmentAge() const;
+
+    /**
+     * @brief Возвращает способ записи журнала (POSIX, если io_uring запрошен, но недоступен)
+     * @return Используемый способ записи
+     */
+    IoBackend getIoBackend() const noexcept;
+
 private:
     // Путь к файлу журнала
     const std::filesystem::path journalFilePath_;
+    // Путь к индексу смещений контрольных точек
+    const std::filesystem::path checkpointIndexPath_;
 
     // Мьютекс для синхронизации доступа к журналу
     mutable std::mutex journalMutex_;
@@ -189,15 +537,166 @@ private:
     // Кэшированный последний checkpoint ID для быстрого доступа
     mutable std::optional<std::string> lastCheckpointId_;
 
+    // Политика фиксации записей на диске
+    const DurabilityPolicy durabilityPolicy_;
+    // Обработчик записи пакета в журнал
+    const std::function<void()> onWrite_;
+
+    // Постоянно открытый дескриптор журнала (-1, если журнал не открыт)
+    int journalFd_ = -1;
+    // Мьютекс для синхронизации записи через дескриптор и его переоткрытия
+    std::mutex descriptorMutex_;
+    // Очередь io_uring для записи пакетов (nullptr - запись обычными системными вызовами)
+    std::unique_ptr<utils::IoRing> ioRing_;
+
+    // Размер сегмента, по достижении которого начинается новый сегмент (по умолчанию 64 МБ)
+    std::atomic<uint64_t> segmentSize_{ 64 * 1024 * 1024 };
+
+    // Алгоритм сжатия запечатанных сегментов
+    std::atomic<CompressionCodec> compressionCodec_{ CompressionCodec::NONE };
+    // Мьютекс для операций, заменяющих или удаляющих запечатанные сегменты (захватывается до
+    // descriptorMutex_)
+    std::mutex sealedSegmentsMutex_;
+    // Номер последнего сегмента, проверенного при сжатии (изменяется под sealedSegmentsMutex_)
+    uint64_t lastCheckedSegment_ = 0;
+
+    // Сведения о сегментах для политики уплотнения журнала
+    std::atomic<uint64_t> activeSegmentSize_{ 0 };
+    std::atomic<uint64_t> sealedSegmentsSize_{ 0 };
+    std::atomic<std::chrono::steady_clock::rep> activeSegmentStart_{ 0 };
+
+    // Для группового коммита
+    std::shared_ptr<JournalBatch> pendingBatch_; // Пакет, накапливающий новые записи
+    JournalTicket acknowledgedTicket_; // Завершённая квитанция для записей без ожидания фиксации
+    std::mutex commitMutex_;
+    std::condition_variable commitCondition_; // Пробуждение потока фиксации
+    std::condition_variable durableCondition_; // Пробуждение ожидающих фиксации писателей
+    bool stopFlusher_ = false;
+    std::thread flusherThread_;
+
+    // Порядок записей: номера резервируются без блокировок, а записи ставятся в очередь под
+    // commitMutex_ строго по возрастанию номеров
+    std::atomic<uint64_t> nextReservedSequence_{ 0 };
+    uint64_t nextQueuedSequence_ = 0;
+    size_t sequenceWaiters_ = 0;
+    std::condition_variable sequenceCondition_;
+    // Последняя поставленная в очередь контрольная точка (std::nullopt - неизвестна) и
+    // количество операций после неё: на них ссылается следующая контрольная точка (под
+    // commitMutex_)
+    std::optional<std::string> linkedCheckpointId_;
+    uint64_t operationsSinceCheckpoint_ = 0;
+
     /**
-     * @brief Выполняет фактическую запись операции в журнал
+     * @brief Ставит сериализованную запись в очередь на запись в журнал
+     * @param sequence Порядковый номер записи
      * @param opType Тип операции
      * @param uuid Идентификатор строки
-     * @param data Данные операции (для INSERT и UPDATE)
+     * @param data Данные операции
+     * @param startNewSegment Нужно ли начать с записи новый сегмент (только для CHECKPOINT)
+     * @return Квитанция для ожидания фиксации или nullptr при ошибке
+     */
+    JournalTicket enqueueOperation(uint64_t sequence, OperationType opType, std::string_view uuid,
+                                   std::string_view data, bool startNewSegment);
+
+    /**
+     * @brief Ставит сериализованные записи с последовательными номерами в очередь на запись в
+     * журнал одним фрагментом пакета
+     * @param firstSequence Номер первой записи
+     * @param count Количество записей (номеров)
+     * @param records Сериализованные записи (для контрольной точки - пустая строка, её запись
+     * сериализуется в порядке очереди)
+     * @param recordable Можно ли записать записи (иначе номера только проходят очередь)
+     * @param checkpointId Идентификатор контрольной точки (пустой, если записи - операции)
+     * @param startNewSegment Нужно ли начать с контрольной точки новый сегмент
+     * @return Квитанция для ожидания фиксации или nullptr при ошибке
+     */
+    JournalTicket enqueueRecords(uint64_t firstSequence, uint64_t count, std::string records,
+                                 bool recordable, std::string_view checkpointId,
+                                 bool startNewSegment);
+
+    /**
+     * @brief Ожидает очереди записи с указанным номером (вызывается под commitMutex_)
+     * @param lock Захваченная блокировка commitMutex_
+     * @param sequence Порядковый номер записи
+     */
+    void do_waitForSequence(std::unique_lock<std::mutex> &lock, uint64_t sequence);
+
+    /**
+     * @brief Передаёт очередь записи следующему номеру (вызывается под commitMutex_)
+     * @param count Количество пройденных очередью номеров
+     */
+    void do_advanceSequence(uint64_t count = 1);
+
+    /**
+     * @brief Записывает пакет в журнал и при необходимости фиксирует его на диске. Если пакет
+     * начинает новый сегмент, то перед контрольной точкой текущий сегмент запечатывается, а
+     * заполненный сегмент запечатывается перед записью пакета
+     * @param batch Пакет записей (в нём сохраняется смещение контрольной точки)
+     * @param sync Нужно ли выполнять fdatasync после записи
      * @return true если запись выполнена успешно
      */
-    bool do_writeOperation(OperationType opType, const std::string &uuid,
-                           const std::string &data = "");
+    bool do_commitBatch(JournalBatch &batch, bool sync = true);
+
+    /**
+     * @brief Фиксирует записанные данные активного сегмента на диске, учитывая длительность в
+     * показателях (вызывается под descriptorMutex_)
+     * @return true если данные зафиксированы
+     */
+    bool syncJournal();
+
+    /**
+     * @brief Дописывает данные в активный сегмент и при необходимости фиксирует их на диске
+     * (через io_uring одним системным вызовом, если очередь доступна; вызывается под
+     * descriptorMutex_)
+     * @param data Данные
+     * @param size Размер данных
+     * @param offset Текущий размер активного сегмента
+     * @param sync Нужно ли выполнять fdatasync после записи
+     * @return true если данные записаны (и зафиксированы)
+     */
+    bool writeJournal(const char *data, size_t size, uint64_t offset, bool sync);
+
+    /**
+     * @brief Запечатывает активный сегмент и создаёт новый пустой активный сегмент (вызывается
+     * под descriptorMutex_ и файловой блокировкой журнала)
+     * @return true если новый сегмент создан
+     */
+    bool do_startNewSegment();
+
+    /**
+     * @brief Ожидает фиксации контрольной точки и обновляет сведения о ней (вызывается под
+     * journalMutex_)
+     * @param ticket Квитанция, полученная от submitOperation для операции CHECKPOINT
+     * @param checkpointId Идентификатор контрольной точки
+     * @return true если контрольная точка зафиксирована успешно
+     */
+    bool do_waitForCheckpoint(const JournalTicket &ticket, const std::string &checkpointId);
+
+    /**
+     * @brief Пересчитывает суммарный размер запечатанных сегментов (вызывается под
+     * descriptorMutex_)
+     */
+    void do_updateSealedSegmentsSize();
+
+    /**
+     * @brief Заменяет в индексе точки переписанного при очистке запечатанного сегмента и удаляет
+     * точки предшествующих сегментов (вызывается под descriptorMutex_)
+     * @param segment Номер сегмента
+     * @param checkpoints Положения контрольных точек в переписанном сегменте
+     */
+    void do_rewriteSealedCheckpoints(uint64_t segment,
+                                     const std::vector<CheckpointLocation> &checkpoints);
+
+    /**
+     * @brief Переоткрывает дескриптор журнала (вызывается под descriptorMutex_)
+     * @return true если журнал успешно открыт
+     */
+    bool do_reopenDescriptor();
+
+    /**
+     * @brief Функция потока фиксации пакетов (для всех режимов, кроме SYNC)
+     */
+    void flusherThreadFunction();
 
     /**
      * @brief Применяет операцию к хранилищу данных
@@ -205,24 +704,122 @@ private:
      * @param dataStore Хранилище данных для применения операции
      * @return true если операция применена успешно
      */
-    bool applyOperation(const JournalEntry &entry,
+    bool applyOperation(const JournalEntryView &entry,
                         std::unordered_map<std::string, std::string> &dataStore) const;
 
     /**
-     * @brief Считывает все записи из журнала
-     * @param checkpointId Идентификатор контрольной точки, с которой нужно начать считывание
-     * (опционально)
-     * @param[out] entries Записи из журнала
-     * @return true если считывание выполнено успешно
+     * @brief Перезаписывает журнал новым содержимым (вызывается под descriptorMutex_)
+     * @param content Полное содержимое нового журнала, включая заголовок
+     * @param checkpoints Контрольные точки нового журнала в порядке следования
+     * @return true если перезапись выполнена успешно
      */
-    bool readAllEntriesFrom(const std::optional<std::string> &checkpointId,
-                            std::vector<JournalEntry> &entries) const;
+    bool rewriteJournal(const std::string &content,
+                        const std::vector<CheckpointLocation> &checkpoints);
+};
+
+/**
+ * @class JournalReader
+ * @brief Читает журнал, который ведёт другой процесс, и дочитывает его новые записи.
+ *
+ * Читатель хранит дескриптор активного сегмента и смещение после последней полной записи в нём,
+ * поэтому новые записи дочитываются без повторного разбора журнала, а недописанная запись
+ * применяется только после того, как писатель её допишет. Когда писатель запечатывает сегмент,
+ * читатель заново разбирает журнал от контрольной точки и пропускает уже применённые операции.
+ * Журнал не изменяется и не блокируется, а журналы текстового формата v1 не поддерживаются (их
+ * переводит в бинарный формат JournalManager при открытии).
+ *
+ * Пройдя очередную контрольную точку, читатель отсчитывает операции уже от неё, поэтому
+ * уплотнение журнала по более поздней точке не теряет его положение. Если точка, от которой
+ * ведётся отсчёт, удалена раньше, чем читатель прошёл следующую, положение находится по ссылке
+ * следующей точки на предыдущую (см. JournalManager::submitCheckpoint), когда все операции между
+ * ними уже прочитаны.
+ */
+class JournalReader {
+public:
+    // Обработчик операции (см. JournalManager::replayJournal)
+    using Handler = std::function<bool(const JournalEntryView &)>;
 
     /**
-     * @brief Перезаписывает журнал с новым набором записей
-     * @param entries Вектор записей для перезаписи
-     * @return true если перезапись выполнена успешно
+     * @brief Конструктор с указанием пути к файлу журнала (журнал не открывается)
+     * @param journalPath Путь к файлу журнала операций
+     * @param withCheckpoints Передавать ли обработчику записи пройденных контрольных точек
+     */
+    explicit JournalReader(const std::filesystem::path &journalPath,
+                           bool withCheckpoints = false);
+
+    /**
+     * @brief Деструктор, закрывает дескриптор журнала
+     */
+    ~JournalReader();
+
+    // Запрещаем копирование и перемещение
+    JournalReader(const JournalReader &) = delete;
+    JournalReader &operator=(const JournalReader &) = delete;
+    JournalReader(JournalReader &&) = delete;
+    JournalReader &operator=(JournalReader &&) = delete;
+
+    /**
+     * @brief Читает журнал с начала или с контрольной точки, передавая операции обработчику.
+     * Отсутствующий журнал считается пустым
+     * @param checkpointId Контрольная точка, после которой нужны операции (опционально)
+     * @param apply Обработчик операции (поля записи действительны только во время вызова)
+     * @param skipped Количество операций после контрольной точки, полученных ранее (обработчику
+     * не передаются)
+     * @return true если журнал прочитан и положение в нём найдено
+     */
+    bool open(const std::optional<std::string> &checkpointId, const Handler &apply,
+              uint64_t skipped = 0);
+
+    /**
+     * @brief Передаёт обработчику операции, записанные после предыдущего чтения
+     * @param apply Обработчик операции (поля записи действительны только во время вызова)
+     * @return true если журнал дочитан. false означает, что положение в журнале потеряно
+     * (например, после уплотнения журнала) и журнал нужно открыть заново
+     */
+    bool poll(const Handler &apply);
+
+    /**
+     * @brief Контрольная точка, от которой отсчитывается положение читателя
+     * @return Идентификатор (std::nullopt - журнал читается с начала)
+     */
+    const std::optional<std::string> &getCheckpointId() const { return checkpointId_; }
+
+    /**
+     * @brief Количество прочитанных операций после контрольной точки getCheckpointId
+     * @return Количество операций
+     */
+    uint64_t getOperationCount() const { return appliedCount_; }
+
+private:
+    // Путь к файлу журнала
+    const std::filesystem::path journalFilePath_;
+    // Путь к индексу смещений контрольных точек
+    const std::filesystem::path checkpointIndexPath_;
+    // Передавать ли обработчику записи контрольных точек
+    const bool withCheckpoints_;
+    // Контрольная точка, после которой читаются операции (последняя пройденная)
+    std::optional<std::string> checkpointId_;
+    // Дескриптор активного сегмента (-1, если журнала ещё нет)
+    int fd_ = -1;
+    // Смещение после последней полной записи активного сегмента
+    uint64_t offset_ = 0;
+    // Количество операций после контрольной точки, уже переданных обработчику
+    uint64_t appliedCount_ = 0;
+
+    /**
+     * @brief Заново разбирает журнал от контрольной точки, передавая обработчику только
+     * операции после первых appliedCount_, и запоминает положение в активном сегменте
+     * @param apply Обработчик операции
+     * @return true если журнал прочитан
+     */
+    bool rescan(const Handler &apply);
+
+    /**
+     * @brief Переносит отсчёт положения на пройденную контрольную точку
+     * @param entry Запись контрольной точки
+     * @param position Количество операций от прежней точки до новой (обнуляется)
+     * @param apply Обработчик, которому передаётся ещё не переданная контрольная точка
      */
-    bool rewriteJournal(const std::vector<JournalEntry> &entries);
+    void passCheckpoint(const JournalEntryView &entry, uint64_t &position, const Handler &apply);
 };
 } // namespace octet
@@ -0,0 +1,237 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <utility>
+
+#include "uuid.hpp"
+#include "value_allocator.hpp"
+
+namespace octet {
+/**
+ * @struct ValueLocation
+ * @brief Положение значения в журнале значений (см. ValueLog)
+ */
+struct ValueLocation {
+    uint32_t segment = 0; // Номер сегмента журнала значений
+    uint32_t offset = 0; // Смещение значения от начала сегмента
+    uint32_t size = 0; // Длина значения
+
+    bool operator==(const ValueLocation &other) const noexcept
+    {
+        return segment == other.segment && offset == other.offset && size == other.size;
+    }
+    bool operator!=(const ValueLocation &other) const noexcept { return !(*this == other); }
+};
+
+/**
+ * @class RecordValue
+ * @brief Значение записи размером 16 байт: короткие строки хранятся прямо в ячейке таблицы,
+ * длинные - в буфере, выделенном ValueAllocator способом ValueAllocator::defaultAllocation(), а
+ * значения, вынесенные в журнал значений, - как их положение в нём.
+ */
+class RecordValue {
+public:
+    // Максимальная длина строки, хранимой без выделения памяти
+    static constexpr size_t INLINE_CAPACITY = 15;
+
+    RecordValue() noexcept;
+    ~RecordValue();
+
+    RecordValue(const RecordValue &other);
+    RecordValue &operator=(const RecordValue &other);
+    RecordValue(RecordValue &&other) noexcept;
+    RecordValue &operator=(RecordValue &&other) noexcept;
+
+    /**
+     * @brief Заменяет значение (длина ограничена 4 ГБ, как и в формате журнала)
+     * @param value Новое значение
+     */
+    void assign(std::string_view value);
+
+    /**
+     * @brief Заменяет значение положением строки в журнале значений
+     * @param location Положение строки
+     */
+    void assignLocation(const ValueLocation &location) noexcept;
+
+    /**
+     * @brief Очищает значение, освобождая буфер в куче
+     */
+    void clear() noexcept;
+
+    /**
+     * @brief Возвращает представление хранимой строки
+     * @return Представление, действительное до следующего изменения значения (для значения в
+     * журнале значений - пустое)
+     */
+    std::string_view view() const noexcept;
+
+    /**
+     * @brief Возвращает положение строки в журнале значений
+     * @return Положение или std::nullopt, если строка хранится в памяти
+     */
+    std::optional<ValueLocation> location() const noexcept;
+
+    /**
+     * @brief Проверяет, хранится ли строка внутри значения
+     * @return true если строка не использует буфер в куче и не вынесена в журнал значений
+     */
+    bool isInline() const noexcept;
+
+private:
+    // Признаки в последнем байте (иначе там хранится длина строки внутри значения): буфер в куче
+    // и положение в журнале значений
+    static constexpr uint8_t HEAP_TAG = 0xFF;
+    static constexpr uint8_t VALUE_LOG_TAG = 0xFE;
+
+    // Смещение способа выделения буфера в куче
+    static constexpr size_t ALLOCATION_OFFSET = 12;
+
+    // Строка внутри значения: байты [0, 15) - данные, байт 15 - длина или признак.
+    // Буфер в куче: байты [0, 8) - указатель, байты [8, 12) - длина, байт 12 - ValueAllocation.
+    // Журнал значений: байты [0, 4) - сегмент, [4, 8) - смещение, [8, 12) - длина
+    alignas(8) char storage_[INLINE_CAPACITY + 1];
+
+    uint8_t tag() const noexcept { return static_cast<uint8_t>(storage_[INLINE_CAPACITY]); }
+    bool hasHeapBuffer() const noexcept { return tag() == HEAP_TAG; }
+    char *heapData() const noexcept;
+    uint32_t heapSize() const noexcept;
+    ValueAllocation heapAllocation() const noexcept;
+};
+
+/**
+ * @class RecordTable
+ * @brief Хэш-таблица с открытой адресацией для записей хранилища.
+ *
+ * Ячейки (ключ и значение по 16 байт) хранятся в одном непрерывном массиве, а отдельный массив
+ * управляющих байтов содержит по байту на ячейку: признак пустой или удалённой ячейки либо
+ * младшие 7 бит хэша ключа. Поиск просматривает управляющие байты группами по 16 (одной
+ * SIMD-инструкцией сравнения там, где она доступна) и сравнивает ключи только при совпадении
+ * байта, поэтому при поиске почти не происходит переходов по указателям.
+ *
+ * Таблица не потокобезопасна: синхронизацию обеспечивает владелец.
+ */
+class RecordTable {
+public:
+    // Количество ячеек в группе, просматриваемой одной операцией сравнения
+    static constexpr size_t GROUP_WIDTH = 16;
+
+    RecordTable() noexcept = default;
+    ~RecordTable() = default;
+
+    RecordTable(const RecordTable &other);
+    RecordTable &operator=(const RecordTable &other);
+    RecordTable(RecordTable &&other) noexcept;
+    RecordTable &operator=(RecordTable &&other) noexcept;
+
+    /**
+     * @brief Ищет значение записи
+     * @param key Ключ записи
+     * @return Указатель на значение (действителен до изменения таблицы) или nullptr
+     */
+    const RecordValue *find(const Uuid &key) const noexcept;
+    RecordValue *find(const Uuid &key) noexcept;
+
+    /**
+     * @brief Добавляет запись или заменяет значение существующей
+     * @param key Ключ записи
+     * @param value Значение записи
+     * @return true если запись добавлена, false если заменено значение существующей
+     */
+    bool insertOrAssign(const Uuid &key, std::string_view value);
+
+    /**
+     * @brief Находит значение записи, добавляя запись с пустым значением, если её нет
+     * @param key Ключ записи
+     * @return Указатель на значение (действителен до изменения таблицы) и признак добавления
+     */
+    std::pair<RecordValue *, bool> emplace(const Uuid &key);
+
+    /**
+     * @brief Удаляет запись
+     * @param key Ключ записи
+     * @return true если запись была удалена
+     */
+    bool erase(const Uuid &key) noexcept;
+
+    /**
+     * @brief Резервирует место для указанного количества записей
+     * @param count Количество записей
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Удаляет все записи и освобождает память
+     */
+    void clear() noexcept;
+
+    size_t size() const noexcept { return size_; }
+    bool empty() const noexcept { return size_ == 0; }
+    size_t capacity() const noexcept { return capacity_; }
+
+    /**
+     * @brief Обходит все записи таблицы в порядке ячеек
+     * @param func Функция с сигнатурой void(const Uuid &, std::string_view)
+     */
+    template <typename Func>
+    void forEach(Func &&func) const
+    {
+        forEachRecord([&func](const Uuid &key, const RecordValue &value) {
+            func(key, value.view());
+        });
+    }
+
+    /**
+     * @brief Обходит все записи таблицы в порядке ячеек вместе с их значениями (в том числе
+     * вынесенными в журнал значений)
+     * @param func Функция с сигнатурой void(const Uuid &, const RecordValue &)
+     */
+    template <typename Func>
+    void forEachRecord(Func &&func) const
+    {
+        for (size_t i = 0; i < capacity_; i++) {
+            if (control_[i] >= 0) {
+                func(slots_[i].key, slots_[i].value);
+            }
+        }
+    }
+
+private:
+    struct Slot {
+        Uuid key;
+        RecordValue value;
+    };
+
+    // Управляющие байты (capacity_ штук), значение >= 0 означает занятую ячейку
+    std::unique_ptr<int8_t[]> control_;
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_ = 0; // Степень двойки, кратная GROUP_WIDTH, или 0
+    size_t size_ = 0;
+    size_t growthLeft_ = 0; // Сколько ещё пустых ячеек можно занять без перестроения
+
+    /**
+     * @brief Ищет ячейку с ключом
+     * @param key Ключ записи
+     * @param hash Хэш ключа
+     * @return Индекс ячейки или capacity_, если ключ не найден
+     */
+    size_t findIndex(const Uuid &key, uint64_t hash) const noexcept;
+
+    /**
+     * @brief Ищет первую свободную (пустую или удалённую) ячейку в последовательности проб
+     * @param hash Хэш ключа
+     * @return Индекс ячейки
+     */
+    size_t findFreeIndex(uint64_t hash) const noexcept;
+
+    /**
+     * @brief Перестраивает таблицу с новым количеством ячеек, удаляя пометки удалённых ячеек
+     * @param newCapacity Новое количество ячеек
+     */
+    void rehash(size_t newCapacity);
+};
+} // namespace octet
@@ -0,0 +1,175 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <memory>
+#include <optional>
+#include <string>
+
+namespace octet {
+class JournalReader;
+class StorageManager;
+
+// Положение реплики в потоке репликации хранится в директории данных реплики
+inline constexpr char REPLICATION_POSITION_FILE_NAME[] = "octet-replica.position";
+
+/**
+ * @struct ReplicationPosition
+ * @brief Положение реплики в потоке репликации
+ */
+struct ReplicationPosition {
+    // Контрольная точка журнала источника, от которой ведётся отсчёт (последняя полученная)
+    std::string checkpointId;
+    uint64_t offset = 0; // Количество операций после контрольной точки, полученных репликой
+    // Номер следующей части состояния хранилища, пока оно передаётся (std::nullopt - состояние
+    // передано, и передаются операции журнала)
+    std::optional<uint32_t> part;
+
+    bool operator==(const ReplicationPosition &other) const noexcept
+    {
+        return checkpointId == other.checkpointId && offset == other.offset
+               && part == other.part;
+    }
+    bool operator!=(const ReplicationPosition &other) const noexcept
+    {
+        return !(*this == other);
+    }
+};
+
+/**
+ * @struct ReplicationChunk
+ * @brief Очередная порция потока репликации
+ */
+struct ReplicationChunk {
+    // Сериализованные записи журнала, включая контрольные точки (см. JournalEntry::serialize)
+    std::string records;
+    ReplicationPosition next; // Положение реплики после применения записей
+    // Начинает ли порция состояние хранилища, которое заменит все записи реплики
+    bool reset = false;
+};
+
+/**
+ * @class ReplicationSource
+ * @brief Формирует поток репликации хранилища для одной реплики.
+ *
+ * Реплика запрашивает порции, передавая положение, полученное с предыдущей порцией. Новой
+ * реплике, а также реплике, положение которой больше нет в журнале (например, после уплотнения
+ * журнала), сначала по частям передаётся состояние хранилища (см. StorageManager::exportPart), а
+ * затем операции журнала после контрольной точки, запомненной до начала передачи. Части
+ * читаются, пока писатели продолжают изменять хранилище, поэтому операции, уже попавшие в
+ * переданные части, могут быть переданы ещё раз: их повторное применение
+ * (StorageManager::applyReplicated) приводит реплику к тому же состоянию.
+ *
+ * Журнал читается через JournalReader, поэтому следующая порция дочитывает только новые записи.
+ * Записи контрольных точек передаются в потоке вместе с операциями, и положение реплики после
+ * такой записи отсчитывается уже от этой точки: реплика, не отставшая от журнала, продолжает
+ * поток и после его уплотнения. Источник не потокобезопасен.
+ */
+class ReplicationSource {
+public:
+    /**
+     * @brief Конструктор
+     * @param storage Реплицируемое хранилище
+     */
+    explicit ReplicationSource(StorageManager &storage);
+
+    /**
+     * @brief Деструктор, закрывает журнал
+     */
+    ~ReplicationSource();
+
+    // Запрещаем копирование и перемещение
+    ReplicationSource(const ReplicationSource &) = delete;
+    ReplicationSource &operator=(const ReplicationSource &) = delete;
+    ReplicationSource(ReplicationSource &&) = delete;
+    ReplicationSource &operator=(ReplicationSource &&) = delete;
+
+    /**
+     * @brief Читает очередную порцию потока репликации
+     * @param from Положение реплики (std::nullopt - передать состояние хранилища заново)
+     * @param maxBytes Желаемый размер записей порции журнала (часть состояния передаётся
+     * целиком, а одна запись - даже если она больше)
+     * @param[out] chunk Порция (без записей, если новых операций нет)
+     * @return true если порция прочитана
+     */
+    bool read(const std::optional<ReplicationPosition> &from, size_t maxBytes,
+              ReplicationChunk &chunk);
+
+private:
+    StorageManager &storage_;
+    // Читатель журнала хранилища
+    std::unique_ptr<JournalReader> reader_;
+    // Положение реплики после операций, предшествующих pending_
+    std::optional<ReplicationPosition> position_;
+    // Прочитанные из журнала, но ещё не переданные записи
+    std::string pending_;
+
+    /**
+     * @brief Начинает передачу состояния хранилища заново
+     * @param[out] chunk Порция с первой частью состояния
+     * @return true если положение в журнале запомнено и часть прочитана
+     */
+    bool resync(ReplicationChunk &chunk);
+
+    /**
+     * @brief Открывает журнал от контрольной точки, пропуская уже полученные репликой операции
+     * @param from Положение реплики
+     * @return true если положение найдено в журнале
+     */
+    bool openJournal(const ReplicationPosition &from);
+
+    /**
+     * @brief Передаёт в порцию начало прочитанных записей
+     * @param maxBytes Желаемый размер записей
+     * @param[out] chunk Порция
+     */
+    void takePending(size_t maxBytes, ReplicationChunk &chunk);
+};
+
+/**
+ * @class ReplicationTarget
+ * @brief Применяет поток репликации к хранилищу реплики и сохраняет положение реплики.
+ *
+ * Положение записывается в директорию данных реплики после фиксации записей порции в её журнале,
+ * поэтому после перезапуска реплика продолжает поток с сохранённого положения, а операции,
+ * применённые до сбоя, но не учтённые в положении, применяются повторно. Пока передаётся
+ * состояние хранилища, сохраняется пустое положение: прерванная передача начинается заново.
+ * Части состояния собираются отдельно от содержимого хранилища (см.
+ * StorageManager::beginStaging) и заменяют его только после последней части, поэтому во время
+ * передачи реплика отвечает прежним содержимым.
+ */
+class ReplicationTarget {
+public:
+    /**
+     * @brief Конструктор, загружает сохранённое положение реплики
+     * @param storage Хранилище реплики
+     * @param dataDir Директория данных хранилища реплики
+     */
+    ReplicationTarget(StorageManager &storage, const std::filesystem::path &dataDir);
+
+    /**
+     * @brief Возвращает положение реплики для запроса следующей порции
+     * @return Положение или std::nullopt, если состояние хранилища нужно получить заново
+     */
+    const std::optional<ReplicationPosition> &getPosition() const;
+
+    /**
+     * @brief Применяет порцию потока репликации
+     * @param chunk Порция, полученная в ответ на запрос с положением getPosition
+     * @return true если порция применена и положение обновлено
+     */
+    bool apply(const ReplicationChunk &chunk);
+
+private:
+    StorageManager &storage_;
+    const std::filesystem::path positionPath_;
+    std::optional<ReplicationPosition> position_;
+
+    /**
+     * @brief Сохраняет положение реплики на диске
+     * @return true если положение записано
+     */
+    bool savePosition() const;
+};
+} // namespace octet
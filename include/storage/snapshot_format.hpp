@@ -0,0 +1,360 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "storage/record_table.hpp"
+#include "storage/uuid.hpp"
+#include "utils/byte_order.hpp"
+#include "utils/compression.hpp"
+#include "utils/crc32c.hpp"
+
+// Формат файлов снапшотов, общий для StorageManager (запись и загрузка) и StorageReader (чтение
+// без загрузки значений в память)
+namespace octet {
+inline constexpr char SNAPSHOT_FILE_NAME[] = "octet-data.snapshot";
+inline constexpr char JOURNAL_FILE_NAME[] = "octet-operations.journal";
+// Счётчики поколений хранилища в разделяемой памяти (см. StorageGeneration)
+inline constexpr char GENERATION_FILE_NAME[] = "octet-storage.generation";
+// Разностные снапшоты хранятся рядом с базовым: "<снапшот>.delta.<номер>"
+inline constexpr char DELTA_SNAPSHOT_SUFFIX[] = ".delta.";
+inline constexpr size_t DELTA_SNAPSHOT_NUMBER_WIDTH = 6;
+// Сегменты журнала значений: "<журнал значений>.<номер>" (см. ValueLog)
+inline constexpr char VALUE_LOG_FILE_NAME[] = "octet-data.values";
+
+// Формат снапшота v2:
+//   заголовок: сигнатура "OCTSNAP2", версия (u32), флаги (u32, младший байт - алгоритм сжатия
+//              CompressionCodec, бит SNAPSHOT_FLAG_DELTA - разностный снапшот, бит
+//              SNAPSHOT_FLAG_VALUE_LOG - записи могут ссылаться на журнал значений), длина
+//              идентификатора контрольной точки (u32), идентификатор, у разностного снапшота
+//              также длина и идентификатор контрольной точки предыдущего снапшота цепочки,
+//              CRC32C заголовка (u32);
+//   блоки записей: запись - 16 байт UUID, длина значения (u32), значение. Запись разностного
+//                  снапшота и снапшота с флагом SNAPSHOT_FLAG_VALUE_LOG начинается с вида записи
+//                  (u8): у удаления нет длины и значения, а у значения в журнале значений вместо
+//                  него записаны номер сегмента (u32) и смещение (u32).
+//                  Сжатый блок хранится как размер исходного блока (u64) и сжатые данные;
+//   индекс блоков: для каждого блока смещение (u64), размер (u64), количество записей (u32) и
+//                  CRC32C блока (u32);
+//   итоговый блок фиксированного размера: смещение индекса (u64), количество записей (u64),
+//              количество блоков (u32), CRC32C индекса (u32), CRC32C итогового блока (u32) и
+//              сигнатура (u32).
+// Все числа записываются в представлении little-endian. Благодаря индексу блоки разбираются
+// параллельно прямо из отображенного в память файла, а повреждение одного блока не затрагивает
+// остальные
+inline constexpr char SNAPSHOT_MAGIC[] = "OCTSNAP2";
+inline constexpr size_t SNAPSHOT_MAGIC_SIZE = sizeof(SNAPSHOT_MAGIC) - 1;
+inline constexpr uint32_t SNAPSHOT_FORMAT_VERSION = 2;
+inline constexpr uint32_t SNAPSHOT_FOOTER_MAGIC = 0x58444E49; // "INDX"
+
+// Размер заголовка без идентификатора контрольной точки и контрольной суммы
+inline constexpr size_t SNAPSHOT_HEADER_FIXED_SIZE = SNAPSHOT_MAGIC_SIZE + 3 * sizeof(uint32_t);
+// Размер описания блока в индексе
+inline constexpr size_t SNAPSHOT_INDEX_ENTRY_SIZE = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+// Размер итогового блока и его части, покрываемой контрольной суммой
+inline constexpr size_t SNAPSHOT_FOOTER_CRC_OFFSET = 2 * sizeof(uint64_t) + 2 * sizeof(uint32_t);
+inline constexpr size_t SNAPSHOT_FOOTER_SIZE = SNAPSHOT_FOOTER_CRC_OFFSET + 2 * sizeof(uint32_t);
+// Размер записи без значения
+inline constexpr size_t SNAPSHOT_ENTRY_HEADER_SIZE = 16 + sizeof(uint32_t);
+// Минимальный размер записи с видом записи (удаление)
+inline constexpr size_t SNAPSHOT_TAGGED_ENTRY_MIN_SIZE = sizeof(uint8_t) + 16;
+// Биты флагов, в которых записан алгоритм сжатия блоков
+inline constexpr uint32_t SNAPSHOT_CODEC_MASK = 0xFF;
+// Флаг разностного снапшота: записаны только изменения после предыдущего снапшота цепочки
+inline constexpr uint32_t SNAPSHOT_FLAG_DELTA = 0x100;
+// Флаг снапшота, записи которого могут хранить положение значения в журнале значений
+inline constexpr uint32_t SNAPSHOT_FLAG_VALUE_LOG = 0x200;
+
+// Вид записи разностного снапшота и снапшота с флагом SNAPSHOT_FLAG_VALUE_LOG
+inline constexpr uint8_t SNAPSHOT_ENTRY_UPSERT = 0;
+inline constexpr uint8_t SNAPSHOT_ENTRY_REMOVE = 1;
+inline constexpr uint8_t SNAPSHOT_ENTRY_LOCATION = 2;
+
+// Примерный размер блока записей: блок закрывается после записи, с которой он превысил размер
+inline constexpr size_t SNAPSHOT_BLOCK_SIZE = 1024 * 1024;
+
+// Метка, после которой в конце снапшота прежнего формата записан идентификатор его контрольной
+// точки. Снапшоты прежнего формата по-прежнему загружаются, но записываются только в формате v2
+inline constexpr uint32_t SNAPSHOT_CHECKPOINT_MAGIC = 0x5450434F; // "OCPT"
+
+/**
+ * @struct SnapshotBlockInfo
+ * @brief Описание блока записей из индекса снапшота
+ */
+struct SnapshotBlockInfo {
+    uint64_t offset; // Смещение блока от начала файла
+    uint64_t size; // Размер блока в байтах
+    uint32_t entryCount; // Количество записей в блоке
+    uint32_t crc; // Контрольная сумма CRC32C блока
+};
+
+/**
+ * @struct SnapshotLayout
+ * @brief Разобранная структура снапшота формата v2
+ */
+struct SnapshotLayout {
+    std::string_view checkpointId; // Контрольная точка снапшота (ссылается на данные файла)
+    std::string_view baseCheckpointId; // Контрольная точка предыдущего снапшота цепочки
+    uint32_t flags = 0; // Флаги формата
+    uint64_t entryCount = 0; // Общее количество записей
+    std::vector<SnapshotBlockInfo> blocks; // Блоки записей в порядке их следования
+};
+
+/**
+ * @brief Формирует путь к разностному снапшоту
+ * @param snapshotPath Путь к файлу базового снапшота
+ * @param number Порядковый номер разностного снапшота в цепочке
+ * @return Путь к файлу разностного снапшота
+ */
+std::filesystem::path deltaSnapshotPath(const std::filesystem::path &snapshotPath, uint64_t number);
+
+/**
+ * @brief Находит разностные снапшоты
+ * @param snapshotPath Путь к файлу базового снапшота
+ * @return Пары из номера и пути к файлу в порядке возрастания номеров
+ */
+std::vector<std::pair<uint64_t, std::filesystem::path>>
+listDeltaSnapshots(const std::filesystem::path &snapshotPath);
+
+/**
+ * @brief Проверяет, записан ли снапшот в формате v2
+ * @param content Содержимое файла снапшота
+ * @return true, если файл начинается с сигнатуры формата v2
+ */
+bool isVersionedSnapshot(std::string_view content);
+
+/**
+ * @brief Разбирает заголовок, индекс и итоговый блок снапшота формата v2 (содержимое блоков
+ * записей не проверяется)
+ * @param content Содержимое файла снапшота
+ * @param[out] layout Структура снапшота
+ * @return true, если служебные части снапшота не повреждены
+ */
+bool parseSnapshotLayout(std::string_view content, SnapshotLayout &layout);
+
+/**
+ * @brief Проверяет, что разобранный снапшот можно применить: флаги известны, вид снапшота
+ * (базовый или разностный) ожидаемый, разностный снапшот продолжает нужную цепочку, а алгоритм
+ * сжатия поддерживается сборкой
+ * @param layout Структура снапшота
+ * @param baseCheckpointId Для разностного снапшота - контрольная точка, на которой должна
+ * заканчиваться уже загруженная часть цепочки, для базового - std::nullopt
+ * @param[out] codec Алгоритм сжатия блоков снапшота
+ * @return true, если снапшот можно применить
+ */
+bool checkSnapshotLayout(const SnapshotLayout &layout,
+                         const std::optional<std::string> &baseCheckpointId,
+                         CompressionCodec &codec);
+
+/**
+ * @brief Проверяет контрольную сумму блока снапшота и при необходимости распаковывает его
+ * @param content Содержимое файла снапшота
+ * @param block Описание блока из индекса
+ * @param codec Алгоритм сжатия блоков снапшота
+ * @param[out] decompressed Буфер для распакованного блока (используется только для сжатого)
+ * @param[out] data Данные блока: часть content или decompressed
+ * @return true, если блок не повреждён
+ */
+bool readSnapshotBlock(std::string_view content, const SnapshotBlockInfo &block,
+                       CompressionCodec codec, std::string &decompressed, std::string_view &data);
+
+/**
+ * @brief Разбирает записи блока снапшота формата v2
+ * @param block Данные блока
+ * @param entryCount Количество записей в блоке по индексу
+ * @param flags Флаги формата снапшота
+ * @param handler Обработчик записи с сигнатурой
+ * void(const Uuid &, std::string_view, bool, const ValueLocation *): значение ссылается на данные
+ * блока, третий аргумент - удаление записи, четвёртый - положение значения в журнале значений
+ * (тогда значение пустое) или nullptr
+ * @return true, если блок содержит ровно указанное количество корректных записей
+ */
+template <typename Handler>
+bool decodeSnapshotBlock(std::string_view block, uint32_t entryCount, uint32_t flags,
+                         Handler &&handler)
+{
+    const bool tagged = (flags & (SNAPSHOT_FLAG_DELTA | SNAPSHOT_FLAG_VALUE_LOG)) != 0;
+    const bool delta = (flags & SNAPSHOT_FLAG_DELTA) != 0;
+    const bool valueLog = (flags & SNAPSHOT_FLAG_VALUE_LOG) != 0;
+    const auto *ptr = block.data();
+    const auto *end = ptr + block.size();
+    for (uint32_t i = 0; i < entryCount; i++) {
+        auto kind = SNAPSHOT_ENTRY_UPSERT;
+        if (tagged) {
+            if (ptr == end) {
+                return false;
+            }
+            kind = static_cast<uint8_t>(*ptr++);
+            if ((kind == SNAPSHOT_ENTRY_REMOVE && !delta)
+                || (kind == SNAPSHOT_ENTRY_LOCATION && !valueLog)
+                || kind > SNAPSHOT_ENTRY_LOCATION) {
+                return false;
+            }
+        }
+        const bool removed = kind == SNAPSHOT_ENTRY_REMOVE;
+        if (static_cast<size_t>(end - ptr) < (removed ? 16 : SNAPSHOT_ENTRY_HEADER_SIZE)) {
+            return false;
+        }
+        const auto key = Uuid::fromBytes(ptr);
+        if (removed) {
+            handler(key, std::string_view(), true, nullptr);
+            ptr += 16;
+            continue;
+        }
+        const auto valueSize = utils::loadLittleEndian<uint32_t>(ptr + 16);
+        ptr += SNAPSHOT_ENTRY_HEADER_SIZE;
+        if (kind == SNAPSHOT_ENTRY_LOCATION) {
+            if (static_cast<size_t>(end - ptr) < 2 * sizeof(uint32_t)) {
+                return false;
+            }
+            const ValueLocation location{ utils::loadLittleEndian<uint32_t>(ptr),
+                                          utils::loadLittleEndian<uint32_t>(ptr + 4), valueSize };
+            handler(key, std::string_view(), false, &location);
+            ptr += 2 * sizeof(uint32_t);
+            continue;
+        }
+        if (valueSize > static_cast<size_t>(end - ptr)) {
+            return false;
+        }
+        handler(key, std::string_view(ptr, valueSize), false, nullptr);
+        ptr += valueSize;
+    }
+    return ptr == end;
+}
+
+/**
+ * @brief Сериализует записи в формате снапшота v2, передавая данные по блокам (функция не
+ * использует логгер, так как вызывается и в дочернем процессе)
+ * @param checkpointId Контрольная точка, соответствующая снапшоту
+ * @param baseCheckpointId Контрольная точка предыдущего снапшота цепочки для разностного
+ * снапшота или nullptr для полного
+ * @param codec Алгоритм сжатия блоков
+ * @param valueLog Могут ли записи ссылаться на журнал значений (флаг SNAPSHOT_FLAG_VALUE_LOG)
+ * @param forEachEntry Источник записей, вызывающий переданную ему функцию с сигнатурой
+ * void(const Uuid &, std::string_view, bool, const ValueLocation * = nullptr) для каждой записи
+ * (третий аргумент - удаление, четвёртый - положение значения в журнале значений)
+ * @param write Приёмник данных с сигнатурой bool(const char *, size_t), возвращающий false при
+ * ошибке записи
+ * @return true, если все данные переданы приёмнику
+ */
+template <typename ForEachEntry, typename Write>
+bool writeSnapshotEntries(const std::string &checkpointId, const std::string *baseCheckpointId,
+                          CompressionCodec codec, bool valueLog, ForEachEntry &&forEachEntry,
+                          Write &&write)
+{
+    using utils::appendLittleEndian;
+
+    // Заголовок с контрольной точкой снапшота
+    const bool delta = baseCheckpointId != nullptr;
+    const bool tagged = delta || valueLog;
+    std::string buffer;
+    buffer.reserve(SNAPSHOT_BLOCK_SIZE + SNAPSHOT_BLOCK_SIZE / 4);
+    buffer.append(SNAPSHOT_MAGIC, SNAPSHOT_MAGIC_SIZE);
+    appendLittleEndian<uint32_t>(buffer, SNAPSHOT_FORMAT_VERSION);
+    appendLittleEndian<uint32_t>(
+        buffer, static_cast<uint32_t>(codec) | (delta ? SNAPSHOT_FLAG_DELTA : 0)
+                    | (valueLog ? SNAPSHOT_FLAG_VALUE_LOG : 0)); // флаги
+    appendLittleEndian<uint32_t>(buffer, static_cast<uint32_t>(checkpointId.size()));
+    buffer.append(checkpointId);
+    if (delta) {
+        appendLittleEndian<uint32_t>(buffer, static_cast<uint32_t>(baseCheckpointId->size()));
+        buffer.append(*baseCheckpointId);
+    }
+    appendLittleEndian<uint32_t>(buffer, utils::crc32c(buffer.data(), buffer.size()));
+    uint64_t offset = buffer.size();
+    if (!write(buffer.data(), buffer.size())) {
+        return false;
+    }
+    buffer.clear();
+
+    // Блоки записей (ключи в двоичном представлении UUID)
+    std::vector<SnapshotBlockInfo> blocks;
+    uint64_t entryCount = 0;
+    uint32_t blockEntries = 0;
+    bool success = true;
+    std::string compressed;
+    auto flushBlock = [&] {
+        if (blockEntries == 0 || !success) {
+            return;
+        }
+        std::string_view stored = buffer;
+        if (codec != CompressionCodec::NONE) {
+            std::string payload;
+            success = utils::compressBlock(codec, buffer, payload);
+            compressed.clear();
+            appendLittleEndian<uint64_t>(compressed, buffer.size());
+            compressed += payload;
+            stored = compressed;
+        }
+        const auto crc = utils::crc32c(stored.data(), stored.size());
+        blocks.push_back({ offset, stored.size(), blockEntries, crc });
+        success = success && write(stored.data(), stored.size());
+        offset += stored.size();
+        buffer.clear();
+        blockEntries = 0;
+    };
+    forEachEntry([&](const Uuid &key, std::string_view value, bool removed,
+                     const ValueLocation *location = nullptr) {
+        if (tagged) {
+            buffer.push_back(static_cast<char>(removed               ? SNAPSHOT_ENTRY_REMOVE
+                                               : location != nullptr ? SNAPSHOT_ENTRY_LOCATION
+                                                                     : SNAPSHOT_ENTRY_UPSERT));
+        }
+        const auto &bytes = key.bytes();
+        buffer.append(reinterpret_cast<const char *>(bytes.data()), bytes.size());
+        if (location != nullptr) {
+            appendLittleEndian<uint32_t>(buffer, location->size);
+            appendLittleEndian<uint32_t>(buffer, location->segment);
+            appendLittleEndian<uint32_t>(buffer, location->offset);
+        }
+        else if (!removed) {
+            appendLittleEndian<uint32_t>(buffer, static_cast<uint32_t>(value.size()));
+            buffer.append(value.data(), value.size());
+        }
+        blockEntries++;
+        entryCount++;
+        if (buffer.size() >= SNAPSHOT_BLOCK_SIZE) {
+            flushBlock();
+        }
+    });
+    flushBlock();
+    if (!success) {
+        return false;
+    }
+
+    // Индекс блоков и итоговый блок
+    std::string tail;
+    tail.reserve(blocks.size() * SNAPSHOT_INDEX_ENTRY_SIZE + SNAPSHOT_FOOTER_SIZE);
+    for (const auto &block : blocks) {
+        appendLittleEndian<uint64_t>(tail, block.offset);
+        appendLittleEndian<uint64_t>(tail, block.size);
+        appendLittleEndian<uint32_t>(tail, block.entryCount);
+        appendLittleEndian<uint32_t>(tail, block.crc);
+    }
+    const auto indexCrc = utils::crc32c(tail.data(), tail.size());
+    const auto footerStart = tail.size();
+    appendLittleEndian<uint64_t>(tail, offset);
+    appendLittleEndian<uint64_t>(tail, entryCount);
+    appendLittleEndian<uint32_t>(tail, static_cast<uint32_t>(blocks.size()));
+    appendLittleEndian<uint32_t>(tail, indexCrc);
+    appendLittleEndian<uint32_t>(
+        tail, utils::crc32c(tail.data() + footerStart, SNAPSHOT_FOOTER_CRC_OFFSET));
+    appendLittleEndian<uint32_t>(tail, SNAPSHOT_FOOTER_MAGIC);
+    return write(tail.data(), tail.size());
+}
+
+/**
+ * @brief Разбирает снапшот прежнего формата
+ * @param buf Содержимое файла снапшота
+ * @param[out] checkpointId Контрольная точка, соответствующая снапшоту (если она в нём сохранена)
+ * @return Записи снапшота или std::nullopt, если данные повреждены
+ */
+std::optional<std::unordered_map<std::string, std::string>>
+deserializeLegacySnapshot(std::string_view buf, std::optional<std::string> &checkpointId);
+} // namespace octet
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+
+namespace octet {
+/**
+ * @class StorageGeneration
+ * @brief Счётчики поколений хранилища в разделяемой памяти.
+ *
+ * Файл со счётчиками отображается в память всех процессов, работающих с одной директорией
+ * данных (MAP_SHARED), поэтому изменение счётчика писателем сразу видно читателям без обращения к
+ * файловой системе. Счётчик журнала увеличивается после каждой записи пакета в журнал, счётчик
+ * снапшотов - после замены базового снапшота. Читатели сравнивают счётчики с последними
+ * увиденными значениями и обращаются к журналу или снапшоту только при их изменении.
+ *
+ * Если файл не удалось открыть для записи, он отображается только для чтения, а если не удалось
+ * отобразить совсем - счётчики всегда равны нулю, а их увеличение ничего не делает.
+ */
+class StorageGeneration {
+public:
+    /**
+     * @brief Конструктор, открывает (при необходимости создаёт) и отображает файл счётчиков
+     * @param filePath Путь к файлу счётчиков (родительская директория создаётся при
+     * необходимости)
+     */
+    explicit StorageGeneration(const std::filesystem::path &filePath);
+
+    /**
+     * @brief Деструктор, освобождает отображение
+     */
+    ~StorageGeneration();
+
+    // Запрещаем копирование и перемещение
+    StorageGeneration(const StorageGeneration &) = delete;
+    StorageGeneration &operator=(const StorageGeneration &) = delete;
+    StorageGeneration(StorageGeneration &&) = delete;
+    StorageGeneration &operator=(StorageGeneration &&) = delete;
+
+    /**
+     * @brief Проверяет, удалось ли отобразить файл счётчиков
+     * @return true, если счётчики находятся в разделяемой памяти
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief Возвращает счётчик записей в журнал
+     * @return Значение счётчика (0, если файл не отображен)
+     */
+    uint64_t journal() const;
+
+    /**
+     * @brief Возвращает счётчик замен базового снапшота
+     * @return Значение счётчика (0, если файл не отображен)
+     */
+    uint64_t snapshot() const;
+
+    /**
+     * @brief Увеличивает счётчик записей в журнал (если файл отображен для записи)
+     */
+    void advanceJournal();
+
+    /**
+     * @brief Увеличивает счётчик замен базового снапшота (если файл отображен для записи)
+     */
+    void advanceSnapshot();
+
+private:
+    // Расположение счётчиков в файле (определено в storage_generation.cpp)
+    struct Counters;
+
+    // Отображенные счётчики (nullptr, если файл не отображен)
+    Counters *counters_ = nullptr;
+    // Отображены ли счётчики для записи
+    bool writable_ = false;
+};
+} // namespace octet
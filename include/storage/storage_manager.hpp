@@ -1,33 +1,89 @@
 #pragma once
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <condition_variable>
 #include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <shared_mutex>
 #include <string>
 #include <thread>
-#include <unordered_map>
+#include <string_view>
+#include <unordered_set>
+#include <vector>
 
 #include "journal_manager.hpp"
+#include "record_table.hpp"
+#include "storage_generation.hpp"
 #include "uuid_generator.hpp"
+#include "value_log.hpp"
 
 namespace octet {
+/**
+ * @enum SnapshotMode
+ * @brief Способы создания снапшота.
+ *
+ * В обоих режимах состояние снапшота фиксируется под разделяемыми блокировками всех сегментов
+ * хранилища вместе с резервированием номера контрольной точки в журнале, поэтому снапшот содержит
+ * ровно операции до контрольной точки.
+ */
+enum class SnapshotMode : uint8_t {
+    COPY, // Данные копируются в памяти и записываются на диск в текущем процессе
+    FORK // Дочерний процесс записывает на диск образ памяти родителя (копирование при записи)
+};
+
+/**
+ * @struct BatchOperation
+ * @brief Операция пакета, применяемого через StorageManager::applyBatch
+ */
+struct BatchOperation {
+    OperationType type; // INSERT, UPDATE или REMOVE
+    std::string uuid; // Идентификатор строки (для UPDATE и REMOVE)
+    std::string data; // Данные (для INSERT и UPDATE)
+};
+
 /**
  * @class StorageManager
  * @brief Управляет хранением UTF-8 строк и их идентификаторов.
  *
  * Реализует гибридное хранилище с данными в памяти и постоянное хранение на диске.
  * Обеспечивает базовые операции вставки, получения, обновления и удаления.
+ *
+ * Данные в памяти разделены на сегменты (shards) по хэшу UUID, у каждого из которых своя
+ * блокировка, поэтому операции с разными записями не конкурируют за одну блокировку. Записи
+ * сегмента хранятся в хэш-таблице с открытой адресацией по двоичному представлению UUID. Изменение
+ * данных и резервирование номера записи журнала выполняются под блокировкой сегмента, а сама
+ * запись ставится в очередь журнала уже после её снятия: журнал упорядочивает записи по номерам.
+ *
+ * Снапшоты образуют цепочку: полный (базовый) снапшот и следующие за ним разностные снапшоты, в
+ * которые записываются только записи, изменённые после предыдущего снапшота цепочки. Поэтому
+ * стоимость автоматического снапшота определяется объёмом недавних изменений, а не размером
+ * хранилища. Когда разностных снапшотов становится слишком много, фоновый поток объединяет цепочку,
+ * записывая новый базовый снапшот.
+ *
+ * В режиме ограниченной памяти (ValueLogPolicy::minValueSize) длинные значения дописываются в
+ * журнал значений на диске, а в памяти остаются только ключи, положения значений и короткие
+ * значения, поэтому объём хранилища ограничен диском, а не памятью. Снапшоты таких записей
+ * сохраняют только положение значения. Часто читаемые значения обслуживаются кэшем журнала
+ * значений, а сегменты, значения которых в основном устарели, уплотняются фоновым потоком.
  */
 class StorageManager {
 public:
     /**
      * @brief Конструктор с указанием путей к файлам хранилища
      * @param dataDir Директория для хранения файлов
+     * @param durability Политика фиксации операций на диске (по умолчанию групповой коммит,
+     * семантика режимов описана в DurabilityMode)
+     * @param valueLog Параметры журнала значений (по умолчанию все значения хранятся в памяти)
      */
-    explicit StorageManager(const std::filesystem::path &dataDir);
+    explicit StorageManager(const std::filesystem::path &dataDir,
+                            DurabilityPolicy durability
+                            = DurabilityPolicy{ DurabilityMode::GROUP_COMMIT },
+                            ValueLogPolicy valueLog = ValueLogPolicy{});
 
     /**
      * @brief Деструктор, гарантирующий корректное закрытие ресурсов
@@ -41,33 +97,163 @@ public:
     StorageManager &operator=(StorageManager &&) = delete;
 
     /**
-     * @brief Добавляет UTF-8 строку в хранилище
+     * @brief Добавляет UTF-8 строку в хранилище. Данные копируются только в память хранилища и в
+     * запись журнала, поэтому их можно передавать из любого буфера без промежуточной std::string
      * @param data Строка данных для сохранения
      * @return UUID для добавленной строки или std::nullopt при ошибке
      */
-    std::optional<std::string> insert(const std::string &data);
+    std::optional<std::string> insert(std::string_view data);
 
     /**
      * @brief Извлекает строку по её идентификатору
      * @param uuid Уникальный идентификатор строки
-     * @return Сохранённая строка данных или std::nullopt, если не найдена
+     * @return Копия сохранённой строки данных или std::nullopt, если не найдена
      */
-    std::optional<std::string> get(const std::string &uuid) const;
+    std::optional<std::string> get(std::string_view uuid) const;
+
+    /**
+     * @brief Передаёт обработчику строку по её идентификатору без копирования. Обработчик
+     * вызывается под разделяемой блокировкой сегмента, поэтому он должен быть коротким и не
+     * должен обращаться к хранилищу на запись
+     * @param uuid Уникальный идентификатор строки
+     * @param reader Обработчик, получающий представление строки, действительное только во время
+     * вызова
+     * @return true если строка найдена и передана обработчику
+     */
+    bool read(std::string_view uuid, const std::function<void(std::string_view)> &reader) const;
 
     /**
      * @brief Обновляет существующую строку новыми данными
      * @param uuid Уникальный идентификатор строки для обновления
-     * @param data Новые данные для сохранения
+     * @param data Новые данные для сохранения (копируются так же, как в insert)
      * @return true если обновление выполнено успешно или false при ошибке
      */
-    bool update(const std::string &uuid, const std::string &data);
+    bool update(std::string_view uuid, std::string_view data);
 
     /**
      * @brief Удаляет строку из хранилища
      * @param uuid Уникальный идентификатор строки для удаления
      * @return true если удаление выполнено успешно или false при ошибке
      */
-    bool remove(const std::string &uuid);
+    bool remove(std::string_view uuid);
+
+    /**
+     * @brief Добавляет несколько строк в хранилище одним пакетом (см. applyBatch)
+     * @param data Строки данных для сохранения
+     * @return UUID добавленных строк в порядке строк или std::nullopt при ошибке (тогда не
+     * добавлена ни одна строка)
+     */
+    std::optional<std::vector<std::string>> insertBatch(const std::vector<std::string> &data);
+
+    /**
+     * @brief Извлекает несколько строк, захватывая блокировку каждого затронутого сегмента один
+     * раз
+     * @param uuids Идентификаторы строк
+     * @return Строки в порядке идентификаторов (std::nullopt для ненайденных)
+     */
+    std::vector<std::optional<std::string>> getMany(const std::vector<std::string> &uuids) const;
+
+    /**
+     * @brief Применяет пакет операций: блокировка каждого затронутого сегмента захватывается один
+     * раз, операции записываются в журнал одним пакетом с одной фиксацией на диске, а порог
+     * снапшота учитывает все операции пакета сразу. Пакет применяется целиком или не применяется
+     * совсем: если UPDATE или REMOVE (с учётом предыдущих операций пакета) относятся к
+     * несуществующей записи, хранилище не изменяется, а если пакет не зафиксирован в журнале,
+     * его изменения откатываются (кроме записей, уже изменённых следующими писателями)
+     * @param operations Операции пакета в порядке их применения
+     * @return UUID записей в порядке операций (для INSERT - новые) или std::nullopt при ошибке
+     */
+    std::optional<std::vector<std::string>>
+    applyBatch(const std::vector<BatchOperation> &operations);
+
+    /**
+     * @brief Резервирует место под новые записи во всех сегментах хранилища, чтобы загрузка
+     * большого числа записей не перестраивала таблицы по мере роста
+     * @param count Ожидаемое количество новых записей
+     */
+    void reserve(size_t count);
+
+    /**
+     * @brief Загружает строки без записи каждой операции в журнал: ключи генерируются, а записи
+     * распределяются по сегментам хранилища в нескольких потоках, и загрузка не приближает
+     * снапшот по порогу операций. Записи попадают на диск только со снапшотом, поэтому после
+     * загрузки (одним или несколькими вызовами) нужно вызвать finishImport, а до этого
+     * загруженные записи теряются при сбое
+     * @param values Строки данных
+     * @param[out] keys Ключи записей в порядке строк (nullptr - ключи не нужны)
+     * @return true если загружены все строки (при ошибке журнала значений часть строк может
+     * остаться загруженной)
+     */
+    bool importValues(const std::vector<std::string_view> &values,
+                      std::vector<Uuid> *keys = nullptr);
+
+    /**
+     * @brief Завершает загрузку строк: записывает полный снапшот с контрольной точкой, которая
+     * начинает новый сегмент журнала, и удаляет прежние сегменты (см. compactJournal)
+     * @return true если снапшот записан
+     */
+    bool finishImport();
+
+    /**
+     * @brief Возвращает количество частей, на которые делится состояние хранилища при его
+     * передаче реплике (см. exportPart)
+     * @return Количество частей
+     */
+    static size_t getExportPartCount();
+
+    /**
+     * @brief Дописывает записи одной части хранилища в буфер как операции INSERT журнала. Часть
+     * читается под разделяемой блокировкой её сегмента, поэтому части передаются реплике по
+     * очереди, не останавливая писателей всего хранилища
+     * @param part Номер части (меньше getExportPartCount)
+     * @param[out] records Буфер для записей
+     */
+    void exportPart(size_t part, std::string &records) const;
+
+    /**
+     * @brief Применяет записи журнала другого хранилища (реплицируемые операции) с их ключами и
+     * записывает их в свой журнал одним пакетом. Записи применяются как повторное воспроизведение
+     * журнала: INSERT и UPDATE заменяют значение записи или добавляют её, а удаление
+     * отсутствующей записи пропускается, поэтому повторное применение тех же записей безопасно
+     * @param records Сериализованные записи журнала (контрольные точки пропускаются)
+     * @return true если все записи разобраны, применены и зафиксированы в журнале
+     */
+    bool applyReplicated(std::string_view records);
+
+    /**
+     * @brief Начинает приём состояния хранилища в отдельные таблицы: принятые записи не видны
+     * читателям, пока commitStaged не заменит ими содержимое хранилища (используется репликой
+     * при повторной передаче состояния). Ранее принятые, но не применённые записи отбрасываются
+     */
+    void beginStaging();
+
+    /**
+     * @brief Добавляет записи журнала другого хранилища к принимаемому состоянию (см.
+     * beginStaging). Записи не попадают в журнал: они сохраняются снапшотом в commitStaged
+     * @param records Сериализованные записи журнала (контрольные точки пропускаются)
+     * @return true если приём начат, а все записи разобраны и приняты
+     */
+    bool stageReplicated(std::string_view records);
+
+    /**
+     * @brief Заменяет содержимое хранилища принятым состоянием под блокировками всех сегментов
+     * и уплотняет журнал, поэтому после перезапуска хранилище загружается уже с новым
+     * содержимым
+     * @return true если приём был начат, а журнал уплотнён
+     */
+    bool commitStaged();
+
+    /**
+     * @brief Возвращает путь к журналу операций (для чтения журнала через JournalReader)
+     * @return Путь к файлу журнала
+     */
+    std::filesystem::path getJournalPath() const;
+
+    /**
+     * @brief Возвращает последнюю контрольную точку журнала
+     * @return Идентификатор контрольной точки или std::nullopt, если снапшотов ещё не было
+     */
+    std::optional<std::string> getLastCheckpointId() const;
 
     /**
      * @brief Явно создаёт снимок текущего состояния хранилища
@@ -75,13 +261,41 @@ public:
      */
     bool createSnapshot();
 
+    /**
+     * @brief Создаёт разностный снимок с изменениями после предыдущего снимка цепочки, а если
+     * цепочку пора объединить (или её нет) - полный снимок
+     * @return true если снимок создан успешно (в том числе если изменений не было)
+     */
+    bool createDeltaSnapshot();
+
+    /**
+     * @brief Уплотняет журнал: создаёт снимок, начиная с его контрольной точки новый сегмент
+     * журнала, и после сохранения снимка на диске удаляет предшествующие сегменты
+     * @return true если снимок создан и журнал уплотнён
+     */
+    bool compactJournal();
+
+    /**
+     * @brief Уплотняет журнал значений: переносит действующие значения из сегментов, большая
+     * часть которых устарела, в активный сегмент и создаёт полный снимок, после записи которого
+     * файлы освободившихся сегментов удаляются
+     * @return true если уплотнение выполнено (в том числе если уплотнять было нечего)
+     */
+    bool compactValueLog();
+
+    /**
+     * @brief Возвращает состояние журнала значений
+     * @return Текущие значения
+     */
+    ValueLogStats getValueLogStats() const;
+
     /**
      * @brief Принудительно запрашивает асинхронное создание снапшота
      */
     void requestSnapshotAsync();
 
     /**
-     * @brief Возвращает количество записей в хранилище
+     * @brief Возвращает количество записей в хранилище (без блокировок сегментов)
      * @return Количество записей
      */
     size_t getEntriesCount() const;
@@ -98,23 +312,122 @@ public:
      */
     void setSnapshotTimeThreshold(size_t minutes);
 
+    /**
+     * @brief Задает способ создания снапшотов
+     * @param mode Способ создания (по умолчанию: FORK)
+     */
+    void setSnapshotMode(SnapshotMode mode);
+
+    /**
+     * @brief Задает количество разностных снапшотов, после которого цепочка объединяется в новый
+     * базовый снапшот. Цепочка объединяется и раньше, если разностные снапшоты суммарно стали
+     * больше базового
+     * @param count Количество снапшотов, 0 - всегда создавать полные снапшоты (по умолчанию: 10)
+     */
+    void setSnapshotDeltaLimit(size_t count);
+
+    /**
+     * @brief Задает суммарный размер сегментов журнала для автоматического уплотнения
+     * @param bytes Размер в байтах, 0 - без ограничения (по умолчанию: 64 МБ)
+     */
+    void setJournalCompactionSizeThreshold(uint64_t bytes);
+
+    /**
+     * @brief Задает возраст активного сегмента журнала для автоматического уплотнения
+     * @param minutes Возраст в минутах, 0 - без ограничения (по умолчанию: 60 минут)
+     */
+    void setJournalCompactionTimeThreshold(size_t minutes);
+
+    /**
+     * @brief Задает размер сегмента журнала, по достижении которого начинается новый сегмент
+     * @param bytes Размер в байтах, 0 - без ограничения (по умолчанию: 64 МБ)
+     */
+    void setJournalSegmentSize(uint64_t bytes);
+
+    /**
+     * @brief Задает алгоритм поблочного сжатия снапшотов и запечатанных сегментов журнала (по
+     * умолчанию: без сжатия). Алгоритм записывается в заголовок файла, поэтому ранее записанные
+     * файлы читаются независимо от настройки
+     * @param codec Алгоритм сжатия
+     * @return true если алгоритм поддерживается сборкой и установлен
+     */
+    bool setCompressionCodec(CompressionCodec codec);
+
 private:
+    // Количество сегментов хранилища в памяти
+    static constexpr size_t STORAGE_SHARD_COUNT = 64;
+
+    /**
+     * @struct StorageShard
+     * @brief Сегмент хранилища в памяти со своей блокировкой (выровнен по кэш-линии, чтобы
+     * блокировки соседних сегментов не делили одну линию)
+     */
+    struct alignas(64) StorageShard {
+        // Разделяемый мьютекс для повышения производительности чтения
+        mutable std::shared_mutex mutex;
+        RecordTable data;
+        // Ключи, изменённые после последнего снапшота. Писатели дополняют множество под
+        // эксклюзивной блокировкой, а очищается оно при создании снапшота под разделяемой
+        // (снапшоты создаются последовательно, а читатели множество не используют)
+        std::unordered_set<Uuid> dirty;
+    };
+
+    /**
+     * @struct SnapshotFileInfo
+     * @brief Результат загрузки файла снапшота
+     */
+    struct SnapshotFileInfo {
+        std::optional<std::string> checkpointId; // Контрольная точка снапшота
+        bool versioned = false; // Записан ли снапшот в формате v2
+        bool damaged = false; // Были ли пропущены повреждённые блоки
+    };
+
     // Хранилище данных в памяти
-    std::unordered_map<std::string, std::string> dataStore_;
+    std::array<StorageShard, STORAGE_SHARD_COUNT> shards_;
+    // Принимаемое состояние хранилища по сегментам (nullptr - приём не начат)
+    std::unique_ptr<std::array<RecordTable, STORAGE_SHARD_COUNT>> staged_;
+    std::mutex stagingMutex_;
+    // Общее количество записей, изменяемое под блокировкой сегмента вместе с его данными
+    std::atomic<size_t> entriesCount_{ 0 };
 
     const std::filesystem::path dataDir_;
     const std::filesystem::path snapshotPath_;
 
+    // Счётчики поколений для читателей из других процессов (создаются раньше журнала, который
+    // увеличивает счётчик записей после каждого пакета)
+    StorageGeneration generation_;
     JournalManager journalManager_;
     UuidGenerator uuidGenerator_;
-
-    // Мьютекс для синхронизации (разделяемый для повышения производительности чтения)
-    mutable std::shared_mutex storageMutex_;
+    // Журнал значений, вынесенных из памяти
+    ValueLog valueLog_;
+    // Сегменты журнала значений, выведенные из использования, но ещё упоминаемые в снапшотах на
+    // диске (изменяется под snapshotCreationMutex_, файлы удаляются после полного снапшота)
+    std::vector<uint32_t> retiredValueSegments_;
 
     // Параметры снапшотов
     std::atomic<size_t> operationsSinceLastSnapshot_{ 0 };
     std::atomic<size_t> snapshotOperationsThreshold_{ 100 }; // По умолчанию каждые 100 операций
     std::atomic<size_t> snapshotTimeThresholdMinutes_{ 10 }; // По умолчанию каждые 10 минут
+    std::atomic<SnapshotMode> snapshotMode_{ SnapshotMode::FORK };
+    std::atomic<CompressionCodec> compressionCodec_{ CompressionCodec::NONE };
+    // Снапшоты создаются строго последовательно, чтобы более старый не заменил более новый
+    std::mutex snapshotCreationMutex_;
+
+    // Цепочка разностных снапшотов (изменяется под snapshotCreationMutex_): контрольная точка
+    // последнего снапшота цепочки (std::nullopt - следующий снапшот будет полным), количество и
+    // суммарный размер разностных снапшотов, размер базового снапшота и номер следующего файла
+    std::atomic<size_t> snapshotDeltaLimit_{ 10 }; // По умолчанию 10 разностных снапшотов
+    std::optional<std::string> chainCheckpointId_;
+    size_t deltaCount_ = 0;
+    uint64_t deltaBytes_ = 0;
+    uint64_t baseBytes_ = 0;
+    uint64_t nextDeltaNumber_ = 1;
+
+    // Параметры уплотнения журнала
+    std::atomic<uint64_t> compactionSizeThresholdBytes_{ 64 * 1024 * 1024 }; // По умолчанию 64 МБ
+    std::atomic<size_t> compactionTimeThresholdMinutes_{ 60 }; // По умолчанию каждый час
+    std::atomic<size_t> operationsSinceLastCompaction_{ 0 };
+    std::atomic<bool> compactionRequested_{ false };
 
     // Для управления асинхронными снапшотами
     std::thread snapshotThread_;
@@ -131,24 +444,154 @@ private:
     bool loadFromDisk();
 
     /**
-     * @brief Загружает данные из снапшота
+     * @brief Загружает данные из снапшота в сегменты хранилища. Блоки снапшота формата v2
+     * проверяются и разбираются параллельно прямо из отображенного в память файла
+     * @param path Путь к файлу снапшота
+     * @param baseCheckpointId Для разностного снапшота - контрольная точка, на которой должна
+     * заканчиваться уже загруженная часть цепочки, для базового - std::nullopt
+     * @param[out] info Контрольная точка снапшота и результат загрузки
+     * @return true если снапшот загружен (возможно, частично). Снапшот неожиданного вида или с
+     * другой предыдущей контрольной точкой не применяется
+     */
+    bool loadSnapshot(const std::filesystem::path &path,
+                      const std::optional<std::string> &baseCheckpointId, SnapshotFileInfo &info);
+
+    /**
+     * @brief Применяет разностные снапшоты цепочки базового снапшота в порядке их номеров и
+     * восстанавливает состояние цепочки
+     * @param[in,out] checkpointId Контрольная точка загруженной части цепочки
+     * @param[out] damaged Были ли пропущены повреждённые блоки
+     */
+    void loadDeltaSnapshots(std::optional<std::string> &checkpointId, bool &damaged);
+
+    /**
+     * @brief Загружает данные из снапшота прежнего формата в сегменты хранилища
+     * @param content Содержимое файла снапшота
+     * @param[out] checkpointId Контрольная точка, соответствующая снапшоту (если она в нём
+     * сохранена)
      * @return true если загрузка выполнена успешно
      */
-    bool loadSnapshot();
+    bool loadLegacySnapshot(std::string_view content, std::optional<std::string> &checkpointId);
 
     /**
-     * @brief Восстанавливает данные из журнала операций
+     * @brief Восстанавливает данные из журнала операций, применяя операции к сегментам хранилища
      * @param lastCheckpointId ID последней контрольной точки (опционально)
      * @return true если восстановление выполнено успешно
      */
     bool restoreFromJournal(const std::optional<std::string> &lastCheckpointId = std::nullopt);
 
+    /**
+     * @brief Дописывает значение в журнал значений, если его нужно хранить на диске
+     * @param key Ключ записи
+     * @param data Значение
+     * @param[out] location Положение значения или std::nullopt, если значение хранится в памяти
+     * @param[out] pin Блокировка, запрещающая удалять сегмент значения до вызова assignValue
+     * @return true если значение не нужно выносить или оно записано в журнал значений
+     */
+    bool prepareValue(const Uuid &key, std::string_view data,
+                      std::optional<ValueLocation> &location,
+                      std::shared_lock<std::shared_mutex> &pin);
+
+    /**
+     * @brief Заменяет значение записи (вызывается под эксклюзивной блокировкой сегмента)
+     * @param value Значение записи
+     * @param data Новое значение
+     * @param location Положение нового значения в журнале значений (из prepareValue)
+     */
+    void assignValue(RecordValue &value, std::string_view data,
+                     const std::optional<ValueLocation> &location);
+
+    /**
+     * @brief Удаляет запись из сегмента хранилища (вызывается под эксклюзивной блокировкой)
+     * @param shard Сегмент хранилища
+     * @param key Ключ записи
+     * @return true если запись была удалена
+     */
+    bool eraseRecord(StorageShard &shard, const Uuid &key);
+
+    /**
+     * @brief Освобождает положение значения в журнале значений (для значения, которое больше не
+     * хранится в таблице сегмента)
+     * @param value Значение записи
+     */
+    void releaseValue(const RecordValue &value);
+
+    /**
+     * @brief Освобождает положения всех значений таблицы, которая больше не используется
+     * хранилищем
+     * @param table Таблица записей
+     */
+    void releaseValues(const RecordTable &table);
+
+    /**
+     * @brief Читает значение из журнала значений вне блокировки сегмента. Если значение уже
+     * перенесено уплотнением, положение перечитывается под разделяемой блокировкой
+     * @param key Ключ записи
+     * @param location Положение значения, прочитанное под блокировкой сегмента
+     * @return Значение или std::nullopt, если запись удалена или не читается
+     */
+    std::optional<std::string> loadValue(const Uuid &key, const ValueLocation &location) const;
+
+    /**
+     * @brief Уплотняет журнал значений (вызывается под snapshotCreationMutex_)
+     * @return true если уплотнение выполнено
+     */
+    bool do_compactValueLog();
+
+    /**
+     * @brief Возвращает индекс сегмента хранилища, в котором находится запись
+     * @param key Ключ записи
+     * @return Индекс сегмента
+     */
+    static size_t shardIndex(const Uuid &key);
+
+    /**
+     * @brief Возвращает сегмент хранилища, в котором находится запись
+     * @param key Ключ записи
+     * @return Сегмент хранилища
+     */
+    StorageShard &shardFor(const Uuid &key);
+    const StorageShard &shardFor(const Uuid &key) const;
+
+    /**
+     * @brief Создаёт снимок текущего состояния хранилища (вызывается под snapshotCreationMutex_)
+     * @param startNewSegment Нужно ли начать с контрольной точки снимка новый сегмент журнала
+     * @param[out] checkpointId Контрольная точка созданного снимка (опционально)
+     * @return true если снимок создан успешно
+     */
+    bool do_createSnapshot(bool startNewSegment, std::string *checkpointId = nullptr);
+
+    /**
+     * @brief Создаёт разностный снимок (вызывается под snapshotCreationMutex_ при существующей
+     * цепочке снапшотов)
+     * @return true если снимок создан успешно или изменений не было
+     */
+    bool do_createDeltaSnapshot();
+
+    /**
+     * @brief Удаляет файлы разностных снапшотов (после записи нового базового снапшота)
+     * @return true если все файлы удалены
+     */
+    bool removeDeltaSnapshots();
+
+    /**
+     * @brief Проверяет, требуется ли уплотнение журнала по его размеру или возрасту активного
+     * сегмента
+     * @return true если журнал нужно уплотнить
+     */
+    bool isJournalCompactionDue() const;
+
     /**
      * @brief Записывает снапшот на диск
      * @param data Данные для записи
+     * @param checkpointId Контрольная точка, соответствующая снапшоту
+     * @param codec Алгоритм сжатия блоков снапшота
+     * @param valueLog Могут ли записи ссылаться на журнал значений
      * @return true если запись выполнена успешно
      */
-    bool writeSnapshotToDisk(const std::unordered_map<std::string, std::string> &data);
+    bool writeSnapshotToDisk(const std::vector<const RecordTable *> &data,
+                             const std::string &checkpointId, CompressionCodec codec,
+                             bool valueLog);
 
     /**
      * @brief Функция потока для создания снапшотов.
@@ -156,9 +599,10 @@ private:
     void snapshotThreadFunction();
 
     /**
-     * @brief Уведомляет о выполнении операции, изменяющей данные.
+     * @brief Уведомляет о выполнении операций, изменяющих данные.
+     * @param count Количество выполненных операций
      */
-    void notifyOperation();
+    void notifyOperation(size_t count = 1);
 };
 
 } // namespace octet
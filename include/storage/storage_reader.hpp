@@ -0,0 +1,133 @@
+#pragma once
+
+#include <atomic>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+#include "storage_generation.hpp"
+
+namespace octet {
+/**
+ * @class StorageReader
+ * @brief Предоставляет доступ только для чтения к хранилищу, которое ведёт StorageManager
+ * другого процесса.
+ *
+ * Несколько читателей могут работать с одной директорией данных одновременно с единственным
+ * писателем. Базовый снапшот формата v2 отображается в память, а индекс читателя хранит только
+ * ключи и ссылки на значения в отображении, поэтому данные не копируются в каждый процесс, а
+ * страницы снапшота разделяются через кэш страниц ОС (значения сжатого снапшота распаковываются
+ * в память читателя). Значения, вынесенные писателем в журнал значений, читаются из
+ * отображённых сегментов этого журнала. Изменения разностных снапшотов и журнала хранятся поверх
+ * индекса.
+ *
+ * Перед каждым чтением читатель сравнивает счётчики поколений хранилища (StorageGeneration) с
+ * увиденными ранее: после записи в журнал он дочитывает новые операции, а после замены базового
+ * снапшота загружает хранилище заново, освобождая накопленные изменения. Пока счётчики не
+ * изменились, чтение не обращается к файловой системе. Читатель ничего не записывает в
+ * хранилище и не блокирует его файлы, а единственность писателя должен обеспечить вызывающий код.
+ */
+class StorageReader {
+public:
+    /**
+     * @brief Конструктор, загружает хранилище из указанной директории
+     * @param dataDir Директория с файлами хранилища (должна существовать)
+     * @throws std::runtime_error если директория не существует
+     */
+    explicit StorageReader(const std::filesystem::path &dataDir);
+
+    /**
+     * @brief Деструктор, освобождает отображение снапшота и дескриптор журнала
+     */
+    ~StorageReader();
+
+    // Запрещаем копирование и перемещение
+    StorageReader(const StorageReader &) = delete;
+    StorageReader &operator=(const StorageReader &) = delete;
+    StorageReader(StorageReader &&) = delete;
+    StorageReader &operator=(StorageReader &&) = delete;
+
+    /**
+     * @brief Извлекает строку по её идентификатору
+     * @param uuid Уникальный идентификатор строки
+     * @return Сохранённая строка данных или std::nullopt, если не найдена
+     */
+    std::optional<std::string> get(const std::string &uuid) const;
+
+    /**
+     * @brief Извлекает несколько строк, дочитывая изменения хранилища один раз
+     * @param uuids Идентификаторы строк
+     * @return Строки в порядке идентификаторов (std::nullopt для ненайденных)
+     */
+    std::vector<std::optional<std::string>> getMany(const std::vector<std::string> &uuids) const;
+
+    /**
+     * @brief Возвращает количество записей в хранилище
+     * @return Количество записей
+     */
+    size_t getEntriesCount() const;
+
+    /**
+     * @brief Дочитывает изменения хранилища, дожидаясь обновления, начатого другим потоком
+     * (get и getMany дочитывают изменения сами, но не ждут уже идущего обновления)
+     * @return true если изменения дочитаны, false если хранилище загружено не полностью
+     */
+    bool refresh();
+
+private:
+    // Загруженное состояние хранилища (определено в storage_reader.cpp)
+    struct State;
+
+    const std::filesystem::path dataDir_;
+    const std::filesystem::path snapshotPath_;
+    const std::filesystem::path journalPath_;
+    const std::filesystem::path valueLogPath_;
+
+    // Счётчики поколений хранилища (отображаются после проверки директории)
+    std::unique_ptr<StorageGeneration> generation_;
+
+    // Текущее состояние: заменяется целиком при загрузке нового базового снапшота и дополняется
+    // операциями журнала под эксклюзивной блокировкой, пока чтение идёт под разделяемой.
+    // Состояние дочитывается и константными методами чтения, поэтому изменяемо
+    mutable std::unique_ptr<State> state_;
+    mutable std::shared_mutex stateMutex_;
+    // Состояние обновляет не больше одного потока одновременно
+    mutable std::mutex refreshMutex_;
+    // Значения счётчиков поколений, до которых дочитано состояние
+    mutable std::atomic<uint64_t> seenJournal_{ 0 };
+    mutable std::atomic<uint64_t> seenSnapshot_{ 0 };
+
+    /**
+     * @brief Дочитывает изменения, если счётчики поколений изменились, а другой поток их ещё не
+     * дочитывает
+     */
+    void catchUp() const;
+
+    /**
+     * @brief Дочитывает журнал или, если заменён базовый снапшот или положение в журнале
+     * потеряно, загружает хранилище заново (вызывается под refreshMutex_)
+     * @return true если изменения дочитаны полностью
+     */
+    bool do_refresh() const;
+
+    /**
+     * @brief Загружает хранилище, повторяя загрузку, если писатель заменил снапшот во время неё
+     * @param[out] snapshotGeneration Счётчик замен снапшота, соответствующий загруженному
+     * состоянию
+     * @param[out] complete Загружено ли хранилище полностью
+     * @return Загруженное состояние
+     */
+    std::unique_ptr<State> loadState(uint64_t &snapshotGeneration, bool &complete) const;
+
+    /**
+     * @brief Загружает снапшоты и журнал в состояние
+     * @param state Пустое состояние
+     * @return true если хранилище загружено полностью
+     */
+    bool do_loadState(State &state) const;
+};
+} // namespace octet
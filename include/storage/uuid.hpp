@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace octet {
+/**
+ * @class Uuid
+ * @brief Двоичное представление UUID (16 байт).
+ *
+ * Строковое представление - каноническое "xxxxxxxx-xxxx-xxxx-xxxx-xxxxxxxxxxxx" в нижнем
+ * регистре. Преобразование в обе стороны выполняется без выделения памяти, локалей и регулярных
+ * выражений, поэтому хранить и сравнивать UUID в виде строк не требуется.
+ */
+class Uuid {
+public:
+    // Длина строкового представления UUID
+    static constexpr size_t STRING_LENGTH = 36;
+
+    /**
+     * @brief Конструктор нулевого UUID
+     */
+    constexpr Uuid() noexcept = default;
+
+    /**
+     * @brief Создаёт UUID из двух 64-битных половин
+     * @param high Старшие 8 байт (первые 16 шестнадцатеричных цифр)
+     * @param low Младшие 8 байт (последние 16 шестнадцатеричных цифр)
+     * @return UUID
+     */
+    static Uuid fromParts(uint64_t high, uint64_t low) noexcept;
+
+    /**
+     * @brief Создаёт UUID из двоичного представления
+     * @param data Указатель на 16 байт в порядке их следования в строковом представлении
+     * @return UUID
+     */
+    static Uuid fromBytes(const void *data) noexcept;
+
+    /**
+     * @brief Разбирает строковое представление UUID
+     * @param uuid Строка UUID в нижнем регистре
+     * @return UUID или std::nullopt, если строка не является UUID
+     */
+    static std::optional<Uuid> fromString(std::string_view uuid) noexcept;
+
+    /**
+     * @brief Записывает строковое представление UUID (без выделения памяти)
+     * @param out Буфер размером не меньше STRING_LENGTH байт
+     */
+    void writeTo(char *out) const noexcept;
+
+    /**
+     * @brief Возвращает строковое представление UUID
+     * @return Строка UUID в нижнем регистре
+     */
+    std::string toString() const;
+
+    /**
+     * @brief Возвращает версию UUID (старшие 4 бита 7-го байта)
+     * @return Версия UUID
+     */
+    uint8_t version() const noexcept { return bytes_[6] >> 4; }
+
+    /**
+     * @brief Возвращает 64-битный хэш UUID с перемешиванием всех битов
+     * @return Хэш UUID
+     */
+    uint64_t hash() const noexcept;
+
+    const std::array<uint8_t, 16> &bytes() const noexcept { return bytes_; }
+
+    bool operator==(const Uuid &other) const noexcept { return bytes_ == other.bytes_; }
+    bool operator!=(const Uuid &other) const noexcept { return bytes_ != other.bytes_; }
+    bool operator<(const Uuid &other) const noexcept { return bytes_ < other.bytes_; }
+
+private:
+    std::array<uint8_t, 16> bytes_{};
+};
+} // namespace octet
+
+namespace std {
+template <>
+struct hash<octet::Uuid> {
+    size_t operator()(const octet::Uuid &uuid) const noexcept
+    {
+        return static_cast<size_t>(uuid.hash());
+    }
+};
+} // namespace std
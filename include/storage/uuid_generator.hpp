@@ -1,8 +1,10 @@
 #pragma once
 
 #include <atomic>
-#include <random>
 #include <string>
+#include <string_view>
+
+#include "uuid.hpp"
 
 namespace octet {
 /**
@@ -13,6 +15,9 @@ namespace octet {
  * однако не соответствует ей полностью. Использует комбинацию временной
  * метки, случайных чисел и счётчика для создания глобально уникальных
  * идентификаторов.
+ *
+ * Генератор потокобезопасен и не использует блокировок: состояние генератора случайных чисел
+ * хранится отдельно для каждого потока, а общим является только атомарный счётчик.
  */
 class UuidGenerator {
 public:
@@ -21,6 +26,12 @@ public:
      */
     UuidGenerator();
 
+    /**
+     * @brief Генерирует новый уникальный идентификатор.
+     * @return Новый UUID в двоичном представлении.
+     */
+    Uuid generate();
+
     /**
      * @brief Генерирует новый уникальный идентификатор.
      * @return Строка с новым UUID.
@@ -32,13 +43,10 @@ public:
      * @param uuid Проверяемый идентификатор.
      * @return true если формат корректен.
      */
-    static bool isValidUuid(const std::string &uuid);
+    static bool isValidUuid(std::string_view uuid);
 
 private:
     // Счётчик для обеспечения уникальности
     std::atomic<uint64_t> counter;
-
-    // Генератор случайных чисел
-    std::mt19937_64 rng;
 };
 } // namespace octet
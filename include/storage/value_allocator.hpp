@@ -0,0 +1,154 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace octet {
+/**
+ * @enum ValueAllocation
+ * @brief Способ выделения буферов для значений записей, не помещающихся в ячейку таблицы
+ */
+enum class ValueAllocation : uint8_t {
+    HEAP, // Отдельный буфер через operator new для каждого значения
+    SLAB, // Блоки фиксированных классов размера внутри общих слэбов
+};
+
+/**
+ * @struct ValueAllocatorStats
+ * @brief Использование памяти значениями записей. Отношение reservedBytes к liveBytes показывает
+ * накладные расходы на округление до класса размера и фрагментацию слэбов
+ */
+struct ValueAllocatorStats {
+    uint64_t liveBytes = 0; // Суммарная длина хранимых значений
+    uint64_t allocatedBytes = 0; // Размер выданных блоков (длина, округлённая до класса размера)
+    uint64_t reservedBytes = 0; // Память, полученная у системы (слэбы и отдельные буферы)
+    uint64_t slabs = 0; // Количество слэбов, включая пустые слэбы в резерве
+};
+
+/**
+ * @class ValueAllocator
+ * @brief Выделяет буферы для длинных значений записей.
+ *
+ * ValueAllocator является синглтоном. В режиме SLAB значения до MAX_BLOCK_SIZE байт хранятся в
+ * блоках одного из CLASS_COUNT классов размера (шаг 8 байт до 128 байт, далее по 4 класса на
+ * каждую степень двойки). Блоки одного класса нарезаются из слэбов размером SLAB_SIZE, выровненных
+ * по своему размеру, поэтому слэб блока находится маскированием адреса, а накладные расходы на
+ * блок отсутствуют. Освобождённые блоки переиспользуются внутри своего слэба, а полностью пустые
+ * слэбы возвращаются системе (по одному на класс остаётся в резерве), поэтому после удаления
+ * записей память не остаётся раздробленной по всей куче. Значения длиннее MAX_BLOCK_SIZE байт и
+ * все значения в режиме HEAP выделяются через operator new.
+ *
+ * Каждый класс размера защищён собственным мьютексом, поэтому потоки, пишущие значения разной
+ * длины, не конкурируют между собой. Экземпляр не разрушается при завершении процесса, так как
+ * значения в статических объектах могут освобождаться позже.
+ */
+class ValueAllocator {
+public:
+    // Размер и выравнивание слэба
+    static constexpr size_t SLAB_SIZE = 64 * 1024;
+    // Наибольший размер значения, хранимого в слэбе
+    static constexpr size_t MAX_BLOCK_SIZE = 4096;
+    // Наименьший размер блока (в свободном блоке хранится указатель на следующий)
+    static constexpr size_t MIN_BLOCK_SIZE = 16;
+    // Количество классов размера
+    static constexpr size_t CLASS_COUNT = 35;
+
+    /**
+     * @brief Получение единственного экземпляра
+     * @return Ссылка на экземпляр
+     */
+    static ValueAllocator &getInstance();
+
+    /**
+     * @brief Возвращает класс размера для значения
+     * @param size Длина значения (не больше MAX_BLOCK_SIZE)
+     * @return Индекс класса в [0, CLASS_COUNT)
+     */
+    static size_t sizeClass(size_t size) noexcept;
+
+    /**
+     * @brief Возвращает размер блока класса
+     * @param index Индекс класса
+     * @return Размер блока в байтах
+     */
+    static size_t classSize(size_t index) noexcept;
+
+    /**
+     * @brief Выделяет буфер для значения
+     * @param size Длина значения
+     * @param allocation Способ выделения
+     * @return Указатель на буфер размером не меньше size байт
+     * @throws std::bad_alloc если память не удалось выделить
+     */
+    char *allocate(size_t size, ValueAllocation allocation);
+
+    /**
+     * @brief Освобождает буфер, выделенный allocate
+     * @param data Указатель на буфер
+     * @param size Длина значения, переданная в allocate
+     * @param allocation Способ выделения, переданный в allocate
+     */
+    void deallocate(char *data, size_t size, ValueAllocation allocation) noexcept;
+
+    /**
+     * @brief Проверяет, можно ли хранить значение новой длины в уже выделенном буфере
+     * @param oldSize Длина значения, переданная в allocate
+     * @param newSize Длина нового значения
+     * @param allocation Способ выделения буфера
+     * @return true если буфер подходит для нового значения
+     */
+    static bool fits(size_t oldSize, size_t newSize, ValueAllocation allocation) noexcept;
+
+    /**
+     * @brief Учитывает изменение длины значения, сохранённого в буфере без перевыделения
+     * @param oldSize Прежняя длина значения
+     * @param newSize Новая длина значения
+     */
+    void resize(size_t oldSize, size_t newSize) noexcept;
+
+    /**
+     * @brief Собирает статистику использования памяти
+     * @return Текущие значения
+     */
+    ValueAllocatorStats stats() const;
+
+    /**
+     * @brief Задаёт способ выделения новых значений для всего процесса. Уже выделенные буферы
+     * освобождаются тем способом, которым были выделены
+     * @param allocation Способ выделения
+     */
+    static void setDefaultAllocation(ValueAllocation allocation) noexcept;
+
+    /**
+     * @brief Возвращает способ выделения новых значений
+     * @return Способ выделения (по умолчанию SLAB)
+     */
+    static ValueAllocation defaultAllocation() noexcept;
+
+private:
+    struct Slab; // Заголовок слэба
+    struct SizeClass; // Слэбы и статистика одного класса размера
+
+    // Запрещаем создание экземпляров класса напрямую
+    ValueAllocator();
+    ~ValueAllocator();
+    ValueAllocator(const ValueAllocator &) = delete;
+    ValueAllocator &operator=(const ValueAllocator &) = delete;
+    ValueAllocator(ValueAllocator &&) = delete;
+    ValueAllocator &operator=(ValueAllocator &&) = delete;
+
+    /**
+     * @brief Создаёт пустой слэб для класса размера
+     * @param index Индекс класса
+     * @return Указатель на заголовок слэба
+     * @throws std::bad_alloc если память не удалось выделить
+     */
+    static Slab *createSlab(size_t index);
+
+    std::unique_ptr<SizeClass[]> classes_; // Классы размера
+    std::atomic<uint64_t> heapLiveBytes_{ 0 }; // Длина значений в отдельных буферах
+    static std::atomic<ValueAllocation> defaultAllocation_; // Способ выделения новых значений
+};
+} // namespace octet
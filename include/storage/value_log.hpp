@@ -0,0 +1,269 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "record_table.hpp"
+#include "uuid.hpp"
+
+namespace octet {
+/**
+ * @struct ValueLogPolicy
+ * @brief Параметры журнала значений
+ */
+struct ValueLogPolicy {
+    // Наименьшая длина значения, выносимого в журнал значений (0 - значения хранятся в памяти).
+    // Строки до RecordValue::INLINE_CAPACITY байт всегда хранятся в ячейке таблицы
+    size_t minValueSize = 0;
+    // Объём кэша значений, прочитанных из журнала значений (0 - без кэша)
+    size_t cacheBytes = 64 * 1024 * 1024;
+    // Размер сегмента, по достижении которого начинается новый (не больше 1 ГБ)
+    uint64_t segmentSize = 64 * 1024 * 1024;
+};
+
+/**
+ * @struct ValueLogStats
+ * @brief Состояние журнала значений
+ */
+struct ValueLogStats {
+    uint64_t segments = 0; // Количество сегментов, включая выведенные из использования
+    uint64_t diskBytes = 0; // Суммарный размер сегментов
+    uint64_t liveBytes = 0; // Размер записей, на которые ссылаются записи хранилища
+    uint64_t cacheBytes = 0; // Суммарная длина значений в кэше
+    uint64_t reads = 0; // Количество чтений значений с диска
+    uint64_t cacheHits = 0; // Количество чтений значений из кэша
+};
+
+/**
+ * @class ValueLog
+ * @brief Журнал значений: хранит на диске значения, вынесенные из памяти хранилища.
+ *
+ * Значения дописываются в активный сегмент записями [UUID (16 байт), длина (u32), CRC32C (u32),
+ * значение], а хранилище держит в памяти только их положение (ValueLocation). Сегмент файла
+ * "<путь>.<номер>" начинается с сигнатуры, и после перезапуска запись всегда начинается с нового
+ * сегмента, поэтому недописанная запись может оказаться только в конце сегмента. Место под запись
+ * резервируется под мьютексом, а сама запись выполняется pwrite вне его, поэтому потоки пишут
+ * значения параллельно.
+ *
+ * Значения читаются через pread с проверкой контрольной суммы и помещаются в кэш, вытесняющий
+ * значения по алгоритму CLOCK, поэтому часто читаемые значения не требуют обращения к диску.
+ * Записи на диске неизменяемы, поэтому кэш не требует инвалидации.
+ *
+ * Журнал учитывает, сколько байт каждого сегмента ещё используется хранилищем. Сегменты, большая
+ * часть которых устарела, можно уплотнить: хранилище переносит их действующие значения в
+ * активный сегмент, выводит опустевший сегмент из использования и удаляет его файл после записи
+ * снапшота, который на него уже не ссылается. Журнал потокобезопасен.
+ */
+class ValueLog {
+public:
+    // Размер заголовка записи перед значением
+    static constexpr size_t RECORD_HEADER_SIZE = 16 + 2 * sizeof(uint32_t);
+    // Наибольший размер сегмента
+    static constexpr uint64_t MAX_SEGMENT_SIZE = uint64_t(1) << 30;
+
+    /**
+     * @brief Конструктор, открывает существующие сегменты (новые файлы создаются при первой
+     * записи)
+     * @param basePath Путь к журналу значений (сегменты создаются рядом с ним)
+     * @param policy Параметры журнала значений
+     */
+    ValueLog(const std::filesystem::path &basePath, ValueLogPolicy policy);
+
+    /**
+     * @brief Деструктор, закрывает дескрипторы сегментов
+     */
+    ~ValueLog();
+
+    // Запрещаем копирование и перемещение
+    ValueLog(const ValueLog &) = delete;
+    ValueLog &operator=(const ValueLog &) = delete;
+    ValueLog(ValueLog &&) = delete;
+    ValueLog &operator=(ValueLog &&) = delete;
+
+    /**
+     * @brief Проверяет, нужно ли выносить значение в журнал значений
+     * @param size Длина значения
+     * @return true если журнал значений включён и значение не меньше minValueSize
+     */
+    bool shouldStore(size_t size) const noexcept;
+
+    /**
+     * @brief Дописывает значение в активный сегмент (без фиксации на диске, см. sync). Место в
+     * сегменте не учитывается как используемое до вызова retain
+     * @param key Ключ записи
+     * @param value Значение
+     * @return Положение значения или std::nullopt при ошибке записи
+     */
+    std::optional<ValueLocation> append(const Uuid &key, std::string_view value);
+
+    /**
+     * @brief Запрещает выводить сегменты из использования, пока удерживается возвращённая
+     * блокировка. Положение, полученное от append под этой блокировкой, должно быть учтено
+     * через retain до её освобождения, иначе сегмент может быть удалён вместе со значением
+     * @return Разделяемая блокировка
+     */
+    std::shared_lock<std::shared_mutex> pinSegments() const;
+
+    /**
+     * @brief Читает значение из кэша или с диска, проверяя ключ и контрольную сумму записи
+     * @param key Ключ записи
+     * @param location Положение значения
+     * @param[out] value Значение
+     * @return true если значение прочитано (false, если сегмент удалён или запись повреждена)
+     */
+    bool read(const Uuid &key, const ValueLocation &location, std::string &value) const;
+
+    /**
+     * @brief Проверяет, что положение значения находится в пределах существующего сегмента
+     * @param location Положение значения
+     * @return true если сегмент существует и содержит указанную область
+     */
+    bool contains(const ValueLocation &location) const;
+
+    /**
+     * @brief Учитывает запись значения как используемую хранилищем
+     * @param location Положение значения
+     */
+    void retain(const ValueLocation &location);
+
+    /**
+     * @brief Учитывает, что хранилище больше не использует запись значения
+     * @param location Положение значения
+     */
+    void release(const ValueLocation &location);
+
+    /**
+     * @brief Фиксирует на диске все дописанные значения. Вызывается до того, как на диске
+     * появится снапшот, ссылающийся на них
+     * @return true если данные зафиксированы
+     */
+    bool sync();
+
+    /**
+     * @brief Проверяет, есть ли у журнала сегменты (тогда снапшоты могут ссылаться на него)
+     * @return true если есть хотя бы один сегмент
+     */
+    bool hasSegments() const;
+
+    /**
+     * @brief Возвращает запечатанные сегменты, в которых используется меньше половины места
+     * @return Номера сегментов в порядке возрастания
+     */
+    std::vector<uint32_t> collectableSegments() const;
+
+    /**
+     * @brief Обходит неповреждённые записи сегмента (обход останавливается на первой
+     * повреждённой или недописанной записи)
+     * @param segment Номер сегмента
+     * @param func Функция с сигнатурой void(const Uuid &, const ValueLocation &)
+     * @return true если сегмент прочитан до конца
+     */
+    bool scanSegment(uint32_t segment,
+                     const std::function<void(const Uuid &, const ValueLocation &)> &func) const;
+
+    /**
+     * @brief Выводит сегмент из использования, если хранилище больше не ссылается на его
+     * записи. Файл сегмента остаётся на диске до вызова removeSegments
+     * @param segment Номер сегмента
+     * @return true если сегмент выведен из использования
+     */
+    bool retireSegment(uint32_t segment);
+
+    /**
+     * @brief Удаляет файлы сегментов, выведенных из использования
+     * @param segments Номера сегментов
+     * @return true если все файлы удалены
+     */
+    bool removeSegments(const std::vector<uint32_t> &segments);
+
+    /**
+     * @brief Собирает состояние журнала значений
+     * @return Текущие значения
+     */
+    ValueLogStats stats() const;
+
+    /**
+     * @brief Формирует путь к сегменту журнала значений
+     * @param basePath Путь к журналу значений
+     * @param number Номер сегмента
+     * @return Путь к файлу сегмента
+     */
+    static std::filesystem::path segmentPath(const std::filesystem::path &basePath,
+                                             uint32_t number);
+
+    /**
+     * @brief Находит сегменты журнала значений
+     * @param basePath Путь к журналу значений
+     * @return Пары из номера и пути к файлу в порядке возрастания номеров
+     */
+    static std::vector<std::pair<uint32_t, std::filesystem::path>>
+    listSegments(const std::filesystem::path &basePath);
+
+    /**
+     * @brief Проверяет сигнатуру в начале сегмента
+     * @param content Содержимое файла сегмента
+     * @return true если файл является сегментом журнала значений
+     */
+    static bool isSegment(std::string_view content);
+
+    /**
+     * @brief Извлекает значение из содержимого сегмента, проверяя ключ и контрольную сумму записи
+     * @param content Содержимое файла сегмента
+     * @param key Ключ записи
+     * @param location Положение значения
+     * @return Значение (ссылается на content) или std::nullopt, если запись повреждена или
+     * находится за пределами содержимого
+     */
+    static std::optional<std::string_view>
+    recordValue(std::string_view content, const Uuid &key, const ValueLocation &location);
+
+private:
+    struct Segment; // Открытый файл сегмента
+    class Cache; // Кэш прочитанных значений
+
+    const std::filesystem::path basePath_;
+    const ValueLogPolicy policy_;
+
+    // Сегменты по номерам (сегменты, выведенные из использования, хранятся до удаления файлов)
+    mutable std::shared_mutex segmentsMutex_;
+    std::map<uint32_t, std::shared_ptr<Segment>> segments_;
+    // Разделяется записями значений и захватывается эксклюзивно при выводе сегмента из
+    // использования (см. pinSegments)
+    mutable std::shared_mutex pinMutex_;
+
+    // Активный сегмент и номер следующего сегмента (место в активном сегменте резервируется под
+    // appendMutex_)
+    mutable std::mutex appendMutex_;
+    std::shared_ptr<Segment> active_;
+    uint32_t nextSegment_ = 1;
+
+    std::unique_ptr<Cache> cache_;
+    mutable std::atomic<uint64_t> reads_{ 0 };
+    mutable std::atomic<uint64_t> cacheHits_{ 0 };
+
+    /**
+     * @brief Находит сегмент по номеру
+     * @param number Номер сегмента
+     * @return Сегмент или nullptr
+     */
+    std::shared_ptr<Segment> findSegment(uint32_t number) const;
+
+    /**
+     * @brief Создаёт новый активный сегмент (вызывается под appendMutex_)
+     * @return true если сегмент создан
+     */
+    bool startSegment();
+};
+} // namespace octet
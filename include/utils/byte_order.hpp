@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+namespace octet::utils {
+/**
+ * @brief Записывает беззнаковое целое в буфер в порядке байтов little-endian
+ * @param data Указатель на буфер (не менее sizeof(T) байт)
+ * @param value Записываемое значение
+ */
+template <typename T> inline void storeLittleEndian(char *data, T value)
+{
+    static_assert(std::is_unsigned_v<T>, "Поддерживаются только беззнаковые целые");
+    for (size_t i = 0; i < sizeof(T); i++) {
+        data[i] = static_cast<char>((value >> (8 * i)) & 0xFF);
+    }
+}
+
+/**
+ * @brief Дописывает беззнаковое целое в конец буфера в порядке байтов little-endian
+ * @param buffer Буфер для дописывания
+ * @param value Записываемое значение
+ */
+template <typename T> inline void appendLittleEndian(std::string &buffer, T value)
+{
+    char bytes[sizeof(T)];
+    storeLittleEndian(bytes, value);
+    buffer.append(bytes, sizeof(T));
+}
+
+/**
+ * @brief Считывает беззнаковое целое, записанное в порядке байтов little-endian
+ * @param data Указатель на данные (не менее sizeof(T) байт)
+ * @return Считанное значение
+ */
+template <typename T> inline T loadLittleEndian(const char *data)
+{
+    static_assert(std::is_unsigned_v<T>, "Поддерживаются только беззнаковые целые");
+    T value = 0;
+    for (size_t i = 0; i < sizeof(T); i++) {
+        value |= static_cast<T>(static_cast<uint8_t>(data[i])) << (8 * i);
+    }
+    return value;
+}
+} // namespace octet::utils
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+#include "storage/journal_manager.hpp"
+
+namespace octet::utils {
+/**
+ * @brief Проверяет, собрана ли библиотека с поддержкой алгоритма сжатия
+ * @param codec Алгоритм сжатия
+ * @return true, если блоки можно сжимать и распаковывать этим алгоритмом
+ */
+bool isCompressionCodecAvailable(CompressionCodec codec);
+
+/**
+ * @brief Возвращает название алгоритма сжатия для сообщений журнала
+ * @param codec Алгоритм сжатия
+ * @return Название алгоритма
+ */
+const char *compressionCodecName(CompressionCodec codec);
+
+// Функции сжатия не используют логгер и блокировки, поэтому их можно вызывать и в дочернем
+// процессе, записывающем снапшот
+
+/**
+ * @brief Сжимает блок данных
+ * @param codec Алгоритм сжатия (для NONE данные копируются без изменений)
+ * @param input Исходные данные
+ * @param[out] output Сжатые данные (прежнее содержимое заменяется)
+ * @return true, если блок сжат (false, если алгоритм не поддерживается сборкой или блок
+ * слишком велик для него)
+ */
+bool compressBlock(CompressionCodec codec, std::string_view input, std::string &output);
+
+/**
+ * @brief Распаковывает блок данных
+ * @param codec Алгоритм, которым был сжат блок
+ * @param input Сжатые данные
+ * @param originalSize Размер исходных данных
+ * @param[out] output Исходные данные (прежнее содержимое заменяется)
+ * @return true, если блок распакован и его размер совпал с ожидаемым
+ */
+bool decompressBlock(CompressionCodec codec, std::string_view input, size_t originalSize,
+                     std::string &output);
+} // namespace octet::utils
@@ -0,0 +1,16 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace octet::utils {
+/**
+ * @brief Вычисляет контрольную сумму CRC32C (полином Кастаньоли) для блока данных.
+ * При наличии поддержки процессором используется аппаратная инструкция crc32 (SSE4.2)
+ * @param data Указатель на данные
+ * @param size Размер данных
+ * @param crc Контрольная сумма предыдущих блоков для продолжения вычисления (0 для первого блока)
+ * @return Контрольная сумма CRC32C
+ */
+uint32_t crc32c(const void *data, size_t size, uint32_t crc = 0);
+} // namespace octet::utils
@@ -29,6 +29,11 @@ enum class LockWaitStrategy {
  *
  * Использует RAII-подход: блокировка создается в конструкторе и автоматически
  * освобождается в деструкторе.
+ *
+ * Внутри процесса блокировки одного файла учитываются в общей таблице: повторная
+ * блокировка тем же потоком разрешена (кроме повышения SHARED до EXCLUSIVE), ожидающие
+ * потоки просыпаются по условной переменной, а блокировка файла передается им без
+ * повторного открытия и flock().
  */
 class FileLockGuard {
 public:
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <filesystem>
 #include <optional>
 #include <string>
@@ -30,6 +31,15 @@ bool ensureDirectoryExists(const std::filesystem::path &dir, bool createIfMissin
  */
 bool atomicFileWrite(const std::filesystem::path &filePath, const std::string &data);
 
+/**
+ * @brief Атомарно заменяет файл уже записанным на диск файлом и синхронизирует директорию
+ * @param sourcePath Путь к заменяющему файлу (данные должны быть уже зафиксированы на диске)
+ * @param targetPath Путь к заменяемому файлу
+ * @return true, если замена выполнена успешно
+ */
+bool replaceFileDurably(const std::filesystem::path &sourcePath,
+                        const std::filesystem::path &targetPath);
+
 /**
  * @brief Безопасно считывает все содержимое файла
  * @param filePath Путь к файлу для чтения
@@ -53,6 +63,127 @@ bool isFileReadable(const std::filesystem::path &filePath);
  */
 bool safeFileAppend(const std::filesystem::path &filePath, const std::string &data);
 
+/**
+ * @brief Открывает файл для дозаписи на низком уровне (файл создаётся, если отсутствует)
+ * @param filePath Путь к файлу
+ * @return Дескриптор открытого файла или std::nullopt при ошибке
+ */
+std::optional<int> openFileForAppend(const std::filesystem::path &filePath);
+
+/**
+ * @brief Открывает существующий файл только для чтения на низком уровне
+ * @param filePath Путь к файлу
+ * @return Дескриптор открытого файла или std::nullopt при ошибке (в том числе если файла нет)
+ */
+std::optional<int> openFileForRead(const std::filesystem::path &filePath);
+
+/**
+ * @brief Создаёт новый файл с начальным содержимым и открывает его для дозаписи. Содержимое и
+ * запись о файле в директории фиксируются на диске до возврата дескриптора
+ * @param filePath Путь к файлу (файл не должен существовать)
+ * @param initialData Начальное содержимое файла
+ * @return Дескриптор открытого файла или std::nullopt при ошибке
+ */
+std::optional<int> createFileForAppend(const std::filesystem::path &filePath,
+                                       const std::string &initialData);
+
+/**
+ * @brief Создаёт новый файл с начальным содержимым и открывает его для записи по смещениям и
+ * чтения. Содержимое и запись о файле в директории фиксируются на диске до возврата дескриптора
+ * @param filePath Путь к файлу (файл не должен существовать)
+ * @param initialData Начальное содержимое файла
+ * @return Дескриптор открытого файла или std::nullopt при ошибке
+ */
+std::optional<int> createFileForWrite(const std::filesystem::path &filePath,
+                                      const std::string &initialData);
+
+/**
+ * @brief Полностью записывает данные в файл по дескриптору (с повтором при частичной записи)
+ * @param fd Дескриптор файла
+ * @param data Указатель на данные для записи
+ * @param size Размер данных
+ * @return true, если все данные записаны
+ */
+bool writeToDescriptor(int fd, const char *data, size_t size);
+
+/**
+ * @brief Полностью записывает данные в файл по дескриптору с указанного смещения, не изменяя
+ * позицию дескриптора (с повтором при частичной записи)
+ * @param fd Дескриптор файла, открытого без O_APPEND
+ * @param offset Смещение, с которого начинается запись
+ * @param data Указатель на данные для записи
+ * @param size Размер данных
+ * @return true, если все данные записаны
+ */
+bool writeToDescriptorAt(int fd, uint64_t offset, const char *data, size_t size);
+
+/**
+ * @brief Читает ровно указанное количество байт файла по дескриптору с указанного смещения, не
+ * изменяя позицию дескриптора (с повтором при частичном чтении)
+ * @param fd Дескриптор файла
+ * @param offset Смещение, с которого начинается чтение
+ * @param[out] data Буфер размером не меньше size байт
+ * @param size Количество байт
+ * @return true, если прочитаны все байты (false и при достижении конца файла)
+ */
+bool readFromDescriptorAt(int fd, uint64_t offset, char *data, size_t size);
+
+/**
+ * @brief Дочитывает файл по дескриптору от указанного смещения до текущего конца файла (с
+ * повтором при частичном чтении), не изменяя позицию дескриптора
+ * @param fd Дескриптор файла
+ * @param offset Смещение, с которого начинается чтение
+ * @param[out] data Буфер, в конец которого дописываются прочитанные данные
+ * @return true, если файл прочитан до конца
+ */
+bool readFromDescriptor(int fd, uint64_t offset, std::string &data);
+
+/**
+ * @brief Сбрасывает данные файла на диск без синхронизации директории
+ * @param fd Дескриптор файла
+ * @return true, если данные зафиксированы на диске
+ */
+bool syncFileData(int fd);
+
+/**
+ * @brief Проверяет, что дескриптор всё ещё указывает на файл по указанному пути (файл мог быть
+ * атомарно заменён другим процессом)
+ * @param fd Дескриптор файла
+ * @param filePath Путь к файлу
+ * @return true, если дескриптор и путь указывают на один и тот же файл
+ */
+bool isDescriptorOfFile(int fd, const std::filesystem::path &filePath);
+
+/**
+ * @brief Возвращает текущий размер файла по дескриптору
+ * @param fd Дескриптор файла
+ * @return Размер файла в байтах или std::nullopt при ошибке
+ */
+std::optional<uint64_t> getDescriptorFileSize(int fd);
+
+/**
+ * @brief Заранее выделяет место на диске под файл, не изменяя его размер, чтобы последующая
+ * дозапись не требовала выделения новых блоков. Если файловая система или платформа не
+ * поддерживают выделение, файл остаётся без изменений
+ * @param fd Дескриптор файла
+ * @param size Размер выделяемой области от начала файла
+ * @return true, если место выделено
+ */
+bool preallocateFile(int fd, uint64_t size);
+
+/**
+ * @brief Освобождает место, заранее выделенное за концом файла (см. preallocateFile)
+ * @param fd Дескриптор файла
+ * @return true, если место освобождено
+ */
+bool releasePreallocatedSpace(int fd);
+
+/**
+ * @brief Закрывает дескриптор файла
+ * @param fd Дескриптор файла
+ */
+void closeDescriptor(int fd);
+
 /**
  * @brief Создаёт резервную копию файла с временной меткой в имени
  * @param filePath Путь к файлу для резервного копирования
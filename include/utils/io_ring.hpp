@@ -0,0 +1,118 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace octet::utils {
+/**
+ * @class IoRing
+ * @brief Очередь асинхронного ввода-вывода io_uring (Linux) для записи файлов.
+ *
+ * Очередь работает напрямую через системные вызовы io_uring_setup/io_uring_enter, без liburing.
+ * Запись и последующая синхронизация передаются ядру одной связанной парой операций, поэтому
+ * фиксация данных требует одного системного вызова вместо двух. Данные копируются в буферы,
+ * заранее зарегистрированные в ядре, поэтому ядру не нужно закреплять страницы при каждой записи,
+ * а вызывающий может сразу переиспользовать свой буфер: записи из queueWrite выполняются, пока
+ * вызывающий готовит следующие данные.
+ *
+ * Если ядро не поддерживает io_uring, система запрещает его (например, seccomp контейнера) или
+ * библиотека собрана без него, очередь недоступна (isAvailable), и вызывающий использует обычные
+ * системные вызовы. Очередь не потокобезопасна и ничего не пишет в лог, поэтому её можно
+ * использовать в дочернем процессе после fork.
+ */
+class IoRing {
+public:
+    // Размер одного зарегистрированного буфера
+    static constexpr size_t BUFFER_SIZE = 1024 * 1024;
+
+    /**
+     * @brief Конструктор, создаёт очередь и регистрирует буферы
+     * @param bufferCount Количество буферов (не больше числа одновременных записей)
+     */
+    explicit IoRing(size_t bufferCount = 1);
+
+    /**
+     * @brief Деструктор, дожидается поставленных записей и освобождает очередь
+     */
+    ~IoRing();
+
+    /**
+     * @brief Проверяет, поддерживает ли сборка io_uring
+     * @return true если библиотека собрана с поддержкой io_uring
+     */
+    static bool isSupported() noexcept;
+
+    /**
+     * @brief Проверяет, удалось ли создать очередь
+     * @return true если очередь можно использовать
+     */
+    bool isAvailable() const noexcept;
+
+    /**
+     * @brief Записывает данные и фиксирует их на диске связанной парой операций write и
+     * fdatasync, дожидаясь завершения обеих
+     * @param fd Дескриптор файла
+     * @param offset Смещение записи (для файла, открытого с O_APPEND, данные дописываются в конец)
+     * @param data Данные
+     * @param size Размер данных
+     * @param sync Фиксировать ли данные на диске
+     * @return true если данные записаны (и зафиксированы)
+     */
+    bool write(int fd, uint64_t offset, const char *data, size_t size, bool sync);
+
+    /**
+     * @brief Ставит запись в очередь, копируя данные в свободные буферы. Если свободных буферов
+     * нет, дожидается завершения одной из поставленных записей
+     * @param fd Дескриптор файла
+     * @param offset Смещение записи
+     * @param data Данные
+     * @param size Размер данных
+     * @return false если одна из записей завершилась ошибкой
+     */
+    bool queueWrite(int fd, uint64_t offset, const char *data, size_t size);
+
+    /**
+     * @brief Дожидается всех поставленных записей и фиксирует файл на диске
+     * @param fd Дескриптор файла
+     * @param dataOnly Фиксировать только данные (fdatasync), а не все метаданные (fsync)
+     * @return true если все записи выполнены и файл зафиксирован
+     */
+    bool drainAndSync(int fd, bool dataOnly);
+
+    /**
+     * @brief Возвращает код последней ошибки
+     * @return Значение errno последней неудачной операции
+     */
+    int lastError() const noexcept;
+
+    // Запрещаем копирование и перемещение
+    IoRing(const IoRing &) = delete;
+    IoRing &operator=(const IoRing &) = delete;
+    IoRing(IoRing &&) = delete;
+    IoRing &operator=(IoRing &&) = delete;
+
+private:
+    struct Ring; // Отображённые кольца очереди (определено в io_ring.cpp)
+
+    Ring *ring_ = nullptr;
+    std::vector<char *> buffers_; // Зарегистрированные буферы
+    std::vector<size_t> freeBuffers_; // Номера свободных буферов
+    size_t inFlight_ = 0; // Количество поставленных и не завершённых операций
+    bool failed_ = false; // Завершилась ли ошибкой одна из поставленных записей
+    int lastError_ = 0;
+
+    /**
+     * @brief Передаёт ядру поставленные операции и дожидается завершения указанного их числа
+     * @param minComplete Количество завершений, которого нужно дождаться
+     * @return true если системный вызов выполнен
+     */
+    bool enter(unsigned minComplete);
+
+    /**
+     * @brief Обрабатывает завершённые операции: освобождает буферы и дописывает частично
+     * выполненные записи
+     */
+    void reap();
+};
+} // namespace octet::utils
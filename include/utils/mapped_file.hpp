@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <string_view>
+
+namespace octet::utils {
+/**
+ * @class MappedFile
+ * @brief Отображает файл в память только для чтения.
+ *
+ * Использует RAII-подход: файл отображается в конструкторе и освобождается в деструкторе.
+ * Содержимое доступно через std::string_view без копирования в пользовательский буфер, а страницы
+ * подгружаются ОС по мере чтения, поэтому разбор больших файлов не требует выделения памяти под
+ * весь файл. Отображение фиксирует размер файла на момент открытия: дописанные позже данные в
+ * него не попадают, а атомарная замена файла на него не влияет.
+ */
+class MappedFile {
+public:
+    /**
+     * @brief Конструктор, открывает и отображает файл в память
+     * @param filePath Путь к файлу
+     * @param sequential Будет ли файл читаться последовательно (подсказка ОС для упреждающего
+     * чтения)
+     */
+    explicit MappedFile(const std::filesystem::path &filePath, bool sequential = true);
+
+    /**
+     * @brief Деструктор, освобождает отображение
+     */
+    ~MappedFile();
+
+    /**
+     * @brief Проверяет, удалось ли отобразить файл
+     * @return true, если файл успешно отображен (в том числе, если файл пустой)
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief Возвращает содержимое файла
+     * @return Представление содержимого файла, действительное до уничтожения объекта
+     */
+    std::string_view view() const;
+
+    /**
+     * @brief Возвращает размер отображенной части файла
+     * @return Размер в байтах
+     */
+    size_t size() const;
+
+private:
+    // Запрещаем копирование и присваивание
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+    MappedFile(MappedFile &&) = delete;
+    MappedFile &operator=(MappedFile &&) = delete;
+
+    // Начало отображения (nullptr для пустого или не отображенного файла)
+    const char *data_ = nullptr;
+    // Размер отображения
+    size_t size_ = 0;
+    // Состояние отображения
+    bool mapped_ = false;
+};
+} // namespace octet::utils
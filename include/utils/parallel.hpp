@@ -0,0 +1,54 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+namespace octet::utils {
+/**
+ * @brief Возвращает число потоков для параллельной обработки по умолчанию
+ * @return Количество аппаратных потоков (не менее одного)
+ */
+inline size_t defaultParallelism()
+{
+    return std::max<size_t>(1, std::thread::hardware_concurrency());
+}
+
+/**
+ * @brief Вызывает функцию для каждого индекса из [0, count) в нескольких потоках. Индексы
+ * распределяются между потоками динамически, вызывающий поток также участвует в обработке
+ * @param count Количество индексов
+ * @param func Функция с сигнатурой void(size_t), не должна выбрасывать исключения
+ * @param maxThreads Максимальное количество потоков (по умолчанию по числу аппаратных потоков)
+ */
+template <typename Func>
+void parallelFor(size_t count, Func &&func, size_t maxThreads = defaultParallelism())
+{
+    const auto threadCount = std::min(count, std::max<size_t>(1, maxThreads));
+    if (threadCount <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            func(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex{ 0 };
+    auto worker = [&] {
+        for (auto i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+            func(i);
+        }
+    };
+
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount - 1);
+    for (size_t i = 1; i < threadCount; i++) {
+        threads.emplace_back(worker);
+    }
+    worker();
+    for (auto &thread : threads) {
+        thread.join();
+    }
+}
+} // namespace octet::utils
@@ -1,5 +1,6 @@
 #include "logger.hpp"
 
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <filesystem>
@@ -16,29 +17,27 @@
 #include "utils/compiler.hpp"
 
 namespace {
+// Количество сообщений в кольцевом буфере потока
+static constexpr size_t LOG_RING_CAPACITY = 1024;
+// Максимальное время сна потока записи без новых сообщений
+static constexpr auto LOG_WRITER_IDLE_INTERVAL = std::chrono::milliseconds(20);
+
 /**
- * @brief Получение текущего времени в формате для лога
- * @return Строка с текущим временем в формате "YYYY-MM-DD HH:MM:SS.mmm"
+ * @brief Форматирование времени для лога
+ * @param time Время
+ * @return Строка со временем в формате "YYYY-MM-DD HH:MM:SS.mmm"
  */
-std::string getCurrentTimeFormatted()
+std::string formatTime(std::chrono::system_clock::time_point time)
 {
-    // Получаем текущее время из системных часов
-    auto now = std::chrono::system_clock::now();
-    // now -> time_t для использования localtime
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
+    // time -> time_t для использования localtime
+    auto time_t_now = std::chrono::system_clock::to_time_t(time);
     // Получаем миллисекунды текущей секунды
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(time.time_since_epoch()) % 1000;
 
     std::ostringstream oss;
     oss << std::put_time(std::localtime(&time_t_now), "%Y-%m-%d %H:%M:%S") << '.'
         << std::setfill('0') << std::setw(3) << ms.count();
     return oss.str();
-
-    char buffer[32];
-    std::strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", std::localtime(&time_t_now));
-    std::string result(buffer);
-    result += "." + std::to_string(ms.count());
-    return result;
 }
 
 /**
@@ -71,6 +70,66 @@ constexpr const char *CYAN = "\033[36m"; // Голубой (для трасси
 } // namespace ConsoleColor
 
 namespace octet {
+struct Logger::Record {
+    LogLevel level = LogLevel::INFO; // Уровень сообщения
+    std::chrono::system_clock::time_point time; // Время логирования
+    std::string message; // Текст сообщения (без форматирования)
+    std::string_view file; // Имя файла
+    int line = 0; // Номер строки
+};
+
+/**
+ * @brief Кольцевой буфер сообщений одного потока: пишет только поток-владелец, читает только
+ * поток записи, поэтому достаточно двух атомарных счетчиков без блокировок
+ */
+class Logger::Ring {
+public:
+    Ring()
+        : slots_(new Record[LOG_RING_CAPACITY])
+    {
+    }
+
+    bool tryPush(Record &&record)
+    {
+        const auto tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == LOG_RING_CAPACITY) {
+            return false;
+        }
+        slots_[tail % LOG_RING_CAPACITY] = std::move(record);
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool tryPop(Record &record)
+    {
+        const auto head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        record = std::move(slots_[head % LOG_RING_CAPACITY]);
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Количество сообщений, помещенных в буфер за все время
+    uint64_t pushed() const { return tail_.load(std::memory_order_acquire); }
+    // Количество сообщений, извлеченных из буфера за все время
+    uint64_t popped() const { return head_.load(std::memory_order_acquire); }
+
+private:
+    std::unique_ptr<Record[]> slots_; // Сообщения
+    alignas(64) std::atomic<uint64_t> head_{ 0 }; // Следующее сообщение для вывода
+    alignas(64) std::atomic<uint64_t> tail_{ 0 }; // Следующее свободное место
+};
+
+// Логгер хранит копию указателя, поэтому сообщения завершившегося потока все равно будут выведены
+thread_local std::shared_ptr<Logger::Ring> Logger::threadRing_;
+
+namespace {
+// Является ли текущий поток потоком записи
+thread_local bool isWriterThread = false;
+} // namespace
+
 std::string errnoToString(int errnum)
 {
     char buffer[128] = { 0 };
@@ -113,11 +172,15 @@ Logger::Logger()
     , formatMessage_(false)
     , logFilePath_(std::nullopt)
     , minimumLevel_(LogLevel::INFO)
+    , async_(false)
+    , wakeup_(false)
 {
 }
 
 Logger::~Logger()
 {
+    // Выводим оставшиеся сообщения и останавливаем поток записи
+    setAsync(false);
 }
 
 void Logger::enable(bool logToConsole, std::optional<std::filesystem::path> logFile,
@@ -149,14 +212,26 @@ void Logger::enable(bool logToConsole, std::optional<std::filesystem::path> logF
                 std::filesystem::create_directories(dir);
             }
 
+            // Файл открывается один раз и остается открытым до смены файла
+            if (logFile_.is_open()) {
+                logFile_.close();
+            }
+            logFile_.clear();
+            logFile_.open(*logFilePath_, std::ios::out | std::ios::app);
+
             // Записываем заголовок при инициализации лог-файла
-            std::ofstream file(*logFilePath_, std::ios::out | std::ios::app);
-            if (file) {
-                file << "--- OCTET логирование начато в " << getCurrentTimeFormatted() << " ---"
-                     << std::endl;
-                file.close();
+            if (logFile_) {
+                logFile_ << "--- OCTET логирование начато в "
+                         << formatTime(std::chrono::system_clock::now()) << " ---" << std::endl;
+            }
+            else {
+                std::cerr << "OCTET: Не удалось открыть файл для записи: " << *logFilePath_
+                          << std::endl;
             }
         }
+        else if (logFile_.is_open()) {
+            logFile_.close();
+        }
 
         // Формируем сообщение с конфигурацией логгера
         configMsg << "Логирование включено (минимальный уровень: " << levelToString(minimumLevel_)
@@ -174,50 +249,56 @@ void Logger::enable(bool logToConsole, std::optional<std::filesystem::path> logF
 
 void Logger::disable()
 {
+    log(LogLevel::INFO, "Логирование отключено", __FILE__, __LINE__);
+    flush();
     std::lock_guard<std::mutex> lock(logMutex_);
-    log(LogLevel::INFO, "Логирование отключено", __FILE__, __LINE__, false);
     enabled_ = false;
 }
 
 bool Logger::isEnabled() const
 {
-    return enabled_;
+    return enabled_.load(std::memory_order_relaxed);
 }
 
 void Logger::setMinLogLevel(LogLevel level)
 {
-    std::lock_guard<std::mutex> lock(logMutex_);
-    minimumLevel_ = level;
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        minimumLevel_ = level;
+    }
 
+    // Логируем вне блокировки: в асинхронном режиме поток записи выводит сообщения под ней
     if (enabled_) {
         std::ostringstream oss;
         oss << "Минимальный уровень логирования установлен на " << levelToString(level);
-        log(LogLevel::INFO, oss.str(), __FILE__, __LINE__, false);
+        log(LogLevel::INFO, oss.str(), __FILE__, __LINE__);
     }
 }
 
 LogLevel Logger::getMinLogLevel() const
 {
-    return minimumLevel_;
+    return minimumLevel_.load(std::memory_order_relaxed);
 }
 
 void Logger::setUseColors(bool useColors)
 {
-    std::lock_guard<std::mutex> lock(logMutex_);
-
     // Устанавливаем использование цветов, если это запрошено и поддерживается
     const auto isColorSupported = isColorSupportedByTerminal();
     if (useColors && !isColorSupported) {
         log(LogLevel::WARNING,
             "Включена поддержка цветного вывода, однако текущая консоль не поддерживает ANSI "
             "цвета",
-            __FILE__, __LINE__, false);
+            __FILE__, __LINE__);
+    }
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        colorOutput_ = useColors && isColorSupported;
     }
-    colorOutput_ = useColors && isColorSupported;
 
     log(LogLevel::INFO,
-        "Использование цветного вывода " + std::string(colorOutput_ ? "включено" : "отключено"),
-        __FILE__, __LINE__, false);
+        "Использование цветного вывода " + std::string(useColors && isColorSupported ? "включено"
+                                                                                     : "отключено"),
+        __FILE__, __LINE__);
 }
 
 bool Logger::getUseColors() const
@@ -235,11 +316,85 @@ bool Logger::getFormatMessage() const
     return formatMessage_;
 }
 
-void Logger::log(LogLevel level, const std::string &message, const std::string_view file, int line,
+void Logger::setAsync(bool async)
+{
+    std::lock_guard<std::mutex> asyncLock(asyncMutex_);
+    if (async == writer_.joinable()) {
+        return;
+    }
+
+    if (async) {
+        writerRunning_ = true;
+        writer_ = std::thread(&Logger::writerLoop, this);
+        async_.store(true, std::memory_order_release);
+        return;
+    }
+
+    // Новые сообщения выводятся синхронно, а уже помещенные в буферы выводит поток записи
+    async_.store(false, std::memory_order_release);
+    {
+        std::lock_guard<std::mutex> lock(writerMutex_);
+        writerRunning_ = false;
+    }
+    writerCv_.notify_one();
+    writer_.join();
+    // Сообщения, помещенные в буферы после последнего прохода потока записи
+    drainRings();
+}
+
+bool Logger::isAsync() const
+{
+    return async_.load(std::memory_order_acquire);
+}
+
+void Logger::flush()
+{
+    // Поток записи не может ждать сам себя (например, при логировании из writeRecord)
+    if (!isAsync() || isWriterThread) {
+        return;
+    }
+
+    // Запоминаем, сколько сообщений уже помещено в каждый буфер
+    std::vector<std::pair<std::shared_ptr<Ring>, uint64_t>> targets;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        targets.reserve(rings_.size());
+        for (const auto &ring : rings_) {
+            targets.emplace_back(ring, ring->pushed());
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    wakeup_.store(true, std::memory_order_release);
+    writerCv_.notify_one();
+    drainedCv_.wait(lock, [&] {
+        if (!writerRunning_) {
+            return true;
+        }
+        for (const auto &[ring, pushed] : targets) {
+            if (ring->popped() < pushed) {
+                return false;
+            }
+        }
+        return true;
+    });
+}
+
+void Logger::log(LogLevel level, std::string message, const std::string_view file, int line,
                  bool useLock)
 {
     // Проверяем, включено ли логирование и подходит ли уровень сообщения
-    if (!enabled_ || level < minimumLevel_) {
+    if (!isEnabled() || level < getMinLogLevel()) {
+        return;
+    }
+
+    Record record{ level, std::chrono::system_clock::now(), std::move(message), file, line };
+    if (isAsync()) {
+        enqueue(std::move(record));
+        // Критические сообщения выводятся до возврата (например, перед аварийным завершением)
+        if (level >= LogLevel::CRITICAL) {
+            flush();
+        }
         return;
     }
 
@@ -247,13 +402,19 @@ void Logger::log(LogLevel level, const std::string &message, const std::string_v
     if (useLock) {
         lock.lock();
     }
+    writeRecord(record);
+}
 
+void Logger::writeRecord(const Record &record)
+{
     // Форматируем сообщение (если нужно)
-    auto formattedMessage = formatMessage_ ? formatLogMessage(level, message, file, line) : message;
+    auto formattedMessage = formatMessage_ ? formatLogMessage(record.level, record.message,
+                                                              record.file, record.line, record.time)
+                                           : record.message;
 
     // Выводим в консоль, если необходимо
     if (consoleOutput_) {
-        writeToConsole(formattedMessage, level);
+        writeToConsole(formattedMessage, record.level);
     }
 
     // Записываем в файл, если указан путь
@@ -262,6 +423,86 @@ void Logger::log(LogLevel level, const std::string &message, const std::string_v
     }
 }
 
+void Logger::enqueue(Record &&record)
+{
+    if (threadRing_ == nullptr) {
+        threadRing_ = std::make_shared<Ring>();
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings_.push_back(threadRing_);
+    }
+
+    // Буфер заполнен: ждем, пока поток записи освободит место
+    while (!threadRing_->tryPush(std::move(record))) {
+        wakeWriter();
+        std::this_thread::yield();
+    }
+    // Поток записи пробуждается только первым сообщением после его засыпания
+    if (!wakeup_.exchange(true, std::memory_order_acq_rel)) {
+        writerCv_.notify_one();
+    }
+}
+
+void Logger::wakeWriter()
+{
+    std::lock_guard<std::mutex> lock(writerMutex_);
+    wakeup_.store(true, std::memory_order_release);
+    writerCv_.notify_one();
+}
+
+void Logger::writerLoop()
+{
+    isWriterThread = true;
+    std::unique_lock<std::mutex> lock(writerMutex_);
+    while (writerRunning_) {
+        wakeup_.store(false, std::memory_order_release);
+        lock.unlock();
+        drainRings();
+        lock.lock();
+        drainedCv_.notify_all();
+
+        // Уведомление без блокировки может быть пропущено, поэтому сон ограничен по времени
+        writerCv_.wait_for(lock, LOG_WRITER_IDLE_INTERVAL, [this] {
+            return !writerRunning_ || wakeup_.load(std::memory_order_acquire);
+        });
+    }
+    lock.unlock();
+    drainRings();
+    lock.lock();
+    drainedCv_.notify_all();
+}
+
+void Logger::drainRings()
+{
+    std::vector<std::shared_ptr<Ring>> rings;
+    {
+        std::lock_guard<std::mutex> lock(ringsMutex_);
+        rings = rings_;
+    }
+
+    Record record;
+    {
+        std::lock_guard<std::mutex> lock(logMutex_);
+        for (const auto &ring : rings) {
+            while (ring->tryPop(record)) {
+                writeRecord(record);
+            }
+        }
+        if (logFile_.is_open()) {
+            logFile_.flush();
+        }
+    }
+    rings.clear();
+
+    // Удаляем опустошенные буферы завершившихся потоков
+    std::lock_guard<std::mutex> lock(ringsMutex_);
+    rings_.erase(std::remove_if(rings_.begin(), rings_.end(),
+                                [](const auto &ring) {
+                                    return ring.use_count() == 1
+                                        && ring->popped() == ring->pushed();
+                                }),
+                 rings_.end());
+}
+
 std::string Logger::levelToString(LogLevel level)
 {
     switch (level) {
@@ -285,13 +526,14 @@ std::string Logger::levelToString(LogLevel level)
 }
 
 std::string Logger::formatLogMessage(LogLevel level, const std::string &message,
-                                     const std::string_view file, int line) const
+                                     const std::string_view file, int line,
+                                     std::chrono::system_clock::time_point time) const
 {
     std::ostringstream oss;
 
     // Формат для файла: [ВРЕМЯ] [УРОВЕНЬ] [ФАЙЛ:СТРОКА] Сообщение
     // Для консоли добавляем префикс `OCTET` (если включен)
-    oss << "[" << getCurrentTimeFormatted() << "] "
+    oss << "[" << formatTime(time) << "] "
         << "[" << levelToString(level) << "] ";
 
     if (!file.empty()) {
@@ -305,19 +547,21 @@ std::string Logger::formatLogMessage(LogLevel level, const std::string &message,
 
 bool Logger::writeToFile(const std::string &formattedMessage)
 {
-    if (!logFilePath_.has_value()) {
+    if (!logFile_.is_open()) {
         return false;
     }
 
-    // Открываем файл в режиме добавления
-    std::ofstream file(*logFilePath_, std::ios::out | std::ios::app);
-    if (!file) {
-        std::cerr << "OCTET: Не удалось открыть файл для записи: " << *logFilePath_ << std::endl;
+    // Записываем сообщение и добавляем перевод строки (в асинхронном режиме буфер файла
+    // сбрасывается после каждого прохода потока записи)
+    logFile_ << formattedMessage << '\n';
+    if (!isAsync()) {
+        logFile_.flush();
+    }
+    if (!logFile_) {
+        std::cerr << "OCTET: Не удалось записать в файл: " << *logFilePath_ << std::endl;
+        logFile_.clear();
         return false;
     }
-
-    // Записываем сообщение и добавляем перевод строки
-    file << formattedMessage << std::endl;
     return true;
 }
 
@@ -400,6 +644,7 @@ bool Logger::isColorSupportedByTerminal() const
 
 LogStream::LogStream(LogLevel level, const std::string_view file, int line)
     : level_(level)
+    , active_(Logger::getInstance().isEnabled() && level >= Logger::getInstance().getMinLogLevel())
     , file_(file)
     , line_(line)
 {
@@ -409,7 +654,10 @@ LogStream::~LogStream()
 {
     // Отправляем собранное сообщение в логгер при уничтожении объекта
     // Это позволяет использовать потоковый синтаксис для логирования
-    Logger::getInstance().log(level_, stream_.str(), file_, line_);
+    if (active_) {
+        Logger::getInstance().log(level_, stream_.has_value() ? stream_->str() : std::string(),
+                                  file_, line_);
+    }
 }
 
 } // namespace octet
@@ -0,0 +1,324 @@
+#include "metrics.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+#include "storage/value_allocator.hpp"
+
+namespace {
+/**
+ * @struct MetricDescription
+ * @brief Описание показателя для вывода в формате Prometheus. Показатели с одним именем
+ * различаются значением метки
+ */
+struct MetricDescription {
+    const char *name; // Имя показателя
+    const char *help; // Описание показателя
+    const char *label; // Метка в формате `имя="значение"` (пустая строка - без метки)
+    double scale; // Множитель для перевода значений в единицы показателя
+};
+
+// Длительности записываются в наносекундах, а Prometheus ожидает секунды
+static constexpr double NANOSECONDS = 1e-9;
+
+// Квантили распределений
+static constexpr double QUANTILES[] = { 0.5, 0.9, 0.99, 0.999 };
+
+static constexpr MetricDescription COUNTERS[] = {
+    { "octet_storage_failures_total", "Storage operations that failed", "", 1 },
+    { "octet_journal_bytes_total", "Bytes appended to the journal", "", 1 },
+    { "octet_journal_fsyncs_total", "Journal fdatasync calls", "", 1 },
+    { "octet_snapshot_bytes_total", "Bytes written to snapshot files", "", 1 },
+    { "octet_snapshot_failures_total", "Snapshots that could not be created", "", 1 },
+    { "octet_value_log_reads_total", "Values read from the value log on disk", "", 1 },
+    { "octet_value_cache_hits_total", "Value log reads served from the value cache", "", 1 },
+};
+static_assert(std::size(COUNTERS) == size_t(octet::MetricCounter::COUNT));
+
+static constexpr MetricDescription GAUGES[] = {
+    { "octet_snapshot_size_bytes", "Size of the last written snapshot", "kind=\"full\"", 1 },
+    { "octet_snapshot_size_bytes", "Size of the last written snapshot", "kind=\"delta\"", 1 },
+    { "octet_loaded_entries", "Entries loaded from disk at startup", "", 1 },
+    { "octet_write_queue_frames", "Response frames queued for writing on all connections", "",
+      1 },
+    { "octet_value_memory_bytes", "Memory used by record values stored outside table slots",
+      "kind=\"live\"", 1 },
+    { "octet_value_memory_bytes", "Memory used by record values stored outside table slots",
+      "kind=\"allocated\"", 1 },
+    { "octet_value_memory_bytes", "Memory used by record values stored outside table slots",
+      "kind=\"reserved\"", 1 },
+    { "octet_value_slabs", "Slabs held by the record value allocator", "", 1 },
+    { "octet_value_log_bytes", "Size of the on-disk value log", "kind=\"disk\"", 1 },
+    { "octet_value_log_bytes", "Size of the on-disk value log", "kind=\"live\"", 1 },
+    { "octet_value_cache_bytes", "Bytes of values held in the value cache", "", 1 },
+};
+static_assert(std::size(GAUGES) == size_t(octet::MetricGauge::COUNT));
+
+static constexpr char OPERATION_DURATION_NAME[] = "octet_storage_operation_duration_seconds";
+static constexpr char OPERATION_DURATION_HELP[] = "Latency of StorageManager operations";
+static constexpr char SNAPSHOT_DURATION_NAME[] = "octet_snapshot_duration_seconds";
+static constexpr char SNAPSHOT_DURATION_HELP[] = "Time to create a snapshot";
+
+static constexpr MetricDescription HISTOGRAMS[] = {
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"insert\"", NANOSECONDS },
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"get\"", NANOSECONDS },
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"update\"", NANOSECONDS },
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"remove\"", NANOSECONDS },
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"batch\"", NANOSECONDS },
+    { OPERATION_DURATION_NAME, OPERATION_DURATION_HELP, "operation=\"mget\"", NANOSECONDS },
+    { "octet_journal_append_duration_seconds",
+      "Time to append a batch to the journal, including fdatasync", "", NANOSECONDS },
+    { "octet_journal_fsync_duration_seconds", "Journal fdatasync latency", "", NANOSECONDS },
+    { SNAPSHOT_DURATION_NAME, SNAPSHOT_DURATION_HELP, "kind=\"full\"", NANOSECONDS },
+    { SNAPSHOT_DURATION_NAME, SNAPSHOT_DURATION_HELP, "kind=\"delta\"", NANOSECONDS },
+    { "octet_load_duration_seconds", "Time to load snapshots and replay the journal at startup",
+      "", NANOSECONDS },
+    { "octet_file_lock_wait_seconds", "Time spent waiting for file locks", "", NANOSECONDS },
+    { "octet_write_queue_depth", "Write queue length of a connection when a frame is queued",
+      "", 1 },
+};
+static_assert(std::size(HISTOGRAMS) == size_t(octet::MetricHistogram::COUNT));
+
+/**
+ * @brief Дописывает строки HELP и TYPE, если показатель с этим именем ещё не выводился (все
+ * показатели одного имени идут подряд)
+ */
+void writeHeader(std::ostringstream &out, const MetricDescription &metric, const char *type,
+                 const char *&previousName)
+{
+    if (previousName != nullptr && std::string_view(previousName) == metric.name) {
+        return;
+    }
+    previousName = metric.name;
+    out << "# HELP " << metric.name << ' ' << metric.help << '\n'
+        << "# TYPE " << metric.name << ' ' << type << '\n';
+}
+
+/**
+ * @brief Дописывает строку значения показателя
+ */
+void writeSample(std::ostringstream &out, std::string_view name, std::string_view label,
+                 std::string_view extraLabel, double value)
+{
+    out << name;
+    if (!label.empty() || !extraLabel.empty()) {
+        out << '{' << label << (!label.empty() && !extraLabel.empty() ? "," : "") << extraLabel
+            << '}';
+    }
+    out << ' ' << value << '\n';
+}
+
+/**
+ * @brief Прибавляет значение к атомарной переменной, которую изменяет только текущий поток (без
+ * read-modify-write операции)
+ */
+inline void addOwned(std::atomic<uint64_t> &target, uint64_t value)
+{
+    target.store(target.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+} // namespace
+
+namespace octet {
+/**
+ * @class Metrics::Shard
+ * @brief Счётчики и распределения одного потока. Изменяются только потоком-владельцем, а
+ * читаются при суммировании, поэтому значения атомарны, но изменяются без read-modify-write
+ */
+class alignas(64) Metrics::Shard {
+public:
+    struct Histogram {
+        std::atomic<uint64_t> count{ 0 };
+        std::atomic<uint64_t> sum{ 0 };
+        std::atomic<uint64_t> max{ 0 };
+        std::array<std::atomic<uint64_t>, HistogramSnapshot::BUCKET_COUNT> buckets{};
+    };
+
+    std::array<std::atomic<uint64_t>, size_t(MetricCounter::COUNT)> counters{};
+    std::array<Histogram, size_t(MetricHistogram::COUNT)> histograms;
+};
+
+thread_local std::shared_ptr<Metrics::Shard> Metrics::threadShard_;
+
+size_t HistogramSnapshot::bucketIndex(uint64_t value)
+{
+    value = std::min(value, MAX_TRACKABLE_VALUE);
+    if (value < SUB_BUCKET_COUNT) {
+        return static_cast<size_t>(value);
+    }
+    // Номер старшего бита определяет интервал, а следующие SUB_BUCKET_BITS бит - корзину в нём
+    size_t exponent = 0;
+    for (auto rest = value; rest > 1; rest >>= 1) {
+        exponent++;
+    }
+    const auto shift = exponent - SUB_BUCKET_BITS;
+    const auto subBucket = static_cast<size_t>(value >> shift) & (SUB_BUCKET_COUNT - 1);
+    return (shift + 1) * SUB_BUCKET_COUNT + subBucket;
+}
+
+uint64_t HistogramSnapshot::bucketUpperBound(size_t index)
+{
+    if (index < SUB_BUCKET_COUNT) {
+        return index;
+    }
+    const auto shift = index / SUB_BUCKET_COUNT - 1;
+    const auto subBucket = index % SUB_BUCKET_COUNT;
+    return ((uint64_t(SUB_BUCKET_COUNT + subBucket + 1)) << shift) - 1;
+}
+
+uint64_t HistogramSnapshot::valueAtQuantile(double quantile) const
+{
+    if (count == 0 || buckets.empty()) {
+        return 0;
+    }
+    quantile = std::clamp(quantile, 0.0, 1.0);
+    const auto rank = std::max<uint64_t>(
+        1, static_cast<uint64_t>(std::ceil(quantile * static_cast<double>(count))));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); i++) {
+        seen += buckets[i];
+        if (seen >= rank) {
+            return std::min(bucketUpperBound(i), max);
+        }
+    }
+    return max;
+}
+
+double HistogramSnapshot::mean() const
+{
+    return count == 0 ? 0.0 : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+std::string MetricsSnapshot::toPrometheus() const
+{
+    std::ostringstream out;
+    out << std::setprecision(9);
+    const char *previousName = nullptr;
+
+    for (size_t i = 0; i < counters.size(); i++) {
+        writeHeader(out, COUNTERS[i], "counter", previousName);
+        writeSample(out, COUNTERS[i].name, COUNTERS[i].label, {},
+                    static_cast<double>(counters[i]) * COUNTERS[i].scale);
+    }
+    for (size_t i = 0; i < gauges.size(); i++) {
+        writeHeader(out, GAUGES[i], "gauge", previousName);
+        writeSample(out, GAUGES[i].name, GAUGES[i].label, {},
+                    static_cast<double>(gauges[i]) * GAUGES[i].scale);
+    }
+    for (size_t i = 0; i < histograms.size(); i++) {
+        const auto &metric = HISTOGRAMS[i];
+        const auto &histogram = histograms[i];
+        writeHeader(out, metric, "summary", previousName);
+        for (const auto quantile : QUANTILES) {
+            std::ostringstream quantileLabel;
+            quantileLabel << "quantile=\"" << quantile << '"';
+            writeSample(out, metric.name, metric.label, quantileLabel.str(),
+                        static_cast<double>(histogram.valueAtQuantile(quantile)) * metric.scale);
+        }
+        writeSample(out, std::string(metric.name) + "_sum", metric.label, {},
+                    static_cast<double>(histogram.sum) * metric.scale);
+        writeSample(out, std::string(metric.name) + "_count", metric.label, {},
+                    static_cast<double>(histogram.count));
+    }
+    return out.str();
+}
+
+Metrics &Metrics::getInstance()
+{
+    static Metrics instance;
+    return instance;
+}
+
+Metrics::Metrics() = default;
+
+Metrics::~Metrics() = default;
+
+Metrics::Shard &Metrics::threadShard()
+{
+    if (threadShard_ == nullptr) {
+        threadShard_ = std::make_shared<Shard>();
+        std::lock_guard<std::mutex> lock(shardsMutex_);
+        shards_.push_back(threadShard_);
+    }
+    return *threadShard_;
+}
+
+void Metrics::increment(MetricCounter metric, uint64_t value)
+{
+    addOwned(threadShard().counters[size_t(metric)], value);
+}
+
+void Metrics::setGauge(MetricGauge metric, int64_t value)
+{
+    gauges_[size_t(metric)].store(value, std::memory_order_relaxed);
+}
+
+void Metrics::addGauge(MetricGauge metric, int64_t delta)
+{
+    gauges_[size_t(metric)].fetch_add(delta, std::memory_order_relaxed);
+}
+
+void Metrics::record(MetricHistogram metric, uint64_t value)
+{
+    auto &histogram = threadShard().histograms[size_t(metric)];
+    addOwned(histogram.buckets[HistogramSnapshot::bucketIndex(value)], 1);
+    addOwned(histogram.sum, value);
+    if (value > histogram.max.load(std::memory_order_relaxed)) {
+        histogram.max.store(value, std::memory_order_relaxed);
+    }
+    // Количество увеличивается последним, поэтому при суммировании оно не больше суммы корзин
+    histogram.count.store(histogram.count.load(std::memory_order_relaxed) + 1,
+                          std::memory_order_release);
+}
+
+void Metrics::recordDuration(MetricHistogram metric, std::chrono::steady_clock::duration duration)
+{
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    record(metric, ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+MetricsSnapshot Metrics::snapshot() const
+{
+    MetricsSnapshot result;
+    for (auto &histogram : result.histograms) {
+        histogram.buckets.assign(HistogramSnapshot::BUCKET_COUNT, 0);
+    }
+    for (size_t i = 0; i < result.gauges.size(); i++) {
+        result.gauges[i] = gauges_[i].load(std::memory_order_relaxed);
+    }
+    const auto values = ValueAllocator::getInstance().stats();
+    result.gauges[size_t(MetricGauge::VALUE_LIVE_BYTES)] = static_cast<int64_t>(values.liveBytes);
+    result.gauges[size_t(MetricGauge::VALUE_ALLOCATED_BYTES)]
+        = static_cast<int64_t>(values.allocatedBytes);
+    result.gauges[size_t(MetricGauge::VALUE_RESERVED_BYTES)]
+        = static_cast<int64_t>(values.reservedBytes);
+    result.gauges[size_t(MetricGauge::VALUE_SLABS)] = static_cast<int64_t>(values.slabs);
+
+    std::lock_guard<std::mutex> lock(shardsMutex_);
+    for (const auto &shard : shards_) {
+        for (size_t i = 0; i < result.counters.size(); i++) {
+            result.counters[i] += shard->counters[i].load(std::memory_order_relaxed);
+        }
+        for (size_t i = 0; i < result.histograms.size(); i++) {
+            const auto &source = shard->histograms[i];
+            auto &target = result.histograms[i];
+            const auto count = source.count.load(std::memory_order_acquire);
+            if (count == 0) {
+                continue;
+            }
+            // Количество берётся по корзинам, чтобы квантили не выходили за их сумму
+            for (size_t bucket = 0; bucket < target.buckets.size(); bucket++) {
+                const auto value = source.buckets[bucket].load(std::memory_order_relaxed);
+                target.buckets[bucket] += value;
+                target.count += value;
+            }
+            target.sum += source.sum.load(std::memory_order_relaxed);
+            target.max = std::max(target.max, source.max.load(std::memory_order_relaxed));
+        }
+    }
+    return result;
+}
+} // namespace octet
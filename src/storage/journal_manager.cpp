@@ -1,19 +1,88 @@
 #include "storage/journal_manager.hpp"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 #include <chrono>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <utility>
 
+#include "utils/byte_order.hpp"
 #include "utils/compiler.hpp"
+#include "utils/compression.hpp"
+#include "utils/crc32c.hpp"
 #include "utils/file_lock_guard.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/io_ring.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/parallel.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
 
 namespace {
-// Константы для форматирования журнала
+// Заголовок журнала в бинарном формате (после него следуют бинарные записи)
+static constexpr char JOURNAL_HEADER[] = "# OCTET Journal Format v2.0\n";
+static constexpr size_t JOURNAL_HEADER_SIZE = sizeof(JOURNAL_HEADER) - 1;
+
+/*
+ * Формат бинарной записи журнала (все числа в little-endian):
+ *   [0]      u8   маркер начала записи (RECORD_MAGIC)
+ *   [1]      u8   тип операции
+ *   [2..3]   u16  длина идентификатора
+ *   [4..7]   u32  длина данных
+ *   [8..15]  u64  временная метка (наносекунды с начала эпохи Unix)
+ *   [16..19] u32  CRC32C байтов [0..15], идентификатора и данных
+ *   далее идентификатор и данные без какого-либо экранирования
+ */
+static constexpr uint8_t RECORD_MAGIC = 0xA5;
+static constexpr size_t RECORD_HEADER_SIZE = 20;
+static constexpr size_t RECORD_CRC_OFFSET = 16;
+
+// Индекс смещений контрольных точек хранится рядом с журналом
+static constexpr char CHECKPOINT_INDEX_SUFFIX[] = ".checkpoints";
+static constexpr char CHECKPOINT_INDEX_HEADER[] = "# OCTET Checkpoint Index v2.0\n";
+static constexpr char CHECKPOINT_INDEX_HEADER_V1[] = "# OCTET Checkpoint Index v1.0\n";
+static constexpr size_t CHECKPOINT_INDEX_HEADER_SIZE = sizeof(CHECKPOINT_INDEX_HEADER) - 1;
+static_assert(sizeof(CHECKPOINT_INDEX_HEADER) == sizeof(CHECKPOINT_INDEX_HEADER_V1));
+
+/*
+ * Формат записи индекса контрольных точек (все числа в little-endian):
+ *   [0..3]   u32  CRC32C байтов [4..21] и идентификатора
+ *   [4..11]  u64  номер запечатанного сегмента с контрольной точкой (0 - активный сегмент)
+ *   [12..19] u64  смещение записи контрольной точки в сегменте
+ *   [20..21] u16  длина идентификатора
+ *   далее идентификатор контрольной точки
+ *
+ * В индексе версии 1 поле номера сегмента отсутствует, а все точки относятся к активному сегменту
+ */
+static constexpr size_t INDEX_ENTRY_HEADER_SIZE = 22;
+static constexpr size_t INDEX_ENTRY_HEADER_SIZE_V1 = 14;
+
+// Запечатанные сегменты журнала хранятся рядом с ним под именем <журнал>.<порядковый номер>
+static constexpr size_t SEGMENT_NUMBER_WIDTH = 6;
+
+/*
+ * Формат сжатого запечатанного сегмента (все числа в little-endian):
+ *   [0..7]   сигнатура (COMPRESSED_SEGMENT_MAGIC)
+ *   [8..11]  u32  алгоритм сжатия (CompressionCodec)
+ *   [12..19] u64  размер исходного сегмента
+ *   [20..23] u32  CRC32C сжатых данных
+ *   далее сжатое содержимое исходного сегмента целиком (вместе с заголовком журнала)
+ */
+static constexpr char COMPRESSED_SEGMENT_MAGIC[] = "OCTJSEGZ";
+static constexpr size_t COMPRESSED_SEGMENT_MAGIC_SIZE = sizeof(COMPRESSED_SEGMENT_MAGIC) - 1;
+static constexpr size_t COMPRESSED_SEGMENT_HEADER_SIZE = COMPRESSED_SEGMENT_MAGIC_SIZE + 16;
+
+// Писатель запечатывает сегмент переименованием и только затем создаёт новый активный сегмент,
+// поэтому читатель может ненадолго не найти активный сегмент и повторяет попытку
+static constexpr size_t READER_RESCAN_ATTEMPTS = 50;
+static constexpr auto READER_RESCAN_DELAY = std::chrono::milliseconds(1);
+
+// Константы для текстового формата журнала v1 (поддерживается только для чтения)
 static constexpr char FIELD_SEPARATOR = '|';
 static constexpr char ESCAPE_CHAR = '\\';
-static constexpr char JOURNAL_HEADER[] = "# OCTET Journal Format v1.0\n";
 
 // Строковые представления типов операций
 // !!! Порядок должен соответствовать порядку в перечислении OperationType
@@ -21,56 +90,28 @@ static const std::array<std::string, 4> OPERATION_TYPE_STRINGS
     = { "INSERT", "UPDATE", "REMOVE", "CHECKPOINT" };
 
 /**
- * @brief Экранирует специальные символы в строке для хранения в журнале
- * @param str Исходная строка
- * @return Экранированная строка
- */
-std::string escapeString(const std::string &str)
-{
-    std::ostringstream result;
-    for (char c : str) {
-        if (c == FIELD_SEPARATOR || c == ESCAPE_CHAR) {
-            // Обычное экранирование для разделителей и экранирующих символов
-            result << ESCAPE_CHAR << c;
-        }
-        else if (c == '\n') {
-            // Заменяем символ новой строки на строковое представление "\n"
-            result << ESCAPE_CHAR << 'n';
-        }
-        else if (c == '\r') {
-            // Заменяем символ возврата каретки на строковое представление "\r"
-            result << ESCAPE_CHAR << 'r';
-        }
-        else {
-            // Обычные символы просто копируем
-            result << c;
-        }
-    }
-    return result.str();
-}
-
-/**
- * @brief Убирает экранирование специальных символов в строке
+ * @brief Убирает экранирование специальных символов в строке (формат v1)
  * @param str Экранированная строка
  * @return Исходная строка без экранирования
  */
-std::string unescapeString(const std::string &str)
+std::string unescapeString(std::string_view str)
 {
-    std::ostringstream result;
+    std::string result;
+    result.reserve(str.size());
     bool escaped = false;
     for (char c : str) {
         if (escaped) {
             if (c == 'n') {
                 // Преобразуем "\n" обратно в символ новой строки
-                result << '\n';
+                result += '\n';
             }
             else if (c == 'r') {
                 // Преобразуем "\r" обратно в символ возврата каретки
-                result << '\r';
+                result += '\r';
             }
             else {
                 // Все остальные экранированные символы добавляем как есть
-                result << c;
+                result += c;
             }
             escaped = false;
         }
@@ -78,26 +119,50 @@ std::string unescapeString(const std::string &str)
             escaped = true;
         }
         else {
-            result << c;
+            result += c;
         }
     }
-    return result.str();
+    return result;
+}
+
+/**
+ * @brief Получает текущее время в наносекундах с начала эпохи Unix
+ * @return Временная метка
+ */
+uint64_t getCurrentTimestampNs()
+{
+    const auto now = std::chrono::system_clock::now().time_since_epoch();
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
 }
 
 /**
- * @brief Форматирует строку ISO 8601 из текущего времени
- * @return Строка с временной меткой
+ * @brief Преобразует временную метку ISO 8601 формата v1 (UTC) в наносекунды с начала эпохи Unix
+ * @param timestamp Строка вида 2023-01-01T12:00:00.000Z
+ * @return Временная метка или 0, если строка имеет некорректный формат
  */
-std::string getCurrentIsoTimestamp()
+uint64_t isoTimestampToNs(std::string_view timestamp)
 {
-    auto now = std::chrono::system_clock::now();
-    auto time_t_now = std::chrono::system_clock::to_time_t(now);
-    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+    const std::string str(timestamp);
+    int year, month, day, hour, minute, second, millis;
+    if (std::sscanf(str.c_str(), "%d-%d-%dT%d:%d:%d.%dZ", &year, &month, &day, &hour, &minute,
+                    &second, &millis)
+        != 7) {
+        return 0;
+    }
 
-    std::ostringstream oss;
-    oss << std::put_time(std::gmtime(&time_t_now), "%Y-%m-%dT%H:%M:%S") << '.' << std::setfill('0')
-        << std::setw(3) << ms.count() << 'Z';
-    return oss.str();
+    // Количество дней от начала эпохи по григорианскому календарю (без обращения к timegm)
+    year -= month <= 2 ? 1 : 0;
+    const int era = (year >= 0 ? year : year - 399) / 400;
+    const int yearOfEra = year - era * 400;
+    const int dayOfYear = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+    const int dayOfEra = yearOfEra * 365 + yearOfEra / 4 - yearOfEra / 100 + dayOfYear;
+    const int64_t days = static_cast<int64_t>(era) * 146097 + dayOfEra - 719468;
+    if (days < 0) {
+        return 0;
+    }
+
+    const int64_t seconds = days * 86400 + hour * 3600 + minute * 60 + second;
+    return static_cast<uint64_t>(seconds) * 1000000000ULL + static_cast<uint64_t>(millis) * 1000000;
 }
 
 /**
@@ -117,7 +182,7 @@ std::string operationTypeToString(octet::OperationType type)
  * @brief Преобразование строки в тип операции
  * @return Операция в формате OperationType
  */
-std::optional<octet::OperationType> stringToOperationType(const std::string &typeStr)
+std::optional<octet::OperationType> stringToOperationType(std::string_view typeStr)
 {
     for (size_t i = 0; i < OPERATION_TYPE_STRINGS.size(); i++) {
         if (typeStr == OPERATION_TYPE_STRINGS[i]) {
@@ -128,13 +193,46 @@ std::optional<octet::OperationType> stringToOperationType(const std::string &typ
 }
 
 /**
- * @brief Чтение строки из содержимого всего журнала
+ * @brief Дописывает бинарную запись журнала в буфер
+ * @param buffer Буфер для дописывания
+ * @param type Тип операции
+ * @param uuid Идентификатор строки (не длиннее UINT16_MAX)
+ * @param data Данные операции (не длиннее UINT32_MAX)
+ * @param timestamp Временная метка в наносекундах
+ */
+void appendRecord(std::string &buffer, octet::OperationType type, std::string_view uuid,
+                  std::string_view data, uint64_t timestamp)
+{
+    assert(uuid.size() <= std::numeric_limits<uint16_t>::max());
+    assert(data.size() <= std::numeric_limits<uint32_t>::max());
+
+    char header[RECORD_HEADER_SIZE];
+    header[0] = static_cast<char>(RECORD_MAGIC);
+    header[1] = static_cast<char>(type);
+    octet::utils::storeLittleEndian(header + 2, static_cast<uint16_t>(uuid.size()));
+    octet::utils::storeLittleEndian(header + 4, static_cast<uint32_t>(data.size()));
+    octet::utils::storeLittleEndian(header + 8, timestamp);
+
+    // Контрольная сумма покрывает заголовок (без самой суммы) и полезную нагрузку
+    auto crc = octet::utils::crc32c(header, RECORD_CRC_OFFSET);
+    crc = octet::utils::crc32c(uuid.data(), uuid.size(), crc);
+    crc = octet::utils::crc32c(data.data(), data.size(), crc);
+    octet::utils::storeLittleEndian(header + RECORD_CRC_OFFSET, crc);
+
+    buffer.reserve(buffer.size() + RECORD_HEADER_SIZE + uuid.size() + data.size());
+    buffer.append(header, RECORD_HEADER_SIZE);
+    buffer.append(uuid.data(), uuid.size());
+    buffer.append(data.data(), data.size());
+}
+
+/**
+ * @brief Чтение строки из содержимого журнала формата v1
  * @param content Содержимое всего журнала
  * @param pos Начальная позиция чтения
  * @return Строка из журнала или std::nullopt при ошибке чтения или если строка пустая или является
  * комментарием
  */
-std::optional<std::string> readLineFromJournalContent(const std::string &content, size_t &pos)
+std::optional<std::string_view> readLineFromJournalContent(std::string_view content, size_t &pos)
 {
     const auto contentSize = content.size();
     if (pos >= contentSize) {
@@ -146,11 +244,11 @@ std::optional<std::string> readLineFromJournalContent(const std::string &content
     // Ищем конец строки
     const auto nextPos = content.find('\n', pos);
     // Если конец строки не найден, обрабатываем до конца строки
-    const auto endlFound = nextPos != std::string::npos;
+    const auto endlFound = nextPos != std::string_view::npos;
     const auto lineLength = endlFound ? (nextPos - pos) : (contentSize - pos);
 
     // Используем string_view для избежания лишних копирований
-    std::string_view currentLine(content.data() + pos, lineLength);
+    const auto currentLine = content.substr(pos, lineLength);
 
     // Обновляем позицию для следующей итерации
     pos = endlFound ? (nextPos + 1) : contentSize;
@@ -160,34 +258,832 @@ std::optional<std::string> readLineFromJournalContent(const std::string &content
         return std::nullopt;
     }
 
-    return std::string(currentLine);
+    return currentLine;
+}
+
+/**
+ * @struct JournalScanResult
+ * @brief Результат разбора содержимого журнала
+ */
+struct JournalScanResult {
+    bool legacy = false; // Журнал записан в текстовом формате v1
+    bool complete = true; // Всё содержимое журнала корректно
+    size_t validSize = 0; // Размер корректной части журнала в байтах (для бинарного формата)
+};
+
+/**
+ * @brief Проверяет, записан ли журнал в текстовом формате v1
+ * @param content Содержимое журнала
+ * @return true, если журнал не начинается с заголовка бинарного формата
+ */
+bool isLegacyJournal(std::string_view content)
+{
+    return content.substr(0, JOURNAL_HEADER_SIZE) != JOURNAL_HEADER;
+}
+
+/**
+ * @brief Разбирает содержимое журнала и вызывает обработчик для каждой корректной записи.
+ * В бинарном формате разбор останавливается на первой поврежденной или недописанной записи,
+ * так как границы последующих записей уже не могут быть достоверно определены. В формате v1
+ * некорректные строки пропускаются
+ * @param content Содержимое журнала
+ * @param handler Обработчик записей с сигнатурой void(const octet::JournalEntryView &, size_t),
+ * где второй аргумент - смещение записи от начала журнала. Записи бинарного формата передаются
+ * без копирования, поэтому представление действительно только во время вызова обработчика
+ * @param startOffset Смещение первой разбираемой записи (для бинарного формата, по умолчанию
+ * разбор начинается сразу после заголовка)
+ * @return Результат разбора
+ */
+template <typename Handler>
+JournalScanResult scanJournalContent(std::string_view content, Handler &&handler,
+                                     size_t startOffset = JOURNAL_HEADER_SIZE)
+{
+    JournalScanResult result;
+    if (isLegacyJournal(content)) {
+        result.legacy = true;
+        size_t pos = 0;
+        while (pos < content.size()) {
+            const auto lineOffset = pos;
+            const auto line = readLineFromJournalContent(content, pos);
+            // Пропускаем пустые строки и комментарии
+            if (!line.has_value()) {
+                continue;
+            }
+            // Данные формата v1 экранированы, поэтому без копирования их не прочитать
+            const auto entry = octet::JournalEntry::deserializeLegacy(*line);
+            if (!entry.has_value()) {
+                LOG_WARNING << "Некорректная запись в журнале формата v1: " << *line;
+                result.complete = false;
+                continue;
+            }
+            handler(entry->view(), lineOffset);
+        }
+        result.validSize = content.size();
+        return result;
+    }
+
+    assert(startOffset >= JOURNAL_HEADER_SIZE);
+    size_t pos = startOffset;
+    while (pos < content.size()) {
+        size_t recordSize = 0;
+        const auto entry = octet::JournalEntry::deserializeView(content.substr(pos), &recordSize);
+        if (!entry.has_value()) {
+            LOG_WARNING << "Поврежденная или недописанная запись в журнале по смещению " << pos
+                        << ", последующие " << (content.size() - pos) << " байт не читаются";
+            result.complete = false;
+            break;
+        }
+        handler(*entry, pos);
+        pos += recordSize;
+    }
+    result.validSize = pos;
+    return result;
+}
+
+/**
+ * @brief Дописывает запись индекса контрольных точек в буфер
+ * @param buffer Буфер для дописывания
+ * @param location Положение контрольной точки
+ */
+void appendCheckpointIndexEntry(std::string &buffer, const octet::CheckpointLocation &location)
+{
+    assert(location.id.size() <= std::numeric_limits<uint16_t>::max());
+
+    char header[INDEX_ENTRY_HEADER_SIZE];
+    octet::utils::storeLittleEndian(header + 4, location.segment);
+    octet::utils::storeLittleEndian(header + 12, location.offset);
+    octet::utils::storeLittleEndian(header + 20, static_cast<uint16_t>(location.id.size()));
+    auto crc = octet::utils::crc32c(header + 4, INDEX_ENTRY_HEADER_SIZE - 4);
+    crc = octet::utils::crc32c(location.id.data(), location.id.size(), crc);
+    octet::utils::storeLittleEndian(header, crc);
+
+    buffer.append(header, INDEX_ENTRY_HEADER_SIZE);
+    buffer.append(location.id);
+}
+
+/**
+ * @brief Считывает индекс контрольных точек
+ * @param indexPath Путь к индексу
+ * @return Корректные записи индекса (чтение останавливается на первой поврежденной записи)
+ */
+std::vector<octet::CheckpointLocation> readCheckpointIndex(const std::filesystem::path &indexPath)
+{
+    std::vector<octet::CheckpointLocation> locations;
+    if (!octet::utils::checkIfFileExists(indexPath, false)) {
+        return locations;
+    }
+
+    std::string content;
+    if (!octet::utils::safeFileRead(indexPath, content)) {
+        LOG_WARNING << "Индекс контрольных точек не прочитан: " << indexPath.string();
+        return locations;
+    }
+    const auto header = std::string_view(content).substr(0, CHECKPOINT_INDEX_HEADER_SIZE);
+    const auto legacy = header == CHECKPOINT_INDEX_HEADER_V1;
+    if (header != CHECKPOINT_INDEX_HEADER && !legacy) {
+        LOG_WARNING << "Индекс контрольных точек не прочитан: " << indexPath.string();
+        return locations;
+    }
+
+    // Поля записи версии 1 совпадают с полями текущей версии без номера сегмента
+    const auto headerSize = legacy ? INDEX_ENTRY_HEADER_SIZE_V1 : INDEX_ENTRY_HEADER_SIZE;
+    const auto fieldsOffset = legacy ? 4 : 12;
+    const char *data = content.data();
+    size_t pos = CHECKPOINT_INDEX_HEADER_SIZE;
+    while (pos + headerSize <= content.size()) {
+        const auto storedCrc = octet::utils::loadLittleEndian<uint32_t>(data + pos);
+        const auto segment
+            = legacy ? 0 : octet::utils::loadLittleEndian<uint64_t>(data + pos + 4);
+        const auto offset = octet::utils::loadLittleEndian<uint64_t>(data + pos + fieldsOffset);
+        const auto idSize
+            = octet::utils::loadLittleEndian<uint16_t>(data + pos + fieldsOffset + 8);
+        if (pos + headerSize + idSize > content.size()) {
+            break;
+        }
+        auto crc = octet::utils::crc32c(data + pos + 4, headerSize - 4);
+        crc = octet::utils::crc32c(data + pos + headerSize, idSize, crc);
+        if (crc != storedCrc) {
+            break;
+        }
+        locations.push_back({ std::string(data + pos + headerSize, idSize), offset, segment });
+        pos += headerSize + idSize;
+    }
+    return locations;
+}
+
+/**
+ * @brief Перезаписывает индекс контрольных точек
+ * @param indexPath Путь к индексу
+ * @param locations Положения контрольных точек в порядке следования в журнале
+ * @return true, если индекс успешно записан
+ */
+bool rewriteCheckpointIndex(const std::filesystem::path &indexPath,
+                            const std::vector<octet::CheckpointLocation> &locations)
+{
+    std::string content = CHECKPOINT_INDEX_HEADER;
+    for (const auto &location : locations) {
+        appendCheckpointIndexEntry(content, location);
+    }
+    return octet::utils::atomicFileWrite(indexPath, content);
+}
+
+/**
+ * @brief Дописывает положение новой контрольной точки в индекс
+ * @param indexPath Путь к индексу
+ * @param location Положение контрольной точки
+ * @return true, если индекс успешно обновлен
+ */
+bool appendCheckpointIndex(const std::filesystem::path &indexPath,
+                           const octet::CheckpointLocation &location)
+{
+    if (!octet::utils::checkIfFileExists(indexPath, false)) {
+        return rewriteCheckpointIndex(indexPath, { location });
+    }
+    // Индекс прежней версии переводится в текущую целиком
+    std::string content;
+    if (!octet::utils::safeFileRead(indexPath, content)
+        || std::string_view(content).substr(0, CHECKPOINT_INDEX_HEADER_SIZE)
+               != CHECKPOINT_INDEX_HEADER) {
+        auto locations = readCheckpointIndex(indexPath);
+        locations.push_back(location);
+        return rewriteCheckpointIndex(indexPath, locations);
+    }
+    std::string entry;
+    appendCheckpointIndexEntry(entry, location);
+    return octet::utils::safeFileAppend(indexPath, entry);
+}
+
+/**
+ * @struct JournalSegment
+ * @brief Запечатанный сегмент журнала
+ */
+struct JournalSegment {
+    uint64_t number; // Порядковый номер сегмента
+    std::filesystem::path path; // Путь к файлу сегмента
+};
+
+/**
+ * @brief Формирует путь к запечатанному сегменту журнала
+ * @param journalPath Путь к файлу журнала
+ * @param number Порядковый номер сегмента
+ * @return Путь к файлу сегмента
+ */
+std::filesystem::path sealedSegmentPath(const std::filesystem::path &journalPath, uint64_t number)
+{
+    auto suffix = std::to_string(number);
+    if (suffix.size() < SEGMENT_NUMBER_WIDTH) {
+        suffix.insert(0, SEGMENT_NUMBER_WIDTH - suffix.size(), '0');
+    }
+    return std::filesystem::path(journalPath.string() + "." + suffix);
+}
+
+/**
+ * @brief Находит запечатанные сегменты журнала
+ * @param journalPath Путь к файлу журнала
+ * @return Сегменты в порядке возрастания номеров (от самого старого к самому новому)
+ */
+std::vector<JournalSegment> listSealedSegments(const std::filesystem::path &journalPath)
+{
+    std::vector<JournalSegment> segments;
+    const auto dir
+        = journalPath.has_parent_path() ? journalPath.parent_path() : std::filesystem::path(".");
+    const auto prefix = journalPath.filename().string() + ".";
+
+    std::error_code ec;
+    for (const auto &item : std::filesystem::directory_iterator(dir, ec)) {
+        const auto name = item.path().filename().string();
+        if (name.size() < prefix.size() + SEGMENT_NUMBER_WIDTH
+            || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        // Рядом с журналом лежат и другие файлы (индекс, блокировки), их суффиксы не числовые
+        const auto suffix = name.substr(prefix.size());
+        if (suffix.size() > std::numeric_limits<uint64_t>::digits10
+            || !std::all_of(suffix.begin(), suffix.end(),
+                            [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        segments.push_back({ std::stoull(suffix), item.path() });
+    }
+    if (ec) {
+        LOG_ERROR << "Не удалось получить список сегментов журнала: " << journalPath.string()
+                  << ", код ошибки: " << ec.value() << ", сообщение: " << ec.message();
+    }
+
+    std::sort(segments.begin(), segments.end(),
+              [](const JournalSegment &lhs, const JournalSegment &rhs) {
+                  return lhs.number < rhs.number;
+              });
+    return segments;
+}
+
+/**
+ * @brief Удаляет файлы запечатанных сегментов журнала
+ * @param segments Удаляемые сегменты
+ * @return true, если все сегменты удалены
+ */
+bool removeSealedSegments(const std::vector<JournalSegment> &segments)
+{
+    bool success = true;
+    for (const auto &segment : segments) {
+        std::error_code ec;
+        std::filesystem::remove(segment.path, ec);
+        if (ec) {
+            LOG_ERROR << "Не удалось удалить сегмент журнала: " << segment.path.string()
+                      << ", код ошибки: " << ec.value() << ", сообщение: " << ec.message();
+            success = false;
+            continue;
+        }
+        LOG_DEBUG << "Удален сегмент журнала: " << segment.path.string();
+    }
+    return success;
+}
+
+/**
+ * @brief Проверяет, сжат ли запечатанный сегмент журнала
+ * @param content Содержимое файла сегмента
+ * @return true, если файл начинается с сигнатуры сжатого сегмента
+ */
+bool isCompressedSegment(std::string_view content)
+{
+    return content.substr(0, COMPRESSED_SEGMENT_MAGIC_SIZE) == COMPRESSED_SEGMENT_MAGIC;
+}
+
+/**
+ * @brief Сжимает содержимое запечатанного сегмента журнала
+ * @param content Содержимое сегмента
+ * @param codec Алгоритм сжатия
+ * @param[out] compressed Содержимое сжатого сегмента вместе с заголовком
+ * @return true, если сегмент сжат
+ */
+bool compressSegment(std::string_view content, octet::CompressionCodec codec,
+                     std::string &compressed)
+{
+    std::string payload;
+    if (!octet::utils::compressBlock(codec, content, payload)) {
+        return false;
+    }
+    compressed.clear();
+    compressed.reserve(COMPRESSED_SEGMENT_HEADER_SIZE + payload.size());
+    compressed.append(COMPRESSED_SEGMENT_MAGIC, COMPRESSED_SEGMENT_MAGIC_SIZE);
+    octet::utils::appendLittleEndian<uint32_t>(compressed, static_cast<uint32_t>(codec));
+    octet::utils::appendLittleEndian<uint64_t>(compressed, content.size());
+    octet::utils::appendLittleEndian<uint32_t>(
+        compressed, octet::utils::crc32c(payload.data(), payload.size()));
+    compressed += payload;
+    return true;
+}
+
+/**
+ * @class SegmentContent
+ * @brief Содержимое сегмента журнала: отображение файла в память или, для сжатого сегмента,
+ * распакованные данные.
+ */
+class SegmentContent {
+public:
+    explicit SegmentContent(const std::filesystem::path &segmentPath)
+        : file_(segmentPath)
+    {
+        if (!file_.isMapped()) {
+            return;
+        }
+        const auto content = file_.view();
+        if (!isCompressedSegment(content)) {
+            view_ = content;
+            valid_ = true;
+            return;
+        }
+
+        if (content.size() < COMPRESSED_SEGMENT_HEADER_SIZE) {
+            LOG_ERROR << "Заголовок сжатого сегмента журнала повреждён: " << segmentPath.string();
+            return;
+        }
+        const auto *header = content.data() + COMPRESSED_SEGMENT_MAGIC_SIZE;
+        const auto codec = static_cast<octet::CompressionCodec>(
+            octet::utils::loadLittleEndian<uint32_t>(header));
+        const auto originalSize
+            = octet::utils::loadLittleEndian<uint64_t>(header + sizeof(uint32_t));
+        const auto crc = octet::utils::loadLittleEndian<uint32_t>(header + sizeof(uint32_t)
+                                                                  + sizeof(uint64_t));
+        const auto payload = content.substr(COMPRESSED_SEGMENT_HEADER_SIZE);
+        if (octet::utils::crc32c(payload.data(), payload.size()) != crc) {
+            LOG_ERROR << "Контрольная сумма сжатого сегмента журнала не совпадает: "
+                      << segmentPath.string();
+            return;
+        }
+        if (!octet::utils::decompressBlock(codec, payload, originalSize, decompressed_)) {
+            LOG_ERROR << "Не удалось распаковать сегмент журнала (алгоритм: "
+                      << octet::utils::compressionCodecName(codec)
+                      << "): " << segmentPath.string();
+            decompressed_.clear();
+            return;
+        }
+        view_ = decompressed_;
+        valid_ = true;
+    }
+
+    // Удалось ли прочитать сегмент
+    bool isValid() const
+    {
+        return valid_;
+    }
+
+    // Содержимое сегмента, действительное до уничтожения объекта
+    std::string_view view() const
+    {
+        return view_;
+    }
+
+private:
+    // Представление ссылается на собственные данные объекта
+    SegmentContent(const SegmentContent &) = delete;
+    SegmentContent &operator=(const SegmentContent &) = delete;
+
+    const octet::utils::MappedFile file_;
+    std::string decompressed_;
+    std::string_view view_;
+    bool valid_ = false;
+};
+
+/**
+ * @brief Перезаписывает точки активного сегмента в индексе контрольных точек, сохраняя точки
+ * запечатанных сегментов
+ * @param indexPath Путь к индексу
+ * @param checkpoints Положения контрольных точек активного сегмента в порядке следования
+ * @return true, если индекс успешно записан
+ */
+bool rewriteActiveCheckpoints(const std::filesystem::path &indexPath,
+                              const std::vector<octet::CheckpointLocation> &checkpoints)
+{
+    auto locations = readCheckpointIndex(indexPath);
+    locations.erase(std::remove_if(locations.begin(), locations.end(),
+                                   [](const octet::CheckpointLocation &location) {
+                                       return location.segment == 0;
+                                   }),
+                    locations.end());
+    locations.insert(locations.end(), checkpoints.begin(), checkpoints.end());
+    return rewriteCheckpointIndex(indexPath, locations);
+}
+
+/**
+ * @brief Ищет контрольную точку в индексе и сверяет найденное положение с сегментом журнала
+ * @param journalPath Путь к файлу журнала (активному сегменту)
+ * @param indexPath Путь к индексу
+ * @param journal Содержимое активного сегмента
+ * @param checkpointId Идентификатор искомой точки (если не указан, ищется последняя точка)
+ * @return Положение контрольной точки или std::nullopt, если в индексе нет достоверных сведений
+ */
+std::optional<octet::CheckpointLocation>
+findIndexedCheckpoint(const std::filesystem::path &journalPath,
+                      const std::filesystem::path &indexPath, std::string_view journal,
+                      const std::optional<std::string> &checkpointId)
+{
+    if (isLegacyJournal(journal)) {
+        return std::nullopt;
+    }
+
+    const auto locations = readCheckpointIndex(indexPath);
+    for (auto it = locations.rbegin(); it != locations.rend(); ++it) {
+        if (checkpointId.has_value() && it->id != *checkpointId) {
+            continue;
+        }
+        // Запечатанный сегмент мог быть удалён или переписан при очистке журнала
+        std::unique_ptr<SegmentContent> sealed;
+        auto content = journal;
+        if (it->segment != 0) {
+            const auto segmentPath = sealedSegmentPath(journalPath, it->segment);
+            content = std::string_view();
+            if (octet::utils::checkIfFileExists(segmentPath, false)) {
+                sealed = std::make_unique<SegmentContent>(segmentPath);
+                content = sealed->isValid() ? sealed->view() : std::string_view();
+            }
+        }
+        // Индекс мог устареть после перезаписи журнала, поэтому смещение обязательно сверяем
+        const auto entry = it->offset >= JOURNAL_HEADER_SIZE && it->offset < content.size()
+                               ? octet::JournalEntry::deserializeView(content.substr(it->offset))
+                               : std::nullopt;
+        if (entry.has_value() && entry->type == octet::OperationType::CHECKPOINT
+            && entry->uuid == it->id) {
+            return *it;
+        }
+        LOG_DEBUG << "Запись индекса контрольных точек не соответствует журналу, точка = "
+                  << it->id << ", сегмент = " << it->segment << ", смещение = " << it->offset;
+        if (checkpointId.has_value()) {
+            break;
+        }
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Находит запечатанные сегменты журнала, начиная с сегмента контрольной точки
+ * @param journalPath Путь к файлу журнала
+ * @param location Положение контрольной точки (std::nullopt - все сегменты)
+ * @return Сегменты в порядке возрастания номеров (для точки в активном сегменте - пустой список)
+ */
+std::vector<JournalSegment>
+listSealedSegmentsFrom(const std::filesystem::path &journalPath,
+                       const std::optional<octet::CheckpointLocation> &location)
+{
+    if (location.has_value() && location->segment == 0) {
+        return {};
+    }
+    auto segments = listSealedSegments(journalPath);
+    if (location.has_value()) {
+        // Номера сегментов возрастают, поэтому предшествующие сегменты идут в начале списка
+        segments.erase(segments.begin(),
+                       std::find_if(segments.begin(), segments.end(),
+                                    [&location](const JournalSegment &segment) {
+                                        return segment.number >= location->segment;
+                                    }));
+    }
+    return segments;
+}
+
+/**
+ * @brief Проверяет, начинается ли сегмент журнала с указанной контрольной точки. Читается только
+ * первая запись сегмента
+ * @param segmentPath Путь к файлу сегмента
+ * @param checkpointId Идентификатор контрольной точки
+ * @return true, если первая запись сегмента является этой контрольной точкой
+ */
+bool segmentStartsWithCheckpoint(const std::filesystem::path &segmentPath,
+                                 const std::string &checkpointId)
+{
+    const SegmentContent segment(segmentPath);
+    if (!segment.isValid() || isLegacyJournal(segment.view())) {
+        return false;
+    }
+    const auto entry = octet::JournalEntry::deserializeView(segment.view().substr(
+        std::min(JOURNAL_HEADER_SIZE, segment.view().size())));
+    return entry.has_value() && entry->type == octet::OperationType::CHECKPOINT
+           && entry->uuid == checkpointId;
+}
+
+/**
+ * @brief Возвращает суммарный размер сегментов журнала
+ * @param segments Сегменты журнала
+ * @return Размер в байтах (сегменты, размер которых получить не удалось, не учитываются)
+ */
+uint64_t getSegmentsSize(const std::vector<JournalSegment> &segments)
+{
+    uint64_t size = 0;
+    for (const auto &segment : segments) {
+        std::error_code ec;
+        const auto fileSize = std::filesystem::file_size(segment.path, ec);
+        if (!ec) {
+            size += fileSize;
+        }
+    }
+    return size;
+}
+
+/**
+ * @struct DecodedSegment
+ * @brief Проверенные записи сегмента журнала, ссылающиеся на его отображение в память
+ */
+struct DecodedSegment {
+    std::unique_ptr<SegmentContent> file; // Содержимое сегмента
+    std::vector<std::pair<octet::JournalEntryView, size_t>> entries; // Записи и их смещения
+    bool complete = true; // Все ли записи сегмента корректны
+};
+
+/**
+ * @brief Отображает сегмент журнала в память и проверяет его записи
+ * @param segmentPath Путь к файлу сегмента
+ * @param[out] decoded Результат разбора
+ * @param startOffset Смещение первой проверяемой записи
+ */
+void decodeSegment(const std::filesystem::path &segmentPath, DecodedSegment &decoded,
+                   size_t startOffset = JOURNAL_HEADER_SIZE)
+{
+    decoded.file = std::make_unique<SegmentContent>(segmentPath);
+    if (!decoded.file->isValid()) {
+        LOG_ERROR << "Не удалось прочитать сегмент журнала: " << segmentPath.string();
+        decoded.complete = false;
+        return;
+    }
+    // Запечатываются только сегменты бинарного формата
+    if (isLegacyJournal(decoded.file->view())) {
+        LOG_WARNING << "Сегмент журнала имеет неизвестный формат: " << segmentPath.string();
+        decoded.complete = false;
+        return;
+    }
+
+    const auto result = scanJournalContent(
+        decoded.file->view(),
+        [&decoded](const octet::JournalEntryView &entry, size_t offset) {
+            decoded.entries.emplace_back(entry, offset);
+        },
+        startOffset);
+    decoded.complete = result.complete;
+    if (!decoded.complete) {
+        LOG_WARNING << "Сегмент журнала содержит некорректные записи: " << segmentPath.string();
+    }
+}
+
+/**
+ * @brief Разбирает запечатанные сегменты журнала от самого старого к самому новому. Проверка
+ * контрольных сумм выполняется параллельно для группы сегментов, а обработчик вызывается строго
+ * в порядке следования записей. В памяти одновременно находится не больше одной группы
+ * @param segments Сегменты журнала в порядке возрастания номеров
+ * @param handler Обработчик записей (см. scanJournalContent), смещения отсчитываются от начала
+ * каждого сегмента
+ * @param startOffset Смещение первой разбираемой записи первого сегмента (например, контрольной
+ * точки из индекса)
+ * @return true, если все сегменты прочитаны и корректны
+ */
+template <typename Handler>
+bool scanSealedSegments(const std::vector<JournalSegment> &segments, Handler &handler,
+                        size_t startOffset = JOURNAL_HEADER_SIZE)
+{
+    const auto groupSize = octet::utils::defaultParallelism();
+
+    bool complete = true;
+    for (size_t first = 0; first < segments.size(); first += groupSize) {
+        const auto count = std::min(groupSize, segments.size() - first);
+        std::vector<DecodedSegment> decoded(count);
+        octet::utils::parallelFor(count, [&](size_t i) {
+            decodeSegment(segments[first + i].path, decoded[i],
+                          first + i == 0 ? startOffset : JOURNAL_HEADER_SIZE);
+        });
+
+        for (const auto &segment : decoded) {
+            for (const auto &[entry, offset] : segment.entries) {
+                handler(entry, offset);
+            }
+            complete = complete && segment.complete;
+        }
+    }
+    return complete;
+}
+
+/**
+ * @brief Разбирает полные записи бинарного журнала, дописываемого другим процессом. В отличие от
+ * scanJournalContent недописанная запись в конце не считается повреждением и не выводится в лог
+ * @param content Содержимое журнала (часть, начинающаяся с записи)
+ * @param handler Обработчик записей с сигнатурой void(const octet::JournalEntryView &)
+ * @return Размер разобранной части в байтах
+ */
+template <typename Handler>
+size_t scanCompleteRecords(std::string_view content, Handler &&handler)
+{
+    size_t pos = 0;
+    while (pos < content.size()) {
+        size_t recordSize = 0;
+        const auto entry = octet::JournalEntry::deserializeView(content.substr(pos), &recordSize);
+        if (!entry.has_value()) {
+            break;
+        }
+        handler(*entry);
+        pos += recordSize;
+    }
+    return pos;
+}
+
+/**
+ * @brief Отображает сегменты журнала в память и разбирает их содержимое без промежуточных копий.
+ * Если указана контрольная точка и её положение есть в индексе, разбор начинается сразу с неё, а
+ * предшествующие ей сегменты не читаются
+ * @param journalPath Путь к файлу журнала (активному сегменту)
+ * @param indexPath Путь к индексу контрольных точек
+ * @param checkpointId Контрольная точка, с которой нужны записи (опционально)
+ * @param handler Обработчик записей (см. scanJournalContent)
+ * @param[out] result Результат разбора (complete учитывает и запечатанные сегменты)
+ * @return true, если журнал удалось прочитать
+ */
+template <typename Handler>
+bool scanJournalFile(const std::filesystem::path &journalPath,
+                     const std::filesystem::path &indexPath,
+                     const std::optional<std::string> &checkpointId, Handler &&handler,
+                     JournalScanResult &result)
+{
+    const octet::utils::MappedFile journal(journalPath);
+    if (!journal.isMapped()) {
+        LOG_ERROR << "Не удалось прочитать файл журнала: " << journalPath.string();
+        return false;
+    }
+
+    std::optional<octet::CheckpointLocation> location;
+    if (checkpointId.has_value()) {
+        location = findIndexedCheckpoint(journalPath, indexPath, journal.view(), checkpointId);
+    }
+    if (location.has_value()) {
+        LOG_DEBUG << "Контрольная точка найдена в индексе, чтение журнала с сегмента "
+                  << location->segment << ", смещение " << location->offset;
+    }
+    if (location.has_value() && location->segment == 0) {
+        result = scanJournalContent(journal.view(), handler, location->offset);
+        return true;
+    }
+
+    // Записи запечатанных сегментов предшествуют записям активного
+    const auto sealedComplete
+        = scanSealedSegments(listSealedSegmentsFrom(journalPath, location), handler,
+                             location.has_value() ? location->offset : JOURNAL_HEADER_SIZE);
+    result = scanJournalContent(journal.view(), handler);
+    result.complete = result.complete && sealedComplete;
+    return true;
+}
+
+/**
+ * @brief Перегрузка scanJournalFile для случаев, когда результат разбора не нужен
+ */
+template <typename Handler>
+bool scanJournalFile(const std::filesystem::path &journalPath,
+                     const std::filesystem::path &indexPath,
+                     const std::optional<std::string> &checkpointId, Handler &&handler)
+{
+    JournalScanResult result;
+    return scanJournalFile(journalPath, indexPath, checkpointId, std::forward<Handler>(handler),
+                           result);
+}
+
+/**
+ * @class CheckpointFilter
+ * @brief Отбирает записи журнала, начиная с указанной контрольной точки.
+ *
+ * Сама контрольная точка отбирается, а другие контрольные точки после неё - нет. Если
+ * контрольная точка не указана, отбираются все записи.
+ */
+class CheckpointFilter {
+public:
+    explicit CheckpointFilter(const std::optional<std::string> &checkpointId)
+        : checkpointId_(checkpointId)
+        , found_(!checkpointId.has_value())
+    {
+    }
+
+    // Проверка, нужно ли отобрать очередную запись
+    bool accept(const octet::JournalEntryView &entry)
+    {
+        if (entry.type == octet::OperationType::CHECKPOINT && checkpointId_.has_value()) {
+            if (entry.uuid != *checkpointId_) {
+                return false;
+            }
+            // Для отладки проверяем, что такая контрольная точка уникальна
+            assert(found_ == false);
+            found_ = true;
+            return true;
+        }
+        // Пропускаем операции до нахождения контрольной точки
+        return found_;
+    }
+
+    // Проверка, найдена ли контрольная точка (всегда true, если точка не указана)
+    bool found() const
+    {
+        return found_;
+    }
+
+private:
+    const std::optional<std::string> &checkpointId_;
+    bool found_;
+};
+
+/**
+ * @brief Формирует данные записи контрольной точки: ссылку на предыдущую контрольную точку и
+ * количество операций журнала между ними
+ * @param previousId Идентификатор предыдущей контрольной точки
+ * @param operations Количество операций после предыдущей контрольной точки
+ * @return Данные записи
+ */
+std::string checkpointLink(std::string_view previousId, uint64_t operations)
+{
+    std::string link(previousId);
+    link += '\n';
+    link += std::to_string(operations);
+    return link;
 }
 } // namespace
 
 namespace octet {
+/**
+ * @struct JournalBatch
+ * @brief Пакет записей, фиксируемых на диске одной операцией записи и синхронизации
+ */
+struct JournalBatch {
+    std::string buffer; // Сериализованные записи пакета
+    bool completed = false; // Обработан ли пакет потоком фиксации
+    bool succeeded = false; // Зафиксирован ли пакет на диске
+    bool forceSync = false; // Нужна ли синхронная фиксация пакета независимо от режима
+    bool hasCheckpoint = false; // Содержит ли пакет контрольную точку
+    bool startsSegment = false; // Начинает ли контрольная точка новый сегмент журнала
+    size_t checkpointPosition = 0; // Позиция записи контрольной точки внутри пакета
+    uint64_t checkpointOffset = 0; // Смещение контрольной точки в активном сегменте журнала
+};
+
 JournalEntry::JournalEntry(OperationType type, std::string uuid, std::string data,
-                           std::string timestamp)
+                           std::optional<uint64_t> timestamp)
     : type_(type)
     , uuid_(std::move(uuid))
     , data_(std::move(data))
-    , timestamp_(timestamp.empty() ? getCurrentIsoTimestamp() : std::move(timestamp))
+    , timestamp_(timestamp.has_value() ? *timestamp : getCurrentTimestampNs())
 {
 }
 
 std::string JournalEntry::serialize() const
 {
-    std::ostringstream oss;
-    // Формат: TYPE|UUID|TIMESTAMP|DATA
-    // TODO: нужно решить, что все-таки делать с UUID:
-    // 1)  Разрешить любые UUID и экранировать их
-    // 2)  Разрешить любые UUID и не экранировать их, а выкидывать исключение
-    // 3)  Разрешить только UUID получаемые через генератор
-    oss << operationTypeToString(type_) << FIELD_SEPARATOR << uuid_ << FIELD_SEPARATOR << timestamp_
-        << FIELD_SEPARATOR << escapeString(data_) << "\n";
-    return oss.str();
+    std::string record;
+    appendRecord(record, type_, uuid_, data_, timestamp_);
+    return record;
 }
 
-std::optional<JournalEntry> JournalEntry::deserialize(const std::string &line)
+void JournalEntry::serializeView(const JournalEntryView &entry, std::string &buffer)
+{
+    appendRecord(buffer, entry.type, entry.uuid, entry.data, entry.timestamp);
+}
+
+std::optional<JournalEntry> JournalEntry::deserialize(std::string_view buffer, size_t *recordSize)
+{
+    const auto entry = deserializeView(buffer, recordSize);
+    if (!entry.has_value()) {
+        return std::nullopt;
+    }
+    return JournalEntry(entry->type, std::string(entry->uuid), std::string(entry->data),
+                        entry->timestamp);
+}
+
+std::optional<JournalEntryView> JournalEntry::deserializeView(std::string_view buffer,
+                                                              size_t *recordSize)
+{
+    if (buffer.size() < RECORD_HEADER_SIZE
+        || static_cast<uint8_t>(buffer[0]) != RECORD_MAGIC) {
+        return std::nullopt;
+    }
+
+    const auto *header = buffer.data();
+    const auto typeIndex = static_cast<uint8_t>(header[1]);
+    if (typeIndex >= OPERATION_TYPE_STRINGS.size()) {
+        return std::nullopt;
+    }
+    const auto uuidSize = utils::loadLittleEndian<uint16_t>(header + 2);
+    const auto dataSize = utils::loadLittleEndian<uint32_t>(header + 4);
+    const auto timestamp = utils::loadLittleEndian<uint64_t>(header + 8);
+    const auto storedCrc = utils::loadLittleEndian<uint32_t>(header + RECORD_CRC_OFFSET);
+
+    // Проверяем, что запись дописана целиком
+    const size_t totalSize = RECORD_HEADER_SIZE + uuidSize + static_cast<size_t>(dataSize);
+    if (buffer.size() < totalSize) {
+        return std::nullopt;
+    }
+
+    // Проверяем контрольную сумму
+    auto crc = utils::crc32c(header, RECORD_CRC_OFFSET);
+    crc = utils::crc32c(header + RECORD_HEADER_SIZE, uuidSize + static_cast<size_t>(dataSize), crc);
+    if (crc != storedCrc) {
+        return std::nullopt;
+    }
+
+    if (recordSize != nullptr) {
+        *recordSize = totalSize;
+    }
+    return JournalEntryView{ static_cast<OperationType>(typeIndex),
+                             buffer.substr(RECORD_HEADER_SIZE, uuidSize),
+                             buffer.substr(RECORD_HEADER_SIZE + uuidSize, dataSize), timestamp };
+}
+
+std::optional<JournalEntry> JournalEntry::deserializeLegacy(std::string_view line)
 {
     // Ищем индексы первых трех разделителей
     constexpr uint8_t FIELD_SEPARATOR_COUNT = 3;
@@ -205,109 +1101,718 @@ std::optional<JournalEntry> JournalEntry::deserialize(const std::string &line)
         return std::nullopt;
     }
 
-    std::string_view typeView(line.c_str(), separators[0]);
-    std::string_view uuidView(line.c_str() + separators[0] + 1, separators[1] - separators[0] - 1);
-    std::string_view timestampView(line.c_str() + separators[1] + 1,
-                                   separators[2] - separators[1] - 1);
+    const auto typeView = line.substr(0, separators[0]);
+    const auto uuidView = line.substr(separators[0] + 1, separators[1] - separators[0] - 1);
+    const auto timestampView = line.substr(separators[1] + 1, separators[2] - separators[1] - 1);
 
     // Проверяем тип операции до извлечения данных
-    const auto type = stringToOperationType(std::string(typeView));
+    const auto type = stringToOperationType(typeView);
     if (!type.has_value()) {
         return std::nullopt;
     }
-    const std::string data = unescapeString(line.substr(separators[2] + 1));
-    return JournalEntry(*type, std::string(uuidView), std::move(data), std::string(timestampView));
+    auto data = unescapeString(line.substr(separators[2] + 1));
+    return JournalEntry(*type, std::string(uuidView), std::move(data),
+                        isoTimestampToNs(timestampView));
 }
 
-JournalManager::JournalManager(const std::filesystem::path &journalPath)
+JournalManager::JournalManager(const std::filesystem::path &journalPath, DurabilityPolicy policy,
+                               std::function<void()> onWrite)
     : journalFilePath_(journalPath)
+    , checkpointIndexPath_(journalPath.string() + CHECKPOINT_INDEX_SUFFIX)
     , lastCheckpointId_(std::nullopt)
+    , durabilityPolicy_(policy)
+    , onWrite_(std::move(onWrite))
 {
     LOG_INFO << "Инициализация журнала по пути: " << journalFilePath_.string();
 
-    bool needToRecrate = false;
+    bool needToRecreate = false;
     // Проверяем, существует ли файл журнала, и создаем его (вместе с директориями), если нет
     if (!utils::checkIfFileExists(journalFilePath_)) {
         LOG_INFO << "Файл журнала не найден, создаем новый: " << journalFilePath_.string();
-        needToRecrate = true;
+        needToRecreate = true;
+    }
+    else {
+        // Записи журнала формата v1 сразу переводим в бинарный формат
+        std::string migratedContent = JOURNAL_HEADER;
+        std::vector<CheckpointLocation> migratedCheckpoints;
+        size_t migratedCount = 0;
+        JournalScanResult scanResult;
+        {
+            const utils::MappedFile journal(journalFilePath_);
+            if (!journal.isMapped()) {
+                LOG_CRITICAL << "Не удалось прочитать файл журнала: "
+                             << journalFilePath_.string();
+                throw std::runtime_error("JournalManager: не удалось прочитать журнал "
+                                         + journalFilePath_.string());
+            }
+
+            const auto legacy = isLegacyJournal(journal.view());
+            scanResult = scanJournalContent(journal.view(), [&](const JournalEntryView &entry,
+                                                                size_t) {
+                if (!legacy) {
+                    return;
+                }
+                if (entry.type == OperationType::CHECKPOINT) {
+                    migratedCheckpoints.push_back(
+                        { std::string(entry.uuid), migratedContent.size() });
+                }
+                appendRecord(migratedContent, entry.type, entry.uuid, entry.data,
+                             entry.timestamp);
+                migratedCount++;
+            });
+        }
+        const auto legacy = scanResult.legacy;
+
+        if (!scanResult.complete) {
+            // Создаем резервную копию перед любыми изменениями поврежденного журнала
+            auto backupPath = utils::createFileBackup(journalFilePath_);
+            if (backupPath.has_value()) {
+                LOG_INFO << "Создана резервная копия поврежденного журнала: "
+                         << backupPath->string();
+            }
+            else {
+                LOG_CRITICAL << "Не удалось создать резервную копию поврежденного журнала: "
+                             << journalFilePath_.string()
+                             << ", прерываем, чтобы не повредить данные";
+                throw std::runtime_error("JournalManager: не удалось создать новый журнал "
+                                         + journalFilePath_.string());
+            }
+
+            if (legacy) {
+                LOG_WARNING << "Формат журнала некорректен, создаем новый журнал";
+                needToRecreate = true;
+            }
+            else {
+                // Поврежденный хвост (например, недописанный при сбое пакет) отрезаем, чтобы
+                // новые записи не оказались после него и не были потеряны при чтении
+                LOG_WARNING << "Журнал содержит поврежденный хвост, обрезаем до "
+                            << scanResult.validSize << " байт";
+                std::error_code ec;
+                std::filesystem::resize_file(journalFilePath_, scanResult.validSize, ec);
+                if (ec) {
+                    LOG_CRITICAL << "Не удалось обрезать поврежденный журнал: "
+                                 << journalFilePath_.string() << ", код ошибки: " << ec.value()
+                                 << ", сообщение: " << ec.message();
+                    throw std::runtime_error("JournalManager: не удалось восстановить журнал "
+                                             + journalFilePath_.string());
+                }
+            }
+        }
+        else if (legacy) {
+            // Переводим журнал формата v1 в бинарный формат, сохраняя все записи
+            LOG_INFO << "Журнал записан в формате v1, переводим в бинарный формат, записей: "
+                     << migratedCount;
+            std::lock_guard<std::mutex> lock(descriptorMutex_);
+            if (!rewriteJournal(migratedContent, migratedCheckpoints)) {
+                LOG_CRITICAL << "Не удалось перевести журнал в бинарный формат: "
+                             << journalFilePath_.string();
+                throw std::runtime_error("JournalManager: не удалось обновить формат журнала "
+                                         + journalFilePath_.string());
+            }
+        }
+    }
+
+    if (needToRecreate) {
+        // Создаем новый файл журнала
+        const std::string header = JOURNAL_HEADER;
+        if (!utils::atomicFileWrite(journalFilePath_, header)) {
+            LOG_CRITICAL << "Не удалось создать новый файл журнала: " << journalFilePath_.string();
+            throw std::runtime_error("JournalManager: не удалось создать новый журнал "
+                                     + journalFilePath_.string());
+        }
+        // Индекс от прежнего журнала к новому журналу не относится
+        if (!rewriteCheckpointIndex(checkpointIndexPath_, {})) {
+            LOG_WARNING << "Не удалось очистить индекс контрольных точек: "
+                        << checkpointIndexPath_.string();
+        }
+    }
+
+    // Держим журнал открытым, чтобы не открывать файл заново при каждой записи
+    if (!do_reopenDescriptor()) {
+        LOG_CRITICAL << "Не удалось открыть файл журнала для записи: " << journalFilePath_.string();
+        throw std::runtime_error("JournalManager: не удалось открыть журнал "
+                                 + journalFilePath_.string());
+    }
+    if (durabilityPolicy_.ioBackend == IoBackend::IO_URING) {
+        ioRing_ = std::make_unique<utils::IoRing>();
+        if (!ioRing_->isAvailable()) {
+            LOG_WARNING << "io_uring недоступен (" << errnoToString(ioRing_->lastError())
+                        << "), журнал записывается обычными системными вызовами";
+            ioRing_.reset();
+        }
+    }
+    activeSegmentStart_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    do_updateSealedSegmentsSize();
+
+    if (durabilityPolicy_.mode != DurabilityMode::SYNC) {
+        acknowledgedTicket_ = std::make_shared<JournalBatch>();
+        acknowledgedTicket_->completed = true;
+        acknowledgedTicket_->succeeded = true;
+
+        flusherThread_ = std::thread(&JournalManager::flusherThreadFunction, this);
+        LOG_DEBUG << "Запущен поток фиксации журнала: " << journalFilePath_.string();
+    }
+}
+
+JournalManager::~JournalManager()
+{
+    LOG_DEBUG << "Закрытие журнала: " << journalFilePath_.string();
+
+    // Поток фиксации перед завершением записывает все накопленные пакеты
+    if (flusherThread_.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(commitMutex_);
+            stopFlusher_ = true;
+        }
+        commitCondition_.notify_one();
+        flusherThread_.join();
+    }
+
+    if (journalFd_ >= 0) {
+        utils::closeDescriptor(journalFd_);
+    }
+}
+
+bool JournalManager::writeOperation(OperationType opType, const std::string &uuid,
+                                    const std::string &data)
+{
+    LOG_DEBUG << "Запись операции в журнал: " << journalFilePath_.string()
+              << ", операция = " << operationTypeToString(opType);
+
+    // Идентификатор должен быть обязательно не пустым
+    if (uuid.empty()) {
+        LOG_ERROR << "Попытка записи операции с пустым UUID";
+        return false;
+    }
+
+    // Если это контрольная точка, обновляем кэшированное значение
+    bool writeResult = false;
+    if (opType == OperationType::CHECKPOINT) {
+        // Используем блокировку для поддержания атомарности между записью в файл и обновлением кэша
+        std::lock_guard<std::mutex> lock(journalMutex_);
+        writeResult = do_waitForCheckpoint(submitOperation(opType, uuid, data), uuid);
+    }
+    else {
+        writeResult = waitForCommit(submitOperation(opType, uuid, data));
+    }
+    return writeResult;
+}
+
+JournalTicket JournalManager::submitOperation(OperationType opType, std::string_view uuid,
+                                              std::string_view data)
+{
+    return enqueueOperation(reserveSequence(), opType, uuid, data, false);
+}
+
+JournalTicket JournalManager::submitCheckpoint(const std::string &checkpointId,
+                                               bool startNewSegment)
+{
+    return submitCheckpoint(reserveSequence(), checkpointId, startNewSegment);
+}
+
+uint64_t JournalManager::reserveSequence()
+{
+    return reserveSequences(1);
+}
+
+uint64_t JournalManager::reserveSequences(uint64_t count)
+{
+    return nextReservedSequence_.fetch_add(count, std::memory_order_relaxed);
+}
+
+JournalTicket JournalManager::submitOperation(uint64_t sequence, OperationType opType,
+                                              std::string_view uuid, std::string_view data)
+{
+    return enqueueOperation(sequence, opType, uuid, data, false);
+}
+
+JournalTicket JournalManager::submitCheckpoint(uint64_t sequence, const std::string &checkpointId,
+                                               bool startNewSegment)
+{
+    return enqueueOperation(sequence, OperationType::CHECKPOINT, checkpointId, "",
+                            startNewSegment);
+}
+
+JournalTicket JournalManager::submitOperations(uint64_t firstSequence,
+                                               const std::vector<JournalOperationView> &operations)
+{
+    // Пустому пакету номера не резервируются, поэтому ему нечего передавать в очередь
+    if (operations.empty()) {
+        LOG_ERROR << "Попытка записи пустого пакета операций в журнал";
+        return nullptr;
+    }
+
+    // Записи сериализуются вне блокировок и попадают в один пакет журнала подряд
+    bool recordable = true;
+    std::string serializedEntries;
+    for (const auto &operation : operations) {
+        if (operation.type == OperationType::CHECKPOINT
+            || !isOperationRecordable(operation.uuid, operation.data)) {
+            LOG_ERROR << "Недопустимая операция в пакете записей журнала, UUID: "
+                      << operation.uuid.substr(0, 64);
+            recordable = false;
+            break;
+        }
+    }
+    if (recordable) {
+        const auto timestamp = getCurrentTimestampNs();
+        for (const auto &operation : operations) {
+            appendRecord(serializedEntries, operation.type, operation.uuid, operation.data,
+                         timestamp);
+        }
+    }
+
+    auto ticket = enqueueRecords(firstSequence, operations.size(), std::move(serializedEntries),
+                                 recordable, {}, false);
+    if (!ticket && recordable) {
+        LOG_ERROR << "Не удалось записать пакет операций в журнал, операций: "
+                  << operations.size();
+    }
+    return ticket;
+}
+
+bool JournalManager::isOperationRecordable(std::string_view uuid, std::string_view data)
+{
+    // Размеры полей ограничены форматом записи
+    return !uuid.empty() && uuid.size() <= std::numeric_limits<uint16_t>::max()
+           && data.size() <= std::numeric_limits<uint32_t>::max();
+}
+
+void JournalManager::do_waitForSequence(std::unique_lock<std::mutex> &lock, uint64_t sequence)
+{
+    if (nextQueuedSequence_ == sequence) {
+        return;
+    }
+    ++sequenceWaiters_;
+    sequenceCondition_.wait(lock, [this, sequence] { return nextQueuedSequence_ == sequence; });
+    --sequenceWaiters_;
+}
+
+void JournalManager::do_advanceSequence(uint64_t count)
+{
+    nextQueuedSequence_ += count;
+    // Без ожидающих писателей (обычный случай без конкуренции) уведомление не требуется
+    if (sequenceWaiters_ > 0) {
+        sequenceCondition_.notify_all();
+    }
+}
+
+JournalTicket JournalManager::enqueueOperation(uint64_t sequence, OperationType opType,
+                                               std::string_view uuid, std::string_view data,
+                                               bool startNewSegment)
+{
+    assert(!startNewSegment || opType == OperationType::CHECKPOINT);
+
+    // Некорректная операция не записывается, но её номер всё равно должен пройти очередь
+    const auto recordable = isOperationRecordable(uuid, data);
+    if (uuid.empty()) {
+        LOG_ERROR << "Попытка записи операции с пустым UUID";
+    }
+    else if (!recordable) {
+        LOG_ERROR << "Превышен допустимый размер идентификатора или данных операции, UUID: "
+                  << uuid.substr(0, 64);
+    }
+
+    // Сериализуем запись вне блокировок (запись контрольной точки ссылается на предыдущую
+    // точку, поэтому она сериализуется уже в порядке очереди)
+    const auto checkpoint = opType == OperationType::CHECKPOINT;
+    std::string serializedEntry;
+    if (recordable && !checkpoint) {
+        appendRecord(serializedEntry, opType, uuid, data, getCurrentTimestampNs());
+    }
+
+    auto ticket = enqueueRecords(sequence, 1, std::move(serializedEntry), recordable,
+                                 checkpoint ? uuid : std::string_view(), startNewSegment);
+    if (!ticket && recordable) {
+        LOG_ERROR << "Не удалось записать операцию в журнал, тип: "
+                  << operationTypeToString(opType) << ", UUID: " << uuid;
+    }
+    return ticket;
+}
+
+JournalTicket JournalManager::enqueueRecords(uint64_t firstSequence, uint64_t count,
+                                             std::string records, bool recordable,
+                                             std::string_view checkpointId, bool startNewSegment)
+{
+    std::unique_lock<std::mutex> lock(commitMutex_);
+    do_waitForSequence(lock, firstSequence);
+    if (!recordable) {
+        do_advanceSequence(count);
+        return nullptr;
+    }
+
+    // Записи ставятся в очередь в порядке журнала, поэтому здесь известно, сколько операций
+    // записано после предыдущей контрольной точки
+    const auto checkpoint = !checkpointId.empty();
+    if (checkpoint) {
+        const auto link = linkedCheckpointId_.has_value()
+                              ? checkpointLink(*linkedCheckpointId_, operationsSinceCheckpoint_)
+                              : std::string();
+        appendRecord(records, OperationType::CHECKPOINT, checkpointId, link,
+                     getCurrentTimestampNs());
+        linkedCheckpointId_ = std::string(checkpointId);
+        operationsSinceCheckpoint_ = 0;
+    }
+    else {
+        operationsSinceCheckpoint_ += count;
+    }
+
+    const auto mode = durabilityPolicy_.mode;
+    if (mode == DurabilityMode::SYNC) {
+        // Очередь удерживается самим номером, поэтому запись фиксируется в потоке вызывающего
+        // без commitMutex_, а следующие записи дожидаются её завершения
+        lock.unlock();
+        auto batch = std::make_shared<JournalBatch>();
+        batch->buffer = std::move(records);
+        batch->hasCheckpoint = checkpoint;
+        batch->startsSegment = startNewSegment;
+        batch->completed = true;
+        batch->succeeded = do_commitBatch(*batch);
+
+        lock.lock();
+        do_advanceSequence(count);
+        lock.unlock();
+
+        return batch->succeeded ? batch : nullptr;
+    }
+
+    // Контрольная точка должна быть зафиксирована до того, как журнал будет очищен по ней,
+    // поэтому для неё ожидание фиксации требуется в любом режиме
+    const auto needsWait = mode == DurabilityMode::GROUP_COMMIT || checkpoint;
+
+    // Добавляем запись в накапливаемый пакет: пока поток фиксации записывает предыдущий пакет,
+    // в текущий попадают записи всех конкурентных писателей
+    bool wakeFlusher = false;
+    if (!pendingBatch_) {
+        pendingBatch_ = std::make_shared<JournalBatch>();
+        // Поток фиксации ждёт появления нового пакета
+        wakeFlusher = true;
+    }
+    if (checkpoint) {
+        pendingBatch_->hasCheckpoint = true;
+        pendingBatch_->startsSegment = startNewSegment;
+        pendingBatch_->checkpointPosition = pendingBatch_->buffer.size();
+    }
+    pendingBatch_->buffer += records;
+    if (checkpoint) {
+        // В режиме INTERVAL поток фиксации не должен ждать окончания интервала
+        pendingBatch_->forceSync = true;
+        wakeFlusher = true;
+    }
+    JournalTicket ticket = needsWait ? pendingBatch_ : acknowledgedTicket_;
+    do_advanceSequence(count);
+    lock.unlock();
+
+    if (wakeFlusher) {
+        commitCondition_.notify_one();
+    }
+    return ticket;
+}
+
+bool JournalManager::waitForCommit(const JournalTicket &ticket)
+{
+    if (!ticket) {
+        return false;
+    }
+
+    std::unique_lock<std::mutex> lock(commitMutex_);
+    durableCondition_.wait(lock, [&ticket] { return ticket->completed; });
+    return ticket->succeeded;
+}
+
+bool JournalManager::waitForCheckpoint(const JournalTicket &ticket, const std::string &checkpointId)
+{
+    std::lock_guard<std::mutex> lock(journalMutex_);
+    return do_waitForCheckpoint(ticket, checkpointId);
+}
+
+bool JournalManager::do_waitForCheckpoint(const JournalTicket &ticket,
+                                          const std::string &checkpointId)
+{
+    if (!waitForCommit(ticket)) {
+        return false;
+    }
+
+    // Обновляем кэшированное значение только при успешном добавлении операции в журнал
+    lastCheckpointId_ = checkpointId;
+
+    // Индекс вспомогательный, поэтому ошибка его обновления не отменяет контрольную точку
+    const CheckpointLocation location{ checkpointId, ticket->checkpointOffset };
+    if (!appendCheckpointIndex(checkpointIndexPath_, location)) {
+        LOG_WARNING << "Не удалось обновить индекс контрольных точек: "
+                    << checkpointIndexPath_.string();
+    }
+    return true;
+}
+
+bool JournalManager::do_commitBatch(JournalBatch &batch, bool sync)
+{
+    ScopedLatency latency(MetricHistogram::JOURNAL_APPEND);
+    std::lock_guard<std::mutex> lock(descriptorMutex_);
+
+    // Файловая блокировка защищает запись от конкурентных процессов
+    utils::FileLockGuard fileLock(journalFilePath_, utils::LockMode::EXCLUSIVE);
+    if (!fileLock.isLocked()) {
+        LOG_ERROR << "Не удалось получить блокировку для записи в журнал: "
+                  << journalFilePath_.string();
+        return false;
+    }
+
+    // Другой процесс мог атомарно перезаписать журнал, тогда дескриптор указывает на старый файл
+    if (journalFd_ < 0 || !utils::isDescriptorOfFile(journalFd_, journalFilePath_)) {
+        LOG_DEBUG << "Файл журнала был заменён, переоткрываем: " << journalFilePath_.string();
+        if (!do_reopenDescriptor()) {
+            return false;
+        }
+    }
+
+    // Под эксклюзивной блокировкой запись в режиме дозаписи начнется ровно с текущего конца файла
+    auto fileSize = utils::getDescriptorFileSize(journalFd_);
+    if (!fileSize.has_value()) {
+        return false;
+    }
+
+    // Заполненный сегмент запечатываем до записи пакета (если пакет сам не начинает сегмент)
+    const auto segmentSize = segmentSize_.load();
+    if (!batch.startsSegment && segmentSize > 0 && *fileSize >= segmentSize
+        && *fileSize > JOURNAL_HEADER_SIZE) {
+        // Записи запечатываемого сегмента должны оказаться на диске раньше нового сегмента
+        if (!syncJournal()) {
+            return false;
+        }
+        if (do_startNewSegment()) {
+            fileSize = JOURNAL_HEADER_SIZE;
+        }
+        else {
+            // Журнал остаётся корректным и без нового сегмента, он просто продолжает расти
+            LOG_WARNING << "Не удалось начать новый сегмент журнала, продолжаем запись в текущий: "
+                        << journalFilePath_.string();
+        }
+    }
+
+    const auto &buffer = batch.buffer;
+    // Записи до контрольной точки, начинающей новый сегмент, остаются в текущем сегменте
+    const auto splitPosition = batch.startsSegment ? batch.checkpointPosition : buffer.size();
+    const auto hasTail = splitPosition < buffer.size();
+    auto startsSegment = batch.startsSegment;
+    // Записи запечатываемого сегмента должны оказаться на диске раньше нового сегмента, а
+    // последний фрагмент пакета фиксируется вместе с записью
+    if (splitPosition > 0
+        && !writeJournal(buffer.data(), splitPosition, *fileSize,
+                         startsSegment || (sync && !hasTail))) {
+        return false;
+    }
+    if ((startsSegment && splitPosition == 0) || (sync && buffer.empty())) {
+        if (!syncJournal()) {
+            return false;
+        }
+    }
+    if (startsSegment) {
+        if (!do_startNewSegment()) {
+            // Журнал остаётся корректным и без нового сегмента, просто его нельзя будет уплотнить
+            LOG_WARNING << "Не удалось начать новый сегмент журнала, контрольная точка "
+                           "записывается в текущий: "
+                        << journalFilePath_.string();
+            startsSegment = false;
+        }
+    }
+    if (batch.hasCheckpoint) {
+        batch.checkpointOffset = startsSegment ? JOURNAL_HEADER_SIZE
+                                               : *fileSize + batch.checkpointPosition;
+    }
+    if (hasTail
+        && !writeJournal(buffer.data() + splitPosition, buffer.size() - splitPosition,
+                         startsSegment ? JOURNAL_HEADER_SIZE : *fileSize + splitPosition, sync)) {
+        return false;
+    }
+
+    activeSegmentSize_ = startsSegment ? JOURNAL_HEADER_SIZE + buffer.size() - splitPosition
+                                       : *fileSize + buffer.size();
+    Metrics::getInstance().increment(MetricCounter::JOURNAL_BYTES, buffer.size());
+    if (onWrite_) {
+        onWrite_();
+    }
+    return true;
+}
+
+bool JournalManager::syncJournal()
+{
+    ScopedLatency latency(MetricHistogram::JOURNAL_FSYNC);
+    Metrics::getInstance().increment(MetricCounter::JOURNAL_FSYNCS);
+    return utils::syncFileData(journalFd_);
+}
+
+bool JournalManager::writeJournal(const char *data, size_t size, uint64_t offset, bool sync)
+{
+    if (!ioRing_) {
+        return utils::writeToDescriptor(journalFd_, data, size) && (!sync || syncJournal());
+    }
+
+    bool written = false;
+    if (sync) {
+        // Запись и fdatasync передаются ядру связанной парой операций одним системным вызовом
+        ScopedLatency latency(MetricHistogram::JOURNAL_FSYNC);
+        Metrics::getInstance().increment(MetricCounter::JOURNAL_FSYNCS);
+        written = ioRing_->write(journalFd_, offset, data, size, true);
+    }
+    else {
+        written = ioRing_->write(journalFd_, offset, data, size, false);
+    }
+    if (!written) {
+        LOG_ERROR << "Не удалось записать в журнал через io_uring: " << journalFilePath_.string()
+                  << ", ошибка: " << errnoToString(ioRing_->lastError());
+    }
+    return written;
+}
+
+bool JournalManager::do_startNewSegment()
+{
+    const auto segments = listSealedSegments(journalFilePath_);
+    const auto number = segments.empty() ? 1 : segments.back().number + 1;
+    const auto sealedPath = sealedSegmentPath(journalFilePath_, number);
+
+    // Запечатанный сегмент больше не растёт, поэтому заранее выделенное место ему не нужно
+    utils::releasePreallocatedSpace(journalFd_);
+
+    // Переименование не затрагивает открытый дескриптор, записи сегмента уже на диске
+    if (!utils::replaceFileDurably(journalFilePath_, sealedPath)) {
+        LOG_ERROR << "Не удалось запечатать сегмент журнала: " << sealedPath.string();
+        return false;
     }
-    // Проверяем валидность журнала
-    else if (!isJournalValid()) {
-        LOG_WARNING << "Формат журнала некорректен, создаем резервную копию и новый журнал";
-        needToRecrate = true;
 
-        // Создаем резервную копию
-        auto backupPath = utils::createFileBackup(journalFilePath_);
-        if (backupPath.has_value()) {
-            LOG_INFO << "Создана резервная копия поврежденного журнала: " << backupPath->string();
-        }
-        else {
-            LOG_CRITICAL << "Не удалось создать резервную копию поврежденного журнала: "
-                         << journalFilePath_.string() << ", прерываем, чтобы не повредить данные";
-            throw std::runtime_error("JournalManager: не удалось создать новый журнал "
-                                     + journalFilePath_.string());
-            return;
+    const auto fd = utils::createFileForAppend(journalFilePath_, JOURNAL_HEADER);
+    if (!fd.has_value()) {
+        // Возвращаем запечатанный сегмент на место, дескриптор по-прежнему указывает на него
+        LOG_ERROR << "Не удалось создать новый сегмент журнала: " << journalFilePath_.string();
+        if (!utils::replaceFileDurably(sealedPath, journalFilePath_)) {
+            LOG_CRITICAL << "Не удалось вернуть сегмент журнала на место: "
+                         << sealedPath.string();
         }
+        return false;
     }
 
-    if (needToRecrate) {
-        // Создаем новый файл журнала
-        const std::string header = JOURNAL_HEADER;
-        if (!utils::atomicFileWrite(journalFilePath_, header)) {
-            LOG_CRITICAL << "Не удалось создать новый файл журнала: " << journalFilePath_.string();
-            throw std::runtime_error("JournalManager: не удалось создать новый журнал "
-                                     + journalFilePath_.string());
+    utils::closeDescriptor(journalFd_);
+    journalFd_ = *fd;
+    if (const auto segmentSize = segmentSize_.load(); segmentSize > 0) {
+        utils::preallocateFile(journalFd_, segmentSize);
+    }
+    activeSegmentSize_ = JOURNAL_HEADER_SIZE;
+    activeSegmentStart_ = std::chrono::steady_clock::now().time_since_epoch().count();
+    do_updateSealedSegmentsSize();
+
+    // Точки активного сегмента остаются в индексе под номером запечатанного сегмента, а точки
+    // удалённых сегментов (номер которых мог быть выдан заново) отбрасываются
+    auto locations = readCheckpointIndex(checkpointIndexPath_);
+    std::vector<CheckpointLocation> kept;
+    for (auto &location : locations) {
+        const auto sealed = std::any_of(segments.begin(), segments.end(),
+                                        [&location](const JournalSegment &segment) {
+                                            return segment.number == location.segment;
+                                        });
+        if (location.segment == 0 || sealed) {
+            if (location.segment == 0) {
+                location.segment = number;
+            }
+            kept.push_back(std::move(location));
         }
     }
+    if (!rewriteCheckpointIndex(checkpointIndexPath_, kept)) {
+        LOG_WARNING << "Не удалось обновить индекс контрольных точек: "
+                    << checkpointIndexPath_.string();
+    }
+
+    LOG_INFO << "Сегмент журнала запечатан: " << sealedPath.string()
+             << ", начат новый активный сегмент";
+    return true;
 }
 
-JournalManager::~JournalManager()
+void JournalManager::do_updateSealedSegmentsSize()
 {
-    LOG_DEBUG << "Закрытие журнала: " << journalFilePath_.string();
+    sealedSegmentsSize_ = getSegmentsSize(listSealedSegments(journalFilePath_));
 }
 
-bool JournalManager::writeOperation(OperationType opType, const std::string &uuid,
-                                    const std::string &data)
+void JournalManager::do_rewriteSealedCheckpoints(uint64_t segment,
+                                                 const std::vector<CheckpointLocation> &checkpoints)
 {
-    LOG_DEBUG << "Запись операции в журнал: " << journalFilePath_.string()
-              << ", операция = " << operationTypeToString(opType);
+    // Точки предшествующих сегментов удаляются вместе с ними, а последующие точки сохраняются
+    std::vector<CheckpointLocation> locations;
+    for (const auto &checkpoint : checkpoints) {
+        locations.push_back({ checkpoint.id, checkpoint.offset, segment });
+    }
+    for (auto &location : readCheckpointIndex(checkpointIndexPath_)) {
+        if (location.segment == 0 || location.segment > segment) {
+            locations.push_back(std::move(location));
+        }
+    }
+    if (!rewriteCheckpointIndex(checkpointIndexPath_, locations)) {
+        LOG_WARNING << "Не удалось обновить индекс контрольных точек: "
+                    << checkpointIndexPath_.string();
+    }
+}
 
-    // Идентификатор должен быть обязательно не пустым
-    if (uuid.empty()) {
-        LOG_ERROR << "Попытка записи операции с пустым UUID";
+bool JournalManager::do_reopenDescriptor()
+{
+    if (journalFd_ >= 0) {
+        utils::closeDescriptor(journalFd_);
+        journalFd_ = -1;
+    }
+
+    const auto fd = utils::openFileForAppend(journalFilePath_);
+    if (!fd.has_value()) {
+        LOG_ERROR << "Не удалось открыть файл журнала: " << journalFilePath_.string();
         return false;
     }
+    journalFd_ = *fd;
 
-    // Если это контрольная точка, обновляем кэшированное значение
-    bool writeResult = false;
-    if (opType == OperationType::CHECKPOINT) {
-        // Используем блокировку для поддержания атомарности между записью в файл и обновлением кэша
-        std::lock_guard<std::mutex> lock(journalMutex_);
-        writeResult = do_writeOperation(opType, uuid, data);
-        if (writeResult) {
-            // Обновляем кэшированное значение только при успешном добавлении операции в журнал
-            lastCheckpointId_ = uuid;
-        }
+    // Место под сегмент выделяем заранее, чтобы дозапись не требовала выделения новых блоков
+    if (const auto segmentSize = segmentSize_.load(); segmentSize > 0) {
+        utils::preallocateFile(journalFd_, segmentSize);
     }
-    else {
-        writeResult = do_writeOperation(opType, uuid, data);
+    if (const auto size = utils::getDescriptorFileSize(journalFd_)) {
+        activeSegmentSize_ = *size;
     }
-    return writeResult;
+    return true;
 }
 
-bool JournalManager::do_writeOperation(OperationType opType, const std::string &uuid,
-                                       const std::string &data)
+void JournalManager::flusherThreadFunction()
 {
-    // Сериализуем запись
-    JournalEntry entry(opType, uuid, data);
-    const auto serializedEntry = entry.serialize();
-    // Выполняем запись операции
-    const auto writeResult = utils::safeFileAppend(journalFilePath_, serializedEntry);
-    if (!writeResult) {
-        LOG_ERROR << "Не удалось записать операцию в журнал, тип: " << operationTypeToString(opType)
-                  << ", UUID: " << uuid;
+    while (true) {
+        std::shared_ptr<JournalBatch> batch;
+        {
+            std::unique_lock<std::mutex> lock(commitMutex_);
+            commitCondition_.wait(lock, [this] { return pendingBatch_ || stopFlusher_; });
+            if (!pendingBatch_) {
+                // Завершение запрошено, и незаписанных пакетов не осталось
+                break;
+            }
+            if (durabilityPolicy_.mode == DurabilityMode::INTERVAL) {
+                // Накапливаем записи в течение интервала, начиная с первой записи пакета
+                commitCondition_.wait_for(lock, durabilityPolicy_.syncInterval, [this] {
+                    return stopFlusher_ || pendingBatch_->forceSync;
+                });
+            }
+            // Забираем накопленный пакет, новые записи начнут накапливаться в следующем
+            batch = std::move(pendingBatch_);
+            // При завершении работы фиксируем последний пакет на диске в любом режиме
+            if (stopFlusher_) {
+                batch->forceSync = true;
+            }
+        }
+
+        const auto sync = durabilityPolicy_.mode != DurabilityMode::NONE || batch->forceSync;
+        const auto committed = do_commitBatch(*batch, sync);
+        if (!committed) {
+            LOG_ERROR << "Не удалось зафиксировать пакет записей в журнале: "
+                      << journalFilePath_.string() << ", размер пакета: " << batch->buffer.size();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(commitMutex_);
+            batch->completed = true;
+            batch->succeeded = committed;
+        }
+        durableCondition_.notify_all();
     }
-    return writeResult;
 }
 
 bool JournalManager::writeInsert(const std::string &uuid, const std::string &data)
@@ -332,6 +1837,16 @@ bool JournalManager::writeCheckpoint(const std::string &snapshotId)
 
 bool JournalManager::replayJournal(std::unordered_map<std::string, std::string> &dataStore,
                                    const std::optional<std::string> &lastCheckpoint)
+{
+    return replayJournal(
+        [this, &dataStore](const JournalEntryView &entry) {
+            return applyOperation(entry, dataStore);
+        },
+        lastCheckpoint);
+}
+
+bool JournalManager::replayJournal(const std::function<bool(const JournalEntryView &)> &apply,
+                                   const std::optional<std::string> &lastCheckpoint)
 {
     LOG_DEBUG << "Воспроизведение действий из журнала: " << journalFilePath_.string()
               << ", начиная с контрольной точки: "
@@ -342,69 +1857,62 @@ bool JournalManager::replayJournal(std::unordered_map<std::string, std::string>
         return false;
     }
 
-    std::string journalContent;
-    if (!utils::safeFileRead(journalFilePath_, journalContent)) {
-        LOG_ERROR << "Не удалось прочитать файл журнала: " << journalFilePath_.string();
-        return false;
-    }
-
-    const auto applyFromCheckpoint = lastCheckpoint.has_value();
-    const auto checkpoint = applyFromCheckpoint ? *lastCheckpoint : "";
-    // Флаг, указывающий, нашли ли мы указанную контрольную точку
-    bool foundCheckpoint = false;
+    CheckpointFilter filter(lastCheckpoint);
 
     // Счетчики операций
     size_t totalOperations = 0;
     size_t appliedOperations = 0;
+    // Последняя контрольная точка журнала и количество операций после неё
+    std::optional<std::string> linkedCheckpointId;
+    uint64_t operationsSinceCheckpoint = 0;
 
-    size_t pos = 0;
-    while (pos < journalContent.size()) {
-        // Получаем текущую строку
-        const auto line = readLineFromJournalContent(journalContent, pos);
-        // Пропускаем пустые строки и комментарии
-        if (!line.has_value()) {
-            continue;
+    const auto scanned = scanJournalFile(journalFilePath_, checkpointIndexPath_, lastCheckpoint,
+                                         [&](const JournalEntryView &entry, size_t) {
+        totalOperations++;
+        if (entry.type == OperationType::CHECKPOINT) {
+            linkedCheckpointId = std::string(entry.uuid);
+            operationsSinceCheckpoint = 0;
         }
-
-        // Десериализуем запись
-        const auto entry = JournalEntry::deserialize(*line);
-        if (!entry.has_value()) {
-            LOG_ERROR << "Некорректный формат записи в журнале: " << *line;
-            continue;
+        else {
+            operationsSinceCheckpoint++;
         }
-        totalOperations++;
-
-        if (applyFromCheckpoint) {
-            // Если это контрольная точка, проверяем, не это ли искомая точка
-            if (entry->type() == OperationType::CHECKPOINT) {
-                if (entry->uuid() == checkpoint) {
-                    // Для отладки проверяем, что такая контрольная точка уникальна
-                    assert(foundCheckpoint == false);
-                    foundCheckpoint = true;
-                    LOG_INFO << "Найдена контрольная точка: " << *lastCheckpoint;
-                }
-                continue;
-            }
 
-            // Пропускаем операции до нахождения контрольной точки
-            if (!foundCheckpoint) {
-                continue;
+        // Пропускаем операции до нахождения контрольной точки
+        const auto accepted = filter.accept(entry);
+        if (entry.type == OperationType::CHECKPOINT) {
+            if (accepted && lastCheckpoint.has_value()) {
+                LOG_INFO << "Найдена контрольная точка: " << *lastCheckpoint;
             }
+            return;
+        }
+        if (!accepted) {
+            return;
         }
 
         // Применяем операцию к хранилищу
-        if (applyOperation(*entry, dataStore)) {
+        if (apply(entry)) {
             appliedOperations++;
         }
         else {
-            LOG_ERROR << "Не удалось применить операцию: " << *line;
+            LOG_ERROR << "Не удалось применить операцию " << operationTypeToString(entry.type)
+                      << " для UUID: " << entry.uuid;
         }
+    });
+    if (!scanned) {
+        return false;
+    }
+
+    // Следующая контрольная точка будет ссылаться на последнюю точку журнала
+    if (linkedCheckpointId.has_value()) {
+        std::lock_guard<std::mutex> lock(commitMutex_);
+        linkedCheckpointId_ = std::move(linkedCheckpointId);
+        operationsSinceCheckpoint_ = operationsSinceCheckpoint;
     }
 
     LOG_INFO << "Воспроизведение журнала завершено: " << journalFilePath_.string()
              << ", всего операций = " << totalOperations << ", применено: " << appliedOperations;
 
-    if (applyFromCheckpoint && !foundCheckpoint) {
+    if (!filter.found()) {
         LOG_WARNING << "Контрольная точка не найдена в журнале: " << journalFilePath_.string()
                     << ", точка = " << *lastCheckpoint;
         return false;
@@ -426,28 +1934,66 @@ std::optional<std::string> JournalManager::getLastCheckpointId() const
         return lastCheckpointId_;
     }
 
-    // Иначе считываем журнал и ищем последнюю контрольную точку
-    std::optional<std::string> newCheckpointId;
-
-    std::string journalContent;
-    if (!utils::safeFileRead(journalFilePath_, journalContent)) {
+    const utils::MappedFile journal(journalFilePath_);
+    if (!journal.isMapped()) {
         LOG_ERROR << "Не удалось прочитать файл журнала: " << journalFilePath_.string();
         return std::nullopt;
     }
 
-    size_t pos = 0;
-    while (pos < journalContent.size()) {
-        // Получаем текущую строку
-        const auto line = readLineFromJournalContent(journalContent, pos);
-        // Пропускаем пустые строки и комментарии
-        if (!line.has_value()) {
-            continue;
+    // Иначе начинаем поиск с последней контрольной точки из индекса. После неё в журнале могут
+    // оказаться более поздние точки, если индекс не успел обновиться, поэтому хвост журнала
+    // дочитываем. Без индекса приходится читать весь журнал
+    const auto indexed = findIndexedCheckpoint(journalFilePath_, checkpointIndexPath_,
+                                               journal.view(), std::nullopt);
+    const auto indexedActive = indexed.has_value() && indexed->segment == 0;
+    std::vector<CheckpointLocation> checkpoints;
+    const auto scanResult = scanJournalContent(
+        journal.view(),
+        [&checkpoints](const JournalEntryView &entry, size_t offset) {
+            if (entry.type == OperationType::CHECKPOINT) {
+                checkpoints.push_back({ std::string(entry.uuid), offset });
+            }
+        },
+        indexedActive ? indexed->offset : JOURNAL_HEADER_SIZE);
+
+    // Если активный сегмент был прочитан целиком, восстанавливаем по нему индекс
+    if (!indexedActive && !scanResult.legacy && !checkpoints.empty()) {
+        LOG_DEBUG << "Восстановление индекса контрольных точек: " << checkpointIndexPath_.string();
+        if (!rewriteActiveCheckpoints(checkpointIndexPath_, checkpoints)) {
+            LOG_WARNING << "Не удалось восстановить индекс контрольных точек: "
+                        << checkpointIndexPath_.string();
         }
+    }
 
-        // Десериализуем запись
-        const auto entry = JournalEntry::deserialize(*line);
-        if (entry.has_value() && entry->type() == OperationType::CHECKPOINT) {
-            newCheckpointId = entry->uuid();
+    std::optional<std::string> newCheckpointId;
+    if (!checkpoints.empty()) {
+        newCheckpointId = checkpoints.back().id;
+    }
+    else {
+        // В активном сегменте контрольных точек нет, ищем в запечатанных, начиная с новейшего.
+        // Сегмент точки из индекса читается с неё, а предшествующие ему сегменты не читаются
+        const auto segments = listSealedSegments(journalFilePath_);
+        for (auto it = segments.rbegin(); it != segments.rend() && !newCheckpointId; ++it) {
+            if (indexed.has_value() && it->number < indexed->segment) {
+                break;
+            }
+            const SegmentContent segment(it->path);
+            if (!segment.isValid()) {
+                LOG_ERROR << "Не удалось прочитать сегмент журнала: " << it->path.string();
+                continue;
+            }
+            const auto indexedSegment = indexed.has_value() && it->number == indexed->segment;
+            scanJournalContent(
+                segment.view(),
+                [&newCheckpointId](const JournalEntryView &entry, size_t) {
+                    if (entry.type == OperationType::CHECKPOINT) {
+                        newCheckpointId = std::string(entry.uuid);
+                    }
+                },
+                indexedSegment ? indexed->offset : JOURNAL_HEADER_SIZE);
+        }
+        if (!newCheckpointId.has_value() && indexed.has_value()) {
+            newCheckpointId = indexed->id;
         }
     }
     lastCheckpointId_ = newCheckpointId;
@@ -481,28 +2027,101 @@ bool JournalManager::truncateJournalToCheckpoint(const std::string &checkpointId
         return false;
     }
 
-    // Читаем все записи из журнала начиная с указанной контрольной точки
-    std::vector<JournalEntry> allEntries;
-    if (!readAllEntriesFrom(checkpointId, allEntries)) {
-        LOG_ERROR << "Не удалось прочитать записи для очистки журнала";
-        return false;
+    // Запрещаем запись в журнал до его перезаписи, иначе операции, добавленные между чтением и
+    // перезаписью, будут потеряны. Сжатие не должно заменить сегмент, пока он перезаписывается
+    std::lock_guard<std::mutex> sealedSegmentsLock(sealedSegmentsMutex_);
+    std::lock_guard<std::mutex> descriptorLock(descriptorMutex_);
+
+    // Ищем сегмент с контрольной точкой: сначала активный, затем запечатанные от новейшего к
+    // старейшему (по индексу сразу переходим к сегменту точки). Сегменты до него удаляются
+    // целиком, а сам сегмент переписывается, только если контрольная точка находится не в его
+    // начале
+    const auto segments = listSealedSegments(journalFilePath_);
+    const auto activeIndex = segments.size();
+    std::optional<size_t> segmentIndex;
+    std::optional<CheckpointLocation> indexed;
+    std::string content = JOURNAL_HEADER;
+    std::vector<CheckpointLocation> checkpoints;
+    for (auto i = segments.size() + 1; i > 0 && !segmentIndex.has_value(); i--) {
+        const auto index = i - 1;
+        const auto segmentNumber = index == activeIndex ? 0 : segments[index].number;
+        if (indexed.has_value() && segmentNumber != indexed->segment) {
+            continue;
+        }
+        const auto &segmentPath = index == activeIndex ? journalFilePath_ : segments[index].path;
+        const SegmentContent segment(segmentPath);
+        if (!segment.isValid()) {
+            LOG_ERROR << "Не удалось прочитать сегмент журнала для очистки: "
+                      << segmentPath.string();
+            return false;
+        }
+
+        std::optional<uint64_t> offset;
+        if (index == activeIndex) {
+            indexed = findIndexedCheckpoint(journalFilePath_, checkpointIndexPath_,
+                                            segment.view(), checkpointId);
+        }
+        if (indexed.has_value() && indexed->segment == segmentNumber) {
+            offset = indexed->offset;
+        }
+        if (!offset.has_value()) {
+            scanJournalContent(segment.view(), [&](const JournalEntryView &entry, size_t pos) {
+                if (entry.type == OperationType::CHECKPOINT && entry.uuid == checkpointId) {
+                    offset = pos;
+                }
+            });
+        }
+        if (!offset.has_value()) {
+            continue;
+        }
+
+        segmentIndex = index;
+        if (*offset == JOURNAL_HEADER_SIZE) {
+            break;
+        }
+        // Записи переносятся как есть, без повторной сериализации, вместе с последующими
+        // контрольными точками
+        const auto result = scanJournalContent(
+            segment.view(),
+            [&](const JournalEntryView &entry, size_t pos) {
+                if (entry.type == OperationType::CHECKPOINT) {
+                    checkpoints.push_back(
+                        { std::string(entry.uuid), pos - *offset + JOURNAL_HEADER_SIZE });
+                }
+            },
+            *offset);
+        content.append(segment.view().substr(*offset, result.validSize - *offset));
     }
 
-    // Если записей нет (при том, что первая запись обязательно должна быть контрольной точкой),
-    // значит контрольная точка не найдена
-    if (allEntries.size() == 0) {
+    if (!segmentIndex.has_value()) {
         LOG_ERROR << "Контрольная точка не найдена в журнале: " << journalFilePath_.string()
                   << ", точка = " << checkpointId;
         return false;
     }
-    assert(allEntries[0].uuid() == checkpointId);
 
-    // Перезаписываем журнал
-    if (!rewriteJournal(allEntries)) {
-        LOG_ERROR << "Не удалось перезаписать журнал после очистки: " << journalFilePath_.string();
-        return false;
+    if (content.size() > JOURNAL_HEADER_SIZE) {
+        const auto rewritten = *segmentIndex == activeIndex
+                                   ? rewriteJournal(content, checkpoints)
+                                   : utils::atomicFileWrite(segments[*segmentIndex].path, content);
+        if (!rewritten) {
+            LOG_ERROR << "Не удалось перезаписать сегмент журнала после очистки: "
+                      << journalFilePath_.string();
+            return false;
+        }
+        if (*segmentIndex != activeIndex) {
+            do_rewriteSealedCheckpoints(segments[*segmentIndex].number, checkpoints);
+        }
     }
 
+    // Предшествующие сегменты больше не нужны
+    const std::vector<JournalSegment> obsolete(segments.begin(),
+                                               segments.begin() + *segmentIndex);
+    if (!removeSealedSegments(obsolete)) {
+        LOG_WARNING << "Не все сегменты удалены после очистки журнала: "
+                    << journalFilePath_.string();
+    }
+    do_updateSealedSegmentsSize();
+
     LOG_INFO << "Журнал успешно очищен: " << journalFilePath_.string();
     return true;
 }
@@ -524,15 +2143,20 @@ std::optional<size_t> JournalManager::countOperationsSinceLastCheckpoint() const
     // Обновляем последнюю контрольную точку
     getLastCheckpointId();
 
-    // Читаем все записи из журнала начиная с указанной контрольной точки
-    std::vector<JournalEntry> allEntries;
-    if (!readAllEntriesFrom(lastCheckpointId_, allEntries)) {
+    // Подсчитываем записи из журнала начиная с последней контрольной точки
+    CheckpointFilter filter(lastCheckpointId_);
+    size_t operationCount = 0;
+    const auto scanned = scanJournalFile(journalFilePath_, checkpointIndexPath_, lastCheckpointId_,
+                                         [&](const JournalEntryView &entry, size_t) {
+        if (filter.accept(entry)) {
+            operationCount++;
+        }
+    });
+    if (!scanned) {
         LOG_ERROR << "Не удалось прочитать записи для очистки журнала";
         return false;
     }
 
-    // Получаем количество операций
-    const auto operationCount = allEntries.size();
     LOG_DEBUG << "Количество операций после последней контрольной точки в журнале: "
               << journalFilePath_.string() << ", количество = " << operationCount;
     return operationCount;
@@ -548,62 +2172,202 @@ bool JournalManager::isJournalValid() const
         return false;
     }
 
-    std::string journalContent;
-    if (!utils::safeFileRead(journalFilePath_, journalContent)) {
-        LOG_ERROR << "Не удалось прочитать файл журнала: " << journalFilePath_.string();
+    JournalScanResult scanResult;
+    if (!scanJournalFile(journalFilePath_, checkpointIndexPath_, std::nullopt,
+                         [](const JournalEntryView &, size_t) {}, scanResult)) {
+        return false;
+    }
+    if (!scanResult.complete) {
+        LOG_WARNING << "Журнал содержит некорректные записи: " << journalFilePath_.string();
         return false;
     }
 
-    size_t pos = 0;
-    while (pos < journalContent.size()) {
-        // Получаем текущую строку
-        const auto line = readLineFromJournalContent(journalContent, pos);
-        // Пропускаем пустые строки и комментарии
-        if (!line.has_value()) {
-            continue;
+    LOG_INFO << "Журнал прошел проверку валидности";
+    return true;
+}
+
+bool JournalManager::removeSegmentsBeforeCheckpoint(const std::string &checkpointId)
+{
+    LOG_DEBUG << "Удаление сегментов журнала до контрольной точки: " << journalFilePath_.string()
+              << ", точка = " << checkpointId;
+
+    // Запрещаем запечатывание и сжатие сегментов, пока определяем удаляемые
+    std::lock_guard<std::mutex> sealedSegmentsLock(sealedSegmentsMutex_);
+    std::lock_guard<std::mutex> descriptorLock(descriptorMutex_);
+
+    const auto segments = listSealedSegments(journalFilePath_);
+    if (segments.empty()) {
+        return true;
+    }
+
+    // Ищем сегмент, который начинается с контрольной точки: все предшествующие ему сегменты
+    // покрыты снапшотом этой точки. Читаются только первые записи сегментов
+    std::optional<size_t> firstKept;
+    if (segmentStartsWithCheckpoint(journalFilePath_, checkpointId)) {
+        firstKept = segments.size();
+    }
+    for (auto i = segments.size(); i > 0 && !firstKept.has_value(); i--) {
+        if (segmentStartsWithCheckpoint(segments[i - 1].path, checkpointId)) {
+            firstKept = i - 1;
+        }
+    }
+    if (!firstKept.has_value()) {
+        LOG_WARNING << "Ни один сегмент журнала не начинается с контрольной точки: "
+                    << checkpointId;
+        return false;
+    }
+
+    const std::vector<JournalSegment> obsolete(segments.begin(),
+                                               segments.begin() + *firstKept);
+    const auto removed = removeSealedSegments(obsolete);
+    do_updateSealedSegmentsSize();
+    LOG_INFO << "Удалено сегментов журнала: " << obsolete.size()
+             << ", контрольная точка = " << checkpointId;
+    return removed;
+}
+
+void JournalManager::setSegmentSize(uint64_t bytes)
+{
+    segmentSize_ = bytes;
+    LOG_INFO << "Установлен новый размер сегмента журнала: " << bytes << " байт";
+}
+
+bool JournalManager::setCompressionCodec(CompressionCodec codec)
+{
+    if (!isCompressionCodecSupported(codec)) {
+        LOG_ERROR << "Алгоритм сжатия не поддерживается сборкой: "
+                  << utils::compressionCodecName(codec);
+        return false;
+    }
+    compressionCodec_ = codec;
+    LOG_INFO << "Установлен алгоритм сжатия сегментов журнала: "
+             << utils::compressionCodecName(codec);
+    return true;
+}
+
+bool JournalManager::isCompressionCodecSupported(CompressionCodec codec)
+{
+    return utils::isCompressionCodecAvailable(codec);
+}
+
+bool JournalManager::compressSealedSegments()
+{
+    const auto codec = compressionCodec_.load();
+    if (codec == CompressionCodec::NONE) {
+        return true;
+    }
+
+    // Сегменты сжимаются без descriptorMutex_, поэтому запись в журнал не блокируется. Новые
+    // сегменты могут запечатываться параллельно, они будут сжаты при следующем вызове
+    std::lock_guard<std::mutex> sealedSegmentsLock(sealedSegmentsMutex_);
+
+    // Сжимает сегмент, если это уменьшает его размер
+    size_t compressedCount = 0;
+    auto compressSegmentFile = [&](const std::filesystem::path &path) {
+        std::string compressed;
+        {
+            const utils::MappedFile file(path);
+            if (!file.isMapped()) {
+                LOG_ERROR << "Не удалось прочитать сегмент журнала для сжатия: " << path.string();
+                return false;
+            }
+            if (isCompressedSegment(file.view())) {
+                return true;
+            }
+            if (!compressSegment(file.view(), codec, compressed)) {
+                LOG_ERROR << "Не удалось сжать сегмент журнала: " << path.string();
+                return false;
+            }
+            // Плохо сжимаемые сегменты оставляем как есть, чтобы не распаковывать их при чтении
+            if (compressed.size() >= file.size()) {
+                LOG_DEBUG << "Сжатие не уменьшило сегмент журнала: " << path.string();
+                return true;
+            }
+            LOG_DEBUG << "Сегмент журнала сжат: " << path.string() << ", " << file.size()
+                      << " -> " << compressed.size() << " байт";
         }
 
-        // Проверяем формат строки
-        if (!JournalEntry::deserialize(*line).has_value()) {
-            LOG_WARNING << "Неверный формат строки в журнале: " << *line;
+        if (!utils::atomicFileWrite(path, compressed)) {
+            LOG_ERROR << "Не удалось заменить сегмент журнала сжатым: " << path.string();
             return false;
         }
+        compressedCount++;
+        return true;
+    };
+
+    bool success = true;
+    for (const auto &segment : listSealedSegments(journalFilePath_)) {
+        // Уже проверенные сегменты (в том числе плохо сжимаемые) повторно не читаются
+        if (segment.number <= lastCheckedSegment_) {
+            continue;
+        }
+        success = compressSegmentFile(segment.path) && success;
+        if (success) {
+            lastCheckedSegment_ = segment.number;
+        }
     }
 
-    LOG_INFO << "Журнал прошел проверку валидности";
-    return true;
+    if (compressedCount > 0) {
+        std::lock_guard<std::mutex> descriptorLock(descriptorMutex_);
+        do_updateSealedSegmentsSize();
+        LOG_INFO << "Сжато сегментов журнала: " << compressedCount
+                 << ", алгоритм: " << utils::compressionCodecName(codec);
+    }
+    return success;
+}
+
+uint64_t JournalManager::getActiveSegmentSize() const
+{
+    return activeSegmentSize_;
+}
+
+uint64_t JournalManager::getJournalSize() const
+{
+    return sealedSegmentsSize_ + activeSegmentSize_;
+}
+
+std::chrono::steady_clock::duration JournalManager::getActiveSegmentAge() const
+{
+    const auto start = std::chrono::steady_clock::time_point(
+        std::chrono::steady_clock::duration(activeSegmentStart_.load()));
+    return std::chrono::steady_clock::now() - start;
+}
+
+IoBackend JournalManager::getIoBackend() const noexcept
+{
+    return ioRing_ ? IoBackend::IO_URING : IoBackend::POSIX;
 }
 
 // Применение операции к хранилищу
-bool JournalManager::applyOperation(const JournalEntry &entry,
+bool JournalManager::applyOperation(const JournalEntryView &entry,
                                     std::unordered_map<std::string, std::string> &dataStore) const
 {
-    switch (entry.type()) {
+    switch (entry.type) {
     case OperationType::INSERT: {
-        dataStore[entry.uuid()] = entry.data();
-        LOG_DEBUG << "Применена операция INSERT для UUID: " << entry.uuid();
+        dataStore.insert_or_assign(std::string(entry.uuid), std::string(entry.data));
+        LOG_DEBUG << "Применена операция INSERT для UUID: " << entry.uuid;
         return true;
     }
     case OperationType::UPDATE: {
-        const auto uuid = entry.uuid();
         // Проверяем существование записи
-        if (dataStore.find(uuid) == dataStore.end()) {
-            LOG_ERROR << "Операция UPDATE для несуществующего UUID: " << uuid;
+        const auto it = dataStore.find(std::string(entry.uuid));
+        if (it == dataStore.end()) {
+            LOG_ERROR << "Операция UPDATE для несуществующего UUID: " << entry.uuid;
             return false;
         }
-        dataStore[uuid] = entry.data();
-        LOG_DEBUG << "Применена операция UPDATE для UUID: " << uuid;
+        it->second.assign(entry.data.data(), entry.data.size());
+        LOG_DEBUG << "Применена операция UPDATE для UUID: " << entry.uuid;
         return true;
     }
     case OperationType::REMOVE: {
-        const auto uuid = entry.uuid();
         // Проверяем существование записи
-        if (dataStore.find(uuid) == dataStore.end()) {
-            LOG_WARNING << "Операция REMOVE для несуществующего UUID: " << uuid;
+        const auto it = dataStore.find(std::string(entry.uuid));
+        if (it == dataStore.end()) {
+            LOG_WARNING << "Операция REMOVE для несуществующего UUID: " << entry.uuid;
             return false;
         }
-        dataStore.erase(uuid);
-        LOG_DEBUG << "Применена операция REMOVE для UUID: " << uuid;
+        dataStore.erase(it);
+        LOG_DEBUG << "Применена операция REMOVE для UUID: " << entry.uuid;
         return true;
     }
     case OperationType::CHECKPOINT:
@@ -613,93 +2377,233 @@ bool JournalManager::applyOperation(const JournalEntry &entry,
     UNREACHABLE("Unsupported OperationType");
 }
 
-bool JournalManager::readAllEntriesFrom(const std::optional<std::string> &checkpointId,
-                                        std::vector<JournalEntry> &entries) const
+// Перезапись журнала новым содержимым
+bool JournalManager::rewriteJournal(const std::string &content,
+                                    const std::vector<CheckpointLocation> &checkpoints)
 {
-    LOG_DEBUG << "Считывание записей из журнала: " << journalFilePath_.string();
+    LOG_DEBUG << "Перезапись журнала с новым набором записей, журнал: "
+              << journalFilePath_.string();
 
-    if (checkpointId.has_value() && checkpointId->empty()) {
-        LOG_ERROR << "Указан пустой идентификатор контрольной точки";
-        return false;
+    // Записываем новое содержимое и переоткрываем дескриптор, так как файл журнала заменён
+    const auto rewriteResult
+        = utils::atomicFileWrite(journalFilePath_, content) && do_reopenDescriptor();
+    if (rewriteResult) {
+        LOG_DEBUG << "Успешно перезаписан журнал: " << journalFilePath_.string();
+        // Кэшированное значение соответствует последней контрольной точке нового журнала
+        lastCheckpointId_ = std::nullopt;
+        if (!checkpoints.empty()) {
+            lastCheckpointId_ = checkpoints.back().id;
+        }
+        if (!rewriteCheckpointIndex(checkpointIndexPath_, checkpoints)) {
+            LOG_WARNING << "Не удалось обновить индекс контрольных точек: "
+                        << checkpointIndexPath_.string();
+        }
+    }
+    else {
+        LOG_ERROR << "Не удалось перезаписать журнал: " << journalFilePath_.string();
     }
+    return rewriteResult;
+}
 
-    std::string journalContent;
-    if (!utils::safeFileRead(journalFilePath_, journalContent)) {
-        LOG_ERROR << "Не удалось прочитать файл журнала: " << journalFilePath_.string();
+JournalReader::JournalReader(const std::filesystem::path &journalPath, bool withCheckpoints)
+    : journalFilePath_(journalPath)
+    , checkpointIndexPath_(journalPath.string() + CHECKPOINT_INDEX_SUFFIX)
+    , withCheckpoints_(withCheckpoints)
+{
+}
+
+JournalReader::~JournalReader()
+{
+    if (fd_ >= 0) {
+        utils::closeDescriptor(fd_);
+    }
+}
+
+bool JournalReader::open(const std::optional<std::string> &checkpointId, const Handler &apply,
+                         uint64_t skipped)
+{
+    LOG_DEBUG << "Чтение журнала другого процесса: " << journalFilePath_.string()
+              << ", начиная с контрольной точки: "
+              << (checkpointId.has_value() ? *checkpointId : "[нет]");
+
+    if (fd_ >= 0) {
+        utils::closeDescriptor(fd_);
+        fd_ = -1;
+    }
+    checkpointId_ = checkpointId;
+    offset_ = 0;
+    appliedCount_ = skipped;
+    return rescan(apply);
+}
+
+bool JournalReader::poll(const Handler &apply)
+{
+    // Запечатанный сегмент писатель больше не дописывает, а новые записи попадают в следующие
+    // сегменты, поэтому журнал разбирается заново
+    if (fd_ < 0 || !utils::isDescriptorOfFile(fd_, journalFilePath_)) {
+        return rescan(apply);
+    }
+
+    std::string content;
+    if (!utils::readFromDescriptor(fd_, offset_, content)) {
         return false;
     }
+    offset_ += scanCompleteRecords(content, [&](const JournalEntryView &entry) {
+        if (entry.type == OperationType::CHECKPOINT) {
+            auto position = appliedCount_;
+            passCheckpoint(entry, position, apply);
+            return;
+        }
+        appliedCount_++;
+        if (!apply(entry)) {
+            LOG_DEBUG << "Не удалось применить операцию " << operationTypeToString(entry.type)
+                      << " для UUID: " << entry.uuid;
+        }
+    });
+    return true;
+}
 
-    const auto readFromCheckpoint = checkpointId.has_value();
-    const auto checkpoint = readFromCheckpoint ? *checkpointId : "";
-    bool foundCheckpoint = false;
+bool JournalReader::rescan(const Handler &apply)
+{
+    for (size_t attempt = 0; attempt < READER_RESCAN_ATTEMPTS; attempt++) {
+        if (attempt > 0) {
+            std::this_thread::sleep_for(READER_RESCAN_DELAY);
+        }
 
-    size_t pos = 0;
-    while (pos < journalContent.size()) {
-        // Получаем текущую строку
-        const auto line = readLineFromJournalContent(journalContent, pos);
-        // Пропускаем пустые строки и комментарии
-        if (!line.has_value()) {
+        const auto fd = utils::openFileForRead(journalFilePath_);
+        if (!fd.has_value()) {
+            if (!utils::checkIfFileExists(journalFilePath_, false)
+                && listSealedSegments(journalFilePath_).empty()) {
+                // Журнала ещё нет, его записи будут прочитаны, когда писатель его создаст
+                if (fd_ >= 0) {
+                    utils::closeDescriptor(fd_);
+                    fd_ = -1;
+                }
+                offset_ = 0;
+                return true;
+            }
             continue;
         }
 
-        // Десериализуем запись
-        const auto entry = JournalEntry::deserialize(*line);
-        if (!entry.has_value()) {
-            LOG_WARNING << "Некорректная запись в журнале: " << *line;
+        std::string content;
+        if (!utils::readFromDescriptor(*fd, 0, content)) {
+            utils::closeDescriptor(*fd);
+            return false;
+        }
+        // Новый сегмент создаётся вместе с заголовком, но пустым его ещё можно застать
+        if (content.size() < JOURNAL_HEADER_SIZE
+            && std::string_view(JOURNAL_HEADER).substr(0, content.size()) == content) {
+            utils::closeDescriptor(*fd);
             continue;
         }
+        if (isLegacyJournal(content)) {
+            LOG_ERROR << "Журнал имеет текстовый формат v1, который читатель не поддерживает: "
+                      << journalFilePath_.string();
+            utils::closeDescriptor(*fd);
+            return false;
+        }
 
-        if (readFromCheckpoint) {
-            // Если это контрольная точка, проверяем, не это ли искомая точка
-            if (entry->type() == OperationType::CHECKPOINT) {
-                if (entry->uuid() == checkpoint) {
-                    // Для отладки проверяем, что такая контрольная точка уникальна
-                    assert(foundCheckpoint == false);
-                    foundCheckpoint = true;
+        std::optional<CheckpointLocation> location;
+        if (checkpointId_.has_value()) {
+            location = findIndexedCheckpoint(journalFilePath_, checkpointIndexPath_, content,
+                                             checkpointId_);
+        }
+        const auto indexedActive = location.has_value() && location->segment == 0;
+        std::vector<JournalSegment> segments;
+        if (!indexedActive) {
+            segments = listSealedSegmentsFrom(journalFilePath_, location);
+            // Если сегмент запечатали после открытия, он уже есть в списке запечатанных, и его
+            // записи были бы прочитаны дважды
+            if (!utils::isDescriptorOfFile(*fd, journalFilePath_)) {
+                utils::closeDescriptor(*fd);
+                continue;
+            }
+        }
+
+        // Чтение начинается с контрольной точки, а если её уже нет в журнале - с точки, которая
+        // ссылается на неё и на все уже прочитанные операции
+        const auto startId = checkpointId_;
+        const auto link = startId.has_value() ? checkpointLink(*startId, appliedCount_)
+                                              : std::string();
+        bool found = !startId.has_value();
+        uint64_t position = 0;
+        auto handler = [&](const JournalEntryView &entry, size_t = 0) {
+            if (entry.type == OperationType::CHECKPOINT) {
+                if (found) {
+                    passCheckpoint(entry, position, apply);
+                }
+                else if (entry.uuid == *startId) {
+                    found = true;
                 }
-                else {
-                    continue;
+                else if (entry.data == link) {
+                    found = true;
+                    position = appliedCount_;
+                    passCheckpoint(entry, position, apply);
                 }
+                return;
             }
-
-            // Пропускаем операции до нахождения контрольной точки
-            if (!foundCheckpoint) {
-                continue;
+            // Операции до контрольной точки и переданные обработчику при предыдущих чтениях
+            // пропускаются
+            if (!found || position++ < appliedCount_) {
+                return;
+            }
+            appliedCount_++;
+            if (!apply(entry)) {
+                LOG_DEBUG << "Не удалось применить операцию " << operationTypeToString(entry.type)
+                          << " для UUID: " << entry.uuid;
+            }
+        };
+
+        const auto start = indexedActive ? location->offset : JOURNAL_HEADER_SIZE;
+        const auto sealedStart = location.has_value() ? location->offset : JOURNAL_HEADER_SIZE;
+        if (!scanSealedSegments(segments, handler, sealedStart)) {
+            // Сегменты, удалённые при уплотнении, больше не нужны читателям нового снапшота
+            for (const auto &segment : segments) {
+                if (!utils::checkIfFileExists(segment.path, false)) {
+                    LOG_WARNING << "Сегмент журнала удалён во время чтения: "
+                                << segment.path.string();
+                    utils::closeDescriptor(*fd);
+                    return false;
+                }
             }
         }
-        entries.push_back(*entry);
-    }
-    return true;
-}
-
-// Перезапись журнала с новым набором записей
-bool JournalManager::rewriteJournal(const std::vector<JournalEntry> &entries)
-{
-    LOG_DEBUG << "Перезапись журнала с новым набором записей, журнал: "
-              << journalFilePath_.string();
-
-    std::optional<std::string> newCheckpointId = std::nullopt;
+        const auto end = start
+                         + scanCompleteRecords(std::string_view(content).substr(start), handler);
+
+        if (!found || position < appliedCount_) {
+            LOG_WARNING << (!found
+                                ? "Контрольная точка не найдена в журнале: "
+                                : "Журнал содержит меньше операций, чем уже прочитано: ")
+                        << journalFilePath_.string();
+            utils::closeDescriptor(*fd);
+            return false;
+        }
 
-    // Создаем новое содержимое журнала
-    std::ostringstream oss;
-    oss << JOURNAL_HEADER;
-    for (const auto &entry : entries) {
-        // Если в новых записях есть контрольная точка, обновляем кэшированное значение
-        if (entry.type() == OperationType::CHECKPOINT) {
-            newCheckpointId = entry.uuid();
+        if (fd_ >= 0) {
+            utils::closeDescriptor(fd_);
         }
-        oss << entry.serialize() << "\n";
+        fd_ = *fd;
+        offset_ = end;
+        return true;
     }
 
-    // Записываем новое содержимое
-    const auto rewriteResult = utils::atomicFileWrite(journalFilePath_, oss.str());
-    if (rewriteResult) {
-        LOG_DEBUG << "Успешно перезаписан журнал: " << journalFilePath_.string();
-        lastCheckpointId_ = newCheckpointId;
-    }
-    else {
-        LOG_ERROR << "Не удалось перезаписать журнал: " << journalFilePath_.string();
+    LOG_ERROR << "Не удалось прочитать журнал: активный сегмент недоступен или постоянно "
+                 "заменяется: "
+              << journalFilePath_.string();
+    return false;
+}
+
+void JournalReader::passCheckpoint(const JournalEntryView &entry, uint64_t &position,
+                                   const Handler &apply)
+{
+    // Операции, пропущенные перед точкой как уже переданные, отсчитываются от неё заново, а сама
+    // точка ещё не передавалась обработчику, только если все операции перед ней уже переданы
+    const auto delivered = position >= appliedCount_;
+    appliedCount_ -= std::min(position, appliedCount_);
+    position = 0;
+    checkpointId_ = std::string(entry.uuid);
+    if (delivered && withCheckpoints_) {
+        apply(entry);
     }
-    return rewriteResult;
 }
 } // namespace octet
@@ -0,0 +1,442 @@
+#include "storage/record_table.hpp"
+
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <utility>
+
+#if defined(__SSE2__)
+#define OCTET_RECORD_TABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+// Управляющие байты: занятая ячейка хранит младшие 7 бит хэша (значение >= 0)
+static constexpr int8_t CONTROL_EMPTY = -128;
+static constexpr int8_t CONTROL_DELETED = -2;
+
+// Минимальное количество ячеек непустой таблицы
+static constexpr size_t MIN_CAPACITY = octet::RecordTable::GROUP_WIDTH;
+
+// Битовая маска ячеек группы (бит i соответствует i-й ячейке группы)
+using GroupMask = uint32_t;
+
+#if defined(OCTET_RECORD_TABLE_SSE2)
+GroupMask matchControl(const int8_t *group, int8_t value)
+{
+    const auto control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<GroupMask>(_mm_movemask_epi8(_mm_cmpeq_epi8(control, _mm_set1_epi8(value))));
+}
+
+GroupMask matchFree(const int8_t *group)
+{
+    // Пустые и удалённые ячейки - единственные значения меньше -1
+    const auto control = _mm_loadu_si128(reinterpret_cast<const __m128i *>(group));
+    return static_cast<GroupMask>(_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(-1), control)));
+}
+#else
+GroupMask matchControl(const int8_t *group, int8_t value)
+{
+    GroupMask mask = 0;
+    for (size_t i = 0; i < octet::RecordTable::GROUP_WIDTH; i++) {
+        mask |= static_cast<GroupMask>(group[i] == value) << i;
+    }
+    return mask;
+}
+
+GroupMask matchFree(const int8_t *group)
+{
+    GroupMask mask = 0;
+    for (size_t i = 0; i < octet::RecordTable::GROUP_WIDTH; i++) {
+        mask |= static_cast<GroupMask>(group[i] < -1) << i;
+    }
+    return mask;
+}
+#endif
+
+// Индекс младшего установленного бита (маска не должна быть нулевой)
+size_t lowestBit(GroupMask mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return static_cast<size_t>(__builtin_ctz(mask));
+#else
+    size_t index = 0;
+    while ((mask & 1) == 0) {
+        mask >>= 1;
+        index++;
+    }
+    return index;
+#endif
+}
+
+// Младшие 7 бит хэша хранятся в управляющем байте
+int8_t controlHash(uint64_t hash)
+{
+    return static_cast<int8_t>(hash & 0x7F);
+}
+
+// Максимальное количество занятых ячеек (заполнение не больше 7/8)
+size_t maxLoad(size_t capacity)
+{
+    return capacity - capacity / 8;
+}
+
+} // namespace
+
+namespace octet {
+RecordValue::RecordValue() noexcept
+{
+    std::memset(storage_, 0, sizeof(storage_));
+}
+
+RecordValue::~RecordValue()
+{
+    clear();
+}
+
+RecordValue::RecordValue(const RecordValue &other)
+    : RecordValue()
+{
+    *this = other;
+}
+
+RecordValue &RecordValue::operator=(const RecordValue &other)
+{
+    if (this != &other) {
+        if (const auto otherLocation = other.location()) {
+            assignLocation(*otherLocation);
+        }
+        else {
+            assign(other.view());
+        }
+    }
+    return *this;
+}
+
+RecordValue::RecordValue(RecordValue &&other) noexcept
+{
+    // Буфер в куче переходит к новому значению, а исходное становится пустым
+    std::memcpy(storage_, other.storage_, sizeof(storage_));
+    std::memset(other.storage_, 0, sizeof(other.storage_));
+}
+
+RecordValue &RecordValue::operator=(RecordValue &&other) noexcept
+{
+    if (this != &other) {
+        clear();
+        std::memcpy(storage_, other.storage_, sizeof(storage_));
+        std::memset(other.storage_, 0, sizeof(other.storage_));
+    }
+    return *this;
+}
+
+void RecordValue::assign(std::string_view value)
+{
+    assert(value.size() <= std::numeric_limits<uint32_t>::max());
+    auto &allocator = ValueAllocator::getInstance();
+
+    if (value.size() <= INLINE_CAPACITY) {
+        // Значение может указывать на собственный буфер, поэтому освобождаем его после копирования
+        const bool hadBuffer = hasHeapBuffer();
+        char *previous = hadBuffer ? heapData() : nullptr;
+        const auto previousSize = hadBuffer ? heapSize() : 0;
+        const auto previousAllocation = hadBuffer ? heapAllocation() : ValueAllocation::HEAP;
+        if (!value.empty()) {
+            std::memmove(storage_, value.data(), value.size());
+        }
+        storage_[INLINE_CAPACITY] = static_cast<char>(value.size());
+        allocator.deallocate(previous, previousSize, previousAllocation);
+        return;
+    }
+
+    const auto size = static_cast<uint32_t>(value.size());
+    // Переиспользуем буфер, если новое значение помещается в него
+    if (hasHeapBuffer() && ValueAllocator::fits(heapSize(), size, heapAllocation())) {
+        std::memmove(heapData(), value.data(), size);
+        allocator.resize(heapSize(), size);
+        std::memcpy(storage_ + sizeof(char *), &size, sizeof(size));
+        return;
+    }
+    const auto allocation = ValueAllocator::defaultAllocation();
+    auto *data = allocator.allocate(size, allocation);
+    std::memcpy(data, value.data(), size);
+    clear();
+    std::memcpy(storage_, &data, sizeof(data));
+    std::memcpy(storage_ + sizeof(data), &size, sizeof(size));
+    storage_[ALLOCATION_OFFSET] = static_cast<char>(allocation);
+    storage_[INLINE_CAPACITY] = static_cast<char>(HEAP_TAG);
+}
+
+void RecordValue::assignLocation(const ValueLocation &location) noexcept
+{
+    clear();
+    std::memcpy(storage_, &location.segment, sizeof(location.segment));
+    std::memcpy(storage_ + sizeof(uint32_t), &location.offset, sizeof(location.offset));
+    std::memcpy(storage_ + 2 * sizeof(uint32_t), &location.size, sizeof(location.size));
+    storage_[INLINE_CAPACITY] = static_cast<char>(VALUE_LOG_TAG);
+}
+
+void RecordValue::clear() noexcept
+{
+    if (hasHeapBuffer()) {
+        ValueAllocator::getInstance().deallocate(heapData(), heapSize(), heapAllocation());
+    }
+    std::memset(storage_, 0, sizeof(storage_));
+}
+
+std::string_view RecordValue::view() const noexcept
+{
+    if (isInline()) {
+        return std::string_view(storage_, tag());
+    }
+    if (hasHeapBuffer()) {
+        return std::string_view(heapData(), heapSize());
+    }
+    return std::string_view();
+}
+
+std::optional<ValueLocation> RecordValue::location() const noexcept
+{
+    if (tag() != VALUE_LOG_TAG) {
+        return std::nullopt;
+    }
+    ValueLocation location;
+    std::memcpy(&location.segment, storage_, sizeof(location.segment));
+    std::memcpy(&location.offset, storage_ + sizeof(uint32_t), sizeof(location.offset));
+    std::memcpy(&location.size, storage_ + 2 * sizeof(uint32_t), sizeof(location.size));
+    return location;
+}
+
+bool RecordValue::isInline() const noexcept
+{
+    return tag() != HEAP_TAG && tag() != VALUE_LOG_TAG;
+}
+
+char *RecordValue::heapData() const noexcept
+{
+    char *data = nullptr;
+    std::memcpy(&data, storage_, sizeof(data));
+    return data;
+}
+
+uint32_t RecordValue::heapSize() const noexcept
+{
+    uint32_t size = 0;
+    std::memcpy(&size, storage_ + sizeof(char *), sizeof(size));
+    return size;
+}
+
+ValueAllocation RecordValue::heapAllocation() const noexcept
+{
+    return static_cast<ValueAllocation>(storage_[ALLOCATION_OFFSET]);
+}
+
+RecordTable::RecordTable(const RecordTable &other)
+    : control_(other.capacity_ > 0 ? std::make_unique<int8_t[]>(other.capacity_) : nullptr)
+    , slots_(other.capacity_ > 0 ? std::make_unique<Slot[]>(other.capacity_) : nullptr)
+    , capacity_(other.capacity_)
+    , size_(other.size_)
+    , growthLeft_(other.growthLeft_)
+{
+    if (capacity_ == 0) {
+        return;
+    }
+    std::memcpy(control_.get(), other.control_.get(), capacity_);
+    for (size_t i = 0; i < capacity_; i++) {
+        if (control_[i] >= 0) {
+            slots_[i] = other.slots_[i];
+        }
+    }
+}
+
+RecordTable &RecordTable::operator=(const RecordTable &other)
+{
+    if (this != &other) {
+        RecordTable copy(other);
+        *this = std::move(copy);
+    }
+    return *this;
+}
+
+RecordTable::RecordTable(RecordTable &&other) noexcept
+    : control_(std::move(other.control_))
+    , slots_(std::move(other.slots_))
+    , capacity_(std::exchange(other.capacity_, 0))
+    , size_(std::exchange(other.size_, 0))
+    , growthLeft_(std::exchange(other.growthLeft_, 0))
+{
+}
+
+RecordTable &RecordTable::operator=(RecordTable &&other) noexcept
+{
+    if (this != &other) {
+        control_ = std::move(other.control_);
+        slots_ = std::move(other.slots_);
+        capacity_ = std::exchange(other.capacity_, 0);
+        size_ = std::exchange(other.size_, 0);
+        growthLeft_ = std::exchange(other.growthLeft_, 0);
+    }
+    return *this;
+}
+
+const RecordValue *RecordTable::find(const Uuid &key) const noexcept
+{
+    const auto index = findIndex(key, key.hash());
+    return index < capacity_ ? &slots_[index].value : nullptr;
+}
+
+RecordValue *RecordTable::find(const Uuid &key) noexcept
+{
+    const auto index = findIndex(key, key.hash());
+    return index < capacity_ ? &slots_[index].value : nullptr;
+}
+
+bool RecordTable::insertOrAssign(const Uuid &key, std::string_view value)
+{
+    const auto [slot, inserted] = emplace(key);
+    slot->assign(value);
+    return inserted;
+}
+
+std::pair<RecordValue *, bool> RecordTable::emplace(const Uuid &key)
+{
+    const auto hash = key.hash();
+    const auto existing = findIndex(key, hash);
+    if (existing < capacity_) {
+        return { &slots_[existing].value, false };
+    }
+
+    auto index = capacity_ > 0 ? findFreeIndex(hash) : capacity_;
+    // Пустую ячейку можно занять только при запасе, а удалённую - всегда
+    if (index == capacity_ || (control_[index] == CONTROL_EMPTY && growthLeft_ == 0)) {
+        // Если большая часть занятых ячеек - удалённые записи, то достаточно перестроения без
+        // увеличения таблицы
+        auto newCapacity = MIN_CAPACITY;
+        if (capacity_ > 0) {
+            newCapacity = size_ + 1 <= maxLoad(capacity_) / 2 ? capacity_ : capacity_ * 2;
+        }
+        rehash(newCapacity);
+        index = findFreeIndex(hash);
+    }
+
+    if (control_[index] == CONTROL_EMPTY) {
+        growthLeft_--;
+    }
+    control_[index] = controlHash(hash);
+    slots_[index].key = key;
+    size_++;
+    return { &slots_[index].value, true };
+}
+
+bool RecordTable::erase(const Uuid &key) noexcept
+{
+    const auto index = findIndex(key, key.hash());
+    if (index == capacity_) {
+        return false;
+    }
+
+    slots_[index].value.clear();
+    size_--;
+
+    // Поиск останавливается на группе с пустой ячейкой. Если в группе уже есть пустая ячейка, то
+    // она никогда не была заполнена целиком и ни один ключ не был вытеснен из неё дальше, поэтому
+    // ячейку можно сделать пустой. Иначе ячейка помечается удалённой, чтобы не прервать поиск
+    const auto *group = &control_[index - index % GROUP_WIDTH];
+    if (matchControl(group, CONTROL_EMPTY) != 0) {
+        control_[index] = CONTROL_EMPTY;
+        growthLeft_++;
+    }
+    else {
+        control_[index] = CONTROL_DELETED;
+    }
+    return true;
+}
+
+void RecordTable::reserve(size_t count)
+{
+    size_t newCapacity = MIN_CAPACITY;
+    while (maxLoad(newCapacity) < count) {
+        newCapacity *= 2;
+    }
+    if (newCapacity > capacity_) {
+        rehash(newCapacity);
+    }
+}
+
+void RecordTable::clear() noexcept
+{
+    control_.reset();
+    slots_.reset();
+    capacity_ = 0;
+    size_ = 0;
+    growthLeft_ = 0;
+}
+
+size_t RecordTable::findIndex(const Uuid &key, uint64_t hash) const noexcept
+{
+    if (capacity_ == 0) {
+        return capacity_;
+    }
+
+    // Группы просматриваются с треугольным шагом (1, 2, 3, ...), что при количестве групп,
+    // равном степени двойки, обходит каждую группу ровно один раз
+    const auto groupMask = capacity_ / GROUP_WIDTH - 1;
+    const auto controlByte = controlHash(hash);
+    auto group = static_cast<size_t>(hash >> 7) & groupMask;
+    for (size_t probe = 1; probe <= groupMask + 1; probe++) {
+        const auto *control = &control_[group * GROUP_WIDTH];
+        for (auto mask = matchControl(control, controlByte); mask != 0; mask &= mask - 1) {
+            const auto index = group * GROUP_WIDTH + lowestBit(mask);
+            if (slots_[index].key == key) {
+                return index;
+            }
+        }
+        if (matchControl(control, CONTROL_EMPTY) != 0) {
+            return capacity_;
+        }
+        group = (group + probe) & groupMask;
+    }
+    return capacity_;
+}
+
+size_t RecordTable::findFreeIndex(uint64_t hash) const noexcept
+{
+    const auto groupMask = capacity_ / GROUP_WIDTH - 1;
+    auto group = static_cast<size_t>(hash >> 7) & groupMask;
+    for (size_t probe = 1; probe <= groupMask + 1; probe++) {
+        const auto mask = matchFree(&control_[group * GROUP_WIDTH]);
+        if (mask != 0) {
+            return group * GROUP_WIDTH + lowestBit(mask);
+        }
+        group = (group + probe) & groupMask;
+    }
+    return capacity_;
+}
+
+void RecordTable::rehash(size_t newCapacity)
+{
+    assert(newCapacity >= MIN_CAPACITY && maxLoad(newCapacity) >= size_);
+
+    auto oldControl = std::move(control_);
+    auto oldSlots = std::move(slots_);
+    const auto oldCapacity = capacity_;
+
+    control_ = std::make_unique<int8_t[]>(newCapacity);
+    std::memset(control_.get(), CONTROL_EMPTY, newCapacity);
+    slots_ = std::make_unique<Slot[]>(newCapacity);
+    capacity_ = newCapacity;
+    growthLeft_ = maxLoad(newCapacity) - size_;
+
+    // Перемещаем записи без копирования значений
+    for (size_t i = 0; i < oldCapacity; i++) {
+        if (oldControl[i] < 0) {
+            continue;
+        }
+        const auto hash = oldSlots[i].key.hash();
+        const auto index = findFreeIndex(hash);
+        control_[index] = controlHash(hash);
+        slots_[index].key = oldSlots[i].key;
+        slots_[index].value = std::move(oldSlots[i].value);
+    }
+}
+} // namespace octet
@@ -0,0 +1,250 @@
+#include "storage/replication.hpp"
+
+#include <charconv>
+#include <string_view>
+
+#include "storage/journal_manager.hpp"
+#include "storage/storage_manager.hpp"
+#include "utils/file_utils.hpp"
+#include "logger.hpp"
+
+namespace octet {
+ReplicationSource::ReplicationSource(StorageManager &storage)
+    : storage_(storage)
+{
+}
+
+ReplicationSource::~ReplicationSource() = default;
+
+bool ReplicationSource::read(const std::optional<ReplicationPosition> &from, size_t maxBytes,
+                             ReplicationChunk &chunk)
+{
+    chunk = ReplicationChunk();
+    if (!from.has_value()) {
+        return resync(chunk);
+    }
+
+    if (from->part.has_value()) {
+        const auto partCount = StorageManager::getExportPartCount();
+        if (*from->part >= partCount) {
+            LOG_WARNING << "Недопустимый номер части состояния хранилища: " << *from->part;
+            return resync(chunk);
+        }
+        storage_.exportPart(*from->part, chunk.records);
+        chunk.next = *from;
+        if (*from->part + 1 < partCount) {
+            chunk.next.part = *from->part + 1;
+        }
+        else {
+            chunk.next.part.reset();
+        }
+        return true;
+    }
+
+    // Пока реплика запрашивает порции по очереди, журнал только дочитывается
+    const auto append = [this](const JournalEntryView &entry) {
+        JournalEntry::serializeView(entry, pending_);
+        return true;
+    };
+    if (reader_ == nullptr || position_ != from || !reader_->poll(append)) {
+        if (!openJournal(*from)) {
+            LOG_WARNING << "Положение реплики не найдено в журнале, состояние хранилища будет "
+                           "передано заново, контрольная точка: "
+                        << from->checkpointId;
+            return resync(chunk);
+        }
+    }
+    takePending(maxBytes, chunk);
+    return true;
+}
+
+bool ReplicationSource::resync(ReplicationChunk &chunk)
+{
+    reader_.reset();
+    position_.reset();
+    pending_.clear();
+
+    // Без контрольной точки операции не от чего отсчитывать, поэтому она создаётся снапшотом
+    auto checkpointId = storage_.getLastCheckpointId();
+    if (!checkpointId.has_value()) {
+        if (!storage_.createSnapshot()) {
+            LOG_ERROR << "Не удалось создать контрольную точку для передачи состояния хранилища";
+            return false;
+        }
+        checkpointId = storage_.getLastCheckpointId();
+        if (!checkpointId.has_value()) {
+            return false;
+        }
+    }
+
+    // Положение в журнале запоминается до чтения частей, поэтому операции, выполненные во время
+    // передачи, будут прочитаны из журнала после неё
+    reader_ = std::make_unique<JournalReader>(storage_.getJournalPath(), true);
+    if (!reader_->open(*checkpointId, [](const JournalEntryView &) { return true; })) {
+        LOG_ERROR << "Не удалось прочитать журнал от контрольной точки: " << *checkpointId;
+        reader_.reset();
+        return false;
+    }
+    ReplicationPosition start{ *reader_->getCheckpointId(), reader_->getOperationCount(),
+                               std::nullopt };
+    position_ = start;
+
+    LOG_INFO << "Передача состояния хранилища реплике, контрольная точка: " << start.checkpointId
+             << ", операций после неё: " << start.offset;
+    start.part = 0;
+    if (!read(start, 0, chunk)) {
+        return false;
+    }
+    chunk.reset = true;
+    return true;
+}
+
+bool ReplicationSource::openJournal(const ReplicationPosition &from)
+{
+    pending_.clear();
+    position_.reset();
+    reader_ = std::make_unique<JournalReader>(storage_.getJournalPath(), true);
+
+    // Операции, уже полученные репликой, пропускаются. Если контрольной точки реплики уже нет в
+    // журнале, читатель продолжает с точки, записанной сразу после полученных операций
+    const auto opened = reader_->open(
+        from.checkpointId,
+        [this](const JournalEntryView &entry) {
+            JournalEntry::serializeView(entry, pending_);
+            return true;
+        },
+        from.offset);
+    if (!opened) {
+        reader_.reset();
+        pending_.clear();
+        return false;
+    }
+    position_ = from;
+    return true;
+}
+
+void ReplicationSource::takePending(size_t maxBytes, ReplicationChunk &chunk)
+{
+    // Порция заканчивается на границе записи, а пройденная контрольная точка становится началом
+    // отсчёта положения: пока реплика не отстала от неё, уплотнение журнала по этой точке не
+    // требует передавать состояние заново
+    std::string_view rest(pending_);
+    size_t size = 0;
+    while (!rest.empty()) {
+        size_t recordSize = 0;
+        const auto entry = JournalEntry::deserializeView(rest, &recordSize);
+        if (!entry.has_value() || (size > 0 && size + recordSize > maxBytes)) {
+            break;
+        }
+        if (entry->type == OperationType::CHECKPOINT) {
+            position_->checkpointId = std::string(entry->uuid);
+            position_->offset = 0;
+        }
+        else {
+            position_->offset++;
+        }
+        rest.remove_prefix(recordSize);
+        size += recordSize;
+    }
+
+    chunk.records = pending_.substr(0, size);
+    pending_.erase(0, size);
+    chunk.next = *position_;
+}
+
+ReplicationTarget::ReplicationTarget(StorageManager &storage, const std::filesystem::path &dataDir)
+    : storage_(storage)
+    , positionPath_(dataDir / REPLICATION_POSITION_FILE_NAME)
+{
+    std::string content;
+    if (!utils::checkIfFileExists(positionPath_, false)
+        || !utils::safeFileRead(positionPath_, content) || content.empty()) {
+        LOG_INFO << "Положение реплики не сохранено, состояние хранилища будет получено заново";
+        return;
+    }
+
+    // Положение хранится двумя строками: контрольная точка и количество операций после неё
+    const auto separator = content.find('\n');
+    ReplicationPosition position;
+    if (separator != std::string::npos && separator > 0) {
+        position.checkpointId = content.substr(0, separator);
+        const auto *begin = content.data() + separator + 1;
+        const auto *end = content.data() + content.size();
+        const auto [next, ec] = std::from_chars(begin, end, position.offset);
+        if (ec == std::errc() && next != begin && (next == end || *next == '\n')) {
+            LOG_INFO << "Загружено положение реплики, контрольная точка: "
+                     << position.checkpointId << ", операций после неё: " << position.offset;
+            position_ = std::move(position);
+            return;
+        }
+    }
+    LOG_WARNING << "Повреждён файл положения реплики, состояние хранилища будет получено "
+                   "заново: "
+                << positionPath_.string();
+}
+
+const std::optional<ReplicationPosition> &ReplicationTarget::getPosition() const
+{
+    return position_;
+}
+
+bool ReplicationTarget::apply(const ReplicationChunk &chunk)
+{
+    const auto transferring
+        = chunk.reset || (position_.has_value() && position_->part.has_value());
+    if (chunk.reset) {
+        LOG_INFO << "Получение состояния хранилища от источника, контрольная точка: "
+                 << chunk.next.checkpointId;
+        // Пустое положение сохраняется до приёма частей, чтобы прерванная передача началась
+        // заново. Пока части принимаются, реплика продолжает отвечать прежним содержимым
+        position_.reset();
+        if (!savePosition()) {
+            LOG_ERROR << "Не удалось подготовить хранилище реплики к получению состояния";
+            return false;
+        }
+        storage_.beginStaging();
+    }
+    else if (!position_.has_value()) {
+        LOG_ERROR << "Получена порция репликации без начала передачи состояния хранилища";
+        return false;
+    }
+
+    if (transferring) {
+        if (!chunk.records.empty() && !storage_.stageReplicated(chunk.records)) {
+            return false;
+        }
+        if (!chunk.next.part.has_value()) {
+            // Принятое состояние заменяет содержимое хранилища и сохраняется полным снапшотом
+            if (!storage_.commitStaged()) {
+                return false;
+            }
+            LOG_INFO << "Состояние хранилища получено, записей: " << storage_.getEntriesCount();
+        }
+    }
+    else if (!chunk.records.empty() && !storage_.applyReplicated(chunk.records)) {
+        return false;
+    }
+
+    const auto changed = position_ != chunk.next;
+    position_ = chunk.next;
+    // Пустое положение уже сохранено перед передачей состояния
+    if (!changed || position_->part.has_value()) {
+        return true;
+    }
+    return savePosition();
+}
+
+bool ReplicationTarget::savePosition() const
+{
+    // Во время передачи состояния сохраняется пустое положение
+    std::string content;
+    if (position_.has_value() && !position_->part.has_value()) {
+        content = position_->checkpointId + '\n' + std::to_string(position_->offset) + '\n';
+    }
+    if (!utils::atomicFileWrite(positionPath_, content)) {
+        LOG_ERROR << "Не удалось сохранить положение реплики: " << positionPath_.string();
+        return false;
+    }
+    return true;
+}
+} // namespace octet
@@ -0,0 +1,293 @@
+#include "storage/snapshot_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+#include "utils/crc32c.hpp"
+#include "logger.hpp"
+
+namespace octet {
+std::filesystem::path deltaSnapshotPath(const std::filesystem::path &snapshotPath, uint64_t number)
+{
+    auto suffix = std::to_string(number);
+    if (suffix.size() < DELTA_SNAPSHOT_NUMBER_WIDTH) {
+        suffix.insert(0, DELTA_SNAPSHOT_NUMBER_WIDTH - suffix.size(), '0');
+    }
+    return std::filesystem::path(snapshotPath.string() + DELTA_SNAPSHOT_SUFFIX + suffix);
+}
+
+std::vector<std::pair<uint64_t, std::filesystem::path>>
+listDeltaSnapshots(const std::filesystem::path &snapshotPath)
+{
+    std::vector<std::pair<uint64_t, std::filesystem::path>> deltas;
+    const auto prefix = snapshotPath.filename().string() + DELTA_SNAPSHOT_SUFFIX;
+
+    std::error_code ec;
+    for (const auto &item : std::filesystem::directory_iterator(snapshotPath.parent_path(), ec)) {
+        const auto name = item.path().filename().string();
+        if (name.size() < prefix.size() + DELTA_SNAPSHOT_NUMBER_WIDTH
+            || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        // Временные файлы записи снапшотов имеют нечисловые суффиксы
+        const auto suffix = name.substr(prefix.size());
+        if (suffix.size() > std::numeric_limits<uint64_t>::digits10
+            || !std::all_of(suffix.begin(), suffix.end(),
+                            [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        deltas.emplace_back(std::stoull(suffix), item.path());
+    }
+    if (ec) {
+        LOG_ERROR << "Не удалось получить список разностных снапшотов: " << snapshotPath.string()
+                  << ", код ошибки: " << ec.value() << ", сообщение: " << ec.message();
+    }
+
+    std::sort(deltas.begin(), deltas.end());
+    return deltas;
+}
+
+bool isVersionedSnapshot(std::string_view content)
+{
+    return content.substr(0, SNAPSHOT_MAGIC_SIZE) == SNAPSHOT_MAGIC;
+}
+
+bool parseSnapshotLayout(std::string_view content, SnapshotLayout &layout)
+{
+    using utils::loadLittleEndian;
+
+    const auto *data = content.data();
+    const auto fileSize = content.size();
+    if (fileSize < SNAPSHOT_HEADER_FIXED_SIZE + sizeof(uint32_t) + SNAPSHOT_FOOTER_SIZE) {
+        LOG_ERROR << "Файл снапшота слишком мал: " << fileSize << " байт";
+        return false;
+    }
+
+    // Заголовок
+    const auto version = loadLittleEndian<uint32_t>(data + SNAPSHOT_MAGIC_SIZE);
+    if (version != SNAPSHOT_FORMAT_VERSION) {
+        LOG_ERROR << "Неподдерживаемая версия формата снапшота: " << version;
+        return false;
+    }
+    const auto flags = loadLittleEndian<uint32_t>(data + SNAPSHOT_MAGIC_SIZE + sizeof(uint32_t));
+    const bool delta = (flags & SNAPSHOT_FLAG_DELTA) != 0;
+    auto available
+        = fileSize - SNAPSHOT_HEADER_FIXED_SIZE - sizeof(uint32_t) - SNAPSHOT_FOOTER_SIZE;
+    const auto idSize
+        = loadLittleEndian<uint32_t>(data + SNAPSHOT_MAGIC_SIZE + 2 * sizeof(uint32_t));
+    if (idSize > available) {
+        LOG_ERROR << "Некорректная длина контрольной точки в заголовке снапшота: " << idSize;
+        return false;
+    }
+    available -= idSize;
+    auto headerSize = SNAPSHOT_HEADER_FIXED_SIZE + idSize;
+    size_t baseIdSize = 0;
+    if (delta) {
+        // Для разностного снапшота следом записана контрольная точка предыдущего снапшота
+        if (available < sizeof(uint32_t)
+            || (baseIdSize = loadLittleEndian<uint32_t>(data + headerSize))
+                   > available - sizeof(uint32_t)) {
+            LOG_ERROR << "Некорректная длина предыдущей контрольной точки в заголовке снапшота";
+            return false;
+        }
+        headerSize += sizeof(uint32_t) + baseIdSize;
+    }
+    if (utils::crc32c(data, headerSize) != loadLittleEndian<uint32_t>(data + headerSize)) {
+        LOG_ERROR << "Контрольная сумма заголовка снапшота не совпадает";
+        return false;
+    }
+    layout.flags = flags;
+    layout.checkpointId = content.substr(SNAPSHOT_HEADER_FIXED_SIZE, idSize);
+    layout.baseCheckpointId = delta ? content.substr(headerSize - baseIdSize, baseIdSize)
+                                    : std::string_view();
+    const uint64_t dataStart = headerSize + sizeof(uint32_t);
+
+    // Итоговый блок
+    const auto *footer = data + fileSize - SNAPSHOT_FOOTER_SIZE;
+    if (loadLittleEndian<uint32_t>(footer + SNAPSHOT_FOOTER_SIZE - sizeof(uint32_t))
+            != SNAPSHOT_FOOTER_MAGIC
+        || utils::crc32c(footer, SNAPSHOT_FOOTER_CRC_OFFSET)
+               != loadLittleEndian<uint32_t>(footer + SNAPSHOT_FOOTER_CRC_OFFSET)) {
+        LOG_ERROR << "Итоговый блок снапшота повреждён или файл записан не полностью";
+        return false;
+    }
+    const auto indexOffset = loadLittleEndian<uint64_t>(footer);
+    const auto entryCount = loadLittleEndian<uint64_t>(footer + sizeof(uint64_t));
+    const auto blockCount = loadLittleEndian<uint32_t>(footer + 2 * sizeof(uint64_t));
+    const auto indexCrc
+        = loadLittleEndian<uint32_t>(footer + 2 * sizeof(uint64_t) + sizeof(uint32_t));
+
+    // Индекс блоков
+    const auto minEntrySize = (flags & (SNAPSHOT_FLAG_DELTA | SNAPSHOT_FLAG_VALUE_LOG)) != 0
+                                  ? SNAPSHOT_TAGGED_ENTRY_MIN_SIZE
+                                  : SNAPSHOT_ENTRY_HEADER_SIZE;
+    const uint64_t indexEnd = fileSize - SNAPSHOT_FOOTER_SIZE;
+    if (indexOffset < dataStart || indexOffset > indexEnd
+        || indexEnd - indexOffset != static_cast<uint64_t>(blockCount) * SNAPSHOT_INDEX_ENTRY_SIZE
+        || entryCount > (indexOffset - dataStart) / minEntrySize) {
+        LOG_ERROR << "Некорректное описание индекса блоков снапшота";
+        return false;
+    }
+    if (utils::crc32c(data + indexOffset, indexEnd - indexOffset) != indexCrc) {
+        LOG_ERROR << "Контрольная сумма индекса блоков снапшота не совпадает";
+        return false;
+    }
+
+    // Блоки должны следовать друг за другом без промежутков и занимать всю область данных
+    layout.blocks.clear();
+    layout.blocks.reserve(blockCount);
+    uint64_t expectedOffset = dataStart;
+    uint64_t indexedEntries = 0;
+    for (uint32_t i = 0; i < blockCount; i++) {
+        const auto *entry = data + indexOffset + i * SNAPSHOT_INDEX_ENTRY_SIZE;
+        SnapshotBlockInfo block;
+        block.offset = loadLittleEndian<uint64_t>(entry);
+        block.size = loadLittleEndian<uint64_t>(entry + sizeof(uint64_t));
+        block.entryCount = loadLittleEndian<uint32_t>(entry + 2 * sizeof(uint64_t));
+        block.crc = loadLittleEndian<uint32_t>(entry + 2 * sizeof(uint64_t) + sizeof(uint32_t));
+        if (block.offset != expectedOffset || block.size > indexOffset - block.offset) {
+            LOG_ERROR << "Некорректное описание блока снапшота " << i;
+            return false;
+        }
+        expectedOffset += block.size;
+        indexedEntries += block.entryCount;
+        layout.blocks.push_back(block);
+    }
+    if (expectedOffset != indexOffset || indexedEntries != entryCount) {
+        LOG_ERROR << "Индекс блоков снапшота не соответствует области данных";
+        return false;
+    }
+    layout.entryCount = entryCount;
+    return true;
+}
+
+
+bool checkSnapshotLayout(const SnapshotLayout &layout,
+                         const std::optional<std::string> &baseCheckpointId,
+                         CompressionCodec &codec)
+{
+    if ((layout.flags & ~(SNAPSHOT_CODEC_MASK | SNAPSHOT_FLAG_DELTA | SNAPSHOT_FLAG_VALUE_LOG))
+        != 0) {
+        LOG_ERROR << "Неподдерживаемые флаги формата снапшота: " << layout.flags;
+        return false;
+    }
+    const bool delta = (layout.flags & SNAPSHOT_FLAG_DELTA) != 0;
+    if (delta != baseCheckpointId.has_value()) {
+        LOG_ERROR << (delta ? "Вместо базового снапшота записан разностный"
+                            : "Вместо разностного снапшота записан полный");
+        return false;
+    }
+    if (delta && layout.baseCheckpointId != *baseCheckpointId) {
+        LOG_ERROR << "Разностный снапшот продолжает другую цепочку, предыдущая контрольная точка: "
+                  << layout.baseCheckpointId << ", ожидалась: " << *baseCheckpointId;
+        return false;
+    }
+    codec = static_cast<CompressionCodec>(layout.flags & SNAPSHOT_CODEC_MASK);
+    if (!JournalManager::isCompressionCodecSupported(codec)) {
+        LOG_ERROR << "Снапшот сжат алгоритмом, который не поддерживается сборкой: "
+                  << utils::compressionCodecName(codec) << " (" << layout.flags << ")";
+        return false;
+    }
+    return true;
+}
+
+bool readSnapshotBlock(std::string_view content, const SnapshotBlockInfo &block,
+                       CompressionCodec codec, std::string &decompressed, std::string_view &data)
+{
+    data = content.substr(block.offset, block.size);
+    if (utils::crc32c(data.data(), data.size()) != block.crc) {
+        return false;
+    }
+    if (codec == CompressionCodec::NONE) {
+        return true;
+    }
+    // Сжатый блок начинается с размера исходного блока
+    if (data.size() < sizeof(uint64_t)
+        || !utils::decompressBlock(codec, data.substr(sizeof(uint64_t)),
+                                   utils::loadLittleEndian<uint64_t>(data.data()), decompressed)) {
+        return false;
+    }
+    data = decompressed;
+    return true;
+}
+
+std::optional<std::unordered_map<std::string, std::string>>
+deserializeLegacySnapshot(std::string_view buf, std::optional<std::string> &checkpointId)
+{
+    // Указатели на начало и конец буфера
+    const char *ptr = buf.data();
+    const char *end = ptr + buf.size();
+
+    // Проверка недостаточности места для считывания размера
+    auto sizeInvalid = [&] { return ptr + sizeof(uint32_t) > end; };
+    // Проверка недостаточности места для считывания строки
+    auto strSizeInvalid = [&](uint32_t len) { return len > static_cast<size_t>(end - ptr); };
+    // Чтение размера
+    auto readSize = [&] {
+        uint32_t size;
+        std::memcpy(&size, ptr, sizeof(size));
+        ptr += sizeof(uint32_t);
+        return size;
+    };
+
+    // Удостоверяемся, что достаточно байт для чтения count
+    if (sizeInvalid()) {
+        return std::nullopt;
+    }
+    // Читаем count
+    const auto count = readSize();
+
+    // Каждая пара занимает не меньше 8 байт, поэтому большее количество означает повреждение
+    // (и не должно приводить к резервированию огромного количества бакетов)
+    if (count > static_cast<size_t>(end - ptr) / (2 * sizeof(uint32_t))) {
+        return std::nullopt;
+    }
+
+    // Создаём хранилище и сразу резервируем нужное количество бакетов
+    std::unordered_map<std::string, std::string> map;
+    map.reserve(count);
+
+    // Читаем длину и данные ключа/значения
+    for (uint32_t i = 0; i < count; i++) {
+        // Считываем ключ
+        if (sizeInvalid()) {
+            return std::nullopt;
+        }
+        const auto klen = readSize();
+        if (strSizeInvalid(klen)) {
+            return std::nullopt;
+        }
+        std::string key(ptr, klen);
+        ptr += klen;
+
+        // Считываем значение
+        if (sizeInvalid()) {
+            return std::nullopt;
+        }
+        const auto vlen = readSize();
+        if (strSizeInvalid(vlen)) {
+            return std::nullopt;
+        }
+        std::string value(ptr, vlen);
+        ptr += vlen;
+
+        // Вставляем пару в хранилище
+        map.emplace(std::move(key), std::move(value));
+    }
+
+    // Читаем контрольную точку, если она записана
+    checkpointId = std::nullopt;
+    const auto tailSize = static_cast<size_t>(end - ptr);
+    if (tailSize >= 2 * sizeof(uint32_t)) {
+        uint32_t idSize, magic;
+        std::memcpy(&idSize, end - 2 * sizeof(uint32_t), sizeof(idSize));
+        std::memcpy(&magic, end - sizeof(uint32_t), sizeof(magic));
+        if (magic == SNAPSHOT_CHECKPOINT_MAGIC && idSize == tailSize - 2 * sizeof(uint32_t)) {
+            checkpointId = std::string(ptr, idSize);
+        }
+    }
+
+    return map;
+}
+} // namespace octet
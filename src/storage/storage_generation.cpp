@@ -0,0 +1,121 @@
+#include "storage/storage_generation.hpp"
+
+#include <atomic>
+
+#if defined(OCTET_PLATFORM_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils/compiler.hpp"
+#include "utils/file_utils.hpp"
+#include "logger.hpp"
+
+namespace octet {
+/**
+ * @struct StorageGeneration::Counters
+ * @brief Счётчики в файле: каждый на своей кэш-линии, чтобы запись в журнал не сбрасывала у
+ * читателей линию со счётчиком снапшотов
+ */
+struct StorageGeneration::Counters {
+    alignas(64) std::atomic<uint64_t> journal;
+    alignas(64) std::atomic<uint64_t> snapshot;
+};
+
+// Счётчики изменяются через разделяемую память несколькими процессами, поэтому атомарные
+// операции не должны использовать внутренние блокировки процесса
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "StorageGeneration requires lock-free 64-bit atomics");
+
+StorageGeneration::StorageGeneration(const std::filesystem::path &filePath)
+{
+    LOG_DEBUG << "Отображение счётчиков поколений хранилища: " << filePath.string();
+
+#if defined(OCTET_PLATFORM_UNIX)
+    // Счётчики создаются раньше остальных файлов хранилища, поэтому готовим и директорию
+    utils::checkIfFileExists(filePath);
+
+    // Процессы без права записи в директорию данных отображают уже созданный файл для чтения
+    auto fd = open(filePath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    writable_ = fd != -1;
+    if (fd == -1) {
+        fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    }
+    if (fd == -1) {
+        LOG_WARNING << "Не удалось открыть файл счётчиков поколений хранилища: "
+                    << filePath.string() << ", ошибка: " << octet::errnoToString(errno);
+        writable_ = false;
+        return;
+    }
+
+    // Новый файл дополняется нулями до размера счётчиков, а его одновременное расширение
+    // несколькими процессами безопасно, так как все расширяют его до одного размера
+    struct stat fileStat;
+    bool ready = fstat(fd, &fileStat) == 0;
+    if (ready && static_cast<size_t>(fileStat.st_size) < sizeof(Counters)) {
+        ready = writable_ && ftruncate(fd, sizeof(Counters)) == 0;
+    }
+    if (!ready) {
+        LOG_WARNING << "Файл счётчиков поколений хранилища недоступен: " << filePath.string()
+                    << ", ошибка: " << octet::errnoToString(errno);
+        close(fd);
+        writable_ = false;
+        return;
+    }
+
+    void *address = mmap(nullptr, sizeof(Counters), writable_ ? PROT_READ | PROT_WRITE : PROT_READ,
+                         MAP_SHARED, fd, 0);
+    // Отображение остается действительным и после закрытия дескриптора
+    close(fd);
+    if (address == MAP_FAILED) {
+        LOG_WARNING << "Не удалось отобразить счётчики поколений хранилища: "
+                    << filePath.string() << ", ошибка: " << octet::errnoToString(errno);
+        writable_ = false;
+        return;
+    }
+    counters_ = static_cast<Counters *>(address);
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+StorageGeneration::~StorageGeneration()
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    if (counters_ != nullptr) {
+        munmap(counters_, sizeof(Counters));
+    }
+#endif
+}
+
+bool StorageGeneration::isMapped() const
+{
+    return counters_ != nullptr;
+}
+
+uint64_t StorageGeneration::journal() const
+{
+    return counters_ != nullptr ? counters_->journal.load(std::memory_order_acquire) : 0;
+}
+
+uint64_t StorageGeneration::snapshot() const
+{
+    return counters_ != nullptr ? counters_->snapshot.load(std::memory_order_acquire) : 0;
+}
+
+void StorageGeneration::advanceJournal()
+{
+    if (writable_) {
+        counters_->journal.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void StorageGeneration::advanceSnapshot()
+{
+    if (writable_) {
+        counters_->snapshot.fetch_add(1, std::memory_order_release);
+    }
+}
+} // namespace octet
@@ -1,118 +1,177 @@
 #include "storage/storage_manager.hpp"
 
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <tuple>
+
+#if defined(OCTET_PLATFORM_UNIX)
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "storage/snapshot_format.hpp"
+#include "utils/byte_order.hpp"
+#include "utils/compiler.hpp"
+#include "utils/compression.hpp"
+#include "utils/crc32c.hpp"
 #include "utils/file_utils.hpp"
+#include "utils/io_ring.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/parallel.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
 
 namespace {
-static constexpr char SNAPSHOT_FILE_NAME[] = "octet-data.snapshot";
-static constexpr char JOURNAL_FILE_NAME[] = "octet-operations.journal";
-
-// Быстрое преобразование хранилища в строку
-std::string serializeMap(const std::unordered_map<std::string, std::string> &map)
-{
-    // Узнаём число пар в хранилище и приводим к uint32_t
-    const auto count = static_cast<uint32_t>(map.size());
-
-    // Считаем общий размер буфера:
-    // + 4 байта на count
-    // + по 4 байта на длину для каждой пары
-    // + длина самих данных
-    size_t totalSize = sizeof(count);
-    for (auto &[k, v] : map) {
-        totalSize += sizeof(uint32_t) + k.size() // длина ключа + ключ
-                     + sizeof(uint32_t) + v.size(); // длина значения + значение
-    }
-
-    // Резервируем память в итоговой строке, чтобы не было повторных аллокаций
-    std::string buf;
-    buf.reserve(totalSize);
-
-    // Лямбда для добавления 32‑битного целого в buf
-    // TODO: данные записываются в представлении little‑endian, но может для поддержания
-    // кроссплатформенности лучше явно использовать big-endian представление
-    auto u32Append = [&](uint32_t x) { buf.append(reinterpret_cast<const char *>(&x), sizeof(x)); };
-
-    // Записываем сначала количество элементов
-    u32Append(count);
-    // Затем уже записываем сами данные хранилища
-    for (auto &[k, v] : map) {
-        u32Append(static_cast<uint32_t>(k.size())); // длина ключа
-        buf.append(k.data(), k.size()); // байты ключа
-        u32Append(static_cast<uint32_t>(v.size())); // длина значения
-        buf.append(v.data(), v.size()); // байты значения
-    }
-
-    return buf;
-}
-
-// Быстрое преобразование строки в хранилище
-std::optional<std::unordered_map<std::string, std::string>> deserializeMap(const std::string &buf)
-{
-    // Указатели на начало и конец буфера
-    const char *ptr = buf.data();
-    const char *end = ptr + buf.size();
-
-    // Проверка недостаточности места для считывания размера
-    auto sizeInvalid = [&] { return ptr + sizeof(uint32_t) > end; };
-    // Проверка недостаточности места для считывания строки
-    auto strSizeInvalid = [&](uint32_t len) { return ptr + len > end; };
-    // Чтение размера
-    auto readSize = [&] {
-        uint32_t size = *reinterpret_cast<const uint32_t *>(ptr);
-        ptr += sizeof(uint32_t);
-        return size;
-    };
+// Количество буферов io_uring для записи снапшота (блоки, записываемые одновременно)
+static constexpr size_t SNAPSHOT_IO_BUFFERS = 4;
+// Количество строк, ключи которых генерируются и распределяются по сегментам одним потоком
+static constexpr size_t IMPORT_BLOCK_SIZE = 64 * 1024;
+
+/**
+ * @struct SnapshotChange
+ * @brief Изменение записи после предыдущего снапшота цепочки
+ */
+struct SnapshotChange {
+    octet::Uuid key; // Ключ записи
+    bool removed; // Удалена ли запись
+    std::string value; // Текущее значение записи (если она не удалена)
+    std::optional<octet::ValueLocation> location; // Положение значения в журнале значений
+};
+
+/**
+ * @brief Сериализует сегменты хранилища в формате полного снапшота v2
+ * @param tables Таблицы сегментов хранилища
+ * @param checkpointId Контрольная точка, соответствующая снапшоту
+ * @param codec Алгоритм сжатия блоков
+ * @param valueLog Могут ли записи ссылаться на журнал значений
+ * @param write Приёмник данных (см. writeSnapshotEntries)
+ * @return true, если все данные переданы приёмнику
+ */
+template <typename Write>
+bool writeSnapshotTo(const std::vector<const octet::RecordTable *> &tables,
+                     const std::string &checkpointId, octet::CompressionCodec codec,
+                     bool valueLog, Write &&write)
+{
+    return writeSnapshotEntries(
+        checkpointId, nullptr, codec, valueLog,
+        [&tables](auto &&emit) {
+            for (const auto *table : tables) {
+                // Для значений в журнале значений сохраняется только их положение
+                table->forEachRecord(
+                    [&emit](const octet::Uuid &key, const octet::RecordValue &value) {
+                        const auto location = value.location();
+                        emit(key, value.view(), false, location ? &*location : nullptr);
+                    });
+            }
+        },
+        std::forward<Write>(write));
+}
 
-    // Удостоверяемся, что достаточно байт для чтения count
-    if (sizeInvalid()) {
-        return std::nullopt;
+#if defined(OCTET_PLATFORM_UNIX)
+/**
+ * @brief Записывает снапшот во временный файл в дочернем процессе.
+ *
+ * После fork многопоточного процесса в дочернем процессе существует только вызвавший поток, а
+ * мьютексы, захваченные другими потоками родителя (логгера, журналов, файловых блокировок),
+ * остаются захваченными навсегда. Поэтому здесь нет логирования и обращений к объектам
+ * хранилища, кроме таблиц сегментов, которые только читаются.
+ *
+ * Дочерний процесс при этом выделяет память: блоки снапшота и их сжатые копии хранятся в
+ * std::string, ZSTD_compress создаёт контекст сжатия в куче, а IoRing выделяет свою очередь.
+ * Это допустимо, потому что malloc поддерживаемых библиотек C (glibc, musl начиная с 1.2.1,
+ * libSystem в macOS) захватывает свои блокировки перед fork и освобождает их в дочернем
+ * процессе, поэтому блокировка распределителя, занятая другим потоком родителя, не остаётся
+ * захваченной. Других блокировок эти библиотеки не используют, а IoRing обращается к ядру
+ * только системными вызовами. На библиотеке C без этой гарантии режим FORK использовать нельзя.
+ * @param tempPath Путь к временному файлу снапшота
+ * @param tables Таблицы сегментов хранилища (образ памяти родителя на момент fork)
+ * @param checkpointId Контрольная точка, соответствующая снапшоту
+ * @param codec Алгоритм сжатия блоков
+ * @param valueLog Могут ли записи ссылаться на журнал значений
+ * @param ioBackend Способ записи на диск
+ * @return true, если снапшот записан и зафиксирован на диске
+ */
+bool writeSnapshotInChild(const char *tempPath,
+                          const std::vector<const octet::RecordTable *> &tables,
+                          const std::string &checkpointId, octet::CompressionCodec codec,
+                          bool valueLog, octet::IoBackend ioBackend)
+{
+    const auto fd = open(tempPath, O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        return false;
     }
-    // Читаем count
-    const auto count = *reinterpret_cast<const uint32_t *>(ptr);
-    ptr += sizeof(uint32_t);
-
-    // Создаём хранилище и сразу резервируем нужное количество бакетов
-    std::unordered_map<std::string, std::string> map;
-    map.reserve(count);
 
-    // Читаем длину и данные ключа/значения
-    for (uint32_t i = 0; i < count; i++) {
-        // Считываем ключ
-        if (sizeInvalid()) {
-            return std::nullopt;
-        }
-        const auto klen = readSize();
-        if (strSizeInvalid(klen)) {
-            return std::nullopt;
+    // Через io_uring блоки записываются ядром из нескольких буферов, пока сериализуются
+    // следующие блоки (очередь не использует блокировок и логирования)
+    std::unique_ptr<octet::utils::IoRing> ring;
+    if (ioBackend == octet::IoBackend::IO_URING) {
+        ring = std::make_unique<octet::utils::IoRing>(SNAPSHOT_IO_BUFFERS);
+        if (!ring->isAvailable()) {
+            ring.reset();
         }
-        std::string key(ptr, klen);
-        ptr += klen;
-
-        // Считываем значение
-        if (sizeInvalid()) {
-            return std::nullopt;
+    }
+    uint64_t offset = 0;
+
+    // Записываем данные целиком, повторяя запись при прерывании и частичной записи. Данные
+    // передаются по блокам, чтобы не удваивать потребление памяти дочерним процессом
+    auto writeAll = [fd, &ring, &offset](const char *data, size_t size) {
+        if (ring) {
+            offset += size;
+            return ring->queueWrite(fd, offset - size, data, size);
         }
-        const auto vlen = readSize();
-        if (strSizeInvalid(vlen)) {
-            return std::nullopt;
+        while (size > 0) {
+            const auto written = write(fd, data, size);
+            if (written < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                return false;
+            }
+            data += written;
+            size -= static_cast<size_t>(written);
         }
-        std::string value(ptr, vlen);
-        ptr += vlen;
-
-        // Вставляем пару в хранилище
-        map.emplace(std::move(key), std::move(value));
-    }
+        return true;
+    };
 
-    return map;
+    auto success = writeSnapshotTo(tables, checkpointId, codec, valueLog, writeAll);
+    success = success && (ring ? ring->drainAndSync(fd, false) : fsync(fd) == 0);
+    // Ядро не должно писать в закрытый дескриптор, поэтому очередь завершается раньше
+    ring.reset();
+    return close(fd) == 0 && success;
 }
 
+/**
+ * @brief Ожидает завершения дочернего процесса, записывающего снапшот
+ * @param pid Идентификатор дочернего процесса
+ * @return true, если процесс успешно записал снапшот
+ */
+bool waitForSnapshotChild(pid_t pid)
+{
+    int status = 0;
+    while (waitpid(pid, &status, 0) == -1) {
+        if (errno != EINTR) {
+            LOG_ERROR << "Ошибка ожидания процесса записи снапшота " << pid
+                      << ", ошибка: " << octet::errnoToString(errno);
+            return false;
+        }
+    }
+    return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+#endif
 } // namespace
 
 namespace octet {
-StorageManager::StorageManager(const std::filesystem::path &dataDir)
+StorageManager::StorageManager(const std::filesystem::path &dataDir, DurabilityPolicy durability,
+                               ValueLogPolicy valueLog)
     : dataDir_(dataDir)
     , snapshotPath_(dataDir / SNAPSHOT_FILE_NAME)
-    , journalManager_(dataDir / JOURNAL_FILE_NAME)
+    , generation_(dataDir / GENERATION_FILE_NAME)
+    , journalManager_(dataDir / JOURNAL_FILE_NAME, durability,
+                      [this] { generation_.advanceJournal(); })
+    , valueLog_(dataDir / VALUE_LOG_FILE_NAME, valueLog)
     , lastSnapshotTime_(std::chrono::steady_clock::now())
 {
     LOG_INFO << "Инициализация StorageManager, директория данных: " << dataDir_.string();
@@ -149,9 +208,9 @@ StorageManager::~StorageManager()
         snapshotThread_.join();
     }
 
-    // Создание финального снапшота перед выходом
+    // Создание финального снапшота перед выходом (разностного, если цепочку ещё не пора объединять)
     LOG_INFO << "Создание финального снапшота перед завершением работы";
-    createSnapshot();
+    createDeltaSnapshot();
 
     LOG_INFO << "StorageManager успешно завершил работу";
 }
@@ -159,12 +218,15 @@ StorageManager::~StorageManager()
 bool StorageManager::loadFromDisk()
 {
     LOG_INFO << "Загрузка данных с диска";
+    ScopedLatency latency(MetricHistogram::LOAD);
 
     // Проверяем наличие файла снапшота
+    // Данные загружаются прямо в сегменты: потоки снапшотов ещё не запущены
     bool snapshotLoaded = false;
+    SnapshotFileInfo snapshot;
     if (utils::isFileReadable(snapshotPath_)) {
         LOG_INFO << "Найден файл снапшота, загружаем: " << snapshotPath_.string();
-        snapshotLoaded = loadSnapshot();
+        snapshotLoaded = loadSnapshot(snapshotPath_, std::nullopt, snapshot);
 
         if (!snapshotLoaded) {
             LOG_WARNING << "Не удалось загрузить снапшот, продолжаем без него";
@@ -174,11 +236,32 @@ bool StorageManager::loadFromDisk()
         LOG_INFO << "Файл снапшота не найден, продолжаем без него";
     }
 
+    // Разностные снапшоты применяются только поверх неповреждённого базового снапшота формата
+    // v2, иначе следующий снапшот будет полным, а изменения восстанавливаются из журнала
+    bool snapshotDamaged = snapshot.damaged;
+    auto snapshotCheckpointId = snapshot.checkpointId;
+    if (snapshotLoaded && snapshot.versioned && !snapshotDamaged) {
+        std::error_code ec;
+        const auto baseSize = std::filesystem::file_size(snapshotPath_, ec);
+        baseBytes_ = ec ? 0 : baseSize;
+        loadDeltaSnapshots(snapshotCheckpointId, snapshotDamaged);
+    }
+
     // Восстанавливаем данные из журнала
     std::optional<std::string> lastCheckpointId = std::nullopt;
-    if (snapshotLoaded) {
-        // Если снапшот загружен, восстанавливаем операции после последней контрольной точки
-        lastCheckpointId = journalManager_.getLastCheckpointId();
+    if (snapshotLoaded && !snapshotDamaged) {
+        // Если снапшот загружен, восстанавливаем операции после его контрольной точки. В журнале
+        // могут быть и более поздние контрольные точки, снапшоты которых не успели записаться.
+        // Для снапшотов без сохраненной контрольной точки используем последнюю точку журнала
+        lastCheckpointId = snapshotCheckpointId.has_value() ? snapshotCheckpointId
+                                                            : journalManager_.getLastCheckpointId();
+    }
+    else if (snapshotDamaged) {
+        // Операции журнала применяются в порядке их выполнения, поэтому после воспроизведения
+        // всего журнала поверх частично загруженного снапшота каждая упомянутая в журнале запись
+        // получает своё последнее состояние. Записи повреждённых блоков восстанавливаются, если
+        // их история ещё сохранилась в журнале
+        LOG_WARNING << "Снапшот загружен частично, воспроизводим журнал полностью";
     }
 
     LOG_INFO << "Восстановление из журнала"
@@ -189,52 +272,407 @@ bool StorageManager::loadFromDisk()
         LOG_WARNING << "Не удалось полностью восстановить данные из журнала";
     }
 
-    LOG_INFO << "Загрузка данных с диска завершена, записей в хранилище: " << dataStore_.size();
-    return true;
+    size_t entriesCount = 0;
+    for (const auto &shard : shards_) {
+        entriesCount += shard.data.size();
+    }
+    entriesCount_ = entriesCount;
+    Metrics::getInstance().setGauge(MetricGauge::LOADED_ENTRIES,
+                                    static_cast<int64_t>(entriesCount));
+
+    LOG_INFO << "Загрузка данных с диска завершена, записей в хранилище: " << entriesCount_;
+    return !snapshotDamaged;
 }
 
-bool StorageManager::loadSnapshot()
+bool StorageManager::loadSnapshot(const std::filesystem::path &path,
+                                  const std::optional<std::string> &baseCheckpointId,
+                                  SnapshotFileInfo &info)
 {
-    LOG_DEBUG << "Загрузка снапшота: " << snapshotPath_.string();
+    LOG_DEBUG << "Загрузка снапшота: " << path.string();
 
-    std::string content;
-    if (!utils::safeFileRead(snapshotPath_, content)) {
+    info = SnapshotFileInfo{};
+
+    // Блоки читаются несколькими потоками из разных частей файла, поэтому подсказка о
+    // последовательном чтении не нужна
+    const utils::MappedFile file(path, false);
+    if (!file.isMapped()) {
         LOG_ERROR << "Ошибка чтения файла снапшота";
         return false;
     }
+    const auto content = file.view();
+    if (!isVersionedSnapshot(content)) {
+        if (baseCheckpointId.has_value()) {
+            LOG_ERROR << "Разностный снапшот имеет некорректный формат";
+            return false;
+        }
+        return loadLegacySnapshot(content, info.checkpointId);
+    }
 
-    auto dataStore = deserializeMap(content);
-    if (dataStore.has_value()) {
-        LOG_INFO << "Снапшот успешно загружен, записей: " << dataStore_.size();
-        dataStore_ = std::move(*dataStore);
-        return true;
+    SnapshotLayout layout;
+    if (!parseSnapshotLayout(content, layout)) {
+        LOG_ERROR << "Данные снапшота повреждены или имеют некорректный формат";
+        return false;
+    }
+    CompressionCodec codec = CompressionCodec::NONE;
+    if (!checkSnapshotLayout(layout, baseCheckpointId, codec)) {
+        return false;
+    }
+    const bool delta = baseCheckpointId.has_value();
+    const auto flags = layout.flags;
+
+    // Резервируем место в сегментах заранее, чтобы вставка не перестраивала таблицы
+    // (изменения разностного снапшота применяются к уже заполненным сегментам)
+    if (!delta) {
+        const auto expectedPerShard = layout.entryCount / STORAGE_SHARD_COUNT;
+        for (auto &shard : shards_) {
+            shard.data.reserve(expectedPerShard + expectedPerShard / 8 + RecordTable::GROUP_WIDTH);
+        }
     }
 
-    LOG_ERROR << "Данные снапшота повреждены или имеют некорректный формат";
-    return false;
+    std::atomic<size_t> damagedBlocks{ 0 };
+    std::atomic<size_t> damagedEntries{ 0 };
+    utils::parallelFor(layout.blocks.size(), [&](size_t i) {
+        const auto &block = layout.blocks[i];
+
+        // Записи раскладываются по сегментам заранее, чтобы захватывать блокировку каждого
+        // сегмента один раз на блок. Значения ссылаются на отображение и копируются при вставке
+        struct BlockEntry {
+            Uuid key;
+            std::string_view value;
+            bool removed; // Удаление записи разностным снапшотом
+            std::optional<ValueLocation> location; // Положение значения в журнале значений
+        };
+        std::array<std::vector<BlockEntry>, STORAGE_SHARD_COUNT> buckets;
+
+        // Сжатый блок распаковывается в буфер, на который ссылаются значения до их вставки.
+        // Положение за пределами журнала значений делает блок повреждённым
+        std::string decompressed;
+        std::string_view blockData;
+        bool locationsValid = true;
+        const auto valid = readSnapshotBlock(content, block, codec, decompressed, blockData)
+                && decodeSnapshotBlock(
+                    blockData, block.entryCount, flags,
+                    [this, &buckets, &locationsValid](const Uuid &key, std::string_view value,
+                                                      bool removed,
+                                                      const ValueLocation *location) {
+                        if (location != nullptr && !valueLog_.contains(*location)) {
+                            locationsValid = false;
+                        }
+                        buckets[shardIndex(key)].push_back(
+                            { key, value, removed,
+                              location != nullptr ? std::optional(*location) : std::nullopt });
+                    })
+                && locationsValid;
+        if (!valid) {
+            LOG_ERROR << "Блок снапшота " << i << " повреждён (смещение: " << block.offset
+                      << ", размер: " << block.size << " байт, записей: " << block.entryCount
+                      << ")";
+            damagedBlocks++;
+            damagedEntries += block.entryCount;
+            return;
+        }
+
+        for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+            if (buckets[shardId].empty()) {
+                continue;
+            }
+            auto &shard = shards_[shardId];
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            for (const auto &entry : buckets[shardId]) {
+                if (entry.removed) {
+                    eraseRecord(shard, entry.key);
+                }
+                else {
+                    // Значения снапшота, записанного без журнала значений, переносятся в него
+                    auto location = entry.location;
+                    std::shared_lock<std::shared_mutex> pin;
+                    if (!location.has_value()) {
+                        prepareValue(entry.key, entry.value, location, pin);
+                    }
+                    assignValue(*shard.data.emplace(entry.key).first, entry.value, location);
+                }
+            }
+        }
+    });
+
+    info.checkpointId = std::string(layout.checkpointId);
+    info.versioned = true;
+    info.damaged = damagedBlocks > 0;
+    if (info.damaged) {
+        LOG_ERROR << "Снапшот загружен частично, повреждено блоков: " << damagedBlocks << " из "
+                  << layout.blocks.size() << ", записей: " << damagedEntries;
+    }
+    else {
+        LOG_INFO << "Снапшот успешно загружен, " << (delta ? "изменений: " : "записей: ")
+                 << layout.entryCount << ", блоков: " << layout.blocks.size()
+                 << ", сжатие: " << utils::compressionCodecName(codec);
+    }
+    return true;
+}
+
+void StorageManager::loadDeltaSnapshots(std::optional<std::string> &checkpointId, bool &damaged)
+{
+    chainCheckpointId_ = checkpointId;
+    for (const auto &[number, path] : listDeltaSnapshots(snapshotPath_)) {
+        nextDeltaNumber_ = number + 1;
+        // Файлы после разрыва цепочки остались от прежних цепочек или не могут быть применены:
+        // следующий снапшот будет полным и удалит их
+        if (!chainCheckpointId_.has_value()) {
+            continue;
+        }
+
+        LOG_INFO << "Найден разностный снапшот, загружаем: " << path.string();
+        SnapshotFileInfo delta;
+        if (!loadSnapshot(path, checkpointId, delta) || delta.damaged) {
+            LOG_WARNING << "Разностный снапшот не применён полностью, цепочка снапшотов прервана";
+            damaged = damaged || delta.damaged;
+            chainCheckpointId_ = std::nullopt;
+            continue;
+        }
+        checkpointId = delta.checkpointId;
+        chainCheckpointId_ = checkpointId;
+        deltaCount_++;
+        std::error_code ec;
+        const auto deltaSize = std::filesystem::file_size(path, ec);
+        deltaBytes_ += ec ? 0 : deltaSize;
+    }
+}
+
+bool StorageManager::loadLegacySnapshot(std::string_view content,
+                                        std::optional<std::string> &checkpointId)
+{
+    LOG_INFO << "Снапшот записан в прежнем формате, загружаем";
+
+    auto snapshotData = deserializeLegacySnapshot(content, checkpointId);
+    if (!snapshotData.has_value()) {
+        LOG_ERROR << "Данные снапшота повреждены или имеют некорректный формат";
+        return false;
+    }
+
+    // Распределяем записи по сегментам, освобождая память загруженных данных по мере переноса
+    size_t entriesCount = 0;
+    for (auto it = snapshotData->begin(); it != snapshotData->end();
+         it = snapshotData->erase(it)) {
+        const auto key = Uuid::fromString(it->first);
+        if (!key.has_value()) {
+            LOG_WARNING << "Пропущена запись с некорректным UUID: " << it->first.substr(0, 64);
+            continue;
+        }
+        std::optional<ValueLocation> location;
+        std::shared_lock<std::shared_mutex> pin;
+        prepareValue(*key, it->second, location, pin);
+        auto &shard = shardFor(*key);
+        assignValue(*shard.data.emplace(*key).first, it->second, location);
+        entriesCount++;
+    }
+    LOG_INFO << "Снапшот успешно загружен, записей: " << entriesCount;
+    return true;
 }
 
 bool StorageManager::restoreFromJournal(const std::optional<std::string> &lastCheckpointId)
 {
     LOG_DEBUG << "Восстановление данных из журнала операций";
-    std::unique_lock<std::shared_mutex> lock(storageMutex_);
-    return journalManager_.replayJournal(dataStore_, lastCheckpointId);
+
+    // Операции применяются прямо к сегментам без блокировок: восстановление выполняется в
+    // конструкторе, до запуска других потоков
+    return journalManager_.replayJournal(
+        [this](const JournalEntryView &entry) {
+            const auto key = Uuid::fromString(entry.uuid);
+            if (!key.has_value()) {
+                LOG_ERROR << "Операция журнала для некорректного UUID: "
+                          << entry.uuid.substr(0, 64);
+                return false;
+            }
+            auto &shard = shardFor(*key);
+            auto &table = shard.data;
+            // Восстановленные из журнала изменения войдут в следующий разностный снапшот
+            if (entry.type != OperationType::CHECKPOINT) {
+                shard.dirty.insert(*key);
+            }
+
+            // Значение, которое не удалось записать в журнал значений, остаётся в памяти
+            std::optional<ValueLocation> location;
+            std::shared_lock<std::shared_mutex> pin;
+            if (entry.type == OperationType::INSERT || entry.type == OperationType::UPDATE) {
+                prepareValue(*key, entry.data, location, pin);
+            }
+            switch (entry.type) {
+            case OperationType::INSERT:
+                assignValue(*table.emplace(*key).first, entry.data, location);
+                return true;
+            case OperationType::UPDATE:
+                if (auto *value = table.find(*key)) {
+                    assignValue(*value, entry.data, location);
+                    return true;
+                }
+                LOG_ERROR << "Операция UPDATE для несуществующего UUID: " << entry.uuid;
+                return false;
+            case OperationType::REMOVE:
+                if (eraseRecord(shard, *key)) {
+                    return true;
+                }
+                LOG_WARNING << "Операция REMOVE для несуществующего UUID: " << entry.uuid;
+                return false;
+            case OperationType::CHECKPOINT:
+                // Контрольные точки не применяются к хранилищу
+                return true;
+            }
+            UNREACHABLE("Unsupported OperationType");
+        },
+        lastCheckpointId);
+}
+
+size_t StorageManager::shardIndex(const Uuid &key)
+{
+    // Младшие биты хэша используются внутри таблицы сегмента, поэтому сегмент выбирается по
+    // старшим, иначе все ключи сегмента имели бы одинаковые управляющие байты
+    return (key.hash() >> 32) % STORAGE_SHARD_COUNT;
+}
+
+StorageManager::StorageShard &StorageManager::shardFor(const Uuid &key)
+{
+    return shards_[shardIndex(key)];
 }
 
-std::optional<std::string> StorageManager::insert(const std::string &data)
+const StorageManager::StorageShard &StorageManager::shardFor(const Uuid &key) const
 {
-    // Эксклюзивная блокировка для записи
-    std::unique_lock<std::shared_mutex> lock(storageMutex_);
+    return shards_[shardIndex(key)];
+}
+
+bool StorageManager::prepareValue(const Uuid &key, std::string_view data,
+                                  std::optional<ValueLocation> &location,
+                                  std::shared_lock<std::shared_mutex> &pin)
+{
+    location = std::nullopt;
+    if (!valueLog_.shouldStore(data.size())) {
+        return true;
+    }
+    // Значение записывается до блокировки сегмента, поэтому запись на диск не задерживает
+    // других писателей и читателей сегмента
+    if (!pin.owns_lock()) {
+        pin = valueLog_.pinSegments();
+    }
+    location = valueLog_.append(key, data);
+    return location.has_value();
+}
 
-    // Генерируем UUID
-    const auto uuid = uuidGenerator_.generateUuid();
-    // Записываем в журнал
-    if (!journalManager_.writeInsert(uuid, data)) {
+void StorageManager::assignValue(RecordValue &value, std::string_view data,
+                                 const std::optional<ValueLocation> &location)
+{
+    releaseValue(value);
+    if (location.has_value()) {
+        value.assignLocation(*location);
+        valueLog_.retain(*location);
+    }
+    else {
+        value.assign(data);
+    }
+}
+
+bool StorageManager::eraseRecord(StorageShard &shard, const Uuid &key)
+{
+    const auto *value = shard.data.find(key);
+    if (value == nullptr) {
+        return false;
+    }
+    releaseValue(*value);
+    return shard.data.erase(key);
+}
+
+void StorageManager::releaseValue(const RecordValue &value)
+{
+    if (const auto location = value.location()) {
+        valueLog_.release(*location);
+    }
+}
+
+void StorageManager::releaseValues(const RecordTable &table)
+{
+    table.forEachRecord([this](const Uuid &, const RecordValue &value) { releaseValue(value); });
+}
+
+std::optional<std::string> StorageManager::loadValue(const Uuid &key,
+                                                     const ValueLocation &location) const
+{
+    std::string value;
+    if (valueLog_.read(key, location, value)) {
+        return value;
+    }
+
+    // После чтения положения значение могло быть перенесено уплотнением, а его прежний сегмент
+    // удалён. Под блокировкой сегмента положение актуально, а его сегмент не удаляется
+    const auto &shard = shardFor(key);
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    const auto *record = shard.data.find(key);
+    if (record == nullptr) {
+        return std::nullopt;
+    }
+    const auto current = record->location();
+    if (!current.has_value()) {
+        return std::string(record->view());
+    }
+    if (!valueLog_.read(key, *current, value)) {
+        LOG_ERROR << "Не удалось прочитать значение из журнала значений, UUID: "
+                  << key.toString();
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::optional<std::string> StorageManager::insert(std::string_view data)
+{
+    ScopedLatency latency(MetricHistogram::STORAGE_INSERT);
+    // Генерируем UUID (строковое представление нужно для журнала и вызывающего)
+    const auto key = uuidGenerator_.generate();
+    const auto uuid = key.toString();
+    // Проверяем операцию заранее: зарезервированный номер журнала отменить уже нельзя
+    if (!JournalManager::isOperationRecordable(uuid, data)) {
         LOG_ERROR << "Не удалось записать данные: " << data;
         return std::nullopt;
     }
-    // Обновляем данные в памяти
-    dataStore_[uuid] = data;
+    std::optional<ValueLocation> location;
+    std::shared_lock<std::shared_mutex> pin;
+    if (!prepareValue(key, data, location, pin)) {
+        LOG_ERROR << "Не удалось записать значение в журнал значений, UUID: " << uuid;
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        return std::nullopt;
+    }
+
+    auto &shard = shardFor(key);
+    uint64_t sequence = 0;
+    {
+        // Эксклюзивная блокировка сегмента для записи
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        // Номер записи журнала резервируется вместе с изменением, поэтому порядок записей в
+        // журнале совпадает с порядком изменений
+        sequence = journalManager_.reserveSequence();
+        // Обновляем данные в памяти
+        auto [value, inserted] = shard.data.emplace(key);
+        assignValue(*value, data, location);
+        if (inserted) {
+            ++entriesCount_;
+        }
+        shard.dirty.insert(key);
+    }
+    if (pin.owns_lock()) {
+        pin.unlock();
+    }
+
+    // Ставим операцию в очередь и ожидаем фиксации вне блокировки, чтобы записи конкурентных
+    // писателей попали в тот же пакет
+    const auto ticket
+        = journalManager_.submitOperation(sequence, OperationType::INSERT, uuid, data);
+    if (!journalManager_.waitForCommit(ticket)) {
+        LOG_ERROR << "Не удалось зафиксировать в журнале данные: " << data;
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        // UUID ещё не был возвращен вызывающему, поэтому запись можно безопасно откатить
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        if (eraseRecord(shard, key)) {
+            --entriesCount_;
+        }
+        return std::nullopt;
+    }
 
     // Уведомляем о выполнении операции
     notifyOperation();
@@ -243,36 +681,137 @@ std::optional<std::string> StorageManager::insert(const std::string &data)
     return uuid;
 }
 
-std::optional<std::string> StorageManager::get(const std::string &uuid) const
+std::optional<std::string> StorageManager::get(std::string_view uuid) const
 {
-    // Разделяемая блокировка для чтения
-    std::shared_lock<std::shared_mutex> lock(storageMutex_);
-    // Ищем запись в хранилище
-    auto it = dataStore_.find(uuid);
-    if (it != dataStore_.end()) {
-        // Если нашли, возвращаем данные для переданного UUID
-        return it->second;
+    ScopedLatency latency(MetricHistogram::STORAGE_GET);
+    // Строка, не являющаяся UUID, не может быть ключом записи
+    const auto key = Uuid::fromString(uuid);
+    if (key.has_value()) {
+        std::optional<ValueLocation> location;
+        {
+            const auto &shard = shardFor(*key);
+            // Разделяемая блокировка сегмента для чтения
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            // Ищем запись в хранилище
+            const auto *value = shard.data.find(*key);
+            if (value != nullptr) {
+                location = value->location();
+                if (!location.has_value()) {
+                    // Если нашли, возвращаем данные для переданного UUID
+                    return std::string(value->view());
+                }
+            }
+        }
+        // Значение из журнала значений читается вне блокировки сегмента
+        if (location.has_value()) {
+            return loadValue(*key, *location);
+        }
     }
-    LOG_WARNING << "Запись с UUID не найдена: " << uuid;
+    // Отсутствие записи - обычный результат чтения, о котором узнает вызывающий код
+    LOG_DEBUG << "Запись с UUID не найдена: " << uuid;
     return std::nullopt;
 }
 
-bool StorageManager::update(const std::string &uuid, const std::string &data)
+bool StorageManager::read(std::string_view uuid,
+                          const std::function<void(std::string_view)> &reader) const
+{
+    ScopedLatency latency(MetricHistogram::STORAGE_GET);
+    const auto key = Uuid::fromString(uuid);
+    if (key.has_value()) {
+        std::optional<ValueLocation> location;
+        {
+            const auto &shard = shardFor(*key);
+            // Представление значения действительно, пока удерживается разделяемая блокировка
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+            const auto *value = shard.data.find(*key);
+            if (value != nullptr) {
+                location = value->location();
+                if (!location.has_value()) {
+                    reader(value->view());
+                    return true;
+                }
+            }
+        }
+        // Значение из журнала значений передаётся из прочитанной копии
+        if (location.has_value()) {
+            const auto value = loadValue(*key, *location);
+            if (value.has_value()) {
+                reader(*value);
+                return true;
+            }
+        }
+    }
+    LOG_DEBUG << "Запись с UUID не найдена: " << uuid;
+    return false;
+}
+
+bool StorageManager::update(std::string_view uuid, std::string_view data)
 {
-    // Эксклюзивная блокировка для записи
-    std::unique_lock<std::shared_mutex> lock(storageMutex_);
+    ScopedLatency latency(MetricHistogram::STORAGE_UPDATE);
+    if (!JournalManager::isOperationRecordable(uuid, data)) {
+        LOG_ERROR << "Недопустимая операция обновления записи с UUID: " << uuid.substr(0, 64);
+        return false;
+    }
 
-    // Проверяем существование записи
-    if (dataStore_.find(uuid) == dataStore_.end()) {
+    const auto key = Uuid::fromString(uuid);
+    if (!key.has_value()) {
         LOG_WARNING << "Попытка обновить несуществующую запись с UUID: " << uuid;
         return false;
     }
-    // Записываем в журнал
-    if (!journalManager_.writeUpdate(uuid, data)) {
+    std::optional<ValueLocation> location;
+    std::shared_lock<std::shared_mutex> pin;
+    if (!prepareValue(*key, data, location, pin)) {
+        LOG_ERROR << "Не удалось записать значение в журнал значений, UUID: " << uuid;
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
         return false;
     }
-    // Обновляем данные в памяти
-    dataStore_[uuid] = data;
+
+    auto &shard = shardFor(*key);
+    uint64_t sequence = 0;
+    RecordValue previous;
+    {
+        // Эксклюзивная блокировка сегмента для записи
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // Проверяем существование записи
+        auto *value = shard.data.find(*key);
+        if (value == nullptr) {
+            LOG_WARNING << "Попытка обновить несуществующую запись с UUID: " << uuid;
+            return false;
+        }
+        sequence = journalManager_.reserveSequence();
+        // Прежнее значение хранится до фиксации операции, чтобы откатить обновление при ошибке
+        // журнала (его положение в журнале значений до тех пор остаётся занятым)
+        previous = std::move(*value);
+        // Обновляем данные в памяти
+        assignValue(*value, data, location);
+        shard.dirty.insert(*key);
+    }
+    if (pin.owns_lock()) {
+        pin.unlock();
+    }
+
+    // Ставим операцию в очередь и ожидаем фиксации вне блокировки
+    const auto ticket
+        = journalManager_.submitOperation(sequence, OperationType::UPDATE, uuid, data);
+    if (!journalManager_.waitForCommit(ticket)) {
+        LOG_ERROR << "Не удалось зафиксировать в журнале обновление записи с UUID: " << uuid;
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        // Прежнее значение восстанавливается, только если запись не изменена следующим писателем
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto *value = shard.data.find(*key);
+        const auto unchanged = value != nullptr && value->location() == location
+                               && (location.has_value() || value->view() == data);
+        if (unchanged) {
+            releaseValue(*value);
+            *value = std::move(previous);
+        }
+        else {
+            releaseValue(previous);
+        }
+        return false;
+    }
+    releaseValue(previous);
 
     // Уведомляем о выполнении операции
     notifyOperation();
@@ -281,22 +820,60 @@ bool StorageManager::update(const std::string &uuid, const std::string &data)
     return true;
 }
 
-bool StorageManager::remove(const std::string &uuid)
+bool StorageManager::remove(std::string_view uuid)
 {
-    // Эксклюзивная блокировка для записи
-    std::unique_lock<std::shared_mutex> lock(storageMutex_);
+    ScopedLatency latency(MetricHistogram::STORAGE_REMOVE);
+    if (!JournalManager::isOperationRecordable(uuid, "")) {
+        LOG_ERROR << "Недопустимая операция удаления записи с UUID: " << uuid.substr(0, 64);
+        return false;
+    }
 
-    // Проверяем существование записи
-    if (dataStore_.find(uuid) == dataStore_.end()) {
+    const auto key = Uuid::fromString(uuid);
+    if (!key.has_value()) {
         LOG_WARNING << "Попытка удалить несуществующую запись с UUID: " << uuid;
         return false;
     }
-    // Записываем в журнал
-    if (!journalManager_.writeRemove(uuid)) {
+
+    auto &shard = shardFor(*key);
+    uint64_t sequence = 0;
+    RecordValue previous;
+    {
+        // Эксклюзивная блокировка сегмента для записи
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // Проверяем существование записи
+        auto *value = shard.data.find(*key);
+        if (value == nullptr) {
+            LOG_WARNING << "Попытка удалить несуществующую запись с UUID: " << uuid;
+            return false;
+        }
+        sequence = journalManager_.reserveSequence();
+        // Удалённое значение хранится до фиксации операции, чтобы вернуть запись при ошибке
+        // журнала (его положение в журнале значений до тех пор остаётся занятым)
+        previous = std::move(*value);
+        shard.data.erase(*key);
+        --entriesCount_;
+        shard.dirty.insert(*key);
+    }
+
+    // Ставим операцию в очередь и ожидаем фиксации вне блокировки
+    const auto ticket = journalManager_.submitOperation(sequence, OperationType::REMOVE, uuid);
+    if (!journalManager_.waitForCommit(ticket)) {
+        LOG_ERROR << "Не удалось зафиксировать в журнале удаление записи с UUID: " << uuid;
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        // Запись возвращается, если её ключ ещё не занят
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        auto [value, inserted] = shard.data.emplace(*key);
+        if (inserted) {
+            *value = std::move(previous);
+            ++entriesCount_;
+        }
+        else {
+            releaseValue(previous);
+        }
         return false;
     }
-    // Удаляем из памяти
-    dataStore_.erase(uuid);
+    releaseValue(previous);
 
     // Уведомляем о выполнении операции
     notifyOperation();
@@ -305,46 +882,1070 @@ bool StorageManager::remove(const std::string &uuid)
     return true;
 }
 
+std::optional<std::vector<std::string>>
+StorageManager::insertBatch(const std::vector<std::string> &data)
+{
+    std::vector<BatchOperation> operations;
+    operations.reserve(data.size());
+    for (const auto &item : data) {
+        operations.push_back({ OperationType::INSERT, std::string(), item });
+    }
+    return applyBatch(operations);
+}
+
+std::vector<std::optional<std::string>>
+StorageManager::getMany(const std::vector<std::string> &uuids) const
+{
+    ScopedLatency latency(MetricHistogram::STORAGE_MGET);
+    std::vector<std::optional<std::string>> result(uuids.size());
+
+    // Запросы группируются по сегментам, чтобы захватывать блокировку каждого сегмента один раз
+    std::array<std::vector<std::pair<size_t, Uuid>>, STORAGE_SHARD_COUNT> requests;
+    for (size_t i = 0; i < uuids.size(); i++) {
+        const auto key = Uuid::fromString(uuids[i]);
+        if (key.has_value()) {
+            requests[shardIndex(*key)].emplace_back(i, *key);
+        }
+    }
+    // Значения из журнала значений читаются после освобождения блокировок
+    std::vector<std::tuple<size_t, Uuid, ValueLocation>> logged;
+    for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+        if (requests[shardId].empty()) {
+            continue;
+        }
+        const auto &shard = shards_[shardId];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        for (const auto &[index, key] : requests[shardId]) {
+            if (const auto *value = shard.data.find(key)) {
+                if (const auto location = value->location()) {
+                    logged.emplace_back(index, key, *location);
+                }
+                else {
+                    result[index] = std::string(value->view());
+                }
+            }
+        }
+    }
+    for (const auto &[index, key, location] : logged) {
+        result[index] = loadValue(key, location);
+    }
+
+    size_t missing = 0;
+    for (const auto &value : result) {
+        missing += value.has_value() ? 0 : 1;
+    }
+    if (missing > 0) {
+        LOG_DEBUG << "Записи с UUID не найдены: " << missing << " из " << uuids.size();
+    }
+    return result;
+}
+
+std::optional<std::vector<std::string>>
+StorageManager::applyBatch(const std::vector<BatchOperation> &operations)
+{
+    ScopedLatency latency(MetricHistogram::STORAGE_BATCH);
+    if (operations.empty()) {
+        return std::vector<std::string>();
+    }
+
+    // Ключи и строковые UUID операций подготавливаются до захвата блокировок
+    std::vector<Uuid> keys;
+    keys.reserve(operations.size());
+    std::vector<std::string> uuids;
+    uuids.reserve(operations.size());
+    std::array<bool, STORAGE_SHARD_COUNT> involvedShards{};
+    for (const auto &operation : operations) {
+        std::optional<Uuid> key;
+        switch (operation.type) {
+        case OperationType::INSERT:
+            key = uuidGenerator_.generate();
+            uuids.push_back(key->toString());
+            break;
+        case OperationType::UPDATE:
+        case OperationType::REMOVE:
+            key = Uuid::fromString(operation.uuid);
+            uuids.push_back(operation.uuid);
+            break;
+        case OperationType::CHECKPOINT:
+            break;
+        }
+        if (!key.has_value()) {
+            LOG_ERROR << "Пакет не применён: недопустимая операция для UUID: "
+                      << operation.uuid.substr(0, 64);
+            return std::nullopt;
+        }
+        if (!JournalManager::isOperationRecordable(uuids.back(), operation.data)) {
+            LOG_ERROR << "Пакет не применён: превышен допустимый размер данных для UUID: "
+                      << uuids.back();
+            return std::nullopt;
+        }
+        keys.push_back(*key);
+        involvedShards[shardIndex(*key)] = true;
+    }
+
+    // Большие значения записываются в журнал значений до захвата блокировок
+    std::vector<std::optional<ValueLocation>> locations(operations.size());
+    std::shared_lock<std::shared_mutex> pin;
+    for (size_t i = 0; i < operations.size(); i++) {
+        if (operations[i].type != OperationType::REMOVE
+            && !prepareValue(keys[i], operations[i].data, locations[i], pin)) {
+            LOG_ERROR << "Пакет не применён: не удалось записать значение в журнал значений, "
+                         "UUID: "
+                      << uuids[i];
+            Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+            return std::nullopt;
+        }
+    }
+
+    // Для каждой затронутой записи хранится её значение до пакета (std::nullopt - записи не
+    // было) и номер последней операции пакета, которая её записала (std::nullopt - удалила).
+    // Прежние значения не освобождаются до фиксации пакета, чтобы откатить его при ошибке журнала
+    struct BatchChange {
+        std::optional<RecordValue> previous;
+        std::optional<size_t> last;
+    };
+    std::unordered_map<Uuid, BatchChange> changes;
+    uint64_t firstSequence = 0;
+    {
+        // Эксклюзивные блокировки затронутых сегментов захватываются по одному разу в порядке
+        // сегментов (в том же порядке их захватывает создание снапшота)
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+            if (involvedShards[shardId]) {
+                locks.emplace_back(shards_[shardId].mutex);
+            }
+        }
+
+        // Проверяем существование записей с учётом предыдущих операций пакета до изменения
+        // данных, чтобы пакет применялся целиком
+        std::unordered_map<Uuid, bool> batchState;
+        for (size_t i = 0; i < operations.size(); i++) {
+            const auto &key = keys[i];
+            if (operations[i].type == OperationType::INSERT) {
+                batchState[key] = true;
+                continue;
+            }
+            const auto it = batchState.find(key);
+            const auto exists
+                = it != batchState.end() ? it->second : shardFor(key).data.find(key) != nullptr;
+            if (!exists) {
+                LOG_WARNING << "Пакет не применён: запись с UUID не найдена: " << uuids[i];
+                return std::nullopt;
+            }
+            batchState[key] = operations[i].type == OperationType::UPDATE;
+        }
+
+        // Номера записей журнала резервируются подряд вместе с изменением данных
+        firstSequence = journalManager_.reserveSequences(operations.size());
+        for (size_t i = 0; i < operations.size(); i++) {
+            const auto &key = keys[i];
+            auto &shard = shardFor(key);
+            auto [change, first] = changes.try_emplace(key);
+            switch (operations[i].type) {
+            case OperationType::INSERT:
+                assignValue(*shard.data.emplace(key).first, operations[i].data, locations[i]);
+                ++entriesCount_;
+                change->second.last = i;
+                break;
+            case OperationType::UPDATE: {
+                auto *value = shard.data.find(key);
+                if (first) {
+                    change->second.previous = std::move(*value);
+                }
+                assignValue(*value, operations[i].data, locations[i]);
+                change->second.last = i;
+                break;
+            }
+            case OperationType::REMOVE:
+                if (first) {
+                    change->second.previous = std::move(*shard.data.find(key));
+                    shard.data.erase(key);
+                }
+                else {
+                    eraseRecord(shard, key);
+                }
+                --entriesCount_;
+                change->second.last = std::nullopt;
+                break;
+            case OperationType::CHECKPOINT:
+                UNREACHABLE("Unsupported OperationType");
+            }
+            shard.dirty.insert(key);
+        }
+    }
+    if (pin.owns_lock()) {
+        pin.unlock();
+    }
+
+    // Весь пакет ставится в журнал одним фрагментом и фиксируется одной синхронизацией
+    std::vector<JournalOperationView> journalOperations;
+    journalOperations.reserve(operations.size());
+    for (size_t i = 0; i < operations.size(); i++) {
+        const auto type = operations[i].type;
+        journalOperations.push_back(
+            { type, uuids[i],
+              type == OperationType::REMOVE ? std::string_view() : operations[i].data });
+    }
+    const auto ticket = journalManager_.submitOperations(firstSequence, journalOperations);
+    if (!journalManager_.waitForCommit(ticket)) {
+        LOG_ERROR << "Не удалось зафиксировать в журнале пакет операций: " << operations.size();
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        // Запись возвращается к значению до пакета, только если её не изменил следующий писатель
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+            if (involvedShards[shardId]) {
+                locks.emplace_back(shards_[shardId].mutex);
+            }
+        }
+        for (auto &[key, change] : changes) {
+            auto &shard = shardFor(key);
+            auto *value = shard.data.find(key);
+            auto unchanged = value == nullptr;
+            if (const auto last = change.last) {
+                unchanged = value != nullptr && value->location() == locations[*last]
+                            && (locations[*last].has_value()
+                                || value->view() == operations[*last].data);
+            }
+            if (!unchanged) {
+                if (change.previous.has_value()) {
+                    releaseValue(*change.previous);
+                }
+                continue;
+            }
+            if (value != nullptr) {
+                releaseValue(*value);
+                if (change.previous.has_value()) {
+                    *value = std::move(*change.previous);
+                }
+                else {
+                    shard.data.erase(key);
+                    --entriesCount_;
+                }
+            }
+            else if (change.previous.has_value()) {
+                *shard.data.emplace(key).first = std::move(*change.previous);
+                ++entriesCount_;
+            }
+            shard.dirty.insert(key);
+        }
+        return std::nullopt;
+    }
+    for (const auto &[key, change] : changes) {
+        if (change.previous.has_value()) {
+            releaseValue(*change.previous);
+        }
+    }
+
+    // Уведомляем о выполнении всех операций пакета
+    notifyOperation(operations.size());
+
+    LOG_DEBUG << "Успешно применён пакет операций: " << operations.size();
+    return uuids;
+}
+
+void StorageManager::reserve(size_t count)
+{
+    // Ключи распределяются по сегментам равномерно, запас покрывает неравномерность
+    const auto expectedPerShard = count / STORAGE_SHARD_COUNT;
+    for (auto &shard : shards_) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.data.reserve(shard.data.size() + expectedPerShard + expectedPerShard / 8
+                           + RecordTable::GROUP_WIDTH);
+    }
+}
+
+bool StorageManager::importValues(const std::vector<std::string_view> &values,
+                                  std::vector<Uuid> *keys)
+{
+    // Длина значения ограничена форматом снапшота и журнала
+    for (const auto &value : values) {
+        if (value.size() > std::numeric_limits<uint32_t>::max()) {
+            LOG_ERROR << "Загрузка не выполнена: превышен допустимый размер строки";
+            return false;
+        }
+    }
+
+    // Ключи генерируются в нескольких потоках блоками, и для каждого блока сразу
+    // запоминается, какие его строки относятся к каждому сегменту
+    std::vector<Uuid> generated(values.size());
+    const auto blockCount = (values.size() + IMPORT_BLOCK_SIZE - 1) / IMPORT_BLOCK_SIZE;
+    std::vector<std::array<std::vector<uint32_t>, STORAGE_SHARD_COUNT>> blockShards(blockCount);
+    utils::parallelFor(blockCount, [&](size_t block) {
+        const auto begin = block * IMPORT_BLOCK_SIZE;
+        const auto end = std::min(values.size(), begin + IMPORT_BLOCK_SIZE);
+        for (auto i = begin; i < end; i++) {
+            generated[i] = uuidGenerator_.generate();
+            blockShards[block][shardIndex(generated[i])].push_back(
+                static_cast<uint32_t>(i - begin));
+        }
+    });
+
+    // Большие значения записываются в журнал значений до вставки строк в какой-либо сегмент,
+    // поэтому ошибка записи не оставляет в хранилище части загружаемых строк (уже записанные
+    // значения ни на что не ссылаются и удаляются уплотнением журнала значений). Сегменты
+    // журнала значений закреплены до окончания вставки, иначе уплотнение может удалить сегмент
+    // с ещё не вставленными значениями
+    const auto useValueLog = valueLog_.shouldStore(std::numeric_limits<size_t>::max());
+    std::vector<std::optional<ValueLocation>> locations(useValueLog ? values.size() : 0);
+    std::shared_lock<std::shared_mutex> pin;
+    if (useValueLog) {
+        pin = valueLog_.pinSegments();
+        std::atomic<bool> failed{ false };
+        utils::parallelFor(blockCount, [&](size_t block) {
+            const auto begin = block * IMPORT_BLOCK_SIZE;
+            const auto end = std::min(values.size(), begin + IMPORT_BLOCK_SIZE);
+            for (auto i = begin; i < end && !failed; i++) {
+                if (!valueLog_.shouldStore(values[i].size())) {
+                    continue;
+                }
+                locations[i] = valueLog_.append(generated[i], values[i]);
+                if (!locations[i].has_value()) {
+                    failed = true;
+                }
+            }
+        });
+        if (failed) {
+            LOG_ERROR << "Не удалось записать значения в журнал значений при загрузке, строки не "
+                         "загружены";
+            Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+            return false;
+        }
+    }
+
+    // Каждый сегмент заполняется одним потоком под одной эксклюзивной блокировкой, а место в
+    // его таблице резервируется заранее
+    utils::parallelFor(STORAGE_SHARD_COUNT, [&](size_t shardId) {
+        size_t count = 0;
+        for (const auto &shards : blockShards) {
+            count += shards[shardId].size();
+        }
+        if (count == 0) {
+            return;
+        }
+
+        auto &shard = shards_[shardId];
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        shard.data.reserve(shard.data.size() + count);
+        size_t inserted = 0;
+        for (size_t block = 0; block < blockCount; block++) {
+            for (const auto offset : blockShards[block][shardId]) {
+                const auto index = block * IMPORT_BLOCK_SIZE + offset;
+                auto [value, isNew] = shard.data.emplace(generated[index]);
+                assignValue(*value, values[index],
+                            useValueLog ? locations[index] : std::nullopt);
+                inserted += isNew ? 1 : 0;
+            }
+        }
+        entriesCount_ += inserted;
+    });
+    if (pin.owns_lock()) {
+        pin.unlock();
+    }
+
+    // Загруженные записи не отмечены изменёнными, поэтому следующий снапшот должен быть полным,
+    // а не разностным
+    {
+        std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+        chainCheckpointId_.reset();
+    }
+
+    if (keys != nullptr) {
+        *keys = std::move(generated);
+    }
+    LOG_DEBUG << "Загружено строк: " << values.size();
+    return true;
+}
+
+bool StorageManager::finishImport()
+{
+    LOG_INFO << "Завершение загрузки, записей в хранилище: " << entriesCount_;
+    return compactJournal();
+}
+
+size_t StorageManager::getExportPartCount()
+{
+    return STORAGE_SHARD_COUNT;
+}
+
+void StorageManager::exportPart(size_t part, std::string &records) const
+{
+    assert(part < STORAGE_SHARD_COUNT);
+    const auto timestamp = static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch())
+            .count());
+
+    // Значения из журнала значений читаются после освобождения блокировки
+    std::vector<std::pair<Uuid, ValueLocation>> logged;
+    {
+        const auto &shard = shards_[part];
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        shard.data.forEachRecord([&](const Uuid &key, const RecordValue &value) {
+            if (const auto location = value.location()) {
+                logged.emplace_back(key, *location);
+                return;
+            }
+            const auto uuid = key.toString();
+            JournalEntry::serializeView({ OperationType::INSERT, uuid, value.view(), timestamp },
+                                        records);
+        });
+    }
+    for (const auto &[key, location] : logged) {
+        // Запись, удалённая после освобождения блокировки, не передаётся: её удаление будет
+        // прочитано из журнала
+        const auto value = loadValue(key, location);
+        if (value.has_value()) {
+            const auto uuid = key.toString();
+            JournalEntry::serializeView({ OperationType::INSERT, uuid, *value, timestamp },
+                                        records);
+        }
+    }
+}
+
+bool StorageManager::applyReplicated(std::string_view records)
+{
+    ScopedLatency latency(MetricHistogram::STORAGE_BATCH);
+
+    // Записи разбираются и ключи подготавливаются до захвата блокировок
+    std::vector<JournalEntryView> entries;
+    std::vector<Uuid> keys;
+    std::array<bool, STORAGE_SHARD_COUNT> involvedShards{};
+    while (!records.empty()) {
+        size_t recordSize = 0;
+        const auto entry = JournalEntry::deserializeView(records, &recordSize);
+        if (!entry.has_value()) {
+            LOG_ERROR << "Реплицируемые записи не применены: повреждённая запись журнала";
+            return false;
+        }
+        records.remove_prefix(recordSize);
+        if (entry->type == OperationType::CHECKPOINT) {
+            continue;
+        }
+        const auto key = Uuid::fromString(entry->uuid);
+        if (!key.has_value()) {
+            LOG_ERROR << "Реплицируемые записи не применены: недопустимый UUID: "
+                      << entry->uuid.substr(0, 64);
+            return false;
+        }
+        entries.push_back(*entry);
+        keys.push_back(*key);
+        involvedShards[shardIndex(*key)] = true;
+    }
+    if (entries.empty()) {
+        return true;
+    }
+
+    // Большие значения записываются в журнал значений до захвата блокировок
+    std::vector<std::optional<ValueLocation>> locations(entries.size());
+    std::shared_lock<std::shared_mutex> pin;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].type != OperationType::REMOVE
+            && !prepareValue(keys[i], entries[i].data, locations[i], pin)) {
+            LOG_ERROR << "Реплицируемые записи не применены: не удалось записать значение в "
+                         "журнал значений, UUID: "
+                      << entries[i].uuid;
+            Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+            return false;
+        }
+    }
+
+    // В свой журнал записываются фактически выполненные операции: замена отсутствующей записи
+    // становится добавлением, а удаление отсутствующей записи пропускается
+    std::vector<JournalOperationView> journalOperations;
+    journalOperations.reserve(entries.size());
+    uint64_t firstSequence = 0;
+    {
+        // Блокировки захватываются в порядке сегментов, как в applyBatch
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+            if (involvedShards[shardId]) {
+                locks.emplace_back(shards_[shardId].mutex);
+            }
+        }
+
+        for (size_t i = 0; i < entries.size(); i++) {
+            const auto &key = keys[i];
+            const auto &entry = entries[i];
+            auto &shard = shardFor(key);
+            switch (entry.type) {
+            case OperationType::INSERT:
+            case OperationType::UPDATE: {
+                auto [value, inserted] = shard.data.emplace(key);
+                assignValue(*value, entry.data, locations[i]);
+                if (inserted) {
+                    ++entriesCount_;
+                }
+                journalOperations.push_back(
+                    { inserted ? OperationType::INSERT : OperationType::UPDATE, entry.uuid,
+                      entry.data });
+                break;
+            }
+            case OperationType::REMOVE:
+                if (!eraseRecord(shard, key)) {
+                    continue;
+                }
+                --entriesCount_;
+                journalOperations.push_back({ OperationType::REMOVE, entry.uuid, {} });
+                break;
+            case OperationType::CHECKPOINT:
+                UNREACHABLE("Unsupported OperationType");
+            }
+            shard.dirty.insert(key);
+        }
+        if (!journalOperations.empty()) {
+            firstSequence = journalManager_.reserveSequences(journalOperations.size());
+        }
+    }
+    if (pin.owns_lock()) {
+        pin.unlock();
+    }
+    if (journalOperations.empty()) {
+        return true;
+    }
+
+    // Изменения не откатываются: реплика не подтверждает получение записей, и они будут
+    // применены повторно
+    const auto ticket = journalManager_.submitOperations(firstSequence, journalOperations);
+    if (!journalManager_.waitForCommit(ticket)) {
+        LOG_ERROR << "Не удалось зафиксировать в журнале реплицируемые операции: "
+                  << journalOperations.size();
+        Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+        return false;
+    }
+
+    notifyOperation(journalOperations.size());
+    LOG_DEBUG << "Применены реплицируемые операции: " << journalOperations.size();
+    return true;
+}
+
+void StorageManager::beginStaging()
+{
+    auto staged = std::make_unique<std::array<RecordTable, STORAGE_SHARD_COUNT>>();
+    {
+        std::lock_guard<std::mutex> lock(stagingMutex_);
+        staged_.swap(staged);
+    }
+    if (staged != nullptr) {
+        LOG_INFO << "Ранее принятое состояние хранилища отброшено";
+        for (const auto &table : *staged) {
+            releaseValues(table);
+        }
+    }
+}
+
+bool StorageManager::stageReplicated(std::string_view records)
+{
+    // Записи разбираются, а большие значения записываются в журнал значений до захвата
+    // блокировки принимаемого состояния
+    std::vector<JournalEntryView> entries;
+    std::vector<Uuid> keys;
+    while (!records.empty()) {
+        size_t recordSize = 0;
+        const auto entry = JournalEntry::deserializeView(records, &recordSize);
+        if (!entry.has_value()) {
+            LOG_ERROR << "Принимаемые записи не применены: повреждённая запись журнала";
+            return false;
+        }
+        records.remove_prefix(recordSize);
+        if (entry->type == OperationType::CHECKPOINT) {
+            continue;
+        }
+        const auto key = Uuid::fromString(entry->uuid);
+        if (!key.has_value()) {
+            LOG_ERROR << "Принимаемые записи не применены: недопустимый UUID: "
+                      << entry->uuid.substr(0, 64);
+            return false;
+        }
+        entries.push_back(*entry);
+        keys.push_back(*key);
+    }
+
+    std::vector<std::optional<ValueLocation>> locations(entries.size());
+    std::shared_lock<std::shared_mutex> pin;
+    for (size_t i = 0; i < entries.size(); i++) {
+        if (entries[i].type != OperationType::REMOVE
+            && !prepareValue(keys[i], entries[i].data, locations[i], pin)) {
+            LOG_ERROR << "Принимаемые записи не применены: не удалось записать значение в "
+                         "журнал значений, UUID: "
+                      << entries[i].uuid;
+            Metrics::getInstance().increment(MetricCounter::STORAGE_FAILURES);
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(stagingMutex_);
+    if (staged_ == nullptr) {
+        LOG_ERROR << "Принимаемые записи не применены: приём состояния хранилища не начат";
+        return false;
+    }
+    for (size_t i = 0; i < entries.size(); i++) {
+        auto &table = (*staged_)[shardIndex(keys[i])];
+        switch (entries[i].type) {
+        case OperationType::INSERT:
+        case OperationType::UPDATE:
+            assignValue(*table.emplace(keys[i]).first, entries[i].data, locations[i]);
+            break;
+        case OperationType::REMOVE:
+            if (const auto *value = table.find(keys[i])) {
+                releaseValue(*value);
+                table.erase(keys[i]);
+            }
+            break;
+        case OperationType::CHECKPOINT:
+            UNREACHABLE("Unsupported OperationType");
+        }
+    }
+    return true;
+}
+
+bool StorageManager::commitStaged()
+{
+    std::unique_ptr<std::array<RecordTable, STORAGE_SHARD_COUNT>> tables;
+    {
+        std::lock_guard<std::mutex> lock(stagingMutex_);
+        tables.swap(staged_);
+    }
+    if (tables == nullptr) {
+        LOG_ERROR << "Приём состояния хранилища не начат";
+        return false;
+    }
+
+    {
+        // До замены читатели видят прежнее содержимое хранилища целиком, а после - принятое
+        std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(shards_.size());
+        for (auto &shard : shards_) {
+            locks.emplace_back(shard.mutex);
+        }
+        size_t count = 0;
+        for (size_t shardId = 0; shardId < STORAGE_SHARD_COUNT; shardId++) {
+            auto &shard = shards_[shardId];
+            std::swap(shard.data, (*tables)[shardId]);
+            shard.dirty.clear();
+            count += shard.data.size();
+        }
+        entriesCount_ = count;
+        // Замена не записана в журнал, поэтому следующий снапшот должен быть полным
+        chainCheckpointId_.reset();
+    }
+    LOG_INFO << "Содержимое хранилища заменено принятым состоянием, записей: " << entriesCount_;
+
+    // Прежние значения больше не доступны читателям
+    for (const auto &table : *tables) {
+        releaseValues(table);
+    }
+    return compactJournal();
+}
+
+std::filesystem::path StorageManager::getJournalPath() const
+{
+    return dataDir_ / JOURNAL_FILE_NAME;
+}
+
+std::optional<std::string> StorageManager::getLastCheckpointId() const
+{
+    return journalManager_.getLastCheckpointId();
+}
+
 bool StorageManager::createSnapshot()
 {
     LOG_INFO << "Создание снапшота хранилища";
 
-    // Копируем данные
-    std::unordered_map<std::string, std::string> dataCopy;
-    {
-        std::shared_lock<std::shared_mutex> lock(storageMutex_);
-        dataCopy = dataStore_;
+    std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+    return do_createSnapshot(false);
+}
+
+bool StorageManager::createDeltaSnapshot()
+{
+    std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+
+    // Цепочка объединяется записью нового базового снапшота из памяти: это дешевле чтения и
+    // слияния файлов цепочки и даёт тот же результат. Без файла базового снапшота (например,
+    // удалённого вручную) разностный снапшот бесполезен
+    std::error_code ec;
+    if (!chainCheckpointId_.has_value() || deltaCount_ >= snapshotDeltaLimit_
+        || deltaBytes_ >= baseBytes_ || !std::filesystem::exists(snapshotPath_, ec)) {
+        LOG_INFO << "Создание базового снапшота хранилища, разностных снапшотов в цепочке: "
+                 << deltaCount_;
+        return do_createSnapshot(false);
     }
 
+    LOG_INFO << "Создание разностного снапшота хранилища";
+    return do_createDeltaSnapshot();
+}
+
+bool StorageManager::compactJournal()
+{
+    LOG_INFO << "Уплотнение журнала операций";
+
+    std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+    // Операции, выполненные во время уплотнения, будут учтены уже для нового сегмента
+    operationsSinceLastCompaction_ = 0;
+
+    std::string checkpointId;
+    if (!do_createSnapshot(true, &checkpointId)) {
+        LOG_ERROR << "Ошибка уплотнения журнала: не удалось создать снапшот";
+        return false;
+    }
+
+    // Снапшот уже сохранён на диске, поэтому сегменты до его контрольной точки больше не нужны
+    // для восстановления и удаляются без чтения
+    if (!journalManager_.removeSegmentsBeforeCheckpoint(checkpointId)) {
+        LOG_ERROR << "Ошибка уплотнения журнала: не удалось удалить старые сегменты";
+        return false;
+    }
+
+    LOG_INFO << "Журнал успешно уплотнен, контрольная точка: " << checkpointId;
+    return true;
+}
+
+bool StorageManager::compactValueLog()
+{
+    std::lock_guard<std::mutex> creationLock(snapshotCreationMutex_);
+    return do_compactValueLog();
+}
+
+ValueLogStats StorageManager::getValueLogStats() const
+{
+    return valueLog_.stats();
+}
+
+bool StorageManager::do_compactValueLog()
+{
+    const auto segments = valueLog_.collectableSegments();
+    if (segments.empty()) {
+        return true;
+    }
+    LOG_INFO << "Уплотнение журнала значений, сегментов: " << segments.size();
+
+    size_t moved = 0;
+    bool retired = false;
+    for (const auto segment : segments) {
+        // Записи сегмента, на которые ещё ссылается хранилище, переносятся в активный сегмент.
+        // Значение читается и дописывается вне блокировки, а положение заменяется, только если
+        // запись за это время не изменилась
+        valueLog_.scanSegment(segment, [this, &moved](const Uuid &key,
+                                                      const ValueLocation &location) {
+            auto &shard = shardFor(key);
+            {
+                std::shared_lock<std::shared_mutex> lock(shard.mutex);
+                const auto *value = shard.data.find(key);
+                if (value == nullptr || value->location() != location) {
+                    return;
+                }
+            }
+            std::string data;
+            if (!valueLog_.read(key, location, data)) {
+                return;
+            }
+            const auto pin = valueLog_.pinSegments();
+            const auto newLocation = valueLog_.append(key, data);
+            if (!newLocation.has_value()) {
+                return;
+            }
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
+            auto *value = shard.data.find(key);
+            if (value == nullptr || value->location() != location) {
+                return;
+            }
+            assignValue(*value, data, newLocation);
+            // Разностный снапшот должен ссылаться на новое положение значения
+            shard.dirty.insert(key);
+            moved++;
+        });
+
+        // Сегмент выводится из использования, только если на него больше нет ссылок
+        if (valueLog_.retireSegment(segment)) {
+            retiredValueSegments_.push_back(segment);
+            retired = true;
+        }
+        else {
+            LOG_WARNING << "Сегмент журнала значений " << segment
+                        << " ещё используется, уплотнение отложено";
+        }
+    }
+    if (!retired) {
+        return false;
+    }
+
+    // Файлы выведенных сегментов удаляются после записи полного снапшота, который на них уже
+    // не ссылается
+    if (!do_createSnapshot(false)) {
+        LOG_ERROR << "Ошибка уплотнения журнала значений: не удалось создать снапшот";
+        return false;
+    }
+    LOG_INFO << "Журнал значений успешно уплотнен, перенесено значений: " << moved;
+    return true;
+}
+
+bool StorageManager::do_createSnapshot(bool startNewSegment, std::string *checkpointId)
+{
+    ScopedLatency latency(MetricHistogram::SNAPSHOT);
+    const auto mode = snapshotMode_.load();
+    const auto codec = compressionCodec_.load();
+
     // Генерируем идентификатор снапшота
     const auto snapshotId = uuidGenerator_.generateUuid();
 
-    // Записываем снапшот на диск
-    if (!writeSnapshotToDisk(dataCopy)) {
-        LOG_ERROR << "Ошибка создания снапшота: не удалось записать снапшот на диск";
+    uint64_t checkpointSequence = 0;
+    bool valueLog = false;
+    std::vector<RecordTable> dataCopy;
+#if defined(OCTET_PLATFORM_UNIX)
+    std::string tempPath;
+    pid_t childPid = -1;
+#endif
+    {
+        // Писатели резервируют номер записи журнала под эксклюзивной блокировкой сегмента,
+        // поэтому под разделяемыми блокировками всех сегментов номер контрольной точки попадает
+        // ровно после номеров всех операций, вошедших в снапшот. Блокировки захватываются в
+        // порядке сегментов, как и писателями пакетов, поэтому взаимоблокировок нет
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(shards_.size());
+        std::vector<const RecordTable *> tables;
+        tables.reserve(shards_.size());
+        for (auto &shard : shards_) {
+            locks.emplace_back(shard.mutex);
+            tables.push_back(&shard.data);
+            // Полный снапшот включает все изменения сегмента
+            shard.dirty.clear();
+        }
+        checkpointSequence = journalManager_.reserveSequence();
+        // Записи ссылаются на журнал значений, только если у него есть сегменты
+        valueLog = valueLog_.hasSegments();
+
+#if defined(OCTET_PLATFORM_UNIX)
+        if (mode == SnapshotMode::FORK) {
+            tempPath = snapshotPath_.string() + ".tmp." + snapshotId;
+            // Дочерний процесс получает образ памяти на момент fork, а страницы копируются
+            // только при их изменении родителем, поэтому писатели блокируются лишь на время fork
+            childPid = fork();
+            if (childPid == 0) {
+                _exit(writeSnapshotInChild(tempPath.c_str(), tables, snapshotId, codec, valueLog,
+                                           journalManager_.getIoBackend())
+                          ? 0
+                          : 1);
+            }
+            if (childPid < 0) {
+                LOG_WARNING << "Не удалось создать процесс для записи снапшота, ошибка: "
+                            << errnoToString(errno) << ", копируем данные в памяти";
+            }
+        }
+        if (childPid < 0)
+#endif
+        {
+            dataCopy.reserve(tables.size());
+            for (const auto *table : tables) {
+                dataCopy.push_back(*table);
+            }
+        }
+    }
+
+    // Ставим контрольную точку в журнал уже вне блокировок: её место в журнале задаёт номер
+    const auto checkpointTicket
+        = journalManager_.submitCheckpoint(checkpointSequence, snapshotId, startNewSegment);
+
+    // Снапшот не должен появиться на диске раньше своей контрольной точки, иначе после сбоя
+    // операции после снапшота нельзя будет найти в журнале
+    const auto checkpointWritten = journalManager_.waitForCheckpoint(checkpointTicket, snapshotId);
+    // Значения, на которые ссылается снапшот, фиксируются на диске раньше него
+    const auto valuesWritten = !valueLog || valueLog_.sync();
+    if (!valuesWritten) {
+        LOG_ERROR << "Не удалось зафиксировать журнал значений на диске";
+    }
+
+    bool snapshotWritten = false;
+#if defined(OCTET_PLATFORM_UNIX)
+    if (childPid > 0) {
+        // Дожидаемся дочернего процесса в любом случае, чтобы не оставлять зомби-процессов
+        snapshotWritten = waitForSnapshotChild(childPid);
+        if (!snapshotWritten) {
+            LOG_ERROR << "Процесс записи снапшота завершился с ошибкой";
+        }
+        snapshotWritten = snapshotWritten && checkpointWritten && valuesWritten
+                          && utils::replaceFileDurably(tempPath, snapshotPath_);
+        if (!snapshotWritten) {
+            std::error_code ec;
+            std::filesystem::remove(tempPath, ec);
+        }
+        else {
+            LOG_INFO << "Снапшот успешно записан на диск дочерним процессом";
+        }
+    }
+    else
+#endif
+    {
+        std::vector<const RecordTable *> tables;
+        tables.reserve(dataCopy.size());
+        for (const auto &table : dataCopy) {
+            tables.push_back(&table);
+        }
+        snapshotWritten = checkpointWritten && valuesWritten
+                          && writeSnapshotToDisk(tables, snapshotId, codec, valueLog);
+    }
+
+    if (!checkpointWritten || !snapshotWritten) {
+        LOG_ERROR << (!checkpointWritten
+                          ? "Ошибка создания снапшота: не удалось записать операцию в журнал"
+                          : "Ошибка создания снапшота: не удалось записать снапшот на диск");
+        // Изменения сегментов уже не отслеживаются, поэтому следующий снапшот будет полным
+        chainCheckpointId_ = std::nullopt;
+        Metrics::getInstance().increment(MetricCounter::SNAPSHOT_FAILURES);
         return false;
     }
 
-    // Записываем контрольную точку в журнал
-    if (!journalManager_.writeCheckpoint(snapshotId)) {
+    // Базовый снапшот начинает новую цепочку, а разностные снапшоты прежней больше не нужны
+    std::error_code ec;
+    const auto baseSize = std::filesystem::file_size(snapshotPath_, ec);
+    baseBytes_ = ec ? 0 : baseSize;
+    Metrics::getInstance().increment(MetricCounter::SNAPSHOT_BYTES, baseBytes_);
+    Metrics::getInstance().setGauge(MetricGauge::SNAPSHOT_SIZE, static_cast<int64_t>(baseBytes_));
+    deltaCount_ = 0;
+    deltaBytes_ = 0;
+    nextDeltaNumber_ = 1;
+    chainCheckpointId_ = removeDeltaSnapshots() ? std::optional<std::string>(snapshotId)
+                                                : std::nullopt;
+    // Читатели из других процессов заново загружают хранилище с нового базового снапшота
+    generation_.advanceSnapshot();
+    // Выведенные из использования сегменты журнала значений больше не нужны ни одному снапшоту
+    if (!retiredValueSegments_.empty() && valueLog_.removeSegments(retiredValueSegments_)) {
+        retiredValueSegments_.clear();
+    }
+
+    // Сбрасываем счетчик операций и обновляем время последнего снапшота
+    operationsSinceLastSnapshot_ = 0;
+    lastSnapshotTime_ = std::chrono::steady_clock::now();
+
+    if (checkpointId != nullptr) {
+        *checkpointId = snapshotId;
+    }
+    LOG_INFO << "Снапшот успешно создан, UUID: " << snapshotId;
+    return true;
+}
+
+bool StorageManager::do_createDeltaSnapshot()
+{
+    ScopedLatency latency(MetricHistogram::DELTA_SNAPSHOT);
+    const auto codec = compressionCodec_.load();
+
+    // Генерируем идентификатор снапшота
+    const auto snapshotId = uuidGenerator_.generateUuid();
+
+    uint64_t checkpointSequence = 0;
+    std::vector<SnapshotChange> changes;
+    {
+        // Номер контрольной точки резервируется под разделяемыми блокировками всех сегментов, как
+        // и для полного снапшота, но копируются только записи, изменённые после предыдущего
+        // снапшота цепочки
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(shards_.size());
+        for (auto &shard : shards_) {
+            locks.emplace_back(shard.mutex);
+            for (const auto &key : shard.dirty) {
+                if (const auto *value = shard.data.find(key)) {
+                    changes.push_back(
+                        { key, false, std::string(value->view()), value->location() });
+                }
+                else {
+                    changes.push_back({ key, true, std::string(), std::nullopt });
+                }
+            }
+            shard.dirty.clear();
+        }
+        if (!changes.empty()) {
+            checkpointSequence = journalManager_.reserveSequence();
+        }
+    }
+    const auto valueLog = std::any_of(changes.begin(), changes.end(),
+                                      [](const auto &change) { return change.location; });
+
+    if (changes.empty()) {
+        LOG_INFO << "Изменений после предыдущего снапшота нет, разностный снапшот не нужен";
+        operationsSinceLastSnapshot_ = 0;
+        lastSnapshotTime_ = std::chrono::steady_clock::now();
+        return true;
+    }
+
+    const auto checkpointTicket
+        = journalManager_.submitCheckpoint(checkpointSequence, snapshotId, false);
+    if (!journalManager_.waitForCheckpoint(checkpointTicket, snapshotId)) {
         LOG_ERROR << "Ошибка создания снапшота: не удалось записать операцию в журнал";
+        chainCheckpointId_ = std::nullopt;
+        Metrics::getInstance().increment(MetricCounter::SNAPSHOT_FAILURES);
         return false;
     }
 
+    // Разностный снапшот мал, поэтому записывается в текущем процессе независимо от режима
+    std::string serializedData;
+    const auto serialized = writeSnapshotEntries(
+        snapshotId, &*chainCheckpointId_, codec, valueLog,
+        [&changes](auto &&emit) {
+            for (const auto &change : changes) {
+                emit(change.key, change.value, change.removed,
+                     change.location ? &*change.location : nullptr);
+            }
+        },
+        [&serializedData](const char *chunk, size_t size) {
+            serializedData.append(chunk, size);
+            return true;
+        });
+    const auto path = deltaSnapshotPath(snapshotPath_, nextDeltaNumber_);
+    if (!serialized || (valueLog && !valueLog_.sync())
+        || !utils::atomicFileWrite(path, serializedData)) {
+        LOG_ERROR << "Ошибка создания снапшота: не удалось записать разностный снапшот на диск";
+        chainCheckpointId_ = std::nullopt;
+        Metrics::getInstance().increment(MetricCounter::SNAPSHOT_FAILURES);
+        return false;
+    }
+
+    chainCheckpointId_ = snapshotId;
+    deltaCount_++;
+    deltaBytes_ += serializedData.size();
+    Metrics::getInstance().increment(MetricCounter::SNAPSHOT_BYTES, serializedData.size());
+    Metrics::getInstance().setGauge(MetricGauge::DELTA_SNAPSHOT_SIZE,
+                                    static_cast<int64_t>(serializedData.size()));
+    nextDeltaNumber_++;
+
     // Сбрасываем счетчик операций и обновляем время последнего снапшота
     operationsSinceLastSnapshot_ = 0;
     lastSnapshotTime_ = std::chrono::steady_clock::now();
 
-    LOG_INFO << "Снапшот успешно создан, UUID: " << snapshotId;
+    LOG_INFO << "Разностный снапшот успешно создан, UUID: " << snapshotId
+             << ", изменений: " << changes.size() << ", файл: " << path.string();
     return true;
 }
 
-bool StorageManager::writeSnapshotToDisk(const std::unordered_map<std::string, std::string> &data)
+bool StorageManager::removeDeltaSnapshots()
+{
+    bool success = true;
+    for (const auto &[number, path] : listDeltaSnapshots(snapshotPath_)) {
+        std::error_code ec;
+        if (!std::filesystem::remove(path, ec) && ec) {
+            LOG_ERROR << "Не удалось удалить разностный снапшот: " << path.string()
+                      << ", сообщение: " << ec.message();
+            success = false;
+        }
+    }
+    return success;
+}
+
+bool StorageManager::writeSnapshotToDisk(const std::vector<const RecordTable *> &data,
+                                         const std::string &checkpointId, CompressionCodec codec,
+                                         bool valueLog)
 {
     LOG_DEBUG << "Запись снапшота на диск: " << snapshotPath_.string();
 
     // Сериализуем данные
-    const auto serializedData = serializeMap(data);
+    std::string serializedData;
+    const auto serialized = writeSnapshotTo(
+        data, checkpointId, codec, valueLog, [&serializedData](const char *chunk, size_t size) {
+            serializedData.append(chunk, size);
+            return true;
+        });
+    if (!serialized) {
+        LOG_ERROR << "Не удалось сжать снапшот алгоритмом " << utils::compressionCodecName(codec);
+        return false;
+    }
 
     // Записываем снапшот атомарно
     if (!utils::atomicFileWrite(snapshotPath_, serializedData)) {
@@ -352,7 +1953,11 @@ bool StorageManager::writeSnapshotToDisk(const std::unordered_map<std::string, s
         return false;
     }
 
-    LOG_INFO << "Снапшот успешно записан на диск, записей: " << data.size();
+    size_t entriesCount = 0;
+    for (const auto *table : data) {
+        entriesCount += table->size();
+    }
+    LOG_INFO << "Снапшот успешно записан на диск, записей: " << entriesCount;
     return true;
 }
 
@@ -362,19 +1967,39 @@ void StorageManager::snapshotThreadFunction()
 
     while (!shutdownRequested_) {
         bool shouldCreateSnapshot = false;
+        bool shouldCompactJournal = false;
 
         {
             std::unique_lock<std::mutex> lock(snapshotMutex_);
 
-            // Ждем уведомления или таймаута
-            snapshotCondition_.wait_for(
-                lock, std::chrono::minutes(snapshotTimeThresholdMinutes_),
-                [this] { return snapshotRequested_ || shutdownRequested_; });
+            // Ждем уведомления или таймаута (возраст сегмента журнала проверяется не реже, чем
+            // задано для его уплотнения)
+            auto waitMinutes = snapshotTimeThresholdMinutes_.load();
+            const auto compactionMinutes = compactionTimeThresholdMinutes_.load();
+            if (compactionMinutes > 0 && compactionMinutes < waitMinutes) {
+                waitMinutes = compactionMinutes;
+            }
+            snapshotCondition_.wait_for(lock, std::chrono::minutes(waitMinutes), [this] {
+                return snapshotRequested_ || compactionRequested_ || shutdownRequested_;
+            });
 
             shouldCreateSnapshot = snapshotRequested_;
             snapshotRequested_ = false;
+            shouldCompactJournal = compactionRequested_;
+            compactionRequested_ = false;
+        }
+
+        // Уплотнение журнала само создаёт снапшот, поэтому отдельный снапшот уже не нужен
+        if (shouldCompactJournal || isJournalCompactionDue()) {
+            LOG_INFO << "Автоматическое уплотнение журнала, размер журнала: "
+                     << journalManager_.getJournalSize() << " байт";
+            compactJournal();
+            continue;
         }
 
+        // Запечатанные с прошлого пробуждения сегменты журнала сжимаются вне пути записи
+        journalManager_.compressSealedSegments();
+
         // Если запрошен снапшот или прошло достаточное время
         const auto now = std::chrono::steady_clock::now();
         const auto timeSinceLastSnapshot
@@ -384,7 +2009,12 @@ void StorageManager::snapshotThreadFunction()
         if (shouldCreateSnapshot || (timeElapsed && operationsSinceLastSnapshot_ > 0)) {
             LOG_INFO << "Создание автоматического снапшота, операций с последнего: "
                      << operationsSinceLastSnapshot_;
-            createSnapshot();
+            createDeltaSnapshot();
+        }
+
+        // Сегменты журнала значений, в которых преобладают устаревшие значения, уплотняются
+        if (!valueLog_.collectableSegments().empty()) {
+            compactValueLog();
         }
     }
 
@@ -399,10 +2029,21 @@ void StorageManager::requestSnapshotAsync()
     LOG_DEBUG << "Запрошено асинхронное создание снапшота";
 }
 
-void StorageManager::notifyOperation()
+void StorageManager::notifyOperation(size_t count)
 {
     // Увеличиваем счетчик операций
-    size_t currentOperations = ++operationsSinceLastSnapshot_;
+    size_t currentOperations = operationsSinceLastSnapshot_ += count;
+    operationsSinceLastCompaction_ += count;
+
+    // Если журнал пора уплотнить - запрашиваем уплотнение (оно включает и создание снапшота)
+    if (!compactionRequested_ && isJournalCompactionDue()) {
+        LOG_DEBUG << "Достигнут порог уплотнения журнала, запрашиваем уплотнение";
+        std::lock_guard<std::mutex> lock(snapshotMutex_);
+        compactionRequested_ = true;
+        snapshotCondition_.notify_one();
+        return;
+    }
+
     // Если достигли порога - запрашиваем снапшот
     if (currentOperations >= snapshotOperationsThreshold_) {
         LOG_DEBUG << "Достигнут порог операций (" << currentOperations << "), запрашиваем снапшот";
@@ -410,10 +2051,24 @@ void StorageManager::notifyOperation()
     }
 }
 
+bool StorageManager::isJournalCompactionDue() const
+{
+    // Без новых операций уплотнение не уменьшит журнал
+    if (operationsSinceLastCompaction_ == 0) {
+        return false;
+    }
+
+    const auto sizeThreshold = compactionSizeThresholdBytes_.load();
+    if (sizeThreshold > 0 && journalManager_.getJournalSize() >= sizeThreshold) {
+        return true;
+    }
+    const auto minutes = compactionTimeThresholdMinutes_.load();
+    return minutes > 0 && journalManager_.getActiveSegmentAge() >= std::chrono::minutes(minutes);
+}
+
 size_t StorageManager::getEntriesCount() const
 {
-    std::shared_lock<std::shared_mutex> lock(storageMutex_);
-    return dataStore_.size();
+    return entriesCount_.load(std::memory_order_relaxed);
 }
 
 void StorageManager::setSnapshotOperationsThreshold(size_t threshold)
@@ -428,6 +2083,47 @@ void StorageManager::setSnapshotOperationsThreshold(size_t threshold)
     }
 }
 
+void StorageManager::setSnapshotMode(SnapshotMode mode)
+{
+    snapshotMode_ = mode;
+    LOG_INFO << "Установлен способ создания снапшотов: "
+             << (mode == SnapshotMode::FORK ? "fork" : "copy");
+}
+
+void StorageManager::setSnapshotDeltaLimit(size_t count)
+{
+    snapshotDeltaLimit_ = count;
+    LOG_INFO << "Установлено количество разностных снапшотов до объединения цепочки: " << count;
+}
+
+void StorageManager::setJournalCompactionSizeThreshold(uint64_t bytes)
+{
+    compactionSizeThresholdBytes_ = bytes;
+    LOG_INFO << "Установлен новый размер журнала для уплотнения: " << bytes << " байт";
+}
+
+void StorageManager::setJournalCompactionTimeThreshold(size_t minutes)
+{
+    compactionTimeThresholdMinutes_ = minutes;
+    LOG_INFO << "Установлен новый возраст сегмента журнала для уплотнения: " << minutes
+             << " минут";
+}
+
+bool StorageManager::setCompressionCodec(CompressionCodec codec)
+{
+    if (!journalManager_.setCompressionCodec(codec)) {
+        return false;
+    }
+    compressionCodec_ = codec;
+    LOG_INFO << "Установлен алгоритм сжатия снапшотов: " << utils::compressionCodecName(codec);
+    return true;
+}
+
+void StorageManager::setJournalSegmentSize(uint64_t bytes)
+{
+    journalManager_.setSegmentSize(bytes);
+}
+
 void StorageManager::setSnapshotTimeThreshold(size_t minutes)
 {
     snapshotTimeThresholdMinutes_ = minutes;
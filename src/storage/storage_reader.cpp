@@ -0,0 +1,566 @@
+#include "storage/storage_reader.hpp"
+
+#include <algorithm>
+#include <map>
+#include <stdexcept>
+#include <unordered_set>
+#include <utility>
+
+#include "storage/journal_manager.hpp"
+#include "storage/record_table.hpp"
+#include "storage/snapshot_format.hpp"
+#include "storage/uuid.hpp"
+#include "storage/value_log.hpp"
+#include "utils/compiler.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/mapped_file.hpp"
+#include "utils/parallel.hpp"
+#include "logger.hpp"
+
+namespace {
+// Количество попыток загрузки, если писатель заменяет снапшот во время неё
+static constexpr size_t LOAD_ATTEMPTS = 3;
+
+/**
+ * @struct BaseSnapshotInfo
+ * @brief Результат загрузки базового снапшота
+ */
+struct BaseSnapshotInfo {
+    std::optional<std::string> checkpointId; // Контрольная точка снапшота
+    bool versioned = false; // Записан ли снапшот в формате v2
+    bool damaged = false; // Были ли пропущены повреждённые блоки
+};
+} // namespace
+
+namespace octet {
+/**
+ * @struct StorageReader::State
+ * @brief Загруженное состояние хранилища: индекс отображенного базового снапшота и изменения
+ * поверх него
+ */
+struct StorageReader::State {
+    State(const std::filesystem::path &journalPath, const std::filesystem::path &logPath)
+        : journal(journalPath)
+        , valueLogPath(logPath)
+    {
+    }
+
+    // Отображение базового снапшота формата v2, на которое ссылается индекс
+    std::unique_ptr<utils::MappedFile> snapshot;
+    // Распакованные блоки сжатого снапшота (по одному на блок, поэтому строки не перемещаются)
+    std::vector<std::string> decompressedBlocks;
+    // Записи базового снапшота, упорядоченные по ключу
+    std::vector<std::pair<Uuid, std::string_view>> index;
+    // Записи, добавленные или изменённые после базового снапшота (значения скопированы)
+    RecordTable overlay;
+    // Записи базового снапшота, удалённые после него
+    std::unordered_set<Uuid> removed;
+    // Количество записей с учётом изменений
+    size_t entriesCount = 0;
+    // Положение в журнале
+    JournalReader journal;
+    // Путь к журналу значений писателя
+    std::filesystem::path valueLogPath;
+    // Отображения сегментов журнала значений, на которые ссылается индекс
+    std::map<uint32_t, std::unique_ptr<utils::MappedFile>> valueSegments;
+    // Прежние отображения дописанных сегментов (на них могут ссылаться записи индекса)
+    std::vector<std::unique_ptr<utils::MappedFile>> staleValueSegments;
+
+    // Отображение сегментов журнала значений (уже отображённые сегменты отображаются заново,
+    // только если remap и они выросли после отображения)
+    void mapValueSegments(bool remap)
+    {
+        for (const auto &[number, path] : ValueLog::listSegments(valueLogPath)) {
+            auto &segment = valueSegments[number];
+            if (segment != nullptr) {
+                std::error_code ec;
+                const auto size = std::filesystem::file_size(path, ec);
+                if (!remap || ec || size == segment->view().size()) {
+                    continue;
+                }
+            }
+            auto file = std::make_unique<utils::MappedFile>(path, false);
+            if (!file->isMapped() || !ValueLog::isSegment(file->view())) {
+                continue;
+            }
+            if (segment != nullptr) {
+                staleValueSegments.push_back(std::move(segment));
+            }
+            segment = std::move(file);
+        }
+    }
+
+    // Поиск значения в отображённом сегменте журнала значений
+    std::optional<std::string_view> findValue(const Uuid &key,
+                                              const ValueLocation &location) const
+    {
+        const auto it = valueSegments.find(location.segment);
+        if (it == valueSegments.end() || it->second == nullptr) {
+            return std::nullopt;
+        }
+        return ValueLog::recordValue(it->second->view(), key, location);
+    }
+
+    // Поиск записи базового снапшота
+    std::optional<std::string_view> findBase(const Uuid &key) const
+    {
+        const auto it = std::lower_bound(
+            index.begin(), index.end(), key,
+            [](const std::pair<Uuid, std::string_view> &entry, const Uuid &value) {
+                return entry.first < value;
+            });
+        if (it == index.end() || !(it->first == key)) {
+            return std::nullopt;
+        }
+        return it->second;
+    }
+
+    // Поиск записи с учётом изменений
+    std::optional<std::string_view> find(const Uuid &key) const
+    {
+        if (const auto *value = overlay.find(key)) {
+            return value->view();
+        }
+        if (removed.count(key) != 0) {
+            return std::nullopt;
+        }
+        return findBase(key);
+    }
+
+    // Добавление или изменение записи
+    void upsert(const Uuid &key, std::string_view value)
+    {
+        if (!find(key).has_value()) {
+            entriesCount++;
+        }
+        overlay.insertOrAssign(key, value);
+        removed.erase(key);
+    }
+
+    // Удаление записи
+    bool erase(const Uuid &key)
+    {
+        if (!find(key).has_value()) {
+            return false;
+        }
+        overlay.erase(key);
+        if (findBase(key).has_value()) {
+            removed.insert(key);
+        }
+        entriesCount--;
+        return true;
+    }
+
+    // Применение операции журнала
+    bool apply(const JournalEntryView &entry)
+    {
+        const auto key = Uuid::fromString(entry.uuid);
+        if (!key.has_value()) {
+            return false;
+        }
+        switch (entry.type) {
+        case OperationType::INSERT:
+            upsert(*key, entry.data);
+            return true;
+        case OperationType::UPDATE:
+            if (!find(*key).has_value()) {
+                return false;
+            }
+            upsert(*key, entry.data);
+            return true;
+        case OperationType::REMOVE:
+            return erase(*key);
+        case OperationType::CHECKPOINT:
+            // Контрольные точки не применяются к хранилищу
+            return true;
+        }
+        UNREACHABLE("Unsupported OperationType");
+    }
+
+    /**
+     * @brief Загружает базовый снапшот: снапшот формата v2 отображается в память и индексируется,
+     * а записи снапшота прежнего формата копируются в изменения
+     * @param path Путь к файлу снапшота
+     * @param[out] info Контрольная точка снапшота и результат загрузки
+     * @return true если снапшот загружен (возможно, частично)
+     */
+    bool loadBase(const std::filesystem::path &path, BaseSnapshotInfo &info)
+    {
+        // Блоки разбираются несколькими потоками, а затем читаются в случайном порядке
+        snapshot = std::make_unique<utils::MappedFile>(path, false);
+        if (!snapshot->isMapped()) {
+            LOG_ERROR << "Ошибка чтения файла снапшота";
+            return false;
+        }
+        const auto content = snapshot->view();
+        if (!isVersionedSnapshot(content)) {
+            LOG_INFO << "Снапшот записан в прежнем формате, загружаем";
+            auto data = deserializeLegacySnapshot(content, info.checkpointId);
+            snapshot.reset();
+            if (!data.has_value()) {
+                LOG_ERROR << "Данные снапшота повреждены или имеют некорректный формат";
+                return false;
+            }
+            for (const auto &[uuid, value] : *data) {
+                const auto key = Uuid::fromString(uuid);
+                if (!key.has_value()) {
+                    LOG_WARNING << "Пропущена запись с некорректным UUID: " << uuid.substr(0, 64);
+                    continue;
+                }
+                upsert(*key, value);
+            }
+            return true;
+        }
+
+        SnapshotLayout layout;
+        CompressionCodec codec = CompressionCodec::NONE;
+        if (!parseSnapshotLayout(content, layout)) {
+            LOG_ERROR << "Данные снапшота повреждены или имеют некорректный формат";
+            return false;
+        }
+        if (!checkSnapshotLayout(layout, std::nullopt, codec)) {
+            return false;
+        }
+
+        // Значения несжатого снапшота ссылаются прямо на отображение, а значения из журнала
+        // значений - на отображения его сегментов. Писатель фиксирует значения на диске раньше
+        // снапшота, поэтому отображённые сейчас сегменты содержат все значения снапшота
+        if (codec != CompressionCodec::NONE) {
+            decompressedBlocks.resize(layout.blocks.size());
+        }
+        if ((layout.flags & SNAPSHOT_FLAG_VALUE_LOG) != 0) {
+            mapValueSegments(false);
+        }
+        std::vector<std::vector<std::pair<Uuid, std::string_view>>> blocks(layout.blocks.size());
+        std::atomic<size_t> damagedBlocks{ 0 };
+        utils::parallelFor(layout.blocks.size(), [&](size_t i) {
+            const auto &block = layout.blocks[i];
+            auto &entries = blocks[i];
+            entries.reserve(block.entryCount);
+
+            std::string unused;
+            auto &decompressed = decompressedBlocks.empty() ? unused : decompressedBlocks[i];
+            std::string_view blockData;
+            bool resolved = true;
+            const auto valid
+                = readSnapshotBlock(content, block, codec, decompressed, blockData)
+                  && decodeSnapshotBlock(
+                      blockData, block.entryCount, layout.flags,
+                      [this, &entries, &resolved](const Uuid &key, std::string_view value, bool,
+                                                  const ValueLocation *location) {
+                          if (location == nullptr) {
+                              entries.emplace_back(key, value);
+                          }
+                          else if (const auto stored = findValue(key, *location)) {
+                              entries.emplace_back(key, *stored);
+                          }
+                          else {
+                              resolved = false;
+                          }
+                      })
+                  && resolved;
+            if (!valid) {
+                LOG_ERROR << "Блок снапшота " << i << " повреждён (смещение: " << block.offset
+                          << ", размер: " << block.size << " байт, записей: " << block.entryCount
+                          << ")";
+                entries.clear();
+                decompressed.clear();
+                damagedBlocks++;
+            }
+        });
+
+        size_t total = 0;
+        for (const auto &entries : blocks) {
+            total += entries.size();
+        }
+        index.reserve(total);
+        for (auto &entries : blocks) {
+            index.insert(index.end(), entries.begin(), entries.end());
+            std::vector<std::pair<Uuid, std::string_view>>().swap(entries);
+        }
+        std::sort(index.begin(), index.end(),
+                  [](const std::pair<Uuid, std::string_view> &lhs,
+                     const std::pair<Uuid, std::string_view> &rhs) {
+                      return lhs.first < rhs.first;
+                  });
+        entriesCount = index.size();
+
+        info.checkpointId = std::string(layout.checkpointId);
+        info.versioned = true;
+        info.damaged = damagedBlocks > 0;
+        if (info.damaged) {
+            LOG_ERROR << "Снапшот загружен частично, повреждено блоков: " << damagedBlocks
+                      << " из " << layout.blocks.size();
+        }
+        return true;
+    }
+
+    /**
+     * @brief Применяет разностный снапшот (его значения копируются в изменения)
+     * @param path Путь к файлу разностного снапшота
+     * @param[in,out] checkpointId Контрольная точка загруженной части цепочки
+     * @param[out] damaged Были ли пропущены повреждённые блоки
+     * @return true если снапшот применён (возможно, частично)
+     */
+    bool loadDelta(const std::filesystem::path &path, std::optional<std::string> &checkpointId,
+                   bool &damaged)
+    {
+        const utils::MappedFile file(path);
+        if (!file.isMapped()) {
+            LOG_ERROR << "Ошибка чтения файла снапшота";
+            return false;
+        }
+        const auto content = file.view();
+        SnapshotLayout layout;
+        CompressionCodec codec = CompressionCodec::NONE;
+        if (!isVersionedSnapshot(content) || !parseSnapshotLayout(content, layout)) {
+            LOG_ERROR << "Разностный снапшот имеет некорректный формат";
+            return false;
+        }
+        if (!checkSnapshotLayout(layout, checkpointId, codec)) {
+            return false;
+        }
+
+        // Значения разностного снапшота могли быть дописаны в сегменты журнала значений после
+        // их отображения, поэтому выросшие сегменты отображаются заново
+        if ((layout.flags & SNAPSHOT_FLAG_VALUE_LOG) != 0) {
+            mapValueSegments(true);
+        }
+
+        // Блоки применяются целиком, чтобы повреждённый блок не изменил часть записей
+        std::vector<std::pair<Uuid, std::optional<std::string_view>>> entries;
+        for (const auto &block : layout.blocks) {
+            entries.clear();
+            std::string decompressed;
+            std::string_view blockData;
+            bool resolved = true;
+            const auto valid
+                = readSnapshotBlock(content, block, codec, decompressed, blockData)
+                  && decodeSnapshotBlock(
+                      blockData, block.entryCount, layout.flags,
+                      [this, &entries, &resolved](const Uuid &key, std::string_view value,
+                                                  bool isRemoved, const ValueLocation *location) {
+                          if (isRemoved) {
+                              entries.emplace_back(key, std::nullopt);
+                          }
+                          else if (location == nullptr) {
+                              entries.emplace_back(key, value);
+                          }
+                          else if (const auto stored = findValue(key, *location)) {
+                              entries.emplace_back(key, *stored);
+                          }
+                          else {
+                              resolved = false;
+                          }
+                      })
+                  && resolved;
+            if (!valid) {
+                LOG_ERROR << "Блок разностного снапшота повреждён (смещение: " << block.offset
+                          << ", размер: " << block.size << " байт): " << path.string();
+                damaged = true;
+                continue;
+            }
+            for (const auto &[key, value] : entries) {
+                if (value.has_value()) {
+                    upsert(key, *value);
+                }
+                else {
+                    erase(key);
+                }
+            }
+        }
+        checkpointId = std::string(layout.checkpointId);
+        return true;
+    }
+};
+
+StorageReader::StorageReader(const std::filesystem::path &dataDir)
+    : dataDir_(dataDir)
+    , snapshotPath_(dataDir / SNAPSHOT_FILE_NAME)
+    , journalPath_(dataDir / JOURNAL_FILE_NAME)
+    , valueLogPath_(dataDir / VALUE_LOG_FILE_NAME)
+{
+    LOG_INFO << "Инициализация StorageReader, директория данных: " << dataDir_.string();
+
+    // Читатель не создаёт хранилище: его создаёт писатель
+    if (!utils::ensureDirectoryExists(dataDir_, false)) {
+        LOG_CRITICAL << "Директория данных не найдена: " << dataDir_.string();
+        throw std::runtime_error("Директория данных не найдена: " + dataDir_.string());
+    }
+    generation_ = std::make_unique<StorageGeneration>(dataDir_ / GENERATION_FILE_NAME);
+    if (!generation_->isMapped()) {
+        LOG_WARNING << "Счётчики поколений хранилища недоступны, журнал будет проверяться при "
+                       "каждом чтении";
+    }
+
+    seenJournal_ = generation_->journal();
+    uint64_t snapshotGeneration = 0;
+    bool complete = false;
+    state_ = loadState(snapshotGeneration, complete);
+    seenSnapshot_ = snapshotGeneration;
+    if (!complete) {
+        LOG_WARNING << "Не удалось полностью загрузить данные с диска";
+    }
+    LOG_INFO << "StorageReader успешно инициализирован, записей в хранилище: "
+             << state_->entriesCount;
+}
+
+StorageReader::~StorageReader() = default;
+
+std::optional<std::string> StorageReader::get(const std::string &uuid) const
+{
+    catchUp();
+
+    // Строка, не являющаяся UUID, не может быть ключом записи
+    const auto key = Uuid::fromString(uuid);
+    if (key.has_value()) {
+        std::shared_lock<std::shared_mutex> lock(stateMutex_);
+        if (const auto value = state_->find(*key)) {
+            return std::string(*value);
+        }
+    }
+    LOG_DEBUG << "Запись с UUID не найдена: " << uuid;
+    return std::nullopt;
+}
+
+std::vector<std::optional<std::string>>
+StorageReader::getMany(const std::vector<std::string> &uuids) const
+{
+    catchUp();
+
+    std::vector<std::optional<std::string>> result(uuids.size());
+    size_t missing = 0;
+    {
+        std::shared_lock<std::shared_mutex> lock(stateMutex_);
+        for (size_t i = 0; i < uuids.size(); i++) {
+            const auto key = Uuid::fromString(uuids[i]);
+            const auto value = key.has_value() ? state_->find(*key) : std::nullopt;
+            if (value.has_value()) {
+                result[i] = std::string(*value);
+            }
+            else {
+                missing++;
+            }
+        }
+    }
+    if (missing > 0) {
+        LOG_DEBUG << "Записи с UUID не найдены: " << missing << " из " << uuids.size();
+    }
+    return result;
+}
+
+size_t StorageReader::getEntriesCount() const
+{
+    catchUp();
+    std::shared_lock<std::shared_mutex> lock(stateMutex_);
+    return state_->entriesCount;
+}
+
+bool StorageReader::refresh()
+{
+    std::lock_guard<std::mutex> lock(refreshMutex_);
+    return do_refresh();
+}
+
+void StorageReader::catchUp() const
+{
+    // Без счётчиков изменения хранилища можно обнаружить только по самому журналу
+    if (generation_->isMapped() && generation_->journal() == seenJournal_
+        && generation_->snapshot() == seenSnapshot_) {
+        return;
+    }
+    // Если изменения уже дочитывает другой поток, читаем текущее состояние, не дожидаясь его
+    std::unique_lock<std::mutex> lock(refreshMutex_, std::try_to_lock);
+    if (lock.owns_lock()) {
+        do_refresh();
+    }
+}
+
+bool StorageReader::do_refresh() const
+{
+    // Счётчики запоминаются до чтения: изменения, сделанные во время него, будут дочитаны при
+    // следующем обращении
+    const auto snapshotGeneration = generation_->snapshot();
+    seenJournal_ = generation_->journal();
+
+    if (snapshotGeneration == seenSnapshot_) {
+        std::unique_lock<std::shared_mutex> lock(stateMutex_);
+        auto &state = *state_;
+        if (state.journal.poll([&state](const JournalEntryView &entry) {
+                return state.apply(entry);
+            })) {
+            return true;
+        }
+        LOG_INFO << "Положение в журнале потеряно, хранилище загружается заново";
+    }
+
+    // Новое состояние загружается без блокировки, поэтому чтение продолжается по прежнему, а
+    // прежнее состояние освобождается уже после её снятия
+    uint64_t loadedGeneration = 0;
+    bool complete = false;
+    auto state = loadState(loadedGeneration, complete);
+    size_t entriesCount = state->entriesCount;
+    {
+        std::unique_lock<std::shared_mutex> lock(stateMutex_);
+        state_.swap(state);
+    }
+    seenSnapshot_ = loadedGeneration;
+    LOG_INFO << "Хранилище загружено заново, записей: " << entriesCount;
+    return complete;
+}
+
+std::unique_ptr<StorageReader::State> StorageReader::loadState(uint64_t &snapshotGeneration,
+                                                               bool &complete) const
+{
+    std::unique_ptr<State> state;
+    for (size_t attempt = 0; attempt < LOAD_ATTEMPTS; attempt++) {
+        snapshotGeneration = generation_->snapshot();
+        state = std::make_unique<State>(journalPath_, valueLogPath_);
+        complete = do_loadState(*state);
+        // Писатель мог заменить снапшот во время загрузки, и тогда снапшоты цепочки и журнал
+        // могли быть прочитаны от разных снапшотов
+        if (complete && generation_->snapshot() == snapshotGeneration) {
+            return state;
+        }
+        LOG_DEBUG << "Хранилище изменилось во время загрузки, попытка " << (attempt + 1)
+                  << " из " << LOAD_ATTEMPTS;
+    }
+    return state;
+}
+
+bool StorageReader::do_loadState(State &state) const
+{
+    bool snapshotLoaded = false;
+    BaseSnapshotInfo snapshot;
+    if (utils::isFileReadable(snapshotPath_)) {
+        snapshotLoaded = state.loadBase(snapshotPath_, snapshot);
+        if (!snapshotLoaded) {
+            LOG_WARNING << "Не удалось загрузить снапшот, продолжаем без него";
+        }
+    }
+
+    // Как и при загрузке StorageManager, разностные снапшоты применяются только поверх
+    // неповреждённого базового снапшота формата v2
+    bool damaged = snapshot.damaged;
+    auto checkpointId = snapshot.checkpointId;
+    if (snapshotLoaded && snapshot.versioned && !damaged) {
+        for (const auto &[number, path] : listDeltaSnapshots(snapshotPath_)) {
+            if (!state.loadDelta(path, checkpointId, damaged) || damaged) {
+                LOG_WARNING << "Разностный снапшот не применён полностью, цепочка снапшотов "
+                               "прервана: "
+                            << path.string();
+                break;
+            }
+        }
+    }
+
+    // Повреждённый снапшот дополняется всем журналом. Журнал воспроизводится полностью и для
+    // снапшота прежнего формата без контрольной точки: повторное применение операций, уже
+    // вошедших в снапшот, приводит каждую запись к её последнему состоянию
+    const auto journalCheckpoint
+        = snapshotLoaded && !damaged ? checkpointId : std::optional<std::string>();
+    return state.journal.open(journalCheckpoint, [&state](const JournalEntryView &entry) {
+        return state.apply(entry);
+    });
+}
+} // namespace octet
@@ -0,0 +1,123 @@
+#include "storage/uuid.hpp"
+
+#include <cstring>
+
+namespace {
+static constexpr char HEX_DIGITS[] = "0123456789abcdef";
+
+// Индексы байтов, перед которыми в строковом представлении стоит дефис
+static constexpr size_t DASH_BEFORE_BYTES[] = { 4, 6, 8, 10 };
+
+// Позиции дефисов в строковом представлении
+static constexpr size_t DASH_POSITIONS[] = { 8, 13, 18, 23 };
+
+// Стоит ли дефис перед байтом с указанным индексом
+bool dashBeforeByte(size_t byte)
+{
+    for (const auto dashByte : DASH_BEFORE_BYTES) {
+        if (byte == dashByte) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Значение шестнадцатеричной цифры в нижнем регистре или -1
+int hexValue(char c)
+{
+    if (c >= '0' && c <= '9') {
+        return c - '0';
+    }
+    if (c >= 'a' && c <= 'f') {
+        return c - 'a' + 10;
+    }
+    return -1;
+}
+} // namespace
+
+namespace octet {
+Uuid Uuid::fromParts(uint64_t high, uint64_t low) noexcept
+{
+    // Байты хранятся в порядке их следования в строковом представлении
+    Uuid uuid;
+    for (size_t i = 0; i < 8; i++) {
+        uuid.bytes_[i] = static_cast<uint8_t>(high >> (56 - 8 * i));
+        uuid.bytes_[8 + i] = static_cast<uint8_t>(low >> (56 - 8 * i));
+    }
+    return uuid;
+}
+
+Uuid Uuid::fromBytes(const void *data) noexcept
+{
+    Uuid uuid;
+    std::memcpy(uuid.bytes_.data(), data, uuid.bytes_.size());
+    return uuid;
+}
+
+std::optional<Uuid> Uuid::fromString(std::string_view uuid) noexcept
+{
+    if (uuid.size() != STRING_LENGTH) {
+        return std::nullopt;
+    }
+    for (const auto position : DASH_POSITIONS) {
+        if (uuid[position] != '-') {
+            return std::nullopt;
+        }
+    }
+
+    Uuid result;
+    size_t position = 0;
+    for (size_t i = 0; i < result.bytes_.size(); i++) {
+        if (dashBeforeByte(i)) {
+            position++;
+        }
+        const auto high = hexValue(uuid[position]);
+        const auto low = hexValue(uuid[position + 1]);
+        if (high < 0 || low < 0) {
+            return std::nullopt;
+        }
+        result.bytes_[i] = static_cast<uint8_t>((high << 4) | low);
+        position += 2;
+    }
+    return result;
+}
+
+void Uuid::writeTo(char *out) const noexcept
+{
+    size_t position = 0;
+    for (size_t i = 0; i < bytes_.size(); i++) {
+        if (dashBeforeByte(i)) {
+            out[position++] = '-';
+        }
+        out[position++] = HEX_DIGITS[bytes_[i] >> 4];
+        out[position++] = HEX_DIGITS[bytes_[i] & 0x0F];
+    }
+}
+
+std::string Uuid::toString() const
+{
+    std::string result(STRING_LENGTH, '\0');
+    writeTo(result.data());
+    return result;
+}
+
+uint64_t Uuid::hash() const noexcept
+{
+    uint64_t high = 0;
+    uint64_t low = 0;
+    for (size_t i = 0; i < 8; i++) {
+        high = (high << 8) | bytes_[i];
+        low = (low << 8) | bytes_[8 + i];
+    }
+
+    // Перемешивание обеих половин (финализатор MurmurHash3): в UUID часть битов фиксирована, а
+    // часть зависит от времени, поэтому отдельные биты нельзя использовать напрямую
+    uint64_t hash = high ^ (low * 0x9E3779B97F4A7C15ULL);
+    hash ^= hash >> 33;
+    hash *= 0xFF51AFD7ED558CCDULL;
+    hash ^= hash >> 33;
+    hash *= 0xC4CEB9FE1A85EC53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+} // namespace octet
@@ -1,9 +1,8 @@
 #include "storage/uuid_generator.hpp"
 
 #include <chrono>
-#include <iomanip>
-#include <regex>
-#include <sstream>
+#include <random>
+#include <thread>
 
 namespace {
 // Получение текущего времени в виде количества тиков (единиц времени) с начала эпохи
@@ -11,14 +10,42 @@ uint64_t getCurrentTimestampInTicks()
 {
     return std::chrono::high_resolution_clock::now().time_since_epoch().count();
 }
+
+/**
+ * @class ThreadRandom
+ * @brief Генератор случайных чисел потока (SplitMix64): состояние из 64 бит, поэтому генерация
+ * не требует ни блокировок, ни выделения памяти.
+ */
+class ThreadRandom {
+public:
+    ThreadRandom()
+    {
+        // Потоки, созданные одновременно, получают разные начальные состояния за счёт энтропии
+        // ОС и идентификатора потока
+        std::random_device device;
+        state_ = (static_cast<uint64_t>(device()) << 32) ^ device() ^ getCurrentTimestampInTicks()
+                 ^ std::hash<std::thread::id>{}(std::this_thread::get_id());
+    }
+
+    uint64_t next()
+    {
+        uint64_t value = (state_ += 0x9E3779B97F4A7C15ULL);
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBULL;
+        return value ^ (value >> 31);
+    }
+
+private:
+    uint64_t state_;
+};
+
+thread_local ThreadRandom threadRandom;
 } // namespace
 
 namespace octet {
 UuidGenerator::UuidGenerator()
     : counter(0)
 {
-    // Инициализация генератора случайных чисел
-    rng.seed(getCurrentTimestampInTicks());
 }
 
 /**
@@ -33,45 +60,36 @@ UuidGenerator::UuidGenerator()
  *      - [fff] — 12 бит случайного числа
  * - [dddddddddddd] (12) — 48 бит случайного числа
  */
-std::string UuidGenerator::generateUuid()
+Uuid UuidGenerator::generate()
 {
     // Получение текущего времени с высоким разрешением
-    auto timestamp = getCurrentTimestampInTicks();
+    const auto timestamp = getCurrentTimestampInTicks();
 
     // Генерация случайного компонента
-    auto random = rng();
+    const auto random = threadRandom.next();
 
     // Увеличение счетчика, не требуем синхронизацию между потоками для увелечения
-    auto count = counter.fetch_add(1, std::memory_order_relaxed);
-
-    // Форматирование в формате UUID
-    std::stringstream ss;
-    ss << std::hex << std::setfill('0');
+    const auto count = counter.fetch_add(1, std::memory_order_relaxed);
 
-    // 8 символов из временной метки
-    ss << std::setw(8) << (timestamp & 0xFFFFFFFF) << "-";
-
-    // 4 символа из верхних битов временной метки
-    ss << std::setw(4) << ((timestamp >> 32) & 0xFFFF) << "-";
-
-    // Версия + 3 символа из счетчика
-    ss << "4" << std::setw(3) << (count & 0xFFF) << "-";
-
-    // Вариант + 3 символа из случайного числа
-    ss << std::setw(1) << (8 + (random & 0x3)) << std::setw(3) << ((random >> 2) & 0xFFF) << "-";
-
-    // 12 символов из случайного числа
-    ss << std::setw(12) << ((random >> 14) & 0xFFFFFFFFFFFF);
-
-    return ss.str();
+    // Временная метка, версия и счетчик
+    const uint64_t high = ((timestamp & 0xFFFFFFFF) << 32) | (((timestamp >> 32) & 0xFFFF) << 16)
+                          | 0x4000 | (count & 0xFFF);
+    // Вариант, 12 бит и затем 48 бит случайного числа
+    const uint64_t low = ((8 + (random & 0x3)) << 60) | (((random >> 2) & 0xFFF) << 48)
+                         | ((random >> 14) & 0xFFFFFFFFFFFF);
+    return Uuid::fromParts(high, low);
 }
 
-bool UuidGenerator::isValidUuid(const std::string &uuid)
+std::string UuidGenerator::generateUuid()
 {
-    // Регулярное выражение для проверки (регистр всех символов должен быть нижним)
-    static const std::regex uuidRegex(
-        R"(^[0-9a-f]{8}-[0-9a-f]{4}-4[0-9a-f]{3}-[89ab][0-9a-f]{3}-[0-9a-f]{12}$)");
+    return generate().toString();
+}
 
-    return std::regex_match(uuid, uuidRegex);
+bool UuidGenerator::isValidUuid(std::string_view uuid)
+{
+    // Все символы должны быть в нижнем регистре (это проверяет разбор строки), версия - 4, а
+    // вариант - из набора [8, 9, A, B]
+    const auto parsed = Uuid::fromString(uuid);
+    return parsed.has_value() && parsed->version() == 4 && (parsed->bytes()[8] >> 6) == 0x2;
 }
 } // namespace octet
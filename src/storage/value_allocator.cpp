@@ -0,0 +1,281 @@
+#include "storage/value_allocator.hpp"
+
+#include <cassert>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <new>
+
+namespace {
+// Классы с шагом 8 байт охватывают блоки до SMALL_LIMIT байт включительно
+static constexpr size_t SMALL_LIMIT = 128;
+static constexpr size_t SMALL_STEP = 8;
+static constexpr size_t SMALL_CLASS_COUNT
+    = (SMALL_LIMIT - octet::ValueAllocator::MIN_BLOCK_SIZE) / SMALL_STEP + 1;
+// Количество классов на каждую следующую степень двойки
+static constexpr size_t CLASSES_PER_DOUBLING = 4;
+static constexpr size_t SMALL_LIMIT_BITS = 7;
+static_assert(size_t(1) << SMALL_LIMIT_BITS == SMALL_LIMIT);
+static_assert(SMALL_CLASS_COUNT + CLASSES_PER_DOUBLING * 5 == octet::ValueAllocator::CLASS_COUNT);
+
+// Размер заголовка слэба: блоки начинаются с отдельной кэш-линии
+static constexpr size_t SLAB_HEADER_SIZE = 64;
+
+// Номер старшего установленного бита (значение не должно быть нулевым)
+size_t highestBit(size_t value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return sizeof(unsigned long long) * 8 - 1
+           - static_cast<size_t>(__builtin_clzll(static_cast<unsigned long long>(value)));
+#else
+    size_t index = 0;
+    while (value >>= 1) {
+        index++;
+    }
+    return index;
+#endif
+}
+} // namespace
+
+namespace octet {
+/**
+ * @struct ValueAllocator::Slab
+ * @brief Заголовок слэба, расположенный в его начале. Слэбы класса, в которых есть свободные
+ * блоки, связаны в двусвязный список
+ */
+struct ValueAllocator::Slab {
+    Slab *prev; // Предыдущий слэб в списке слэбов со свободными блоками
+    Slab *next; // Следующий слэб в списке слэбов со свободными блоками
+    char *freeList; // Освобождённые блоки (первые байты блока указывают на следующий)
+    uint32_t bumpOffset; // Смещение первого ещё не выданного блока
+    uint32_t liveBlocks; // Количество выданных блоков
+    uint32_t capacity; // Количество блоков в слэбе
+    uint32_t sizeClass; // Индекс класса размера
+};
+
+/**
+ * @struct ValueAllocator::SizeClass
+ * @brief Слэбы и статистика одного класса размера (на отдельной кэш-линии, чтобы потоки,
+ * работающие с разными классами, не делили её)
+ */
+struct alignas(64) ValueAllocator::SizeClass {
+    std::mutex mutex; // Мьютекс для защиты списка слэбов
+    Slab *partial = nullptr; // Слэбы со свободными блоками
+    Slab *spare = nullptr; // Пустой слэб в резерве
+    std::atomic<uint64_t> liveBytes{ 0 }; // Суммарная длина значений в блоках класса
+    std::atomic<uint64_t> liveBlocks{ 0 }; // Количество выданных блоков
+    std::atomic<uint64_t> slabs{ 0 }; // Количество слэбов, включая резервный
+};
+
+std::atomic<ValueAllocation> ValueAllocator::defaultAllocation_{ ValueAllocation::SLAB };
+
+ValueAllocator &ValueAllocator::getInstance()
+{
+    // Не разрушается при завершении процесса (см. описание класса)
+    static auto *instance = new ValueAllocator();
+    return *instance;
+}
+
+ValueAllocator::ValueAllocator()
+    : classes_(std::make_unique<SizeClass[]>(CLASS_COUNT))
+{
+}
+
+ValueAllocator::~ValueAllocator() = default;
+
+size_t ValueAllocator::sizeClass(size_t size) noexcept
+{
+    assert(size <= MAX_BLOCK_SIZE);
+    if (size <= SMALL_LIMIT) {
+        return size <= MIN_BLOCK_SIZE ? 0 : (size - MIN_BLOCK_SIZE + SMALL_STEP - 1) / SMALL_STEP;
+    }
+    // Интервал (2^bits, 2^(bits + 1)] делится на CLASSES_PER_DOUBLING равных классов
+    const auto bits = highestBit(size - 1);
+    const auto step = size_t(1) << (bits - 2);
+    return SMALL_CLASS_COUNT + (bits - SMALL_LIMIT_BITS) * CLASSES_PER_DOUBLING
+           + ((size - 1 - (size_t(1) << bits)) / step);
+}
+
+size_t ValueAllocator::classSize(size_t index) noexcept
+{
+    assert(index < CLASS_COUNT);
+    if (index < SMALL_CLASS_COUNT) {
+        return MIN_BLOCK_SIZE + index * SMALL_STEP;
+    }
+    const auto large = index - SMALL_CLASS_COUNT;
+    const auto bits = SMALL_LIMIT_BITS + large / CLASSES_PER_DOUBLING;
+    return (size_t(1) << bits) + (large % CLASSES_PER_DOUBLING + 1) * (size_t(1) << (bits - 2));
+}
+
+ValueAllocator::Slab *ValueAllocator::createSlab(size_t index)
+{
+    static_assert(sizeof(Slab) <= SLAB_HEADER_SIZE);
+    void *memory = std::aligned_alloc(SLAB_SIZE, SLAB_SIZE);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    auto *slab = static_cast<Slab *>(memory);
+    slab->prev = nullptr;
+    slab->next = nullptr;
+    slab->freeList = nullptr;
+    slab->bumpOffset = SLAB_HEADER_SIZE;
+    slab->liveBlocks = 0;
+    slab->capacity = static_cast<uint32_t>((SLAB_SIZE - SLAB_HEADER_SIZE) / classSize(index));
+    slab->sizeClass = static_cast<uint32_t>(index);
+    return slab;
+}
+
+char *ValueAllocator::allocate(size_t size, ValueAllocation allocation)
+{
+    if (allocation == ValueAllocation::HEAP || size > MAX_BLOCK_SIZE) {
+        auto *data = new char[size];
+        heapLiveBytes_.fetch_add(size, std::memory_order_relaxed);
+        return data;
+    }
+
+    const auto index = sizeClass(size);
+    auto &pool = classes_[index];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    auto *slab = pool.partial;
+    if (slab == nullptr) {
+        if (pool.spare != nullptr) {
+            slab = pool.spare;
+            pool.spare = nullptr;
+        }
+        else {
+            slab = createSlab(index);
+            pool.slabs.fetch_add(1, std::memory_order_relaxed);
+        }
+        pool.partial = slab;
+    }
+
+    char *block = nullptr;
+    if (slab->freeList != nullptr) {
+        block = slab->freeList;
+        std::memcpy(&slab->freeList, block, sizeof(char *));
+    }
+    else {
+        block = reinterpret_cast<char *>(slab) + slab->bumpOffset;
+        slab->bumpOffset += static_cast<uint32_t>(classSize(index));
+    }
+
+    // Заполненный слэб исключается из списка до освобождения одного из его блоков
+    if (++slab->liveBlocks == slab->capacity) {
+        pool.partial = slab->next;
+        if (slab->next != nullptr) {
+            slab->next->prev = nullptr;
+        }
+        slab->next = nullptr;
+    }
+    pool.liveBytes.fetch_add(size, std::memory_order_relaxed);
+    pool.liveBlocks.fetch_add(1, std::memory_order_relaxed);
+    return block;
+}
+
+void ValueAllocator::deallocate(char *data, size_t size, ValueAllocation allocation) noexcept
+{
+    if (data == nullptr) {
+        return;
+    }
+    if (allocation == ValueAllocation::HEAP || size > MAX_BLOCK_SIZE) {
+        delete[] data;
+        heapLiveBytes_.fetch_sub(size, std::memory_order_relaxed);
+        return;
+    }
+
+    auto *slab = reinterpret_cast<Slab *>(reinterpret_cast<uintptr_t>(data) & ~(SLAB_SIZE - 1));
+    assert(slab->sizeClass == sizeClass(size));
+    auto &pool = classes_[slab->sizeClass];
+    std::lock_guard<std::mutex> lock(pool.mutex);
+
+    const bool wasFull = slab->liveBlocks == slab->capacity;
+    std::memcpy(data, &slab->freeList, sizeof(char *));
+    slab->freeList = data;
+    slab->liveBlocks--;
+    pool.liveBytes.fetch_sub(size, std::memory_order_relaxed);
+    pool.liveBlocks.fetch_sub(1, std::memory_order_relaxed);
+
+    if (wasFull) {
+        // Слэб снова может выдавать блоки
+        slab->prev = nullptr;
+        slab->next = pool.partial;
+        if (pool.partial != nullptr) {
+            pool.partial->prev = slab;
+        }
+        pool.partial = slab;
+    }
+    if (slab->liveBlocks != 0) {
+        return;
+    }
+
+    // Пустой слэб исключается из списка и остаётся в резерве либо возвращается системе
+    if (slab->prev != nullptr) {
+        slab->prev->next = slab->next;
+    }
+    else {
+        pool.partial = slab->next;
+    }
+    if (slab->next != nullptr) {
+        slab->next->prev = slab->prev;
+    }
+    if (pool.spare == nullptr) {
+        slab->prev = nullptr;
+        slab->next = nullptr;
+        slab->freeList = nullptr;
+        slab->bumpOffset = SLAB_HEADER_SIZE;
+        pool.spare = slab;
+        return;
+    }
+    std::free(slab);
+    pool.slabs.fetch_sub(1, std::memory_order_relaxed);
+}
+
+bool ValueAllocator::fits(size_t oldSize, size_t newSize, ValueAllocation allocation) noexcept
+{
+    if (allocation == ValueAllocation::HEAP || oldSize > MAX_BLOCK_SIZE
+        || newSize > MAX_BLOCK_SIZE) {
+        return oldSize == newSize;
+    }
+    return sizeClass(oldSize) == sizeClass(newSize);
+}
+
+void ValueAllocator::resize(size_t oldSize, size_t newSize) noexcept
+{
+    if (oldSize == newSize) {
+        return;
+    }
+    // Длина меняется без перевыделения только внутри одного класса размера
+    auto &pool = classes_[sizeClass(oldSize)];
+    pool.liveBytes.fetch_add(newSize - oldSize, std::memory_order_relaxed);
+}
+
+ValueAllocatorStats ValueAllocator::stats() const
+{
+    ValueAllocatorStats result;
+    for (size_t i = 0; i < CLASS_COUNT; i++) {
+        const auto &pool = classes_[i];
+        result.liveBytes += pool.liveBytes.load(std::memory_order_relaxed);
+        result.allocatedBytes
+            += pool.liveBlocks.load(std::memory_order_relaxed) * classSize(i);
+        result.slabs += pool.slabs.load(std::memory_order_relaxed);
+    }
+    result.reservedBytes = result.slabs * SLAB_SIZE;
+
+    const auto heapBytes = heapLiveBytes_.load(std::memory_order_relaxed);
+    result.liveBytes += heapBytes;
+    result.allocatedBytes += heapBytes;
+    result.reservedBytes += heapBytes;
+    return result;
+}
+
+void ValueAllocator::setDefaultAllocation(ValueAllocation allocation) noexcept
+{
+    defaultAllocation_.store(allocation, std::memory_order_relaxed);
+}
+
+ValueAllocation ValueAllocator::defaultAllocation() noexcept
+{
+    return defaultAllocation_.load(std::memory_order_relaxed);
+}
+} // namespace octet
@@ -0,0 +1,608 @@
+#include "storage/value_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <limits>
+#include <unordered_map>
+
+#include "utils/byte_order.hpp"
+#include "utils/crc32c.hpp"
+#include "utils/file_utils.hpp"
+#include "utils/mapped_file.hpp"
+#include "logger.hpp"
+#include "metrics.hpp"
+
+namespace {
+// Сигнатура в начале каждого сегмента
+static constexpr char SEGMENT_MAGIC[] = "OCTVLOG1";
+static constexpr size_t SEGMENT_MAGIC_SIZE = sizeof(SEGMENT_MAGIC) - 1;
+static constexpr size_t SEGMENT_NUMBER_WIDTH = 6;
+
+// Количество частей кэша со своими мьютексами
+static constexpr size_t CACHE_SHARD_COUNT = 16;
+
+// Ключ кэша: номер сегмента и смещение значения (номера сегментов не переиспользуются)
+uint64_t cacheKey(const octet::ValueLocation &location)
+{
+    return (static_cast<uint64_t>(location.segment) << 32) | location.offset;
+}
+
+// Контрольная сумма записи: ключ, длина и значение
+uint32_t recordCrc(const char *header, std::string_view value)
+{
+    return octet::utils::crc32c(value.data(), value.size(),
+                                octet::utils::crc32c(header, 16 + sizeof(uint32_t)));
+}
+
+// Проверка заголовка записи перед значением: ключ, длина и контрольная сумма
+bool checkRecord(const char *header, const octet::Uuid &key, std::string_view value)
+{
+    const auto &bytes = key.bytes();
+    return std::memcmp(header, bytes.data(), bytes.size()) == 0
+           && octet::utils::loadLittleEndian<uint32_t>(header + 16) == value.size()
+           && octet::utils::loadLittleEndian<uint32_t>(header + 16 + sizeof(uint32_t))
+                  == recordCrc(header, value);
+}
+} // namespace
+
+namespace octet {
+/**
+ * @struct ValueLog::Segment
+ * @brief Открытый файл сегмента. Дескриптор закрывается, когда сегмент удалён из журнала и
+ * завершились все чтения, получившие его
+ */
+struct ValueLog::Segment {
+    Segment(uint32_t segmentNumber, std::filesystem::path segmentPath, int descriptor,
+            uint64_t initialSize)
+        : number(segmentNumber)
+        , path(std::move(segmentPath))
+        , fd(descriptor)
+        , size(initialSize)
+    {
+    }
+
+    ~Segment() { utils::closeDescriptor(fd); }
+
+    const uint32_t number; // Номер сегмента
+    const std::filesystem::path path; // Путь к файлу сегмента
+    const int fd; // Дескриптор файла
+    std::atomic<uint64_t> size; // Размер сегмента, включая зарезервированное под запись место
+    std::atomic<uint64_t> liveBytes{ 0 }; // Размер записей, используемых хранилищем
+    std::atomic<bool> dirty{ false }; // Есть ли записанные, но не зафиксированные данные
+    std::atomic<bool> retired{ false }; // Выведен ли сегмент из использования
+};
+
+/**
+ * @class ValueLog::Cache
+ * @brief Кэш значений фиксированного объёма. Каждая часть кэша вытесняет значения по алгоритму
+ * CLOCK: стрелка обходит ячейки по кругу, снимая признак обращения, и вытесняет первое значение,
+ * к которому не обращались с прошлого обхода. В отличие от LRU чтение из кэша не перестраивает
+ * список, а только устанавливает признак
+ */
+class ValueLog::Cache {
+public:
+    explicit Cache(size_t capacity)
+        : shardCapacity_(capacity / CACHE_SHARD_COUNT)
+    {
+    }
+
+    ~Cache() { Metrics::getInstance().addGauge(MetricGauge::VALUE_CACHE_BYTES, -bytes()); }
+
+    bool get(uint64_t key, std::string &value)
+    {
+        auto &shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        const auto it = shard.index.find(key);
+        if (it == shard.index.end()) {
+            return false;
+        }
+        auto &entry = shard.entries[it->second];
+        entry.referenced = true;
+        value = entry.value;
+        return true;
+    }
+
+    void put(uint64_t key, std::string_view value)
+    {
+        // Слишком длинное значение вытеснило бы большую часть кэша
+        if (value.size() > shardCapacity_ / 8) {
+            return;
+        }
+        auto &shard = shardFor(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        if (shard.index.count(key) != 0) {
+            return;
+        }
+        while (shard.bytes + value.size() > shardCapacity_ && shard.bytes > 0) {
+            evict(shard);
+        }
+
+        size_t slot = shard.entries.size();
+        if (!shard.freeSlots.empty()) {
+            slot = shard.freeSlots.back();
+            shard.freeSlots.pop_back();
+        }
+        else {
+            shard.entries.emplace_back();
+        }
+        auto &entry = shard.entries[slot];
+        entry.key = key;
+        entry.value.assign(value.data(), value.size());
+        // Новое значение вытесняется первым, если к нему не обратятся до прихода стрелки
+        entry.referenced = false;
+        entry.occupied = true;
+        shard.index.emplace(key, slot);
+        shard.bytes += value.size();
+        addBytes(static_cast<int64_t>(value.size()));
+    }
+
+    int64_t bytes() const { return bytes_.load(std::memory_order_relaxed); }
+
+private:
+    struct Entry {
+        uint64_t key = 0;
+        std::string value;
+        bool referenced = false; // Было ли обращение после прошлого прохода стрелки
+        bool occupied = false; // Занята ли ячейка
+    };
+
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        std::vector<Entry> entries; // Ячейки, которые обходит стрелка
+        std::vector<size_t> freeSlots; // Освобождённые ячейки
+        std::unordered_map<uint64_t, size_t> index; // Ячейки по ключам
+        size_t hand = 0; // Положение стрелки
+        size_t bytes = 0; // Суммарная длина значений
+    };
+
+    const size_t shardCapacity_;
+    std::array<Shard, CACHE_SHARD_COUNT> shards_;
+    std::atomic<int64_t> bytes_{ 0 };
+
+    Shard &shardFor(uint64_t key)
+    {
+        // Смещения значений в сегменте кратны только длинам записей, поэтому ключ перемешивается
+        return shards_[(key * 0x9E3779B97F4A7C15ULL) >> 60];
+    }
+
+    void addBytes(int64_t delta)
+    {
+        bytes_.fetch_add(delta, std::memory_order_relaxed);
+        Metrics::getInstance().addGauge(MetricGauge::VALUE_CACHE_BYTES, delta);
+    }
+
+    // Вытесняет одно значение (в части кэша есть хотя бы одно значение)
+    void evict(Shard &shard)
+    {
+        for (;;) {
+            auto &entry = shard.entries[shard.hand];
+            shard.hand = (shard.hand + 1) % shard.entries.size();
+            if (!entry.occupied) {
+                continue;
+            }
+            if (entry.referenced) {
+                entry.referenced = false;
+                continue;
+            }
+            shard.index.erase(entry.key);
+            shard.bytes -= entry.value.size();
+            addBytes(-static_cast<int64_t>(entry.value.size()));
+            std::string().swap(entry.value);
+            entry.occupied = false;
+            shard.freeSlots.push_back(static_cast<size_t>(&entry - shard.entries.data()));
+            return;
+        }
+    }
+};
+static_assert(CACHE_SHARD_COUNT == 16, "Часть кэша выбирается по старшим 4 битам хэша");
+
+ValueLog::ValueLog(const std::filesystem::path &basePath, ValueLogPolicy policy)
+    : basePath_(basePath)
+    , policy_(policy)
+    , cache_(policy.cacheBytes > 0 ? std::make_unique<Cache>(policy.cacheBytes) : nullptr)
+{
+    // Существующие сегменты только читаются: запись продолжается в новом сегменте
+    int64_t diskBytes = 0;
+    for (const auto &[number, path] : listSegments(basePath_)) {
+        nextSegment_ = std::max(nextSegment_, number + 1);
+        const auto fd = utils::openFileForRead(path);
+        const auto size = fd.has_value() ? utils::getDescriptorFileSize(*fd) : std::nullopt;
+        if (!size.has_value()) {
+            LOG_ERROR << "Не удалось открыть сегмент журнала значений: " << path.string();
+            if (fd.has_value()) {
+                utils::closeDescriptor(*fd);
+            }
+            continue;
+        }
+        std::array<char, SEGMENT_MAGIC_SIZE> magic{};
+        if (!utils::readFromDescriptorAt(*fd, 0, magic.data(), magic.size())
+            || !isSegment(std::string_view(magic.data(), magic.size()))) {
+            LOG_ERROR << "Файл не является сегментом журнала значений: " << path.string();
+            utils::closeDescriptor(*fd);
+            continue;
+        }
+        segments_.emplace(number, std::make_shared<Segment>(number, path, *fd, *size));
+        diskBytes += static_cast<int64_t>(*size);
+    }
+    Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_DISK_BYTES, diskBytes);
+    if (!segments_.empty()) {
+        LOG_INFO << "Открыт журнал значений: " << basePath_.string()
+                 << ", сегментов: " << segments_.size() << ", размер: " << diskBytes << " байт";
+    }
+}
+
+ValueLog::~ValueLog()
+{
+    int64_t diskBytes = 0;
+    int64_t liveBytes = 0;
+    for (const auto &[number, segment] : segments_) {
+        diskBytes += static_cast<int64_t>(segment->size.load());
+        liveBytes += static_cast<int64_t>(segment->liveBytes.load());
+    }
+    Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_DISK_BYTES, -diskBytes);
+    Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_LIVE_BYTES, -liveBytes);
+}
+
+bool ValueLog::shouldStore(size_t size) const noexcept
+{
+    // Короткие строки в ячейке таблицы занимают не больше места, чем их положение
+    return policy_.minValueSize > 0 && size >= policy_.minValueSize
+           && size > RecordValue::INLINE_CAPACITY;
+}
+
+std::optional<ValueLocation> ValueLog::append(const Uuid &key, std::string_view value)
+{
+    if (value.size() > std::numeric_limits<uint32_t>::max()) {
+        LOG_ERROR << "Значение слишком длинное для журнала значений: " << value.size() << " байт";
+        return std::nullopt;
+    }
+    const auto recordSize = RECORD_HEADER_SIZE + value.size();
+    const auto segmentSize = std::min(policy_.segmentSize, MAX_SEGMENT_SIZE);
+
+    std::shared_ptr<Segment> segment;
+    uint64_t offset = 0;
+    {
+        // Под мьютексом только резервируется место, запись выполняется параллельно
+        std::lock_guard<std::mutex> lock(appendMutex_);
+        if (active_ == nullptr
+            || (active_->size > SEGMENT_MAGIC_SIZE && active_->size + recordSize > segmentSize)) {
+            if (!startSegment()) {
+                return std::nullopt;
+            }
+        }
+        segment = active_;
+        offset = segment->size;
+        segment->size += recordSize;
+    }
+    Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_DISK_BYTES,
+                                    static_cast<int64_t>(recordSize));
+
+    std::array<char, RECORD_HEADER_SIZE> header{};
+    const auto &bytes = key.bytes();
+    std::memcpy(header.data(), bytes.data(), bytes.size());
+    utils::storeLittleEndian<uint32_t>(header.data() + 16, static_cast<uint32_t>(value.size()));
+    utils::storeLittleEndian<uint32_t>(header.data() + 16 + sizeof(uint32_t),
+                                       recordCrc(header.data(), value));
+    if (!utils::writeToDescriptorAt(segment->fd, offset, header.data(), header.size())
+        || !utils::writeToDescriptorAt(segment->fd, offset + header.size(), value.data(),
+                                       value.size())) {
+        LOG_ERROR << "Не удалось записать значение в сегмент журнала значений: "
+                  << segment->path.string();
+        return std::nullopt;
+    }
+    // Признак устанавливается после записи: sync, не увидевший его, не мог получить и
+    // положение этого значения
+    segment->dirty = true;
+    return ValueLocation{ segment->number, static_cast<uint32_t>(offset + RECORD_HEADER_SIZE),
+                          static_cast<uint32_t>(value.size()) };
+}
+
+bool ValueLog::read(const Uuid &key, const ValueLocation &location, std::string &value) const
+{
+    if (cache_ != nullptr && cache_->get(cacheKey(location), value)) {
+        cacheHits_.fetch_add(1, std::memory_order_relaxed);
+        Metrics::getInstance().increment(MetricCounter::VALUE_CACHE_HITS);
+        return true;
+    }
+
+    // Сегмент мог быть удалён после уплотнения, тогда вызывающий перечитывает положение
+    const auto segment = findSegment(location.segment);
+    if (segment == nullptr || location.offset < SEGMENT_MAGIC_SIZE + RECORD_HEADER_SIZE) {
+        return false;
+    }
+    std::string record(RECORD_HEADER_SIZE + location.size, '\0');
+    if (!utils::readFromDescriptorAt(segment->fd, location.offset - RECORD_HEADER_SIZE,
+                                     record.data(), record.size())) {
+        LOG_ERROR << "Не удалось прочитать значение из сегмента журнала значений: "
+                  << segment->path.string() << ", смещение: " << location.offset;
+        return false;
+    }
+    if (!checkRecord(record.data(), key, std::string_view(record).substr(RECORD_HEADER_SIZE))) {
+        LOG_ERROR << "Запись журнала значений повреждена: " << segment->path.string()
+                  << ", смещение: " << location.offset;
+        return false;
+    }
+    reads_.fetch_add(1, std::memory_order_relaxed);
+    Metrics::getInstance().increment(MetricCounter::VALUE_LOG_READS);
+
+    record.erase(0, RECORD_HEADER_SIZE);
+    value = std::move(record);
+    if (cache_ != nullptr) {
+        cache_->put(cacheKey(location), value);
+    }
+    return true;
+}
+
+bool ValueLog::contains(const ValueLocation &location) const
+{
+    const auto segment = findSegment(location.segment);
+    return segment != nullptr && location.offset >= SEGMENT_MAGIC_SIZE + RECORD_HEADER_SIZE
+           && static_cast<uint64_t>(location.offset) + location.size <= segment->size;
+}
+
+std::shared_lock<std::shared_mutex> ValueLog::pinSegments() const
+{
+    return std::shared_lock<std::shared_mutex>(pinMutex_);
+}
+
+void ValueLog::retain(const ValueLocation &location)
+{
+    if (const auto segment = findSegment(location.segment)) {
+        const auto size = RECORD_HEADER_SIZE + location.size;
+        segment->liveBytes.fetch_add(size, std::memory_order_relaxed);
+        Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_LIVE_BYTES,
+                                        static_cast<int64_t>(size));
+    }
+}
+
+void ValueLog::release(const ValueLocation &location)
+{
+    if (const auto segment = findSegment(location.segment)) {
+        const auto size = RECORD_HEADER_SIZE + location.size;
+        segment->liveBytes.fetch_sub(size, std::memory_order_relaxed);
+        Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_LIVE_BYTES,
+                                        -static_cast<int64_t>(size));
+    }
+}
+
+bool ValueLog::sync()
+{
+    std::vector<std::shared_ptr<Segment>> segments;
+    {
+        std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+        for (const auto &[number, segment] : segments_) {
+            if (segment->dirty) {
+                segments.push_back(segment);
+            }
+        }
+    }
+    for (const auto &segment : segments) {
+        if (segment->dirty.exchange(false) && !utils::syncFileData(segment->fd)) {
+            LOG_ERROR << "Не удалось зафиксировать сегмент журнала значений: "
+                      << segment->path.string();
+            segment->dirty = true;
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ValueLog::hasSegments() const
+{
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+    return !segments_.empty();
+}
+
+std::vector<uint32_t> ValueLog::collectableSegments() const
+{
+    std::shared_ptr<Segment> active;
+    {
+        std::lock_guard<std::mutex> lock(appendMutex_);
+        active = active_;
+    }
+
+    std::vector<uint32_t> result;
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+    for (const auto &[number, segment] : segments_) {
+        if (segment == active || segment->retired) {
+            continue;
+        }
+        const auto dataBytes
+            = segment->size - std::min<uint64_t>(segment->size, SEGMENT_MAGIC_SIZE);
+        if (segment->liveBytes * 2 < dataBytes || segment->liveBytes == 0) {
+            result.push_back(number);
+        }
+    }
+    return result;
+}
+
+bool ValueLog::scanSegment(
+    uint32_t segment, const std::function<void(const Uuid &, const ValueLocation &)> &func) const
+{
+    const auto path = segmentPath(basePath_, segment);
+    const utils::MappedFile file(path);
+    const auto content = file.view();
+    if (!file.isMapped() || !isSegment(content)) {
+        LOG_ERROR << "Не удалось прочитать сегмент журнала значений: " << path.string();
+        return false;
+    }
+
+    size_t offset = SEGMENT_MAGIC_SIZE;
+    while (content.size() - offset >= RECORD_HEADER_SIZE) {
+        const auto *header = content.data() + offset;
+        const auto size = utils::loadLittleEndian<uint32_t>(header + 16);
+        if (size > content.size() - offset - RECORD_HEADER_SIZE) {
+            break;
+        }
+        const auto value = content.substr(offset + RECORD_HEADER_SIZE, size);
+        if (utils::loadLittleEndian<uint32_t>(header + 16 + sizeof(uint32_t))
+            != recordCrc(header, value)) {
+            break;
+        }
+        func(Uuid::fromBytes(header),
+             ValueLocation{ segment, static_cast<uint32_t>(offset + RECORD_HEADER_SIZE), size });
+        offset += RECORD_HEADER_SIZE + size;
+    }
+    if (offset != content.size()) {
+        LOG_WARNING << "Сегмент журнала значений прочитан не до конца: " << path.string()
+                    << ", смещение: " << offset;
+        return false;
+    }
+    return true;
+}
+
+bool ValueLog::retireSegment(uint32_t segment)
+{
+    // Все значения, дописанные до этого момента, уже учтены через retain или не используются,
+    // а под appendMutex_ активный сегмент не меняется
+    std::unique_lock<std::shared_mutex> pinLock(pinMutex_);
+    std::lock_guard<std::mutex> appendLock(appendMutex_);
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+    const auto it = segments_.find(segment);
+    if (it == segments_.end() || it->second == active_ || it->second->liveBytes != 0) {
+        return false;
+    }
+    it->second->retired = true;
+    LOG_INFO << "Сегмент журнала значений выведен из использования: "
+             << it->second->path.string();
+    return true;
+}
+
+bool ValueLog::removeSegments(const std::vector<uint32_t> &segments)
+{
+    bool success = true;
+    for (const auto number : segments) {
+        std::shared_ptr<Segment> segment;
+        {
+            std::unique_lock<std::shared_mutex> lock(segmentsMutex_);
+            const auto it = segments_.find(number);
+            if (it == segments_.end() || !it->second->retired) {
+                continue;
+            }
+            segment = std::move(it->second);
+            segments_.erase(it);
+        }
+        Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_DISK_BYTES,
+                                        -static_cast<int64_t>(segment->size.load()));
+        // Чтения, уже получившие сегмент, дочитывают удалённый файл через открытый дескриптор
+        std::error_code ec;
+        if (!std::filesystem::remove(segment->path, ec) && ec) {
+            LOG_ERROR << "Не удалось удалить сегмент журнала значений: " << segment->path.string()
+                      << ", сообщение: " << ec.message();
+            success = false;
+            continue;
+        }
+        LOG_INFO << "Удалён сегмент журнала значений: " << segment->path.string();
+    }
+    return success;
+}
+
+ValueLogStats ValueLog::stats() const
+{
+    ValueLogStats result;
+    {
+        std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+        result.segments = segments_.size();
+        for (const auto &[number, segment] : segments_) {
+            result.diskBytes += segment->size;
+            result.liveBytes += segment->liveBytes;
+        }
+    }
+    result.cacheBytes = cache_ != nullptr ? static_cast<uint64_t>(cache_->bytes()) : 0;
+    result.reads = reads_.load(std::memory_order_relaxed);
+    result.cacheHits = cacheHits_.load(std::memory_order_relaxed);
+    return result;
+}
+
+std::filesystem::path ValueLog::segmentPath(const std::filesystem::path &basePath,
+                                            uint32_t number)
+{
+    auto suffix = std::to_string(number);
+    if (suffix.size() < SEGMENT_NUMBER_WIDTH) {
+        suffix.insert(0, SEGMENT_NUMBER_WIDTH - suffix.size(), '0');
+    }
+    return std::filesystem::path(basePath.string() + "." + suffix);
+}
+
+std::vector<std::pair<uint32_t, std::filesystem::path>>
+ValueLog::listSegments(const std::filesystem::path &basePath)
+{
+    std::vector<std::pair<uint32_t, std::filesystem::path>> segments;
+    const auto dir
+        = basePath.has_parent_path() ? basePath.parent_path() : std::filesystem::path(".");
+    const auto prefix = basePath.filename().string() + ".";
+
+    std::error_code ec;
+    for (const auto &item : std::filesystem::directory_iterator(dir, ec)) {
+        const auto name = item.path().filename().string();
+        if (name.size() < prefix.size() + SEGMENT_NUMBER_WIDTH
+            || name.compare(0, prefix.size(), prefix) != 0) {
+            continue;
+        }
+        // Временные файлы и другие файлы с тем же префиксом имеют нечисловые суффиксы
+        const auto suffix = name.substr(prefix.size());
+        if (suffix.size() > std::numeric_limits<uint32_t>::digits10
+            || !std::all_of(suffix.begin(), suffix.end(),
+                            [](char c) { return c >= '0' && c <= '9'; })) {
+            continue;
+        }
+        segments.emplace_back(static_cast<uint32_t>(std::stoul(suffix)), item.path());
+    }
+    // Директория данных ещё может не существовать, тогда сегментов нет
+    if (ec && ec != std::errc::no_such_file_or_directory) {
+        LOG_ERROR << "Не удалось получить список сегментов журнала значений: "
+                  << basePath.string() << ", сообщение: " << ec.message();
+    }
+    std::sort(segments.begin(), segments.end());
+    return segments;
+}
+
+bool ValueLog::isSegment(std::string_view content)
+{
+    return content.substr(0, SEGMENT_MAGIC_SIZE) == std::string_view(SEGMENT_MAGIC);
+}
+
+std::optional<std::string_view> ValueLog::recordValue(std::string_view content, const Uuid &key,
+                                                      const ValueLocation &location)
+{
+    if (location.offset < SEGMENT_MAGIC_SIZE + RECORD_HEADER_SIZE
+        || static_cast<uint64_t>(location.offset) + location.size > content.size()) {
+        return std::nullopt;
+    }
+    const auto value = content.substr(location.offset, location.size);
+    if (!checkRecord(content.data() + location.offset - RECORD_HEADER_SIZE, key, value)) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+std::shared_ptr<ValueLog::Segment> ValueLog::findSegment(uint32_t number) const
+{
+    std::shared_lock<std::shared_mutex> lock(segmentsMutex_);
+    const auto it = segments_.find(number);
+    return it != segments_.end() ? it->second : nullptr;
+}
+
+bool ValueLog::startSegment()
+{
+    const auto number = nextSegment_;
+    const auto path = segmentPath(basePath_, number);
+    const auto fd = utils::createFileForWrite(path, std::string(SEGMENT_MAGIC, SEGMENT_MAGIC_SIZE));
+    if (!fd.has_value()) {
+        LOG_ERROR << "Не удалось создать сегмент журнала значений: " << path.string();
+        return false;
+    }
+    nextSegment_++;
+    auto segment = std::make_shared<Segment>(number, path, *fd, SEGMENT_MAGIC_SIZE);
+    {
+        std::unique_lock<std::shared_mutex> lock(segmentsMutex_);
+        segments_.emplace(number, segment);
+    }
+    Metrics::getInstance().addGauge(MetricGauge::VALUE_LOG_DISK_BYTES,
+                                    static_cast<int64_t>(SEGMENT_MAGIC_SIZE));
+    active_ = std::move(segment);
+    LOG_INFO << "Начат новый сегмент журнала значений: " << path.string();
+    return true;
+}
+} // namespace octet
@@ -0,0 +1,134 @@
+#include "utils/compression.hpp"
+
+#include <limits>
+
+#if defined(OCTET_HAVE_LZ4)
+#include <lz4.h>
+#endif
+#if defined(OCTET_HAVE_ZSTD)
+#include <zstd.h>
+#endif
+
+namespace {
+#if defined(OCTET_HAVE_ZSTD)
+// Уровень сжатия Zstd: быстрый уровень по умолчанию, сжатие выполняется вне пути записи
+static constexpr int ZSTD_COMPRESSION_LEVEL = 3;
+#endif
+} // namespace
+
+namespace octet::utils {
+bool isCompressionCodecAvailable(CompressionCodec codec)
+{
+    switch (codec) {
+    case CompressionCodec::NONE:
+        return true;
+    case CompressionCodec::LZ4:
+#if defined(OCTET_HAVE_LZ4)
+        return true;
+#else
+        return false;
+#endif
+    case CompressionCodec::ZSTD:
+#if defined(OCTET_HAVE_ZSTD)
+        return true;
+#else
+        return false;
+#endif
+    }
+    return false;
+}
+
+const char *compressionCodecName(CompressionCodec codec)
+{
+    switch (codec) {
+    case CompressionCodec::NONE:
+        return "none";
+    case CompressionCodec::LZ4:
+        return "lz4";
+    case CompressionCodec::ZSTD:
+        return "zstd";
+    }
+    return "unknown";
+}
+
+bool compressBlock(CompressionCodec codec, std::string_view input, std::string &output)
+{
+    switch (codec) {
+    case CompressionCodec::NONE:
+        output.assign(input.data(), input.size());
+        return true;
+    case CompressionCodec::LZ4: {
+#if defined(OCTET_HAVE_LZ4)
+        if (input.size() > static_cast<size_t>(LZ4_MAX_INPUT_SIZE)) {
+            return false;
+        }
+        const auto inputSize = static_cast<int>(input.size());
+        output.resize(static_cast<size_t>(LZ4_compressBound(inputSize)));
+        const auto compressedSize = LZ4_compress_default(input.data(), output.data(), inputSize,
+                                                         static_cast<int>(output.size()));
+        if (compressedSize <= 0) {
+            return false;
+        }
+        output.resize(static_cast<size_t>(compressedSize));
+        return true;
+#else
+        break;
+#endif
+    }
+    case CompressionCodec::ZSTD: {
+#if defined(OCTET_HAVE_ZSTD)
+        output.resize(ZSTD_compressBound(input.size()));
+        const auto compressedSize = ZSTD_compress(output.data(), output.size(), input.data(),
+                                                  input.size(), ZSTD_COMPRESSION_LEVEL);
+        if (ZSTD_isError(compressedSize)) {
+            return false;
+        }
+        output.resize(compressedSize);
+        return true;
+#else
+        break;
+#endif
+    }
+    }
+    return false;
+}
+
+bool decompressBlock(CompressionCodec codec, std::string_view input, size_t originalSize,
+                     std::string &output)
+{
+    switch (codec) {
+    case CompressionCodec::NONE:
+        if (input.size() != originalSize) {
+            return false;
+        }
+        output.assign(input.data(), input.size());
+        return true;
+    case CompressionCodec::LZ4: {
+#if defined(OCTET_HAVE_LZ4)
+        constexpr auto maxSize = static_cast<size_t>(std::numeric_limits<int>::max());
+        if (input.size() > maxSize || originalSize > maxSize) {
+            return false;
+        }
+        output.resize(originalSize);
+        const auto size
+            = LZ4_decompress_safe(input.data(), output.data(), static_cast<int>(input.size()),
+                                  static_cast<int>(originalSize));
+        return size >= 0 && static_cast<size_t>(size) == originalSize;
+#else
+        break;
+#endif
+    }
+    case CompressionCodec::ZSTD: {
+#if defined(OCTET_HAVE_ZSTD)
+        output.resize(originalSize);
+        const auto size
+            = ZSTD_decompress(output.data(), originalSize, input.data(), input.size());
+        return !ZSTD_isError(size) && size == originalSize;
+#else
+        break;
+#endif
+    }
+    }
+    return false;
+}
+} // namespace octet::utils
@@ -0,0 +1,114 @@
+#include "utils/crc32c.hpp"
+
+#include <array>
+#include <cstring>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define OCTET_CRC32C_HARDWARE
+#include <nmmintrin.h>
+#endif
+
+namespace {
+// Отраженный полином Кастаньоли
+static constexpr uint32_t CRC32C_POLYNOMIAL = 0x82F63B78;
+
+// Таблицы для программного вычисления методом slicing-by-8
+using Crc32cTables = std::array<std::array<uint32_t, 256>, 8>;
+
+constexpr Crc32cTables makeCrc32cTables()
+{
+    Crc32cTables tables{};
+    for (uint32_t i = 0; i < 256; i++) {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc >> 1) ^ ((crc & 1) ? CRC32C_POLYNOMIAL : 0);
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++) {
+        for (size_t t = 1; t < tables.size(); t++) {
+            tables[t][i] = (tables[t - 1][i] >> 8) ^ tables[0][tables[t - 1][i] & 0xFF];
+        }
+    }
+    return tables;
+}
+
+static constexpr Crc32cTables CRC32C_TABLES = makeCrc32cTables();
+
+// Программное вычисление CRC32C (crc передается без финальной инверсии)
+uint32_t crc32cSoftware(const uint8_t *data, size_t size, uint32_t crc)
+{
+    while (size >= 8) {
+        uint32_t low;
+        uint32_t high;
+        std::memcpy(&low, data, sizeof(low));
+        std::memcpy(&high, data + 4, sizeof(high));
+#if defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__)
+        low = __builtin_bswap32(low);
+        high = __builtin_bswap32(high);
+#endif
+        low ^= crc;
+        crc = CRC32C_TABLES[7][low & 0xFF] ^ CRC32C_TABLES[6][(low >> 8) & 0xFF]
+              ^ CRC32C_TABLES[5][(low >> 16) & 0xFF] ^ CRC32C_TABLES[4][low >> 24]
+              ^ CRC32C_TABLES[3][high & 0xFF] ^ CRC32C_TABLES[2][(high >> 8) & 0xFF]
+              ^ CRC32C_TABLES[1][(high >> 16) & 0xFF] ^ CRC32C_TABLES[0][high >> 24];
+        data += 8;
+        size -= 8;
+    }
+    while (size-- > 0) {
+        crc = (crc >> 8) ^ CRC32C_TABLES[0][(crc ^ *data++) & 0xFF];
+    }
+    return crc;
+}
+
+#if defined(OCTET_CRC32C_HARDWARE)
+// Аппаратное вычисление CRC32C (crc передается без финальной инверсии)
+__attribute__((target("sse4.2"))) uint32_t crc32cHardware(const uint8_t *data, size_t size,
+                                                          uint32_t crc)
+{
+#if defined(__x86_64__)
+    uint64_t crc64 = crc;
+    while (size >= 8) {
+        uint64_t chunk;
+        std::memcpy(&chunk, data, sizeof(chunk));
+        crc64 = _mm_crc32_u64(crc64, chunk);
+        data += 8;
+        size -= 8;
+    }
+    crc = static_cast<uint32_t>(crc64);
+#endif
+    while (size >= 4) {
+        uint32_t chunk;
+        std::memcpy(&chunk, data, sizeof(chunk));
+        crc = _mm_crc32_u32(crc, chunk);
+        data += 4;
+        size -= 4;
+    }
+    while (size-- > 0) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+// Проверка поддержки SSE4.2 выполняется один раз
+bool hasHardwareCrc32c()
+{
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+}
+#endif
+} // namespace
+
+namespace octet::utils {
+uint32_t crc32c(const void *data, size_t size, uint32_t crc)
+{
+    const auto *bytes = static_cast<const uint8_t *>(data);
+    crc = ~crc;
+#if defined(OCTET_CRC32C_HARDWARE)
+    if (hasHardwareCrc32c()) {
+        return ~crc32cHardware(bytes, size, crc);
+    }
+#endif
+    return ~crc32cSoftware(bytes, size, crc);
+}
+} // namespace octet::utils
@@ -3,6 +3,8 @@
 #include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <system_error>
@@ -27,88 +29,54 @@ typedef HANDLE FileDescriptor;
 
 #include "utils/compiler.hpp"
 #include "logger.hpp"
+#include "metrics.hpp"
 
 namespace {
-// Структура для хранения информации о блокировке
-struct LockInfo {
-public:
-    LockInfo(FileDescriptor fd, octet::utils::LockMode mode, std::thread::id threadId)
-        : fd_(fd)
-        , mode_(mode)
-        , threadIds_({ threadId })
-        , refCount_(1)
-    {
-    }
-    // Геттер для дескриптора
-    FileDescriptor getFileDescriptor() const
-    {
-        return fd_;
-    }
-    // Геттер для режима блокировки
-    octet::utils::LockMode getMode() const
-    {
-        return mode_;
-    }
-    // Проверка, захвачена ли блокировка вызывающим потоком
-    bool lockedByThread(std::thread::id threadId) const
-    {
-        return std::find(threadIds_.begin(), threadIds_.end(), threadId) != threadIds_.end();
-    }
-    // Геттер для счетчика ссылок
-    size_t getRefCount() const
-    {
-        return refCount_;
-    }
-    // Увеличение счетчика ссылок на единицу
-    void incrementRefCount(std::thread::id threadId)
+#if defined(OCTET_PLATFORM_UNIX)
+static constexpr FileDescriptor INVALID_DESCRIPTOR = -1;
+#elif defined(OCTET_PLATFORM_WINDOWS)
+static const FileDescriptor INVALID_DESCRIPTOR = INVALID_HANDLE_VALUE;
+#endif
+// Пауза между попытками захвата блокировки, удерживаемой другим процессом
+static constexpr auto FILE_LOCK_RETRY_INTERVAL = std::chrono::milliseconds(1);
+
+// Состояние блокировки одного lock-файла в текущем процессе
+struct PathLock {
+    std::mutex mutex; // Мьютекс для защиты состояния
+    std::condition_variable released; // Уведомление об освобождении блокировки в процессе
+    // Потоки, захватившие блокировку (при повторном захвате поток повторяется)
+    std::vector<std::thread::id> holders;
+    octet::utils::LockMode mode = octet::utils::LockMode::EXCLUSIVE; // Режим захвата потоками
+    size_t waiters = 0; // Количество потоков, ожидающих освобождения блокировки
+    size_t users = 0; // Захваты и попытки захвата (защищено fileLockMutex)
+
+    FileDescriptor fd = INVALID_DESCRIPTOR; // Открытый дескриптор lock-файла
+    bool fileLocked = false; // Удерживается ли межпроцессная (файловая) блокировка
+    octet::utils::LockMode fileMode = octet::utils::LockMode::EXCLUSIVE; // Режим файловой
+                                                                         // блокировки
+    bool fileAcquiring = false; // Ожидает ли один из потоков файловую блокировку
+
+    // Проверка, захвачена ли блокировка потоком
+    bool heldBy(std::thread::id threadId) const
     {
-        if (mode_ == octet::utils::LockMode::SHARED) {
-            refCount_++;
-            threadIds_.push_back(threadId);
-        }
-        // LCOV_EXCL_START
-        else {
-            UNREACHABLE("Increment function must be called only for SHARED mode");
-        }
-        // LCOV_EXCL_STOP
+        return std::find(holders.begin(), holders.end(), threadId) != holders.end();
     }
-    // Уменьшение счетчика ссылок на единицу
-    void decrementRefCount(std::thread::id threadId)
+    // Может ли блокировка в указанном режиме быть захвачена без ожидания других потоков
+    bool available(octet::utils::LockMode requested) const
     {
-        // LCOV_EXCL_START
-        if (refCount_ == 0) {
-            UNREACHABLE("Trying to decrease empty reference counter for shared locks");
-        }
-        // LCOV_EXCL_STOP
-
-        if (mode_ == octet::utils::LockMode::SHARED) {
-            refCount_--;
-            // Удаляем первое вхождение идентификатора потока
-            auto it = std::find(threadIds_.begin(), threadIds_.end(), threadId);
-            // LCOV_EXCL_START
-            if (it == threadIds_.end()) {
-                UNREACHABLE("Trying to decrease reference count from unauthorized thread");
-            }
-            // LCOV_EXCL_STOP
-            threadIds_.erase(it);
-        }
-        // LCOV_EXCL_START
-        else {
-            UNREACHABLE("Decrement function must be called only for SHARED mode");
+        if (fileAcquiring) {
+            return false;
         }
-        // LCOV_EXCL_STOP
+        return holders.empty()
+            || (mode == octet::utils::LockMode::SHARED
+                && requested == octet::utils::LockMode::SHARED);
     }
-
-private:
-    const FileDescriptor fd_; // Дескриптор lock-файла
-    const octet::utils::LockMode mode_; // Режим блокировки
-    std::vector<std::thread::id> threadIds_; // Идентификаторы потоков, захвативших блокировку
-    size_t refCount_; // Счетчик ссылок для разделяемых блокировок
 };
 
-// Глобальный контейнер для хранения информации о блокировках
-static std::unordered_map<std::string, LockInfo> fileLockMap;
-// Мьютекс для безопасного доступа к контейнерам из нескольких потоков
+// Таблица блокировок текущего процесса (ключ - путь к lock-файлу). Запись существует, пока
+// блокировка захвачена или ожидается хотя бы одним потоком
+static std::unordered_map<std::string, std::shared_ptr<PathLock>> fileLockMap;
+// Мьютекс для защиты таблицы (состояние записи защищено собственным мьютексом записи)
 static std::mutex fileLockMutex;
 
 /**
@@ -138,18 +106,6 @@ std::string getLockModeString(octet::utils::LockMode mode)
     UNREACHABLE("Unsupported LockMode"); // LCOV_EXCL_LINE
 }
 
-/**
- * @brief Приостанавливает блокировку мьютекса
- * @param lock Обертка над мьютексом с блокировкой
- * @param pause Время паузы (в миллисекундах)
- */
-void pauseLock(std::unique_lock<std::mutex> &lock, size_t pause = 5)
-{
-    lock.unlock();
-    std::this_thread::sleep_for(std::chrono::milliseconds(pause));
-    lock.lock();
-}
-
 /**
  * @brief Формирует путь к файлу блокировки по пути к исходному файлу
  * @param filePath Путь к исходному файлу
@@ -202,141 +158,90 @@ bool checkDirectoryExists(const std::filesystem::path &dir)
     }
     return created;
 }
-} // namespace
-
-namespace octet::utils {
-FileLockGuard::FileLockGuard(const std::filesystem::path &filePath, LockMode mode,
-                             LockWaitStrategy waitStrategy, std::chrono::milliseconds timeout)
-    : originalLockPath_(filePath)
-    , locked_(acquireFileLock(originalLockPath_, mode, waitStrategy, timeout))
-{
-}
-
-FileLockGuard::~FileLockGuard()
+/**
+ * @brief Записывает в lock-файл PID, ID потока и режим (для отладки и информативности)
+ * @param fd Дескриптор lock-файла
+ * @param mode Режим блокировки
+ * @param filePath Путь к исходному файлу (для логирования)
+ */
+void writeLockInfo(FileDescriptor fd, octet::utils::LockMode mode,
+                   const std::filesystem::path &filePath)
 {
-    if (locked_) {
-        release();
-    }
-}
+    const std::string lockInfo
+        = "PID: " + getCurrentPid() + " ThreadID: "
+        + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()))
+        + " Mode: " + getLockModeString(mode) + "\n";
 
-bool FileLockGuard::isLocked() const
-{
-    return locked_;
-}
+#if defined(OCTET_PLATFORM_UNIX)
+    // Усекаем файл и пишем в начало
+    ftruncate(fd, 0);
+    lseek(fd, 0, SEEK_SET);
 
-bool FileLockGuard::release()
-{
-    if (!locked_) {
-        return false;
+    if (write(fd, lockInfo.c_str(), lockInfo.size()) == -1) {
+        // Запись в lock-файле не так важна, поэтому просто кидаем предупреждение
+        LOG_WARNING << "Не удалось записать информацию в файл блокировки: " << filePath.string()
+                    << ", ошибка: " << octet::errnoToString(errno);
     }
+#elif defined(OCTET_PLATFORM_WINDOWS)
+    // Усекаем файл и пишем в начало
+    SetFilePointer(fd, 0, NULL, FILE_BEGIN);
+    SetEndOfFile(fd);
 
-    bool result = releaseFileLock(originalLockPath_);
-    if (result) {
-        locked_ = false;
+    DWORD bytesWritten = 0;
+    if (!WriteFile(fd, lockInfo.c_str(), static_cast<DWORD>(lockInfo.size()), &bytesWritten,
+                   nullptr)) {
+        // Запись в lock-файле не так важна, поэтому просто кидаем предупреждение
+        LOG_WARNING << "Не удалось записать информацию в файл блокировки: " << filePath.string()
+                    << ", ошибка: " << GetLastError();
     }
-    return result;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
 }
 
-bool FileLockGuard::acquireFileLock(const std::filesystem::path &filePath, LockMode mode,
-                                    LockWaitStrategy waitStrategy,
-                                    std::chrono::milliseconds timeout)
+/**
+ * @brief Захватывает межпроцессную блокировку lock-файла (или меняет ее режим)
+ *
+ * Пока блокировка удерживается другим процессом, мьютекс записи освобождается, а остальные
+ * потоки процесса ждут окончания попытки (fileAcquiring).
+ *
+ * @param entry Состояние блокировки
+ * @param lock Захваченный мьютекс записи
+ * @param lockPath Путь к lock-файлу
+ * @param filePath Путь к исходному файлу (для логирования)
+ * @param mode Режим блокировки
+ * @param waitStrategy Стратегия ожидания
+ * @param deadline Момент окончания ожидания (для TIMEOUT)
+ * @return true, если блокировка захвачена
+ */
+bool lockFile(PathLock &entry, std::unique_lock<std::mutex> &lock,
+              const std::filesystem::path &lockPath, const std::filesystem::path &filePath,
+              octet::utils::LockMode mode, octet::utils::LockWaitStrategy waitStrategy,
+              std::chrono::steady_clock::time_point deadline)
 {
-    LOG_DEBUG << "Попытка получения блокировки: " << filePath.string()
-              << ", режим: " << (mode == LockMode::EXCLUSIVE ? "эксклюзивный" : "разделяемый");
-
-    // Проверяем, существует ли родительская директория
-    auto parentDir = filePath.parent_path();
-    if (!checkDirectoryExists(parentDir)) {
-        LOG_ERROR << "Не удалось обеспечить существование директории для файла блокировки: "
-                  << parentDir.string();
-        return false;
-    }
-
-#if defined(OCTET_PLATFORM_SUPPORTED)
-    // Получаем путь к lock-файлу
-    const auto lockPath = getLockFilePath(filePath);
-    const auto lockPathStr = lockPath.string();
-
-    // Текущий ID потока
-    const auto currentThreadId = std::this_thread::get_id();
-
-    // Блокируем мьютекс для защиты доступа к глобальному контейнеру
-    std::unique_lock<std::mutex> lock(fileLockMutex);
-
-    // Проверяем, захвачена ли уже блокировка текущим процессом
-    auto it = fileLockMap.find(lockPathStr);
-    if (it != fileLockMap.end()) {
-        // Проверяем совместимость режимов блокировки
-        const auto bothShared
-            = (mode == LockMode::SHARED && it->second.getMode() == LockMode::SHARED);
-
-        // Если оба режима разделяемые, увеличиваем счетчик ссылок
-        if (bothShared) {
-            const auto refCount = it->second.getRefCount();
-            it->second.incrementRefCount(currentThreadId);
-            const auto newRefCount = it->second.getRefCount();
-            LOG_DEBUG << "Увеличен счетчик ссылок для разделяемой блокировки: " << filePath.string()
-                      << ", изменение значения: " << refCount << " -> " << newRefCount;
-            return true;
-        }
-
-        // Если блокировка принадлежит текущему потоку - это самоблокировка
-        if (it->second.lockedByThread(currentThreadId)) {
-            LOG_ERROR << "Попытка повторного захвата блокировки в том же потоке: "
-                      << filePath.string() << ". Это может привести к deadlock!";
-            return false;
-        }
+    using octet::utils::LockMode;
+    using octet::utils::LockWaitStrategy;
 
-        // Если режимы несовместимы и стратегия без ожидания, сразу выходим
-        if (!bothShared && waitStrategy == LockWaitStrategy::INSTANTLY) {
-            LOG_WARNING << "Блокировка для файла уже захвачена другим потоком: "
-                        << filePath.string();
+#if defined(OCTET_PLATFORM_UNIX)
+    // Дескриптор открывается один раз и используется всеми захватами, пока запись существует
+    if (entry.fd == INVALID_DESCRIPTOR) {
+        // Убеждаемся, что родительская директория существует
+        const auto parentDir = filePath.parent_path();
+        if (!checkDirectoryExists(parentDir)) {
+            LOG_ERROR << "Не удалось обеспечить существование директории для файла блокировки: "
+                      << parentDir.string();
             return false;
         }
 
-        // Для других стратегий ожидания, ждем освобождения блокировки
-        auto startTime = std::chrono::steady_clock::now();
-        bool timeoutExceeded = false;
-        do {
-            // Временно освобождаем мьютекс, чтобы другие потоки могли освободить блокировку
-            pauseLock(lock);
-
-            // Проверяем, не освободилась ли блокировка
-            it = fileLockMap.find(lockPathStr);
-            if (it == fileLockMap.end()) {
-                // Блокировка освободилась, можно продолжить
-                break;
-            }
-
-            // Проверяем таймаут для стратегии с ограниченным ожиданием
-            if (waitStrategy == LockWaitStrategy::TIMEOUT) {
-                const auto currentTime = std::chrono::steady_clock::now();
-                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    currentTime - startTime);
-                timeoutExceeded = (elapsed >= timeout);
-            }
-        } while (!timeoutExceeded && waitStrategy != LockWaitStrategy::INSTANTLY);
-
-        // Если блокировка всё ещё захвачена и истёк таймаут или нет ожидания
-        if (fileLockMap.find(lockPathStr) != fileLockMap.end()
-            && (timeoutExceeded || waitStrategy == LockWaitStrategy::INSTANTLY)) {
-            LOG_WARNING << "Таймаут ожидания освобождения блокировки в текущем процессе: "
-                        << filePath.string();
+        // Открываем (или создаём) файл блокировки с правами чтения/записи для всех
+        entry.fd = open(lockPath.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0666);
+        if (entry.fd == INVALID_DESCRIPTOR) {
+            LOG_ERROR << "Не удалось открыть файл блокировки: " << filePath.string()
+                      << ", ошибка: " << octet::errnoToString(errno);
             return false;
         }
     }
-#else
-    UNREACHABLE("Unsupported platform");
-#endif
-
-#if defined(OCTET_PLATFORM_UNIX)
-    // Открываем (или создаём) файл блокировки с правами чтения/записи для всех
-    const auto fd = open(lockPath.c_str(), O_RDWR | O_CREAT, 0666);
-    if (fd == -1) {
-        LOG_ERROR << "Не удалось открыть файл блокировки: " << filePath.string()
-                  << ", ошибка: " << errnoToString(errno);
-        return false;
-    }
+    const auto fd = entry.fd;
 
     // Определяем тип блокировки в зависимости от режима
     int lockType = -1;
@@ -353,57 +258,57 @@ bool FileLockGuard::acquireFileLock(const std::filesystem::path &filePath, LockM
         // LCOV_EXCL_STOP
     }
 
+    entry.fileAcquiring = true;
+    bool locked = false;
     switch (waitStrategy) {
     // Стандартная стратегия (бесконечное ожидание)
     case LockWaitStrategy::STANDARD: {
-        if (flock(fd, lockType) != 0) {
+        lock.unlock();
+        const auto result = flock(fd, lockType);
+        const auto error = errno;
+        lock.lock();
+        if (result != 0) {
             LOG_ERROR << "Не удалось получить блокировку с бесконечным ожиданием: "
-                      << filePath.string() << ", ошибка: " << errnoToString(errno);
-            close(fd);
-            return false;
+                      << filePath.string() << ", ошибка: " << octet::errnoToString(error);
+            break;
         }
+        locked = true;
         break;
     }
     // Стратегия без ожидания
     case LockWaitStrategy::INSTANTLY: {
-        lockType |= LOCK_NB; // Non-blocking
-        if (flock(fd, lockType) != 0) {
+        if (flock(fd, lockType | LOCK_NB) != 0) {
             LOG_ERROR << "Не удалось получить блокировку без ожидания: " << filePath.string()
-                      << ", ошибка: " << errnoToString(errno);
-            close(fd);
-            return false;
+                      << ", ошибка: " << octet::errnoToString(errno);
+            break;
         }
+        locked = true;
         break;
     }
     // Стратегия с таймаутом ожидания
     case LockWaitStrategy::TIMEOUT: {
-        const auto startTime = std::chrono::steady_clock::now();
         while (true) {
             // Пытаемся получить блокировку без ожидания
             if (flock(fd, lockType | LOCK_NB) == 0) {
+                locked = true;
                 break;
             }
 
             // Если ошибка не EWOULDBLOCK, значит, что-то пошло не так
             if (errno != EWOULDBLOCK) {
                 LOG_ERROR << "Не удалось получить блокировку: " << filePath.string()
-                          << ", ошибка: " << errnoToString(errno);
-                close(fd);
-                return false;
+                          << ", ошибка: " << octet::errnoToString(errno);
+                break;
             }
-
-            const auto currentTime = std::chrono::steady_clock::now();
-            const auto elapsed
-                = std::chrono::duration_cast<std::chrono::milliseconds>(currentTime - startTime);
-
-            if (elapsed >= timeout) {
+            if (std::chrono::steady_clock::now() >= deadline) {
                 LOG_WARNING << "Таймаут ожидания блокировки: " << filePath.string();
-                close(fd);
-                return false;
+                break;
             }
 
-            // Временно освобождаем мьютекс, чтобы другие потоки могли освободить блокировку
-            pauseLock(lock);
+            // flock не поддерживает таймаут, поэтому повторяем попытку после паузы
+            lock.unlock();
+            std::this_thread::sleep_for(FILE_LOCK_RETRY_INTERVAL);
+            lock.lock();
         }
         break;
     }
@@ -412,41 +317,27 @@ bool FileLockGuard::acquireFileLock(const std::filesystem::path &filePath, LockM
         UNREACHABLE("Unsupported LockWaitStrategy");
         // LCOV_EXCL_STOP
     }
-
-    // Записываем PID текущего процесса и режим блокировки в файл (для отладки и информативности)
-    const std::string lockInfo = "PID: " + getCurrentPid() + " ThreadID: "
-                                 + std::to_string(std::hash<std::thread::id>{}(currentThreadId))
-                                 + " Mode: " + getLockModeString(mode) + "\n";
-
-    // Усекаем файл и пишем в начало
-    ftruncate(fd, 0);
-    lseek(fd, 0, SEEK_SET);
-
-    // Записываем информацию в файл
-    const auto writeResult = write(fd, lockInfo.c_str(), lockInfo.size());
-    if (writeResult == -1) {
-        // Запись в lock-файле не так важна, поэтому просто кидаем предупреждение
-        LOG_WARNING << "Не удалось записать информацию в файл блокировки: " << filePath.string()
-                    << ", ошибка: " << errnoToString(errno);
-    }
+    entry.fileAcquiring = false;
 #elif defined(OCTET_PLATFORM_WINDOWS)
-    // Для Windows настраиваем режим доступа в зависимости от типа блокировки
-    DWORD winMode;
-    switch (mode) {
-    case LockMode::EXCLUSIVE:
-        // Для эксклюзивной блокировки запрещаем любой совместный доступ
-        winMode = 0;
-        break;
-    case LockMode::SHARED:
-        winMode = FILE_SHARE_READ;
-        break;
-    // LCOV_EXCL_START
-    default:
-        UNREACHABLE("Unsupported LockMode");
-        // LCOV_EXCL_STOP
+    // Режим совместного доступа задается при открытии, поэтому для смены режима файл
+    // открывается заново
+    if (entry.fileLocked) {
+        CloseHandle(entry.fd);
+        entry.fd = INVALID_DESCRIPTOR;
+        entry.fileLocked = false;
     }
 
-    auto openHandle = [&lockPath, &winMode]() {
+    // Убеждаемся, что родительская директория существует
+    const auto parentDir = filePath.parent_path();
+    if (!checkDirectoryExists(parentDir)) {
+        LOG_ERROR << "Не удалось обеспечить существование директории для файла блокировки: "
+                  << parentDir.string();
+        return false;
+    }
+
+    // Для эксклюзивной блокировки запрещаем любой совместный доступ
+    const DWORD winMode = mode == LockMode::EXCLUSIVE ? 0 : FILE_SHARE_READ;
+    auto openHandle = [&lockPath, winMode]() {
         return CreateFileW(lockPath.wstring().c_str(), // Путь в формате wide string
                            GENERIC_READ | GENERIC_WRITE, // Права на чтение и запись
                            winMode, // Режим совместного использования
@@ -457,182 +348,302 @@ bool FileLockGuard::acquireFileLock(const std::filesystem::path &filePath, LockM
         );
     };
 
-    // Получаем дескриптор файла
+    entry.fileAcquiring = true;
     auto fd = openHandle();
-    // Проверка на получение дескриптора с первого раза
-    if (fd == INVALID_HANDLE_VALUE) {
-        switch (waitStrategy) {
-        // Стратегия без ожидания
-        case LockWaitStrategy::INSTANTLY: {
-            LOG_ERROR << "Не удалось открыть файл блокировки: " << filePath.string()
-                      << ", ошибка: " << GetLastError();
-            return false;
-        }
-        // Стандартная стратегия (бесконечное ожидание)
-        case LockWaitStrategy::STANDARD: {
-            while (true) {
-                // Временно освобождаем мьютекс, чтобы другие потоки могли освободить блокировку
-                pauseLock(lock);
-                // Пытаемся снова получить дескрипттор
-                fd = openHandle();
-                if (fd != INVALID_HANDLE_VALUE) {
-                    break;
-                }
-            }
+    while (fd == INVALID_HANDLE_VALUE && waitStrategy != LockWaitStrategy::INSTANTLY) {
+        if (waitStrategy == LockWaitStrategy::TIMEOUT
+            && std::chrono::steady_clock::now() >= deadline) {
+            LOG_WARNING << "Таймаут ожидания блокировки: " << filePath.string();
             break;
         }
-        // Стратегия с таймаутом ожидания
-        case LockWaitStrategy::TIMEOUT: {
-            const auto startTime = std::chrono::steady_clock::now();
-            while (true) {
-                // Временно освобождаем мьютекс, чтобы другие потоки могли освободить блокировку
-                pauseLock(lock);
-                // Пытаемся снова получить дескрипттор
-                fd = openHandle();
-                if (fd != INVALID_HANDLE_VALUE) {
-                    break;
-                }
-
-                const auto currentTime = std::chrono::steady_clock::now();
-                const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
-                    currentTime - startTime);
-                if (elapsed >= timeout) {
-                    LOG_WARNING << "Таймаут ожидания блокировки: " << filePath.string();
-                    return false;
-                }
-            }
-            break;
-        }
-        // LCOV_EXCL_START
-        default:
-            UNREACHABLE("Unsupported LockWaitStrategy");
-            // LCOV_EXCL_STOP
-        }
+        lock.unlock();
+        std::this_thread::sleep_for(FILE_LOCK_RETRY_INTERVAL);
+        lock.lock();
+        fd = openHandle();
     }
+    entry.fileAcquiring = false;
 
-    // Записываем PID, ThreadID и режим блокировки в файл
-    const std::string lockInfo = "PID: " + getCurrentPid() + " ThreadID: "
-                                 + std::to_string(std::hash<std::thread::id>{}(currentThreadId))
-                                 + " Mode: " + getLockModeString(mode) + "\n";
-
-    // Усекаем файл и пишем в начало
-    SetFilePointer(fd, 0, NULL, FILE_BEGIN);
-    SetEndOfFile(fd);
-
-    DWORD bytesWritten = 0;
-    const auto writeResult = WriteFile(fd, lockInfo.c_str(), static_cast<DWORD>(lockInfo.size()),
-                                       &bytesWritten, nullptr);
-    if (!writeResult) {
-        // Запись в lock-файле не так важна, поэтому просто кидаем предупреждение
-        LOG_WARNING << "Не удалось записать информацию в файл блокировки: " << lockFilePath.string()
-                    << ", ошибка: " << GetLastError();
+    if (fd == INVALID_HANDLE_VALUE && waitStrategy == LockWaitStrategy::INSTANTLY) {
+        LOG_ERROR << "Не удалось открыть файл блокировки: " << filePath.string()
+                  << ", ошибка: " << GetLastError();
     }
+    entry.fd = fd;
+    const auto locked = fd != INVALID_HANDLE_VALUE;
 #else
     UNREACHABLE("Unsupported platform");
 #endif
 
-#if defined(OCTET_PLATFORM_SUPPORTED)
-    // Сохраняем информацию о блокировке в глобальном контейнере
-    fileLockMap.emplace(lockPathStr, LockInfo(fd, mode, currentThreadId));
+    if (!locked) {
+        // Пропустившие попытку потоки могут попробовать сами
+        entry.released.notify_all();
+        return false;
+    }
 
-    LOG_INFO << "Успешно получена блокировка: " << filePath.string() << " (" << lockPathStr
-             << "), режим: " << getLockModeString(mode);
+    entry.fileLocked = true;
+    entry.fileMode = mode;
+    writeLockInfo(entry.fd, mode, filePath);
     return true;
-#else
-    UNREACHABLE("Unsupported platform");
-#endif
 }
 
-bool FileLockGuard::releaseFileLock(const std::filesystem::path &filePath)
+/**
+ * @brief Освобождает межпроцессную блокировку, закрывает дескриптор и удаляет lock-файл
+ * (вызывается, когда блокировку в процессе больше никто не держит и не ждет)
+ * @param entry Состояние блокировки
+ * @param lockPath Путь к lock-файлу
+ */
+void closeLockFile(PathLock &entry, const std::filesystem::path &lockPath)
 {
-    LOG_DEBUG << "Освобождение блокировки: " << filePath.string();
-
-#if defined(OCTET_PLATFORM_SUPPORTED)
-    // Получаем путь к lock-файлу
-    const auto lockPath = getLockFilePath(filePath);
     const auto lockPathStr = lockPath.string();
 
-    // Блокируем мьютекс для защиты глобального контейнера
-    std::lock_guard<std::mutex> guard(fileLockMutex);
+#if defined(OCTET_PLATFORM_UNIX)
+    if (entry.fileLocked) {
+        // Удаляем файл блокировки, пока она еще захвачена
+        if (unlink(lockPath.c_str()) != 0) {
+            LOG_ERROR << "Не удалось удалить файл блокировки: " << lockPathStr
+                      << ", ошибка: " << octet::errnoToString(errno);
+        }
 
-    // Ищем информацию о блокировке для данного lock-файла
-    auto it = fileLockMap.find(lockPathStr);
-    if (it == fileLockMap.end()) {
-        LOG_WARNING << "Попытка освободить несуществующую блокировку: " << lockPathStr;
-        return false;
+        // Снимаем блокировку
+        if (flock(entry.fd, LOCK_UN) != 0) {
+            LOG_ERROR << "Ошибка при снятии блокировки: " << lockPathStr
+                      << ", ошибка: " << octet::errnoToString(errno);
+        }
+        entry.fileLocked = false;
     }
 
-    // Получаем информацию о блокировке
-    auto &info = it->second;
-
-    // Проверяем, что блокировка освобождается тем же потоком, который ее захватил
-    const auto currentThreadId = std::this_thread::get_id();
-    if (!info.lockedByThread(currentThreadId)) {
-        LOG_ERROR << "Попытка освободить блокировку из неидентифицированного потока: "
-                  << lockPathStr;
-        return false;
+    // Закрываем файловый дескриптор
+    if (entry.fd != INVALID_DESCRIPTOR && close(entry.fd) != 0) {
+        LOG_ERROR << "Ошибка при закрытии файлового дескриптора: " << lockPathStr
+                  << ", ошибка: " << octet::errnoToString(errno);
     }
+#elif defined(OCTET_PLATFORM_WINDOWS)
+    if (entry.fileLocked) {
+        // Закрываем файловый дескриптор
+        if (!CloseHandle(entry.fd)) {
+            LOG_ERROR << "Ошибка при закрытии файлового дескриптора: " << lockPathStr
+                      << ", ошибка: " << GetLastError();
+        }
+        entry.fileLocked = false;
 
-    // Уменьшаем счетчик ссылок для разделяемых блокировок
-    const auto refCount = info.getRefCount();
-    if (info.getMode() == LockMode::SHARED && refCount > 1) {
-        info.decrementRefCount(currentThreadId);
-        const auto newRefCount = info.getRefCount();
-        LOG_DEBUG << "Уменьшен счетчик ссылок для разделяемой блокировки: " << lockPathStr
-                  << ", изменение значения: " << refCount << " -> " << newRefCount;
-        return true;
+        // Удаляем файл блокировки
+        if (!DeleteFileW(lockPath.wstring().c_str())) {
+            LOG_ERROR << "Не удалось удалить файл блокировки: " << lockPathStr
+                      << ", ошибка: " << GetLastError();
+        }
     }
-
-    // Получаем дескриптор файла
-    const auto fd = it->second.getFileDescriptor();
 #else
     UNREACHABLE("Unsupported platform");
 #endif
+    entry.fd = INVALID_DESCRIPTOR;
+}
 
-#if defined(OCTET_PLATFORM_UNIX)
-    // Снимаем блокировку
-    if (flock(fd, LOCK_UN) != 0) {
-        LOG_ERROR << "Ошибка при снятии блокировки: " << lockPathStr
-                  << ", ошибка: " << errnoToString(errno);
-        return false;
+/**
+ * @brief Завершает захват или попытку захвата записи таблицы: последний пользователь
+ * освобождает файловую блокировку и удаляет запись
+ * @param lockPath Путь к lock-файлу
+ * @param entry Состояние блокировки
+ */
+void releaseUser(const std::filesystem::path &lockPath, const std::shared_ptr<PathLock> &entry)
+{
+    std::lock_guard<std::mutex> tableLock(fileLockMutex);
+    std::lock_guard<std::mutex> entryLock(entry->mutex);
+    if (--entry->users != 0) {
+        return;
     }
 
-    // Закрываем файловый дескриптор
-    if (close(fd) != 0) {
-        LOG_ERROR << "Ошибка при закрытии файлового дескриптора: " << lockPathStr
-                  << ", ошибка: " << errnoToString(errno);
-        // TODO: Можем ли считать блокировку снятой?
+    closeLockFile(*entry, lockPath);
+    fileLockMap.erase(lockPath.string());
+}
+} // namespace
+
+namespace octet::utils {
+FileLockGuard::FileLockGuard(const std::filesystem::path &filePath, LockMode mode,
+                             LockWaitStrategy waitStrategy, std::chrono::milliseconds timeout)
+    : originalLockPath_(filePath)
+    , locked_(acquireFileLock(originalLockPath_, mode, waitStrategy, timeout))
+{
+}
+
+FileLockGuard::~FileLockGuard()
+{
+    if (locked_) {
+        release();
+    }
+}
+
+bool FileLockGuard::isLocked() const
+{
+    return locked_;
+}
+
+bool FileLockGuard::release()
+{
+    if (!locked_) {
+        return false;
     }
 
-    // Удаляем файл блокировки
-    if (unlink(lockPath.c_str()) != 0) {
-        LOG_ERROR << "Не удалось удалить файл блокировки: " << lockPathStr
-                  << ", ошибка: " << errnoToString(errno);
-        // TODO: Можем ли считать блокировку снятой?
+    bool result = releaseFileLock(originalLockPath_);
+    if (result) {
+        locked_ = false;
     }
-#elif defined(OCTET_PLATFORM_WINDOWS)
-    // Закрываем файловый дескриптор
-    if (!CloseHandle(fd)) {
-        LOG_ERROR << "Ошибка при закрытии файлового дескриптора: " << lockPathStr
-                  << ", ошибка: " << GetLastError();
-        // TODO: Можем ли считать блокировку снятой?
+    return result;
+}
+
+
+bool FileLockGuard::acquireFileLock(const std::filesystem::path &filePath, LockMode mode,
+                                    LockWaitStrategy waitStrategy,
+                                    std::chrono::milliseconds timeout)
+{
+    LOG_DEBUG << "Попытка получения блокировки: " << filePath.string()
+              << ", режим: " << (mode == LockMode::EXCLUSIVE ? "эксклюзивный" : "разделяемый");
+
+#if defined(OCTET_PLATFORM_SUPPORTED)
+    // Получаем путь к lock-файлу
+    const auto lockPath = getLockFilePath(filePath);
+    const auto deadline = std::chrono::steady_clock::now() + timeout;
+
+    // Текущий ID потока
+    const auto currentThreadId = std::this_thread::get_id();
+
+    // Находим (или создаем) запись таблицы блокировок. Глобальный мьютекс удерживается только
+    // на время поиска, поэтому блокировки разных файлов не мешают друг другу
+    std::shared_ptr<PathLock> entry;
+    {
+        std::lock_guard<std::mutex> tableLock(fileLockMutex);
+        auto &slot = fileLockMap[lockPath.string()];
+        if (slot == nullptr) {
+            slot = std::make_shared<PathLock>();
+        }
+        entry = slot;
+        ++entry->users;
     }
 
-    // Удаляем файл блокировки
-    if (!DeleteFileW(lockFilePath.wstring().c_str())) {
-        LOG_ERROR << "Не удалось удалить файл блокировки: " << lockFilePath.string()
-                  << ", ошибка: " << GetLastError();
-        // TODO: Можем ли считать блокировку снятой?
+    // Учитывается всё время получения блокировки: ожидание других потоков и процессов
+    ScopedLatency latency(MetricHistogram::LOCK_WAIT);
+    const auto acquired = [&] {
+        std::unique_lock<std::mutex> lock(entry->mutex);
+
+        // Повторный захват потоком, который уже владеет блокировкой
+        if (entry->heldBy(currentThreadId)) {
+            if (entry->mode == LockMode::SHARED && mode == LockMode::EXCLUSIVE) {
+                LOG_ERROR << "Попытка повышения разделяемой блокировки до эксклюзивной в том же "
+                             "потоке: "
+                          << filePath.string() << ". Это может привести к deadlock!";
+                return false;
+            }
+            entry->holders.push_back(currentThreadId);
+            LOG_DEBUG << "Повторный захват блокировки в том же потоке: " << filePath.string()
+                      << ", количество захватов: " << entry->holders.size();
+            return true;
+        }
+
+        // Ждем, пока блокировку не освободят другие потоки процесса
+        if (!entry->available(mode)) {
+            if (waitStrategy == LockWaitStrategy::INSTANTLY) {
+                LOG_WARNING << "Блокировка для файла уже захвачена другим потоком: "
+                            << filePath.string();
+                return false;
+            }
+
+            ++entry->waiters;
+            const auto predicate = [&] { return entry->available(mode); };
+            bool available = true;
+            if (waitStrategy == LockWaitStrategy::TIMEOUT) {
+                available = entry->released.wait_until(lock, deadline, predicate);
+            }
+            else {
+                entry->released.wait(lock, predicate);
+            }
+            --entry->waiters;
+
+            if (!available) {
+                LOG_WARNING << "Таймаут ожидания освобождения блокировки в текущем процессе: "
+                            << filePath.string();
+                return false;
+            }
+        }
+
+        // Разделяемая блокировка уже удерживается процессом: присоединяемся без системных вызовов
+        if (!entry->holders.empty()) {
+            entry->holders.push_back(currentThreadId);
+            LOG_DEBUG << "Увеличен счетчик ссылок для разделяемой блокировки: "
+                      << filePath.string() << ", количество захватов: " << entry->holders.size();
+            return true;
+        }
+
+        // Файловая блокировка в нужном режиме передана от предыдущего владельца
+        if (!entry->fileLocked || entry->fileMode != mode) {
+            if (!lockFile(*entry, lock, lockPath, filePath, mode, waitStrategy, deadline)) {
+                return false;
+            }
+            LOG_INFO << "Успешно получена блокировка: " << filePath.string() << " ("
+                     << lockPath.string() << "), режим: " << getLockModeString(mode);
+        }
+        entry->mode = mode;
+        entry->holders.push_back(currentThreadId);
+        return true;
+    }();
+
+    if (!acquired) {
+        releaseUser(lockPath, entry);
     }
+    return acquired;
 #else
     UNREACHABLE("Unsupported platform");
 #endif
+}
+
+bool FileLockGuard::releaseFileLock(const std::filesystem::path &filePath)
+{
+    LOG_DEBUG << "Освобождение блокировки: " << filePath.string();
 
 #if defined(OCTET_PLATFORM_SUPPORTED)
-    // Удаляем запись из контейнера
-    fileLockMap.erase(it);
+    // Получаем путь к lock-файлу
+    const auto lockPath = getLockFilePath(filePath);
+    const auto lockPathStr = lockPath.string();
+
+    // Ищем информацию о блокировке для данного lock-файла
+    std::shared_ptr<PathLock> entry;
+    {
+        std::lock_guard<std::mutex> tableLock(fileLockMutex);
+        auto it = fileLockMap.find(lockPathStr);
+        if (it == fileLockMap.end()) {
+            LOG_WARNING << "Попытка освободить несуществующую блокировку: " << lockPathStr;
+            return false;
+        }
+        entry = it->second;
+    }
 
-    LOG_INFO << "Блокировка успешно освобождена: " << filePath.string();
+    bool lastHolder = false;
+    {
+        std::lock_guard<std::mutex> lock(entry->mutex);
+
+        // Проверяем, что блокировка освобождается тем же потоком, который ее захватил
+        const auto currentThreadId = std::this_thread::get_id();
+        auto it = std::find(entry->holders.begin(), entry->holders.end(), currentThreadId);
+        if (it == entry->holders.end()) {
+            LOG_ERROR << "Попытка освободить блокировку из неидентифицированного потока: "
+                      << lockPathStr;
+            return false;
+        }
+        entry->holders.erase(it);
+        lastHolder = entry->holders.empty();
+
+        if (lastHolder) {
+            // Файловая блокировка остается захваченной: ожидающий поток получит ее без
+            // системных вызовов, а если ожидающих нет, ее освободит последний пользователь
+            entry->released.notify_all();
+        }
+        else {
+            LOG_DEBUG << "Уменьшен счетчик ссылок для блокировки: " << lockPathStr
+                      << ", количество захватов: " << entry->holders.size();
+        }
+    }
+
+    releaseUser(lockPath, entry);
+    if (lastHolder) {
+        LOG_INFO << "Блокировка успешно освобождена: " << filePath.string();
+    }
     return true;
 #else
     UNREACHABLE("Unsupported platform");
@@ -9,6 +9,7 @@
 #include <thread>
 
 #if defined(OCTET_PLATFORM_UNIX)
+#include <fcntl.h>
 #include <sys/file.h>
 #include <sys/stat.h>
 #include <sys/types.h>
@@ -17,10 +18,9 @@
 #include <fcntl.h>
 #include <io.h>
 #include <windows.h>
-#else
-#include "utils/compiler.hpp"
 #endif
 
+#include "utils/compiler.hpp"
 #include "utils/file_lock_guard.hpp"
 #include "logger.hpp"
 
@@ -208,6 +208,32 @@ std::string pathToFilename(const std::filesystem::path &path)
     }
     return filename;
 }
+
+#if defined(OCTET_PLATFORM_UNIX)
+// Создание файла с начальным содержимым, зафиксированным на диске вместе с записью в директории
+std::optional<int> createFileWithContent(const std::filesystem::path &filePath,
+                                         const std::string &initialData, int flags)
+{
+    const auto fd = open(filePath.c_str(), flags, 0644);
+    if (fd == -1) {
+        LOG_ERROR << "Не удалось создать файл: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return std::nullopt;
+    }
+
+    const auto parentDir
+        = filePath.has_parent_path() ? filePath.parent_path() : std::filesystem::path(".");
+    if (!octet::utils::writeToDescriptor(fd, initialData.data(), initialData.size())
+        || !octet::utils::syncFileData(fd) || !syncDirectory(parentDir)) {
+        LOG_ERROR << "Не удалось записать начальное содержимое файла: " << filePath.string();
+        close(fd);
+        std::error_code ec;
+        std::filesystem::remove(filePath, ec);
+        return std::nullopt;
+    }
+    return fd;
+}
+#endif
 } // namespace
 
 namespace octet::utils {
@@ -471,6 +497,28 @@ bool atomicFileWrite(const std::filesystem::path &filePath, const std::string &d
     return true;
 }
 
+bool replaceFileDurably(const std::filesystem::path &sourcePath,
+                        const std::filesystem::path &targetPath)
+{
+    LOG_DEBUG << "Замена файла: " << sourcePath.string() << " -> " << targetPath.string();
+
+    std::error_code ec;
+    std::filesystem::rename(sourcePath, targetPath, ec);
+    if (ec) {
+        LOG_ERROR << "Не удалось заменить файл: " << targetPath.string()
+                  << ", код ошибки: " << ec.value() << ", сообщение: " << ec.message();
+        return false;
+    }
+
+    // Синхронизируем директорию, чтобы переименование пережило сбой
+    if (!syncDirectory(targetPath.parent_path())) {
+        LOG_WARNING << "Файл заменен, но синхронизация директории не удалась: "
+                    << targetPath.string();
+        return false;
+    }
+    return true;
+}
+
 bool safeFileRead(const std::filesystem::path &filePath, std::string &data)
 {
     LOG_DEBUG << "Безопасное чтение файла: " << filePath.string();
@@ -647,6 +695,260 @@ bool safeFileAppend(const std::filesystem::path &filePath, const std::string &da
     return true;
 }
 
+std::optional<int> openFileForAppend(const std::filesystem::path &filePath)
+{
+    LOG_DEBUG << "Открытие файла для дозаписи: " << filePath.string();
+#if defined(OCTET_PLATFORM_UNIX)
+    const auto fd = open(filePath.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+    if (fd == -1) {
+        LOG_ERROR << "Не удалось открыть файл для дозаписи: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return std::nullopt;
+    }
+    return fd;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+std::optional<int> openFileForRead(const std::filesystem::path &filePath)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    const auto fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_DEBUG << "Не удалось открыть файл для чтения: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return std::nullopt;
+    }
+    return fd;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+std::optional<int> createFileForAppend(const std::filesystem::path &filePath,
+                                       const std::string &initialData)
+{
+    LOG_DEBUG << "Создание файла для дозаписи: " << filePath.string();
+#if defined(OCTET_PLATFORM_UNIX)
+    return createFileWithContent(filePath, initialData,
+                                 O_WRONLY | O_APPEND | O_CREAT | O_EXCL | O_CLOEXEC);
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+std::optional<int> createFileForWrite(const std::filesystem::path &filePath,
+                                      const std::string &initialData)
+{
+    LOG_DEBUG << "Создание файла для записи: " << filePath.string();
+#if defined(OCTET_PLATFORM_UNIX)
+    return createFileWithContent(filePath, initialData, O_RDWR | O_CREAT | O_EXCL | O_CLOEXEC);
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool writeToDescriptor(int fd, const char *data, size_t size)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    size_t written = 0;
+    while (written < size) {
+        const auto result = write(fd, data + written, size - written);
+        if (result < 0) {
+            // Прерывание сигналом не является ошибкой, повторяем запись
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR << "Ошибка записи в файл по дескриптору " << fd
+                      << ", ошибка: " << octet::errnoToString(errno);
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool readFromDescriptor(int fd, uint64_t offset, std::string &data)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    static constexpr size_t READ_CHUNK_SIZE = 64 * 1024;
+    while (true) {
+        const auto start = data.size();
+        data.resize(start + READ_CHUNK_SIZE);
+        const auto result = pread(fd, data.data() + start, READ_CHUNK_SIZE,
+                                  static_cast<off_t>(offset));
+        if (result < 0) {
+            data.resize(start);
+            // Прерывание сигналом не является ошибкой, повторяем чтение
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR << "Ошибка чтения файла по дескриптору " << fd
+                      << ", ошибка: " << octet::errnoToString(errno);
+            return false;
+        }
+        data.resize(start + static_cast<size_t>(result));
+        if (result == 0) {
+            return true;
+        }
+        offset += static_cast<uint64_t>(result);
+    }
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool writeToDescriptorAt(int fd, uint64_t offset, const char *data, size_t size)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    size_t written = 0;
+    while (written < size) {
+        const auto result
+            = pwrite(fd, data + written, size - written, static_cast<off_t>(offset + written));
+        if (result < 0) {
+            // Прерывание сигналом не является ошибкой, повторяем запись
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR << "Ошибка записи в файл по дескриптору " << fd
+                      << ", ошибка: " << octet::errnoToString(errno);
+            return false;
+        }
+        written += static_cast<size_t>(result);
+    }
+    return true;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool readFromDescriptorAt(int fd, uint64_t offset, char *data, size_t size)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    size_t received = 0;
+    while (received < size) {
+        const auto result
+            = pread(fd, data + received, size - received, static_cast<off_t>(offset + received));
+        if (result < 0) {
+            // Прерывание сигналом не является ошибкой, повторяем чтение
+            if (errno == EINTR) {
+                continue;
+            }
+            LOG_ERROR << "Ошибка чтения файла по дескриптору " << fd
+                      << ", ошибка: " << octet::errnoToString(errno);
+            return false;
+        }
+        if (result == 0) {
+            return false;
+        }
+        received += static_cast<size_t>(result);
+    }
+    return true;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool syncFileData(int fd)
+{
+#if defined(OCTET_PLATFORM_MACOS)
+    // На macOS fdatasync отсутствует
+    const auto success = fsync(fd) == 0;
+#elif defined(OCTET_PLATFORM_UNIX)
+    // Метаданные (время изменения) не нужны для восстановления, поэтому достаточно fdatasync
+    const auto success = fdatasync(fd) == 0;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+    if (!success) {
+        LOG_ERROR << "Ошибка синхронизации файла по дескриптору " << fd
+                  << ", ошибка: " << octet::errnoToString(errno);
+    }
+    return success;
+}
+
+bool isDescriptorOfFile(int fd, const std::filesystem::path &filePath)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    struct stat fdStat;
+    struct stat pathStat;
+    if (fstat(fd, &fdStat) != 0 || stat(filePath.c_str(), &pathStat) != 0) {
+        return false;
+    }
+    return fdStat.st_dev == pathStat.st_dev && fdStat.st_ino == pathStat.st_ino;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+std::optional<uint64_t> getDescriptorFileSize(int fd)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    struct stat fdStat;
+    if (fstat(fd, &fdStat) != 0) {
+        LOG_ERROR << "Не удалось получить размер файла по дескриптору " << fd
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return std::nullopt;
+    }
+    return static_cast<uint64_t>(fdStat.st_size);
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool preallocateFile(int fd, uint64_t size)
+{
+#if defined(OCTET_PLATFORM_LINUX)
+    // FALLOC_FL_KEEP_SIZE выделяет блоки, не сдвигая конец файла, поэтому читатели по-прежнему
+    // видят только записанные данные
+    if (fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size)) != 0) {
+        LOG_DEBUG << "Не удалось заранее выделить место под файл по дескриптору " << fd
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return false;
+    }
+    return true;
+#elif defined(OCTET_PLATFORM_UNIX)
+    // Выделение без изменения размера файла поддерживается только на Linux
+    (void)fd;
+    (void)size;
+    return false;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+bool releasePreallocatedSpace(int fd)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    // Усечение до текущего размера освобождает блоки, выделенные за концом файла
+    const auto size = getDescriptorFileSize(fd);
+    if (!size.has_value() || ftruncate(fd, static_cast<off_t>(*size)) != 0) {
+        LOG_WARNING << "Не удалось освободить заранее выделенное место по дескриптору " << fd
+                    << ", ошибка: " << octet::errnoToString(errno);
+        return false;
+    }
+    return true;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+void closeDescriptor(int fd)
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    if (close(fd) != 0) {
+        LOG_WARNING << "Ошибка закрытия файла по дескриптору " << fd
+                    << ", ошибка: " << octet::errnoToString(errno);
+    }
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
 std::optional<std::filesystem::path> createFileBackup(const std::filesystem::path &filePath)
 {
     LOG_DEBUG << "Создание резервной копии файла: " << filePath.string();
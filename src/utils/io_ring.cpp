@@ -0,0 +1,507 @@
+#include "utils/io_ring.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+
+#if defined(OCTET_HAVE_IO_URING)
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#endif
+
+namespace {
+#if defined(OCTET_HAVE_IO_URING)
+// Метки операций, не использующих зарегистрированные буферы (остальные метки - номера буферов)
+static constexpr uint64_t DIRECT_WRITE_TAG = UINT64_MAX - 1;
+static constexpr uint64_t SYNC_TAG = UINT64_MAX;
+
+// Индексы колец разделяются с ядром, поэтому читаются и записываются с барьерами памяти
+unsigned loadAcquire(const unsigned *value)
+{
+    return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+}
+
+void storeRelease(unsigned *value, unsigned newValue)
+{
+    __atomic_store_n(value, newValue, __ATOMIC_RELEASE);
+}
+
+// Дописывает остаток частично выполненной записи обычными системными вызовами
+bool writeRemainder(int fd, uint64_t offset, const char *data, size_t size, int &error)
+{
+    while (size > 0) {
+        const auto written = pwrite(fd, data, size, static_cast<off_t>(offset));
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            error = errno;
+            return false;
+        }
+        if (written == 0) {
+            error = EIO;
+            return false;
+        }
+        data += written;
+        offset += static_cast<uint64_t>(written);
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+#endif
+} // namespace
+
+namespace octet::utils {
+/**
+ * @struct IoRing::Ring
+ * @brief Кольца очереди, отображённые из ядра, и состояние поставленных операций
+ */
+struct IoRing::Ring {
+#if defined(OCTET_HAVE_IO_URING)
+    /**
+     * @struct PendingWrite
+     * @brief Запись из зарегистрированного буфера, ожидающая завершения
+     */
+    struct PendingWrite {
+        int fd = -1;
+        uint64_t offset = 0;
+        size_t size = 0;
+    };
+
+    int fd = -1; // Дескриптор очереди
+    bool fixedBuffers = false; // Зарегистрированы ли буферы в ядре
+
+    // Кольцо отправки
+    void *sqRing = MAP_FAILED;
+    size_t sqRingSize = 0;
+    unsigned *sqHead = nullptr;
+    unsigned *sqTail = nullptr;
+    unsigned *sqMask = nullptr;
+    unsigned *sqArray = nullptr;
+    unsigned sqEntries = 0;
+    io_uring_sqe *sqes = static_cast<io_uring_sqe *>(MAP_FAILED);
+    size_t sqesSize = 0;
+
+    // Кольцо завершений (может совпадать с кольцом отправки)
+    void *cqRing = MAP_FAILED;
+    size_t cqRingSize = 0;
+    unsigned *cqHead = nullptr;
+    unsigned *cqTail = nullptr;
+    unsigned *cqMask = nullptr;
+    io_uring_cqe *cqes = nullptr;
+
+    std::vector<PendingWrite> pending; // Записи зарегистрированных буферов по номерам буферов
+    int directResult = 0; // Результат последней записи из буфера вызывающего
+    int syncResult = 0; // Результат последней синхронизации
+
+    ~Ring()
+    {
+        if (sqes != MAP_FAILED) {
+            munmap(sqes, sqesSize);
+        }
+        if (cqRing != MAP_FAILED && cqRing != sqRing) {
+            munmap(cqRing, cqRingSize);
+        }
+        if (sqRing != MAP_FAILED) {
+            munmap(sqRing, sqRingSize);
+        }
+        if (fd >= 0) {
+            close(fd);
+        }
+    }
+
+    // Свободный элемент кольца отправки (передаётся ядру вызовом commit)
+    io_uring_sqe *next()
+    {
+        const auto tail = *sqTail;
+        if (tail - loadAcquire(sqHead) >= sqEntries) {
+            return nullptr;
+        }
+        auto *sqe = &sqes[tail & *sqMask];
+        std::memset(sqe, 0, sizeof(*sqe));
+        return sqe;
+    }
+
+    void commit()
+    {
+        const auto tail = *sqTail;
+        sqArray[tail & *sqMask] = tail & *sqMask;
+        storeRelease(sqTail, tail + 1);
+    }
+#endif
+};
+
+IoRing::IoRing(size_t bufferCount)
+{
+#if defined(OCTET_HAVE_IO_URING)
+    if (bufferCount == 0) {
+        bufferCount = 1;
+    }
+    auto ring = std::make_unique<Ring>();
+
+    // На каждую запись может приходиться синхронизация, поэтому мест в очереди вдвое больше
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+    ring->fd = static_cast<int>(
+        syscall(__NR_io_uring_setup, static_cast<unsigned>(2 * bufferCount + 2), &params));
+    if (ring->fd < 0) {
+        lastError_ = errno;
+        return;
+    }
+
+    ring->sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+    ring->cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    const auto singleMap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+    if (singleMap) {
+        ring->sqRingSize = ring->cqRingSize = std::max(ring->sqRingSize, ring->cqRingSize);
+    }
+    ring->sqRing = mmap(nullptr, ring->sqRingSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_SQ_RING);
+    if (ring->sqRing == MAP_FAILED) {
+        lastError_ = errno;
+        return;
+    }
+    ring->cqRing = singleMap ? ring->sqRing
+                             : mmap(nullptr, ring->cqRingSize, PROT_READ | PROT_WRITE,
+                                    MAP_SHARED | MAP_POPULATE, ring->fd, IORING_OFF_CQ_RING);
+    if (ring->cqRing == MAP_FAILED) {
+        lastError_ = errno;
+        return;
+    }
+    ring->sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+    ring->sqes = static_cast<io_uring_sqe *>(mmap(nullptr, ring->sqesSize,
+                                                  PROT_READ | PROT_WRITE,
+                                                  MAP_SHARED | MAP_POPULATE, ring->fd,
+                                                  IORING_OFF_SQES));
+    if (ring->sqes == MAP_FAILED) {
+        lastError_ = errno;
+        return;
+    }
+
+    auto *sq = static_cast<char *>(ring->sqRing);
+    ring->sqHead = reinterpret_cast<unsigned *>(sq + params.sq_off.head);
+    ring->sqTail = reinterpret_cast<unsigned *>(sq + params.sq_off.tail);
+    ring->sqMask = reinterpret_cast<unsigned *>(sq + params.sq_off.ring_mask);
+    ring->sqArray = reinterpret_cast<unsigned *>(sq + params.sq_off.array);
+    ring->sqEntries = params.sq_entries;
+    auto *cq = static_cast<char *>(ring->cqRing);
+    ring->cqHead = reinterpret_cast<unsigned *>(cq + params.cq_off.head);
+    ring->cqTail = reinterpret_cast<unsigned *>(cq + params.cq_off.tail);
+    ring->cqMask = reinterpret_cast<unsigned *>(cq + params.cq_off.ring_mask);
+    ring->cqes = reinterpret_cast<io_uring_cqe *>(cq + params.cq_off.cqes);
+
+    // Буферы выравниваются по странице, чтобы регистрация закрепляла только их страницы
+    std::vector<iovec> iovecs;
+    for (size_t i = 0; i < bufferCount; i++) {
+        void *buffer = std::aligned_alloc(4096, BUFFER_SIZE);
+        if (buffer == nullptr) {
+            lastError_ = ENOMEM;
+            return;
+        }
+        buffers_.push_back(static_cast<char *>(buffer));
+        freeBuffers_.push_back(i);
+        iovecs.push_back({ buffer, BUFFER_SIZE });
+    }
+    ring->pending.resize(bufferCount);
+    // Регистрация может не пройти из-за ограничения закрепляемой памяти (RLIMIT_MEMLOCK), тогда
+    // буферы передаются ядру при каждой записи
+    ring->fixedBuffers = syscall(__NR_io_uring_register, ring->fd, IORING_REGISTER_BUFFERS,
+                                 iovecs.data(), static_cast<unsigned>(iovecs.size()))
+                         == 0;
+    ring_ = ring.release();
+#else
+    (void)bufferCount;
+    lastError_ = ENOSYS;
+#endif
+}
+
+IoRing::~IoRing()
+{
+#if defined(OCTET_HAVE_IO_URING)
+    if (ring_ != nullptr) {
+        // Ядро не должно писать из освобождённых буферов
+        while (inFlight_ > 0 && enter(static_cast<unsigned>(inFlight_))) {
+            reap();
+        }
+        delete ring_;
+    }
+    for (auto *buffer : buffers_) {
+        std::free(buffer);
+    }
+#endif
+}
+
+bool IoRing::isSupported() noexcept
+{
+#if defined(OCTET_HAVE_IO_URING)
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool IoRing::isAvailable() const noexcept
+{
+    return ring_ != nullptr;
+}
+
+int IoRing::lastError() const noexcept
+{
+    return lastError_;
+}
+
+bool IoRing::write(int fd, uint64_t offset, const char *data, size_t size, bool sync)
+{
+#if defined(OCTET_HAVE_IO_URING)
+    if (ring_ == nullptr || !drainAndSync(-1, true)) {
+        return false;
+    }
+
+    // Небольшие данные копируются в зарегистрированный буфер, большие передаются напрямую
+    auto *write = ring_->next();
+    if (write == nullptr) {
+        lastError_ = EBUSY;
+        return false;
+    }
+    const auto fixed = ring_->fixedBuffers && size <= BUFFER_SIZE;
+    if (fixed) {
+        std::memcpy(buffers_.front(), data, size);
+        write->opcode = IORING_OP_WRITE_FIXED;
+        write->addr = reinterpret_cast<uint64_t>(buffers_.front());
+        write->buf_index = 0;
+    }
+    else {
+        write->opcode = IORING_OP_WRITE;
+        write->addr = reinterpret_cast<uint64_t>(data);
+    }
+    write->fd = fd;
+    write->off = offset;
+    write->len = static_cast<uint32_t>(std::min<size_t>(size, UINT32_MAX));
+    write->user_data = DIRECT_WRITE_TAG;
+    // Синхронизация выполняется только после успешной полной записи
+    write->flags = sync ? IOSQE_IO_LINK : 0;
+    ring_->commit();
+    inFlight_++;
+
+    if (sync) {
+        auto *fsync = ring_->next();
+        if (fsync == nullptr) {
+            write->flags = 0;
+            sync = false;
+        }
+        else {
+            fsync->opcode = IORING_OP_FSYNC;
+            fsync->fd = fd;
+            fsync->fsync_flags = IORING_FSYNC_DATASYNC;
+            fsync->user_data = SYNC_TAG;
+            ring_->commit();
+            inFlight_++;
+        }
+    }
+    if (!enter(static_cast<unsigned>(inFlight_))) {
+        return false;
+    }
+    reap();
+
+    const auto written = ring_->directResult;
+    if (written < 0) {
+        lastError_ = -written;
+        return false;
+    }
+    if (static_cast<size_t>(written) < size) {
+        // Связанная синхронизация отменена ядром, поэтому остаток дописывается и фиксируется
+        // обычными системными вызовами
+        if (!writeRemainder(fd, offset + static_cast<uint64_t>(written), data + written,
+                            size - static_cast<size_t>(written), lastError_)) {
+            return false;
+        }
+        if (sync && fdatasync(fd) != 0) {
+            lastError_ = errno;
+            return false;
+        }
+        return true;
+    }
+    if (sync && ring_->syncResult < 0) {
+        lastError_ = -ring_->syncResult;
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)offset;
+    (void)data;
+    (void)size;
+    (void)sync;
+    return false;
+#endif
+}
+
+bool IoRing::queueWrite(int fd, uint64_t offset, const char *data, size_t size)
+{
+#if defined(OCTET_HAVE_IO_URING)
+    if (ring_ == nullptr) {
+        return false;
+    }
+    while (size > 0) {
+        // Ждём освобождения буфера, пока ядро выполняет предыдущие записи
+        while (freeBuffers_.empty()) {
+            if (!enter(1)) {
+                return false;
+            }
+            reap();
+        }
+        auto *sqe = ring_->next();
+        if (sqe == nullptr) {
+            lastError_ = EBUSY;
+            return false;
+        }
+        const auto index = freeBuffers_.back();
+        freeBuffers_.pop_back();
+        const auto chunk = std::min(size, BUFFER_SIZE);
+        std::memcpy(buffers_[index], data, chunk);
+
+        sqe->opcode = ring_->fixedBuffers ? IORING_OP_WRITE_FIXED : IORING_OP_WRITE;
+        sqe->fd = fd;
+        sqe->addr = reinterpret_cast<uint64_t>(buffers_[index]);
+        sqe->len = static_cast<uint32_t>(chunk);
+        sqe->off = offset;
+        sqe->buf_index = static_cast<uint16_t>(index);
+        sqe->user_data = index;
+        ring_->commit();
+        ring_->pending[index] = { fd, offset, chunk };
+        inFlight_++;
+        if (!enter(0)) {
+            return false;
+        }
+
+        data += chunk;
+        offset += chunk;
+        size -= chunk;
+    }
+    // Завершённые записи освобождают буферы без ожидания, а ошибка сообщается один раз
+    reap();
+    if (failed_) {
+        failed_ = false;
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)offset;
+    (void)data;
+    (void)size;
+    return false;
+#endif
+}
+
+bool IoRing::drainAndSync(int fd, bool dataOnly)
+{
+#if defined(OCTET_HAVE_IO_URING)
+    if (ring_ == nullptr) {
+        return false;
+    }
+    while (inFlight_ > 0) {
+        if (!enter(static_cast<unsigned>(inFlight_))) {
+            return false;
+        }
+        reap();
+    }
+    if (failed_) {
+        failed_ = false;
+        return false;
+    }
+    // Без дескриптора только дожидаемся поставленных записей
+    if (fd < 0) {
+        return true;
+    }
+
+    auto *sqe = ring_->next();
+    if (sqe == nullptr) {
+        lastError_ = EBUSY;
+        return false;
+    }
+    sqe->opcode = IORING_OP_FSYNC;
+    sqe->fd = fd;
+    sqe->fsync_flags = dataOnly ? IORING_FSYNC_DATASYNC : 0;
+    sqe->user_data = SYNC_TAG;
+    ring_->commit();
+    inFlight_++;
+    if (!enter(1)) {
+        return false;
+    }
+    reap();
+    if (ring_->syncResult < 0) {
+        lastError_ = -ring_->syncResult;
+        return false;
+    }
+    return true;
+#else
+    (void)fd;
+    (void)dataOnly;
+    return false;
+#endif
+}
+
+bool IoRing::enter(unsigned minComplete)
+{
+#if defined(OCTET_HAVE_IO_URING)
+    while (true) {
+        // Ядро продвигает начало кольца отправки по мере приёма операций, поэтому после
+        // прерванного вызова повторно передаются только не принятые операции
+        const auto toSubmit = *ring_->sqTail - loadAcquire(ring_->sqHead);
+        const auto result = syscall(__NR_io_uring_enter, ring_->fd, toSubmit, minComplete,
+                                    minComplete > 0 ? IORING_ENTER_GETEVENTS : 0, nullptr, 0);
+        if (result >= 0) {
+            return true;
+        }
+        if (errno != EINTR) {
+            lastError_ = errno;
+            return false;
+        }
+    }
+#else
+    (void)minComplete;
+    return false;
+#endif
+}
+
+void IoRing::reap()
+{
+#if defined(OCTET_HAVE_IO_URING)
+    auto head = *ring_->cqHead;
+    const auto tail = loadAcquire(ring_->cqTail);
+    for (; head != tail; head++) {
+        const auto &cqe = ring_->cqes[head & *ring_->cqMask];
+        inFlight_--;
+        if (cqe.user_data == SYNC_TAG) {
+            ring_->syncResult = cqe.res;
+            continue;
+        }
+        if (cqe.user_data == DIRECT_WRITE_TAG) {
+            ring_->directResult = cqe.res;
+            continue;
+        }
+
+        const auto index = static_cast<size_t>(cqe.user_data);
+        const auto &write = ring_->pending[index];
+        if (cqe.res < 0) {
+            lastError_ = -cqe.res;
+            failed_ = true;
+        }
+        else if (static_cast<size_t>(cqe.res) < write.size
+                 && !writeRemainder(write.fd, write.offset + static_cast<uint64_t>(cqe.res),
+                                    buffers_[index] + cqe.res,
+                                    write.size - static_cast<size_t>(cqe.res), lastError_)) {
+            failed_ = true;
+        }
+        freeBuffers_.push_back(index);
+    }
+    storeRelease(ring_->cqHead, head);
+#endif
+}
+} // namespace octet::utils
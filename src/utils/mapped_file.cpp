@@ -0,0 +1,103 @@
+#include "utils/mapped_file.hpp"
+
+#if defined(OCTET_PLATFORM_UNIX)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "utils/compiler.hpp"
+#include "utils/file_lock_guard.hpp"
+#include "logger.hpp"
+
+namespace octet::utils {
+MappedFile::MappedFile(const std::filesystem::path &filePath, bool sequential)
+{
+    LOG_DEBUG << "Отображение файла в память: " << filePath.string();
+
+#if defined(OCTET_PLATFORM_UNIX)
+    // Разделяемая блокировка гарантирует, что размер файла не будет зафиксирован посреди
+    // записи другого потока или процесса
+    FileLockGuard lock(filePath, LockMode::SHARED);
+    if (!lock.isLocked()) {
+        LOG_ERROR << "Не удалось получить блокировку для отображения файла: "
+                  << filePath.string();
+        return;
+    }
+
+    const auto fd = open(filePath.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd == -1) {
+        LOG_ERROR << "Не удалось открыть файл для отображения: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return;
+    }
+
+    struct stat fileStat;
+    if (fstat(fd, &fileStat) != 0) {
+        LOG_ERROR << "Не удалось получить размер файла: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        close(fd);
+        return;
+    }
+    if (!S_ISREG(fileStat.st_mode)) {
+        LOG_ERROR << "Невозможно отобразить в память: " << filePath.string()
+                  << " - это не обычный файл";
+        close(fd);
+        return;
+    }
+
+    // Пустой файл отобразить нельзя, но для чтения он корректен
+    const auto fileSize = static_cast<size_t>(fileStat.st_size);
+    if (fileSize == 0) {
+        close(fd);
+        mapped_ = true;
+        return;
+    }
+
+    void *address = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    // Отображение остается действительным и после закрытия дескриптора
+    close(fd);
+    if (address == MAP_FAILED) {
+        LOG_ERROR << "Не удалось отобразить файл в память: " << filePath.string()
+                  << ", ошибка: " << octet::errnoToString(errno);
+        return;
+    }
+
+    if (sequential) {
+        // Подсказка необязательна, поэтому ошибку не обрабатываем
+        madvise(address, fileSize, MADV_SEQUENTIAL);
+    }
+
+    data_ = static_cast<const char *>(address);
+    size_ = fileSize;
+    mapped_ = true;
+#else
+    UNREACHABLE("Unsupported platform");
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined(OCTET_PLATFORM_UNIX)
+    if (data_ != nullptr) {
+        munmap(const_cast<char *>(data_), size_);
+    }
+#endif
+}
+
+bool MappedFile::isMapped() const
+{
+    return mapped_;
+}
+
+std::string_view MappedFile::view() const
+{
+    return std::string_view(data_, size_);
+}
+
+size_t MappedFile::size() const
+{
+    return size_;
+}
+} // namespace octet::utils
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+#include <string>
+
+#include "utils/crc32c.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+// Проверка на известных контрольных значениях CRC32C
+TEST(Crc32cTest, KnownValues)
+{
+    EXPECT_EQ(utils::crc32c("", 0), 0x00000000u);
+    EXPECT_EQ(utils::crc32c("a", 1), 0xC1D04330u);
+    EXPECT_EQ(utils::crc32c("123456789", 9), 0xE3069283u);
+
+    // 32 нулевых байта (тестовый вектор из RFC 3720)
+    const std::string zeros(32, '\0');
+    EXPECT_EQ(utils::crc32c(zeros.data(), zeros.size()), 0x8A9136AAu);
+}
+
+// Проверка продолжения вычисления по частям
+TEST(Crc32cTest, IncrementalComputation)
+{
+    const auto data = generateRandomId(1027);
+    const auto full = utils::crc32c(data.data(), data.size());
+
+    for (const size_t split : { size_t(0), size_t(1), size_t(7), size_t(8), size_t(513) }) {
+        auto crc = utils::crc32c(data.data(), split);
+        crc = utils::crc32c(data.data() + split, data.size() - split, crc);
+        EXPECT_EQ(crc, full) << "Разбиение на позиции " << split;
+    }
+}
+
+// Проверка чувствительности к изменению одного бита
+TEST(Crc32cTest, DetectsBitFlip)
+{
+    auto data = generateRandomId(256);
+    const auto original = utils::crc32c(data.data(), data.size());
+    data[100] ^= 0x04;
+    EXPECT_NE(utils::crc32c(data.data(), data.size()), original);
+}
+} // namespace octet::tests
@@ -4,6 +4,7 @@
 #include <filesystem>
 #include <fstream>
 #include <future>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <vector>
@@ -134,22 +135,32 @@ TEST_F(FileLockGuardTest, LockTestModes)
     const auto &lockPath = paths.second;
     createTestFile(filePath);
 
-    // Тест EXCLUSIVE блокировки в одном и том же потоке
-    // (должно отсекаться на уровне проверки deadlock)
+    // Тест EXCLUSIVE блокировки в одном и том же потоке (блокировка реентерабельна)
     {
         // Получаем эксклюзивную блокировку
         utils::FileLockGuard exclusiveLock(filePath, utils::LockMode::EXCLUSIVE);
         EXPECT_TRUE(exclusiveLock.isLocked());
 
-        // Пытаемся получить ещё одну EXCLUSIVE блокировку в этом же потоке
-        utils::FileLockGuard anotherExclusiveLock(filePath, utils::LockMode::EXCLUSIVE,
-                                                  utils::LockWaitStrategy::INSTANTLY);
-        EXPECT_FALSE(anotherExclusiveLock.isLocked());
+        {
+            // Повторно получаем EXCLUSIVE блокировку в этом же потоке
+            utils::FileLockGuard anotherExclusiveLock(filePath, utils::LockMode::EXCLUSIVE,
+                                                      utils::LockWaitStrategy::INSTANTLY);
+            EXPECT_TRUE(anotherExclusiveLock.isLocked());
+
+            // Получаем SHARED блокировку в этом же потоке (покрывается эксклюзивной)
+            utils::FileLockGuard sharedLock(filePath, utils::LockMode::SHARED,
+                                            utils::LockWaitStrategy::INSTANTLY);
+            EXPECT_TRUE(sharedLock.isLocked());
+        }
 
-        // Пытаемся получить SHARED блокировку в этом же потоке
-        utils::FileLockGuard sharedLock(filePath, utils::LockMode::SHARED,
-                                        utils::LockWaitStrategy::INSTANTLY);
-        EXPECT_FALSE(sharedLock.isLocked());
+        // После освобождения повторных захватов блокировка остается за потоком
+        EXPECT_TRUE(std::filesystem::exists(lockPath));
+        auto future = std::async(std::launch::async, [&filePath]() {
+            utils::FileLockGuard lock(filePath, utils::LockMode::EXCLUSIVE,
+                                      utils::LockWaitStrategy::INSTANTLY);
+            return lock.isLocked();
+        });
+        EXPECT_FALSE(future.get());
     }
     EXPECT_FALSE(std::filesystem::exists(lockPath));
 
@@ -191,7 +202,7 @@ TEST_F(FileLockGuardTest, LockTestModes)
         utils::FileLockGuard sharedLock2(filePath, utils::LockMode::SHARED);
         EXPECT_TRUE(sharedLock2.isLocked());
 
-        // Пытаемся получить EXCLUSIVE блокировку в этом же потоке
+        // Пытаемся повысить блокировку до EXCLUSIVE в этом же потоке
         // (должно отсекаться на уровне проверки deadlock)
         utils::FileLockGuard exclusiveLock(filePath, utils::LockMode::EXCLUSIVE,
                                            utils::LockWaitStrategy::INSTANTLY);
@@ -250,8 +261,8 @@ TEST_F(FileLockGuardTest, LockTestWaitStrategies)
         const auto end = std::chrono::steady_clock::now();
         const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-        // Блокировка должна провалиться практически сразу, так как есть риск deadlock
-        EXPECT_FALSE(lock2.isLocked());
+        // Повторный захват тем же потоком выполняется сразу, без ожидания
+        EXPECT_TRUE(lock2.isLocked());
 
         // Проверка, что стратегия не занимает слишком много времени
         EXPECT_LT(duration.count(), TIME_EPS_FOR_LOCK);
@@ -300,8 +311,8 @@ TEST_F(FileLockGuardTest, LockTestWaitStrategies)
         const auto end = std::chrono::steady_clock::now();
         const auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
 
-        // Блокировка должна провалиться практически сразу, так как есть риск deadlock
-        EXPECT_FALSE(lock2.isLocked());
+        // Повторный захват тем же потоком выполняется сразу, без ожидания
+        EXPECT_TRUE(lock2.isLocked());
 
         // Проверка, что стратегия не занимает слишком много времени
         EXPECT_LT(duration.count(), TIME_EPS_FOR_LOCK);
@@ -336,6 +347,39 @@ TEST_F(FileLockGuardTest, LockTestWaitStrategies)
     EXPECT_FALSE(std::filesystem::exists(lockPath));
 }
 
+// Проверка передачи блокировки ожидающему потоку сразу после освобождения
+TEST_F(FileLockGuardTest, LockTestHandoffToWaiter)
+{
+    const auto [filePath, lockPath] = getTestAndLockPaths();
+    createTestFile(filePath);
+
+    auto lock1 = std::make_unique<utils::FileLockGuard>(filePath);
+    EXPECT_TRUE(lock1->isLocked());
+
+    std::atomic<bool> released = false;
+    auto future = std::async(std::launch::async, [&filePath, &released]() {
+        utils::FileLockGuard lock2(filePath, utils::LockMode::EXCLUSIVE,
+                                   utils::LockWaitStrategy::TIMEOUT, std::chrono::seconds(10));
+        const auto acquiredAt = std::chrono::steady_clock::now();
+        EXPECT_TRUE(released.load());
+        return std::make_pair(lock2.isLocked(), acquiredAt);
+    });
+
+    // Даём потоку немного времени для запуска и освобождаем блокировку
+    std::this_thread::sleep_for(std::chrono::milliseconds(THREAD_START_TIMEOUT_MS));
+    released = true;
+    const auto releasedAt = std::chrono::steady_clock::now();
+    lock1.reset();
+
+    const auto [isLocked, acquiredAt] = future.get();
+    EXPECT_TRUE(isLocked);
+    // Ожидающий поток пробуждается уведомлением, а не по истечении интервала опроса
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(acquiredAt - releasedAt)
+                  .count(),
+              TIME_EPS_FOR_LOCK);
+    EXPECT_FALSE(std::filesystem::exists(lockPath));
+}
+
 // Проверка работы разделяемых блокировок
 TEST_F(FileLockGuardTest, LockTestSharedMode)
 {
@@ -0,0 +1,109 @@
+#include <gtest/gtest.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <filesystem>
+#include <string>
+
+#include "utils/file_utils.hpp"
+#include "utils/io_ring.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+class IoRingTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+
+    void SetUp() override
+    {
+        testDir = createTmpDirectory("IoRing");
+    }
+
+    void TearDown() override { removeTmpDirectory(testDir); }
+
+    /**
+     * @brief Открывает файл для записи
+     * @param name Имя файла в тестовой директории
+     * @param flags Дополнительные флаги открытия
+     * @return Дескриптор файла
+     */
+    int openFile(const std::string &name, int flags = 0) const
+    {
+        return open((testDir / name).c_str(), O_WRONLY | O_CREAT | O_CLOEXEC | flags, 0644);
+    }
+
+    /**
+     * @brief Читает содержимое файла
+     * @param name Имя файла в тестовой директории
+     * @return Содержимое файла
+     */
+    std::string readFile(const std::string &name) const
+    {
+        std::string content;
+        EXPECT_TRUE(utils::safeFileRead(testDir / name, content));
+        return content;
+    }
+};
+
+/**
+ * @brief Тест записи с фиксацией связанной парой операций
+ */
+TEST_F(IoRingTest, WriteAndSync)
+{
+    utils::IoRing ring;
+    if (!ring.isAvailable()) {
+        GTEST_SKIP() << "io_uring недоступен, код ошибки: " << ring.lastError();
+    }
+
+    // Дозапись в файл, открытый с O_APPEND, как в журнале
+    const auto fd = openFile("append.bin", O_APPEND);
+    ASSERT_GE(fd, 0);
+    const auto first = generateLargeString(1000);
+    const auto second = generateLargeString(2000);
+    EXPECT_TRUE(ring.write(fd, 0, first.data(), first.size(), true));
+    EXPECT_TRUE(ring.write(fd, first.size(), second.data(), second.size(), false));
+    // Данные больше буфера передаются ядру без копирования
+    const auto large = generateLargeString(utils::IoRing::BUFFER_SIZE + 12345);
+    EXPECT_TRUE(ring.write(fd, first.size() + second.size(), large.data(), large.size(), true));
+    close(fd);
+    EXPECT_EQ(readFile("append.bin"), first + second + large);
+
+    // Ошибка записи возвращается вызывающему
+    EXPECT_FALSE(ring.write(-1, 0, first.data(), first.size(), true));
+    EXPECT_NE(ring.lastError(), 0);
+}
+
+/**
+ * @brief Тест записи через очередь буферов и её завершения
+ */
+TEST_F(IoRingTest, QueuedWrites)
+{
+    utils::IoRing ring(2);
+    if (!ring.isAvailable()) {
+        GTEST_SKIP() << "io_uring недоступен, код ошибки: " << ring.lastError();
+    }
+
+    const auto fd = openFile("queued.bin", O_TRUNC);
+    ASSERT_GE(fd, 0);
+    // Данных больше, чем буферов, поэтому очередь дожидается освобождения буферов
+    std::string expected;
+    uint64_t offset = 0;
+    for (size_t i = 0; i < 8; i++) {
+        const auto chunk = generateLargeString(300 * 1024 + i * 200 * 1024);
+        ASSERT_TRUE(ring.queueWrite(fd, offset, chunk.data(), chunk.size()));
+        offset += chunk.size();
+        expected += chunk;
+    }
+    EXPECT_TRUE(ring.drainAndSync(fd, false));
+    close(fd);
+    EXPECT_EQ(readFile("queued.bin"), expected);
+
+    // После ошибки очередь остаётся пригодной для новых записей
+    EXPECT_FALSE(ring.queueWrite(-1, 0, expected.data(), 100) && ring.drainAndSync(-1, true));
+    const auto next = openFile("next.bin", O_TRUNC);
+    ASSERT_GE(next, 0);
+    EXPECT_TRUE(ring.queueWrite(next, 0, expected.data(), 100));
+    EXPECT_TRUE(ring.drainAndSync(next, true));
+    close(next);
+    EXPECT_EQ(readFile("next.bin"), expected.substr(0, 100));
+}
+} // namespace octet::tests
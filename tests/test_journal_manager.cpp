@@ -2,6 +2,7 @@
 #include <atomic>
 #include <chrono>
 #include <filesystem>
+#include <fstream>
 #include <future>
 #include <thread>
 #include <unordered_map>
@@ -58,6 +59,35 @@ protected:
         return content.find(pattern) != std::string::npos;
     }
 
+    /**
+     * @brief Считывает все бинарные записи журнала напрямую из файла
+     * @param journalPath Путь к журналу
+     * @return Записи журнала в порядке их следования
+     */
+    std::vector<JournalEntry> readJournalRecords(const std::filesystem::path &journalPath)
+    {
+        std::string content;
+        EXPECT_TRUE(utils::safeFileRead(journalPath, content));
+        // Бинарные записи следуют сразу после текстовой строки заголовка
+        size_t pos = content.find('\n');
+        EXPECT_NE(pos, std::string::npos);
+        pos++;
+
+        std::vector<JournalEntry> entries;
+        while (pos < content.size()) {
+            size_t recordSize = 0;
+            auto entry = JournalEntry::deserialize(std::string_view(content).substr(pos),
+                                                   &recordSize);
+            EXPECT_TRUE(entry.has_value());
+            if (!entry.has_value()) {
+                break;
+            }
+            entries.push_back(std::move(*entry));
+            pos += recordSize;
+        }
+        return entries;
+    }
+
     /**
      * @brief Заполняет журнал тестовыми данными
      * @param journal Ссылка на экземпляр журнала
@@ -154,7 +184,7 @@ TEST_F(JournalManagerTest, JournalInitializationBasic)
     }
 
     // Проверяем, что в журнале есть заголовок
-    EXPECT_TRUE(journalContains(journalPath, "# OCTET Journal Format v1.0"));
+    EXPECT_TRUE(journalContains(journalPath, "# OCTET Journal Format v2.0"));
 }
 
 // Тест инициализации журнала с существующим файлом
@@ -297,25 +327,117 @@ TEST_F(JournalManagerTest, BasicOperations)
     const auto journalPath = getTestJournalPath();
     JournalManager journal(journalPath);
 
+    // Проверяет последнюю запись журнала
+    auto checkLastRecord = [this, &journalPath](size_t expectedCount, OperationType type,
+                                                const std::string &uuid, const std::string &data) {
+        const auto entries = readJournalRecords(journalPath);
+        ASSERT_EQ(entries.size(), expectedCount);
+        EXPECT_EQ(entries.back().type(), type);
+        EXPECT_EQ(entries.back().uuid(), uuid);
+        EXPECT_EQ(entries.back().data(), data);
+        EXPECT_GT(entries.back().timestamp(), 0);
+    };
+
     // Проверяем запись операции INSERT
     const std::string uuid = "test_uuid";
     const std::string insertData = "test_data";
     EXPECT_TRUE(journal.writeOperation(OperationType::INSERT, uuid, insertData));
-    EXPECT_TRUE(journalContains(journalPath, "INSERT|" + uuid));
+    checkLastRecord(1, OperationType::INSERT, uuid, insertData);
 
     // Проверяем запись операции UPDATE
     const std::string updateData = "updated_data";
     EXPECT_TRUE(journal.writeOperation(OperationType::UPDATE, uuid, updateData));
-    EXPECT_TRUE(journalContains(journalPath, "UPDATE|" + uuid));
+    checkLastRecord(2, OperationType::UPDATE, uuid, updateData);
 
     // Проверяем запись операции REMOVE
     EXPECT_TRUE(journal.writeOperation(OperationType::REMOVE, uuid));
-    EXPECT_TRUE(journalContains(journalPath, "REMOVE|" + uuid));
+    checkLastRecord(3, OperationType::REMOVE, uuid, "");
 
     // Проверяем запись контрольной точки
     const std::string checkpointId = "checkpoint_test";
     EXPECT_TRUE(journal.writeCheckpoint(checkpointId));
-    EXPECT_TRUE(journalContains(journalPath, "CHECKPOINT|" + checkpointId));
+    checkLastRecord(4, OperationType::CHECKPOINT, checkpointId, "");
+}
+
+// Тест чтения и перевода в бинарный формат журнала текстового формата v1
+TEST_F(JournalManagerTest, LegacyJournalMigration)
+{
+    const auto journalPath = getTestJournalPath();
+    const std::string legacyJournal = "# OCTET Journal Format v1.0\n"
+                                      "INSERT|uuid1|2023-01-01T12:00:00.000Z|first\\|line\\nnext\n"
+                                      "INSERT|uuid2|2023-01-01T12:01:00.000Z|second\n"
+                                      "CHECKPOINT|checkpoint_1|2023-01-01T12:02:00.000Z|\n"
+                                      "REMOVE|uuid2|2023-01-01T12:03:00.000Z|\n";
+    ASSERT_TRUE(utils::atomicFileWrite(journalPath, legacyJournal));
+
+    JournalManager journal(journalPath);
+    EXPECT_TRUE(journal.isJournalValid());
+    // Журнал переводится в бинарный формат без создания резервной копии
+    EXPECT_TRUE(journalContains(journalPath, "# OCTET Journal Format v2.0"));
+    EXPECT_EQ(countBackups(), 0);
+
+    const auto entries = readJournalRecords(journalPath);
+    ASSERT_EQ(entries.size(), 4);
+    EXPECT_EQ(entries[0].data(), "first|line\nnext");
+    // 2023-01-01T12:00:00Z в наносекундах с начала эпохи
+    EXPECT_EQ(entries[0].timestamp(), 1672574400ULL * 1000000000ULL);
+    EXPECT_EQ(journal.getLastCheckpointId(), "checkpoint_1");
+
+    // Новые записи дописываются уже в бинарном формате
+    EXPECT_TRUE(journal.writeInsert("uuid3", "third"));
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore));
+    EXPECT_EQ(dataStore.size(), 2);
+    EXPECT_EQ(dataStore["uuid1"], "first|line\nnext");
+    EXPECT_EQ(dataStore["uuid3"], "third");
+}
+
+// Тест обнаружения поврежденных и недописанных записей
+TEST_F(JournalManagerTest, TornAndCorruptedRecords)
+{
+    const auto journalPath = getTestJournalPath();
+    {
+        JournalManager journal(journalPath);
+        for (size_t i = 0; i < 5; i++) {
+            EXPECT_TRUE(journal.writeInsert("uuid_" + std::to_string(i), "data"));
+        }
+    }
+
+    // Имитируем недописанную при сбое запись в конце журнала
+    std::string content;
+    ASSERT_TRUE(utils::safeFileRead(journalPath, content));
+    const auto validSize = content.size();
+    const auto tornRecord = JournalEntry(OperationType::INSERT, "uuid_torn", "torn").serialize();
+    ASSERT_TRUE(utils::safeFileAppend(journalPath, tornRecord.substr(0, tornRecord.size() / 2)));
+
+    {
+        JournalManager journal(journalPath);
+        // Недописанный хвост отрезается с созданием резервной копии
+        EXPECT_EQ(countBackups(), 1);
+        EXPECT_EQ(std::filesystem::file_size(journalPath), validSize);
+        EXPECT_TRUE(journal.isJournalValid());
+
+        // Новые записи после восстановления читаются корректно
+        EXPECT_TRUE(journal.writeInsert("uuid_after", "data"));
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        EXPECT_EQ(dataStore.size(), 6);
+    }
+
+    // Повреждаем байт данных во второй записи: чтение останавливается на ней
+    ASSERT_TRUE(utils::safeFileRead(journalPath, content));
+    const auto secondRecordPos = content.find("uuid_1");
+    ASSERT_NE(secondRecordPos, std::string::npos);
+    content[secondRecordPos + 6] ^= 0x01;
+    ASSERT_TRUE(utils::atomicFileWrite(journalPath, content));
+
+    {
+        JournalManager journal(journalPath);
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        EXPECT_EQ(dataStore.size(), 1);
+        EXPECT_EQ(dataStore.count("uuid_0"), 1);
+    }
 }
 
 // Тест базового воспроизведения журнала
@@ -536,6 +658,510 @@ TEST_F(JournalManagerTest, TruncateJournalToCheckpoint)
     EXPECT_EQ(*lastCheckpoint, checkpoint2);
 }
 
+// Тест восстановления с использованием индекса смещений контрольных точек
+TEST_F(JournalManagerTest, CheckpointIndexSeek)
+{
+    const auto journalPath = getTestJournalPath();
+    const auto indexPath = std::filesystem::path(journalPath.string() + ".checkpoints");
+    JournalManager journal(journalPath);
+
+    for (size_t i = 0; i < 5; i++) {
+        EXPECT_TRUE(journal.writeInsert("uuid_before_" + std::to_string(i), "data"));
+    }
+    const std::string checkpoint = "checkpoint_1";
+    EXPECT_TRUE(journal.writeCheckpoint(checkpoint));
+    for (size_t i = 0; i < 3; i++) {
+        EXPECT_TRUE(journal.writeInsert("uuid_after_" + std::to_string(i), "data"));
+    }
+    EXPECT_TRUE(utils::checkIfFileExists(indexPath, false));
+
+    // Портим запись до контрольной точки прямо в файле: при чтении всего журнала контрольная
+    // точка не была бы найдена, а при переходе по индексу запись до неё не читается
+    std::string content;
+    ASSERT_TRUE(utils::safeFileRead(journalPath, content));
+    const auto corruptedPos = content.find("uuid_before_0");
+    ASSERT_NE(corruptedPos, std::string::npos);
+    {
+        std::fstream file(journalPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(corruptedPos));
+        file.put('X');
+    }
+
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore, checkpoint));
+    EXPECT_EQ(dataStore.size(), 3);
+    EXPECT_EQ(dataStore.count("uuid_after_0"), 1);
+
+    // Очистка журнала также находит контрольную точку по индексу
+    EXPECT_TRUE(journal.truncateJournalToCheckpoint(checkpoint));
+    EXPECT_FALSE(journalContains(journalPath, "before_0"));
+    EXPECT_TRUE(journal.isJournalValid());
+}
+
+// Тест восстановления при устаревшем или поврежденном индексе контрольных точек
+TEST_F(JournalManagerTest, CheckpointIndexFallback)
+{
+    const auto journalPath = getTestJournalPath();
+    const auto indexPath = std::filesystem::path(journalPath.string() + ".checkpoints");
+    std::string staleIndex;
+    {
+        JournalManager journal(journalPath);
+        EXPECT_TRUE(journal.writeInsert("uuid_1", "data_1"));
+        EXPECT_TRUE(journal.writeCheckpoint("checkpoint_1"));
+        ASSERT_TRUE(utils::safeFileRead(indexPath, staleIndex));
+
+        EXPECT_TRUE(journal.writeInsert("uuid_2", "data_2"));
+        EXPECT_TRUE(journal.writeCheckpoint("checkpoint_2"));
+        EXPECT_TRUE(journal.writeInsert("uuid_3", "data_3"));
+    }
+
+    // Индекс не содержит последнюю контрольную точку (например, сбой произошел до его
+    // обновления): она находится при дочитывании хвоста журнала
+    ASSERT_TRUE(utils::atomicFileWrite(indexPath, staleIndex));
+    {
+        JournalManager journal(journalPath);
+        const auto lastCheckpoint = journal.getLastCheckpointId();
+        ASSERT_TRUE(lastCheckpoint.has_value());
+        EXPECT_EQ(*lastCheckpoint, "checkpoint_2");
+
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore, *lastCheckpoint));
+        EXPECT_EQ(dataStore.size(), 1);
+        EXPECT_EQ(dataStore["uuid_3"], "data_3");
+    }
+
+    // Поврежденный индекс игнорируется, и журнал читается целиком
+    ASSERT_TRUE(utils::atomicFileWrite(indexPath, "garbage"));
+    {
+        JournalManager journal(journalPath);
+        const auto lastCheckpoint = journal.getLastCheckpointId();
+        ASSERT_TRUE(lastCheckpoint.has_value());
+        EXPECT_EQ(*lastCheckpoint, "checkpoint_2");
+
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore, "checkpoint_1"));
+        EXPECT_EQ(dataStore.size(), 2);
+        EXPECT_FALSE(journal.replayJournal(dataStore, "checkpoint_unknown"));
+    }
+
+    // После полного чтения индекс восстанавливается
+    std::string rebuiltIndex;
+    ASSERT_TRUE(utils::safeFileRead(indexPath, rebuiltIndex));
+    EXPECT_NE(rebuiltIndex.find("checkpoint_2"), std::string::npos);
+}
+
+// Тест перехода на новый сегмент журнала по контрольной точке и удаления старых сегментов
+TEST_F(JournalManagerTest, SegmentRotation)
+{
+    for (const auto mode : { DurabilityMode::SYNC, DurabilityMode::GROUP_COMMIT }) {
+        const auto journalDir = testDir / (mode == DurabilityMode::SYNC ? "sync" : "group");
+        const auto journalPath = getTestJournalPath(journalDir);
+        const auto sealedPath = std::filesystem::path(journalPath.string() + ".000001");
+        {
+            JournalManager journal(journalPath, DurabilityPolicy{ mode });
+            EXPECT_TRUE(journal.writeInsert("uuid_1", "data_1"));
+            EXPECT_TRUE(journal.writeInsert("uuid_2", "data_2"));
+            const auto sizeBefore = journal.getActiveSegmentSize();
+
+            const std::string checkpoint = "checkpoint_1";
+            const auto ticket = journal.submitCheckpoint(checkpoint, true);
+            ASSERT_TRUE(journal.waitForCheckpoint(ticket, checkpoint));
+            EXPECT_TRUE(journal.writeUpdate("uuid_1", "data_1_updated"));
+            EXPECT_TRUE(journal.writeInsert("uuid_3", "data_3"));
+
+            // Старый сегмент запечатан, а новый начинается с контрольной точки
+            ASSERT_TRUE(std::filesystem::exists(sealedPath));
+            EXPECT_EQ(std::filesystem::file_size(sealedPath), sizeBefore);
+            const auto activeRecords = readJournalRecords(journalPath);
+            ASSERT_EQ(activeRecords.size(), 3);
+            EXPECT_EQ(activeRecords[0].type(), OperationType::CHECKPOINT);
+            EXPECT_EQ(activeRecords[0].uuid(), checkpoint);
+            EXPECT_EQ(journal.getActiveSegmentSize(), std::filesystem::file_size(journalPath));
+
+            // Полное воспроизведение читает все сегменты по порядку
+            std::unordered_map<std::string, std::string> dataStore;
+            EXPECT_TRUE(journal.replayJournal(dataStore));
+            EXPECT_EQ(dataStore.size(), 3);
+            EXPECT_EQ(dataStore["uuid_1"], "data_1_updated");
+            EXPECT_TRUE(journal.isJournalValid());
+
+            // Сегменты до контрольной точки удаляются, записи после неё сохраняются
+            EXPECT_TRUE(journal.removeSegmentsBeforeCheckpoint(checkpoint));
+            EXPECT_FALSE(std::filesystem::exists(sealedPath));
+        }
+
+        JournalManager journal(journalPath, DurabilityPolicy{ mode });
+        const auto lastCheckpoint = journal.getLastCheckpointId();
+        ASSERT_TRUE(lastCheckpoint.has_value());
+        EXPECT_EQ(*lastCheckpoint, "checkpoint_1");
+
+        std::unordered_map<std::string, std::string> dataStore{ { "uuid_1", "data_1" },
+                                                                { "uuid_2", "data_2" } };
+        EXPECT_TRUE(journal.replayJournal(dataStore, lastCheckpoint));
+        EXPECT_EQ(dataStore.size(), 3);
+        EXPECT_EQ(dataStore["uuid_1"], "data_1_updated");
+        EXPECT_EQ(dataStore["uuid_3"], "data_3");
+    }
+}
+
+// Тест поиска контрольной точки в запечатанных сегментах без индекса
+TEST_F(JournalManagerTest, SegmentRotationWithoutIndex)
+{
+    const auto journalPath = getTestJournalPath();
+    const auto indexPath = std::filesystem::path(journalPath.string() + ".checkpoints");
+    {
+        JournalManager journal(journalPath);
+        EXPECT_TRUE(journal.writeInsert("uuid_1", "data_1"));
+        EXPECT_TRUE(journal.writeCheckpoint("checkpoint_1"));
+        EXPECT_TRUE(journal.writeInsert("uuid_2", "data_2"));
+        const auto ticket = journal.submitCheckpoint("checkpoint_2", true);
+        ASSERT_TRUE(journal.waitForCheckpoint(ticket, "checkpoint_2"));
+        EXPECT_TRUE(journal.writeInsert("uuid_3", "data_3"));
+    }
+    ASSERT_TRUE(std::filesystem::remove(indexPath));
+
+    JournalManager journal(journalPath);
+    const auto lastCheckpoint = journal.getLastCheckpointId();
+    ASSERT_TRUE(lastCheckpoint.has_value());
+    EXPECT_EQ(*lastCheckpoint, "checkpoint_2");
+
+    // Контрольная точка из запечатанного сегмента находится при чтении всех сегментов
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore, "checkpoint_1"));
+    EXPECT_EQ(dataStore.size(), 2);
+    EXPECT_EQ(dataStore.count("uuid_1"), 0);
+
+    // Очистка переписывает только сегмент с контрольной точкой, начиная с неё
+    const auto sealedPath = std::filesystem::path(journalPath.string() + ".000001");
+    EXPECT_TRUE(journal.truncateJournalToCheckpoint("checkpoint_1"));
+    ASSERT_TRUE(std::filesystem::exists(sealedPath));
+    EXPECT_FALSE(journalContains(sealedPath, "uuid_1"));
+    EXPECT_TRUE(journalContains(journalPath, "uuid_3"));
+    dataStore.clear();
+    EXPECT_TRUE(journal.replayJournal(dataStore, "checkpoint_1"));
+    EXPECT_EQ(dataStore.size(), 2);
+
+    // Для контрольной точки в начале сегмента предшествующие сегменты просто удаляются
+    const auto activeSize = std::filesystem::file_size(journalPath);
+    EXPECT_TRUE(journal.truncateJournalToCheckpoint("checkpoint_2"));
+    EXPECT_FALSE(std::filesystem::exists(sealedPath));
+    EXPECT_EQ(std::filesystem::file_size(journalPath), activeSize);
+    EXPECT_EQ(journal.getJournalSize(), activeSize);
+}
+
+// Тест перехода по индексу к контрольной точке в запечатанном сегменте
+TEST_F(JournalManagerTest, CheckpointIndexSealedSegment)
+{
+    const auto journalPath = getTestJournalPath();
+    const auto checkpoint = std::string("checkpoint_1");
+    {
+        JournalManager journal(journalPath);
+        journal.setSegmentSize(512);
+        for (size_t i = 0; i < 3; i++) {
+            EXPECT_TRUE(journal.writeInsert("uuid_before_" + std::to_string(i), "data"));
+        }
+        EXPECT_TRUE(journal.writeCheckpoint(checkpoint));
+        for (size_t i = 0; i < 40; i++) {
+            EXPECT_TRUE(journal.writeInsert("uuid_after_" + std::to_string(i), "data"));
+        }
+    }
+
+    // Контрольная точка оказалась в первом запечатанном сегменте, а после него запечатаны другие
+    const auto sealedPath = std::filesystem::path(journalPath.string() + ".000001");
+    ASSERT_TRUE(journalContains(sealedPath, checkpoint));
+    ASSERT_TRUE(std::filesystem::exists(journalPath.string() + ".000002"));
+
+    // Портим запись до контрольной точки в её сегменте: при чтении сегмента целиком точка не
+    // была бы найдена, а при переходе по индексу запись до неё не читается
+    std::string content;
+    ASSERT_TRUE(utils::safeFileRead(sealedPath, content));
+    const auto corruptedPos = content.find("uuid_before_0");
+    ASSERT_NE(corruptedPos, std::string::npos);
+    {
+        std::fstream file(sealedPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(static_cast<std::streamoff>(corruptedPos));
+        file.put('X');
+    }
+
+    JournalManager journal(journalPath);
+    const auto lastCheckpoint = journal.getLastCheckpointId();
+    ASSERT_TRUE(lastCheckpoint.has_value());
+    EXPECT_EQ(*lastCheckpoint, checkpoint);
+
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore, checkpoint));
+    EXPECT_EQ(dataStore.size(), 40);
+    EXPECT_EQ(dataStore.count("uuid_before_1"), 0);
+
+    // Читатель другого процесса также начинает с сегмента контрольной точки
+    JournalReader reader(journalPath);
+    size_t readCount = 0;
+    EXPECT_TRUE(reader.open(checkpoint, [&readCount](const JournalEntryView &) {
+        readCount++;
+        return true;
+    }));
+    EXPECT_EQ(readCount, 40);
+
+    // Очистка переходит к сегменту контрольной точки и удаляет испорченную запись
+    EXPECT_TRUE(journal.truncateJournalToCheckpoint(checkpoint));
+    EXPECT_FALSE(journalContains(sealedPath, "uuid_before_"));
+    EXPECT_TRUE(journal.isJournalValid());
+    dataStore.clear();
+    EXPECT_TRUE(journal.replayJournal(dataStore, checkpoint));
+    EXPECT_EQ(dataStore.size(), 40);
+}
+
+// Тест продолжения чтения по ссылке контрольной точки после уплотнения журнала
+TEST_F(JournalManagerTest, ReaderFollowsCheckpointLink)
+{
+    const auto journalPath = getTestJournalPath();
+    JournalManager journal(journalPath);
+    auto insertRecords = [&journal](const std::string &prefix, size_t count) {
+        for (size_t i = 0; i < count; i++) {
+            EXPECT_TRUE(journal.writeInsert(prefix + std::to_string(i), "data"));
+        }
+    };
+
+    // Читатель получает и записи контрольных точек
+    std::vector<std::string> records;
+    const auto handler = [&records](const JournalEntryView &entry) {
+        records.push_back(entry.type == OperationType::CHECKPOINT ? "checkpoint:"
+                                                                      + std::string(entry.uuid)
+                                                                  : std::string(entry.uuid));
+        return true;
+    };
+    EXPECT_TRUE(journal.writeCheckpoint("checkpoint_1"));
+    insertRecords("uuid_first_", 5);
+    JournalReader reader(journalPath, true);
+    ASSERT_TRUE(reader.open("checkpoint_1", handler));
+    EXPECT_EQ(records.size(), 5);
+
+    // Пройденная контрольная точка становится началом отсчёта положения
+    EXPECT_TRUE(journal.writeCheckpoint("checkpoint_2"));
+    insertRecords("uuid_second_", 5);
+    records.clear();
+    ASSERT_TRUE(reader.poll(handler));
+    ASSERT_EQ(records.size(), 6);
+    EXPECT_EQ(records.front(), "checkpoint:checkpoint_2");
+    ASSERT_TRUE(reader.getCheckpointId().has_value());
+    EXPECT_EQ(*reader.getCheckpointId(), "checkpoint_2");
+    EXPECT_EQ(reader.getOperationCount(), 5);
+
+    // Уплотнение удаляет сегмент с точкой читателя, но новая точка ссылается на неё и на все
+    // прочитанные операции, поэтому чтение продолжается с новой точки
+    const auto ticket = journal.submitCheckpoint("checkpoint_3", true);
+    ASSERT_TRUE(journal.waitForCheckpoint(ticket, "checkpoint_3"));
+    ASSERT_TRUE(journal.removeSegmentsBeforeCheckpoint("checkpoint_3"));
+    ASSERT_FALSE(std::filesystem::exists(journalPath.string() + ".000001"));
+    insertRecords("uuid_third_", 2);
+    records.clear();
+    ASSERT_TRUE(reader.poll(handler));
+    EXPECT_EQ(records, std::vector<std::string>(
+                           { "checkpoint:checkpoint_3", "uuid_third_0", "uuid_third_1" }));
+    EXPECT_EQ(*reader.getCheckpointId(), "checkpoint_3");
+    EXPECT_EQ(reader.getOperationCount(), 2);
+
+    // Читатель, не получивший часть операций перед удалённой точкой, положение не находит
+    JournalReader lagging(journalPath);
+    EXPECT_FALSE(lagging.open("checkpoint_2", handler, 3));
+    JournalReader resumed(journalPath);
+    records.clear();
+    ASSERT_TRUE(resumed.open("checkpoint_2", handler, 5));
+    EXPECT_EQ(records, std::vector<std::string>({ "uuid_third_0", "uuid_third_1" }));
+}
+
+// Тест перехода на новый сегмент по размеру и восстановления из множества сегментов
+TEST_F(JournalManagerTest, SegmentSizeRotation)
+{
+    const auto journalPath = getTestJournalPath();
+    std::unordered_map<std::string, std::string> expectedData;
+    auto countSegments = [&] {
+        size_t count = 0;
+        for (const auto &item : std::filesystem::directory_iterator(testDir)) {
+            if (item.path().string().rfind(journalPath.string() + ".0", 0) == 0) {
+                count++;
+            }
+        }
+        return count;
+    };
+
+    {
+        JournalManager journal(journalPath, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT });
+        journal.setSegmentSize(512);
+
+        for (size_t i = 0; i < 100; i++) {
+            const auto uuid = "uuid_" + std::to_string(i);
+            const auto data = "data_" + std::to_string(i);
+            EXPECT_TRUE(journal.writeInsert(uuid, data));
+            expectedData[uuid] = data;
+            if (i % 3 == 0) {
+                EXPECT_TRUE(journal.writeUpdate(uuid, data + "_updated"));
+                expectedData[uuid] = data + "_updated";
+            }
+            if (i % 7 == 0) {
+                EXPECT_TRUE(journal.writeRemove(uuid));
+                expectedData.erase(uuid);
+            }
+        }
+        EXPECT_GT(countSegments(), 5);
+        EXPECT_LE(std::filesystem::file_size(journalPath), 512 + 64);
+
+        // Суммарный размер журнала учитывает все сегменты
+        uint64_t totalSize = 0;
+        for (const auto &item : std::filesystem::directory_iterator(testDir)) {
+            const auto path = item.path().string();
+            if (path == journalPath.string() || path.rfind(journalPath.string() + ".0", 0) == 0) {
+                totalSize += std::filesystem::file_size(item.path());
+            }
+        }
+        EXPECT_EQ(journal.getJournalSize(), totalSize);
+        EXPECT_TRUE(journal.isJournalValid());
+    }
+
+    // Сегменты проверяются параллельно, но применяются в исходном порядке
+    JournalManager journal(journalPath);
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore));
+    EXPECT_EQ(dataStore, expectedData);
+
+    // Повреждение запечатанного сегмента обнаруживается при проверке журнала
+    const auto sealedPath = std::filesystem::path(journalPath.string() + ".000002");
+    ASSERT_TRUE(std::filesystem::exists(sealedPath));
+    {
+        std::fstream file(sealedPath, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('X');
+    }
+    EXPECT_FALSE(journal.isJournalValid());
+}
+
+// Тест записи журнала через io_uring (без поддержки журнал пишется обычными вызовами)
+TEST_F(JournalManagerTest, IoUringBackend)
+{
+    const auto journalPath = getTestJournalPath();
+    std::unordered_map<std::string, std::string> expectedData;
+    for (const auto mode : { DurabilityMode::SYNC, DurabilityMode::GROUP_COMMIT,
+                             DurabilityMode::INTERVAL }) {
+        DurabilityPolicy policy{ mode };
+        policy.ioBackend = IoBackend::IO_URING;
+        JournalManager journal(journalPath, policy);
+        if (journal.getIoBackend() != IoBackend::IO_URING) {
+            GTEST_SKIP() << "io_uring недоступен";
+        }
+        journal.setSegmentSize(4096);
+
+        std::vector<std::future<bool>> futures;
+        for (size_t t = 0; t < 4; t++) {
+            futures.push_back(std::async(std::launch::async, [&journal, mode, t]() {
+                bool result = true;
+                for (size_t i = 0; i < 50; i++) {
+                    const auto suffix = std::to_string(static_cast<int>(mode)) + "_"
+                                        + std::to_string(t) + "_" + std::to_string(i);
+                    result &= journal.writeInsert("uuid_" + suffix, "data_" + suffix);
+                }
+                return result;
+            }));
+        }
+        for (auto &future : futures) {
+            EXPECT_TRUE(future.get());
+        }
+        for (size_t t = 0; t < 4; t++) {
+            for (size_t i = 0; i < 50; i++) {
+                const auto suffix = std::to_string(static_cast<int>(mode)) + "_"
+                                    + std::to_string(t) + "_" + std::to_string(i);
+                expectedData["uuid_" + suffix] = "data_" + suffix;
+            }
+        }
+        // Контрольная точка, начинающая сегмент, делит пакет на две записи
+        const auto checkpointId = "checkpoint_" + std::to_string(static_cast<int>(mode));
+        const auto ticket = journal.submitCheckpoint(checkpointId, true);
+        ASSERT_NE(ticket, nullptr);
+        EXPECT_TRUE(journal.waitForCheckpoint(ticket, checkpointId));
+        EXPECT_TRUE(journal.isJournalValid());
+    }
+
+    JournalManager journal(journalPath);
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore));
+    EXPECT_EQ(dataStore, expectedData);
+}
+
+// Тест сжатия запечатанных сегментов журнала
+TEST_F(JournalManagerTest, CompressedSealedSegments)
+{
+    EXPECT_TRUE(JournalManager::isCompressionCodecSupported(CompressionCodec::NONE));
+    bool tested = false;
+    for (const auto codec : { CompressionCodec::LZ4, CompressionCodec::ZSTD }) {
+        if (!JournalManager::isCompressionCodecSupported(codec)) {
+            continue;
+        }
+        tested = true;
+        const auto journalDir
+            = testDir / (codec == CompressionCodec::LZ4 ? "lz4_segments" : "zstd_segments");
+        const auto journalPath = getTestJournalPath(journalDir);
+        std::unordered_map<std::string, std::string> expectedData;
+        std::vector<std::filesystem::path> sealedPaths;
+        uint64_t sizeBefore = 0;
+        {
+            JournalManager journal(journalPath, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT });
+            journal.setSegmentSize(4096);
+            for (size_t i = 0; i < 200; i++) {
+                const auto uuid = "uuid_" + std::to_string(i);
+                const auto data = "{\"id\": " + std::to_string(i)
+                                  + ", \"name\": \"compressible value\", \"tags\": [\"a\", \"b\"]}";
+                EXPECT_TRUE(journal.writeInsert(uuid, data));
+                expectedData[uuid] = data;
+            }
+            EXPECT_TRUE(journal.writeRemove("uuid_0"));
+            expectedData.erase("uuid_0");
+
+            for (const auto &item : std::filesystem::directory_iterator(journalDir)) {
+                if (item.path().string().rfind(journalPath.string() + ".0", 0) == 0) {
+                    sealedPaths.push_back(item.path());
+                }
+            }
+            ASSERT_GT(sealedPaths.size(), 2);
+            sizeBefore = journal.getJournalSize();
+
+            // Без установленного алгоритма сегменты не изменяются
+            EXPECT_TRUE(journal.compressSealedSegments());
+            EXPECT_EQ(journal.getJournalSize(), sizeBefore);
+
+            ASSERT_TRUE(journal.setCompressionCodec(codec));
+            EXPECT_TRUE(journal.compressSealedSegments());
+            EXPECT_LT(journal.getJournalSize(), sizeBefore);
+            for (const auto &path : sealedPaths) {
+                std::string content;
+                ASSERT_TRUE(utils::safeFileRead(path, content));
+                EXPECT_EQ(content.substr(0, 8), "OCTJSEGZ");
+            }
+            EXPECT_TRUE(journal.isJournalValid());
+
+            // Повторное сжатие не затрагивает уже сжатые сегменты
+            const auto compressedSize = journal.getJournalSize();
+            EXPECT_TRUE(journal.compressSealedSegments());
+            EXPECT_EQ(journal.getJournalSize(), compressedSize);
+        }
+
+        // Сжатые сегменты читаются независимо от настройки алгоритма
+        JournalManager journal(journalPath);
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        EXPECT_EQ(dataStore, expectedData);
+
+        // Сжатые сегменты до контрольной точки удаляются как обычные
+        const auto ticket = journal.submitCheckpoint("checkpoint_1", true);
+        ASSERT_TRUE(journal.waitForCheckpoint(ticket, "checkpoint_1"));
+        EXPECT_TRUE(journal.removeSegmentsBeforeCheckpoint("checkpoint_1"));
+        for (const auto &path : sealedPaths) {
+            EXPECT_FALSE(std::filesystem::exists(path));
+        }
+    }
+    if (!tested) {
+        GTEST_SKIP() << "Библиотека собрана без поддержки сжатия";
+    }
+}
+
 // TODO: тест рабочий, но пока отключаем его, чтобы сильно не изнашивать диск
 // Тест с очень большими данными
 // TEST_F(JournalManagerTest, LargeData)
@@ -740,6 +1366,160 @@ TEST_F(JournalManagerTest, ConcurrentWrite)
     EXPECT_EQ(dataStore.size(), THREAD_COUNT * OPERATIONS_PER_THREAD);
 }
 
+// Стресс-тест параллельной записи в журнал в режиме группового коммита
+TEST_F(JournalManagerTest, GroupCommitConcurrentWrite)
+{
+    const auto journalPath = getTestJournalPath();
+    constexpr size_t THREAD_COUNT = 20;
+    constexpr size_t OPERATIONS_PER_THREAD = 50;
+
+    {
+        JournalManager journal(journalPath, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT });
+
+        std::vector<std::future<bool>> futures;
+        for (size_t i = 0; i < THREAD_COUNT; i++) {
+            futures.push_back(std::async(std::launch::async, [&journal, i]() {
+                bool result = true;
+                for (size_t j = 0; j < OPERATIONS_PER_THREAD; j++) {
+                    const auto uuid
+                        = "uuid_thread_" + std::to_string(i) + "_op_" + std::to_string(j);
+                    const auto data
+                        = "data_thread_" + std::to_string(i) + "_op_" + std::to_string(j);
+                    result &= journal.writeInsert(uuid, data);
+                }
+                return result;
+            }));
+        }
+
+        bool allSucceeded = true;
+        for (auto &future : futures) {
+            allSucceeded &= future.get();
+        }
+        EXPECT_TRUE(allSucceeded);
+
+        // После подтверждения фиксации все записи уже должны быть в файле
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        EXPECT_EQ(dataStore.size(), THREAD_COUNT * OPERATIONS_PER_THREAD);
+    }
+
+    // Проверяем, что журнал читается новым экземпляром
+    JournalManager journal(journalPath);
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore));
+    EXPECT_EQ(dataStore.size(), THREAD_COUNT * OPERATIONS_PER_THREAD);
+    EXPECT_EQ(dataStore["uuid_thread_3_op_7"], "data_thread_3_op_7");
+}
+
+// Тест упорядочивания записей по зарезервированным номерам
+TEST_F(JournalManagerTest, SequencedSubmitOrder)
+{
+    for (const auto mode : { DurabilityMode::SYNC, DurabilityMode::GROUP_COMMIT }) {
+        const auto journalDir = testDir / (mode == DurabilityMode::SYNC ? "sync" : "group");
+        const auto journalPath = getTestJournalPath(journalDir);
+        JournalManager journal(journalPath, DurabilityPolicy{ mode });
+
+        const auto insertSequence = journal.reserveSequence();
+        const auto invalidSequence = journal.reserveSequence();
+        const auto updateSequence = journal.reserveSequence();
+
+        // Операция с большим номером ставится первой, но попадает в журнал только после
+        // операций с меньшими номерами
+        auto updateFuture = std::async(std::launch::async, [&] {
+            return journal.waitForCommit(
+                journal.submitOperation(updateSequence, OperationType::UPDATE, "uuid", "new"));
+        });
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        EXPECT_EQ(updateFuture.wait_for(std::chrono::milliseconds(0)),
+                  std::future_status::timeout);
+
+        // Некорректная операция не записывается, но освобождает очередь для следующих номеров
+        auto insertTicket
+            = journal.submitOperation(insertSequence, OperationType::INSERT, "uuid", "old");
+        EXPECT_EQ(journal.submitOperation(invalidSequence, OperationType::INSERT, "", "data"),
+                  nullptr);
+        EXPECT_TRUE(journal.waitForCommit(insertTicket));
+        EXPECT_TRUE(updateFuture.get());
+
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        ASSERT_EQ(dataStore.size(), 1);
+        EXPECT_EQ(dataStore["uuid"], "new");
+    }
+}
+
+// Тест раздельной постановки операций в очередь и ожидания их фиксации
+TEST_F(JournalManagerTest, GroupCommitSubmitAndWait)
+{
+    const auto journalPath = getTestJournalPath();
+    JournalManager journal(journalPath, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT });
+
+    // Несколько операций подряд без ожидания
+    std::vector<JournalTicket> tickets;
+    for (size_t i = 0; i < 10; i++) {
+        tickets.push_back(journal.submitOperation(OperationType::INSERT,
+                                                  "uuid_" + std::to_string(i),
+                                                  "data_" + std::to_string(i)));
+        ASSERT_NE(tickets.back(), nullptr);
+    }
+    tickets.push_back(journal.submitOperation(OperationType::REMOVE, "uuid_0"));
+
+    for (const auto &ticket : tickets) {
+        EXPECT_TRUE(journal.waitForCommit(ticket));
+    }
+    // Повторное ожидание уже зафиксированной операции не блокируется
+    EXPECT_TRUE(journal.waitForCommit(tickets.front()));
+
+    // Операция с пустым UUID отклоняется сразу
+    const auto invalidTicket = journal.submitOperation(OperationType::INSERT, "", "data");
+    EXPECT_EQ(invalidTicket, nullptr);
+    EXPECT_FALSE(journal.waitForCommit(invalidTicket));
+
+    std::unordered_map<std::string, std::string> dataStore;
+    EXPECT_TRUE(journal.replayJournal(dataStore));
+    EXPECT_EQ(dataStore.size(), 9);
+    EXPECT_EQ(dataStore.count("uuid_0"), 0);
+    EXPECT_EQ(dataStore["uuid_9"], "data_9");
+}
+
+// Тест постановки пакета операций в журнал одной квитанцией
+TEST_F(JournalManagerTest, SubmitOperationsBatch)
+{
+    for (const auto mode : { DurabilityMode::SYNC, DurabilityMode::GROUP_COMMIT }) {
+        const auto journalDir = testDir / (mode == DurabilityMode::SYNC ? "sync" : "group");
+        const auto journalPath = getTestJournalPath(journalDir);
+        JournalManager journal(journalPath, DurabilityPolicy{ mode });
+
+        const std::vector<JournalOperationView> operations = {
+            { OperationType::INSERT, "uuid_1", "data_1" },
+            { OperationType::INSERT, "uuid_2", "data_2" },
+            { OperationType::UPDATE, "uuid_1", "updated_1" },
+            { OperationType::REMOVE, "uuid_2", "" },
+        };
+        const auto firstSequence = journal.reserveSequences(operations.size());
+        const auto ticket = journal.submitOperations(firstSequence, operations);
+        ASSERT_NE(ticket, nullptr);
+        EXPECT_TRUE(journal.waitForCommit(ticket));
+
+        // Пакет с некорректной операцией не записывается целиком, но его номера освобождаются
+        const std::vector<JournalOperationView> invalidOperations = {
+            { OperationType::INSERT, "uuid_3", "data_3" },
+            { OperationType::INSERT, "", "data_4" },
+        };
+        const auto invalidSequence = journal.reserveSequences(invalidOperations.size());
+        EXPECT_EQ(journal.submitOperations(invalidSequence, invalidOperations), nullptr);
+        EXPECT_EQ(journal.submitOperations(journal.reserveSequences(0), {}), nullptr);
+        EXPECT_TRUE(journal.writeInsert("uuid_5", "data_5"));
+
+        std::unordered_map<std::string, std::string> dataStore;
+        EXPECT_TRUE(journal.replayJournal(dataStore));
+        ASSERT_EQ(dataStore.size(), 2);
+        EXPECT_EQ(dataStore["uuid_1"], "updated_1");
+        EXPECT_EQ(dataStore["uuid_5"], "data_5");
+        EXPECT_EQ(journal.countOperationsSinceLastCheckpoint(), 5);
+    }
+}
+
 // Тест параллельной записи и чтения журнала
 TEST_F(JournalManagerTest, ConcurrentWriteAndRead)
 {
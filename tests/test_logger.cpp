@@ -0,0 +1,129 @@
+#include <gtest/gtest.h>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "logger.hpp"
+#include "testing_utils.hpp"
+
+namespace {
+static constexpr int THREADS_COUNT = 4;
+// Больше размера кольцевого буфера потока, чтобы проверить ожидание свободного места
+static constexpr int MESSAGES_PER_THREAD = 3000;
+
+/**
+ * @brief Тип, считающий, сколько раз его выводили в поток
+ */
+struct CountedValue {
+    int *counter;
+};
+
+std::ostream &operator<<(std::ostream &os, const CountedValue &value)
+{
+    ++*value.counter;
+    return os << "counted";
+}
+} // namespace
+
+namespace octet::tests {
+class LoggerTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+    std::filesystem::path logPath; // Путь к файлу лога
+
+    void SetUp() override
+    {
+        testDir = createTmpDirectory("Logger");
+        logPath = testDir / "octet.log";
+        Logger::getInstance().enable(false, logPath, LogLevel::INFO, false, false);
+    }
+
+    void TearDown() override
+    {
+        // Возвращаем логгер в исходное (отключенное) состояние и закрываем файл лога
+        auto &logger = Logger::getInstance();
+        logger.setAsync(false);
+        logger.enable(false, std::nullopt, LogLevel::INFO, false, false);
+        logger.disable();
+        removeTmpDirectory(testDir);
+    }
+
+    /**
+     * @brief Читает строки файла лога
+     * @return Строки файла
+     */
+    std::vector<std::string> readLines() const
+    {
+        std::vector<std::string> lines;
+        std::ifstream file(logPath);
+        for (std::string line; std::getline(file, line);) {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+};
+
+// Проверка вывода сообщений нескольких потоков в асинхронном режиме
+TEST_F(LoggerTest, AsyncPreservesPerThreadOrder)
+{
+    auto &logger = Logger::getInstance();
+    logger.setAsync(true);
+    ASSERT_TRUE(logger.isAsync());
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < THREADS_COUNT; ++t) {
+        threads.emplace_back([t] {
+            for (int i = 0; i < MESSAGES_PER_THREAD; ++i) {
+                LOG_INFO << "thread " << t << " message " << i;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    // Сообщения завершившихся потоков тоже должны быть выведены
+    logger.flush();
+
+    std::vector<int> next(THREADS_COUNT, 0);
+    for (const auto &line : readLines()) {
+        int t = 0;
+        int i = 0;
+        if (std::sscanf(line.c_str(), "thread %d message %d", &t, &i) != 2) {
+            continue;
+        }
+        ASSERT_GE(t, 0);
+        ASSERT_LT(t, THREADS_COUNT);
+        EXPECT_EQ(i, next[t]) << "Нарушен порядок сообщений потока " << t;
+        next[t] = i + 1;
+    }
+    for (int t = 0; t < THREADS_COUNT; ++t) {
+        EXPECT_EQ(next[t], MESSAGES_PER_THREAD) << "Потеряны сообщения потока " << t;
+    }
+
+    // После отключения асинхронного режима сообщение записывается сразу
+    logger.setAsync(false);
+    EXPECT_FALSE(logger.isAsync());
+    LOG_INFO << "sync message";
+    const auto lines = readLines();
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines.back(), "sync message");
+}
+
+// Проверка, что сообщение ниже минимального уровня не форматируется
+TEST_F(LoggerTest, SkipsFormattingBelowMinLevel)
+{
+    int counter = 0;
+    LOG_DEBUG << CountedValue{ &counter };
+    LogStream(LogLevel::DEBUG, __FILE__, __LINE__) << CountedValue{ &counter };
+    EXPECT_EQ(counter, 0);
+
+    LOG_INFO << CountedValue{ &counter };
+    EXPECT_EQ(counter, 1);
+    const auto lines = readLines();
+    ASSERT_FALSE(lines.empty());
+    EXPECT_EQ(lines.back(), "counted");
+}
+} // namespace octet::tests
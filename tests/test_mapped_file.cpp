@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+
+#include "utils/file_utils.hpp"
+#include "utils/mapped_file.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+class MappedFileTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+
+    void SetUp() override
+    {
+        // Создаем временную директорию для тестов
+        testDir = createTmpDirectory("MappedFile");
+    }
+
+    void TearDown() override
+    {
+        // Удаляем временную директорию
+        removeTmpDirectory(testDir);
+    }
+};
+
+// Тест отображения файла с содержимым
+TEST_F(MappedFileTest, MapFileContent)
+{
+    const auto filePath = testDir / "data.bin";
+    const auto content = generateLargeString(1024 * 1024);
+    ASSERT_TRUE(utils::atomicFileWrite(filePath, content));
+
+    utils::MappedFile file(filePath);
+    ASSERT_TRUE(file.isMapped());
+    EXPECT_EQ(file.size(), content.size());
+    EXPECT_EQ(file.view(), content);
+}
+
+// Тест отображения пустого файла
+TEST_F(MappedFileTest, MapEmptyFile)
+{
+    const auto filePath = testDir / "empty.bin";
+    ASSERT_TRUE(utils::atomicFileWrite(filePath, ""));
+
+    utils::MappedFile file(filePath);
+    EXPECT_TRUE(file.isMapped());
+    EXPECT_EQ(file.size(), 0);
+    EXPECT_TRUE(file.view().empty());
+}
+
+// Тест отображения несуществующего файла и директории
+TEST_F(MappedFileTest, MapInvalidPath)
+{
+    utils::MappedFile missing(testDir / "missing.bin");
+    EXPECT_FALSE(missing.isMapped());
+    EXPECT_TRUE(missing.view().empty());
+
+    utils::MappedFile directory(testDir);
+    EXPECT_FALSE(directory.isMapped());
+}
+
+// Тест неизменности отображения при дописывании и замене файла
+TEST_F(MappedFileTest, MappingIsStable)
+{
+    const auto filePath = testDir / "data.bin";
+    const std::string content = "initial content";
+    ASSERT_TRUE(utils::atomicFileWrite(filePath, content));
+
+    utils::MappedFile file(filePath);
+    ASSERT_TRUE(file.isMapped());
+
+    // Дописанные данные не попадают в уже существующее отображение
+    ASSERT_TRUE(utils::safeFileAppend(filePath, " appended"));
+    EXPECT_EQ(file.view(), content);
+
+    // Атомарная замена файла не влияет на уже существующее отображение
+    ASSERT_TRUE(utils::atomicFileWrite(filePath, "replaced"));
+    EXPECT_EQ(file.view(), content);
+
+    utils::MappedFile replaced(filePath);
+    EXPECT_EQ(replaced.view(), "replaced");
+}
+} // namespace octet::tests
@@ -0,0 +1,156 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/storage_manager.hpp"
+#include "metrics.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+/**
+ * @brief Тест границ корзин распределения
+ */
+TEST(MetricsTest, HistogramBuckets)
+{
+    // Малые значения хранятся точно
+    for (uint64_t value = 0; value < HistogramSnapshot::SUB_BUCKET_COUNT; value++) {
+        EXPECT_EQ(HistogramSnapshot::bucketIndex(value), value);
+        EXPECT_EQ(HistogramSnapshot::bucketUpperBound(value), value);
+    }
+
+    // Каждое значение попадает в корзину, верхняя граница которой не меньше значения, а
+    // относительная погрешность не превышает 1 / SUB_BUCKET_COUNT
+    for (uint64_t value = 1; value < (uint64_t(1) << 40); value = value * 3 + 1) {
+        const auto index = HistogramSnapshot::bucketIndex(value);
+        ASSERT_LT(index, HistogramSnapshot::BUCKET_COUNT);
+        const auto upper = HistogramSnapshot::bucketUpperBound(index);
+        EXPECT_GE(upper, value);
+        EXPECT_LE(static_cast<double>(upper - value),
+                  static_cast<double>(value) / HistogramSnapshot::SUB_BUCKET_COUNT);
+        // Корзины упорядочены по значениям
+        EXPECT_EQ(HistogramSnapshot::bucketIndex(upper), index);
+        EXPECT_EQ(HistogramSnapshot::bucketIndex(upper + 1), index + 1);
+    }
+
+    // Слишком большие значения попадают в последнюю корзину
+    EXPECT_EQ(HistogramSnapshot::bucketIndex(UINT64_MAX), HistogramSnapshot::BUCKET_COUNT - 1);
+    EXPECT_EQ(HistogramSnapshot::bucketUpperBound(HistogramSnapshot::BUCKET_COUNT - 1),
+              HistogramSnapshot::MAX_TRACKABLE_VALUE);
+}
+
+/**
+ * @brief Тест вычисления квантилей
+ */
+TEST(MetricsTest, HistogramQuantiles)
+{
+    HistogramSnapshot histogram;
+    EXPECT_EQ(histogram.valueAtQuantile(0.5), 0);
+    EXPECT_EQ(histogram.mean(), 0.0);
+
+    histogram.buckets.assign(HistogramSnapshot::BUCKET_COUNT, 0);
+    for (uint64_t value = 1; value <= 1000; value++) {
+        histogram.buckets[HistogramSnapshot::bucketIndex(value)]++;
+        histogram.count++;
+        histogram.sum += value;
+        histogram.max = value;
+    }
+    EXPECT_DOUBLE_EQ(histogram.mean(), 500.5);
+    EXPECT_NEAR(histogram.valueAtQuantile(0.5), 500, 500 / HistogramSnapshot::SUB_BUCKET_COUNT);
+    EXPECT_NEAR(histogram.valueAtQuantile(0.99), 990, 990 / HistogramSnapshot::SUB_BUCKET_COUNT);
+    EXPECT_EQ(histogram.valueAtQuantile(1.0), 1000);
+    EXPECT_EQ(histogram.valueAtQuantile(0.0), 1);
+}
+
+/**
+ * @brief Тест суммирования значений нескольких потоков
+ */
+TEST(MetricsTest, AggregatesThreads)
+{
+    auto &metrics = Metrics::getInstance();
+    const auto before = metrics.snapshot();
+
+    constexpr size_t THREADS = 4;
+    constexpr size_t ITERATIONS = 1000;
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < THREADS; i++) {
+        threads.emplace_back([&metrics] {
+            for (size_t j = 0; j < ITERATIONS; j++) {
+                metrics.increment(MetricCounter::JOURNAL_FSYNCS);
+                metrics.record(MetricHistogram::WRITE_QUEUE_DEPTH, j);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    // Значения завершившихся потоков сохраняются
+    const auto after = metrics.snapshot();
+    EXPECT_EQ(after.counter(MetricCounter::JOURNAL_FSYNCS)
+                  - before.counter(MetricCounter::JOURNAL_FSYNCS),
+              THREADS * ITERATIONS);
+    EXPECT_EQ(after.histogram(MetricHistogram::WRITE_QUEUE_DEPTH).count
+                  - before.histogram(MetricHistogram::WRITE_QUEUE_DEPTH).count,
+              THREADS * ITERATIONS);
+    EXPECT_GE(after.histogram(MetricHistogram::WRITE_QUEUE_DEPTH).max, ITERATIONS - 1);
+
+    metrics.setGauge(MetricGauge::LOADED_ENTRIES, 10);
+    metrics.addGauge(MetricGauge::LOADED_ENTRIES, -3);
+    EXPECT_EQ(metrics.snapshot().gauge(MetricGauge::LOADED_ENTRIES), 7);
+}
+
+/**
+ * @brief Тест учёта операций хранилища и вывода в формате Prometheus
+ */
+TEST(MetricsTest, StorageOperations)
+{
+    const auto testDir = createTmpDirectory("Metrics");
+    auto &metrics = Metrics::getInstance();
+    const auto before = metrics.snapshot();
+    {
+        StorageManager manager(testDir);
+        manager.setSnapshotMode(SnapshotMode::COPY);
+        const auto uuid = manager.insert("value");
+        ASSERT_TRUE(uuid.has_value());
+        EXPECT_TRUE(manager.get(*uuid).has_value());
+        EXPECT_TRUE(manager.update(*uuid, "updated"));
+        EXPECT_TRUE(manager.createSnapshot());
+        EXPECT_TRUE(manager.remove(*uuid));
+    }
+    const auto after = metrics.snapshot();
+    removeTmpDirectory(testDir);
+
+    const auto countOf = [&](MetricHistogram metric) {
+        return after.histogram(metric).count - before.histogram(metric).count;
+    };
+    EXPECT_EQ(countOf(MetricHistogram::STORAGE_INSERT), 1);
+    EXPECT_EQ(countOf(MetricHistogram::STORAGE_GET), 1);
+    EXPECT_EQ(countOf(MetricHistogram::STORAGE_UPDATE), 1);
+    EXPECT_EQ(countOf(MetricHistogram::STORAGE_REMOVE), 1);
+    EXPECT_EQ(countOf(MetricHistogram::LOAD), 1);
+    EXPECT_GE(countOf(MetricHistogram::SNAPSHOT), 1);
+    EXPECT_GE(countOf(MetricHistogram::JOURNAL_APPEND), 1);
+    EXPECT_GE(countOf(MetricHistogram::LOCK_WAIT), 1);
+    EXPECT_GT(after.counter(MetricCounter::JOURNAL_BYTES),
+              before.counter(MetricCounter::JOURNAL_BYTES));
+    EXPECT_GT(after.gauge(MetricGauge::SNAPSHOT_SIZE), 0);
+
+    const auto text = after.toPrometheus();
+    EXPECT_NE(text.find("# TYPE octet_storage_operation_duration_seconds summary\n"),
+              std::string::npos);
+    EXPECT_NE(text.find("octet_storage_operation_duration_seconds{operation=\"insert\","
+                        "quantile=\"0.99\"} "),
+              std::string::npos);
+    EXPECT_NE(text.find("octet_storage_operation_duration_seconds_count{operation=\"get\"} "),
+              std::string::npos);
+    EXPECT_NE(text.find("octet_snapshot_size_bytes{kind=\"full\"} "), std::string::npos);
+    EXPECT_NE(text.find("octet_value_memory_bytes{kind=\"reserved\"} "), std::string::npos);
+    // Заголовок показателя с несколькими метками выводится один раз
+    const auto header = std::string("# HELP octet_snapshot_size_bytes ");
+    const auto first = text.find(header);
+    ASSERT_NE(first, std::string::npos);
+    EXPECT_EQ(text.find(header, first + 1), std::string::npos);
+}
+} // namespace octet::tests
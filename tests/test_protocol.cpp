@@ -0,0 +1,664 @@
+#include <gtest/gtest.h>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "3rdparty/json.hpp"
+#include "server/frame_buffer.hpp"
+#include "server/protocol.hpp"
+#include "storage/uuid_generator.hpp"
+
+namespace octet::tests {
+using server::CommandType;
+using server::FrameBuffer;
+using server::MessageFormat;
+using server::ProtocolFrame;
+using server::Request;
+using server::RequestOperation;
+using server::Response;
+
+class ProtocolTest : public ::testing::Test {
+protected:
+    UuidGenerator generator;
+
+    /**
+     * @brief Создаёт запрос с обязательными полями
+     * @param command Команда запроса
+     * @return Запрос
+     */
+    static Request makeRequest(CommandType command)
+    {
+        Request request;
+        request.requestId = "request-" + std::to_string(static_cast<int>(command));
+        request.command = command;
+        return request;
+    }
+
+    /**
+     * @brief Создаёт по одному запросу каждой команды двоичного формата
+     * @return Запросы
+     */
+    std::vector<Request> makeRequests()
+    {
+        std::vector<Request> requests;
+
+        auto insert = makeRequest(CommandType::INSERT);
+        insert.data = "inserted data";
+        requests.push_back(insert);
+
+        auto get = makeRequest(CommandType::GET);
+        get.uuid = generator.generateUuid();
+        requests.push_back(get);
+
+        auto update = makeRequest(CommandType::UPDATE);
+        update.uuid = generator.generateUuid();
+        update.data = std::string("updated\0data", 12);
+        requests.push_back(update);
+
+        auto remove = makeRequest(CommandType::REMOVE);
+        remove.uuid = generator.generateUuid();
+        requests.push_back(remove);
+
+        auto batch = makeRequest(CommandType::BATCH);
+        batch.operations = std::vector<RequestOperation>{
+            { CommandType::INSERT, std::nullopt, std::string("batch insert") },
+            { CommandType::UPDATE, generator.generateUuid(), std::string() },
+            { CommandType::REMOVE, generator.generateUuid(), std::nullopt },
+        };
+        requests.push_back(batch);
+
+        auto mget = makeRequest(CommandType::MGET);
+        mget.uuids = std::vector<std::string>{ generator.generateUuid(),
+                                               generator.generateUuid() };
+        requests.push_back(mget);
+
+        requests.push_back(makeRequest(CommandType::PING));
+        requests.push_back(makeRequest(CommandType::STATS));
+
+        auto import = makeRequest(CommandType::IMPORT);
+        import.values = std::vector<std::string>{ "first", "", std::string(300, 'v') };
+        import.partial = true;
+        requests.push_back(import);
+
+        auto subscribe = makeRequest(CommandType::SUBSCRIBE);
+        subscribe.position = ReplicationPosition{ "checkpoint", 42, 3 };
+        requests.push_back(subscribe);
+
+        auto journal = makeRequest(CommandType::SUBSCRIBE);
+        journal.position = ReplicationPosition{ "checkpoint", 7, std::nullopt };
+        requests.push_back(journal);
+
+        // Пустые списки отличаются от отсутствующих
+        auto empty = makeRequest(CommandType::MGET);
+        empty.uuids = std::vector<std::string>();
+        requests.push_back(empty);
+        return requests;
+    }
+
+    /**
+     * @brief Создаёт ответы со всеми полями двоичного формата
+     * @return Ответы
+     */
+    std::vector<Response> makeResponses()
+    {
+        std::vector<Response> responses;
+
+        Response uuid{};
+        uuid.requestId = "uuid";
+        uuid.success = true;
+        uuid.uuid = generator.generateUuid();
+        responses.push_back(uuid);
+
+        Response data{};
+        data.requestId = "data";
+        data.success = true;
+        data.data = std::string("value\0with zero", 15);
+        responses.push_back(data);
+
+        Response uuids{};
+        uuids.requestId = "uuids";
+        uuids.success = true;
+        uuids.uuids = std::vector<std::string>{ generator.generateUuid(),
+                                                generator.generateUuid() };
+        responses.push_back(uuids);
+
+        Response values{};
+        values.requestId = "values";
+        values.success = true;
+        values.values = std::vector<std::optional<std::string>>{ std::string("found"),
+                                                                 std::nullopt, std::string() };
+        responses.push_back(values);
+
+        Response error{};
+        error.requestId = "error";
+        error.success = false;
+        error.error = "Failed to import values";
+        error.uuids = std::vector<std::string>{ generator.generateUuid() };
+        responses.push_back(error);
+
+        Response chunk{};
+        chunk.requestId = "subscribe";
+        chunk.success = true;
+        chunk.data = "records";
+        chunk.position = ReplicationPosition{ "checkpoint", 0, 0 };
+        chunk.reset = true;
+        responses.push_back(chunk);
+
+        Response empty{};
+        empty.requestId = std::string();
+        empty.success = true;
+        responses.push_back(empty);
+        return responses;
+    }
+
+    /**
+     * @brief Проверяет, что запросы совпадают
+     * @param expected Исходный запрос
+     * @param actual Разобранный запрос
+     */
+    static void expectSameRequest(const Request &expected, const Request &actual)
+    {
+        EXPECT_EQ(actual.requestId, expected.requestId);
+        EXPECT_EQ(actual.command, expected.command);
+        EXPECT_EQ(actual.uuid, expected.uuid);
+        EXPECT_EQ(actual.payload(), expected.payload());
+        EXPECT_EQ(actual.uuids, expected.uuids);
+        EXPECT_EQ(actual.values, expected.values);
+        EXPECT_EQ(actual.partial, expected.partial);
+        EXPECT_EQ(actual.position, expected.position);
+        ASSERT_EQ(actual.operations.has_value(), expected.operations.has_value());
+        if (expected.operations.has_value()) {
+            ASSERT_EQ(actual.operations->size(), expected.operations->size());
+            for (size_t i = 0; i < expected.operations->size(); i++) {
+                const auto &operation = (*actual.operations)[i];
+                EXPECT_EQ(operation.command, (*expected.operations)[i].command);
+                EXPECT_EQ(operation.uuid, (*expected.operations)[i].uuid);
+                EXPECT_EQ(operation.data, (*expected.operations)[i].data);
+            }
+        }
+    }
+
+    /**
+     * @brief Проверяет, что ответы совпадают
+     * @param expected Исходный ответ
+     * @param actual Разобранный ответ
+     */
+    static void expectSameResponse(const Response &expected, const Response &actual)
+    {
+        EXPECT_EQ(actual.requestId, expected.requestId);
+        EXPECT_EQ(actual.success, expected.success);
+        EXPECT_EQ(actual.uuid, expected.uuid);
+        EXPECT_EQ(actual.data, expected.data);
+        EXPECT_EQ(actual.uuids, expected.uuids);
+        EXPECT_EQ(actual.values, expected.values);
+        EXPECT_EQ(actual.error, expected.error);
+        EXPECT_EQ(actual.position, expected.position);
+        EXPECT_EQ(actual.reset, expected.reset);
+    }
+
+    /**
+     * @brief Начинает двоичный запрос: сигнатура, команда, флаги и идентификатор
+     * @param command Код команды
+     * @param flags Флаги полей
+     * @return Начало сообщения
+     */
+    static std::string binaryRequestHeader(uint8_t command, uint8_t flags)
+    {
+        std::string message{ static_cast<char>(server::BINARY_MESSAGE_MAGIC),
+                             static_cast<char>(command), static_cast<char>(flags) };
+        appendInteger(message, static_cast<uint16_t>(2));
+        message += "id";
+        return message;
+    }
+
+    /**
+     * @brief Начинает двоичный ответ: сигнатура, флаги и идентификатор
+     * @param flags Флаги полей
+     * @return Начало сообщения
+     */
+    static std::string binaryResponseHeader(uint8_t flags)
+    {
+        std::string message{ static_cast<char>(server::BINARY_MESSAGE_MAGIC),
+                             static_cast<char>(flags) };
+        appendInteger(message, static_cast<uint16_t>(2));
+        message += "id";
+        return message;
+    }
+
+    /**
+     * @brief Дописывает целое число в формате little-endian
+     * @param out Строка для результата
+     * @param value Число
+     */
+    template <typename T>
+    static void appendInteger(std::string &out, T value)
+    {
+        for (size_t i = 0; i < sizeof(T); i++) {
+            out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+        }
+    }
+
+    /**
+     * @brief Дописывает байты в буфер чтения, как это делает чтение из сокета
+     * @param buffer Буфер чтения
+     * @param bytes Данные
+     */
+    static void appendToBuffer(FrameBuffer &buffer, std::string_view bytes)
+    {
+        auto *data = buffer.prepare(bytes.size());
+        std::memcpy(data, bytes.data(), bytes.size());
+        buffer.commit(bytes.size());
+    }
+
+    /**
+     * @brief Создаёт кадр: заголовок длины и сообщение
+     * @param message Сообщение
+     * @return Байты кадра
+     */
+    static std::string makeFrame(std::string_view message)
+    {
+        const auto header = ProtocolFrame::encodeLength(static_cast<uint32_t>(message.size()));
+        std::string frame(header.begin(), header.end());
+        frame.append(message);
+        return frame;
+    }
+};
+
+// Все команды двоичного формата проходят сериализацию и разбор без изменений
+TEST_F(ProtocolTest, RequestBinaryRoundTrip)
+{
+    for (const auto &request : makeRequests()) {
+        SCOPED_TRACE(request.requestId);
+        std::string message;
+        ASSERT_TRUE(request.toBinary(message));
+        EXPECT_EQ(ProtocolFrame::messageFormat(message), MessageFormat::BINARY);
+
+        const auto parsed = Request::fromBinary(message);
+        ASSERT_TRUE(parsed.has_value());
+        expectSameRequest(request, *parsed);
+
+        // Формат определяется по первому байту сообщения
+        const auto dispatched = Request::parse(message);
+        ASSERT_TRUE(dispatched.has_value());
+        expectSameRequest(request, *dispatched);
+    }
+}
+
+// Запрос без двоичного представления не сериализуется
+TEST_F(ProtocolTest, RequestBinaryUnsupported)
+{
+    std::string message;
+    EXPECT_FALSE(makeRequest(CommandType::UNKNOWN).toBinary(message));
+
+    auto get = makeRequest(CommandType::GET);
+    get.uuid = "not-a-canonical-uuid";
+    EXPECT_FALSE(get.toBinary(message));
+
+    auto subscribe = makeRequest(CommandType::SUBSCRIBE);
+    subscribe.position = ReplicationPosition{ "checkpoint", 0,
+                                              std::numeric_limits<uint32_t>::max() };
+    EXPECT_FALSE(subscribe.toBinary(message));
+
+    auto longId = makeRequest(CommandType::PING);
+    longId.requestId.assign(std::numeric_limits<uint16_t>::max() + 1, 'r');
+    EXPECT_FALSE(longId.toBinary(message));
+
+    // Неизвестный код команды разбирается, но не сопоставляется ни с одной командой
+    const auto unknown = Request::fromBinary(binaryRequestHeader(200, 0));
+    ASSERT_TRUE(unknown.has_value());
+    EXPECT_EQ(unknown->command, CommandType::UNKNOWN);
+}
+
+// Все поля ответа проходят сериализацию и разбор без изменений
+TEST_F(ProtocolTest, ResponseBinaryRoundTrip)
+{
+    for (const auto &response : makeResponses()) {
+        SCOPED_TRACE(response.requestId);
+        std::string message;
+        ASSERT_TRUE(response.toBinary(message));
+        const auto parsed = Response::fromBinary(message);
+        ASSERT_TRUE(parsed.has_value());
+        expectSameResponse(response, *parsed);
+    }
+
+    // Данные, не принадлежащие ответу, сериализуются как обычные данные
+    const std::string records = "records";
+    Response view{};
+    view.requestId = "view";
+    view.success = true;
+    view.dataView = records;
+    std::string message;
+    ASSERT_TRUE(view.toBinary(message));
+    const auto parsed = Response::fromBinary(message);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->data, records);
+
+    // UUID не в каноническом виде нельзя передать в двоичном формате
+    Response invalid{};
+    invalid.requestId = "invalid";
+    invalid.success = true;
+    invalid.uuids = std::vector<std::string>{ "not-a-canonical-uuid" };
+    EXPECT_FALSE(invalid.toBinary(message));
+}
+
+// Любое усечённое сообщение отклоняется
+TEST_F(ProtocolTest, RejectsTruncatedMessages)
+{
+    for (const auto &request : makeRequests()) {
+        SCOPED_TRACE(request.requestId);
+        std::string message;
+        ASSERT_TRUE(request.toBinary(message));
+        for (size_t size = 0; size < message.size(); size++) {
+            ASSERT_FALSE(Request::fromBinary(message.substr(0, size)).has_value()) << size;
+        }
+    }
+    for (const auto &response : makeResponses()) {
+        SCOPED_TRACE(response.requestId);
+        std::string message;
+        ASSERT_TRUE(response.toBinary(message));
+        for (size_t size = 0; size < message.size(); size++) {
+            ASSERT_FALSE(Response::fromBinary(message.substr(0, size)).has_value()) << size;
+        }
+    }
+}
+
+// Сообщение с лишними байтами после последнего поля отклоняется
+TEST_F(ProtocolTest, RejectsTrailingBytes)
+{
+    for (const auto &request : makeRequests()) {
+        SCOPED_TRACE(request.requestId);
+        std::string message;
+        ASSERT_TRUE(request.toBinary(message));
+        EXPECT_FALSE(Request::fromBinary(message + '\0').has_value());
+    }
+    for (const auto &response : makeResponses()) {
+        SCOPED_TRACE(response.requestId);
+        std::string message;
+        ASSERT_TRUE(response.toBinary(message));
+        EXPECT_FALSE(Response::fromBinary(message + '\0').has_value());
+    }
+
+    // Сообщение с другой сигнатурой не является двоичным
+    std::string message;
+    ASSERT_TRUE(makeRequest(CommandType::PING).toBinary(message));
+    message[0] = '{';
+    EXPECT_FALSE(Request::fromBinary(message).has_value());
+    EXPECT_EQ(ProtocolFrame::messageFormat(message), MessageFormat::JSON);
+}
+
+// Количество элементов и длина данных, не помещающиеся в сообщение, отклоняются до выделения
+// памяти под них
+TEST_F(ProtocolTest, RejectsOversizedCounts)
+{
+    constexpr uint8_t GET = 2;
+    constexpr uint8_t BATCH = 5;
+    constexpr uint8_t MGET = 6;
+    constexpr uint8_t IMPORT = 9;
+    constexpr uint8_t HAS_DATA = 0x02;
+    constexpr uint8_t HAS_UUIDS = 0x04;
+    constexpr uint8_t HAS_OPERATIONS = 0x08;
+    constexpr uint8_t HAS_VALUES = 0x10;
+    constexpr auto MAX_COUNT = std::numeric_limits<uint32_t>::max();
+    const std::string uuidBytes(sizeof(Uuid), '\x11');
+
+    // UUID по 16 байт: два помещаются, а три уже нет
+    auto mget = binaryRequestHeader(MGET, HAS_UUIDS);
+    appendInteger(mget, static_cast<uint32_t>(2));
+    mget += uuidBytes + uuidBytes;
+    const auto parsed = Request::fromBinary(mget);
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->uuids->size(), 2U);
+
+    auto tooManyUuids = binaryRequestHeader(MGET, HAS_UUIDS);
+    appendInteger(tooManyUuids, static_cast<uint32_t>(3));
+    tooManyUuids += uuidBytes + uuidBytes;
+    EXPECT_FALSE(Request::fromBinary(tooManyUuids).has_value());
+
+    auto maxUuids = binaryRequestHeader(MGET, HAS_UUIDS);
+    appendInteger(maxUuids, MAX_COUNT);
+    maxUuids += uuidBytes;
+    EXPECT_FALSE(Request::fromBinary(maxUuids).has_value());
+
+    // Операции пакета - не меньше 2 байт каждая
+    auto batch = binaryRequestHeader(BATCH, HAS_OPERATIONS);
+    appendInteger(batch, MAX_COUNT);
+    batch += std::string(8, '\0');
+    EXPECT_FALSE(Request::fromBinary(batch).has_value());
+
+    // Строки загрузки - не меньше 4 байт длины каждая
+    auto import = binaryRequestHeader(IMPORT, HAS_VALUES);
+    appendInteger(import, MAX_COUNT / 2);
+    import += std::string(16, '\0');
+    EXPECT_FALSE(Request::fromBinary(import).has_value());
+
+    // Количество помещается, но строка длиннее оставшейся части сообщения
+    auto longValue = binaryRequestHeader(IMPORT, HAS_VALUES);
+    appendInteger(longValue, static_cast<uint32_t>(1));
+    appendInteger(longValue, static_cast<uint32_t>(100));
+    longValue += "short";
+    EXPECT_FALSE(Request::fromBinary(longValue).has_value());
+
+    // Длина данных больше сообщения
+    auto data = binaryRequestHeader(GET, HAS_DATA);
+    appendInteger(data, MAX_COUNT);
+    data += "data";
+    EXPECT_FALSE(Request::fromBinary(data).has_value());
+    EXPECT_FALSE(Request::fromBinary(data, std::make_shared<int>(0)).has_value());
+
+    // То же для ответа: UUID и значения MGET (не меньше 1 байта каждое)
+    constexpr uint8_t RESPONSE_HAS_UUIDS = 0x08;
+    constexpr uint8_t RESPONSE_HAS_VALUES = 0x10;
+    auto uuids = binaryResponseHeader(RESPONSE_HAS_UUIDS);
+    appendInteger(uuids, MAX_COUNT);
+    uuids += uuidBytes;
+    EXPECT_FALSE(Response::fromBinary(uuids).has_value());
+
+    auto values = binaryResponseHeader(RESPONSE_HAS_VALUES);
+    appendInteger(values, MAX_COUNT);
+    values += std::string(4, '\0');
+    EXPECT_FALSE(Response::fromBinary(values).has_value());
+}
+
+// Крупные данные запроса читаются на месте в памяти кадра, мелкие копируются
+TEST_F(ProtocolTest, LargeDataReadInPlace)
+{
+    auto insert = makeRequest(CommandType::INSERT);
+    insert.data = std::string(64 * 1024, 'd');
+    std::string message;
+    ASSERT_TRUE(insert.toBinary(message));
+
+    const auto owner = std::make_shared<int>(0);
+    const auto shared = Request::fromBinary(message, owner);
+    ASSERT_TRUE(shared.has_value());
+    ASSERT_TRUE(shared->dataView.has_value());
+    EXPECT_FALSE(shared->data.has_value());
+    EXPECT_EQ(shared->payload(), insert.data);
+    EXPECT_GE(shared->dataView->data(), message.data());
+    EXPECT_LE(shared->dataView->data() + shared->dataView->size(),
+              message.data() + message.size());
+    EXPECT_EQ(shared->frame, owner);
+
+    // Повторная сериализация использует данные на месте
+    std::string copy;
+    ASSERT_TRUE(shared->toBinary(copy));
+    EXPECT_EQ(copy, message);
+
+    // Без владельца памяти данные копируются
+    const auto copied = Request::fromBinary(message);
+    ASSERT_TRUE(copied.has_value());
+    EXPECT_FALSE(copied->dataView.has_value());
+    EXPECT_EQ(copied->data, insert.data);
+
+    // Мелкие данные копируются, и память кадра не удерживается
+    insert.data = "small";
+    ASSERT_TRUE(insert.toBinary(message));
+    const auto small = Request::fromBinary(message, owner);
+    ASSERT_TRUE(small.has_value());
+    EXPECT_FALSE(small->dataView.has_value());
+    EXPECT_EQ(small->data, insert.data);
+    EXPECT_EQ(small->frame, nullptr);
+}
+
+// Разбор JSON-запросов и сериализация JSON-ответов
+TEST_F(ProtocolTest, JsonMessages)
+{
+    const auto uuid = generator.generateUuid();
+    const auto parsed = Request::parse(R"({"request_id": "json", "command": "import",
+        "params": {"values": ["a", "b"], "partial": true, "uuid": ")"
+                                       + uuid + R"("}})");
+    ASSERT_TRUE(parsed.has_value());
+    EXPECT_EQ(parsed->requestId, "json");
+    EXPECT_EQ(parsed->command, CommandType::IMPORT);
+    EXPECT_EQ(parsed->uuid, uuid);
+    EXPECT_EQ(parsed->values, (std::vector<std::string>{ "a", "b" }));
+    EXPECT_TRUE(parsed->partial);
+
+    const auto batch = Request::fromJson(R"({"request_id": "batch", "command": "batch",
+        "params": {"operations": [{"command": "insert", "data": "x"},
+                                  {"command": "remove", "uuid": ")"
+                                         + uuid + R"("}]}})");
+    ASSERT_TRUE(batch.has_value());
+    ASSERT_EQ(batch->operations->size(), 2U);
+    EXPECT_EQ((*batch->operations)[0].command, CommandType::INSERT);
+    EXPECT_EQ((*batch->operations)[0].data, "x");
+    EXPECT_EQ((*batch->operations)[1].command, CommandType::REMOVE);
+    EXPECT_EQ((*batch->operations)[1].uuid, uuid);
+
+    // Некорректный JSON, отсутствие обязательных полей и поля неверного типа отклоняются
+    EXPECT_FALSE(Request::fromJson("{").has_value());
+    EXPECT_FALSE(Request::fromJson(R"({"request_id": "x", "command": "get"})").has_value());
+    EXPECT_FALSE(
+        Request::fromJson(R"({"request_id": "x", "command": "mget", "params": {"uuids": 1}})")
+            .has_value());
+    EXPECT_FALSE(Request::fromJson(R"({"request_id": "x", "command": "batch",
+        "params": {"operations": [{"data": "no command"}]}})")
+                     .has_value());
+
+    for (const auto &response : makeResponses()) {
+        SCOPED_TRACE(response.requestId);
+        const auto json = nlohmann::json::parse(response.toJson());
+        EXPECT_EQ(json["request_id"], response.requestId);
+        EXPECT_EQ(json["success"], response.success);
+        const auto &params = json["params"];
+        EXPECT_EQ(params.contains("uuids"), response.uuids.has_value());
+        if (response.data.has_value()) {
+            EXPECT_EQ(params["data"], *response.data);
+        }
+        if (response.values.has_value()) {
+            ASSERT_EQ(params["values"].size(), response.values->size());
+            EXPECT_TRUE(params["values"][1].is_null());
+        }
+        if (response.position.has_value()) {
+            EXPECT_EQ(params["position"]["checkpoint"], response.position->checkpointId);
+            EXPECT_EQ(params["position"]["part"], *response.position->part);
+        }
+        EXPECT_EQ(params.contains("reset"), response.reset);
+        EXPECT_EQ(json.contains("error"), response.error.has_value());
+    }
+}
+
+// Кодирование длины кадра в little-endian
+TEST_F(ProtocolTest, FrameLength)
+{
+    const auto bytes = ProtocolFrame::encodeLength(0x01020304);
+    EXPECT_EQ(bytes[0], 0x04);
+    EXPECT_EQ(bytes[3], 0x01);
+    for (const uint32_t length : { 0U, 1U, 0x01020304U, std::numeric_limits<uint32_t>::max() }) {
+        EXPECT_EQ(ProtocolFrame::decodeLength(ProtocolFrame::encodeLength(length).data()),
+                  length);
+    }
+}
+
+// Из буфера извлекаются все полные кадры пачки, а неполный ждёт оставшихся байт
+TEST_F(ProtocolTest, ExtractsPipelinedFrames)
+{
+    FrameBuffer buffer(16);
+    EXPECT_FALSE(ProtocolFrame::extractMessage(buffer).has_value());
+    EXPECT_EQ(ProtocolFrame::missingBytes(buffer), server::FRAME_HEADER_SIZE);
+
+    const auto third = makeFrame(std::string(100, 'c'));
+    appendToBuffer(buffer, makeFrame("first") + makeFrame("") + makeFrame("second")
+                               + third.substr(0, 2));
+
+    auto message = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(*message, "first");
+    message = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_TRUE(message->empty());
+    message = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(*message, "second");
+
+    // Заголовок третьего кадра получен не полностью
+    EXPECT_FALSE(ProtocolFrame::extractMessage(buffer).has_value());
+    EXPECT_EQ(ProtocolFrame::missingBytes(buffer), 2U);
+    appendToBuffer(buffer, third.substr(2, 50));
+    EXPECT_FALSE(ProtocolFrame::extractMessage(buffer).has_value());
+    EXPECT_EQ(ProtocolFrame::missingBytes(buffer), third.size() - 52);
+    appendToBuffer(buffer, third.substr(52));
+    EXPECT_EQ(ProtocolFrame::missingBytes(buffer), 0U);
+    message = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(message.has_value());
+    EXPECT_EQ(*message, std::string(100, 'c'));
+    EXPECT_EQ(buffer.size(), 0U);
+}
+
+// Кадр, объявленный больше MAX_FRAME_SIZE, не принимается по одному заголовку
+TEST_F(ProtocolTest, RejectsOversizedFrames)
+{
+    constexpr auto MAX_MESSAGE_SIZE
+        = static_cast<uint32_t>(server::MAX_FRAME_SIZE - server::FRAME_HEADER_SIZE);
+    for (const auto &[length, exceeds] :
+         std::vector<std::pair<uint32_t, bool>>{ { 0, false },
+                                                 { MAX_MESSAGE_SIZE, false },
+                                                 { MAX_MESSAGE_SIZE + 1, true },
+                                                 { std::numeric_limits<uint32_t>::max(), true } }) {
+        SCOPED_TRACE(length);
+        FrameBuffer buffer(16);
+        const auto header = ProtocolFrame::encodeLength(length);
+        // Пока заголовок не получен целиком, размер кадра неизвестен
+        appendToBuffer(buffer, std::string_view(reinterpret_cast<const char *>(header.data()), 3));
+        EXPECT_FALSE(ProtocolFrame::exceedsMaxSize(buffer));
+        appendToBuffer(buffer, std::string_view(reinterpret_cast<const char *>(header.data()) + 3,
+                                                1));
+        EXPECT_EQ(ProtocolFrame::exceedsMaxSize(buffer), exceeds);
+        // Пустой кадр получен целиком, остальные ждут сообщения
+        EXPECT_EQ(ProtocolFrame::extractMessage(buffer).has_value(), length == 0);
+    }
+}
+
+// Пока память буфера разделена с обработчиком запроса, следующие чтения её не перезаписывают
+TEST_F(ProtocolTest, SharedFrameMemory)
+{
+    FrameBuffer buffer(64);
+    const std::string first(40, 'a');
+    appendToBuffer(buffer, makeFrame(first));
+    const auto message = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(message.has_value());
+
+    {
+        const auto owner = buffer.share();
+        // Следующие кадры не помещаются в конец буфера, поэтому остаток переносится в новую
+        // память, а не в начало разделённой
+        const std::string second(100, 'b');
+        appendToBuffer(buffer, makeFrame(second).substr(0, 30));
+        appendToBuffer(buffer, makeFrame(second).substr(30));
+        EXPECT_EQ(*message, first);
+        const auto next = ProtocolFrame::extractMessage(buffer);
+        ASSERT_TRUE(next.has_value());
+        EXPECT_EQ(*next, second);
+        EXPECT_EQ(*message, first);
+    }
+
+    // Без владельцев память снова заполняется сначала
+    appendToBuffer(buffer, makeFrame("third"));
+    const auto third = ProtocolFrame::extractMessage(buffer);
+    ASSERT_TRUE(third.has_value());
+    EXPECT_EQ(*third, "third");
+}
+} // namespace octet::tests
@@ -0,0 +1,155 @@
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "storage/record_table.hpp"
+#include "storage/uuid_generator.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+class RecordTableTest : public ::testing::Test {
+protected:
+    UuidGenerator generator;
+
+    /**
+     * @brief Генерирует ключ записи
+     * @return Новый UUID
+     */
+    Uuid generateKey() { return generator.generate(); }
+};
+
+// Проверка хранения коротких значений в ячейке и длинных в куче
+TEST_F(RecordTableTest, ValueStorage)
+{
+    RecordValue value;
+    EXPECT_TRUE(value.isInline());
+    EXPECT_TRUE(value.view().empty());
+
+    const std::string shortValue(RecordValue::INLINE_CAPACITY, 's');
+    value.assign(shortValue);
+    EXPECT_TRUE(value.isInline());
+    EXPECT_EQ(value.view(), shortValue);
+
+    const std::string longValue(RecordValue::INLINE_CAPACITY + 1, 'l');
+    value.assign(longValue);
+    EXPECT_FALSE(value.isInline());
+    EXPECT_EQ(value.view(), longValue);
+
+    // Копия не разделяет буфер с исходным значением
+    RecordValue copy(value);
+    value.assign(std::string(longValue.size(), 'x'));
+    EXPECT_EQ(copy.view(), longValue);
+
+    // Присваивание части собственного значения
+    copy.assign(copy.view().substr(1, 5));
+    EXPECT_EQ(copy.view(), "lllll");
+
+    RecordValue moved(std::move(value));
+    EXPECT_EQ(moved.view(), std::string(longValue.size(), 'x'));
+    EXPECT_TRUE(value.view().empty());
+
+    moved.assign("");
+    EXPECT_TRUE(moved.isInline());
+    EXPECT_TRUE(moved.view().empty());
+    EXPECT_EQ(sizeof(RecordValue), 16);
+}
+
+// Проверка базовых операций таблицы
+TEST_F(RecordTableTest, BasicOperations)
+{
+    RecordTable table;
+    const auto key = generateKey();
+    EXPECT_EQ(table.find(key), nullptr);
+    EXPECT_FALSE(table.erase(key));
+
+    EXPECT_TRUE(table.insertOrAssign(key, "value"));
+    EXPECT_EQ(table.size(), 1);
+    ASSERT_NE(table.find(key), nullptr);
+    EXPECT_EQ(table.find(key)->view(), "value");
+
+    EXPECT_FALSE(table.insertOrAssign(key, generateLargeString(1000)));
+    EXPECT_EQ(table.size(), 1);
+    EXPECT_EQ(table.find(key)->view(), generateLargeString(1000));
+
+    table.find(key)->assign("updated");
+    EXPECT_EQ(table.find(key)->view(), "updated");
+
+    EXPECT_TRUE(table.erase(key));
+    EXPECT_FALSE(table.erase(key));
+    EXPECT_EQ(table.find(key), nullptr);
+    EXPECT_TRUE(table.empty());
+}
+
+// Проверка на большом количестве случайных операций в сравнении с std::unordered_map
+TEST_F(RecordTableTest, RandomOperations)
+{
+    RecordTable table;
+    std::unordered_map<std::string, std::string> expected;
+    std::vector<Uuid> keys;
+    std::mt19937 rng(42);
+
+    for (size_t i = 0; i < 50000; i++) {
+        const auto action = rng() % 10;
+        if (action < 5 || keys.empty()) {
+            const auto key = generateKey();
+            const auto value = std::to_string(i) + std::string(rng() % 40, 'v');
+            EXPECT_TRUE(table.insertOrAssign(key, value));
+            expected[key.toString()] = value;
+            keys.push_back(key);
+        }
+        else if (action < 7) {
+            const auto &key = keys[rng() % keys.size()];
+            const auto value = "updated_" + std::to_string(i);
+            EXPECT_EQ(table.insertOrAssign(key, value), expected.count(key.toString()) == 0);
+            expected[key.toString()] = value;
+        }
+        else {
+            const auto &key = keys[rng() % keys.size()];
+            EXPECT_EQ(table.erase(key), expected.erase(key.toString()) > 0);
+        }
+    }
+
+    ASSERT_EQ(table.size(), expected.size());
+    for (const auto &key : keys) {
+        const auto it = expected.find(key.toString());
+        const auto *value = table.find(key);
+        ASSERT_EQ(value != nullptr, it != expected.end());
+        if (value != nullptr) {
+            EXPECT_EQ(value->view(), it->second);
+        }
+    }
+
+    size_t visited = 0;
+    table.forEach([&](const Uuid &key, std::string_view value) {
+        EXPECT_EQ(value, expected[key.toString()]);
+        visited++;
+    });
+    EXPECT_EQ(visited, expected.size());
+
+    // Копия таблицы независима от исходной
+    RecordTable copy(table);
+    table.clear();
+    EXPECT_EQ(copy.size(), expected.size());
+    EXPECT_EQ(table.size(), 0);
+    EXPECT_EQ(table.find(keys.front()), nullptr);
+}
+
+// Проверка, что удалённые ячейки не приводят к бесконечному росту таблицы
+TEST_F(RecordTableTest, ReuseDeletedSlots)
+{
+    RecordTable table;
+    table.reserve(1000);
+    const auto capacity = table.capacity();
+    EXPECT_GE(capacity, 1000);
+
+    for (size_t i = 0; i < 100000; i++) {
+        const auto key = generateKey();
+        EXPECT_TRUE(table.insertOrAssign(key, "value"));
+        EXPECT_TRUE(table.erase(key));
+    }
+    EXPECT_TRUE(table.empty());
+    EXPECT_EQ(table.capacity(), capacity);
+}
+} // namespace octet::tests
@@ -0,0 +1,248 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "storage/replication.hpp"
+#include "storage/storage_manager.hpp"
+#include "utils/file_utils.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+class ReplicationTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+    std::filesystem::path leaderDir; // Директория реплицируемого хранилища
+    std::filesystem::path followerDir; // Директория хранилища реплики
+    std::unordered_map<std::string, std::string> expected; // Ожидаемое содержимое хранилища
+
+    void SetUp() override
+    {
+        testDir = createTmpDirectory("Replication");
+        leaderDir = testDir / "leader";
+        followerDir = testDir / "follower";
+    }
+
+    void TearDown() override { removeTmpDirectory(testDir); }
+
+    /**
+     * @brief Создаёт менеджер хранилища без автоматических снапшотов
+     * @param dataDir Директория хранилища
+     * @return Менеджер хранилища
+     */
+    static std::unique_ptr<StorageManager> createManager(const std::filesystem::path &dataDir)
+    {
+        auto manager = std::make_unique<StorageManager>(dataDir);
+        manager->setSnapshotOperationsThreshold(1000000);
+        manager->setSnapshotTimeThreshold(1000000);
+        manager->setSnapshotMode(SnapshotMode::COPY);
+        return manager;
+    }
+
+    /**
+     * @brief Добавляет записи в хранилище и запоминает их
+     * @param manager Менеджер хранилища
+     * @param count Количество записей
+     */
+    void insertRecords(StorageManager &manager, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) {
+            // Длинные значения хранятся вне ячейки таблицы
+            const auto data = i % 3 == 0 ? generateLargeString(100 + i) : generateRandomId(8);
+            const auto uuid = manager.insert(data);
+            ASSERT_TRUE(uuid.has_value());
+            expected[*uuid] = data;
+        }
+    }
+
+    /**
+     * @brief Обновляет и удаляет часть запомненных записей
+     * @param manager Менеджер хранилища
+     */
+    void changeRecords(StorageManager &manager)
+    {
+        std::vector<std::string> uuids;
+        for (const auto &[uuid, data] : expected) {
+            uuids.push_back(uuid);
+        }
+        for (size_t i = 0; i < uuids.size(); i++) {
+            if (i % 4 == 0) {
+                ASSERT_TRUE(manager.remove(uuids[i]));
+                expected.erase(uuids[i]);
+            }
+            else if (i % 4 == 1) {
+                const auto data = generateRandomId(12);
+                ASSERT_TRUE(manager.update(uuids[i], data));
+                expected[uuids[i]] = data;
+            }
+        }
+    }
+
+    /**
+     * @brief Передаёт реплике порции, пока у источника есть новые записи
+     * @param source Источник потока репликации
+     * @param target Реплика
+     * @param maxBytes Желаемый размер порции
+     * @return Количество порций, начинавших передачу состояния заново
+     */
+    static size_t synchronize(ReplicationSource &source, ReplicationTarget &target,
+                              size_t maxBytes = 1024)
+    {
+        size_t resets = 0;
+        for (size_t i = 0; i < 100000; i++) {
+            ReplicationChunk chunk;
+            EXPECT_TRUE(source.read(target.getPosition(), maxBytes, chunk));
+            EXPECT_TRUE(target.apply(chunk));
+            resets += chunk.reset ? 1 : 0;
+            if (chunk.records.empty() && !chunk.next.part.has_value()) {
+                return resets;
+            }
+        }
+        ADD_FAILURE() << "Поток репликации не закончился";
+        return resets;
+    }
+
+    /**
+     * @brief Проверяет, что содержимое хранилища совпадает с запомненным
+     * @param manager Менеджер хранилища
+     */
+    void expectContent(const StorageManager &manager) const
+    {
+        EXPECT_EQ(manager.getEntriesCount(), expected.size());
+        for (const auto &[uuid, data] : expected) {
+            EXPECT_EQ(manager.get(uuid), data);
+        }
+    }
+};
+
+/**
+ * @brief Тест передачи состояния хранилища и последующих операций журнала
+ */
+TEST_F(ReplicationTest, TransfersStateAndJournal)
+{
+    auto leader = createManager(leaderDir);
+    insertRecords(*leader, 300);
+    auto follower = createManager(followerDir);
+    ReplicationSource source(*leader);
+    ReplicationTarget target(*follower, followerDir);
+    EXPECT_FALSE(target.getPosition().has_value());
+
+    // Первая порция начинает передачу состояния
+    ReplicationChunk chunk;
+    ASSERT_TRUE(source.read(target.getPosition(), 1024, chunk));
+    EXPECT_TRUE(chunk.reset);
+    EXPECT_EQ(chunk.next.part, 1U);
+    ASSERT_TRUE(target.apply(chunk));
+
+    // Операции, выполненные во время передачи, доходят до реплики через журнал, в том числе
+    // для записей уже переданных частей
+    changeRecords(*leader);
+    insertRecords(*leader, 50);
+    EXPECT_EQ(synchronize(source, target), 0U);
+    expectContent(*follower);
+    ASSERT_TRUE(target.getPosition().has_value());
+    EXPECT_FALSE(target.getPosition()->part.has_value());
+
+    // Новые операции передаются порциями не больше заданного размера (кроме длинных записей)
+    changeRecords(*leader);
+    insertRecords(*leader, 20);
+    size_t chunks = 0;
+    do {
+        ASSERT_TRUE(source.read(target.getPosition(), 256, chunk));
+        EXPECT_FALSE(chunk.reset);
+        ASSERT_TRUE(target.apply(chunk));
+        chunks++;
+    } while (!chunk.records.empty());
+    EXPECT_GT(chunks, 10U);
+    expectContent(*follower);
+}
+
+/**
+ * @brief Тест продолжения потока после уплотнения журнала источника
+ */
+TEST_F(ReplicationTest, ContinuesAfterCompaction)
+{
+    auto leader = createManager(leaderDir);
+    insertRecords(*leader, 100);
+    auto follower = createManager(followerDir);
+    ReplicationSource source(*leader);
+    ReplicationTarget target(*follower, followerDir);
+    EXPECT_EQ(synchronize(source, target), 1U);
+    changeRecords(*leader);
+    EXPECT_EQ(synchronize(source, target), 0U);
+    expectContent(*follower);
+
+    // Реплика получила все операции до новой контрольной точки, поэтому поток продолжается от неё,
+    // хотя прежняя точка реплики удалена из журнала вместе со старыми сегментами
+    ASSERT_TRUE(leader->compactJournal());
+    insertRecords(*leader, 10);
+    EXPECT_EQ(synchronize(source, target), 0U);
+    expectContent(*follower);
+    ASSERT_TRUE(target.getPosition().has_value());
+    EXPECT_EQ(target.getPosition()->checkpointId, leader->getLastCheckpointId());
+    EXPECT_EQ(target.getPosition()->offset, 10U);
+
+    // Реплика, отставшая от уплотнения, получает состояние заново. Пока принимаются части, она
+    // отвечает прежним содержимым, а удалённые записи пропадают из неё после последней части
+    const auto previous = expected;
+    changeRecords(*leader);
+    ASSERT_TRUE(leader->compactJournal());
+    insertRecords(*leader, 10);
+    ReplicationChunk chunk;
+    ASSERT_TRUE(source.read(target.getPosition(), 1024, chunk));
+    EXPECT_TRUE(chunk.reset);
+    while (chunk.next.part.has_value()) {
+        ASSERT_TRUE(target.apply(chunk));
+        ASSERT_EQ(follower->getEntriesCount(), previous.size());
+        for (const auto &[uuid, data] : previous) {
+            ASSERT_EQ(follower->get(uuid), data);
+        }
+        ASSERT_TRUE(source.read(target.getPosition(), 1024, chunk));
+    }
+    ASSERT_TRUE(target.apply(chunk));
+    expectContent(*follower);
+    EXPECT_EQ(synchronize(source, target), 0U);
+    expectContent(*follower);
+
+    // Записи реплики применяются и к её журналу, поэтому состояние сохраняется после перезапуска
+    follower.reset();
+    follower = createManager(followerDir);
+    expectContent(*follower);
+}
+
+/**
+ * @brief Тест продолжения потока после перезапуска реплики и источника
+ */
+TEST_F(ReplicationTest, ResumesAfterRestart)
+{
+    auto leader = createManager(leaderDir);
+    insertRecords(*leader, 100);
+    {
+        auto follower = createManager(followerDir);
+        ReplicationSource source(*leader);
+        ReplicationTarget target(*follower, followerDir);
+        EXPECT_EQ(synchronize(source, target), 1U);
+    }
+
+    // Реплика продолжает поток с сохранённого положения, не получая состояние заново
+    changeRecords(*leader);
+    insertRecords(*leader, 10);
+    auto follower = createManager(followerDir);
+    ReplicationSource source(*leader);
+    ReplicationTarget target(*follower, followerDir);
+    ASSERT_TRUE(target.getPosition().has_value());
+    EXPECT_EQ(synchronize(source, target), 0U);
+    expectContent(*follower);
+
+    // Повреждённое положение приводит к повторной передаче состояния
+    follower.reset();
+    ASSERT_TRUE(utils::atomicFileWrite(followerDir / REPLICATION_POSITION_FILE_NAME, "broken"));
+    follower = createManager(followerDir);
+    ReplicationTarget restored(*follower, followerDir);
+    EXPECT_FALSE(restored.getPosition().has_value());
+    EXPECT_EQ(synchronize(source, restored), 1U);
+    expectContent(*follower);
+}
+} // namespace octet::tests
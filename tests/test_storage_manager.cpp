@@ -1,4 +1,5 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <atomic>
 #include <chrono>
 #include <filesystem>
@@ -204,6 +205,131 @@ TEST_F(StorageManagerTest, BasicCrudOperations)
     ASSERT_FALSE(manager.remove("non_existent_uuid"));
 }
 
+// Тест пакетных операций и получения нескольких строк
+TEST_F(StorageManagerTest, BatchOperations)
+{
+    const auto dataDir = createSubdir("batch_test");
+    std::unordered_map<std::string, std::string> expected;
+    {
+        StorageManager manager(dataDir);
+
+        // Пакетная вставка
+        std::vector<std::string> data;
+        for (size_t i = 0; i < 50; i++) {
+            data.push_back("batch_data_" + std::to_string(i));
+        }
+        const auto uuids = manager.insertBatch(data);
+        ASSERT_TRUE(uuids.has_value());
+        ASSERT_EQ(uuids->size(), data.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            expected[(*uuids)[i]] = data[i];
+        }
+        EXPECT_EQ(manager.getEntriesCount(), data.size());
+
+        // Получение нескольких строк, в том числе отсутствующих
+        auto keys = *uuids;
+        keys.push_back("non_existent_uuid");
+        keys.push_back((*uuids)[0]);
+        const auto values = manager.getMany(keys);
+        ASSERT_EQ(values.size(), keys.size());
+        for (size_t i = 0; i < data.size(); i++) {
+            ASSERT_TRUE(values[i].has_value());
+            EXPECT_EQ(*values[i], data[i]);
+        }
+        EXPECT_FALSE(values[data.size()].has_value());
+        EXPECT_EQ(values.back(), data[0]);
+        EXPECT_TRUE(manager.getMany({}).empty());
+
+        // Смешанный пакет: вставка, обновление, удаление
+        const std::vector<BatchOperation> operations = {
+            { OperationType::INSERT, "", "inserted" },
+            { OperationType::UPDATE, (*uuids)[1], "updated" },
+            { OperationType::REMOVE, (*uuids)[2], "" },
+        };
+        const auto result = manager.applyBatch(operations);
+        ASSERT_TRUE(result.has_value());
+        ASSERT_EQ(result->size(), operations.size());
+        EXPECT_EQ((*result)[1], (*uuids)[1]);
+        EXPECT_EQ((*result)[2], (*uuids)[2]);
+        expected[(*result)[0]] = "inserted";
+        expected[(*uuids)[1]] = "updated";
+        expected.erase((*uuids)[2]);
+        verifyStorageContents(manager, expected);
+
+        // Пакет с отсутствующей строкой не применяется целиком
+        const std::vector<BatchOperation> invalidOperations = {
+            { OperationType::INSERT, "", "never_inserted" },
+            { OperationType::UPDATE, (*uuids)[3], "never_updated" },
+            { OperationType::REMOVE, (*uuids)[2], "" },
+        };
+        EXPECT_FALSE(manager.applyBatch(invalidOperations).has_value());
+        // Повторное удаление строки внутри одного пакета
+        const std::vector<BatchOperation> doubleRemove = {
+            { OperationType::REMOVE, (*uuids)[4], "" },
+            { OperationType::UPDATE, (*uuids)[4], "never_updated" },
+        };
+        EXPECT_FALSE(manager.applyBatch(doubleRemove).has_value());
+        // Пакет с некорректным UUID отклоняется до захвата блокировок
+        const std::vector<BatchOperation> invalidUuid = {
+            { OperationType::INSERT, "", "never_inserted" },
+            { OperationType::REMOVE, "non_existent_uuid", "" },
+        };
+        EXPECT_FALSE(manager.applyBatch(invalidUuid).has_value());
+        const auto emptyBatch = manager.applyBatch({});
+        ASSERT_TRUE(emptyBatch.has_value());
+        EXPECT_TRUE(emptyBatch->empty());
+        verifyStorageContents(manager, expected);
+    }
+
+    // Пакеты восстанавливаются из журнала после перезапуска
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, expected);
+}
+
+// Тест отката пакета, который не удалось зафиксировать в журнале
+TEST_F(StorageManagerTest, BatchRollbackOnJournalFailure)
+{
+    const auto dataDir = createSubdir("batch_rollback_test");
+    ValueLogPolicy policy;
+    policy.minValueSize = 256;
+    StorageManager manager(dataDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+    manager.setSnapshotOperationsThreshold(1000000);
+
+    // Короткие значения хранятся в памяти, длинные - в журнале значений
+    std::unordered_map<std::string, std::string> expected;
+    std::vector<std::string> uuids;
+    for (size_t i = 0; i < 6; i++) {
+        const auto data = i % 2 == 0 ? "short_" + std::to_string(i) : generateLargeString(1000 + i);
+        uuids.push_back(insertAndCheck(manager, data));
+        expected[uuids.back()] = data;
+    }
+    const auto liveBytes = manager.getValueLogStats().liveBytes;
+
+    // Файл журнала заменяется директорией, поэтому следующая запись в журнал не удаётся
+    const auto journalPath = dataDir / JOURNAL_FILE_NAME;
+    ASSERT_TRUE(std::filesystem::remove(journalPath));
+    ASSERT_TRUE(std::filesystem::create_directory(journalPath));
+
+    const std::vector<BatchOperation> operations = {
+        { OperationType::INSERT, "", generateLargeString(2000) },
+        { OperationType::UPDATE, uuids[0], generateLargeString(2001) },
+        { OperationType::UPDATE, uuids[1], "short_update" },
+        { OperationType::REMOVE, uuids[2], "" },
+        { OperationType::REMOVE, uuids[3], "" },
+        { OperationType::UPDATE, uuids[4], "first_update" },
+        { OperationType::UPDATE, uuids[4], generateLargeString(2002) },
+        { OperationType::REMOVE, uuids[4], "" },
+        { OperationType::UPDATE, uuids[5], "short_update" },
+        { OperationType::UPDATE, uuids[5], generateLargeString(2003) },
+    };
+    EXPECT_FALSE(manager.applyBatch(operations).has_value());
+
+    // Хранилище не изменилось, а значения пакета освобождены в журнале значений
+    verifyStorageContents(manager, expected);
+    EXPECT_EQ(manager.getValueLogStats().liveBytes, liveBytes);
+    std::filesystem::remove(journalPath);
+}
+
 // Тест для проверки сохранения множества записей
 TEST_F(StorageManagerTest, MultipleEntriesStorage)
 {
@@ -257,6 +383,66 @@ TEST_F(StorageManagerTest, DataPersistence)
     }
 }
 
+// Тест сохранения данных при всех режимах фиксации журнала
+TEST_F(StorageManagerTest, DurabilityModes)
+{
+    const std::vector<std::pair<std::string, DurabilityMode>> modes
+        = { { "sync", DurabilityMode::SYNC },
+            { "group", DurabilityMode::GROUP_COMMIT },
+            { "interval", DurabilityMode::INTERVAL },
+            { "none", DurabilityMode::NONE } };
+
+    for (const auto &[name, mode] : modes) {
+        SCOPED_TRACE("Режим: " + name);
+        const auto dataDir = createSubdir("durability_" + name);
+
+        std::unordered_map<std::string, std::string> testData;
+        {
+            StorageManager manager(dataDir, DurabilityPolicy{ mode });
+            testData = fillStorage(manager, 20);
+
+            // Обновляем и удаляем часть записей
+            auto it = testData.begin();
+            ASSERT_TRUE(manager.update(it->first, "updated_data"));
+            it->second = "updated_data";
+            it++;
+            ASSERT_TRUE(manager.remove(it->first));
+            testData.erase(it);
+        }
+
+        // При штатном завершении все режимы обязаны сохранить все операции
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+    }
+}
+
+// Тест фоновой фиксации журнала без ожидания в режимах INTERVAL и NONE
+TEST_F(StorageManagerTest, BackgroundDurabilityModes)
+{
+    for (const auto mode : { DurabilityMode::INTERVAL, DurabilityMode::NONE }) {
+        const auto name = mode == DurabilityMode::INTERVAL ? "interval" : "none";
+        SCOPED_TRACE(std::string("Режим: ") + name);
+        const auto dataDir = createSubdir(std::string("background_") + name);
+
+        StorageManager manager(dataDir, DurabilityPolicy{ mode, std::chrono::milliseconds(20) });
+        const auto uuid = insertAndCheck(manager, "background_data");
+
+        // Запись должна попасть в файл журнала в фоне, без закрытия хранилища
+        bool found = false;
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+        while (!found && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            std::string content;
+            ASSERT_TRUE(utils::safeFileRead(dataDir / JOURNAL_FILE_NAME, content));
+            found = content.find(uuid) != std::string::npos;
+        }
+        EXPECT_TRUE(found);
+
+        // Снапшот (контрольная точка) фиксируется синхронно в любом режиме
+        EXPECT_TRUE(manager.createSnapshot());
+    }
+}
+
 // Тест для проверки восстановления из снапшота
 TEST_F(StorageManagerTest, RecoveryFromSnapshot)
 {
@@ -357,6 +543,441 @@ TEST_F(StorageManagerTest, ManualSnapshotCreation)
     }
 }
 
+// Тест создания снапшотов всеми способами
+TEST_F(StorageManagerTest, SnapshotModes)
+{
+    for (const auto mode : { SnapshotMode::COPY, SnapshotMode::FORK }) {
+        const auto dataDir
+            = createSubdir(mode == SnapshotMode::COPY ? "copy_snapshot" : "fork_snapshot");
+        const auto snapshotPath = dataDir / SNAPSHOT_FILE_NAME;
+        std::unordered_map<std::string, std::string> testData;
+        std::string snapshot;
+        {
+            StorageManager manager(dataDir);
+            manager.setSnapshotMode(mode);
+            testData = fillStorage(manager, 30);
+            ASSERT_TRUE(manager.createSnapshot());
+            checkDataFiles(dataDir);
+            ASSERT_TRUE(utils::safeFileRead(snapshotPath, snapshot));
+
+            // Операции после снапшота восстанавливаются из журнала
+            const auto moreData = fillStorage(manager, 10);
+            testData.insert(moreData.begin(), moreData.end());
+            const auto removedUuid = testData.begin()->first;
+            ASSERT_TRUE(manager.remove(removedUuid));
+            testData.erase(removedUuid);
+
+            // Временные файлы снапшота не остаются в директории
+            for (const auto &entry : std::filesystem::directory_iterator(dataDir)) {
+                EXPECT_EQ(entry.path().string().find(".tmp"), std::string::npos);
+            }
+        }
+
+        // Возвращаем промежуточный снапшот вместо финального, чтобы восстановление шло от него
+        ASSERT_TRUE(utils::atomicFileWrite(snapshotPath, snapshot));
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+    }
+}
+
+// Тест записи журнала и снапшота через io_uring
+TEST_F(StorageManagerTest, IoUringBackend)
+{
+    const auto dataDir = createSubdir("io_uring_test");
+    DurabilityPolicy policy{ DurabilityMode::GROUP_COMMIT };
+    policy.ioBackend = IoBackend::IO_URING;
+    std::unordered_map<std::string, std::string> testData;
+    {
+        StorageManager manager(dataDir, policy);
+        manager.setSnapshotOperationsThreshold(1000000);
+        manager.setSnapshotMode(SnapshotMode::FORK);
+        // Снапшот занимает несколько блоков, которые записываются из разных буферов очереди
+        for (size_t i = 0; i < 300; i++) {
+            const auto data = generateLargeString(10000 + i);
+            testData[insertAndCheck(manager, data)] = data;
+        }
+        ASSERT_TRUE(manager.createSnapshot());
+        checkDataFiles(dataDir);
+        const auto moreData = fillStorage(manager, 10);
+        testData.insert(moreData.begin(), moreData.end());
+    }
+
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, testData);
+}
+
+// Тест загрузки снапшота с повреждённым блоком записей
+TEST_F(StorageManagerTest, SnapshotBlockCorruption)
+{
+    // Записи занимают несколько блоков снапшота
+    constexpr size_t TEST_ENTRIES_COUNT = 3000;
+    const auto dataDir = createSubdir("snapshot_block_corruption");
+    const auto snapshotPath = dataDir / SNAPSHOT_FILE_NAME;
+    std::unordered_map<std::string, std::string> testData;
+    {
+        StorageManager manager(dataDir);
+        manager.setSnapshotOperationsThreshold(1000000);
+        for (size_t i = 0; i < TEST_ENTRIES_COUNT; i++) {
+            const auto data = std::to_string(i) + "_" + generateLargeString(1024);
+            testData[insertAndCheck(manager, data)] = data;
+        }
+    }
+
+    std::string snapshot;
+    ASSERT_TRUE(utils::safeFileRead(snapshotPath, snapshot));
+    ASSERT_EQ(snapshot.substr(0, 8), "OCTSNAP2");
+
+    // Повреждаем один байт в середине файла, то есть внутри одного из блоков записей
+    snapshot[snapshot.size() / 2] ^= 0x5A;
+    ASSERT_TRUE(utils::atomicFileWrite(snapshotPath, snapshot));
+
+    // Записи повреждённого блока восстанавливаются из журнала
+    {
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+    }
+
+    // Без журнала загружаются только записи неповреждённых блоков
+    ASSERT_TRUE(utils::atomicFileWrite(snapshotPath, snapshot));
+    for (const auto &entry : std::filesystem::directory_iterator(dataDir)) {
+        if (entry.path() != snapshotPath) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    StorageManager manager(dataDir);
+    const auto loadedCount = manager.getEntriesCount();
+    EXPECT_GT(loadedCount, 0);
+    EXPECT_LT(loadedCount, TEST_ENTRIES_COUNT);
+    size_t foundCount = 0;
+    for (const auto &[uuid, expectedValue] : testData) {
+        const auto actualValue = manager.get(uuid);
+        if (actualValue.has_value()) {
+            EXPECT_EQ(*actualValue, expectedValue);
+            foundCount++;
+        }
+    }
+    EXPECT_EQ(foundCount, loadedCount);
+}
+
+// Тест сжатых снапшотов
+TEST_F(StorageManagerTest, CompressedSnapshots)
+{
+    bool tested = false;
+    for (const auto codec : { CompressionCodec::LZ4, CompressionCodec::ZSTD }) {
+        if (!JournalManager::isCompressionCodecSupported(codec)) {
+            continue;
+        }
+        tested = true;
+        for (const auto mode : { SnapshotMode::COPY, SnapshotMode::FORK }) {
+            const auto dataDir = createSubdir(
+                std::string(codec == CompressionCodec::LZ4 ? "lz4" : "zstd")
+                + (mode == SnapshotMode::COPY ? "_copy_snapshot" : "_fork_snapshot"));
+            const auto snapshotPath = dataDir / SNAPSHOT_FILE_NAME;
+            std::unordered_map<std::string, std::string> testData;
+            uint64_t rawSize = 0;
+            {
+                StorageManager manager(dataDir);
+                manager.setSnapshotMode(mode);
+                manager.setSnapshotOperationsThreshold(1000000);
+                for (size_t i = 0; i < 2000; i++) {
+                    const auto data = "{\"id\": " + std::to_string(i)
+                                      + ", \"text\": \"" + std::string(200, 'x') + "\"}";
+                    testData[insertAndCheck(manager, data)] = data;
+                }
+                ASSERT_TRUE(manager.createSnapshot());
+                rawSize = std::filesystem::file_size(snapshotPath);
+
+                ASSERT_TRUE(manager.setCompressionCodec(codec));
+                ASSERT_TRUE(manager.createSnapshot());
+                EXPECT_LT(std::filesystem::file_size(snapshotPath) * 4, rawSize);
+            }
+
+            // Сжатый снапшот читается без настройки алгоритма, а журнал после него пуст
+            {
+                StorageManager manager(dataDir);
+                verifyStorageContents(manager, testData);
+            }
+            // Без изменений после снапшота при завершении работы снапшот не перезаписывается
+            EXPECT_LT(std::filesystem::file_size(snapshotPath) * 4, rawSize);
+        }
+    }
+    if (!tested) {
+        GTEST_SKIP() << "Библиотека собрана без поддержки сжатия";
+    }
+}
+
+// Тест разностных снапшотов
+TEST_F(StorageManagerTest, DeltaSnapshots)
+{
+    const auto dataDir = createSubdir("delta_snapshots");
+    const auto snapshotPath = dataDir / SNAPSHOT_FILE_NAME;
+    const auto firstDeltaPath = snapshotPath.string() + ".delta.000001";
+    const auto secondDeltaPath = snapshotPath.string() + ".delta.000002";
+    std::unordered_map<std::string, std::string> testData;
+    uint64_t baseSize = 0;
+    {
+        StorageManager manager(dataDir);
+        manager.setSnapshotOperationsThreshold(1000000);
+        testData = fillStorage(manager, 500);
+
+        // Без базового снапшота создаётся полный
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        baseSize = std::filesystem::file_size(snapshotPath);
+        EXPECT_FALSE(std::filesystem::exists(firstDeltaPath));
+
+        // Разностный снапшот содержит только изменения после базового
+        const auto removedUuid = testData.begin()->first;
+        ASSERT_TRUE(manager.remove(removedUuid));
+        testData.erase(removedUuid);
+        const auto updatedUuid = testData.begin()->first;
+        ASSERT_TRUE(manager.update(updatedUuid, "updated_value"));
+        testData[updatedUuid] = "updated_value";
+        const auto moreData = fillStorage(manager, 5);
+        testData.insert(moreData.begin(), moreData.end());
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        ASSERT_TRUE(std::filesystem::exists(firstDeltaPath));
+        EXPECT_LT(std::filesystem::file_size(firstDeltaPath) * 10, baseSize);
+        EXPECT_EQ(std::filesystem::file_size(snapshotPath), baseSize);
+    }
+    // Без изменений при завершении работы новый разностный снапшот не создаётся
+    EXPECT_FALSE(std::filesystem::exists(secondDeltaPath));
+
+    // Данные восстанавливаются из цепочки снапшотов без журнала
+    for (const auto &entry : std::filesystem::directory_iterator(dataDir)) {
+        if (entry.path().filename().string().find(JOURNAL_FILE_NAME) == 0) {
+            std::filesystem::remove(entry.path());
+        }
+    }
+    {
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+        ASSERT_EQ(manager.getEntriesCount(), testData.size());
+
+        // Цепочка продолжается после перезапуска
+        const auto moreData = fillStorage(manager, 5);
+        testData.insert(moreData.begin(), moreData.end());
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        ASSERT_TRUE(std::filesystem::exists(secondDeltaPath));
+
+        // По достижении предела цепочка объединяется в новый базовый снапшот
+        manager.setSnapshotDeltaLimit(2);
+        const auto uuid = insertAndCheck(manager, "merged_data");
+        testData[uuid] = "merged_data";
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        EXPECT_FALSE(std::filesystem::exists(firstDeltaPath));
+        EXPECT_FALSE(std::filesystem::exists(secondDeltaPath));
+        EXPECT_GT(std::filesystem::file_size(snapshotPath), baseSize);
+
+        const auto deltaData = fillStorage(manager, 5);
+        testData.insert(deltaData.begin(), deltaData.end());
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        ASSERT_TRUE(std::filesystem::exists(firstDeltaPath));
+    }
+
+    // Повреждённый разностный снапшот не применяется, а его изменения восстанавливаются из журнала
+    std::string delta;
+    ASSERT_TRUE(utils::safeFileRead(firstDeltaPath, delta));
+    delta[delta.size() / 2] ^= 0x5A;
+    ASSERT_TRUE(utils::atomicFileWrite(firstDeltaPath, delta));
+    {
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+
+        // После разрыва цепочки следующий снапшот полный
+        const auto uuid = insertAndCheck(manager, "after_broken_chain");
+        testData[uuid] = "after_broken_chain";
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        EXPECT_FALSE(std::filesystem::exists(firstDeltaPath));
+    }
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, testData);
+}
+
+// Тест загрузки снапшота прежнего формата
+TEST_F(StorageManagerTest, LegacySnapshotFormat)
+{
+    const auto dataDir = createSubdir("legacy_snapshot");
+    std::unordered_map<std::string, std::string> testData;
+    UuidGenerator generator;
+    for (size_t i = 0; i < 100; i++) {
+        testData[generator.generateUuid()] = "legacy_data_" + std::to_string(i);
+    }
+
+    // Количество записей, затем длины и байты ключей и значений (little-endian)
+    std::string snapshot;
+    auto appendSize = [&snapshot](uint32_t size) {
+        for (size_t i = 0; i < sizeof(size); i++) {
+            snapshot.push_back(static_cast<char>(size >> (8 * i)));
+        }
+    };
+    appendSize(static_cast<uint32_t>(testData.size()));
+    for (const auto &[uuid, value] : testData) {
+        appendSize(static_cast<uint32_t>(uuid.size()));
+        snapshot += uuid;
+        appendSize(static_cast<uint32_t>(value.size()));
+        snapshot += value;
+    }
+    ASSERT_TRUE(utils::atomicFileWrite(dataDir / SNAPSHOT_FILE_NAME, snapshot));
+
+    {
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, testData);
+    }
+
+    // При завершении работы снапшот перезаписывается уже в новом формате
+    std::string rewritten;
+    ASSERT_TRUE(utils::safeFileRead(dataDir / SNAPSHOT_FILE_NAME, rewritten));
+    EXPECT_EQ(rewritten.substr(0, 8), "OCTSNAP2");
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, testData);
+}
+
+// Тест согласованности снапшотов, создаваемых параллельно с операциями записи
+TEST_F(StorageManagerTest, SnapshotDuringConcurrentWrites)
+{
+    for (const auto mode : { SnapshotMode::COPY, SnapshotMode::FORK }) {
+        const auto dataDir = createSubdir(mode == SnapshotMode::COPY ? "copy_concurrent_snapshot"
+                                                                     : "fork_concurrent_snapshot");
+        std::unordered_map<std::string, std::string> expectedData;
+        std::mutex expectedDataMutex;
+        const auto snapshotPath = dataDir / SNAPSHOT_FILE_NAME;
+        std::string lastSnapshot;
+        {
+            StorageManager manager(dataDir);
+            manager.setSnapshotMode(mode);
+            manager.setSnapshotOperationsThreshold(1000000);
+
+            std::atomic<bool> stop{ false };
+            std::vector<std::thread> writers;
+            for (size_t t = 0; t < 4; t++) {
+                writers.emplace_back([&, t] {
+                    for (size_t i = 0; !stop; i++) {
+                        const auto data = "writer_" + std::to_string(t) + "_" + std::to_string(i);
+                        const auto uuid = manager.insert(data);
+                        ASSERT_TRUE(uuid.has_value());
+                        std::lock_guard<std::mutex> lock(expectedDataMutex);
+                        expectedData[*uuid] = data;
+                    }
+                });
+            }
+
+            for (size_t i = 0; i < 5; i++) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                EXPECT_TRUE(manager.createSnapshot());
+            }
+            stop = true;
+            for (auto &writer : writers) {
+                writer.join();
+            }
+            ASSERT_TRUE(utils::safeFileRead(snapshotPath, lastSnapshot));
+        }
+
+        // Восстанавливаем состояние из промежуточного снапшота и журнала после него
+        ASSERT_TRUE(utils::atomicFileWrite(snapshotPath, lastSnapshot));
+        StorageManager manager(dataDir);
+        verifyStorageContents(manager, expectedData);
+    }
+}
+
+// Тест уплотнения журнала
+TEST_F(StorageManagerTest, JournalCompaction)
+{
+    const auto dataDir = createSubdir("journal_compaction_test");
+    const auto journalPath = dataDir / JOURNAL_FILE_NAME;
+    std::unordered_map<std::string, std::string> expectedData;
+    {
+        StorageManager manager(dataDir);
+        manager.setSnapshotOperationsThreshold(1000000);
+        expectedData = fillStorage(manager, 50);
+        const auto sizeBefore = std::filesystem::file_size(journalPath);
+
+        ASSERT_TRUE(manager.compactJournal());
+        checkDataFiles(dataDir);
+        EXPECT_LT(std::filesystem::file_size(journalPath), sizeBefore);
+        EXPECT_FALSE(std::filesystem::exists(journalPath.string() + ".000001"));
+
+        const auto uuid = insertAndCheck(manager, "after_compaction");
+        expectedData[uuid] = "after_compaction";
+    }
+
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, expectedData);
+}
+
+// Тест загрузки строк без журналирования каждой
+TEST_F(StorageManagerTest, Import)
+{
+    const auto dataDir = createSubdir("import_test");
+    const auto journalPath = dataDir / JOURNAL_FILE_NAME;
+    ValueLogPolicy policy;
+    policy.minValueSize = 256;
+    std::unordered_map<std::string, std::string> expectedData;
+    {
+        StorageManager manager(dataDir, DurabilityPolicy{}, policy);
+        manager.setSnapshotOperationsThreshold(1000000);
+        expectedData = fillStorage(manager, 20);
+        const auto journalSize = std::filesystem::file_size(journalPath);
+
+        // Короткие строки остаются в памяти, длинные выносятся в журнал значений
+        std::vector<std::string> strings;
+        for (size_t i = 0; i < 100000; i++) {
+            strings.push_back(i % 1000 == 0 ? generateLargeString(1000 + i % 7)
+                                            : "import_" + std::to_string(i));
+        }
+        const std::vector<std::string_view> values(strings.begin(), strings.end());
+        manager.reserve(values.size());
+        std::vector<Uuid> keys;
+        ASSERT_TRUE(manager.importValues(values, &keys));
+        ASSERT_EQ(keys.size(), values.size());
+        EXPECT_EQ(manager.getEntriesCount(), expectedData.size() + values.size());
+        // Загруженные строки не записываются в журнал операций
+        EXPECT_EQ(std::filesystem::file_size(journalPath), journalSize);
+        for (size_t i = 0; i < keys.size(); i++) {
+            expectedData[keys[i].toString()] = strings[i];
+        }
+
+        ASSERT_TRUE(manager.finishImport());
+        checkDataFiles(dataDir);
+        EXPECT_LT(std::filesystem::file_size(journalPath), journalSize);
+        verifyStorageContents(manager, expectedData);
+
+        const auto uuid = insertAndCheck(manager, "after_import");
+        expectedData[uuid] = "after_import";
+    }
+
+    // Загруженные строки восстанавливаются из снапшота
+    StorageManager manager(dataDir, DurabilityPolicy{}, policy);
+    verifyStorageContents(manager, expectedData);
+}
+
+// Тест автоматического уплотнения журнала по размеру активного сегмента
+TEST_F(StorageManagerTest, AutoJournalCompactionBySize)
+{
+    const auto dataDir = createSubdir("auto_journal_compaction_test");
+    const auto journalPath = dataDir / JOURNAL_FILE_NAME;
+    std::unordered_map<std::string, std::string> expectedData;
+    {
+        StorageManager manager(dataDir);
+        manager.setSnapshotOperationsThreshold(1000000);
+        manager.setJournalCompactionSizeThreshold(4096);
+
+        // Каждая запись занимает около 90 байт, поэтому порог достигается несколько раз
+        expectedData = fillStorage(manager, 200);
+
+        // Ждем, пока уплотнение будет выполнено (даем время потоку)
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+        checkDataFiles(dataDir);
+        EXPECT_LT(std::filesystem::file_size(journalPath), 200 * 90);
+        for (const auto &item : std::filesystem::directory_iterator(dataDir)) {
+            EXPECT_EQ(item.path().filename().string().find(std::string(JOURNAL_FILE_NAME) + ".0"),
+                      std::string::npos);
+        }
+    }
+
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, expectedData);
+}
+
 // Тест запроса асинхронного создания снапшота
 TEST_F(StorageManagerTest, AsyncSnapshotCreation)
 {
@@ -669,6 +1290,71 @@ TEST_F(StorageManagerTest, ConcurrentWrites)
     verifyStorageContents(manager, addedData);
 }
 
+// Тест совпадения порядка записей журнала с порядком изменений в сегментах хранилища
+TEST_F(StorageManagerTest, ConcurrentUpdatesJournalOrder)
+{
+    const auto dataDir = createSubdir("concurrent_updates_order_test");
+    constexpr size_t KEY_COUNT = 8;
+    constexpr size_t THREAD_COUNT = 8;
+    constexpr size_t OPERATIONS_PER_THREAD = 50;
+
+    std::vector<std::string> uuids;
+    std::unordered_map<std::string, std::string> finalData;
+    {
+        StorageManager manager(dataDir);
+        manager.setSnapshotOperationsThreshold(1000000);
+        for (size_t i = 0; i < KEY_COUNT; i++) {
+            const auto uuid = manager.insert("initial_" + std::to_string(i));
+            ASSERT_TRUE(uuid.has_value());
+            uuids.push_back(*uuid);
+        }
+
+        // Потоки конкурентно обновляют, удаляют и заново добавляют одни и те же записи
+        std::vector<std::future<void>> futures;
+        for (size_t t = 0; t < THREAD_COUNT; t++) {
+            futures.push_back(std::async(std::launch::async, [&, t] {
+                for (size_t j = 0; j < OPERATIONS_PER_THREAD; j++) {
+                    const auto &uuid = uuids[(t + j) % KEY_COUNT];
+                    if (j % 10 == 9) {
+                        manager.remove(uuid);
+                    }
+                    else {
+                        manager.update(uuid, std::to_string(t) + "_" + std::to_string(j));
+                    }
+                }
+                // Новые записи попадают в разные сегменты
+                for (size_t j = 0; j < OPERATIONS_PER_THREAD; j++) {
+                    ASSERT_TRUE(manager.insert("extra_" + std::to_string(t)).has_value());
+                }
+            }));
+        }
+        for (auto &future : futures) {
+            future.wait();
+        }
+
+        for (const auto &uuid : uuids) {
+            if (const auto data = manager.get(uuid)) {
+                finalData[uuid] = *data;
+            }
+        }
+        EXPECT_EQ(manager.getEntriesCount(),
+                  finalData.size() + THREAD_COUNT * OPERATIONS_PER_THREAD);
+    }
+
+    // Восстановленное из журнала состояние совпадает с состоянием в памяти до перезапуска
+    std::filesystem::remove(dataDir / SNAPSHOT_FILE_NAME);
+    StorageManager manager(dataDir);
+    EXPECT_EQ(manager.getEntriesCount(), finalData.size() + THREAD_COUNT * OPERATIONS_PER_THREAD);
+    for (const auto &uuid : uuids) {
+        const auto data = manager.get(uuid);
+        const auto it = finalData.find(uuid);
+        ASSERT_EQ(data.has_value(), it != finalData.end());
+        if (data.has_value()) {
+            EXPECT_EQ(*data, it->second);
+        }
+    }
+}
+
 // Тест параллельного чтения и записи
 TEST_F(StorageManagerTest, ConcurrentReadsAndWrites)
 {
@@ -690,6 +1376,13 @@ TEST_F(StorageManagerTest, ConcurrentReadsAndWrites)
     std::unordered_map<std::string, std::string> updatedData(initialData);
     std::unordered_map<std::string, std::string> newData;
     std::unordered_set<std::string> removedUuids;
+    // Все успешно записанные значения начальных записей: подтверждения конкурентных обновлений
+    // одной записи приходят вне блокировки хранилища, поэтому их порядок может не совпадать с
+    // порядком применения, но итоговое значение должно быть одним из записанных
+    std::unordered_map<std::string, std::unordered_set<std::string>> writtenData;
+    for (const auto &[uuid, data] : initialData) {
+        writtenData[uuid].insert(data);
+    }
 
     // Запускаем потоки для чтения
     constexpr size_t READ_THREADS = 20;
@@ -808,9 +1501,9 @@ TEST_F(StorageManagerTest, ConcurrentReadsAndWrites)
 
                 // Обновляем данные
                 if (manager.update(uuid, newData)) {
-                    // Обновляем ожидаемые данные
+                    // Запоминаем записанное значение
                     std::lock_guard<std::mutex> lock(dataMapMutex);
-                    updatedData[uuid] = newData;
+                    writtenData[uuid].insert(newData);
                 }
                 else {
                     // Обновление могло не удаться, если UUID был уже удален другим потоком
@@ -850,9 +1543,6 @@ TEST_F(StorageManagerTest, ConcurrentReadsAndWrites)
                     uuid = it->first;
                 }
 
-                {
-                }
-
                 // Удаляем данные
                 if (manager.remove(uuid)) {
                     // Обновляем информацию об удаленных UUID
@@ -905,11 +1595,11 @@ TEST_F(StorageManagerTest, ConcurrentReadsAndWrites)
         ASSERT_EQ(*retrievedData, data);
     }
 
-    // Проверяем, что все обновленные данные имеют правильные значения
-    for (const auto &[uuid, data] : updatedData) {
+    // Проверяем, что каждая неудаленная запись содержит одно из записанных в нее значений
+    for (const auto &[uuid, _] : updatedData) {
         const auto retrievedData = manager.get(uuid);
         ASSERT_TRUE(retrievedData.has_value());
-        ASSERT_EQ(*retrievedData, data);
+        ASSERT_EQ(writtenData[uuid].count(*retrievedData), 1U) << *retrievedData;
     }
 
     // Проверяем, что все удаленные данные действительно удалены
@@ -1024,6 +1714,150 @@ TEST_F(StorageManagerTest, InvalidUuids)
     EXPECT_FALSE(manager.remove(invalidUuid));
 }
 
+// Тест операций с данными из string_view и чтения без копирования
+TEST_F(StorageManagerTest, StringViewAndRead)
+{
+    const auto dataDir = createSubdir("string_view_test");
+    std::string uuid;
+    {
+        StorageManager manager(dataDir);
+
+        // Данные передаются частью большего буфера, без промежуточной std::string
+        const std::string buffer = "prefix:" + generateLargeString(1024 * 1024) + ":suffix";
+        const std::string_view value(buffer.data() + 7, buffer.size() - 14);
+        const auto inserted = manager.insert(value);
+        ASSERT_TRUE(inserted.has_value());
+        uuid = *inserted;
+
+        // Обработчик получает представление значения, хранящегося в хранилище
+        std::string_view seen;
+        EXPECT_TRUE(manager.read(std::string_view(uuid), [&](std::string_view data) {
+            EXPECT_EQ(data, value);
+            seen = data;
+        }));
+        EXPECT_NE(seen.data(), value.data());
+
+        const std::string updated = "[updated]";
+        EXPECT_TRUE(manager.update(std::string_view(uuid), std::string_view(updated).substr(1, 7)));
+        EXPECT_EQ(manager.get(std::string_view(uuid)), "updated");
+
+        // Для отсутствующей записи обработчик не вызывается
+        bool called = false;
+        EXPECT_FALSE(manager.read("not-a-valid-uuid", [&](std::string_view) { called = true; }));
+        EXPECT_FALSE(called);
+    }
+
+    // Данные восстанавливаются из журнала
+    StorageManager manager(dataDir);
+    EXPECT_EQ(manager.get(uuid), "updated");
+    EXPECT_TRUE(manager.remove(std::string_view(uuid)));
+    EXPECT_FALSE(manager.read(uuid, [](std::string_view) {}));
+}
+
+// Тест хранения больших значений в журнале значений
+TEST_F(StorageManagerTest, ValueLog)
+{
+    const auto dataDir = createSubdir("value_log_test");
+    ValueLogPolicy policy;
+    policy.minValueSize = 256;
+    policy.cacheBytes = 1024 * 1024;
+    std::unordered_map<std::string, std::string> testData;
+    {
+        StorageManager manager(dataDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+        // Снапшот записывается дочерним процессом, а значения фиксирует родительский
+        manager.setSnapshotOperationsThreshold(1000000);
+        manager.setSnapshotMode(SnapshotMode::FORK);
+        for (size_t i = 0; i < 50; i++) {
+            // Короткие значения остаются в памяти, длинные выносятся в журнал значений
+            const auto data = i % 2 == 0 ? "short_" + std::to_string(i)
+                                         : generateLargeString(1000 + i);
+            testData[insertAndCheck(manager, data)] = data;
+        }
+        const auto stats = manager.getValueLogStats();
+        EXPECT_GE(stats.segments, 1);
+        EXPECT_EQ(stats.liveBytes, 25 * ValueLog::RECORD_HEADER_SIZE + 25 * 1000 + 25 * 25);
+        // Прочитанные значения попадают в кэш
+        EXPECT_EQ(stats.reads, 25);
+        EXPECT_GT(stats.cacheBytes, 0);
+
+        // Значения передаются обработчику и читаются пакетом
+        const auto &[uuid, value] = *std::find_if(
+            testData.begin(), testData.end(),
+            [](const auto &entry) { return entry.second.size() > 256; });
+        EXPECT_TRUE(manager.read(std::string_view(uuid),
+                                 [&](std::string_view data) { EXPECT_EQ(data, value); }));
+        EXPECT_EQ(manager.getMany({ uuid, "missing" }),
+                  (std::vector<std::optional<std::string>>{ value, std::nullopt }));
+        EXPECT_GE(manager.getValueLogStats().cacheHits, 2);
+
+        // Замена длинного значения коротким освобождает место в журнале значений
+        ASSERT_TRUE(manager.update(uuid, "now_short"));
+        testData[uuid] = "now_short";
+        ASSERT_TRUE(manager.createSnapshot());
+
+        const auto removed = std::find_if(testData.begin(), testData.end(), [](const auto &entry) {
+            return entry.second.size() > 256;
+        });
+        ASSERT_TRUE(manager.remove(removed->first));
+        testData.erase(removed);
+        ASSERT_TRUE(manager.createDeltaSnapshot());
+        const auto moreData = generateLargeString(5000);
+        testData[insertAndCheck(manager, moreData)] = moreData;
+        verifyStorageContents(manager, testData);
+    }
+
+    // Снапшоты ссылаются на журнал значений, а операции после них восстанавливаются из журнала
+    {
+        StorageManager manager(dataDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+        verifyStorageContents(manager, testData);
+    }
+
+    // Без вынесения новых значений прежние значения читаются из журнала значений
+    StorageManager manager(dataDir);
+    verifyStorageContents(manager, testData);
+}
+
+// Тест уплотнения журнала значений
+TEST_F(StorageManagerTest, ValueLogCompaction)
+{
+    const auto dataDir = createSubdir("value_log_compaction_test");
+    const auto valueLogPath = dataDir / "octet-data.values";
+    ValueLogPolicy policy;
+    policy.minValueSize = 100;
+    policy.segmentSize = 16 * 1024;
+    std::unordered_map<std::string, std::string> testData;
+    {
+        StorageManager manager(dataDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+        manager.setSnapshotOperationsThreshold(1000000);
+        manager.setSnapshotMode(SnapshotMode::COPY);
+        for (size_t i = 0; i < 100; i++) {
+            const auto data = generateLargeString(1000 + i);
+            testData[insertAndCheck(manager, data)] = data;
+        }
+        // Большая часть значений перезаписывается, и их прежние записи устаревают
+        size_t updated = 0;
+        for (auto &[uuid, value] : testData) {
+            if (updated++ % 4 != 0) {
+                value = generateLargeString(900);
+                ASSERT_TRUE(manager.update(uuid, value));
+            }
+        }
+        const auto before = manager.getValueLogStats();
+        const auto segmentsBefore = ValueLog::listSegments(valueLogPath).size();
+
+        ASSERT_TRUE(manager.compactValueLog());
+        const auto after = manager.getValueLogStats();
+        EXPECT_LT(after.diskBytes, before.diskBytes);
+        EXPECT_EQ(after.liveBytes, before.liveBytes);
+        EXPECT_LT(ValueLog::listSegments(valueLogPath).size(), segmentsBefore);
+        verifyStorageContents(manager, testData);
+    }
+
+    // После уплотнения данные восстанавливаются из снапшота и оставшихся сегментов
+    StorageManager manager(dataDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+    verifyStorageContents(manager, testData);
+}
+
 // Тест глубокой проверки целостности данных после восстановления
 TEST_F(StorageManagerTest, DeepDataIntegrityCheck)
 {
@@ -0,0 +1,193 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "storage/storage_manager.hpp"
+#include "storage/storage_reader.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+class StorageReaderTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+
+    void SetUp() override
+    {
+        // Создаем временную директорию для тестов
+        testDir = createTmpDirectory("StorageReader");
+    }
+
+    void TearDown() override
+    {
+        // Удаляем временную директорию
+        removeTmpDirectory(testDir);
+    }
+
+    /**
+     * @brief Создаёт менеджер хранилища без автоматических снапшотов
+     * @return Менеджер хранилища в тестовой директории
+     */
+    std::unique_ptr<StorageManager> createWriter()
+    {
+        auto manager = std::make_unique<StorageManager>(testDir);
+        manager->setSnapshotOperationsThreshold(1000000);
+        manager->setSnapshotTimeThreshold(1000000);
+        manager->setSnapshotMode(SnapshotMode::COPY);
+        return manager;
+    }
+};
+
+/**
+ * @brief Тест загрузки снапшота и журнала, записанных другим менеджером
+ */
+TEST_F(StorageReaderTest, LoadsSnapshotAndJournal)
+{
+    auto writer = createWriter();
+    const auto first = writer->insert("first");
+    const auto second = writer->insert("second");
+    ASSERT_TRUE(first.has_value() && second.has_value());
+    ASSERT_TRUE(writer->createSnapshot());
+    // Операции после снапшота находятся только в журнале
+    const auto third = writer->insert("third");
+    ASSERT_TRUE(third.has_value());
+    ASSERT_TRUE(writer->update(*first, "first-updated"));
+    ASSERT_TRUE(writer->remove(*second));
+
+    StorageReader reader(testDir);
+    EXPECT_EQ(reader.getEntriesCount(), 2);
+    EXPECT_EQ(reader.get(*first), "first-updated");
+    EXPECT_FALSE(reader.get(*second).has_value());
+    EXPECT_EQ(reader.get(*third), "third");
+    EXPECT_FALSE(reader.get("not-a-uuid").has_value());
+}
+
+/**
+ * @brief Тест дочитывания операций, записанных после создания читателя
+ */
+TEST_F(StorageReaderTest, FollowsNewWrites)
+{
+    auto writer = createWriter();
+    const auto first = writer->insert("first");
+    ASSERT_TRUE(first.has_value());
+
+    StorageReader reader(testDir);
+    EXPECT_EQ(reader.get(*first), "first");
+
+    const auto second = writer->insert("second");
+    ASSERT_TRUE(second.has_value());
+    ASSERT_TRUE(writer->update(*first, "first-updated"));
+    EXPECT_EQ(reader.get(*second), "second");
+    EXPECT_EQ(reader.get(*first), "first-updated");
+
+    const auto values = reader.getMany({ *first, *second, "missing" });
+    ASSERT_EQ(values.size(), 3);
+    EXPECT_EQ(values[0], "first-updated");
+    EXPECT_EQ(values[1], "second");
+    EXPECT_FALSE(values[2].has_value());
+
+    ASSERT_TRUE(writer->remove(*first));
+    EXPECT_FALSE(reader.get(*first).has_value());
+    EXPECT_EQ(reader.getEntriesCount(), 1);
+}
+
+/**
+ * @brief Тест перезагрузки после замены базового снапшота и уплотнения журнала
+ */
+TEST_F(StorageReaderTest, ReloadsAfterSnapshot)
+{
+    auto writer = createWriter();
+    std::vector<std::string> uuids;
+    for (int i = 0; i < 50; i++) {
+        const auto uuid = writer->insert("value-" + std::to_string(i));
+        ASSERT_TRUE(uuid.has_value());
+        uuids.push_back(*uuid);
+    }
+
+    StorageReader reader(testDir);
+    EXPECT_EQ(reader.getEntriesCount(), uuids.size());
+
+    ASSERT_TRUE(writer->createSnapshot());
+    ASSERT_TRUE(writer->compactJournal());
+    const auto last = writer->insert("after-snapshot");
+    ASSERT_TRUE(last.has_value());
+
+    EXPECT_EQ(reader.get(*last), "after-snapshot");
+    EXPECT_EQ(reader.getEntriesCount(), uuids.size() + 1);
+    for (size_t i = 0; i < uuids.size(); i++) {
+        EXPECT_EQ(reader.get(uuids[i]), "value-" + std::to_string(i));
+    }
+}
+
+/**
+ * @brief Тест чтения хранилища после завершения работы писателя
+ */
+TEST_F(StorageReaderTest, ReadsAfterWriterExit)
+{
+    std::string uuid;
+    {
+        auto writer = createWriter();
+        const auto result = writer->insert("persisted");
+        ASSERT_TRUE(result.has_value());
+        uuid = *result;
+    }
+
+    StorageReader reader(testDir);
+    EXPECT_TRUE(reader.refresh());
+    EXPECT_EQ(reader.get(uuid), "persisted");
+}
+
+/**
+ * @brief Тест чтения значений, вынесенных писателем в журнал значений
+ */
+TEST_F(StorageReaderTest, ReadsValueLog)
+{
+    ValueLogPolicy policy;
+    policy.minValueSize = 100;
+    StorageManager writer(testDir, DurabilityPolicy{ DurabilityMode::GROUP_COMMIT }, policy);
+    writer.setSnapshotOperationsThreshold(1000000);
+    writer.setSnapshotTimeThreshold(1000000);
+    writer.setSnapshotMode(SnapshotMode::COPY);
+
+    std::vector<std::pair<std::string, std::string>> values;
+    for (size_t i = 0; i < 20; i++) {
+        const auto value = generateLargeString(500 + i);
+        const auto uuid = writer.insert(value);
+        ASSERT_TRUE(uuid.has_value());
+        values.emplace_back(*uuid, value);
+    }
+    ASSERT_TRUE(writer.createSnapshot());
+    // Изменения разностного снапшота и журнала ссылаются на значения, дописанные после загрузки
+    values[0].second = generateLargeString(700);
+    ASSERT_TRUE(writer.update(values[0].first, values[0].second));
+    ASSERT_TRUE(writer.createDeltaSnapshot());
+    values[1].second = generateLargeString(800);
+    ASSERT_TRUE(writer.update(values[1].first, values[1].second));
+
+    StorageReader reader(testDir);
+    EXPECT_EQ(reader.getEntriesCount(), values.size());
+    for (const auto &[uuid, value] : values) {
+        EXPECT_EQ(reader.get(uuid), value);
+    }
+
+    // Новый базовый снапшот загружается заново
+    values[2].second = generateLargeString(900);
+    ASSERT_TRUE(writer.update(values[2].first, values[2].second));
+    ASSERT_TRUE(writer.createSnapshot());
+    EXPECT_TRUE(reader.refresh());
+    for (const auto &[uuid, value] : values) {
+        EXPECT_EQ(reader.get(uuid), value);
+    }
+}
+
+/**
+ * @brief Тест создания читателя для несуществующей директории
+ */
+TEST_F(StorageReaderTest, MissingDirectory)
+{
+    EXPECT_THROW(StorageReader(testDir / "missing"), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists(testDir / "missing"));
+}
+} // namespace octet::tests
@@ -1,6 +1,7 @@
 #include <gtest/gtest.h>
 #include <cctype>
 #include <future>
+#include <set>
 #include <unordered_set>
 #include <vector>
 
@@ -97,6 +98,68 @@ TEST_F(UuidGeneratorTest, UuidTestConcurrentGeneration)
     EXPECT_EQ(THREAD_COUNT * UUID_PER_THREAD, uuids.size());
 }
 
+// Проверка двоичного представления, совпадающего со строковым
+TEST_F(UuidGeneratorTest, UuidBinaryRepresentation)
+{
+    for (size_t i = 0; i < 1000; i++) {
+        const auto uuid = generator.generate();
+        const auto text = uuid.toString();
+        EXPECT_TRUE(generator.isValidUuid(text));
+        EXPECT_EQ(uuid.version(), 4);
+
+        const auto parsed = Uuid::fromString(text);
+        ASSERT_TRUE(parsed.has_value()) << text;
+        EXPECT_EQ(*parsed, uuid);
+        EXPECT_EQ(parsed->hash(), uuid.hash());
+        EXPECT_EQ(std::hash<Uuid>{}(*parsed), std::hash<Uuid>{}(uuid));
+    }
+
+    const auto uuid = Uuid::fromString("0123abcd-4567-89ef-0123-456789abcdef");
+    ASSERT_TRUE(uuid.has_value());
+    EXPECT_EQ(uuid->bytes()[0], 0x01);
+    EXPECT_EQ(uuid->bytes()[3], 0xCD);
+    EXPECT_EQ(uuid->bytes()[15], 0xEF);
+    EXPECT_EQ(*uuid, Uuid::fromParts(0x0123ABCD456789EFULL, 0x0123456789ABCDEFULL));
+    EXPECT_LT(Uuid(), *uuid);
+
+    // Строки, не являющиеся UUID, не разбираются
+    for (const auto *text : { "", "nonexistent-uuid", "0123abcd-4567-89ef-0123-456789abcde",
+                              "0123abcd-4567-89ef-0123-456789abcdefa",
+                              "0123abcd04567-89ef-0123-456789abcdef",
+                              "0123ABCD-4567-89ef-0123-456789abcdef",
+                              "0123abcg-4567-89ef-0123-456789abcdef",
+                              "0123abc-d4567-89ef-0123-456789abcdef" }) {
+        EXPECT_FALSE(Uuid::fromString(text).has_value()) << text;
+    }
+}
+
+// Проверка уникальности UUID, сгенерированных разными генераторами в разных потоках
+TEST_F(UuidGeneratorTest, UuidTestConcurrentGenerators)
+{
+    constexpr size_t THREAD_COUNT = 8;
+    constexpr size_t UUID_PER_THREAD = 10000;
+
+    std::vector<std::future<std::vector<Uuid>>> futures;
+    for (size_t i = 0; i < THREAD_COUNT; i++) {
+        futures.push_back(std::async(std::launch::async, [] {
+            UuidGenerator localGenerator;
+            std::vector<Uuid> uuids;
+            for (size_t j = 0; j < UUID_PER_THREAD; j++) {
+                uuids.push_back(localGenerator.generate());
+            }
+            return uuids;
+        }));
+    }
+
+    std::set<Uuid> uuids;
+    for (auto &future : futures) {
+        for (const auto &uuid : future.get()) {
+            EXPECT_TRUE(uuids.insert(uuid).second);
+        }
+    }
+    EXPECT_EQ(uuids.size(), THREAD_COUNT * UUID_PER_THREAD);
+}
+
 // Проверка корректных и некорректных UUID
 TEST_F(UuidGeneratorTest, UuidTestValidation)
 {
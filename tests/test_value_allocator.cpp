@@ -0,0 +1,151 @@
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/record_table.hpp"
+#include "storage/value_allocator.hpp"
+#include "testing_utils.hpp"
+
+namespace octet::tests {
+/**
+ * @brief Тест соответствия длин значений классам размера
+ */
+TEST(ValueAllocatorTest, SizeClasses)
+{
+    EXPECT_EQ(ValueAllocator::classSize(0), ValueAllocator::MIN_BLOCK_SIZE);
+    EXPECT_EQ(ValueAllocator::classSize(ValueAllocator::CLASS_COUNT - 1),
+              ValueAllocator::MAX_BLOCK_SIZE);
+
+    for (size_t size = 1; size <= ValueAllocator::MAX_BLOCK_SIZE; size++) {
+        const auto index = ValueAllocator::sizeClass(size);
+        ASSERT_LT(index, ValueAllocator::CLASS_COUNT);
+        const auto blockSize = ValueAllocator::classSize(index);
+        // Значение попадает в наименьший подходящий класс
+        ASSERT_GE(blockSize, size);
+        if (index > 0) {
+            ASSERT_LT(ValueAllocator::classSize(index - 1), size);
+        }
+        // Потери на округление не превышают шага малых классов (8 байт) или четверти длины
+        if (size > ValueAllocator::MIN_BLOCK_SIZE) {
+            ASSERT_LE(blockSize - size, std::max<size_t>(7, size / 4));
+        }
+    }
+}
+
+/**
+ * @brief Тест выдачи блоков из слэбов и возврата пустых слэбов
+ */
+TEST(ValueAllocatorTest, SlabLifecycle)
+{
+    auto &allocator = ValueAllocator::getInstance();
+    const auto before = allocator.stats();
+
+    // Блоков больше, чем помещается в один слэб
+    constexpr size_t SIZE = 100;
+    const auto blockSize = ValueAllocator::classSize(ValueAllocator::sizeClass(SIZE));
+    const auto count = 3 * ValueAllocator::SLAB_SIZE / blockSize;
+    std::vector<char *> blocks;
+    for (size_t i = 0; i < count; i++) {
+        auto *block = allocator.allocate(SIZE, ValueAllocation::SLAB);
+        std::memset(block, static_cast<int>(i), SIZE);
+        blocks.push_back(block);
+    }
+    for (size_t i = 0; i < count; i++) {
+        ASSERT_EQ(blocks[i][0], static_cast<char>(i));
+        ASSERT_EQ(blocks[i][SIZE - 1], static_cast<char>(i));
+    }
+
+    const auto filled = allocator.stats();
+    EXPECT_EQ(filled.liveBytes - before.liveBytes, count * SIZE);
+    EXPECT_EQ(filled.allocatedBytes - before.allocatedBytes, count * blockSize);
+    EXPECT_GE(filled.slabs - before.slabs, 3);
+
+    // Освобождённый блок переиспользуется
+    allocator.deallocate(blocks.back(), SIZE, ValueAllocation::SLAB);
+    EXPECT_EQ(allocator.allocate(SIZE, ValueAllocation::SLAB), blocks.back());
+
+    // После освобождения всех блоков у класса остаётся не больше одного слэба в резерве
+    for (auto *block : blocks) {
+        allocator.deallocate(block, SIZE, ValueAllocation::SLAB);
+    }
+    const auto released = allocator.stats();
+    EXPECT_EQ(released.liveBytes, before.liveBytes);
+    EXPECT_EQ(released.allocatedBytes, before.allocatedBytes);
+    EXPECT_LE(released.slabs, before.slabs + 1);
+}
+
+/**
+ * @brief Тест смены способа выделения при существующих значениях
+ */
+TEST(ValueAllocatorTest, SwitchAllocation)
+{
+    auto &allocator = ValueAllocator::getInstance();
+    const auto before = allocator.stats();
+    const auto previous = ValueAllocator::defaultAllocation();
+
+    ValueAllocator::setDefaultAllocation(ValueAllocation::SLAB);
+    RecordValue slabValue;
+    slabValue.assign(std::string(40, 's'));
+    ValueAllocator::setDefaultAllocation(ValueAllocation::HEAP);
+    RecordValue heapValue;
+    heapValue.assign(std::string(40, 'h'));
+
+    // Значение того же класса размера сохраняется в прежнем блоке
+    const auto *data = slabValue.view().data();
+    slabValue.assign(std::string(38, 'u'));
+    EXPECT_EQ(slabValue.view().data(), data);
+    EXPECT_EQ(slabValue.view(), std::string(38, 'u'));
+    EXPECT_EQ(allocator.stats().liveBytes - before.liveBytes, 78);
+
+    // Каждый буфер освобождается тем способом, которым был выделен
+    RecordValue copy(slabValue);
+    EXPECT_EQ(copy.view(), slabValue.view());
+    slabValue.clear();
+    heapValue.clear();
+    copy.clear();
+    ValueAllocator::setDefaultAllocation(previous);
+
+    const auto after = allocator.stats();
+    EXPECT_EQ(after.liveBytes, before.liveBytes);
+    EXPECT_EQ(after.allocatedBytes, before.allocatedBytes);
+}
+
+/**
+ * @brief Тест одновременной работы нескольких потоков
+ */
+TEST(ValueAllocatorTest, ConcurrentAllocations)
+{
+    auto &allocator = ValueAllocator::getInstance();
+    const auto before = allocator.stats();
+
+    constexpr size_t THREADS = 4;
+    constexpr size_t VALUES = 2000;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; t++) {
+        threads.emplace_back([t] {
+            std::vector<RecordValue> values(VALUES);
+            for (size_t round = 0; round < 3; round++) {
+                for (size_t i = 0; i < VALUES; i++) {
+                    values[i].assign(generateLargeString(16 + (i * 7 + t + round) % 3000));
+                }
+                for (size_t i = 0; i < VALUES; i += 2) {
+                    values[i].clear();
+                }
+            }
+            for (size_t i = 1; i < VALUES; i += 2) {
+                ASSERT_EQ(values[i].view(), generateLargeString(16 + (i * 7 + t + 2) % 3000));
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+
+    const auto after = allocator.stats();
+    EXPECT_EQ(after.liveBytes, before.liveBytes);
+    EXPECT_EQ(after.allocatedBytes, before.allocatedBytes);
+}
+} // namespace octet::tests
@@ -0,0 +1,236 @@
+#include <gtest/gtest.h>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "storage/uuid_generator.hpp"
+#include "storage/value_log.hpp"
+#include "testing_utils.hpp"
+
+namespace {
+static constexpr char VALUE_LOG_FILE_NAME[] = "octet-data.values";
+} // namespace
+
+namespace octet::tests {
+class ValueLogTest : public ::testing::Test {
+protected:
+    std::filesystem::path testDir; // Путь к тестовой директории
+    std::filesystem::path basePath; // Путь к журналу значений
+    UuidGenerator generator; // Генератор ключей записей
+
+    void SetUp() override
+    {
+        testDir = createTmpDirectory("ValueLog");
+        basePath = testDir / VALUE_LOG_FILE_NAME;
+    }
+
+    void TearDown() override { removeTmpDirectory(testDir); }
+
+    /**
+     * @brief Формирует параметры журнала значений
+     * @param segmentSize Размер сегмента
+     * @param cacheBytes Объём кэша
+     * @return Параметры журнала значений
+     */
+    static ValueLogPolicy policy(uint64_t segmentSize = 64 * 1024, size_t cacheBytes = 0)
+    {
+        ValueLogPolicy result;
+        result.minValueSize = 64;
+        result.segmentSize = segmentSize;
+        result.cacheBytes = cacheBytes;
+        return result;
+    }
+};
+
+/**
+ * @brief Тест записи и чтения значений
+ */
+TEST_F(ValueLogTest, AppendAndRead)
+{
+    ValueLog log(basePath, policy());
+    EXPECT_FALSE(log.hasSegments());
+    // Короткие значения остаются в памяти
+    EXPECT_FALSE(log.shouldStore(63));
+    EXPECT_TRUE(log.shouldStore(64));
+
+    const auto key = generator.generate();
+    const auto value = generateLargeString(1000);
+    const auto location = log.append(key, value);
+    ASSERT_TRUE(location.has_value());
+    EXPECT_TRUE(log.hasSegments());
+    EXPECT_TRUE(log.contains(*location));
+    EXPECT_EQ(location->size, value.size());
+
+    std::string stored;
+    ASSERT_TRUE(log.read(key, *location, stored));
+    EXPECT_EQ(stored, value);
+
+    // Запись проверяется по ключу и положению
+    EXPECT_FALSE(log.read(generator.generate(), *location, stored));
+    auto shifted = *location;
+    shifted.offset += 1;
+    shifted.size -= 1;
+    EXPECT_FALSE(log.read(key, shifted, stored));
+    EXPECT_FALSE(log.contains(ValueLocation{ location->segment + 1, location->offset, 1 }));
+
+    log.retain(*location);
+    EXPECT_EQ(log.stats().liveBytes, ValueLog::RECORD_HEADER_SIZE + value.size());
+    log.release(*location);
+    EXPECT_EQ(log.stats().liveBytes, 0);
+    EXPECT_TRUE(log.sync());
+}
+
+/**
+ * @brief Тест чтения значений после перезапуска и обнаружения повреждённых записей
+ */
+TEST_F(ValueLogTest, ReopenAndCorruption)
+{
+    const auto key = generator.generate();
+    const auto value = generateLargeString(500);
+    ValueLocation location;
+    {
+        ValueLog log(basePath, policy());
+        const auto appended = log.append(key, value);
+        ASSERT_TRUE(appended.has_value());
+        location = *appended;
+        ASSERT_TRUE(log.sync());
+    }
+
+    {
+        ValueLog log(basePath, policy());
+        std::string stored;
+        ASSERT_TRUE(log.read(key, location, stored));
+        EXPECT_EQ(stored, value);
+
+        // После перезапуска запись продолжается в новом сегменте
+        const auto next = log.append(key, value);
+        ASSERT_TRUE(next.has_value());
+        EXPECT_GT(next->segment, location.segment);
+    }
+
+    // Изменённый байт значения обнаруживается по контрольной сумме
+    {
+        std::fstream file(ValueLog::segmentPath(basePath, location.segment),
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(location.offset + 10);
+        file.put('#');
+    }
+    ValueLog log(basePath, policy());
+    std::string stored;
+    EXPECT_FALSE(log.read(key, location, stored));
+}
+
+/**
+ * @brief Тест смены сегментов, выбора сегментов для уплотнения и их удаления
+ */
+TEST_F(ValueLogTest, SegmentsAndCollection)
+{
+    ValueLog log(basePath, policy(4096));
+    std::vector<std::pair<Uuid, ValueLocation>> values;
+    for (size_t i = 0; i < 20; i++) {
+        const auto key = generator.generate();
+        const auto location = log.append(key, generateLargeString(1000));
+        ASSERT_TRUE(location.has_value());
+        log.retain(*location);
+        values.emplace_back(key, *location);
+    }
+    const auto segments = ValueLog::listSegments(basePath);
+    ASSERT_GT(segments.size(), 2);
+    EXPECT_EQ(log.stats().segments, segments.size());
+
+    // Сегмент, все записи которого используются, не уплотняется
+    const auto first = values.front().second.segment;
+    EXPECT_TRUE(log.collectableSegments().empty());
+    EXPECT_FALSE(log.retireSegment(first));
+
+    // Обход сегмента возвращает все его записи
+    std::vector<ValueLocation> scanned;
+    EXPECT_TRUE(log.scanSegment(first, [&](const Uuid &key, const ValueLocation &location) {
+        EXPECT_EQ(key, values[scanned.size()].first);
+        scanned.push_back(location);
+    }));
+    ASSERT_FALSE(scanned.empty());
+    EXPECT_EQ(scanned.front(), values.front().second);
+
+    for (const auto &[key, location] : values) {
+        if (location.segment == first) {
+            log.release(location);
+        }
+    }
+    EXPECT_EQ(log.collectableSegments(), std::vector<uint32_t>{ first });
+    ASSERT_TRUE(log.retireSegment(first));
+    EXPECT_TRUE(log.collectableSegments().empty());
+
+    // Файл выведенного сегмента остаётся до явного удаления
+    EXPECT_TRUE(std::filesystem::exists(ValueLog::segmentPath(basePath, first)));
+    EXPECT_TRUE(log.removeSegments({ first }));
+    EXPECT_FALSE(std::filesystem::exists(ValueLog::segmentPath(basePath, first)));
+    std::string stored;
+    EXPECT_FALSE(log.read(values.front().first, values.front().second, stored));
+    EXPECT_TRUE(log.read(values.back().first, values.back().second, stored));
+}
+
+/**
+ * @brief Тест кэша прочитанных значений
+ */
+TEST_F(ValueLogTest, Cache)
+{
+    ValueLog log(basePath, policy(64 * 1024, 1024 * 1024));
+    const auto key = generator.generate();
+    const auto value = generateLargeString(1000);
+    const auto location = log.append(key, value);
+    ASSERT_TRUE(location.has_value());
+
+    std::string stored;
+    for (size_t i = 0; i < 5; i++) {
+        ASSERT_TRUE(log.read(key, *location, stored));
+        EXPECT_EQ(stored, value);
+    }
+    const auto stats = log.stats();
+    EXPECT_EQ(stats.reads, 1);
+    EXPECT_EQ(stats.cacheHits, 4);
+    EXPECT_EQ(stats.cacheBytes, value.size());
+
+    // Объём кэша ограничен
+    for (size_t i = 0; i < 3000; i++) {
+        const auto next = generator.generate();
+        const auto appended = log.append(next, generateLargeString(1000));
+        ASSERT_TRUE(appended.has_value());
+        ASSERT_TRUE(log.read(next, *appended, stored));
+    }
+    EXPECT_LE(log.stats().cacheBytes, 1024 * 1024);
+}
+
+/**
+ * @brief Тест одновременной записи и чтения значений несколькими потоками
+ */
+TEST_F(ValueLogTest, ConcurrentAppends)
+{
+    ValueLog log(basePath, policy(256 * 1024, 256 * 1024));
+    constexpr size_t THREADS = 4;
+    constexpr size_t VALUES = 500;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < THREADS; t++) {
+        threads.emplace_back([&log, t] {
+            UuidGenerator generator;
+            for (size_t i = 0; i < VALUES; i++) {
+                const auto key = generator.generate();
+                const auto value
+                    = std::string(100 + (i * 13 + t) % 2000, static_cast<char>('a' + t));
+                const auto location = log.append(key, value);
+                ASSERT_TRUE(location.has_value());
+                std::string stored;
+                ASSERT_TRUE(log.read(key, *location, stored));
+                ASSERT_EQ(stored, value);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    EXPECT_TRUE(log.sync());
+    EXPECT_GT(log.stats().segments, 1);
+}
+} // namespace octet::tests